@@ -393,7 +393,7 @@ void printVar() {
 //  return the button action state -- true for a new button press, false otherwise
 bool buttonPressed() {
   static ButtonStates buttonState = NOT_PRESSED;
-  static unsigned long pressedTime;
+  static system_tick_t pressedTime;
 
   // state machine to track button actions
   switch(buttonState) {
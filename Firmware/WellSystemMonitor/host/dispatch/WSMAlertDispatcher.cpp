@@ -0,0 +1,91 @@
+/***************************************************************************************************/
+// WSMAlertDispatcher.cpp
+//  See WSMAlertDispatcher.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMAlertDispatcher.h"
+
+#include <climits>
+
+WSMAlertDispatcher::WSMAlertDispatcher(WSMAlertRouter &router)
+    : _router(router), _stopping(false), _started(Clock::now()), _submitted(0), _routed(0), _wakes(0) {}
+
+WSMAlertDispatcher::~WSMAlertDispatcher() {
+    stop();
+}
+
+uint64_t WSMAlertDispatcher::nowMicros() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count();
+}
+
+int64_t WSMAlertDispatcher::nowMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - _started).count();
+}
+
+void WSMAlertDispatcher::start() {
+    if(_thread.joinable()) {
+        return;
+    }
+    _stopping = false;
+    _started = Clock::now();
+    _thread = std::thread(&WSMAlertDispatcher::worker, this);
+}
+
+void WSMAlertDispatcher::submit(std::string_view device, std::string_view event, std::string_view data) {
+    uint64_t receivedUs = nowMicros();
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _submittedList.push_back(Submitted{std::string(device), std::string(event), std::string(data), receivedUs});
+    }
+    _submitted++;
+    _wake.notify_one();
+}
+
+void WSMAlertDispatcher::stop(bool flush) {
+    if(_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _stopping = true;
+        }
+        _wake.notify_one();
+        _thread.join();
+    }
+    if(flush) {
+        _router.flush(nowMs());
+    }
+}
+
+// take what has been submitted, route it and send what is due; sleep until more comes or the
+//  next digest is due
+void WSMAlertDispatcher::worker() {
+    std::vector<Submitted> taken;
+    int64_t nextDueMs = INT64_MAX;
+    while(true) {
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            auto ready = [this]() { return !_submittedList.empty() || _stopping; };
+            if(nextDueMs == INT64_MAX) {
+                _wake.wait(lock, ready);
+            } else {
+                _wake.wait_until(lock, _started + std::chrono::milliseconds(nextDueMs), ready);
+            }
+            if(_submittedList.empty() && _stopping) {
+                break;
+            }
+            taken.swap(_submittedList);
+        }
+        _wakes++;
+
+        int64_t now = nowMs();
+        for(const Submitted &alert : taken) {
+            _router.route(alert.device, alert.event, alert.data, now, alert.receivedUs);
+        }
+        _routed += taken.size();
+        taken.clear();
+        nextDueMs = _router.poll(now);
+    }
+}
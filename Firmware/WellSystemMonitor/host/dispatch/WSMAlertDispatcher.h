@@ -0,0 +1,81 @@
+#ifndef WSMALERTDISPATCHER_H_INCLUDE
+#define WSMALERTDISPATCHER_H_INCLUDE
+/***************************************************************************************************/
+// WSMAlertDispatcher.h
+//  Runs an alert router (WSMAlertRouter.h) on its own thread, on real time, for a service: any
+//  thread hands it alerts, and the router's thread routes them and sends the digests as they come
+//  due.
+//
+//      WSMAlertRouter router(config, sink);                // routes added
+//      WSMAlertDispatcher dispatcher(router);
+//      dispatcher.start();
+//      dispatcher.submit(coreid, event, data);             // from any thread
+//      ...
+//      dispatcher.stop(true);                              // and send what is still held
+//
+//  submit() copies the alert into a list under a lock and wakes the router's thread, which takes
+//  the whole list at once, so many submitting threads share each wake.  The router's times are the
+//  milliseconds since start(); each alert carries nowMicros() of its submit, for the sink to
+//  measure its latency.  The sink is called on the router's thread, and the router belongs to it
+//  from start() to stop().
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMAlertRouter.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class WSMAlertDispatcher {
+    public:
+        explicit WSMAlertDispatcher(WSMAlertRouter &router);
+        ~WSMAlertDispatcher();
+
+        void start();
+
+        // hand an alert to the router's thread
+        void submit(std::string_view device, std::string_view event, std::string_view data);
+
+        // route the alerts submitted so far and stop the thread; with flush, then send every alert
+        //  still held
+        void stop(bool flush = false);
+
+        uint64_t submitted() const { return _submitted.load(); }
+        uint64_t routed() const { return _routed.load(); }  // of them, taken by the router
+        uint64_t wakes() const { return _wakes.load(); }    // lists the router's thread took
+
+        // the steady clock, in microseconds: the receivedUs of the alerts
+        static uint64_t nowMicros();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Submitted {
+            std::string device;
+            std::string event;
+            std::string data;
+            uint64_t receivedUs;
+        };
+
+        void worker();
+        int64_t nowMs() const;
+
+        WSMAlertRouter &_router;
+        std::mutex _lock;
+        std::condition_variable _wake;
+        std::vector<Submitted> _submittedList;
+        bool _stopping;
+        std::thread _thread;
+        Clock::time_point _started;
+        std::atomic<uint64_t> _submitted;
+        std::atomic<uint64_t> _routed;
+        std::atomic<uint64_t> _wakes;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,332 @@
+/***************************************************************************************************/
+// WSMAlertRouter.cpp
+//  See WSMAlertRouter.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMAlertRouter.h"
+#include "JSONWriter.h"
+#include "WSMJsonReader.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+const WSMAlertKind WSM_ALERT_KINDS[ALERT_KINDS] = {
+    {"wsmAlertPPOnTooLong", "WSM ALERT: The PP was on too long"},
+    {"wsmAlertPPOnTooShort", "WSM ALERT: The PP was on too short"},
+    {"wsmAlertWPOnTooLong", "WSM ALERT: The WP was on too long"},
+    {"wsmAlertWPOnTooShort", "WSM ALERT: The WP was on too short"},
+    {"wsmAlertWPNotComeOn", "WSM ALERT: The WP did not come on"},
+    {"wsmAlertWPOnTooSoon", "WSM ALERT: The WP ran too soon"},
+    {"wsmAlertPPNotRun", "WSM ALERT: The PP did not come on"},
+    {"wsmAlertPPDeviation", "WSM ALERT: The PP is not running as it did"},
+    {"wsmAlertWPDeviation", "WSM ALERT: The WP is not running as it did"},
+    {"wsmAlertPPShortCycling", "WSM ALERT: The PP is short cycling"},
+    {"wsmAlertWPFreeze", "WSM ALERT: The WP came on freezing"}
+};
+
+namespace {
+
+    const int64_t NEVER = INT64_MIN / 2;
+    const char SUBJECT_PREFIX[] = "WSM ALERT: ";
+
+    // the subject without "WSM ALERT: ", for a digest line
+    const char *shortSubject(unsigned int kind) {
+        const char *subject = WSM_ALERT_KINDS[kind].subject;
+        size_t prefix = sizeof(SUBJECT_PREFIX) - 1;
+        return strncmp(subject, SUBJECT_PREFIX, prefix) == 0 ? subject + prefix : subject;
+    }
+
+    // midnight UTC of the nth Sunday of a month
+    time_t nthSunday(int year, int month, int n) {
+        struct tm first = {};
+        first.tm_year = year - 1900;
+        first.tm_mon = month;
+        first.tm_mday = 1;
+        time_t day = timegm(&first);
+        gmtime_r(&day, &first);
+        return day + ((7 - first.tm_wday) % 7 + 7 * (n - 1)) * 86400;
+    }
+
+    // etime in local time: US daylight time starts at 2 am standard time and ends at 2 am daylight
+    //  time, 1 am standard
+    time_t localTime(int64_t etime, const WSMAlertRouterConfig &config) {
+        time_t standard = (time_t)(etime + (int64_t)(config.zoneHours * 3600.0f));
+        if(!config.usDaylightTime) {
+            return standard;
+        }
+        struct tm date;
+        gmtime_r(&standard, &date);
+        int year = date.tm_year + 1900;
+        bool daylight = standard >= nthSunday(year, 2, 2) + 2 * 3600 && standard < nthSunday(year, 10, 1) + 3600;
+        return standard + (daylight ? 3600 : 0);
+    }
+
+    // the script's body: the message and its local time, "PP on for 3.5 minutes. at: 2022-09-27 04:51:01"
+    //  and how often it was reported, if more than once
+    void appendLine(std::string &body, const WSMRoutedAlert &alert, const WSMAlertRouterConfig &config) {
+        char text[96];
+        JSONWriter::formatTime(text, localTime(alert.etime, config));
+        body += alert.msg;
+        body += " at: ";
+        body += text;
+        if(alert.reports > 1) {
+            snprintf(text, sizeof(text), " (reported %u times by %u device%s)", alert.reports, alert.devices,
+                     alert.devices == 1 ? "" : "s");
+            body += text;
+        }
+    }
+
+}   // namespace
+
+int alertKind(std::string_view event) {
+    for(unsigned int kind = 0; kind < ALERT_KINDS; kind++) {
+        if(event == WSM_ALERT_KINDS[kind].event) {
+            return (int)kind;
+        }
+    }
+    return -1;
+}
+
+WSMAlertRouter::WSMAlertRouter(const WSMAlertRouterConfig &config, const WSMAlertSink &sink)
+    : _config(config), _sink(sink), _held(0) {}
+
+void WSMAlertRouter::mapDevice(std::string_view device, std::string_view site) {
+    _deviceSites[std::string(device)] = std::string(site);
+}
+
+void WSMAlertRouter::addRecipient(std::string_view siteName, std::string_view recipient) {
+    if(siteName == "*") {
+        _defaultRecipients.push_back(std::string(recipient));
+        return;
+    }
+    Site &s = site(siteName);
+    if(s.defaults) {
+        s.outboxes.clear();
+        s.defaults = false;
+    }
+    Outbox outbox;
+    outbox.site = std::string(siteName);
+    outbox.recipient = std::string(recipient);
+    outbox.tokens = _config.burst;
+    outbox.refilledMs = NEVER;
+    outbox.lastSentMs = NEVER;
+    outbox.dueMs = INT64_MAX;
+    s.outboxes.push_back(_outboxes.size());
+    _outboxes.push_back(outbox);
+}
+
+bool WSMAlertRouter::loadRoutes(const char *path, std::string &error) {
+    FILE *file = fopen(path, "r");
+    if(file == nullptr) {
+        error = std::string("can't open ") + path;
+        return false;
+    }
+    char line[512];
+    bool ok = true;
+    while(ok && fgets(line, sizeof(line), file) != nullptr) {
+        char *comment = strchr(line, '#');
+        if(comment != nullptr) {
+            *comment = '\0';
+        }
+        char kind[16], first[256], second[256], extra[2];
+        int fields = sscanf(line, "%15s %255s %255s %1s", kind, first, second, extra);
+        if(fields <= 0) {
+            continue;
+        } else if(fields == 3 && strcmp(kind, "device") == 0) {
+            mapDevice(first, second);
+        } else if(fields == 3 && strcmp(kind, "recipient") == 0) {
+            addRecipient(first, second);
+        } else {
+            error = line;
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+// the site, made the first time it is named
+WSMAlertRouter::Site &WSMAlertRouter::site(std::string_view name) {
+    auto found = _sites.find(name);
+    if(found != _sites.end()) {
+        return found->second;
+    }
+    Site &s = _sites[std::string(name)];
+    std::fill(s.firstSeenMs, s.firstSeenMs + ALERT_KINDS, NEVER);
+    return s;
+}
+
+void WSMAlertRouter::refill(Outbox &outbox, int64_t nowMs) {
+    if(outbox.refilledMs != NEVER && nowMs > outbox.refilledMs) {
+        outbox.tokens = std::min(_config.burst,
+                                 outbox.tokens + (nowMs - outbox.refilledMs) * _config.messagesPerHour / 3600000.0);
+    }
+    outbox.refilledMs = nowMs;
+}
+
+void WSMAlertRouter::schedule(size_t outbox, int64_t dueMs) {
+    _outboxes[outbox].dueMs = dueMs;
+    _due.push(Due(dueMs, outbox));
+}
+
+bool WSMAlertRouter::route(std::string_view device, std::string_view event, std::string_view data, int64_t nowMs,
+                           uint64_t receivedUs) {
+    int kind = alertKind(event);
+    WSMJsonReader json;
+    double etime;
+    std::string_view msg;
+    if(kind < 0 || !json.read(data) || !json.number("etime", etime) || !json.string("msg", msg)) {
+        _stats.refused++;
+        return false;
+    }
+    auto mapped = _deviceSites.find(device);
+    std::string_view siteName = mapped != _deviceSites.end() ? std::string_view(mapped->second) : device;
+    Site &s = site(siteName);
+    if(s.outboxes.empty() && !_defaultRecipients.empty()) {
+        for(const std::string &recipient : _defaultRecipients) {
+            addRecipient(siteName, recipient);
+        }
+        s.defaults = true;
+    }
+    if(s.outboxes.empty()) {
+        _stats.refused++;
+        return false;
+    }
+    _stats.received++;
+
+    // a duplicate is counted on the alert, where it is still held
+    std::vector<std::string> &devices = s.devices[kind];
+    if(nowMs - s.firstSeenMs[kind] < _config.dedupeWindowMs) {
+        _stats.duplicates++;
+        bool newDevice = std::find(devices.begin(), devices.end(), device) == devices.end();
+        if(newDevice) {
+            devices.push_back(std::string(device));
+        }
+        // the last of its kind held is this window's: the outbox sends all it holds at once
+        for(size_t o : s.outboxes) {
+            std::vector<WSMRoutedAlert> &held = _outboxes[o].held;
+            for(auto alert = held.rbegin(); alert != held.rend(); ++alert) {
+                if(alert->kind == kind) {
+                    alert->reports++;
+                    alert->devices += newDevice ? 1 : 0;
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+    s.firstSeenMs[kind] = nowMs;
+    devices.assign(1, std::string(device));
+
+    WSMRoutedAlert alert;
+    alert.kind = (uint8_t)kind;
+    alert.etime = (int64_t)etime;
+    alert.msg = std::string(msg);
+    alert.device = std::string(device);
+    alert.reports = 1;
+    alert.devices = 1;
+    alert.receivedUs = receivedUs;
+    for(size_t o : s.outboxes) {
+        Outbox &outbox = _outboxes[o];
+        refill(outbox, nowMs);
+        outbox.held.push_back(alert);
+        _held++;
+        if(outbox.held.size() > 1) {
+            continue;       // already due
+        }
+        if(nowMs - outbox.lastSentMs >= _config.digestWindowMs && outbox.tokens >= 1.0) {
+            if(!send(outbox, nowMs)) {
+                schedule(o, nowMs + _config.retryMs);
+            }
+        } else {
+            schedule(o, std::max(nowMs, outbox.lastSentMs + _config.digestWindowMs));
+        }
+    }
+    return true;
+
+}   // end of route()
+
+int64_t WSMAlertRouter::poll(int64_t nowMs) {
+    while(!_due.empty() && _due.top().first <= nowMs) {
+        Due due = _due.top();
+        _due.pop();
+        Outbox &outbox = _outboxes[due.second];
+        if(outbox.dueMs != due.first || outbox.held.empty()) {
+            continue;
+        }
+        refill(outbox, nowMs);
+        if(outbox.tokens < 1.0) {
+            _stats.throttled++;
+            schedule(due.second, nowMs + (int64_t)((1.0 - outbox.tokens) * 3600000.0 / _config.messagesPerHour) + 1);
+        } else if(!send(outbox, nowMs)) {
+            schedule(due.second, nowMs + _config.retryMs);
+        }
+    }
+    return _due.empty() ? INT64_MAX : _due.top().first;
+}
+
+void WSMAlertRouter::flush(int64_t nowMs) {
+    for(Outbox &outbox : _outboxes) {
+        if(!outbox.held.empty()) {
+            refill(outbox, nowMs);
+            outbox.tokens = std::max(outbox.tokens, 1.0);
+            send(outbox, nowMs);
+        }
+    }
+}
+
+// deliver the held alerts; on success they are gone and a token taken
+bool WSMAlertRouter::send(Outbox &outbox, int64_t nowMs) {
+    compose(outbox, _message);
+    if(!_sink(_message)) {
+        _stats.failures++;
+        return false;
+    }
+    _stats.messages++;
+    _stats.digests += _message.digest ? 1 : 0;
+    _stats.alertsSent += outbox.held.size();
+    _held -= outbox.held.size();
+    outbox.held.clear();
+    outbox.dueMs = INT64_MAX;
+    outbox.tokens -= 1.0;
+    outbox.lastSentMs = nowMs;
+    return true;
+}
+
+// a lone alert as the script sends it; several as a digest, a line each
+void WSMAlertRouter::compose(const Outbox &outbox, WSMAlertMessage &message) const {
+    message.site = outbox.site;
+    message.recipient = outbox.recipient;
+    message.alerts = outbox.held;
+    message.digest = outbox.held.size() > 1;
+    message.body.clear();
+    if(!message.digest) {
+        message.subject = WSM_ALERT_KINDS[outbox.held[0].kind].subject;
+        appendLine(message.body, outbox.held[0], _config);
+        return;
+    }
+
+    char count[96];
+    snprintf(count, sizeof(count), "%s%zu alerts from %s", SUBJECT_PREFIX, outbox.held.size(), outbox.site.c_str());
+    message.subject = count;
+    size_t listed = std::min(outbox.held.size(), (size_t)_config.digestLines);
+    for(size_t i = 0; i < listed; i++) {
+        const WSMRoutedAlert &alert = outbox.held[i];
+        message.body += shortSubject(alert.kind);
+        message.body += ": ";
+        appendLine(message.body, alert, _config);
+        message.body += '\n';
+    }
+    if(listed < outbox.held.size()) {
+        snprintf(count, sizeof(count), "and %zu more\n", outbox.held.size() - listed);
+        message.body += count;
+    }
+
+}   // end of compose()
@@ -0,0 +1,167 @@
+#ifndef WSMALERTROUTER_H_INCLUDE
+#define WSMALERTROUTER_H_INCLUDE
+/***************************************************************************************************/
+// WSMAlertRouter.h
+//  A self hosted stand in for the WSM_Send_Alert script, which mails each wsmAlert* event to one
+//  hard coded recipient as it comes: during an incident that is a burst of texts.  The router
+//  takes the wsmAlert* events of many sites and sends each site's recipients at most a few
+//  messages an hour:
+//
+//      WSMAlertRouter router(config, sink);
+//      router.mapDevice("e00fce68...", "smith");           // the devices of a site
+//      router.addRecipient("smith", "5551234567@vtext.com");
+//      router.addRecipient("*", "ops@example.com");        // for the sites without their own
+//      router.route(coreid, event, data, nowMs);           // each alert, as the webhook posts it
+//      router.poll(nowMs);                                 // and now and then, for the digests
+//
+//  - The same alert from a site (any of its devices) within dedupeWindowMs of its first report is
+//    a duplicate: it is counted on the alert, which is not sent again.
+//  - A recipient's first alert goes out at once, as the script sends it (its subject, and the
+//    message with the local time).  Alerts that follow within digestWindowMs of a message are held
+//    and sent together as one digest when the window ends.
+//  - Each site and recipient has a token bucket: a message takes a token, and the tokens come back
+//    at messagesPerHour up to burst.  With no token the held alerts wait, and gather, until one
+//    comes back; none is dropped.
+//
+//  The sink delivers a message (a mailbox file, WSMMailbox.h, stands in for SMTP); when it fails,
+//  the alerts are held and tried again retryMs later.  Times are the caller's milliseconds, which
+//  only have to go forward: real time in a service (WSMAlertDispatcher.h), the alerts' etimes in a
+//  replay.  One thread uses a router at a time.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// the wsmAlert* events the router takes: the script's seven, then the adaptive, short cycling
+//  and freeze alerts
+const unsigned int ALERT_KINDS = 11;
+
+struct WSMAlertKind {
+    const char *event;
+    const char *subject;    // the script's generateSubjText()
+};
+extern const WSMAlertKind WSM_ALERT_KINDS[ALERT_KINDS];
+
+// the index of event in WSM_ALERT_KINDS, or -1
+int alertKind(std::string_view event);
+
+struct WSMRoutedAlert {
+    uint8_t kind;               // in WSM_ALERT_KINDS
+    int64_t etime;
+    std::string msg;            // as published, still JSON escaped
+    std::string device;         // that reported it first
+    unsigned int reports;       // times it was reported within the dedupe window, itself included
+    unsigned int devices;       // devices that reported it
+    uint64_t receivedUs;        // the caller's, for latency
+};
+
+struct WSMAlertMessage {
+    std::string site;
+    std::string recipient;
+    std::string subject;
+    std::string body;
+    std::vector<WSMRoutedAlert> alerts;     // in it, oldest first
+    bool digest;                // of several alerts
+};
+
+// deliver a message; false if it was not, to try again later
+typedef std::function<bool(const WSMAlertMessage &message)> WSMAlertSink;
+
+struct WSMAlertRouterConfig {
+    int64_t digestWindowMs = 60000;     // alerts within this of a recipient's last message wait for a digest
+    int64_t dedupeWindowMs = 600000;    // the same alert from a site within this of its first report is a duplicate
+    double messagesPerHour = 6.0;       // tokens a site and recipient get back
+    double burst = 3.0;                 // and hold at most
+    int64_t retryMs = 30000;            // after a failed delivery
+    float zoneHours = -8.0;             // standard local time in the messages (the script's Los Angeles)
+    bool usDaylightTime = true;         // and an hour on from the second Sunday in March to the first in November
+    unsigned int digestLines = 20;      // alerts listed in a digest; the rest are counted
+};
+
+struct WSMAlertRouterStats {
+    uint64_t received = 0;      // alerts routed
+    uint64_t refused = 0;       // not a wsmAlert*, malformed, or a site with no recipient
+    uint64_t duplicates = 0;
+    uint64_t messages = 0;      // delivered, digests included
+    uint64_t digests = 0;
+    uint64_t alertsSent = 0;    // in the messages delivered; an alert counts once per recipient
+    uint64_t throttled = 0;     // times a due message waited for a token
+    uint64_t failures = 0;      // deliveries the sink refused
+};
+
+class WSMAlertRouter {
+    public:
+        WSMAlertRouter(const WSMAlertRouterConfig &config, const WSMAlertSink &sink);
+
+        // routes: the site of a device (a device not mapped is a site of its own), and the
+        //  recipients of a site, or of every site without its own for "*".  Before its first alert.
+        void mapDevice(std::string_view device, std::string_view site);
+        void addRecipient(std::string_view site, std::string_view recipient);
+
+        // read routes from path, a line each ('#' starts a comment):
+        //      device COREID SITE
+        //      recipient SITE|* ADDRESS
+        //  false, with error set to the line, if it can't be read
+        bool loadRoutes(const char *path, std::string &error);
+
+        // route the alert device published, at nowMs; false if it was refused
+        bool route(std::string_view device, std::string_view event, std::string_view data, int64_t nowMs,
+                   uint64_t receivedUs = 0);
+
+        // send the messages due by nowMs; returns when the next one is due, INT64_MAX for none
+        int64_t poll(int64_t nowMs);
+
+        // send every held alert now, whatever the windows and tokens (at shutdown)
+        void flush(int64_t nowMs);
+
+        uint64_t held() const { return _held; }     // alerts waiting, once per recipient
+        const WSMAlertRouterStats &stats() const { return _stats; }
+
+    private:
+        // a site and recipient
+        struct Outbox {
+            std::string site;
+            std::string recipient;
+            double tokens;
+            int64_t refilledMs;
+            int64_t lastSentMs;
+            int64_t dueMs;                      // of the held alerts; INT64_MAX with none
+            std::vector<WSMRoutedAlert> held;
+        };
+
+        struct Site {
+            std::vector<size_t> outboxes;
+            bool defaults = false;              // its outboxes are the "*" recipients'
+            int64_t firstSeenMs[ALERT_KINDS];   // of each alert, for the dedupe window
+            std::vector<std::string> devices[ALERT_KINDS];  // that reported it within the window
+        };
+
+        Site &site(std::string_view name);
+        void refill(Outbox &outbox, int64_t nowMs);
+        void schedule(size_t outbox, int64_t dueMs);
+        bool send(Outbox &outbox, int64_t nowMs);
+        void compose(const Outbox &outbox, WSMAlertMessage &message) const;
+
+        WSMAlertRouterConfig _config;
+        WSMAlertSink _sink;
+        std::map<std::string, std::string, std::less<>> _deviceSites;
+        std::map<std::string, Site, std::less<>> _sites;
+        std::vector<std::string> _defaultRecipients;
+        std::vector<Outbox> _outboxes;
+        typedef std::pair<int64_t, size_t> Due;     // dueMs, outbox; stale once the outbox's dueMs moves
+        std::priority_queue<Due, std::vector<Due>, std::greater<Due>> _due;
+        uint64_t _held;
+        WSMAlertRouterStats _stats;
+        WSMAlertMessage _message;                   // reused
+};
+
+#endif  // end of header duplication prevention
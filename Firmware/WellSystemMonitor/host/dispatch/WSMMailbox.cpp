@@ -0,0 +1,64 @@
+/***************************************************************************************************/
+// WSMMailbox.cpp
+//  See WSMMailbox.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMMailbox.h"
+
+#include <cstring>
+#include <ctime>
+
+bool WSMMailbox::open(const char *path) {
+    close();
+    _file = fopen(path, "a");
+    return _file != nullptr;
+}
+
+void WSMMailbox::close() {
+    if(_file != nullptr) {
+        fclose(_file);
+        _file = nullptr;
+    }
+}
+
+bool WSMMailbox::deliver(const WSMAlertMessage &message) {
+    if(_file == nullptr) {
+        return false;
+    }
+    time_t now = time(nullptr);
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    char separator[64];
+    char date[64];
+    strftime(separator, sizeof(separator), "%a %b %e %H:%M:%S %Y", &utc);
+    strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S +0000", &utc);
+
+    fprintf(_file, "From wsm-alerts@localhost %s\n", separator);
+    fprintf(_file, "From: wsm-alerts@localhost\nTo: %s\nSubject: %s\nDate: %s\n", message.recipient.c_str(),
+            message.subject.c_str(), date);
+    fprintf(_file, "X-WSM-Site: %s\nX-WSM-Alerts: %zu\n\n", message.site.c_str(), message.alerts.size());
+
+    // a body line that starts "From " would start a new mail: mbox quotes it
+    const char *line = message.body.c_str();
+    while(*line != '\0') {
+        const char *end = strchr(line, '\n');
+        size_t length = end != nullptr ? (size_t)(end - line) : strlen(line);
+        if(strncmp(line, "From ", 5) == 0) {
+            fputc('>', _file);
+        }
+        fwrite(line, 1, length, _file);
+        fputc('\n', _file);
+        line += length + (end != nullptr ? 1 : 0);
+    }
+    fputc('\n', _file);
+    if(fflush(_file) != 0 || ferror(_file)) {
+        clearerr(_file);
+        return false;
+    }
+    _delivered++;
+    return true;
+}
@@ -0,0 +1,43 @@
+#ifndef WSMMAILBOX_H_INCLUDE
+#define WSMMAILBOX_H_INCLUDE
+/***************************************************************************************************/
+// WSMMailbox.h
+//  A local stand in for the mail server that the alert router's messages (WSMAlertRouter.h) would
+//  be handed to: each message is appended to an mbox file as the mail it would be, with its
+//  recipient, subject and body, and the site and alert count in X-WSM headers:
+//
+//      WSMMailbox mailbox;
+//      mailbox.open("alerts.mbox");
+//      WSMAlertRouter router(config, [&](const WSMAlertMessage &message) { return mailbox.deliver(message); });
+//
+//  Any mail reader opens the file.  One thread delivers at a time.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMAlertRouter.h"
+
+#include <cstdio>
+
+class WSMMailbox {
+    public:
+        WSMMailbox() : _file(nullptr), _delivered(0) {}
+        ~WSMMailbox() { close(); }
+
+        // append to the mbox at path, made if missing; false if it can't be opened
+        bool open(const char *path);
+        void close();
+
+        // append message, and flush it to the file; false if it could not be written
+        bool deliver(const WSMAlertMessage &message);
+
+        uint64_t delivered() const { return _delivered; }
+
+    private:
+        FILE *_file;
+        uint64_t _delivered;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,284 @@
+/***************************************************************************************************/
+// WSMIngestServer.cpp
+//  HTTP server for the wsmEvent* webhook posts.  See WSMIngestServer.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMIngestServer.h"
+
+#include <arpa/inet.h>
+#include <charconv>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <system_error>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+    const int LISTEN_BACKLOG = 512;
+
+    // the parts of a request's head that the server looks at
+    struct RequestHead {
+        std::string_view method;
+        std::string_view path;
+        size_t contentLength = 0;
+        bool keepAlive = true;
+    };
+
+    bool headerIs(std::string_view line, const char *name, std::string_view &value) {
+        size_t length = strlen(name);
+        if(line.size() <= length || line[length] != ':' || strncasecmp(line.data(), name, length) != 0) {
+            return false;
+        }
+        value = line.substr(length + 1);
+        while(!value.empty() && value.front() == ' ') {
+            value.remove_prefix(1);
+        }
+        return true;
+    }
+
+    // the request line and headers, up to the blank line; false, with error set, if the request
+    //  line or the Content-Length is bad
+    bool parseHead(std::string_view head, RequestHead &request, const char *&error) {
+        error = "bad request line\n";
+        size_t lineEnd = head.find("\r\n");
+        std::string_view line = head.substr(0, lineEnd);
+        size_t space = line.find(' ');
+        size_t space2 = space == std::string_view::npos ? space : line.find(' ', space + 1);
+        if(space2 == std::string_view::npos) {
+            return false;
+        }
+        request.method = line.substr(0, space);
+        request.path = line.substr(space + 1, space2 - space - 1);
+        request.keepAlive = line.substr(space2 + 1) != "HTTP/1.0";
+
+        while(lineEnd != std::string_view::npos) {
+            size_t begin = lineEnd + 2;
+            lineEnd = head.find("\r\n", begin);
+            line = head.substr(begin, lineEnd == std::string_view::npos ? std::string_view::npos : lineEnd - begin);
+            std::string_view value;
+            if(headerIs(line, "Content-Length", value)) {
+                while(!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+                    value.remove_suffix(1);
+                }
+                // digits only: no sign, and nothing that overflows
+                std::from_chars_result parsed = std::from_chars(value.data(), value.data() + value.size(),
+                                                                request.contentLength);
+                if(value.empty() || parsed.ec != std::errc() || parsed.ptr != value.data() + value.size()) {
+                    error = "bad Content-Length\n";
+                    return false;
+                }
+            } else if(headerIs(line, "Connection", value)) {
+                request.keepAlive = strncasecmp(value.data(), "close", 5) != 0;
+            }
+        }
+        return true;
+    }
+
+    const char *statusText(int status) {
+        switch(status) {
+            case 200: return "OK";
+            case 400: return "Bad Request";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 413: return "Payload Too Large";
+            default: return "Service Unavailable";
+        }
+    }
+
+}   // namespace
+
+WSMIngestServer::WSMIngestServer(WSMIngestStore &store)
+    : _store(store), _listenFd(-1), _port(0), _stopping(false), _posts(0), _events(0), _refused(0) {}
+
+WSMIngestServer::~WSMIngestServer() {
+    stop();
+}
+
+bool WSMIngestServer::start(uint16_t port, const char *address) {
+    stop();
+    sockaddr_in bound;
+    memset(&bound, 0, sizeof(bound));
+    bound.sin_family = AF_INET;
+    bound.sin_port = htons(port);
+    if(inet_pton(AF_INET, address, &bound.sin_addr) != 1) {
+        return false;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    socklen_t length = sizeof(bound);
+    if(fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) != 0 ||
+       bind(fd, (sockaddr *)&bound, sizeof(bound)) != 0 || listen(fd, LISTEN_BACKLOG) != 0 ||
+       getsockname(fd, (sockaddr *)&bound, &length) != 0) {
+        if(fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+
+    _listenFd = fd;
+    _port = ntohs(bound.sin_port);
+    _stopping = false;
+    _acceptor = std::thread(&WSMIngestServer::acceptor, this);
+    return true;
+
+}   // end of start()
+
+void WSMIngestServer::stop() {
+    if(_listenFd < 0) {
+        return;
+    }
+    std::unique_lock<std::mutex> guard(_lock);
+    _stopping = true;
+    shutdown(_listenFd, SHUT_RDWR);
+    for(int fd : _connections) {
+        shutdown(fd, SHUT_RDWR);
+    }
+    guard.unlock();
+    _acceptor.join();
+    close(_listenFd);
+    _listenFd = -1;
+
+    guard.lock();
+    _closed.wait(guard, [&]() { return _connections.empty(); });
+}
+
+// Private methods
+
+void WSMIngestServer::acceptor() {
+    while(true) {
+        int fd = accept(_listenFd, nullptr, nullptr);
+        if(fd < 0) {
+            if(errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break;  // stopped
+        }
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        std::lock_guard<std::mutex> guard(_lock);
+        if(_stopping) {
+            close(fd);
+            break;
+        }
+        _connections.insert(fd);
+        std::thread(&WSMIngestServer::connection, this, fd).detach();
+    }
+}   // end of acceptor()
+
+// read requests into a fixed buffer and answer them in order until the client closes
+void WSMIngestServer::connection(int fd) {
+    std::vector<char> buffer(INGEST_REQUEST_SIZE + 1);     // a spare byte to terminate the last body
+    std::vector<WSMIngestRow> rows;
+    size_t filled = 0;
+    bool open = true;
+    while(open) {
+        std::string_view received(buffer.data(), filled);
+        size_t headEnd = received.find("\r\n\r\n");
+        RequestHead request;
+        bool whole = false;
+        if(headEnd != std::string_view::npos) {
+            size_t headLength = headEnd + 4;
+            const char *error;
+            if(!parseHead(received.substr(0, headEnd), request, error)) {
+                reply(fd, 400, error, false);
+                break;
+            } else if(request.contentLength > INGEST_REQUEST_SIZE - headLength) {
+                reply(fd, 413, "request too long\n", false);
+                break;
+            }
+            whole = filled >= headLength + request.contentLength;
+            if(whole) {
+                char *body = buffer.data() + headLength;
+                char saved = body[request.contentLength];   // the next request's first byte
+                open = handle(fd, request.method, request.path, body, request.contentLength, request.keepAlive, rows);
+                body[request.contentLength] = saved;
+                size_t used = headLength + request.contentLength;
+                memmove(buffer.data(), buffer.data() + used, filled - used);
+                filled -= used;
+            }
+        } else if(filled == INGEST_REQUEST_SIZE) {
+            reply(fd, 413, "request too long\n", false);
+            break;
+        }
+        if(!whole && open) {
+            ssize_t n = recv(fd, buffer.data() + filled, INGEST_REQUEST_SIZE - filled, 0);
+            if(n < 0 && errno == EINTR) {
+                continue;
+            }
+            open = n > 0;
+            filled += open ? n : 0;
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(_lock);
+    close(fd);
+    _connections.erase(fd);
+    _closed.notify_all();
+
+}   // end of connection()
+
+// answer one request; false if the connection is to be closed
+bool WSMIngestServer::handle(int fd, std::string_view method, std::string_view path, char *body, size_t bodyLength,
+                             bool keepAlive, std::vector<WSMIngestRow> &rows) {
+    char text[160];
+    if(method == "GET") {
+        if(path != "/stats") {
+            _refused++;
+            return reply(fd, 404, "not found\n", keepAlive);
+        }
+        snprintf(text, sizeof(text), "{\"posts\":%llu,\"events\":%llu,\"refused\":%llu,\"records\":%llu,\"commits\":%llu}\n",
+                 (unsigned long long)posts(), (unsigned long long)events(), (unsigned long long)refused(),
+                 (unsigned long long)_store.records(), (unsigned long long)_store.commits());
+        return reply(fd, 200, text, keepAlive);
+    } else if(method != "POST") {
+        _refused++;
+        return reply(fd, 405, "POST wsmEvent webhooks, or GET /stats\n", keepAlive);
+    }
+
+    WSMWebhookPost post;
+    const char *error = "no event or data";
+    rows.clear();
+    if(!parseWebhookForm(body, bodyLength, post) || webhookRows(post, rows, &error) < 0) {
+        _refused++;
+        snprintf(text, sizeof(text), "%s\n", error);
+        return reply(fd, 400, text, keepAlive);
+    }
+    if(!_store.append(rows.data(), rows.size())) {
+        _refused++;
+        return reply(fd, 503, "store failed\n", false);
+    }
+    _posts++;
+    _events += rows.size();
+    snprintf(text, sizeof(text), "%zu\n", rows.size());
+    return reply(fd, 200, text, keepAlive);
+
+}   // end of handle()
+
+bool WSMIngestServer::reply(int fd, int status, const char *body, bool keepAlive) {
+    char response[320];
+    int length = snprintf(response, sizeof(response),
+                          "HTTP/1.1 %d %s\r\nContent-Type: text/plain\r\nContent-Length: %zu\r\n%s\r\n%s", status,
+                          statusText(status), strlen(body), keepAlive ? "" : "Connection: close\r\n", body);
+    const char *p = response;
+    while(length > 0) {
+        ssize_t n = send(fd, p, length, MSG_NOSIGNAL);
+        if(n < 0 && errno == EINTR) {
+            continue;
+        } else if(n <= 0) {
+            return false;
+        }
+        p += n;
+        length -= n;
+    }
+    return keepAlive;
+}   // end of reply()
@@ -0,0 +1,76 @@
+#ifndef WSMINGESTSERVER_H_INCLUDE
+#define WSMINGESTSERVER_H_INCLUDE
+/***************************************************************************************************/
+// WSMIngestServer.h
+//  A self hosted stand in for the wsmWriteData script: an HTTP/1.1 server that takes the Particle
+//  webhook's form posts of the wsmEvent* events (WSMWebhookPost.h) and appends their rows to a
+//  WSMIngestStore, instead of one appendRow() per event and a sheet that is cut back to 2000 rows.
+//
+//      POST <any path>     a webhook post; 200 with the number of rows stored, once they are on
+//                          disk, 400 if it is not a wsmEvent* post or its data is malformed
+//      GET /stats          {"posts":..,"events":..,"refused":..,"records":..,"commits":..}
+//
+//  Each connection has its own thread and a fixed request buffer, keep-alive and pipelining are
+//  kept, and the body is decoded where it was received.  A bad request line or Content-Length is
+//  answered 400 and a request too long for the buffer 413, and the connection closed.  A post's reply waits for the store's
+//  group commit, so the posts of all the connections share the syncs.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMIngestStore.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string_view>
+#include <thread>
+
+// the longest request, headers and body, a connection takes
+const size_t INGEST_REQUEST_SIZE = 16384;
+
+class WSMIngestServer {
+    public:
+        explicit WSMIngestServer(WSMIngestStore &store);
+        ~WSMIngestServer();
+
+        // listen on address:port (port 0 picks a free one) and start taking connections; false if
+        //  the port can't be had
+        bool start(uint16_t port, const char *address = "0.0.0.0");
+
+        uint16_t port() const { return _port; }
+
+        // stop listening, close the connections and wait for their threads
+        void stop();
+
+        uint64_t posts() const { return _posts.load(); }        // stored
+        uint64_t events() const { return _events.load(); }      // rows stored
+        uint64_t refused() const { return _refused.load(); }    // requests answered with an error
+
+    private:
+        void acceptor();
+        void connection(int fd);
+        bool handle(int fd, std::string_view method, std::string_view path, char *body, size_t bodyLength,
+                    bool keepAlive, std::vector<WSMIngestRow> &rows);
+        bool reply(int fd, int status, const char *body, bool keepAlive);
+
+        WSMIngestStore &_store;
+        int _listenFd;
+        uint16_t _port;
+        std::thread _acceptor;
+
+        std::mutex _lock;
+        std::condition_variable _closed;    // a connection thread has finished
+        std::set<int> _connections;         // open connection sockets
+        bool _stopping;
+
+        std::atomic<uint64_t> _posts;
+        std::atomic<uint64_t> _events;
+        std::atomic<uint64_t> _refused;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,241 @@
+/***************************************************************************************************/
+// WSMIngestStore.cpp
+//  Append only event store with group commit.  See WSMIngestStore.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMIngestStore.h"
+#include "TPPUtils.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+    const size_t CRC_OFFSET = INGEST_RECORD_SIZE - 2;
+
+    // records read at once by read() and open()
+    const size_t READ_RECORDS = 4096;
+
+    bool writeAll(int fd, const uint8_t *bytes, size_t length) {
+        while(length > 0) {
+            ssize_t n = write(fd, bytes, length);
+            if(n < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            bytes += n;
+            length -= n;
+        }
+        return true;
+    }
+
+    size_t readAll(int fd, uint8_t *bytes, size_t length) {
+        size_t done = 0;
+        while(done < length) {
+            ssize_t n = ::read(fd, bytes + done, length - done);
+            if(n < 0 && errno == EINTR) {
+                continue;
+            } else if(n <= 0) {
+                break;
+            }
+            done += n;
+        }
+        return done;
+    }
+
+    // the valid records at the start of the file; stops at the first one cut short or failing its CRC
+    int64_t scan(int fd, const std::function<void(const WSMIngestRow &row)> &row) {
+        std::vector<uint8_t> buffer(READ_RECORDS * INGEST_RECORD_SIZE);
+        WSMIngestRow decoded;
+        int64_t records = 0;
+        while(true) {
+            size_t n = readAll(fd, buffer.data(), buffer.size());
+            for(size_t pos = 0; pos + INGEST_RECORD_SIZE <= n; pos += INGEST_RECORD_SIZE) {
+                if(!WSMIngestStore::decode(&buffer[pos], decoded)) {
+                    return records;
+                }
+                if(row) {
+                    row(decoded);
+                }
+                records++;
+            }
+            if(n < buffer.size()) {
+                return records;
+            }
+        }
+    }
+
+}   // namespace
+
+WSMIngestStore::WSMIngestStore()
+    : _fd(-1), _sync(true), _truncatedBytes(0), _group(1), _committed(0), _failed(false), _closing(false),
+      _records(0), _commits(0) {}
+
+WSMIngestStore::~WSMIngestStore() {
+    close();
+}
+
+bool WSMIngestStore::open(const char *path, bool sync) {
+    close();
+    int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if(fd < 0) {
+        return false;
+    }
+
+    // keep the whole records at the front and cut off the rest
+    struct stat status;
+    int64_t records = scan(fd, nullptr);
+    off_t valid = (off_t)records * INGEST_RECORD_SIZE;
+    if(fstat(fd, &status) != 0 || (status.st_size > valid && ftruncate(fd, valid) != 0) ||
+       lseek(fd, valid, SEEK_SET) != valid) {
+        ::close(fd);
+        return false;
+    }
+
+    _fd = fd;
+    _sync = sync;
+    _truncatedBytes = status.st_size - valid;
+    _group = 1;
+    _committed = 0;
+    _failed = false;
+    _closing = false;
+    _records = records;
+    _commits = 0;
+    _filling.clear();
+    _thread = std::thread(&WSMIngestStore::writer, this);
+    return true;
+
+}   // end of open()
+
+void WSMIngestStore::close() {
+    if(_fd < 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _closing = true;
+    }
+    _work.notify_one();
+    _thread.join();
+    ::close(_fd);
+    _fd = -1;
+}
+
+bool WSMIngestStore::append(const WSMIngestRow *rows, size_t count) {
+    std::unique_lock<std::mutex> guard(_lock);
+    if(_fd < 0 || _closing || _failed) {
+        return false;
+    } else if(count == 0) {
+        return true;    // nothing to wait for: no group would ever commit it
+    }
+    size_t at = _filling.size();
+    _filling.resize(at + count * INGEST_RECORD_SIZE);
+    for(size_t i = 0; i < count; i++) {
+        encode(rows[i], &_filling[at + i * INGEST_RECORD_SIZE]);
+    }
+    uint64_t group = _group;
+    _work.notify_one();
+    _done.wait(guard, [&]() { return _committed >= group || _failed; });
+    return _committed >= group;
+}
+
+uint64_t WSMIngestStore::records() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _records;
+}
+
+uint64_t WSMIngestStore::commits() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _commits;
+}
+
+int64_t WSMIngestStore::read(const char *path, const std::function<void(const WSMIngestRow &row)> &row) {
+    int fd = ::open(path, O_RDONLY);
+    if(fd < 0) {
+        return -1;
+    }
+    int64_t records = scan(fd, row);
+    ::close(fd);
+    return records;
+}
+
+void WSMIngestStore::encode(const WSMIngestRow &row, uint8_t *record) {
+    int8_t flags[2] = {(int8_t)row.row.pp, (int8_t)row.row.wp};
+    memcpy(record, &row.row.etime, 8);
+    memcpy(record + 8, &row.publishedAt, 8);
+    memcpy(record + 16, &row.row.temp, 4);
+    memcpy(record + 20, &row.row.rh, 4);
+    memcpy(record + 24, &row.row.ppon, 4);
+    memcpy(record + 28, &row.row.wpon, 4);
+    memcpy(record + 32, flags, 2);
+    record[34] = (uint8_t)row.row.event;
+    record[35] = 0;
+    memcpy(record + 36, row.site, INGEST_SITE_SIZE);
+    record[60] = record[61] = 0;
+    uint16_t crc = crc16(0xFFFF, record, CRC_OFFSET);
+    memcpy(record + CRC_OFFSET, &crc, 2);
+}
+
+bool WSMIngestStore::decode(const uint8_t *record, WSMIngestRow &row) {
+    uint16_t crc;
+    memcpy(&crc, record + CRC_OFFSET, 2);
+    if(crc != crc16(0xFFFF, record, CRC_OFFSET)) {
+        return false;
+    }
+    memcpy(&row.row.etime, record, 8);
+    memcpy(&row.publishedAt, record + 8, 8);
+    memcpy(&row.row.temp, record + 16, 4);
+    memcpy(&row.row.rh, record + 20, 4);
+    memcpy(&row.row.ppon, record + 24, 4);
+    memcpy(&row.row.wpon, record + 28, 4);
+    row.row.pp = (int8_t)record[32];
+    row.row.wp = (int8_t)record[33];
+    row.row.event = (WSMEventType)record[34];
+    memcpy(row.site, record + 36, INGEST_SITE_SIZE);
+    return true;
+}
+
+// Private methods
+
+// take the group being filled, write it and sync it without the lock, then wake its callers
+void WSMIngestStore::writer() {
+    std::unique_lock<std::mutex> guard(_lock);
+    while(true) {
+        _work.wait(guard, [&]() { return !_filling.empty() || _closing; });
+        if(_filling.empty()) {
+            break;  // closing, and everything committed
+        }
+        _writing.swap(_filling);
+        _filling.clear();
+        uint64_t group = _group++;
+        guard.unlock();
+
+        bool ok = writeAll(_fd, _writing.data(), _writing.size()) && (!_sync || fdatasync(_fd) == 0);
+        if(!ok) {
+            perror("ingest store");
+        }
+
+        guard.lock();
+        if(ok) {
+            _committed = group;
+            _records += _writing.size() / INGEST_RECORD_SIZE;
+            _commits++;
+        } else {
+            _failed = true;
+        }
+        _done.notify_all();
+        if(!ok) {
+            break;
+        }
+    }
+}   // end of writer()
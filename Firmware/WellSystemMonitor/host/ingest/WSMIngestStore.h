@@ -0,0 +1,85 @@
+#ifndef WSMINGESTSTORE_H_INCLUDE
+#define WSMINGESTSTORE_H_INCLUDE
+/***************************************************************************************************/
+// WSMIngestStore.h
+//  The append only file the ingest service (WSMIngestServer.h) keeps the events in, one 64 byte
+//  record per sheet row, little endian:
+//
+//      0-7     etime               32-33   pp, wp (-1 if missing)
+//      8-15    published_at        34      WSMEventType
+//      16-31   temp, rh, ppon,     35      0
+//              wpon (NaN if        36-59   site: the coreid, zero padded
+//              missing)            60-61   0
+//                                  62-63   CRC-16/CCITT of bytes 0-61
+//
+//  append() may be called from any number of threads and returns once the rows are on disk.  The
+//  rows of every caller waiting while the file is written and synced go out together in the next
+//  write() and fdatasync() (group commit), so one sync serves as many posts as arrive during the
+//  last one.  A record cut short, or one that fails its CRC, at the end of the file (a crash in
+//  the middle of a write) is cut off by open().
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMWebhookPost.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const size_t INGEST_RECORD_SIZE = 64;
+
+class WSMIngestStore {
+    public:
+        WSMIngestStore();
+        ~WSMIngestStore();
+
+        // open or create the store and start its writer thread; sync false leaves out the
+        //  fdatasync() (for benchmarks).  False if the file can't be opened.
+        bool open(const char *path, bool sync = true);
+
+        // commit what is waiting, stop the writer and close the file
+        void close();
+
+        // write rows and wait until they are on disk (or written, without sync); false if the
+        //  store is closed or the write failed.  No rows returns true at once.  Thread safe.
+        bool append(const WSMIngestRow *rows, size_t count);
+
+        uint64_t records() const;           // in the file, committed
+        uint64_t commits() const;           // writes (and syncs) since open()
+        uint64_t truncatedBytes() const { return _truncatedBytes; }    // cut off by open()
+
+        // call row for each valid record of the store at path, in order; returns the number of
+        //  records, or -1 if the file can't be read
+        static int64_t read(const char *path, const std::function<void(const WSMIngestRow &row)> &row);
+
+        static void encode(const WSMIngestRow &row, uint8_t *record);
+        static bool decode(const uint8_t *record, WSMIngestRow &row);  // false if its CRC fails
+
+    private:
+        void writer();
+
+        int _fd;
+        bool _sync;
+        uint64_t _truncatedBytes;
+
+        mutable std::mutex _lock;
+        std::condition_variable _work;      // rows are waiting, or closing
+        std::condition_variable _done;      // a group has been committed
+        std::vector<uint8_t> _filling;      // records of the group being filled
+        std::vector<uint8_t> _writing;      // records of the group being written
+        uint64_t _group;                    // the group being filled
+        uint64_t _committed;                // the last group written
+        bool _failed;                       // a write has failed; the store takes no more
+        bool _closing;
+        uint64_t _records;
+        uint64_t _commits;
+        std::thread _thread;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,133 @@
+/***************************************************************************************************/
+// WSMJsonReader.cpp
+//  Zero copy reader for flat JSON objects.  See WSMJsonReader.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMJsonReader.h"
+
+#include <charconv>
+
+namespace {
+
+    bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    size_t skipBlanks(std::string_view text, size_t pos) {
+        while(pos < text.size() && isBlank(text[pos])) {
+            pos++;
+        }
+        return pos;
+    }
+
+    // the string whose opening quote is at text[pos]; pos is left after its closing quote
+    bool readString(std::string_view text, size_t &pos, std::string_view &value) {
+        size_t begin = pos + 1;
+        for(size_t i = begin; i < text.size(); i++) {
+            if(text[i] == '\\') {
+                i++;
+            } else if(text[i] == '"') {
+                value = text.substr(begin, i - begin);
+                pos = i + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // a number, true, false or null starting at text[pos]; pos is left after it
+    bool readLiteral(std::string_view text, size_t &pos, std::string_view &value) {
+        size_t begin = pos;
+        while(pos < text.size() && text[pos] != ',' && text[pos] != '}' && !isBlank(text[pos])) {
+            if(text[pos] == '{' || text[pos] == '[' || text[pos] == '"') {
+                return false;   // nested, or not a value
+            }
+            pos++;
+        }
+        value = text.substr(begin, pos - begin);
+        return !value.empty();
+    }
+
+}   // namespace
+
+bool WSMJsonReader::read(std::string_view text) {
+    _size = 0;
+    _length = 0;
+    size_t pos = skipBlanks(text, 0);
+    if(pos >= text.size() || text[pos] != '{') {
+        return false;
+    }
+    pos = skipBlanks(text, pos + 1);
+    if(pos < text.size() && text[pos] == '}') {
+        _length = pos + 1;
+        return true;
+    }
+
+    while(pos < text.size()) {
+        if(_size == MAX_MEMBERS || text[pos] != '"') {
+            return false;
+        }
+        WSMJsonMember &member = _members[_size];
+        if(!readString(text, pos, member.key)) {
+            return false;
+        }
+        pos = skipBlanks(text, pos);
+        if(pos >= text.size() || text[pos] != ':') {
+            return false;
+        }
+        pos = skipBlanks(text, pos + 1);
+        if(pos >= text.size()) {
+            return false;
+        }
+        member.string = text[pos] == '"';
+        if(member.string ? !readString(text, pos, member.value) : !readLiteral(text, pos, member.value)) {
+            return false;
+        }
+        _size++;
+
+        pos = skipBlanks(text, pos);
+        if(pos >= text.size()) {
+            return false;
+        } else if(text[pos] == '}') {
+            _length = pos + 1;
+            return true;
+        } else if(text[pos] != ',') {
+            return false;
+        }
+        pos = skipBlanks(text, pos + 1);
+    }
+    return false;
+
+}   // end of read()
+
+const WSMJsonMember *WSMJsonReader::find(std::string_view key) const {
+    for(unsigned int i = 0; i < _size; i++) {
+        if(_members[i].key == key) {
+            return &_members[i];
+        }
+    }
+    return nullptr;
+}
+
+bool WSMJsonReader::number(std::string_view key, double &value) const {
+    const WSMJsonMember *member = find(key);
+    if(member == nullptr || member->string) {
+        return false;
+    }
+    const char *end = member->value.data() + member->value.size();
+    std::from_chars_result result = std::from_chars(member->value.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+bool WSMJsonReader::string(std::string_view key, std::string_view &value) const {
+    const WSMJsonMember *member = find(key);
+    if(member == nullptr || !member->string) {
+        return false;
+    }
+    value = member->value;
+    return true;
+}
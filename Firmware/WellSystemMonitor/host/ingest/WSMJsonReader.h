@@ -0,0 +1,56 @@
+#ifndef WSMJSONREADER_H_INCLUDE
+#define WSMJSONREADER_H_INCLUDE
+/***************************************************************************************************/
+// WSMJsonReader.h
+//  Zero copy reader for the flat JSON objects the firmware publishes, such as
+//
+//      {"etime":1664279461,"pp":0,"ppon":1.433333,"loctime":"2022-09-27 04:51:01"}
+//
+//  read() finds the members of one object in place: each key and value is a view into the text
+//  (strings without their quotes and still escaped, numbers as written), so reading an event makes
+//  no allocation and copies nothing.  Nested objects and arrays are refused; a wsmEventBatch is
+//  read one event at a time, with length() to step from one to the next.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <cstddef>
+#include <string_view>
+
+// one member of an object, pointing into the text that was read
+struct WSMJsonMember {
+    std::string_view key;
+    std::string_view value;     // a string without its quotes, or a number, true, false or null
+    bool string;                // value was quoted
+};
+
+class WSMJsonReader {
+    public:
+        static const unsigned int MAX_MEMBERS = 16;
+
+        // read the object at the start of text (after any blanks); false if it is not a flat
+        //  object of at most MAX_MEMBERS members.  The text must outlive the members.
+        bool read(std::string_view text);
+
+        size_t length() const { return _length; }          // bytes of text read, through the '}'
+        unsigned int size() const { return _size; }         // members
+        const WSMJsonMember &member(unsigned int i) const { return _members[i]; }
+
+        // the member named key, or nullptr
+        const WSMJsonMember *find(std::string_view key) const;
+
+        // the value of key as a number; false if it is missing or not a number
+        bool number(std::string_view key, double &value) const;
+
+        // the value of key as a string, still escaped; false if it is missing or not a string
+        bool string(std::string_view key, std::string_view &value) const;
+
+    private:
+        WSMJsonMember _members[MAX_MEMBERS];
+        unsigned int _size = 0;
+        size_t _length = 0;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,278 @@
+/***************************************************************************************************/
+// WSMWebhookPost.cpp
+//  Decodes wsmEvent* webhook posts into sheet rows.  See WSMWebhookPost.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMWebhookPost.h"
+#include "WSMJsonReader.h"
+#include "WSMEventPack.h"
+#include "WSMPackDecoder.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+    const char BATCH_EVENT[] = "wsmEventBatch";
+    const char BATCH_PREFIX[] = "{\"events\":[";
+
+    int hexDigit(char c) {
+        if(c >= '0' && c <= '9') {
+            return c - '0';
+        } else if(c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        } else if(c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    // decode text[0, length) in place and terminate it; false if a %XX is bad
+    bool formDecode(char *text, size_t length, std::string_view &decoded) {
+        size_t out = 0;
+        for(size_t in = 0; in < length; in++) {
+            char c = text[in];
+            if(c == '+') {
+                c = ' ';
+            } else if(c == '%') {
+                int high = in + 2 < length ? hexDigit(text[in + 1]) : -1;
+                int low = high >= 0 ? hexDigit(text[in + 2]) : -1;
+                if(low < 0) {
+                    return false;
+                }
+                c = (char)(high * 16 + low);
+                in += 2;
+            }
+            text[out++] = c;
+        }
+        text[out] = '\0';
+        decoded = std::string_view(text, out);
+        return true;
+    }
+
+    WSMEventType eventType(std::string_view name) {
+        if(name == "wsmEventTRH") {
+            return WSM_EVENT_TRH;
+        } else if(name == "wsmEventPPstatus") {
+            return WSM_EVENT_PP_STATUS;
+        } else if(name == "wsmEventWPstatus") {
+            return WSM_EVENT_WP_STATUS;
+        }
+        return WSM_EVENT_OTHER;
+    }
+
+    // the number under key as a float, missing if there is none; false if a float can't hold it
+    bool floatOr(const WSMJsonReader &json, const char *key, float missing, float &value) {
+        double number;
+        if(!json.number(key, number)) {
+            value = missing;
+            return true;
+        } else if(!(number >= -FLT_MAX && number <= FLT_MAX)) {
+            return false;
+        }
+        value = (float)number;
+        return true;
+    }
+
+    // a pump state: 0 or 1, -1 if there is none; false if it is anything else
+    bool pumpOr(const WSMJsonReader &json, const char *key, int &state) {
+        double number;
+        if(!json.number(key, number)) {
+            state = -1;
+            return true;
+        } else if(number != 0.0 && number != 1.0) {
+            return false;
+        }
+        state = (int)number;
+        return true;
+    }
+
+    // the row of one event, read from its JSON; false if it has no etime, or a value is out of range
+    bool jsonRow(const WSMJsonReader &json, WSMEventType event, WSMDataRow &row) {
+        double etime;
+        if(!json.number("etime", etime) || !(etime >= -9223372036854775808.0 && etime < 9223372036854775808.0)) {
+            return false;
+        }
+        row.etime = (int64_t)etime;
+        row.event = event;
+        return floatOr(json, "temp", NAN, row.temp) && floatOr(json, "rh", NAN, row.rh) &&
+               pumpOr(json, "pp", row.pp) && pumpOr(json, "wp", row.wp) &&
+               floatOr(json, "ppon", NAN, row.ppon) && floatOr(json, "wpon", NAN, row.wpon);
+    }
+
+    // the row of a packed event, from the values as packed
+    void packedRow(const WSMJournalRecord &record, WSMDataRow &row) {
+        row.etime = record.etime;
+        row.temp = row.rh = row.ppon = row.wpon = NAN;
+        row.pp = row.wp = -1;
+        switch(record.kind) {
+            case JOURNAL_TRH:
+                row.event = WSM_EVENT_TRH;
+                row.temp = record.value1;
+                row.rh = record.value2;
+                break;
+            case JOURNAL_PP_ON:
+            case JOURNAL_PP_OFF:
+                row.event = WSM_EVENT_PP_STATUS;
+                row.pp = record.kind == JOURNAL_PP_ON ? 1 : 0;
+                if(record.kind == JOURNAL_PP_OFF) {
+                    row.ppon = record.value1;
+                }
+                break;
+            default:
+                row.event = WSM_EVENT_WP_STATUS;
+                row.wp = record.kind == JOURNAL_WP_ON ? 1 : 0;
+                if(record.kind == JOURNAL_WP_OFF) {
+                    row.wpon = record.value1;
+                }
+                break;
+        }
+    }
+
+    // {"events":[{"ev":"wsmEventPPstatus",...},...]}, one object at a time
+    bool batchRows(std::string_view data, WSMIngestRow &proto, std::vector<WSMIngestRow> &rows) {
+        const size_t prefixLength = sizeof(BATCH_PREFIX) - 1;
+        if(data.compare(0, prefixLength, BATCH_PREFIX) != 0) {
+            return false;
+        }
+        WSMJsonReader json;
+        std::string_view ev;
+        size_t pos = prefixLength;
+        while(pos < data.size() && data[pos] != ']') {
+            if(!json.read(data.substr(pos)) || !json.string("ev", ev)) {
+                return false;
+            }
+            WSMEventType event = eventType(ev);
+            if(event == WSM_EVENT_OTHER || !jsonRow(json, event, proto.row)) {
+                return false;
+            }
+            rows.push_back(proto);
+            pos += json.length();
+            if(pos < data.size() && data[pos] == ',') {
+                pos++;
+            }
+        }
+        return data.substr(pos) == "]}";
+    }
+
+    bool packRows(std::string_view data, WSMIngestRow &proto, std::vector<WSMIngestRow> &rows) {
+        thread_local WSMPackDecoder decoder;
+        if(!decoder.decode(data.data())) {
+            return false;
+        }
+        for(const WSMPackedEvent &packed : decoder.events()) {
+            packedRow(packed.record, proto.row);
+            rows.push_back(proto);
+        }
+        return true;
+    }
+
+}   // namespace
+
+bool parseWebhookForm(char *body, size_t length, WSMWebhookPost &post) {
+    post = WSMWebhookPost();
+    size_t pos = 0;
+    while(pos < length) {
+        char *field = body + pos;
+        char *end = (char *)memchr(field, '&', length - pos);
+        size_t fieldLength = end != nullptr ? (size_t)(end - field) : length - pos;
+        pos += fieldLength + 1;
+
+        char *equals = (char *)memchr(field, '=', fieldLength);
+        if(equals == nullptr) {
+            continue;   // a bare name carries nothing
+        }
+        std::string_view name(field, equals - field);
+        std::string_view value;
+        if(!formDecode(equals + 1, field + fieldLength - (equals + 1), value)) {
+            return false;
+        }
+        if(name == "event") {
+            post.event = value;
+        } else if(name == "data") {
+            post.data = value;
+        } else if(name == "published_at") {
+            post.publishedAt = value;
+        } else if(name == "coreid") {
+            post.coreid = value;
+        }
+    }
+    return !post.event.empty() && post.data.data() != nullptr;
+
+}   // end of parseWebhookForm()
+
+bool parsePublishedAt(std::string_view text, int64_t &unixTime) {
+    // YYYY-MM-DDTHH:MM:SS, then fractions of a second and a Z, which are ignored
+    const int FIELDS = 6;
+    const char SEPARATORS[FIELDS] = {'-', '-', 'T', ':', ':', '\0'};
+    int values[FIELDS];
+    const char *p = text.data();
+    const char *end = p + text.size();
+    for(int i = 0; i < FIELDS; i++) {
+        std::from_chars_result result = std::from_chars(p, end, values[i]);
+        if(result.ec != std::errc() || (SEPARATORS[i] != '\0' && (result.ptr == end || *result.ptr != SEPARATORS[i]))) {
+            return false;
+        }
+        p = result.ptr + 1;
+    }
+    int year = values[0], month = values[1], day = values[2];
+    if(month < 1 || month > 12 || day < 1 || day > 31 || values[3] > 23 || values[4] > 59 || values[5] > 60) {
+        return false;
+    }
+
+    // days since 1970-01-01 in the proleptic Gregorian calendar, with the year starting in March
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yearOfEra = year - era * 400;
+    int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    int64_t days = era * 146097 + dayOfEra - 719468;
+    unixTime = days * 86400 + values[3] * 3600 + values[4] * 60 + values[5];
+    return true;
+
+}   // end of parsePublishedAt()
+
+int webhookRows(const WSMWebhookPost &post, std::vector<WSMIngestRow> &rows, const char **error) {
+    WSMIngestRow proto;
+    if(post.publishedAt.empty() || !parsePublishedAt(post.publishedAt, proto.publishedAt)) {
+        proto.publishedAt = 0;
+    }
+    memset(proto.site, 0, sizeof(proto.site));
+    memcpy(proto.site, post.coreid.data(), std::min(post.coreid.size(), sizeof(proto.site)));
+
+    size_t before = rows.size();
+    bool ok;
+    const char *why = "malformed data";
+    WSMEventType event = eventType(post.event);
+    if(event != WSM_EVENT_OTHER) {
+        WSMJsonReader json;
+        ok = json.read(post.data) && jsonRow(json, event, proto.row);
+        if(ok) {
+            rows.push_back(proto);
+        }
+    } else if(post.event == BATCH_EVENT) {
+        ok = batchRows(post.data, proto, rows);
+    } else if(post.event == EVENT_PACK_NAME) {
+        ok = packRows(post.data, proto, rows);
+    } else {
+        ok = false;
+        why = "not a wsmEvent";
+    }
+
+    if(!ok) {
+        rows.resize(before);
+        if(error != nullptr) {
+            *error = why;
+        }
+        return -1;
+    }
+    return (int)(rows.size() - before);
+
+}   // end of webhookRows()
@@ -0,0 +1,57 @@
+#ifndef WSMWEBHOOKPOST_H_INCLUDE
+#define WSMWEBHOOKPOST_H_INCLUDE
+/***************************************************************************************************/
+// WSMWebhookPost.h
+//  The wsmEvent* webhook posts as the ingest service (WSMIngestServer.h) receives them: the
+//  Particle webhook's form body
+//
+//      event=wsmEventPPstatus&data=%7B%22etime%22%3A1664279461%2C...%7D&published_at=2022-09-27T11%3A51%3A02.123Z&coreid=...
+//
+//  is decoded in place, and its data turned into the rows the wsmWriteData script writes to the
+//  sheet: one for wsmEventTRH, wsmEventPPstatus and wsmEventWPstatus, one per event for a
+//  wsmEventBatch or a wsmEventPack.  The fields and the JSON are read where they lie in the body
+//  (WSMJsonReader.h), so a post costs no allocation once the row vector has grown.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMDataReader.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// bytes of the site (the coreid of the device, 24 hex digits) kept with each row
+const size_t INGEST_SITE_SIZE = 24;
+
+// the form fields of a post, pointing into the decoded body
+struct WSMWebhookPost {
+    std::string_view event;
+    std::string_view data;          // null terminated in the body
+    std::string_view publishedAt;
+    std::string_view coreid;
+};
+
+// one event as stored: the sheet's columns, when it was published and where from
+struct WSMIngestRow {
+    WSMDataRow row;
+    int64_t publishedAt;                // unix time; 0 if the post had none
+    char site[INGEST_SITE_SIZE];        // the coreid, zero padded
+};
+
+// decode an application/x-www-form-urlencoded body in place ('+' and %XX) into post.  The body
+//  needs one writable byte after length.  False if a field is badly encoded or event or data is
+//  missing.
+bool parseWebhookForm(char *body, size_t length, WSMWebhookPost &post);
+
+// a published_at time, "2022-09-27T11:51:02.123Z", as unix seconds; false if it is not one
+bool parsePublishedAt(std::string_view text, int64_t &unixTime);
+
+// append the rows of post to rows and return how many; -1, with rows as they were and error set,
+//  if the event is not a wsmEvent* one or its data is malformed: a pp or wp other than 0 or 1, or an
+//  etime or value out of range, is malformed too
+int webhookRows(const WSMWebhookPost &post, std::vector<WSMIngestRow> &rows, const char **error = nullptr);
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,238 @@
+/***************************************************************************************************/
+// HostString.cpp
+//  Host (Linux) stand-in for the Particle Wiring String class.  See HostString.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "HostString.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+// integer formatting in an arbitrary base, as the Wiring String does
+static std::string formatUnsigned(unsigned long long value, unsigned char base) {
+    if(base < 2 || base > 36) {
+        base = 10;
+    }
+    char buf[66];
+    int pos = sizeof(buf) - 1;
+    buf[pos] = '\0';
+    do {
+        unsigned digit = (unsigned)(value % base);
+        buf[--pos] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= base;
+    } while(value != 0);
+    return std::string(&buf[pos]);
+}
+
+static std::string formatSigned(long long value, unsigned char base) {
+    if(value < 0 && base == 10) {
+        return "-" + formatUnsigned(0ULL - (unsigned long long)value, base);
+    }
+    return formatUnsigned((unsigned long long)value, base);
+}
+
+static std::string formatDouble(double value, int decimalPlaces) {
+    char buf[64];
+    if(decimalPlaces < 0) {
+        decimalPlaces = 0;
+    }
+    snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    return std::string(buf);
+}
+
+// Constructors
+String::String() {}
+String::String(const char *cstr) : _buffer(cstr ? cstr : "") {}
+String::String(const std::string &str) : _buffer(str) {}
+String::String(char c) : _buffer(1, c) {}
+String::String(unsigned char value, unsigned char base) : _buffer(formatUnsigned(value, base)) {}
+String::String(int value, unsigned char base) : _buffer(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : _buffer(formatUnsigned(value, base)) {}
+String::String(long value, unsigned char base) : _buffer(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : _buffer(formatUnsigned(value, base)) {}
+String::String(long long value, unsigned char base) : _buffer(formatSigned(value, base)) {}
+String::String(unsigned long long value, unsigned char base) : _buffer(formatUnsigned(value, base)) {}
+String::String(float value, int decimalPlaces) : _buffer(formatDouble(value, decimalPlaces)) {}
+String::String(double value, int decimalPlaces) : _buffer(formatDouble(value, decimalPlaces)) {}
+
+// memory management
+bool String::reserve(unsigned int size) {
+    _buffer.reserve(size);
+    return true;
+}
+
+unsigned int String::length() const {
+    return (unsigned int)_buffer.length();
+}
+
+// concatenation
+String &String::operator+=(const String &rhs) {
+    _buffer += rhs._buffer;
+    return *this;
+}
+
+String &String::operator+=(const char *cstr) {
+    if(cstr) {
+        _buffer += cstr;
+    }
+    return *this;
+}
+
+String &String::operator+=(char c) {
+    _buffer += c;
+    return *this;
+}
+
+String &String::concat(const String &rhs) {
+    return *this += rhs;
+}
+
+// comparison
+bool String::equals(const String &rhs) const {
+    return _buffer == rhs._buffer;
+}
+
+bool String::equals(const char *cstr) const {
+    return _buffer == (cstr ? cstr : "");
+}
+
+bool String::operator==(const String &rhs) const {
+    return equals(rhs);
+}
+
+bool String::operator==(const char *cstr) const {
+    return equals(cstr);
+}
+
+bool String::operator!=(const String &rhs) const {
+    return !equals(rhs);
+}
+
+bool String::operator!=(const char *cstr) const {
+    return !equals(cstr);
+}
+
+bool String::startsWith(const String &prefix) const {
+    return _buffer.compare(0, prefix._buffer.length(), prefix._buffer) == 0;
+}
+
+bool String::endsWith(const String &suffix) const {
+    if(suffix._buffer.length() > _buffer.length()) {
+        return false;
+    }
+    return _buffer.compare(_buffer.length() - suffix._buffer.length(), suffix._buffer.length(), suffix._buffer) == 0;
+}
+
+// character access and search
+char String::charAt(unsigned int index) const {
+    return index < _buffer.length() ? _buffer[index] : '\0';
+}
+
+char String::operator[](unsigned int index) const {
+    return charAt(index);
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+    std::string::size_type pos = _buffer.find(ch, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String &str, unsigned int fromIndex) const {
+    std::string::size_type pos = _buffer.find(str._buffer, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char ch) const {
+    std::string::size_type pos = _buffer.rfind(ch);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, length());
+}
+
+// as in Wiring, the indexes are swapped if given in the wrong order and clamped to the length
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if(beginIndex > endIndex) {
+        std::swap(beginIndex, endIndex);
+    }
+    if(beginIndex > length()) {
+        return String();
+    }
+    if(endIndex > length()) {
+        endIndex = length();
+    }
+    return String(_buffer.substr(beginIndex, endIndex - beginIndex));
+}
+
+// modification
+String &String::trim() {
+    std::string::size_type first = 0;
+    while(first < _buffer.length() && isspace((unsigned char)_buffer[first])) {
+        first++;
+    }
+    std::string::size_type last = _buffer.length();
+    while(last > first && isspace((unsigned char)_buffer[last - 1])) {
+        last--;
+    }
+    _buffer = _buffer.substr(first, last - first);
+    return *this;
+}
+
+String &String::toUpperCase() {
+    for(char &c : _buffer) {
+        c = (char)toupper((unsigned char)c);
+    }
+    return *this;
+}
+
+String &String::toLowerCase() {
+    for(char &c : _buffer) {
+        c = (char)tolower((unsigned char)c);
+    }
+    return *this;
+}
+
+// conversion
+long String::toInt() const {
+    return strtol(_buffer.c_str(), nullptr, 10);
+}
+
+float String::toFloat() const {
+    return strtof(_buffer.c_str(), nullptr);
+}
+
+const char *String::c_str() const {
+    return _buffer.c_str();
+}
+
+// free concatenation operators
+String operator+(const String &lhs, const String &rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const String &lhs, const char *rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const char *lhs, const String &rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const String &lhs, char rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
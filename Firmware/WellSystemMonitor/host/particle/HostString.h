@@ -0,0 +1,83 @@
+#ifndef HOSTSTRING_H_INCLUDE
+#define HOSTSTRING_H_INCLUDE
+/***************************************************************************************************/
+// HostString.h
+//  Host (Linux) stand-in for the Particle Wiring String class.  Only the parts of the API used by
+//  the Well System Monitor firmware are implemented.  Numeric conversions follow the Particle
+//  rules: integers in base 10 and floats with 6 decimal places unless told otherwise.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <string>
+
+class String {
+    public:
+        String();
+        String(const char *cstr);
+        String(const std::string &str);
+        explicit String(char c);
+        explicit String(unsigned char value, unsigned char base = 10);
+        explicit String(int value, unsigned char base = 10);
+        explicit String(unsigned int value, unsigned char base = 10);
+        explicit String(long value, unsigned char base = 10);
+        explicit String(unsigned long value, unsigned char base = 10);
+        explicit String(long long value, unsigned char base = 10);
+        explicit String(unsigned long long value, unsigned char base = 10);
+        explicit String(float value, int decimalPlaces = 6);
+        explicit String(double value, int decimalPlaces = 6);
+
+        // memory management
+        bool reserve(unsigned int size);
+        unsigned int length() const;
+
+        // concatenation
+        String &operator+=(const String &rhs);
+        String &operator+=(const char *cstr);
+        String &operator+=(char c);
+        String &concat(const String &rhs);
+
+        // comparison
+        bool equals(const String &rhs) const;
+        bool equals(const char *cstr) const;
+        bool operator==(const String &rhs) const;
+        bool operator==(const char *cstr) const;
+        bool operator!=(const String &rhs) const;
+        bool operator!=(const char *cstr) const;
+        bool startsWith(const String &prefix) const;
+        bool endsWith(const String &suffix) const;
+
+        // character access and search
+        char charAt(unsigned int index) const;
+        char operator[](unsigned int index) const;
+        int indexOf(char ch, unsigned int fromIndex = 0) const;
+        int indexOf(const String &str, unsigned int fromIndex = 0) const;
+        int lastIndexOf(char ch) const;
+        String substring(unsigned int beginIndex) const;
+        String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+        // modification
+        String &trim();
+        String &toUpperCase();
+        String &toLowerCase();
+
+        // conversion
+        long toInt() const;
+        float toFloat() const;
+        const char *c_str() const;
+
+        // host only: the underlying storage
+        const std::string &str() const { return _buffer; }
+
+    private:
+        std::string _buffer;
+};
+
+String operator+(const String &lhs, const String &rhs);
+String operator+(const String &lhs, const char *rhs);
+String operator+(const char *lhs, const String &rhs);
+String operator+(const String &lhs, char rhs);
+
+#endif  // end of header duplication prevention
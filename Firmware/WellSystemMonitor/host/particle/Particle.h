@@ -0,0 +1,5 @@
+/***************************************************************************************************/
+// Particle.h
+//  Host (Linux) stand-in for the Particle Device OS header.  See application.h
+/***************************************************************************************************/
+#include "application.h"
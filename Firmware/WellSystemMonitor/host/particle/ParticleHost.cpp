@@ -0,0 +1,764 @@
+/***************************************************************************************************/
+// ParticleHost.cpp
+//  Host (Linux) implementation of the Particle Device OS calls declared in application.h and of
+//  the host controls declared in ParticleHost.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+#include "ParticleHost.h"
+#include "ParticleHostInternal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <map>
+
+// the Device OS singletons
+CloudClass Particle;
+WiFiClass WiFi;
+SystemClass System;
+TimeClass Time;
+SerialClass Serial;
+EEPROMClass EEPROM;
+
+namespace {
+
+    // a variable registered with Particle.variable()
+    struct CloudVariable {
+        enum { STRING, CHARS, INT, DOUBLE } type;
+        const void *pointer;
+    };
+
+    const time_t DEFAULT_UNIX_TIME = 1704067200;    // 2024-01-01 00:00:00 UTC
+
+    // the Particle cloud publish limit: an average of one a second, in bursts of up to four
+    const uint64_t PUBLISH_PERIOD_MS = 1000;
+    const uint64_t PUBLISH_BURST = 4;
+
+    struct HostState {
+        uint64_t micros = 0;
+        uint32_t millisOffset = 0;
+        time_t unixAtReset = DEFAULT_UNIX_TIME;
+        float zoneHours = 0.0;
+        bool timeValid = true;
+        bool realTicks = true;
+
+        uint8_t pinLevel[TOTAL_PINS];
+        uint8_t outputLevel[TOTAL_PINS];
+        PinMode pinMode[TOTAL_PINS];
+        std::multimap<uint64_t, std::pair<uint16_t, uint8_t>> pinSchedule;     // by uptime in microseconds
+        wiring_interrupt_handler_t interruptHandler[TOTAL_PINS];
+        InterruptMode interruptMode[TOTAL_PINS];
+        bool inInterrupt = false;
+        int servoAngle = 0;
+
+        float dhtCelsius = 20.0;
+        float dhtHumidity = 50.0;
+        int dhtStatus = 0;
+        uint32_t dhtAcquireMs = 0;
+        ParticleHost::DHTModel dhtModel;
+
+        bool cloudConnected = true;
+        bool capturePublishes = true;
+        uint64_t publishCount = 0;
+        uint64_t publishesRejected = 0;
+        bool rateLimit = false;
+        uint64_t rateTokensFullMs = 0;  // uptime at which the publish token bucket is full again
+        ParticleHost::PublishSink publishSink;
+        std::vector<ParticleHost::PublishRecord> published;
+        std::map<std::string, CloudVariable> variables;
+        std::map<std::string, int (*)(String)> functions;
+
+        bool serialEcho = false;
+        std::string serialOutput;
+
+        HostState() {
+            for(int i = 0; i < TOTAL_PINS; i++) {
+                pinLevel[i] = HIGH;
+                outputLevel[i] = LOW;
+                pinMode[i] = INPUT;
+                interruptHandler[i] = nullptr;
+                interruptMode[i] = CHANGE;
+            }
+        }
+    };
+
+    HostState &state() {
+        static HostState s;
+        return s;
+    }
+
+    // the EEPROM outlives reset(), like the flash it is emulated in, when it is backed by a file
+    const size_t EEPROM_SIZE = 2047;
+
+    struct EEPROMState {
+        uint8_t bytes[EEPROM_SIZE];
+        uint64_t writes[EEPROM_SIZE];   // byte writes per address, since reset()
+        FILE *file = nullptr;
+
+        EEPROMState() {
+            memset(bytes, 0xFF, sizeof(bytes));
+            memset(writes, 0, sizeof(writes));
+        }
+    };
+
+    EEPROMState &eeprom() {
+        static EEPROMState e;
+        return e;
+    }
+
+    // power on: the file's contents, or erased; a short file (cut off by a power loss) reads
+    // erased past its end and is filled out again
+    void loadEEPROM() {
+        EEPROMState &e = eeprom();
+        memset(e.bytes, 0xFF, sizeof(e.bytes));
+        memset(e.writes, 0, sizeof(e.writes));
+        if(e.file != nullptr) {
+            rewind(e.file);
+            size_t length = fread(e.bytes, 1, EEPROM_SIZE, e.file);
+            if(length < EEPROM_SIZE) {
+                fseek(e.file, (long)length, SEEK_SET);
+                fwrite(e.bytes + length, 1, EEPROM_SIZE - length, e.file);
+                fflush(e.file);
+            }
+        }
+    }
+
+    // set by worker threads that run their own alert processors; bypasses the shared state
+    thread_local ParticleHost::PublishSink threadPublishSink;
+    thread_local time_t threadUnixTime = 0;     // their own clock; 0 for the virtual one
+
+    // the Photon's EXTI line for each pin, or -1 for none; pins on one line share a handler
+    int interruptLine(uint16_t pin) {
+        static const int LINES[TOTAL_PINS] = {
+            -1, 6, 5, 4, 3, 15, 14, 13,         // D0 - D7 (D0 shares line 7 with A5, which the system uses)
+            -1, -1,
+            5, 3, 2, 5, 6, -1, 4, 0,            // A0 - A7
+            -1, -1, -1, -1, -1, -1
+        };
+        return pin < TOTAL_PINS ? LINES[pin] : -1;
+    }
+
+    // set a pin level that changed at uptime atMicros, and run its interrupt handler if the change
+    // is one it was attached for; micros() reads atMicros in the handler
+    void changePin(uint16_t pin, uint8_t level, uint64_t atMicros) {
+        HostState &s = state();
+        uint8_t previous = s.pinLevel[pin];
+        s.pinLevel[pin] = level;
+        wiring_interrupt_handler_t handler = s.interruptHandler[pin];
+        if(handler == nullptr || level == previous || s.inInterrupt) {
+            return;
+        }
+        InterruptMode mode = s.interruptMode[pin];
+        if(mode == CHANGE || (mode == RISING && level == HIGH) || (mode == FALLING && level == LOW)) {
+            uint64_t now = s.micros;
+            s.micros = std::min(atMicros, now);
+            s.inInterrupt = true;
+            handler();
+            s.inInterrupt = false;
+            s.micros = now;
+        }
+    }
+
+    // apply any scheduled pin levels that are due at the current virtual time, in time order
+    void applyPinSchedule() {
+        HostState &s = state();
+        if(s.inInterrupt) {
+            return;
+        }
+        while(!s.pinSchedule.empty() && s.pinSchedule.begin()->first <= s.micros) {
+            uint64_t atMicros = s.pinSchedule.begin()->first;
+            std::pair<uint16_t, uint8_t> change = s.pinSchedule.begin()->second;
+            s.pinSchedule.erase(s.pinSchedule.begin());
+            changePin(change.first, change.second, atMicros);
+        }
+    }
+
+    size_t serialWrite(const std::string &text) {
+        HostState &s = state();
+        s.serialOutput += text;
+        if(s.serialEcho) {
+            fwrite(text.data(), 1, text.size(), stdout);
+        }
+        return text.size();
+    }
+
+    bool doPublish(const char *eventName, const char *eventData) {
+        if(threadPublishSink) {
+            ParticleHost::PublishRecord record;
+            record.uptimeMs = state().micros / 1000;
+            record.unixTime = Time.now();
+            record.name = eventName ? eventName : "";
+            record.data = eventData ? eventData : "";
+            threadPublishSink(record);
+            return true;
+        }
+        HostState &s = state();
+        if(!s.cloudConnected) {
+            s.publishesRejected++;
+            return false;
+        }
+        if(s.rateLimit) {
+            // a bucket of PUBLISH_BURST tokens, one added every PUBLISH_PERIOD_MS
+            uint64_t nowMs = s.micros / 1000;
+            uint64_t full = std::max(s.rateTokensFullMs, nowMs);
+            if(full + PUBLISH_PERIOD_MS > nowMs + PUBLISH_BURST * PUBLISH_PERIOD_MS) {
+                s.publishesRejected++;
+                return false;
+            }
+            s.rateTokensFullMs = full + PUBLISH_PERIOD_MS;
+        }
+        s.publishCount++;
+        if(!s.capturePublishes && !s.publishSink) {
+            return true;
+        }
+        ParticleHost::PublishRecord record;
+        record.uptimeMs = s.micros / 1000;
+        record.unixTime = Time.now();
+        record.name = eventName ? eventName : "";
+        record.data = eventData ? eventData : "";
+        if(s.publishSink) {
+            s.publishSink(record);
+        }
+        if(s.capturePublishes) {
+            s.published.push_back(std::move(record));
+        }
+        return true;
+    }
+
+}   // namespace
+
+/*************************************** Wiring I/O ********************************************/
+void pinMode(uint16_t pin, PinMode mode) {
+    if(pin < TOTAL_PINS) {
+        state().pinMode[pin] = mode;
+    }
+}
+
+void digitalWrite(uint16_t pin, uint8_t value) {
+    if(pin < TOTAL_PINS) {
+        state().outputLevel[pin] = value ? HIGH : LOW;
+    }
+}
+
+int32_t digitalRead(uint16_t pin) {
+    if(pin >= TOTAL_PINS) {
+        return LOW;
+    }
+    applyPinSchedule();
+    HostState &s = state();
+    if(s.pinMode[pin] == OUTPUT) {
+        return s.outputLevel[pin];
+    }
+    return s.pinLevel[pin];
+}
+
+bool attachInterrupt(uint16_t pin, wiring_interrupt_handler_t handler, InterruptMode mode,
+                     int8_t priority, uint8_t subpriority) {
+    (void)priority;
+    (void)subpriority;
+    int line = interruptLine(pin);
+    if(line < 0 || handler == nullptr) {
+        return false;
+    }
+    HostState &s = state();
+    for(uint16_t other = 0; other < TOTAL_PINS; other++) {
+        if(interruptLine(other) == line) {
+            s.interruptHandler[other] = nullptr;
+        }
+    }
+    s.interruptHandler[pin] = handler;
+    s.interruptMode[pin] = mode;
+    return true;
+}
+
+void detachInterrupt(uint16_t pin) {
+    if(pin < TOTAL_PINS) {
+        state().interruptHandler[pin] = nullptr;
+    }
+}
+
+system_tick_t millis() {
+    HostState &s = state();
+    return (system_tick_t)(s.micros / 1000 + s.millisOffset);
+}
+
+system_tick_t micros() {
+    HostState &s = state();
+    return (system_tick_t)(s.micros + (uint64_t)s.millisOffset * 1000);
+}
+
+void delay(system_tick_t ms) {
+    ParticleHost::advanceMillis(ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+    ParticleHost::advanceMicros(us);
+}
+
+uint32_t SystemClass::ticks() {
+    uint64_t nanos = state().micros * 1000;
+    if(state().realTicks) {
+        nanos += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    return (uint32_t)(nanos * 3 / 25);      // 120 ticks a microsecond
+}
+
+/*************************************** Particle cloud ****************************************/
+bool CloudClass::publish(const char *eventName, PublishFlag flag) {
+    (void)flag;
+    return doPublish(eventName, "");
+}
+
+bool CloudClass::publish(const char *eventName, const char *eventData, PublishFlag flag) {
+    (void)flag;
+    return doPublish(eventName, eventData);
+}
+
+bool CloudClass::publish(const char *eventName, const String &eventData, PublishFlag flag) {
+    (void)flag;
+    return doPublish(eventName, eventData.c_str());
+}
+
+bool CloudClass::publish(const String &eventName, const String &eventData, PublishFlag flag) {
+    (void)flag;
+    return doPublish(eventName.c_str(), eventData.c_str());
+}
+
+bool CloudClass::variable(const char *name, const String &var) {
+    state().variables[name] = CloudVariable{CloudVariable::STRING, &var};
+    return true;
+}
+
+bool CloudClass::variable(const char *name, const char *var) {
+    state().variables[name] = CloudVariable{CloudVariable::CHARS, var};
+    return true;
+}
+
+bool CloudClass::variable(const char *name, const int &var) {
+    state().variables[name] = CloudVariable{CloudVariable::INT, &var};
+    return true;
+}
+
+bool CloudClass::variable(const char *name, const double &var) {
+    state().variables[name] = CloudVariable{CloudVariable::DOUBLE, &var};
+    return true;
+}
+
+bool CloudClass::function(const char *name, int (*func)(String)) {
+    state().functions[name] = func;
+    return true;
+}
+
+bool CloudClass::connected() {
+    return state().cloudConnected;
+}
+
+void CloudClass::publishVitals(system_tick_t periodSeconds) {
+    (void)periodSeconds;
+}
+
+void CloudClass::process() {}
+
+/*************************************** Wi-Fi *************************************************/
+int WiFiClass::selectAntenna(WLanSelectAntenna_TypeDef antenna) {
+    (void)antenna;
+    return 0;
+}
+
+bool WiFiClass::ready() {
+    return state().cloudConnected;
+}
+
+int WiFiClass::RSSI() {
+    return -60;
+}
+
+/*************************************** Time **************************************************/
+time_t TimeClass::now() {
+    if(threadUnixTime != 0) {
+        return threadUnixTime;
+    }
+    HostState &s = state();
+    return s.unixAtReset + (time_t)(s.micros / 1000000);
+}
+
+time_t TimeClass::local() {
+    return now() + (time_t)(state().zoneHours * 3600);
+}
+
+void TimeClass::zone(float gmtOffset) {
+    state().zoneHours = gmtOffset;
+}
+
+float TimeClass::zone() {
+    return state().zoneHours;
+}
+
+bool TimeClass::isValid() {
+    return state().timeValid;
+}
+
+// format a UTC time as local time, as Device OS does
+String TimeClass::format(time_t t, const char *formatSpec) {
+    if(formatSpec == nullptr || strcmp(formatSpec, TIME_FORMAT_DEFAULT) == 0) {
+        formatSpec = "%a %b %e %H:%M:%S %Y";
+    }
+    time_t localTime = t + (time_t)(state().zoneHours * 3600);
+    struct tm calendar;
+    gmtime_r(&localTime, &calendar);
+    char buf[64];
+    size_t len = strftime(buf, sizeof(buf), formatSpec, &calendar);
+    return String(std::string(buf, len));
+}
+
+String TimeClass::format(const char *formatSpec) {
+    return format(now(), formatSpec);
+}
+
+String TimeClass::timeStr() {
+    return format(now(), TIME_FORMAT_DEFAULT);
+}
+
+/*************************************** Serial ************************************************/
+void SerialClass::begin(unsigned long baud) {
+    (void)baud;
+}
+
+size_t SerialClass::print(const char *s) {
+    return serialWrite(s ? s : "");
+}
+
+size_t SerialClass::print(const String &s) {
+    return serialWrite(s.str());
+}
+
+size_t SerialClass::print(char c) {
+    return serialWrite(std::string(1, c));
+}
+
+size_t SerialClass::print(int value) {
+    return serialWrite(String(value).str());
+}
+
+size_t SerialClass::print(unsigned int value) {
+    return serialWrite(String(value).str());
+}
+
+size_t SerialClass::print(long value) {
+    return serialWrite(String(value).str());
+}
+
+size_t SerialClass::print(unsigned long value) {
+    return serialWrite(String(value).str());
+}
+
+size_t SerialClass::print(double value, int digits) {
+    return serialWrite(String(value, digits).str());
+}
+
+size_t SerialClass::println() {
+    return serialWrite("\r\n");
+}
+
+size_t SerialClass::printf(const char *format, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if(len < 0) {
+        return 0;
+    }
+    return serialWrite(std::string(buf, (size_t)len < sizeof(buf) ? (size_t)len : sizeof(buf) - 1));
+}
+
+/*************************************** EEPROM ************************************************/
+uint8_t EEPROMClass::read(int address) {
+    uint8_t value = 0xFF;
+    readBytes(address, &value, 1);
+    return value;
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+    writeBytes(address, &value, 1);
+}
+
+size_t EEPROMClass::length() {
+    return EEPROM_SIZE;
+}
+
+void EEPROMClass::clear() {
+    uint8_t erased[EEPROM_SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    writeBytes(0, erased, sizeof(erased));
+}
+
+void EEPROMClass::readBytes(int address, void *data, size_t size) {
+    EEPROMState &e = eeprom();
+    for(size_t i = 0; i < size; i++) {
+        size_t a = (size_t)address + i;
+        ((uint8_t *)data)[i] = a < EEPROM_SIZE ? e.bytes[a] : 0xFF;
+    }
+}
+
+// writes past the end are ignored; a backing file is written through
+void EEPROMClass::writeBytes(int address, const void *data, size_t size) {
+    EEPROMState &e = eeprom();
+    if(address < 0 || (size_t)address >= EEPROM_SIZE) {
+        return;
+    }
+    size = std::min(size, EEPROM_SIZE - (size_t)address);
+    memcpy(e.bytes + address, data, size);
+    for(size_t i = 0; i < size; i++) {
+        e.writes[address + i]++;
+    }
+    if(e.file != nullptr) {
+        fseek(e.file, address, SEEK_SET);
+        fwrite(data, 1, size, e.file);
+        fflush(e.file);
+    }
+}
+
+/*************************************** Servo *************************************************/
+Servo::Servo() : _pin(0), _angle(0), _attached(false) {}
+
+bool Servo::attach(uint16_t pin) {
+    _pin = pin;
+    _attached = true;
+    return true;
+}
+
+void Servo::detach() {
+    _attached = false;
+}
+
+void Servo::write(int angle) {
+    _angle = angle;
+    state().servoAngle = angle;
+}
+
+int Servo::read() const {
+    return _angle;
+}
+
+bool Servo::attached() const {
+    return _attached;
+}
+
+/*************************************** host controls *****************************************/
+namespace ParticleHost {
+
+    void reset() {
+        state() = HostState();
+        loadEEPROM();
+    }
+
+    uint64_t uptimeMicros() {
+        return state().micros;
+    }
+
+    uint64_t uptimeMillis() {
+        return state().micros / 1000;
+    }
+
+    void advanceMicros(uint64_t us) {
+        state().micros += us;
+        applyPinSchedule();
+    }
+
+    void advanceMillis(uint64_t ms) {
+        advanceMicros(ms * 1000);
+    }
+
+    void advanceTo(uint64_t uptimeMs) {
+        HostState &s = state();
+        if(uptimeMs * 1000 > s.micros) {
+            s.micros = uptimeMs * 1000;
+        }
+        applyPinSchedule();
+    }
+
+    void setMillisOffset(uint32_t offset) {
+        state().millisOffset = offset;
+    }
+
+    void setRealTicks(bool real) {
+        state().realTicks = real;
+    }
+
+    void setUnixTime(time_t unixTime) {
+        HostState &s = state();
+        s.unixAtReset = unixTime - (time_t)(s.micros / 1000000);
+    }
+
+    void setTimeValid(bool valid) {
+        state().timeValid = valid;
+    }
+
+    void setPin(uint16_t pin, uint8_t level) {
+        if(pin < TOTAL_PINS) {
+            applyPinSchedule();
+            changePin(pin, level ? HIGH : LOW, state().micros);
+        }
+    }
+
+    void schedulePin(uint64_t uptimeMs, uint16_t pin, uint8_t level) {
+        schedulePinMicros(uptimeMs * 1000, pin, level);
+    }
+
+    void schedulePinMicros(uint64_t uptimeUs, uint16_t pin, uint8_t level) {
+        if(pin < TOTAL_PINS) {
+            state().pinSchedule.insert(std::make_pair(uptimeUs, std::make_pair(pin, (uint8_t)(level ? HIGH : LOW))));
+            applyPinSchedule();
+        }
+    }
+
+    bool interruptAttached(uint16_t pin) {
+        return pin < TOTAL_PINS && state().interruptHandler[pin] != nullptr;
+    }
+
+    uint8_t outputLevel(uint16_t pin) {
+        return pin < TOTAL_PINS ? state().outputLevel[pin] : LOW;
+    }
+
+    int servoAngle() {
+        return state().servoAngle;
+    }
+
+    void setDHTReading(float celsius, float humidity, int status) {
+        HostState &s = state();
+        s.dhtCelsius = celsius;
+        s.dhtHumidity = humidity;
+        s.dhtStatus = status;
+    }
+
+    void setDHTAcquireTime(uint32_t ms) {
+        state().dhtAcquireMs = ms;
+    }
+
+    void setDHTModel(DHTModel model) {
+        state().dhtModel = model;
+    }
+
+    void setCloudConnected(bool connected) {
+        state().cloudConnected = connected;
+    }
+
+    void setPublishSink(PublishSink sink) {
+        state().publishSink = sink;
+    }
+
+    void setThreadPublishSink(PublishSink sink) {
+        threadPublishSink = sink;
+    }
+
+    void setThreadUnixTime(time_t unixTime) {
+        threadUnixTime = unixTime;
+    }
+
+    void setPublishCapture(bool capture) {
+        state().capturePublishes = capture;
+    }
+
+    const std::vector<PublishRecord> &published() {
+        return state().published;
+    }
+
+    void clearPublished() {
+        state().published.clear();
+    }
+
+    uint64_t publishCount() {
+        return state().publishCount;
+    }
+
+    void setPublishRateLimit(bool limit) {
+        state().rateLimit = limit;
+    }
+
+    uint64_t publishesRejected() {
+        return state().publishesRejected;
+    }
+
+    bool setEEPROMFile(const char *path) {
+        EEPROMState &e = eeprom();
+        if(e.file != nullptr) {
+            fclose(e.file);
+            e.file = nullptr;
+        }
+        if(path != nullptr) {
+            e.file = fopen(path, "r+b");
+            if(e.file == nullptr) {
+                e.file = fopen(path, "w+b");
+            }
+        }
+        loadEEPROM();
+        return path == nullptr || e.file != nullptr;
+    }
+
+    uint64_t eepromWrites(int address) {
+        return address >= 0 && (size_t)address < EEPROM_SIZE ? eeprom().writes[address] : 0;
+    }
+
+    bool hasVariable(const char *name) {
+        return state().variables.count(name) != 0;
+    }
+
+    std::string variable(const char *name) {
+        HostState &s = state();
+        std::map<std::string, CloudVariable>::const_iterator it = s.variables.find(name);
+        if(it == s.variables.end()) {
+            return "";
+        }
+        switch(it->second.type) {
+            case CloudVariable::STRING:
+                return static_cast<const String *>(it->second.pointer)->str();
+            case CloudVariable::CHARS:
+                return static_cast<const char *>(it->second.pointer);
+            case CloudVariable::INT:
+                return std::to_string(*static_cast<const int *>(it->second.pointer));
+            default:
+                return String(*static_cast<const double *>(it->second.pointer)).str();
+        }
+    }
+
+    int callFunction(const char *name, const char *argument) {
+        HostState &s = state();
+        std::map<std::string, int (*)(String)>::const_iterator it = s.functions.find(name);
+        if(it == s.functions.end()) {
+            return -1;
+        }
+        return it->second(String(argument));
+    }
+
+    void setSerialEcho(bool echo) {
+        state().serialEcho = echo;
+    }
+
+    const std::string &serialOutput() {
+        return state().serialOutput;
+    }
+
+    void clearSerialOutput() {
+        state().serialOutput.clear();
+    }
+
+    // used by the PietteTech_DHT stand-in
+    void takeDHTReading(float &celsius, float &humidity, int &status, uint32_t &acquireMs) {
+        HostState &s = state();
+        celsius = s.dhtCelsius;
+        humidity = s.dhtHumidity;
+        status = s.dhtStatus;
+        if(s.dhtModel) {
+            s.dhtModel(celsius, humidity, status);
+        }
+        acquireMs = s.dhtAcquireMs;
+    }
+
+}   // namespace ParticleHost
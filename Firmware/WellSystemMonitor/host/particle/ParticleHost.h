@@ -0,0 +1,89 @@
+#ifndef PARTICLEHOST_H_INCLUDE
+#define PARTICLEHOST_H_INCLUDE
+/***************************************************************************************************/
+// ParticleHost.h
+//  Controls for the host (Linux) stand-in of the Particle Device OS.  Host programs use these to
+//  drive the firmware: set and advance virtual time, script pin levels, script DHT11 readings,
+//  toggle the cloud connection and capture everything that the firmware publishes.
+//
+//  Virtual time only moves when the host program advances it (or the firmware calls delay()).
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ParticleHost {
+
+    // a single Particle.publish() as seen by the cloud
+    struct PublishRecord {
+        uint64_t uptimeMs;      // virtual time since reset, in milliseconds
+        time_t unixTime;        // Time.now() when published
+        std::string name;       // the event name
+        std::string data;       // the event data
+    };
+
+    typedef std::function<void(const PublishRecord &record)> PublishSink;
+
+    // reset all state to power-on defaults: time zero, pins high, cloud connected, nothing captured
+    void reset();
+
+    // virtual time
+    uint64_t uptimeMicros();                        // microseconds since reset
+    uint64_t uptimeMillis();                        // milliseconds since reset (does not roll over)
+    void advanceMicros(uint64_t us);                // move virtual time forward
+    void advanceMillis(uint64_t ms);
+    void advanceTo(uint64_t uptimeMs);              // move virtual time forward to an absolute uptime
+    void setMillisOffset(uint32_t offset);          // millis() = uptime + offset; use to place the 49 day rollover
+    void setRealTicks(bool real);                   // System.ticks() counts the steady clock too (the default); false for virtual time alone
+    void setUnixTime(time_t unixTime);              // Time.now() at the current virtual time
+    void setThreadUnixTime(time_t unixTime);        // Time.now() on the calling thread only; 0 follows virtual time again
+    void setTimeValid(bool valid);                  // Time.isValid(): false until the cloud has synced the clock (default true)
+
+    // pins
+    // a level change runs the pin's attachInterrupt() handler, at the virtual time of the change
+    void setPin(uint16_t pin, uint8_t level);       // the level digitalRead() will return
+    void schedulePin(uint64_t uptimeMs, uint16_t pin, uint8_t level);  // set a level when time reaches uptimeMs
+    void schedulePinMicros(uint64_t uptimeUs, uint16_t pin, uint8_t level);
+    bool interruptAttached(uint16_t pin);           // the pin has the handler of its EXTI line
+    uint8_t outputLevel(uint16_t pin);              // the last level written with digitalWrite()
+    int servoAngle();                               // the last angle written to a Servo
+
+    // DHT11 sensor readings returned by the PietteTech_DHT stand-in
+    void setDHTReading(float celsius, float humidity, int status = 0);
+    void setDHTAcquireTime(uint32_t ms);            // time from acquire() until the reading is ready
+    typedef std::function<void(float &celsius, float &humidity, int &status)> DHTModel;
+    void setDHTModel(DHTModel model);               // called on every acquire(); overrides setDHTReading()
+
+    // cloud
+    void setCloudConnected(bool connected);
+    void setPublishSink(PublishSink sink);          // called for every publish
+    void setThreadPublishSink(PublishSink sink);    // publishes made on the calling thread go only here
+    void setPublishCapture(bool capture);           // keep a copy of every publish (default on)
+    const std::vector<PublishRecord> &published();
+    void clearPublished();
+    uint64_t publishCount();                        // publishes since reset, captured or not
+    void setPublishRateLimit(bool limit);           // refuse publishes over 1 a second, bursts of 4 (default off)
+    uint64_t publishesRejected();                   // publishes refused: rate limited or not connected
+    bool hasVariable(const char *name);
+    std::string variable(const char *name);         // current value of a Particle.variable()
+    int callFunction(const char *name, const char *argument);  // invoke a Particle.function()
+
+    // EEPROM; reset() erases it unless it is backed by a file, which it then reloads as at power on
+    bool setEEPROMFile(const char *path);           // back the EEPROM with a file (created if missing); nullptr detaches
+    uint64_t eepromWrites(int address);             // writes to one byte since reset(); for wear checks
+
+    // serial console output (off by default)
+    void setSerialEcho(bool echo);
+    const std::string &serialOutput();
+    void clearSerialOutput();
+
+}   // namespace ParticleHost
+
+#endif  // end of header duplication prevention
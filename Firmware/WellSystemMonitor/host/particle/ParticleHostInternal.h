@@ -0,0 +1,16 @@
+#ifndef PARTICLEHOSTINTERNAL_H_INCLUDE
+#define PARTICLEHOSTINTERNAL_H_INCLUDE
+/***************************************************************************************************/
+// ParticleHostInternal.h
+//  Hooks shared between the pieces of the host Device OS stand-in.  Not for use by host programs.
+/***************************************************************************************************/
+#include <cstdint>
+
+namespace ParticleHost {
+
+    // the next DHT11 reading and how long it takes to acquire
+    void takeDHTReading(float &celsius, float &humidity, int &status, uint32_t &acquireMs);
+
+}   // namespace ParticleHost
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,138 @@
+// FILE:        PietteTech_DHT.cpp (host stand-in)
+// PURPOSE:     Host (Linux) replacement for the interrupt driven PietteTech_DHT library.
+//              See PietteTech_DHT.h
+
+#include "PietteTech_DHT.h"
+#include "ParticleHostInternal.h"
+
+// the library attaches its handler to the signal pin for a reading, which takes the pin's EXTI
+// line from any other pin on it, and detaches it once the reading is done
+static void dhtSignalEdge()
+{
+}
+
+PietteTech_DHT::PietteTech_DHT(uint8_t sigPin, uint8_t dht_type, void(*callback_wrapper)())
+{
+  (void)callback_wrapper;
+  _sigPin = sigPin;
+  _type = dht_type;
+  _acquiring = false;
+  _readyTime = 0;
+  _status = DHTLIB_ERROR_NOTSTARTED;
+  _hum = 0;
+  _temp = 0;
+}
+
+PietteTech_DHT::PietteTech_DHT()
+{
+  _sigPin = -1;
+  _type = 0;
+  _acquiring = false;
+  _readyTime = 0;
+  _status = DHTLIB_ERROR_NOTSTARTED;
+  _hum = 0;
+  _temp = 0;
+}
+
+void PietteTech_DHT::begin()
+{
+}
+
+void PietteTech_DHT::begin(uint8_t sigPin, uint8_t dht_type, void(*callback_wrapper)())
+{
+  (void)callback_wrapper;
+  _sigPin = sigPin;
+  _type = dht_type;
+}
+
+void PietteTech_DHT::isrCallback()
+{
+}
+
+int PietteTech_DHT::acquire()
+{
+  if (_acquiring)
+    return DHTLIB_ERROR_ACQUIRING;
+
+  uint32_t acquireMs;
+  ParticleHost::takeDHTReading(_temp, _hum, _status, acquireMs);
+  _readyTime = millis() + acquireMs;
+  _acquiring = true;
+  attachInterrupt(_sigPin, dhtSignalEdge, FALLING);
+  return DHTLIB_ACQUIRING;
+}
+
+int PietteTech_DHT::acquireAndWait(uint32_t timeout)
+{
+  (void)timeout;
+  acquire();
+  while (acquiring())
+    delay(1);
+  return getStatus();
+}
+
+bool PietteTech_DHT::acquiring()
+{
+  if (_acquiring && (int32_t)(millis() - _readyTime) >= 0)
+  {
+    _acquiring = false;
+    detachInterrupt(_sigPin);
+  }
+  return _acquiring;
+}
+
+int PietteTech_DHT::getStatus()
+{
+  if (acquiring())
+    return DHTLIB_ERROR_ACQUIRING;
+  return _status;
+}
+
+float PietteTech_DHT::getCelsius()
+{
+  return _temp;
+}
+
+float PietteTech_DHT::getFahrenheit()
+{
+  return _temp * 9 / 5 + 32;
+}
+
+float PietteTech_DHT::getKelvin()
+{
+  return _temp + 273.15;
+}
+
+// delta max = 0.6544 wrt dewPoint()
+// 5x faster than dewPoint()
+// reference: http://en.wikipedia.org/wiki/Dew_point
+double PietteTech_DHT::getDewPoint()
+{
+  double a = 17.271;
+  double b = 237.7;
+  double temp_ = (a * (double) _temp) / (b + (double) _temp) + log((double) _hum/100);
+  double Td = (b * temp_) / (a - temp_);
+  return Td;
+}
+
+double PietteTech_DHT::getDewPointSlow()
+{
+  return getDewPoint();
+}
+
+float PietteTech_DHT::getHumidity()
+{
+  return _hum;
+}
+
+float PietteTech_DHT::readTemperature()
+{
+  acquireAndWait();
+  return getCelsius();
+}
+
+float PietteTech_DHT::readHumidity()
+{
+  acquireAndWait();
+  return getHumidity();
+}
@@ -0,0 +1,67 @@
+// FILE:        PietteTech_DHT.h (host stand-in)
+// PURPOSE:     Host (Linux) replacement for the interrupt driven PietteTech_DHT library.
+//              Keeps the public interface of version 0.0.12; readings come from
+//              ParticleHost::setDHTReading() / setDHTModel() instead of the sensor.
+
+#ifndef __PIETTETECH_DHT_H__
+#define __PIETTETECH_DHT_H__
+
+#include <Particle.h>
+#include <math.h>
+
+const char DHTLIB_VERSION[]              = "0.0.12-host";
+
+// device types
+const int  DHT11                         = 11;
+const int  DHT21                         = 21;
+const int  AM2301                        = 21;
+const int  DHT22                         = 22;
+const int  AM2302                        = 22;
+
+// state codes
+const int  DHTLIB_OK                     =  0;
+const int  DHTLIB_ACQUIRING              =  1;
+const int  DHTLIB_ACQUIRED               =  2;
+const int  DHTLIB_RESPONSE_OK            =  3;
+
+// error codes
+const int  DHTLIB_ERROR_CHECKSUM         = -1;
+const int  DHTLIB_ERROR_ISR_TIMEOUT      = -2;
+const int  DHTLIB_ERROR_RESPONSE_TIMEOUT = -3;
+const int  DHTLIB_ERROR_DATA_TIMEOUT     = -4;
+const int  DHTLIB_ERROR_ACQUIRING        = -5;
+const int  DHTLIB_ERROR_DELTA            = -6;
+const int  DHTLIB_ERROR_NOTSTARTED       = -7;
+
+class PietteTech_DHT
+{
+public:
+  PietteTech_DHT(uint8_t sigPin, uint8_t dht_type, void(*callback_wrapper)() = NULL);
+  void begin();
+  PietteTech_DHT();
+  void begin(uint8_t sigPin, uint8_t dht_type, void(*callback_wrapper)() = NULL);
+
+  void isrCallback();
+  int acquire();
+  int acquireAndWait(uint32_t timeout = 0);
+  float getCelsius();
+  float getFahrenheit();
+  float getKelvin();
+  double getDewPoint();
+  double getDewPointSlow();
+  float getHumidity();
+  bool acquiring();
+  int getStatus();
+  float readTemperature();
+  float readHumidity();
+
+private:
+  int _sigPin;
+  int _type;
+  bool _acquiring;
+  uint32_t _readyTime;        // millis() when the pending reading completes
+  int _status;
+  float _hum;
+  float _temp;
+};
+#endif
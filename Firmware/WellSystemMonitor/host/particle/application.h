@@ -0,0 +1,216 @@
+#ifndef APPLICATION_H_INCLUDE
+#define APPLICATION_H_INCLUDE
+/***************************************************************************************************/
+// application.h
+//  Host (Linux) stand-in for the Particle Device OS application header.  Lets the unmodified
+//  firmware sources compile natively.  Time is virtual, pin levels are scripted and publications
+//  are captured; all of that is controlled through ParticleHost.h.
+//
+//  Only the parts of the Device OS API used by the Well System Monitor firmware are implemented.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "HostString.h"
+
+// Wiring types
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint32_t system_tick_t;
+
+// Photon pin numbers
+const uint16_t D0 = 0;
+const uint16_t D1 = 1;
+const uint16_t D2 = 2;
+const uint16_t D3 = 3;
+const uint16_t D4 = 4;
+const uint16_t D5 = 5;
+const uint16_t D6 = 6;
+const uint16_t D7 = 7;
+const uint16_t A0 = 10;
+const uint16_t A1 = 11;
+const uint16_t A2 = 12;
+const uint16_t A3 = 13;
+const uint16_t A4 = 14;
+const uint16_t A5 = 15;
+const uint16_t A6 = 16;
+const uint16_t A7 = 17;
+const uint16_t TOTAL_PINS = 24;
+
+const uint8_t LOW = 0;
+const uint8_t HIGH = 1;
+
+typedef enum {
+    INPUT,
+    OUTPUT,
+    INPUT_PULLUP,
+    INPUT_PULLDOWN
+} PinMode;
+
+// Wiring I/O and timing
+void pinMode(uint16_t pin, PinMode mode);
+void digitalWrite(uint16_t pin, uint8_t value);
+int32_t digitalRead(uint16_t pin);
+system_tick_t millis();
+system_tick_t micros();
+void delay(system_tick_t ms);
+void delayMicroseconds(unsigned int us);
+inline int32_t pinReadFast(uint16_t pin) { return digitalRead(pin); }
+
+// external interrupts.  As on the Photon, pins that share an EXTI line share one handler: the
+// last pin attached takes the line over (D1/A4, D2/A0/A3, D3/A6, D4/A1), and D0 and A5 have none.
+// Handlers run when a pin level set by the host program changes, with micros() at the change.
+typedef void (*wiring_interrupt_handler_t)(void);
+
+typedef enum {
+    CHANGE,
+    RISING,
+    FALLING
+} InterruptMode;
+
+bool attachInterrupt(uint16_t pin, wiring_interrupt_handler_t handler, InterruptMode mode,
+                     int8_t priority = -1, uint8_t subpriority = 0);
+void detachInterrupt(uint16_t pin);
+
+// threading is not modelled; the application loop runs on the host thread
+#define SYSTEM_THREAD(state)
+#define SYSTEM_MODE(mode)
+
+// Particle cloud
+typedef enum {
+    PUBLIC,
+    PRIVATE,
+    NO_ACK,
+    WITH_ACK
+} PublishFlag;
+
+class CloudClass {
+    public:
+        bool publish(const char *eventName, PublishFlag flag = PRIVATE);
+        bool publish(const char *eventName, const char *eventData, PublishFlag flag = PRIVATE);
+        bool publish(const char *eventName, const String &eventData, PublishFlag flag = PRIVATE);
+        bool publish(const String &eventName, const String &eventData, PublishFlag flag = PRIVATE);
+        bool variable(const char *name, const String &var);
+        bool variable(const char *name, const char *var);
+        bool variable(const char *name, const int &var);
+        bool variable(const char *name, const double &var);
+        bool function(const char *name, int (*func)(String));
+        bool connected();
+        void publishVitals(system_tick_t periodSeconds);
+        void process();
+};
+extern CloudClass Particle;
+
+// Wi-Fi
+typedef enum {
+    ANT_INTERNAL,
+    ANT_EXTERNAL,
+    ANT_AUTO
+} WLanSelectAntenna_TypeDef;
+
+class WiFiClass {
+    public:
+        int selectAntenna(WLanSelectAntenna_TypeDef antenna);
+        bool ready();
+        int RSSI();
+};
+extern WiFiClass WiFi;
+
+// System: the cycle counter.  On the Photon System.ticks() is the DWT cycle counter, 120 to the
+// microsecond.  Here it counts at the same rate from the host's steady clock plus the virtual
+// time, so both the real work of a call and virtual time moved on inside it (a publish that
+// blocks, a delay()) show up.  ParticleHost::setRealTicks(false) leaves the virtual time alone,
+// for tests that check stage times exactly.
+class SystemClass {
+    public:
+        static uint32_t ticks();
+        static uint32_t ticksPerMicrosecond() { return 120; }
+};
+extern SystemClass System;
+
+// Time
+#define TIME_FORMAT_DEFAULT "asctime"
+#define TIME_FORMAT_ISO8601_FULL "%Y-%m-%dT%H:%M:%S%z"
+
+class TimeClass {
+    public:
+        time_t now();
+        time_t local();
+        void zone(float gmtOffset);
+        float zone();
+        bool isValid();
+        String format(time_t t, const char *formatSpec = nullptr);
+        String format(const char *formatSpec);
+        String timeStr();
+};
+extern TimeClass Time;
+
+// Serial console
+class SerialClass {
+    public:
+        void begin(unsigned long baud);
+        size_t print(const char *s);
+        size_t print(const String &s);
+        size_t print(char c);
+        size_t print(int value);
+        size_t print(unsigned int value);
+        size_t print(long value);
+        size_t print(unsigned long value);
+        size_t print(double value, int digits = 2);
+        size_t println();
+        template<typename T> size_t println(const T &value) {
+            size_t n = print(value);
+            return n + println();
+        }
+        size_t printf(const char *format, ...);
+};
+extern SerialClass Serial;
+
+// EEPROM (emulated in flash on the Photon); erased bytes read 0xFF
+class EEPROMClass {
+    public:
+        uint8_t read(int address);
+        void write(int address, uint8_t value);
+        template<typename T> T &get(int address, T &t) {
+            readBytes(address, &t, sizeof(T));
+            return t;
+        }
+        template<typename T> const T &put(int address, const T &t) {
+            writeBytes(address, &t, sizeof(T));
+            return t;
+        }
+        size_t length();
+        void clear();
+
+    private:
+        void readBytes(int address, void *data, size_t size);
+        void writeBytes(int address, const void *data, size_t size);
+};
+extern EEPROMClass EEPROM;
+
+// Servo
+class Servo {
+    public:
+        Servo();
+        bool attach(uint16_t pin);
+        void detach();
+        void write(int angle);
+        int read() const;
+        bool attached() const;
+    private:
+        uint16_t _pin;
+        int _angle;
+        bool _attached;
+};
+
+#endif  // end of header duplication prevention
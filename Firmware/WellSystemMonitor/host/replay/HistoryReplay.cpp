@@ -0,0 +1,84 @@
+/***************************************************************************************************/
+// HistoryReplay.cpp
+//  Replays a recorded WSM event log through WSMAlertProcessor.  See HistoryReplay.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "HistoryReplay.h"
+#include "ParticleHost.h"
+
+#include <cmath>
+
+HistoryReplay::HistoryReplay() {}
+
+HistoryReplay::HistoryReplay(const WSMAlertLimits &limits) :
+    _alerter(limits) {}
+
+void HistoryReplay::process(const WSMDataRow &row, ReplayStats &stats) {
+    stats.rows++;
+    ParticleHost::setUnixTime((time_t)row.etime);
+
+    switch(row.event) {
+        case WSM_EVENT_TRH:
+            stats.trhRows++;
+            _alerter.halfHourTimeTick();
+            break;
+
+        case WSM_EVENT_PP_STATUS:
+            if(row.pp == 1) {
+                stats.ppRows++;
+                _alerter.ppTurnedOn();
+            } else if(row.pp == 0 && !std::isnan(row.ppon)) {
+                stats.ppRows++;
+                _alerter.ppTurnedOff(row.ppon);
+            } else {
+                stats.ignoredRows++;
+            }
+            break;
+
+        case WSM_EVENT_WP_STATUS:
+            if(row.wp == 1) {
+                stats.wpRows++;
+                _alerter.wpTurnedOn();
+            } else if(row.wp == 0 && !std::isnan(row.wpon)) {
+                stats.wpRows++;
+                _alerter.wpTurnedOff(row.wpon);
+            } else {
+                stats.ignoredRows++;
+            }
+            break;
+
+        default:
+            stats.ignoredRows++;
+            break;
+    }
+}
+
+ReplayStats HistoryReplay::run(WSMDataReader &reader, AlertSink sink) {
+    ReplayStats stats;
+    WSMDataRow row;
+
+    ParticleHost::setPublishCapture(false);
+    ParticleHost::setPublishSink([&](const ParticleHost::PublishRecord &record) {
+        stats.alerts++;
+        if(sink) {
+            ReplayAlert alert;
+            alert.etime = record.unixTime;
+            alert.lineNumber = reader.lineNumber();
+            alert.name = record.name;
+            alert.data = record.data;
+            sink(alert);
+        }
+    });
+
+    _alerter.begin();
+    while(reader.next(row)) {
+        process(row, stats);
+    }
+
+    ParticleHost::setPublishSink(ParticleHost::PublishSink());
+    return stats;
+}
@@ -0,0 +1,65 @@
+#ifndef HISTORYREPLAY_H_INCLUDE
+#define HISTORYREPLAY_H_INCLUDE
+/***************************************************************************************************/
+// HistoryReplay.h
+//  Replays a recorded WSM event log through WSMAlertProcessor, the same way the firmware feeds it:
+//
+//      wsmEventTRH                 -> halfHourTimeTick()
+//      wsmEventPPstatus pp = 1     -> ppTurnedOn()
+//      wsmEventPPstatus pp = 0     -> ppTurnedOff(ppon)
+//      wsmEventWPstatus wp = 1     -> wpTurnedOn()
+//      wsmEventWPstatus wp = 0     -> wpTurnedOff(wpon)
+//
+//  Virtual time follows the etime column, so each alert carries the etime at which it would have
+//  been published.  Use it to backtest a change to the alert limits, or the adaptive deviation
+//  alerts (WSMAlertLimits::deviationSigmas), against recorded history.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMAlertProcessor.h"
+#include "WSMDataReader.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// an alert that the replayed history would have raised
+struct ReplayAlert {
+    int64_t etime;          // Time.now() when published
+    uint64_t lineNumber;    // line of the log row that raised it
+    std::string name;       // wsmAlert* event name
+    std::string data;       // the published JSON
+};
+
+struct ReplayStats {
+    uint64_t rows = 0;
+    uint64_t trhRows = 0;
+    uint64_t ppRows = 0;
+    uint64_t wpRows = 0;
+    uint64_t ignoredRows = 0;   // other events, or pump rows with missing values
+    uint64_t alerts = 0;
+};
+
+class HistoryReplay {
+    public:
+        typedef std::function<void(const ReplayAlert &alert)> AlertSink;
+
+        HistoryReplay();
+        HistoryReplay(const WSMAlertLimits &limits);
+
+        // feed every row of the log to a freshly initialized alert processor
+        ReplayStats run(WSMDataReader &reader, AlertSink sink);
+
+        // feed a single row; begin() must have been called on processor()
+        void process(const WSMDataRow &row, ReplayStats &stats);
+
+        WSMAlertProcessor &processor() { return _alerter; }
+
+    private:
+        WSMAlertProcessor _alerter;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,216 @@
+/***************************************************************************************************/
+// WSMDataReader.cpp
+//  Streaming reader for the WSM event log exported as CSV.  See WSMDataReader.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMDataReader.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+    const int NUM_COLUMNS = 8;      // the local time column is not needed
+    enum { COL_ETIME, COL_TEMP, COL_RH, COL_PP, COL_WP, COL_PPON, COL_WPON, COL_EVENT };
+
+    struct Field {
+        const char *begin;
+        const char *end;
+    };
+
+    // strip surrounding blanks and quotes from a field
+    void trimField(Field &field) {
+        while(field.begin < field.end && (*field.begin == ' ' || *field.begin == '\t')) {
+            field.begin++;
+        }
+        while(field.end > field.begin && (field.end[-1] == ' ' || field.end[-1] == '\t' || field.end[-1] == '\r')) {
+            field.end--;
+        }
+        if(field.end - field.begin >= 2 && *field.begin == '"' && field.end[-1] == '"') {
+            field.begin++;
+            field.end--;
+        }
+    }
+
+    float parseFloat(const Field &field) {
+        float value;
+        if(field.begin == field.end ||
+           std::from_chars(field.begin, field.end, value).ec != std::errc()) {
+            return NAN;
+        }
+        return value;
+    }
+
+    int parseFlag(const Field &field) {
+        int value;
+        if(field.begin == field.end ||
+           std::from_chars(field.begin, field.end, value).ec != std::errc()) {
+            return -1;
+        }
+        return value;
+    }
+
+    bool fieldEquals(const Field &field, const char *text, size_t length) {
+        return (size_t)(field.end - field.begin) == length && memcmp(field.begin, text, length) == 0;
+    }
+
+    WSMEventType parseEvent(const Field &field) {
+        if(fieldEquals(field, "wsmEventTRH", 11)) {
+            return WSM_EVENT_TRH;
+        } else if(fieldEquals(field, "wsmEventPPstatus", 16)) {
+            return WSM_EVENT_PP_STATUS;
+        } else if(fieldEquals(field, "wsmEventWPstatus", 16)) {
+            return WSM_EVENT_WP_STATUS;
+        }
+        return WSM_EVENT_OTHER;
+    }
+
+}   // namespace
+
+WSMDataReader::WSMDataReader()
+    : _file(nullptr), _ownsFile(false), _eof(true), _buffer(new char[BUFFER_SIZE]),
+      _start(0), _end(0), _lineNumber(0), _linesSkipped(0), _bytesRead(0) {}
+
+WSMDataReader::~WSMDataReader() {
+    close();
+    delete[] _buffer;
+}
+
+bool WSMDataReader::open(const char *path) {
+    close();
+    if(strcmp(path, "-") == 0) {
+        attach(stdin);
+        return true;
+    }
+    FILE *file = fopen(path, "rb");
+    if(file == nullptr) {
+        return false;
+    }
+    attach(file);
+    _ownsFile = true;
+    return true;
+}
+
+void WSMDataReader::attach(FILE *file) {
+    close();
+    _file = file;
+    _ownsFile = false;
+    _eof = false;
+    _start = _end = 0;
+    _lineNumber = _linesSkipped = _bytesRead = 0;
+}
+
+void WSMDataReader::close() {
+    if(_file != nullptr && _ownsFile) {
+        fclose(_file);
+    }
+    _file = nullptr;
+    _ownsFile = false;
+    _eof = true;
+}
+
+// move the unread bytes to the front of the buffer and read more behind them
+bool WSMDataReader::fill() {
+    if(_eof) {
+        return false;
+    }
+    if(_start > 0) {
+        memmove(_buffer, _buffer + _start, _end - _start);
+        _end -= _start;
+        _start = 0;
+    }
+    size_t n = fread(_buffer + _end, 1, BUFFER_SIZE - _end, _file);
+    _end += n;
+    _bytesRead += n;
+    if(n == 0) {
+        _eof = true;
+        return false;
+    }
+    return true;
+}
+
+bool WSMDataReader::next(WSMDataRow &row) {
+    for(;;) {
+        const char *line = _buffer + _start;
+        const char *newline = (const char *)memchr(line, '\n', _end - _start);
+        if(newline == nullptr) {
+            if(_end - _start == BUFFER_SIZE) {
+                // line too long for the buffer: drop it up to the next newline
+                _start = _end;
+                while(fill()) {
+                    newline = (const char *)memchr(_buffer, '\n', _end);
+                    if(newline != nullptr) {
+                        _start = newline + 1 - _buffer;
+                        break;
+                    }
+                    _start = _end;
+                }
+                _lineNumber++;
+                _linesSkipped++;
+                continue;
+            }
+            if(fill()) {
+                continue;
+            }
+            if(_start == _end) {
+                return false;
+            }
+            line = _buffer + _start;        // fill() may have moved it
+            newline = _buffer + _end;       // last line has no newline
+        }
+
+        _lineNumber++;
+        const char *end = newline;
+        _start = (newline - _buffer) + (newline < _buffer + _end ? 1 : 0);
+        if(parseLine(line, end, row)) {
+            return true;
+        }
+        _linesSkipped++;
+    }
+}
+
+// split one CSV line and convert the columns; false if it is not a data row
+bool WSMDataReader::parseLine(const char *line, const char *end, WSMDataRow &row) {
+    Field fields[NUM_COLUMNS];
+    int numFields = 0;
+    const char *p = line;
+    while(numFields < NUM_COLUMNS) {
+        Field &field = fields[numFields++];
+        field.begin = p;
+        bool quoted = false;
+        while(p < end && (quoted || *p != ',')) {
+            if(*p == '"') {
+                quoted = !quoted;   // a doubled quote toggles twice
+            }
+            p++;
+        }
+        field.end = p;
+        trimField(field);
+        if(p >= end) {
+            break;
+        }
+        p++;    // skip the comma
+    }
+    for(int i = numFields; i < NUM_COLUMNS; i++) {
+        fields[i].begin = fields[i].end = end;
+    }
+
+    const Field &etime = fields[COL_ETIME];
+    if(etime.begin == etime.end ||
+       std::from_chars(etime.begin, etime.end, row.etime).ec != std::errc()) {
+        return false;
+    }
+    row.temp = parseFloat(fields[COL_TEMP]);
+    row.rh = parseFloat(fields[COL_RH]);
+    row.pp = parseFlag(fields[COL_PP]);
+    row.wp = parseFlag(fields[COL_WP]);
+    row.ppon = parseFloat(fields[COL_PPON]);
+    row.wpon = parseFloat(fields[COL_WPON]);
+    row.event = parseEvent(fields[COL_EVENT]);
+    return true;
+}
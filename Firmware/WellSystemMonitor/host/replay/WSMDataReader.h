@@ -0,0 +1,78 @@
+#ifndef WSMDATAREADER_H_INCLUDE
+#define WSMDATAREADER_H_INCLUDE
+/***************************************************************************************************/
+// WSMDataReader.h
+//  Streaming reader for the WSM event log as written to the Google sheet by the wsmWriteData
+//  script, exported as CSV (from Google Sheets, or from WSMData.ods with LibreOffice).  The
+//  columns are:
+//
+//      etime, temp, rh, pp, wp, ppon, wpon, event, local time
+//
+//  Extra columns are ignored.  Rows whose first column is not a number (titles, headers, blank
+//  lines) are skipped, so a whole sheet can be exported as is.
+//
+//  The file is read once through a fixed size buffer and rows are parsed in place, so memory use
+//  does not depend on the size of the file and no allocation is made per row.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <cstdint>
+#include <cstdio>
+
+// the event column
+enum WSMEventType {
+    WSM_EVENT_TRH,          // wsmEventTRH: half hour temperature and humidity report
+    WSM_EVENT_PP_STATUS,    // wsmEventPPstatus: pressure pump on or off
+    WSM_EVENT_WP_STATUS,    // wsmEventWPstatus: well pump on or off
+    WSM_EVENT_OTHER
+};
+
+// one row of the sheet; missing numeric cells are NaN (or -1 for pp and wp)
+struct WSMDataRow {
+    int64_t etime;
+    float temp;
+    float rh;
+    int pp;
+    int wp;
+    float ppon;
+    float wpon;
+    WSMEventType event;
+};
+
+class WSMDataReader {
+    public:
+        static const size_t BUFFER_SIZE = 1 << 16;     // also the longest line that can be read
+
+        WSMDataReader();
+        ~WSMDataReader();
+
+        bool open(const char *path);    // "-" reads stdin
+        void attach(FILE *file);        // read an already open file; it is not closed
+        void close();
+
+        // read the next data row; false at the end of the file
+        bool next(WSMDataRow &row);
+
+        uint64_t lineNumber() const { return _lineNumber; }     // line of the last row returned
+        uint64_t linesSkipped() const { return _linesSkipped; } // lines that were not data rows
+        uint64_t bytesRead() const { return _bytesRead; }
+
+    private:
+        bool parseLine(const char *line, const char *end, WSMDataRow &row);
+        bool fill();
+
+        FILE *_file;
+        bool _ownsFile;
+        bool _eof;
+        char *_buffer;
+        size_t _start;      // first unread byte in _buffer
+        size_t _end;        // one past the last valid byte in _buffer
+        uint64_t _lineNumber;
+        uint64_t _linesSkipped;
+        uint64_t _bytesRead;
+};
+
+#endif  // end of header duplication prevention
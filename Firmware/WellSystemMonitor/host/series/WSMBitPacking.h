@@ -0,0 +1,86 @@
+#ifndef WSMBITPACKING_H_INCLUDE
+#define WSMBITPACKING_H_INCLUDE
+/***************************************************************************************************/
+// WSMBitPacking.h
+//  Bit streams for the series store's columns (WSMSeriesSegment.h): values of a fixed width of 0
+//  to 32 bits, least significant bit first.  The reader loads 8 bytes at a time from wherever the
+//  stream lies (a mapped file), so a stream must be followed by at least 8 readable bytes.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// bits needed for value: 0 for 0
+inline unsigned int bitWidth(uint32_t value) {
+    return value == 0 ? 0 : 32 - __builtin_clz(value);
+}
+
+// 0, -1, 1, -2, 2 ... as 0, 1, 2, 3, 4 ...
+inline uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+inline int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+class WSMBitWriter {
+    public:
+        explicit WSMBitWriter(std::vector<uint8_t> &bytes) : _bytes(bytes), _bits(0), _used(0) {}
+
+        void write(uint32_t value, unsigned int width) {
+            if(width == 0) {
+                return;
+            }
+            _bits |= (uint64_t)(value & (uint32_t)((1ull << width) - 1)) << _used;
+            _used += width;
+            while(_used >= 8) {
+                _bytes.push_back((uint8_t)_bits);
+                _bits >>= 8;
+                _used -= 8;
+            }
+        }
+
+        // write out the last part byte
+        void flush() {
+            if(_used > 0) {
+                _bytes.push_back((uint8_t)_bits);
+            }
+            _bits = 0;
+            _used = 0;
+        }
+
+    private:
+        std::vector<uint8_t> &_bytes;
+        uint64_t _bits;
+        unsigned int _used;
+};
+
+class WSMBitReader {
+    public:
+        WSMBitReader(const uint8_t *bytes, uint64_t bitOffset = 0) : _bytes(bytes), _position(bitOffset) {}
+
+        uint32_t read(unsigned int width) {
+            if(width == 0) {
+                return 0;
+            }
+            uint64_t word;
+            memcpy(&word, _bytes + (_position >> 3), 8);
+            uint32_t value = (uint32_t)(word >> (_position & 7)) & (uint32_t)((1ull << width) - 1);
+            _position += width;
+            return value;
+        }
+
+        uint64_t position() const { return _position; }
+
+    private:
+        const uint8_t *_bytes;
+        uint64_t _position;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,76 @@
+/***************************************************************************************************/
+// WSMRollup.cpp
+//  Hourly aggregates of a site's events.  See WSMRollup.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMRollup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+int32_t hundredths(float value) {
+    return (int32_t)lrint((double)value * 100.0);
+}
+
+int32_t runMillis(float minutes) {
+    return (int32_t)lrint((double)minutes * 60000.0);
+}
+
+void WSMRollup::clear(int64_t hourStart) {
+    memset(this, 0, sizeof(*this));
+    start = hourStart;
+}
+
+void WSMRollup::add(const WSMDataRow &row) {
+    if(row.event == WSM_EVENT_PP_STATUS && row.pp == 0 && !std::isnan(row.ppon)) {
+        uint32_t ms = (uint32_t)std::max(runMillis(row.ppon), 0);
+        ppCycles++;
+        ppMs += ms;
+        ppMaxMs = std::max(ppMaxMs, ms);
+    } else if(row.event == WSM_EVENT_WP_STATUS && row.wp == 0 && !std::isnan(row.wpon)) {
+        uint32_t ms = (uint32_t)std::max(runMillis(row.wpon), 0);
+        wpCycles++;
+        wpMs += ms;
+        wpMaxMs = std::max(wpMaxMs, ms);
+    } else if(row.event == WSM_EVENT_TRH && !std::isnan(row.temp) && !std::isnan(row.rh)) {
+        int32_t temp = hundredths(row.temp);
+        int32_t rh = hundredths(row.rh);
+        tempMin = trhCount == 0 ? temp : std::min(tempMin, temp);
+        tempMax = trhCount == 0 ? temp : std::max(tempMax, temp);
+        rhMin = trhCount == 0 ? rh : std::min(rhMin, rh);
+        rhMax = trhCount == 0 ? rh : std::max(rhMax, rh);
+        tempSum += temp;
+        rhSum += rh;
+        trhCount++;
+    }
+}   // end of add()
+
+void WSMRollup::merge(const WSMRollup &other) {
+    ppCycles += other.ppCycles;
+    ppMs += other.ppMs;
+    ppMaxMs = std::max(ppMaxMs, other.ppMaxMs);
+    wpCycles += other.wpCycles;
+    wpMs += other.wpMs;
+    wpMaxMs = std::max(wpMaxMs, other.wpMaxMs);
+    if(other.trhCount > 0) {
+        tempMin = trhCount == 0 ? other.tempMin : std::min(tempMin, other.tempMin);
+        tempMax = trhCount == 0 ? other.tempMax : std::max(tempMax, other.tempMax);
+        rhMin = trhCount == 0 ? other.rhMin : std::min(rhMin, other.rhMin);
+        rhMax = trhCount == 0 ? other.rhMax : std::max(rhMax, other.rhMax);
+        tempSum += other.tempSum;
+        rhSum += other.rhSum;
+        trhCount += other.trhCount;
+    }
+}   // end of merge()
+
+bool WSMRollup::operator==(const WSMRollup &other) const {
+    return start == other.start && ppCycles == other.ppCycles && ppMs == other.ppMs && ppMaxMs == other.ppMaxMs &&
+           wpCycles == other.wpCycles && wpMs == other.wpMs && wpMaxMs == other.wpMaxMs && trhCount == other.trhCount &&
+           tempMin == other.tempMin && tempMax == other.tempMax && tempSum == other.tempSum && rhMin == other.rhMin &&
+           rhMax == other.rhMax && rhSum == other.rhSum;
+}
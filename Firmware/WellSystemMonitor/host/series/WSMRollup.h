@@ -0,0 +1,58 @@
+#ifndef WSMROLLUP_H_INCLUDE
+#define WSMROLLUP_H_INCLUDE
+/***************************************************************************************************/
+// WSMRollup.h
+//  What is kept of an hour of a site's events once the series store (WSMSeriesStore.h) no
+//  longer keeps the events themselves: the pump cycles and their run times, and the TRH reports'
+//  range and sum.  Temperatures and humidities are in hundredths and run times in milliseconds,
+//  as the series store keeps them, so rollups add up exactly however they are merged.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMDataReader.h"
+
+#include <cstdint>
+
+const int64_t ROLLUP_SECONDS = 3600;
+
+struct WSMRollup {
+    int64_t start;          // etime of the start of the hour
+    uint32_t ppCycles;      // PP off events with a run time
+    uint32_t ppMs;          // their run time
+    uint32_t ppMaxMs;
+    uint32_t wpCycles;
+    uint32_t wpMs;
+    uint32_t wpMaxMs;
+    uint32_t trhCount;      // TRH reports; the temperatures and humidities are 0 without one
+    int32_t tempMin;        // hundredths
+    int32_t tempMax;
+    int32_t tempSum;
+    int32_t rhMin;
+    int32_t rhMax;
+    int32_t rhSum;
+
+    // an empty hour from start
+    void clear(int64_t hourStart);
+
+    // count an event of the hour
+    void add(const WSMDataRow &row);
+
+    // count the events of another rollup of the same hour
+    void merge(const WSMRollup &other);
+
+    bool operator==(const WSMRollup &other) const;
+};
+
+// the start of the hour of etime
+inline int64_t rollupStart(int64_t etime) {
+    return etime - ((etime % ROLLUP_SECONDS) + ROLLUP_SECONDS) % ROLLUP_SECONDS;
+}
+
+// a value as the series store keeps it: hundredths, or milliseconds of a run time in minutes
+int32_t hundredths(float value);
+int32_t runMillis(float minutes);
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,615 @@
+/***************************************************************************************************/
+// WSMRollupIndex.cpp
+//  Half hour aggregates of each site, and the tree over them.  See WSMRollupIndex.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMRollupIndex.h"
+#include "WSMBitPacking.h"
+#include "WSMRollup.h"
+#include "TPPUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+    const char MAGIC[4] = {'W', 'S', 'M', 'I'};
+    const uint8_t INDEX_VERSION = 1;
+    const int64_t MAX_SLOTS = 20 * 366 * 48;    // twenty years of a site
+    const unsigned int SAVE_BLOCK_SLOTS = 128;
+
+    int64_t floorDiv(int64_t a, int64_t b) {
+        return a / b - (a % b < 0);
+    }
+
+    int64_t ceilDiv(int64_t a, int64_t b) {
+        return a / b + (a % b > 0);
+    }
+
+    uint8_t add8(uint8_t a, uint8_t b) {
+        return (uint8_t)std::min(a + b, 0xFF);
+    }
+
+    uint16_t add16(uint16_t a, uint16_t b) {
+        return (uint16_t)std::min(a + b, 0xFFFF);
+    }
+
+    int16_t hundredths16(float value) {
+        return (int16_t)std::max(std::min(hundredths(value), 32767), -32768);
+    }
+
+    // the columns that save() packs, counts before the columns that depend on them.  A column with
+    //  a count is only there for a half hour where the count is not 0; maxima come before totals,
+    //  kept as total - max, and minima before maxima and sums, kept as max - min and sum - min * count,
+    //  so that a half hour of one run or one report takes nothing for them.
+    struct Column {
+        bool isSigned;
+        int count;
+    };
+    const unsigned int SLOT_COLUMNS = 17;
+    const Column SLOT_LAYOUT[SLOT_COLUMNS] = {
+        {false, -1}, {false, 0}, {false, 0},                // ppCycles, ppMaxMs, ppMs
+        {false, -1}, {false, 3}, {false, 3},                // wpCycles, wpMaxMs, wpMs
+        {false, -1}, {false, 6}, {false, 6},                // wpGaps, gapMaxMs, gapMs
+        {false, -1},                                        // trhCount
+        {true, 9}, {false, 9}, {false, 9},                  // tempMin, tempMax, tempSum
+        {true, 9}, {false, 9}, {false, 9},                  // rhMin, rhMax, rhSum
+        {false, -1}                                         // alerts
+    };
+
+    int64_t packed(const WSMRollupSlot &s, unsigned int c) {
+        switch(c) {
+            case 0: return s.ppCycles;
+            case 1: return s.ppMaxMs;
+            case 2: return (int64_t)s.ppMs - s.ppMaxMs;
+            case 3: return s.wpCycles;
+            case 4: return s.wpMaxMs;
+            case 5: return (int64_t)s.wpMs - s.wpMaxMs;
+            case 6: return s.wpGaps;
+            case 7: return s.gapMaxMs;
+            case 8: return (int64_t)s.gapMs - s.gapMaxMs;
+            case 9: return s.trhCount;
+            case 10: return s.tempMin;
+            case 11: return (int64_t)s.tempMax - s.tempMin;
+            case 12: return (int64_t)s.tempSum - (int64_t)s.tempMin * s.trhCount;
+            case 13: return s.rhMin;
+            case 14: return (int64_t)s.rhMax - s.rhMin;
+            case 15: return (int64_t)s.rhSum - (int64_t)s.rhMin * s.trhCount;
+            default: return s.alerts;
+        }
+    }
+
+    void unpack(WSMRollupSlot &s, unsigned int c, int64_t value) {
+        switch(c) {
+            case 0: s.ppCycles = (uint16_t)value; break;
+            case 1: s.ppMaxMs = (uint32_t)value; break;
+            case 2: s.ppMs = (uint32_t)(s.ppMaxMs + value); break;
+            case 3: s.wpCycles = (uint8_t)value; break;
+            case 4: s.wpMaxMs = (uint32_t)value; break;
+            case 5: s.wpMs = (uint32_t)(s.wpMaxMs + value); break;
+            case 6: s.wpGaps = (uint8_t)value; break;
+            case 7: s.gapMaxMs = (uint32_t)value; break;
+            case 8: s.gapMs = (uint32_t)(s.gapMaxMs + value); break;
+            case 9: s.trhCount = (uint8_t)value; break;
+            case 10: s.tempMin = (int16_t)value; break;
+            case 11: s.tempMax = (int16_t)(s.tempMin + value); break;
+            case 12: s.tempSum = (int32_t)((int64_t)s.tempMin * s.trhCount + value); break;
+            case 13: s.rhMin = (int16_t)value; break;
+            case 14: s.rhMax = (int16_t)(s.rhMin + value); break;
+            case 15: s.rhSum = (int32_t)((int64_t)s.rhMin * s.trhCount + value); break;
+            default: s.alerts = (uint8_t)value; break;
+        }
+    }
+
+    void put(std::vector<uint8_t> &bytes, const void *value, size_t size) {
+        bytes.insert(bytes.end(), (const uint8_t *)value, (const uint8_t *)value + size);
+    }
+
+    // a block of half hours as columns
+    struct SlotBlock {
+        int64_t values[SLOT_COLUMNS][SAVE_BLOCK_SLOTS];
+
+        bool present(unsigned int c, size_t i) const {
+            return SLOT_LAYOUT[c].count < 0 || values[SLOT_LAYOUT[c].count][i] != 0;
+        }
+    };
+
+    // the half hours, a block at a time: per column its lowest value and bit width, then the
+    //  columns bit packed as the offset from the lowest
+    void packSlots(const std::vector<WSMRollupSlot> &slots, std::vector<uint8_t> &bytes) {
+        SlotBlock block;
+        for(size_t begin = 0; begin < slots.size(); begin += SAVE_BLOCK_SLOTS) {
+            size_t rows = std::min<size_t>(slots.size() - begin, SAVE_BLOCK_SLOTS);
+            for(size_t i = 0; i < rows; i++) {
+                for(unsigned int c = 0; c < SLOT_COLUMNS; c++) {
+                    block.values[c][i] = packed(slots[begin + i], c);
+                }
+            }
+            int64_t lows[SLOT_COLUMNS];
+            unsigned int widths[SLOT_COLUMNS];
+            for(unsigned int c = 0; c < SLOT_COLUMNS; c++) {
+                int64_t low = 0, high = 0;
+                bool any = false;
+                for(size_t i = 0; i < rows; i++) {
+                    if(block.present(c, i)) {
+                        low = any ? std::min(low, block.values[c][i]) : block.values[c][i];
+                        high = any ? std::max(high, block.values[c][i]) : block.values[c][i];
+                        any = true;
+                    }
+                }
+                lows[c] = low;
+                widths[c] = bitWidth((uint32_t)(high - low));
+                uint32_t base = (uint32_t)low;
+                put(bytes, &base, 4);
+                bytes.push_back((uint8_t)widths[c]);
+            }
+            WSMBitWriter writer(bytes);
+            for(unsigned int c = 0; c < SLOT_COLUMNS; c++) {
+                for(size_t i = 0; i < rows; i++) {
+                    if(block.present(c, i)) {
+                        writer.write((uint32_t)(block.values[c][i] - lows[c]), widths[c]);
+                    }
+                }
+            }
+            writer.flush();
+        }
+    }   // end of packSlots()
+
+    // count slots from bytes (followed by 8 bytes of padding); false if they run past end
+    bool unpackSlots(const uint8_t *bytes, const uint8_t *end, size_t count, std::vector<WSMRollupSlot> &slots) {
+        SlotBlock block;
+        slots.assign(count, WSMRollupSlot{});
+        for(size_t begin = 0; begin < count; begin += SAVE_BLOCK_SLOTS) {
+            size_t rows = std::min<size_t>(count - begin, SAVE_BLOCK_SLOTS);
+            int64_t lows[SLOT_COLUMNS];
+            unsigned int widths[SLOT_COLUMNS];
+            if(end - bytes < (ptrdiff_t)(SLOT_COLUMNS * 5)) {
+                return false;
+            }
+            for(unsigned int c = 0; c < SLOT_COLUMNS; c++) {
+                uint32_t base;
+                memcpy(&base, bytes, 4);
+                lows[c] = SLOT_LAYOUT[c].isSigned ? (int64_t)(int32_t)base : (int64_t)base;
+                widths[c] = std::min<unsigned int>(bytes[4], 32);
+                bytes += 5;
+            }
+            WSMBitReader reader(bytes);
+            for(unsigned int c = 0; c < SLOT_COLUMNS; c++) {
+                for(size_t i = 0; i < rows; i++) {
+                    block.values[c][i] = block.present(c, i) ? lows[c] + reader.read(widths[c]) : 0;
+                }
+            }
+            bytes += (reader.position() + 7) / 8;
+            if(bytes > end) {
+                return false;
+            }
+            for(size_t i = 0; i < rows; i++) {
+                for(unsigned int c = 0; c < SLOT_COLUMNS; c++) {
+                    unpack(slots[begin + i], c, block.values[c][i]);
+                }
+            }
+        }
+        return true;
+    }   // end of unpackSlots()
+
+}   // namespace
+
+void WSMRollupSlot::merge(const WSMRollupSlot &other) {
+    ppMs += other.ppMs;
+    ppMaxMs = std::max(ppMaxMs, other.ppMaxMs);
+    wpMs += other.wpMs;
+    wpMaxMs = std::max(wpMaxMs, other.wpMaxMs);
+    gapMs += other.gapMs;
+    gapMaxMs = std::max(gapMaxMs, other.gapMaxMs);
+    ppCycles = add16(ppCycles, other.ppCycles);
+    wpCycles = add8(wpCycles, other.wpCycles);
+    wpGaps = add8(wpGaps, other.wpGaps);
+    alerts = add8(alerts, other.alerts);
+    if(other.trhCount > 0) {
+        tempMin = trhCount == 0 ? other.tempMin : std::min(tempMin, other.tempMin);
+        tempMax = trhCount == 0 ? other.tempMax : std::max(tempMax, other.tempMax);
+        rhMin = trhCount == 0 ? other.rhMin : std::min(rhMin, other.rhMin);
+        rhMax = trhCount == 0 ? other.rhMax : std::max(rhMax, other.rhMax);
+        tempSum += other.tempSum;
+        rhSum += other.rhSum;
+        trhCount = add8(trhCount, other.trhCount);
+    }
+}   // end of WSMRollupSlot::merge()
+
+void WSMRangeStats::clear() {
+    memset(this, 0, sizeof(*this));
+}
+
+void WSMRangeStats::merge(const WSMRollupSlot &slot) {
+    ppCycles += slot.ppCycles;
+    ppMs += slot.ppMs;
+    ppMaxMs = std::max(ppMaxMs, slot.ppMaxMs);
+    wpCycles += slot.wpCycles;
+    wpMs += slot.wpMs;
+    wpMaxMs = std::max(wpMaxMs, slot.wpMaxMs);
+    wpGaps += slot.wpGaps;
+    gapMs += slot.gapMs;
+    gapMaxMs = std::max(gapMaxMs, slot.gapMaxMs);
+    alerts += slot.alerts;
+    if(slot.trhCount > 0) {
+        tempMin = trhCount == 0 ? slot.tempMin : std::min<int32_t>(tempMin, slot.tempMin);
+        tempMax = trhCount == 0 ? slot.tempMax : std::max<int32_t>(tempMax, slot.tempMax);
+        rhMin = trhCount == 0 ? slot.rhMin : std::min<int32_t>(rhMin, slot.rhMin);
+        rhMax = trhCount == 0 ? slot.rhMax : std::max<int32_t>(rhMax, slot.rhMax);
+        tempSum += slot.tempSum;
+        rhSum += slot.rhSum;
+        trhCount += slot.trhCount;
+    }
+}   // end of WSMRangeStats::merge()
+
+void WSMRangeStats::merge(const WSMRangeStats &other) {
+    slots += other.slots;
+    ppCycles += other.ppCycles;
+    ppMs += other.ppMs;
+    ppMaxMs = std::max(ppMaxMs, other.ppMaxMs);
+    wpCycles += other.wpCycles;
+    wpMs += other.wpMs;
+    wpMaxMs = std::max(wpMaxMs, other.wpMaxMs);
+    wpGaps += other.wpGaps;
+    gapMs += other.gapMs;
+    gapMaxMs = std::max(gapMaxMs, other.gapMaxMs);
+    alerts += other.alerts;
+    if(other.trhCount > 0) {
+        tempMin = trhCount == 0 ? other.tempMin : std::min(tempMin, other.tempMin);
+        tempMax = trhCount == 0 ? other.tempMax : std::max(tempMax, other.tempMax);
+        rhMin = trhCount == 0 ? other.rhMin : std::min(rhMin, other.rhMin);
+        rhMax = trhCount == 0 ? other.rhMax : std::max(rhMax, other.rhMax);
+        tempSum += other.tempSum;
+        rhSum += other.rhSum;
+        trhCount += other.trhCount;
+    }
+}   // end of WSMRangeStats::merge()
+
+bool WSMRangeStats::operator==(const WSMRangeStats &other) const {
+    return slots == other.slots && ppCycles == other.ppCycles && ppMs == other.ppMs && wpCycles == other.wpCycles &&
+           wpMs == other.wpMs && wpGaps == other.wpGaps && gapMs == other.gapMs && trhCount == other.trhCount &&
+           alerts == other.alerts && tempSum == other.tempSum && rhSum == other.rhSum &&
+           ppMaxMs == other.ppMaxMs && wpMaxMs == other.wpMaxMs && gapMaxMs == other.gapMaxMs &&
+           tempMin == other.tempMin && tempMax == other.tempMax && rhMin == other.rhMin && rhMax == other.rhMax;
+}
+
+float WSMRangeStats::ppAverageMinutes() const {
+    return ppCycles == 0 ? NAN : (float)(ppMs / 60000.0 / ppCycles);
+}
+
+float WSMRangeStats::wpAverageMinutes() const {
+    return wpCycles == 0 ? NAN : (float)(wpMs / 60000.0 / wpCycles);
+}
+
+float WSMRangeStats::gapAverageMinutes() const {
+    return wpGaps == 0 ? NAN : (float)(gapMs / 60000.0 / wpGaps);
+}
+
+float WSMRangeStats::tempAverage() const {
+    return trhCount == 0 ? NAN : (float)(tempSum / 100.0 / trhCount);
+}
+
+float WSMRangeStats::rhAverage() const {
+    return trhCount == 0 ? NAN : (float)(rhSum / 100.0 / trhCount);
+}
+
+bool WSMRollupIndex::add(std::string_view name, const WSMDataRow &row) {
+    WSMRollupSlot delta = {};
+    Site &site = this->site(name);
+    switch(row.event) {
+        case WSM_EVENT_TRH:
+            if(std::isnan(row.temp) || std::isnan(row.rh)) {
+                return false;
+            }
+            delta.trhCount = 1;
+            delta.tempMin = delta.tempMax = hundredths16(row.temp);
+            delta.rhMin = delta.rhMax = hundredths16(row.rh);
+            delta.tempSum = delta.tempMin;
+            delta.rhSum = delta.rhMin;
+            break;
+
+        case WSM_EVENT_PP_STATUS:
+            if(row.pp != 0 || std::isnan(row.ppon)) {
+                return false;
+            }
+            delta.ppCycles = 1;
+            delta.ppMs = delta.ppMaxMs = (uint32_t)std::max(runMillis(row.ppon), 0);
+            site.ppSinceWP += delta.ppMs;
+            break;
+
+        case WSM_EVENT_WP_STATUS:
+            if(row.wp == 1) {
+                if(site.wpSeen) {
+                    delta.wpGaps = 1;
+                    delta.gapMs = delta.gapMaxMs = (uint32_t)std::min<uint64_t>(site.ppSinceWP, UINT32_MAX);
+                }
+                site.ppSinceWP = 0;
+                site.wpSeen = true;
+                if(delta.wpGaps == 0) {
+                    return true;
+                }
+            } else if(row.wp == 0 && !std::isnan(row.wpon)) {
+                delta.wpCycles = 1;
+                delta.wpMs = delta.wpMaxMs = (uint32_t)std::max(runMillis(row.wpon), 0);
+            } else {
+                return false;
+            }
+            break;
+
+        default:
+            return false;
+    }
+    return apply(site, row.etime, delta);
+
+}   // end of add()
+
+bool WSMRollupIndex::addAlert(std::string_view name, int64_t etime) {
+    WSMRollupSlot delta = {};
+    delta.alerts = 1;
+    return apply(site(name), etime, delta);
+}
+
+WSMRangeStats WSMRollupIndex::range(std::string_view name, int64_t from, int64_t to) const {
+    WSMRangeStats stats;
+    stats.clear();
+    auto found = _sites.find(name);
+    if(found == _sites.end() || found->second.slots.empty()) {
+        return stats;
+    }
+    const Site &site = found->second;
+    int64_t count = (int64_t)site.slots.size();
+    int64_t lo = std::max<int64_t>(ceilDiv(from, ROLLUP_SLOT_SECONDS) - site.firstSlot, 0);
+    int64_t hi = std::min<int64_t>(ceilDiv(to, ROLLUP_SLOT_SECONDS) - site.firstSlot, count);
+    if(lo >= hi) {
+        return stats;
+    }
+    stats.slots = (uint64_t)(hi - lo);
+
+    // the partial nodes at each end of a level, then up to the next
+    const int64_t fanout = ROLLUP_INDEX_FANOUT;
+    for(int level = -1; lo < hi; level++) {
+        while(lo < hi && lo % fanout != 0) {
+            if(level < 0) {
+                stats.merge(site.slots[lo]);
+            } else {
+                stats.merge(site.levels[level][lo]);
+            }
+            lo++;
+        }
+        while(lo < hi && hi % fanout != 0) {
+            hi--;
+            if(level < 0) {
+                stats.merge(site.slots[hi]);
+            } else {
+                stats.merge(site.levels[level][hi]);
+            }
+        }
+        lo /= fanout;
+        hi /= fanout;
+    }
+    return stats;
+
+}   // end of range()
+
+void WSMRollupIndex::series(std::string_view site, int64_t from, int64_t to, int64_t step,
+                            std::vector<WSMRangeStats> &buckets) const {
+    buckets.clear();
+    for(int64_t start = from; step > 0 && start < to; start += step) {
+        buckets.push_back(range(site, start, std::min(start + step, to)));
+    }
+}
+
+std::vector<std::string> WSMRollupIndex::sites() const {
+    std::vector<std::string> names;
+    for(const auto &entry : _sites) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+bool WSMRollupIndex::span(std::string_view name, int64_t &first, int64_t &end) const {
+    auto found = _sites.find(name);
+    if(found == _sites.end() || found->second.slots.empty()) {
+        return false;
+    }
+    first = found->second.firstSlot * ROLLUP_SLOT_SECONDS;
+    end = (found->second.firstSlot + (int64_t)found->second.slots.size()) * ROLLUP_SLOT_SECONDS;
+    return true;
+}
+
+uint64_t WSMRollupIndex::bytes() const {
+    uint64_t total = 0;
+    for(const auto &entry : _sites) {
+        total += entry.second.slots.size() * sizeof(WSMRollupSlot);
+        for(const auto &level : entry.second.levels) {
+            total += level.size() * sizeof(WSMRangeStats);
+        }
+    }
+    return total;
+}
+
+// the file: "WSMI", version, 3 reserved bytes, the number of sites; then per site the length and
+//  CRC-16 of its record, and the record: its name's length and name, first half hour, half hours,
+//  PP run time since the WP came on and whether it has, then the half hours packed
+bool WSMRollupIndex::save(const char *path) const {
+    std::string temporary = std::string(path) + ".new";
+    FILE *file = fopen(temporary.c_str(), "wb");
+    if(file == nullptr) {
+        return false;
+    }
+    uint8_t header[12] = {0};
+    memcpy(header, MAGIC, 4);
+    header[4] = INDEX_VERSION;
+    uint32_t count = (uint32_t)_sites.size();
+    memcpy(header + 8, &count, 4);
+    bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+    std::vector<uint8_t> record;
+    for(const auto &entry : _sites) {
+        const Site &site = entry.second;
+        record.clear();
+        uint16_t nameLength = (uint16_t)std::min<size_t>(entry.first.size(), 0xFFFF);
+        uint32_t slots = (uint32_t)site.slots.size();
+        uint8_t wpSeen = site.wpSeen;
+        put(record, &nameLength, 2);
+        put(record, entry.first.data(), nameLength);
+        put(record, &site.firstSlot, 8);
+        put(record, &slots, 4);
+        put(record, &site.ppSinceWP, 8);
+        put(record, &wpSeen, 1);
+        packSlots(site.slots, record);
+
+        uint32_t length = (uint32_t)record.size();
+        uint16_t crc = crc16(0xFFFF, record.data(), record.size());
+        ok = ok && fwrite(&length, 4, 1, file) == 1 && fwrite(&crc, 2, 1, file) == 1 &&
+             fwrite(record.data(), 1, record.size(), file) == record.size();
+    }
+    ok = fflush(file) == 0 && fsync(fileno(file)) == 0 && ok;
+    ok = fclose(file) == 0 && ok;
+    if(!ok || rename(temporary.c_str(), path) != 0) {
+        unlink(temporary.c_str());
+        return false;
+    }
+    return true;
+
+}   // end of save()
+
+bool WSMRollupIndex::load(const char *path) {
+    clear();
+    FILE *file = fopen(path, "rb");
+    if(file == nullptr) {
+        return false;
+    }
+    uint8_t header[12];
+    uint32_t count = 0;
+    bool ok = fread(header, 1, sizeof(header), file) == sizeof(header) && memcmp(header, MAGIC, 4) == 0 &&
+              header[4] == INDEX_VERSION;
+    if(ok) {
+        memcpy(&count, header + 8, 4);
+    }
+
+    std::vector<uint8_t> record;
+    for(uint32_t s = 0; ok && s < count; s++) {
+        uint32_t length;
+        uint16_t crc;
+        ok = fread(&length, 4, 1, file) == 1 && fread(&crc, 2, 1, file) == 1 && length >= 23;
+        if(ok) {
+            record.assign(length + 8, 0);   // and the bit reader's padding
+            ok = fread(record.data(), 1, length, file) == length && crc16(0xFFFF, record.data(), length) == crc;
+        }
+        uint16_t nameLength = 0;
+        if(ok) {
+            memcpy(&nameLength, record.data(), 2);
+            ok = 2 + (size_t)nameLength + 21 <= length;
+        }
+        if(!ok) {
+            break;
+        }
+        const uint8_t *p = record.data() + 2;
+        Site &site = _sites[std::string((const char *)p, nameLength)];
+        p += nameLength;
+        uint32_t slots;
+        memcpy(&site.firstSlot, p, 8);
+        memcpy(&slots, p + 8, 4);
+        memcpy(&site.ppSinceWP, p + 12, 8);
+        site.wpSeen = p[20] != 0;
+        p += 21;
+        ok = slots <= MAX_SLOTS && unpackSlots(p, record.data() + length, slots, site.slots);
+        if(ok) {
+            rebuild(site);
+        }
+    }
+    fclose(file);
+    if(!ok) {
+        clear();
+    }
+    return ok;
+
+}   // end of load()
+
+void WSMRollupIndex::clear() {
+    _sites.clear();
+}
+
+// Private methods
+
+WSMRollupIndex::Site &WSMRollupIndex::site(std::string_view name) {
+    auto found = _sites.find(name);
+    if(found == _sites.end()) {
+        found = _sites.emplace(std::string(name), Site()).first;
+    }
+    return found->second;
+}
+
+// add delta to etime's half hour and each node above it, first making room for it
+bool WSMRollupIndex::apply(Site &site, int64_t etime, const WSMRollupSlot &delta) {
+    int64_t slot = floorDiv(etime, ROLLUP_SLOT_SECONDS);
+    if(site.slots.empty()) {
+        site.firstSlot = slot;
+        site.slots.assign(1, WSMRollupSlot{});
+        rebuild(site);
+    } else if(slot < site.firstSlot) {
+        if(site.firstSlot + (int64_t)site.slots.size() - slot > MAX_SLOTS) {
+            return false;
+        }
+        site.slots.insert(site.slots.begin(), (size_t)(site.firstSlot - slot), WSMRollupSlot{});
+        site.firstSlot = slot;
+        rebuild(site);
+    } else if(slot - site.firstSlot >= (int64_t)site.slots.size()) {
+        if(slot - site.firstSlot >= MAX_SLOTS) {
+            return false;
+        }
+        // the new half hours are empty, and so are the new nodes over only them
+        site.slots.resize((size_t)(slot - site.firstSlot + 1), WSMRollupSlot{});
+        WSMRangeStats empty;
+        empty.clear();
+        size_t below = site.slots.size();
+        for(auto &level : site.levels) {
+            below = (below + ROLLUP_INDEX_FANOUT - 1) / ROLLUP_INDEX_FANOUT;
+            level.resize(below, empty);
+        }
+        addLevels(site);
+    }
+
+    size_t i = (size_t)(slot - site.firstSlot);
+    site.slots[i].merge(delta);
+    for(auto &level : site.levels) {
+        i /= ROLLUP_INDEX_FANOUT;
+        level[i].merge(delta);
+    }
+    return true;
+
+}   // end of apply()
+
+void WSMRollupIndex::rebuild(Site &site) {
+    WSMRangeStats empty;
+    empty.clear();
+    site.levels.clear();
+    std::vector<WSMRangeStats> level((site.slots.size() + ROLLUP_INDEX_FANOUT - 1) / ROLLUP_INDEX_FANOUT, empty);
+    for(size_t i = 0; i < site.slots.size(); i++) {
+        level[i / ROLLUP_INDEX_FANOUT].merge(site.slots[i]);
+    }
+    site.levels.push_back(std::move(level));
+    addLevels(site);
+}   // end of rebuild()
+
+// the levels above the top one, up to a single node
+void WSMRollupIndex::addLevels(Site &site) {
+    WSMRangeStats empty;
+    empty.clear();
+    while(site.levels.back().size() > 1) {
+        const std::vector<WSMRangeStats> &top = site.levels.back();
+        std::vector<WSMRangeStats> next((top.size() + ROLLUP_INDEX_FANOUT - 1) / ROLLUP_INDEX_FANOUT, empty);
+        for(size_t i = 0; i < top.size(); i++) {
+            next[i / ROLLUP_INDEX_FANOUT].merge(top[i]);
+        }
+        site.levels.push_back(std::move(next));
+    }
+}
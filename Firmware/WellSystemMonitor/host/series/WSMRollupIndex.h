@@ -0,0 +1,149 @@
+#ifndef WSMROLLUPINDEX_H_INCLUDE
+#define WSMROLLUPINDEX_H_INCLUDE
+/***************************************************************************************************/
+// WSMRollupIndex.h
+//  Per site aggregates of every half hour (the firmware's halfHourTimeTick() and publishTRH()
+//  period), kept up to date as events arrive, that answer the dashboard's questions for any span
+//  of time without going back to the events:
+//
+//      WSMRollupIndex index;
+//      index.add(site, row);                           // each event, as it arrives
+//      index.addAlert(site, etime);                    // and each wsmAlert*
+//      WSMRangeStats year = index.range(site, from, to);
+//      index.series(site, from, to, 86400, days);      // PP cycles per day for the year
+//
+//  The half hours of a site are the leaves of a tree of fanout ROLLUP_INDEX_FANOUT: each node
+//  holds the merged aggregates of the nodes under it (8 half hours = 4 hours, 64 = 32 hours, ...).
+//  An event is added to its half hour and to each node above it, and a range is answered from at
+//  most 2 * (FANOUT - 1) nodes of each level, O(log n) in the half hours kept; a year of a site is
+//  17,520 half hours and 6 levels.  Half hours are those of the clock (UTC), so an hour is 2 of them
+//  and a day 48.
+//
+//  The PP run time between WP runs is the firmware's: the PP run time since the WP last came on,
+//  taken when it comes on again (MEASURE_PP_ACCUMULATED), counted in that half hour.  It follows
+//  the order the events arrive in.
+//
+//  save() writes the half hours, bit packed by column, a few bytes each; load() reads them back and
+//  builds the tree.  One thread uses an index at a time.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMDataReader.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+const int64_t ROLLUP_SLOT_SECONDS = 1800;
+const unsigned int ROLLUP_INDEX_FANOUT = 8;
+
+// a half hour of a site.  Temperatures and humidities are in hundredths and run times in
+//  milliseconds, as WSMRollup.h keeps them; counts stop at their largest value.
+struct WSMRollupSlot {
+    uint32_t ppMs;          // PP runs that ended in the half hour
+    uint32_t ppMaxMs;
+    uint32_t wpMs;
+    uint32_t wpMaxMs;
+    uint32_t gapMs;         // PP run time between WP runs, for the WP runs that started
+    uint32_t gapMaxMs;
+    int32_t tempSum;
+    int32_t rhSum;
+    uint16_t ppCycles;
+    int16_t tempMin;        // 0 without a TRH report
+    int16_t tempMax;
+    int16_t rhMin;
+    int16_t rhMax;
+    uint8_t wpCycles;
+    uint8_t wpGaps;         // WP runs that started, after one before them
+    uint8_t trhCount;
+    uint8_t alerts;
+    uint8_t reserved[2];
+
+    void merge(const WSMRollupSlot &other);
+};
+
+// the aggregates of a span of half hours
+struct WSMRangeStats {
+    uint64_t slots;         // half hours of the span that the index has
+    uint64_t ppCycles;
+    uint64_t ppMs;
+    uint64_t wpCycles;
+    uint64_t wpMs;
+    uint64_t wpGaps;
+    uint64_t gapMs;
+    uint64_t trhCount;
+    uint64_t alerts;
+    int64_t tempSum;
+    int64_t rhSum;
+    uint32_t ppMaxMs;
+    uint32_t wpMaxMs;
+    uint32_t gapMaxMs;
+    int32_t tempMin;        // 0 without a TRH report
+    int32_t tempMax;
+    int32_t rhMin;
+    int32_t rhMax;
+
+    void clear();
+    void merge(const WSMRollupSlot &slot);
+    void merge(const WSMRangeStats &other);
+    bool operator==(const WSMRangeStats &other) const;
+
+    // averages, in the sheet's units; NaN with nothing to average
+    float ppAverageMinutes() const;
+    float wpAverageMinutes() const;
+    float gapAverageMinutes() const;
+    float tempAverage() const;
+    float rhAverage() const;
+};
+
+class WSMRollupIndex {
+    public:
+        // count an event of site, or an alert it published at etime; false if it has nothing to
+        //  count or would stretch the site's half hours past twenty years
+        bool add(std::string_view site, const WSMDataRow &row);
+        bool addAlert(std::string_view site, int64_t etime);
+
+        // the half hours of site that start from <= t < to; empty for an unknown site
+        WSMRangeStats range(std::string_view site, int64_t from, int64_t to) const;
+
+        // range() of each step seconds (a multiple of ROLLUP_SLOT_SECONDS) from from up to to
+        void series(std::string_view site, int64_t from, int64_t to, int64_t step,
+                    std::vector<WSMRangeStats> &buckets) const;
+
+        std::vector<std::string> sites() const;
+
+        // the start of site's first half hour and the end of its last; false for an unknown site
+        bool span(std::string_view site, int64_t &first, int64_t &end) const;
+
+        // memory held by the half hours and the tree
+        uint64_t bytes() const;
+
+        // write the index to path, beside it then renamed over it; read it back
+        bool save(const char *path) const;
+        bool load(const char *path);
+
+        void clear();
+
+    private:
+        struct Site {
+            int64_t firstSlot = 0;
+            std::vector<WSMRollupSlot> slots;
+            std::vector<std::vector<WSMRangeStats>> levels;     // levels[0] is over the slots
+            uint64_t ppSinceWP = 0;     // ms
+            bool wpSeen = false;
+        };
+
+        Site &site(std::string_view name);
+        bool apply(Site &site, int64_t etime, const WSMRollupSlot &delta);
+        void rebuild(Site &site);
+        void addLevels(Site &site);
+
+        std::map<std::string, Site, std::less<>> _sites;
+};
+
+#endif  // end of header duplication prevention
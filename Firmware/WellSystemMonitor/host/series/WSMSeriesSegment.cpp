@@ -0,0 +1,353 @@
+/***************************************************************************************************/
+// WSMSeriesSegment.cpp
+//  Column encoding of the series store's segments.  See WSMSeriesSegment.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMSeriesSegment.h"
+#include "WSMBitPacking.h"
+#include "TPPUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+    const char MAGIC[4] = {'W', 'S', 'M', 'S'};
+    const size_t PADDING = 8;       // for the bit reader's 8 byte loads
+
+    enum Codec {
+        CODEC_OFFSET,       // value - the block's lowest
+        CODEC_DELTA         // zigzag of value - the value before
+    };
+
+    struct Column {
+        Codec codec;
+        bool nullable;      // a presence bit per row
+        int count;          // or present where this earlier column is not 0; -1 if always present
+    };
+
+    // code (event, pp + 1, wp + 1), temp, rh, ppon, wpon
+    const unsigned int EVENT_COLUMNS = 5;
+    const Column EVENT_LAYOUT[EVENT_COLUMNS] = {
+        {CODEC_OFFSET, false, -1}, {CODEC_DELTA, true, -1}, {CODEC_DELTA, true, -1}, {CODEC_OFFSET, true, -1},
+        {CODEC_OFFSET, true, -1}
+    };
+
+    // ppCycles, ppMaxMs, ppMs - ppMaxMs, wpCycles, wpMaxMs, wpMs - wpMaxMs, trhCount, tempMin,
+    //  tempMax - tempMin, tempSum - tempMin * trhCount, rhMin, rhMax - rhMin, rhSum - rhMin * trhCount:
+    //  the differences are small, and 0 for an hour of one cycle or one report.  The run times are
+    //  only there for an hour with cycles, and the temperatures and humidities for one with reports.
+    const unsigned int ROLLUP_COLUMNS = 13;
+    const Column ROLLUP_LAYOUT[ROLLUP_COLUMNS] = {
+        {CODEC_OFFSET, false, -1}, {CODEC_OFFSET, false, 0}, {CODEC_OFFSET, false, 0}, {CODEC_OFFSET, false, -1},
+        {CODEC_OFFSET, false, 3}, {CODEC_OFFSET, false, 3}, {CODEC_OFFSET, false, -1}, {CODEC_DELTA, false, 6},
+        {CODEC_OFFSET, false, 6}, {CODEC_OFFSET, false, 6}, {CODEC_DELTA, false, 6}, {CODEC_OFFSET, false, 6},
+        {CODEC_OFFSET, false, 6}
+    };
+    const unsigned int MAX_COLUMNS = ROLLUP_COLUMNS;
+
+    // a segment's values before they are encoded, or a block's after
+    struct Table {
+        std::vector<int64_t> etime;
+        std::vector<int32_t> values[MAX_COLUMNS];
+        std::vector<uint8_t> present[MAX_COLUMNS];
+
+        void resize(size_t rows, unsigned int columns) {
+            etime.resize(rows);
+            for(unsigned int c = 0; c < columns; c++) {
+                values[c].assign(rows, 0);
+                present[c].assign(rows, 1);
+            }
+        }
+    };
+
+    // rollup etimes are whole hours apart
+    int64_t etimeUnit(WSMSegmentKind kind) {
+        return kind == SEGMENT_ROLLUPS ? ROLLUP_SECONDS : 1;
+    }
+
+    int8_t flag(int value) {
+        return value >= 0 && value <= 1 ? (int8_t)value : -1;
+    }
+
+    void put32(std::vector<uint8_t> &bytes, int32_t value) {
+        uint8_t raw[4];
+        memcpy(raw, &value, 4);
+        bytes.insert(bytes.end(), raw, raw + 4);
+    }
+
+    void encodeBlock(const Table &table, size_t begin, unsigned int rows, const Column *layout, unsigned int columns,
+                     int64_t unit, std::vector<uint8_t> &bytes) {
+        uint32_t maxDelta = 0;
+        for(unsigned int i = 1; i < rows; i++) {
+            maxDelta = std::max(maxDelta, (uint32_t)((table.etime[begin + i] - table.etime[begin + i - 1]) / unit));
+        }
+        unsigned int etimeWidth = bitWidth(maxDelta);
+        bytes.push_back((uint8_t)etimeWidth);
+
+        int32_t bases[MAX_COLUMNS];
+        unsigned int widths[MAX_COLUMNS];
+        for(unsigned int c = 0; c < columns; c++) {
+            const int32_t *values = &table.values[c][begin];
+            const uint8_t *present = &table.present[c][begin];
+            bool any = false;
+            int32_t low = 0, high = 0, previous = 0;
+            uint32_t widest = 0;
+            for(unsigned int i = 0; i < rows; i++) {
+                if(!present[i]) {
+                    continue;
+                }
+                if(!any) {
+                    low = high = previous = values[i];
+                    any = true;
+                }
+                low = std::min(low, values[i]);
+                high = std::max(high, values[i]);
+                widest = std::max(widest, zigzag(values[i] - previous));
+                previous = values[i];
+            }
+            bases[c] = layout[c].codec == CODEC_OFFSET ? low : 0;
+            for(unsigned int i = 0; layout[c].codec == CODEC_DELTA && i < rows; i++) {
+                if(present[i]) {
+                    bases[c] = values[i];   // the first present value
+                    break;
+                }
+            }
+            widths[c] = layout[c].codec == CODEC_OFFSET ? bitWidth((uint32_t)(high - low)) : bitWidth(widest);
+            put32(bytes, bases[c]);
+            bytes.push_back((uint8_t)widths[c]);
+        }
+
+        WSMBitWriter writer(bytes);
+        for(unsigned int c = 0; c < columns; c++) {
+            for(unsigned int i = 0; layout[c].nullable && i < rows; i++) {
+                writer.write(table.present[c][begin + i], 1);
+            }
+        }
+        for(unsigned int i = 1; i < rows; i++) {
+            writer.write((uint32_t)((table.etime[begin + i] - table.etime[begin + i - 1]) / unit), etimeWidth);
+        }
+        for(unsigned int c = 0; c < columns; c++) {
+            int32_t previous = bases[c];
+            for(unsigned int i = 0; i < rows; i++) {
+                if(!table.present[c][begin + i]) {
+                    continue;
+                }
+                int32_t value = table.values[c][begin + i];
+                writer.write(layout[c].codec == CODEC_OFFSET ? (uint32_t)(value - bases[c]) : zigzag(value - previous),
+                             widths[c]);
+                previous = value;
+            }
+        }
+        writer.flush();
+
+    }   // end of encodeBlock()
+
+    void encodeSegment(WSMSegmentKind kind, const Table &table, size_t rows, const Column *layout, unsigned int columns,
+                       std::vector<uint8_t> &bytes) {
+        size_t start = bytes.size();
+        unsigned int blocks = (unsigned int)((rows + SERIES_BLOCK_ROWS - 1) / SERIES_BLOCK_ROWS);
+        bytes.resize(start + sizeof(WSMSegmentHeader) + blocks * sizeof(WSMBlockIndex), 0);
+
+        std::vector<WSMBlockIndex> index(blocks);
+        for(unsigned int b = 0; b < blocks; b++) {
+            size_t begin = (size_t)b * SERIES_BLOCK_ROWS;
+            unsigned int count = (unsigned int)std::min<size_t>(SERIES_BLOCK_ROWS, rows - begin);
+            index[b].firstEtime = table.etime[begin];
+            index[b].lastEtime = table.etime[begin + count - 1];
+            index[b].offset = (uint32_t)(bytes.size() - start);
+            index[b].rows = (uint16_t)count;
+            index[b].reserved = 0;
+            encodeBlock(table, begin, count, layout, columns, etimeUnit(kind), bytes);
+        }
+        bytes.resize(bytes.size() + PADDING, 0);
+        bytes.resize(start + (bytes.size() - start + 7) / 8 * 8, 0);
+
+        WSMSegmentHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = SERIES_VERSION;
+        header.kind = (uint8_t)kind;
+        header.rows = (uint32_t)rows;
+        header.blocks = blocks;
+        header.bytes = (uint32_t)(bytes.size() - start);
+        header.firstEtime = rows > 0 ? table.etime[0] : 0;
+        header.lastEtime = rows > 0 ? table.etime[rows - 1] : 0;
+        header.crc = crc16(0xFFFF, (const uint8_t *)&header, sizeof(header));
+        memcpy(&bytes[start], &header, sizeof(header));
+        if(blocks > 0) {
+            memcpy(&bytes[start + sizeof(header)], index.data(), blocks * sizeof(WSMBlockIndex));
+        }
+    }   // end of encodeSegment()
+
+    // the values of block i of a segment into table[0, rows)
+    void decodeBlock(const uint8_t *segment, const WSMBlockIndex &block, WSMSegmentKind kind, const Column *layout,
+                     unsigned int columns, Table &table) {
+        const uint8_t *p = segment + block.offset;
+        unsigned int rows = block.rows;
+        unsigned int etimeWidth = *p++;
+        int32_t bases[MAX_COLUMNS];
+        unsigned int widths[MAX_COLUMNS];
+        for(unsigned int c = 0; c < columns; c++) {
+            memcpy(&bases[c], p, 4);
+            widths[c] = p[4];
+            p += 5;
+        }
+
+        WSMBitReader reader(p);
+        for(unsigned int c = 0; c < columns; c++) {
+            for(unsigned int i = 0; i < rows; i++) {
+                table.present[c][i] = layout[c].nullable ? (uint8_t)reader.read(1) : 1;
+            }
+        }
+        int64_t unit = etimeUnit(kind);
+        table.etime[0] = block.firstEtime;
+        for(unsigned int i = 1; i < rows; i++) {
+            table.etime[i] = table.etime[i - 1] + (int64_t)reader.read(etimeWidth) * unit;
+        }
+        for(unsigned int c = 0; c < columns; c++) {
+            int32_t value = bases[c];
+            for(unsigned int i = 0; i < rows; i++) {
+                if(layout[c].count >= 0) {
+                    table.present[c][i] = table.values[layout[c].count][i] != 0;
+                    table.values[c][i] = 0;
+                }
+                if(!table.present[c][i]) {
+                    continue;
+                }
+                uint32_t bits = reader.read(widths[c]);
+                value = layout[c].codec == CODEC_OFFSET ? bases[c] + (int32_t)bits : value + unzigzag(bits);
+                table.values[c][i] = value;
+            }
+        }
+    }   // end of decodeBlock()
+
+    Table &blockTable() {
+        thread_local Table table;
+        if(table.etime.size() != SERIES_BLOCK_ROWS) {
+            table.resize(SERIES_BLOCK_ROWS, MAX_COLUMNS);
+        }
+        return table;
+    }
+
+}   // namespace
+
+WSMDataRow WSMSeriesBlock::row(unsigned int i) const {
+    WSMDataRow row;
+    row.etime = etime[i];
+    row.temp = temp[i];
+    row.rh = rh[i];
+    row.pp = pp[i];
+    row.wp = wp[i];
+    row.ppon = ppon[i];
+    row.wpon = wpon[i];
+    row.event = (WSMEventType)event[i];
+    return row;
+}
+
+void encodeEvents(const WSMDataRow *rows, size_t count, std::vector<uint8_t> &bytes) {
+    Table table;
+    table.resize(count, EVENT_COLUMNS);
+    for(size_t i = 0; i < count; i++) {
+        const WSMDataRow &row = rows[i];
+        table.etime[i] = row.etime;
+        table.values[0][i] = (int32_t)row.event | (flag(row.pp) + 1) << 2 | (flag(row.wp) + 1) << 4;
+        const float floats[4] = {row.temp, row.rh, row.ppon, row.wpon};
+        for(unsigned int c = 1; c < EVENT_COLUMNS; c++) {
+            float value = floats[c - 1];
+            table.present[c][i] = !std::isnan(value);
+            table.values[c][i] = std::isnan(value) ? 0 : c <= 2 ? hundredths(value) : runMillis(value);
+        }
+    }
+    encodeSegment(SEGMENT_EVENTS, table, count, EVENT_LAYOUT, EVENT_COLUMNS, bytes);
+}
+
+void encodeRollups(const WSMRollup *rollups, size_t count, std::vector<uint8_t> &bytes) {
+    Table table;
+    table.resize(count, ROLLUP_COLUMNS);
+    for(size_t i = 0; i < count; i++) {
+        const WSMRollup &r = rollups[i];
+        const int32_t values[ROLLUP_COLUMNS] = {
+            (int32_t)r.ppCycles, (int32_t)r.ppMaxMs, (int32_t)(r.ppMs - r.ppMaxMs),
+            (int32_t)r.wpCycles, (int32_t)r.wpMaxMs, (int32_t)(r.wpMs - r.wpMaxMs),
+            (int32_t)r.trhCount, r.tempMin, (int32_t)((uint32_t)r.tempMax - (uint32_t)r.tempMin),
+            (int32_t)((uint32_t)r.tempSum - (uint32_t)r.tempMin * r.trhCount), r.rhMin,
+            (int32_t)((uint32_t)r.rhMax - (uint32_t)r.rhMin), (int32_t)((uint32_t)r.rhSum - (uint32_t)r.rhMin * r.trhCount)
+        };
+        table.etime[i] = r.start;
+        for(unsigned int c = 0; c < ROLLUP_COLUMNS; c++) {
+            table.values[c][i] = values[c];
+            table.present[c][i] = ROLLUP_LAYOUT[c].count < 0 || values[ROLLUP_LAYOUT[c].count] != 0;
+        }
+    }
+    encodeSegment(SEGMENT_ROLLUPS, table, count, ROLLUP_LAYOUT, ROLLUP_COLUMNS, bytes);
+}
+
+bool WSMSegmentView::attach(const uint8_t *data, size_t available) {
+    if(available < sizeof(WSMSegmentHeader)) {
+        return false;
+    }
+    WSMSegmentHeader header;
+    memcpy(&header, data, sizeof(header));
+    uint16_t crc = header.crc;
+    header.crc = 0;
+    if(memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != SERIES_VERSION ||
+       crc != crc16(0xFFFF, (const uint8_t *)&header, sizeof(header)) || header.bytes > available ||
+       sizeof(header) + (size_t)header.blocks * sizeof(WSMBlockIndex) + PADDING > header.bytes) {
+        return false;
+    }
+    _data = data;
+    _header = (const WSMSegmentHeader *)data;
+    _index = (const WSMBlockIndex *)(data + sizeof(WSMSegmentHeader));
+    return true;
+}
+
+unsigned int WSMSegmentView::findBlock(int64_t from) const {
+    const WSMBlockIndex *found = std::lower_bound(_index, _index + blocks(), from,
+        [](const WSMBlockIndex &block, int64_t etime) { return block.lastEtime < etime; });
+    return (unsigned int)(found - _index);
+}
+
+void WSMSegmentView::decode(unsigned int i, WSMSeriesBlock &events) const {
+    Table &table = blockTable();
+    decodeBlock(_data, _index[i], SEGMENT_EVENTS, EVENT_LAYOUT, EVENT_COLUMNS, table);
+    events.rows = _index[i].rows;
+    for(unsigned int r = 0; r < events.rows; r++) {
+        int32_t code = table.values[0][r];
+        events.etime[r] = table.etime[r];
+        events.event[r] = (uint8_t)(code & 3);
+        events.pp[r] = (int8_t)(((code >> 2) & 3) - 1);
+        events.wp[r] = (int8_t)(((code >> 4) & 3) - 1);
+        events.temp[r] = table.present[1][r] ? table.values[1][r] / 100.0f : NAN;
+        events.rh[r] = table.present[2][r] ? table.values[2][r] / 100.0f : NAN;
+        events.ppon[r] = table.present[3][r] ? table.values[3][r] / 60000.0f : NAN;
+        events.wpon[r] = table.present[4][r] ? table.values[4][r] / 60000.0f : NAN;
+    }
+}
+
+void WSMSegmentView::decode(unsigned int i, WSMRollup *rollups) const {
+    Table &table = blockTable();
+    decodeBlock(_data, _index[i], SEGMENT_ROLLUPS, ROLLUP_LAYOUT, ROLLUP_COLUMNS, table);
+    for(unsigned int r = 0; r < _index[i].rows; r++) {
+        WSMRollup &rollup = rollups[r];
+        rollup.start = table.etime[r];
+        rollup.ppCycles = (uint32_t)table.values[0][r];
+        rollup.ppMaxMs = (uint32_t)table.values[1][r];
+        rollup.ppMs = rollup.ppMaxMs + (uint32_t)table.values[2][r];
+        rollup.wpCycles = (uint32_t)table.values[3][r];
+        rollup.wpMaxMs = (uint32_t)table.values[4][r];
+        rollup.wpMs = rollup.wpMaxMs + (uint32_t)table.values[5][r];
+        rollup.trhCount = (uint32_t)table.values[6][r];
+        rollup.tempMin = table.values[7][r];
+        rollup.tempMax = (int32_t)((uint32_t)rollup.tempMin + (uint32_t)table.values[8][r]);
+        rollup.tempSum = (int32_t)((uint32_t)rollup.tempMin * rollup.trhCount + (uint32_t)table.values[9][r]);
+        rollup.rhMin = table.values[10][r];
+        rollup.rhMax = (int32_t)((uint32_t)rollup.rhMin + (uint32_t)table.values[11][r]);
+        rollup.rhSum = (int32_t)((uint32_t)rollup.rhMin * rollup.trhCount + (uint32_t)table.values[12][r]);
+    }
+}
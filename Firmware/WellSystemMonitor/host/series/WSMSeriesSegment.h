@@ -0,0 +1,107 @@
+#ifndef WSMSERIESSEGMENT_H_INCLUDE
+#define WSMSERIESSEGMENT_H_INCLUDE
+/***************************************************************************************************/
+// WSMSeriesSegment.h
+//  The segments of the series store (WSMSeriesStore.h): up to SERIES_SEGMENT_ROWS of a site's
+//  events, or of its hourly rollups (WSMRollup.h), in time order, as columns.  A segment is
+//
+//      header      48 bytes: "WSMS", version, kind, the CRC-16 of the header, rows, blocks, bytes,
+//                  first and last etime
+//      index       per block of SERIES_BLOCK_ROWS rows: its first and last etime and where it starts
+//      blocks      per column a base and a bit width, then the columns bit packed
+//      padding     at least 8 zero bytes, to a multiple of 8
+//
+//  The index is the sparse time index: a time range is found by a binary search over it, and only
+//  the blocks in range are decoded, straight from the mapped file.  In a block the etime is the
+//  delta from the row before; temperatures and humidities (hundredths) the zigzag delta from the
+//  value before; run times (milliseconds), counts and the event's kind, PP and WP flags (6 bits)
+//  the offset from the block's lowest value.  Each column takes the bits of its widest value in the
+//  block, and a missing value only a presence bit.  A healthy site's event takes about 4 bytes.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMDataReader.h"
+#include "WSMRollup.h"
+
+#include <cstdint>
+#include <vector>
+
+const unsigned int SERIES_BLOCK_ROWS = 128;
+const unsigned int SERIES_SEGMENT_ROWS = 4096;
+const uint8_t SERIES_VERSION = 1;
+
+enum WSMSegmentKind {
+    SEGMENT_EVENTS,
+    SEGMENT_ROLLUPS
+};
+
+struct WSMSegmentHeader {
+    char magic[4];          // "WSMS"
+    uint8_t version;
+    uint8_t kind;           // WSMSegmentKind
+    uint16_t crc;           // CRC-16/CCITT of the header with crc 0
+    uint32_t rows;
+    uint32_t blocks;
+    uint32_t bytes;         // the whole segment, padding and all
+    uint32_t reserved;
+    int64_t firstEtime;
+    int64_t lastEtime;
+    uint8_t reserved2[8];
+};
+
+struct WSMBlockIndex {
+    int64_t firstEtime;
+    int64_t lastEtime;
+    uint32_t offset;        // from the start of the segment
+    uint16_t rows;
+    uint16_t reserved;
+};
+
+// a block of events, decoded into columns
+struct WSMSeriesBlock {
+    unsigned int rows;
+    int64_t etime[SERIES_BLOCK_ROWS];
+    uint8_t event[SERIES_BLOCK_ROWS];       // WSMEventType
+    int8_t pp[SERIES_BLOCK_ROWS];           // -1 if missing
+    int8_t wp[SERIES_BLOCK_ROWS];
+    float temp[SERIES_BLOCK_ROWS];          // NaN if missing
+    float rh[SERIES_BLOCK_ROWS];
+    float ppon[SERIES_BLOCK_ROWS];
+    float wpon[SERIES_BLOCK_ROWS];
+
+    WSMDataRow row(unsigned int i) const;
+};
+
+// append a segment of rows, in etime order (at most SERIES_SEGMENT_ROWS), to bytes.  Temperatures
+//  and humidities are kept to 0.01 and run times to the millisecond.
+void encodeEvents(const WSMDataRow *rows, size_t count, std::vector<uint8_t> &bytes);
+void encodeRollups(const WSMRollup *rollups, size_t count, std::vector<uint8_t> &bytes);
+
+// a segment where it lies, in a mapped file
+class WSMSegmentView {
+    public:
+        // false if data does not start with a whole segment of this version
+        bool attach(const uint8_t *data, size_t available);
+
+        const WSMSegmentHeader &header() const { return *_header; }
+        WSMSegmentKind kind() const { return (WSMSegmentKind)_header->kind; }
+        unsigned int blocks() const { return _header->blocks; }
+        const WSMBlockIndex &block(unsigned int i) const { return _index[i]; }
+
+        // the first block whose last etime is at or after from; blocks() if none
+        unsigned int findBlock(int64_t from) const;
+
+        // decode a block of an events segment, or of a rollups segment (block(i).rows rollups)
+        void decode(unsigned int i, WSMSeriesBlock &events) const;
+        void decode(unsigned int i, WSMRollup *rollups) const;
+
+    private:
+        const uint8_t *_data = nullptr;
+        const WSMSegmentHeader *_header = nullptr;
+        const WSMBlockIndex *_index = nullptr;
+};
+
+#endif  // end of header duplication prevention
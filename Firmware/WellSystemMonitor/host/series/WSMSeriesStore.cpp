@@ -0,0 +1,441 @@
+/***************************************************************************************************/
+// WSMSeriesStore.cpp
+//  Memory mapped columnar history of the sites' events.  See WSMSeriesStore.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMSeriesStore.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+    const char EXTENSION[] = ".wsms";
+
+    bool writeAll(int fd, const uint8_t *bytes, size_t length, off_t offset) {
+        while(length > 0) {
+            ssize_t n = pwrite(fd, bytes, length, offset);
+            if(n < 0 && errno == EINTR) {
+                continue;
+            } else if(n <= 0) {
+                return false;
+            }
+            bytes += n;
+            length -= n;
+            offset += n;
+        }
+        return true;
+    }
+
+    bool earlier(const WSMDataRow &a, const WSMDataRow &b) {
+        return a.etime < b.etime;
+    }
+
+    // the rows of block from <= etime < to
+    void rowsInRange(const WSMSeriesBlock &block, int64_t from, int64_t to, unsigned int &begin, unsigned int &end) {
+        begin = (unsigned int)(std::lower_bound(block.etime, block.etime + block.rows, from) - block.etime);
+        end = (unsigned int)(std::lower_bound(block.etime, block.etime + block.rows, to) - block.etime);
+    }
+
+}   // namespace
+
+WSMSeriesStore::WSMSeriesStore() : _sync(true) {}
+
+WSMSeriesStore::~WSMSeriesStore() {
+    close();
+}
+
+bool WSMSeriesStore::open(const char *directory, bool sync) {
+    close();
+    if(mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        return false;
+    }
+    DIR *dir = opendir(directory);
+    if(dir == nullptr) {
+        return false;
+    }
+    _directory = directory;
+    _sync = sync;
+
+    std::vector<std::string> names;
+    const size_t extensionLength = sizeof(EXTENSION) - 1;
+    while(dirent *entry = readdir(dir)) {
+        size_t length = strlen(entry->d_name);
+        if(length > extensionLength && strcmp(entry->d_name + length - extensionLength, EXTENSION) == 0) {
+            names.push_back(std::string(entry->d_name, length - extensionLength));
+        }
+    }
+    closedir(dir);
+
+    for(const std::string &name : names) {
+        if(!openSite(name)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+
+}   // end of open()
+
+void WSMSeriesStore::close() {
+    flush();
+    for(auto &entry : _sites) {
+        unmap(*entry.second);
+        ::close(entry.second->fd);
+    }
+    _sites.clear();
+}
+
+bool WSMSeriesStore::append(std::string_view site, const WSMDataRow &row) {
+    Site *found = find(site);
+    if(found == nullptr) {
+        std::string name = fileName(site);
+        if(!openSite(name)) {
+            return false;
+        }
+        found = _sites[name].get();
+    }
+    found->waiting.push_back(row);
+    return found->waiting.size() < SERIES_SEGMENT_ROWS || seal(*found);
+}
+
+bool WSMSeriesStore::flush() {
+    bool ok = true;
+    for(auto &entry : _sites) {
+        ok = seal(*entry.second) && ok;
+    }
+    return ok;
+}
+
+std::vector<std::string> WSMSeriesStore::sites() const {
+    std::vector<std::string> names;
+    for(const auto &entry : _sites) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+uint64_t WSMSeriesStore::scan(std::string_view site, int64_t from, int64_t to, const BlockScan &scan) const {
+    const Site *found = find(site);
+    if(found == nullptr) {
+        return 0;
+    }
+    uint64_t rows = 0;
+    WSMSeriesBlock block;
+    unsigned int begin, end;
+    for(const Segment &segment : found->segments) {
+        if(segment.kind != SEGMENT_EVENTS || segment.lastEtime < from || segment.firstEtime >= to) {
+            continue;
+        }
+        WSMSegmentView view;
+        view.attach(found->map + segment.offset, found->size - segment.offset);
+        for(unsigned int b = view.findBlock(from); b < view.blocks() && view.block(b).firstEtime < to; b++) {
+            view.decode(b, block);
+            rowsInRange(block, from, to, begin, end);
+            if(begin < end) {
+                scan(block, begin, end);
+                rows += end - begin;
+            }
+        }
+    }
+
+    // and the rows not written yet
+    std::vector<WSMDataRow> waiting;
+    for(const WSMDataRow &row : found->waiting) {
+        if(row.etime >= from && row.etime < to) {
+            waiting.push_back(row);
+        }
+    }
+    std::stable_sort(waiting.begin(), waiting.end(), earlier);
+    for(size_t i = 0; i < waiting.size(); i += SERIES_BLOCK_ROWS) {
+        block.rows = (unsigned int)std::min<size_t>(SERIES_BLOCK_ROWS, waiting.size() - i);
+        for(unsigned int r = 0; r < block.rows; r++) {
+            const WSMDataRow &row = waiting[i + r];
+            block.etime[r] = row.etime;
+            block.event[r] = (uint8_t)row.event;
+            block.pp[r] = (int8_t)row.pp;
+            block.wp[r] = (int8_t)row.wp;
+            block.temp[r] = row.temp;
+            block.rh[r] = row.rh;
+            block.ppon[r] = row.ppon;
+            block.wpon[r] = row.wpon;
+        }
+        scan(block, 0, block.rows);
+        rows += block.rows;
+    }
+    return rows;
+
+}   // end of scan()
+
+uint64_t WSMSeriesStore::scanRows(std::string_view site, int64_t from, int64_t to, const RowScan &scan) const {
+    return this->scan(site, from, to, [&](const WSMSeriesBlock &block, unsigned int begin, unsigned int end) {
+        for(unsigned int i = begin; i < end; i++) {
+            scan(block.row(i));
+        }
+    });
+}
+
+uint64_t WSMSeriesStore::scanRollups(std::string_view site, int64_t from, int64_t to, const RollupScan &scan) const {
+    const Site *found = find(site);
+    if(found == nullptr) {
+        return 0;
+    }
+    uint64_t rollups = 0;
+    WSMRollup decoded[SERIES_BLOCK_ROWS];
+    for(const Segment &segment : found->segments) {
+        if(segment.kind != SEGMENT_ROLLUPS || segment.lastEtime < from || segment.firstEtime >= to) {
+            continue;
+        }
+        WSMSegmentView view;
+        view.attach(found->map + segment.offset, found->size - segment.offset);
+        for(unsigned int b = view.findBlock(from); b < view.blocks() && view.block(b).firstEtime < to; b++) {
+            view.decode(b, decoded);
+            for(unsigned int r = 0; r < view.block(b).rows; r++) {
+                if(decoded[r].start >= from && decoded[r].start < to) {
+                    scan(decoded[r]);
+                    rollups++;
+                }
+            }
+        }
+    }
+    return rollups;
+
+}   // end of scanRollups()
+
+bool WSMSeriesStore::retain(int64_t cutoff) {
+    bool ok = true;
+    for(auto &entry : _sites) {
+        ok = retainSite(*entry.second, cutoff) && ok;
+    }
+    return ok;
+}
+
+WSMSeriesStats WSMSeriesStore::stats() const {
+    WSMSeriesStats stats;
+    for(const auto &entry : _sites) {
+        const Site &site = *entry.second;
+        stats.sites++;
+        stats.bytes += site.size;
+        stats.events += site.waiting.size();
+        for(const Segment &segment : site.segments) {
+            if(segment.kind == SEGMENT_EVENTS) {
+                stats.eventSegments++;
+                stats.events += segment.rows;
+            } else {
+                stats.rollupSegments++;
+                stats.rollups += segment.rows;
+            }
+        }
+    }
+    return stats;
+}
+
+std::string WSMSeriesStore::fileName(std::string_view site) {
+    std::string name;
+    for(char c : site) {
+        if(c == '\0') {
+            break;  // the rest of a zero padded coreid
+        }
+        name += isalnum((unsigned char)c) || c == '-' || c == '_' ? c : '_';
+    }
+    return name.empty() ? "_" : name;
+}
+
+// Private methods
+
+WSMSeriesStore::Site *WSMSeriesStore::find(std::string_view site) const {
+    auto found = _sites.find(fileName(site));
+    return found == _sites.end() ? nullptr : found->second.get();
+}
+
+bool WSMSeriesStore::openSite(const std::string &name) {
+    std::unique_ptr<Site> site(new Site());
+    site->path = _directory + "/" + name + EXTENSION;
+    if(!load(*site)) {
+        return false;
+    }
+    _sites[name] = std::move(site);
+    return true;
+}
+
+// open, map and walk a site's file, cutting off anything after the last whole segment
+bool WSMSeriesStore::load(Site &site) {
+    site.segments.clear();
+    site.fd = ::open(site.path.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat status;
+    if(site.fd < 0 || fstat(site.fd, &status) != 0) {
+        if(site.fd >= 0) {
+            ::close(site.fd);
+        }
+        return false;
+    }
+    site.size = (size_t)status.st_size;
+    if(!remap(site)) {
+        ::close(site.fd);
+        return false;
+    }
+
+    size_t offset = 0;
+    WSMSegmentView view;
+    while(offset < site.size && view.attach(site.map + offset, site.size - offset)) {
+        const WSMSegmentHeader &header = view.header();
+        site.segments.push_back({offset, view.kind(), header.firstEtime, header.lastEtime, header.rows});
+        offset += header.bytes;
+    }
+    if(offset < site.size) {
+        fprintf(stderr, "%s: cut off %zu bytes after the last whole segment\n", site.path.c_str(), site.size - offset);
+        unmap(site);
+        site.size = offset;
+        if(ftruncate(site.fd, (off_t)offset) != 0 || !remap(site)) {
+            ::close(site.fd);
+            return false;
+        }
+    }
+    return true;
+
+}   // end of load()
+
+bool WSMSeriesStore::remap(Site &site) {
+    unmap(site);
+    if(site.size == 0) {
+        return true;
+    }
+    void *map = mmap(nullptr, site.size, PROT_READ, MAP_SHARED, site.fd, 0);
+    if(map == MAP_FAILED) {
+        return false;
+    }
+    site.map = (const uint8_t *)map;
+    return true;
+}
+
+void WSMSeriesStore::unmap(Site &site) {
+    if(site.map != nullptr) {
+        munmap((void *)site.map, site.size);
+        site.map = nullptr;
+    }
+}
+
+// append encoded segments to the site's file and map them
+bool WSMSeriesStore::writeSegments(Site &site, const std::vector<uint8_t> &bytes) {
+    if(!writeAll(site.fd, bytes.data(), bytes.size(), (off_t)site.size) || (_sync && fdatasync(site.fd) != 0)) {
+        perror(site.path.c_str());
+        return false;
+    }
+    size_t offset = 0;
+    WSMSegmentView view;
+    while(offset < bytes.size() && view.attach(&bytes[offset], bytes.size() - offset)) {
+        const WSMSegmentHeader &header = view.header();
+        site.segments.push_back({site.size + offset, view.kind(), header.firstEtime, header.lastEtime, header.rows});
+        offset += header.bytes;
+    }
+    unmap(site);
+    site.size += bytes.size();
+    return remap(site);
+}
+
+// write the waiting rows, in etime order
+bool WSMSeriesStore::seal(Site &site) {
+    if(site.waiting.empty()) {
+        return true;
+    }
+    std::stable_sort(site.waiting.begin(), site.waiting.end(), earlier);
+    std::vector<uint8_t> bytes;
+    for(size_t i = 0; i < site.waiting.size(); i += SERIES_SEGMENT_ROWS) {
+        encodeEvents(&site.waiting[i], std::min<size_t>(SERIES_SEGMENT_ROWS, site.waiting.size() - i), bytes);
+    }
+    if(!writeSegments(site, bytes)) {
+        return false;
+    }
+    site.waiting.clear();
+    return true;
+}
+
+// replace the event segments that end before cutoff with rollups of their events
+bool WSMSeriesStore::retainSite(Site &site, int64_t cutoff) {
+    bool old = false;
+    for(const Segment &segment : site.segments) {
+        old = old || (segment.kind == SEGMENT_EVENTS && segment.lastEtime < cutoff);
+    }
+    if(!old) {
+        return true;
+    }
+
+    // every hour kept so far, and the hours of the old events
+    std::map<int64_t, WSMRollup> hours;
+    std::vector<const Segment *> kept;
+    WSMSeriesBlock block;
+    WSMRollup decoded[SERIES_BLOCK_ROWS];
+    for(const Segment &segment : site.segments) {
+        WSMSegmentView view;
+        view.attach(site.map + segment.offset, site.size - segment.offset);
+        if(segment.kind == SEGMENT_EVENTS && segment.lastEtime >= cutoff) {
+            kept.push_back(&segment);
+            continue;
+        }
+        for(unsigned int b = 0; b < view.blocks(); b++) {
+            if(segment.kind == SEGMENT_ROLLUPS) {
+                view.decode(b, decoded);
+                for(unsigned int r = 0; r < view.block(b).rows; r++) {
+                    auto inserted = hours.emplace(decoded[r].start, decoded[r]);
+                    if(!inserted.second) {
+                        inserted.first->second.merge(decoded[r]);
+                    }
+                }
+                continue;
+            }
+            view.decode(b, block);
+            for(unsigned int r = 0; r < block.rows; r++) {
+                int64_t start = rollupStart(block.etime[r]);
+                auto inserted = hours.emplace(start, WSMRollup());
+                if(inserted.second) {
+                    inserted.first->second.clear(start);
+                }
+                inserted.first->second.add(block.row(r));
+            }
+        }
+    }
+
+    std::vector<WSMRollup> rollups;
+    for(const auto &hour : hours) {
+        rollups.push_back(hour.second);
+    }
+    std::vector<uint8_t> bytes;
+    for(size_t i = 0; i < rollups.size(); i += SERIES_SEGMENT_ROWS) {
+        encodeRollups(&rollups[i], std::min<size_t>(SERIES_SEGMENT_ROWS, rollups.size() - i), bytes);
+    }
+    for(const Segment *segment : kept) {
+        const WSMSegmentHeader *header = (const WSMSegmentHeader *)(site.map + segment->offset);
+        bytes.insert(bytes.end(), site.map + segment->offset, site.map + segment->offset + header->bytes);
+    }
+
+    // the new file beside the old one, then over it
+    std::string path = site.path;
+    std::string temporary = path + ".new";
+    int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0 || !writeAll(fd, bytes.data(), bytes.size(), 0) || (_sync && fdatasync(fd) != 0) ||
+       rename(temporary.c_str(), path.c_str()) != 0) {
+        perror(temporary.c_str());
+        if(fd >= 0) {
+            ::close(fd);
+            unlink(temporary.c_str());
+        }
+        return false;
+    }
+    ::close(fd);
+
+    unmap(site);
+    ::close(site.fd);
+    return load(site);
+
+}   // end of retainSite()
@@ -0,0 +1,125 @@
+#ifndef WSMSERIESSTORE_H_INCLUDE
+#define WSMSERIESSTORE_H_INCLUDE
+/***************************************************************************************************/
+// WSMSeriesStore.h
+//  Columnar history of every site's events, in place of the sheet that cleanUpSheet() cuts back to
+//  its last 2000 rows.  A directory holds one file per site (<site>.wsms), a run of segments
+//  (WSMSeriesSegment.h) that is only ever appended to, and each file is memory mapped:
+//
+//      WSMSeriesStore store;
+//      store.open("history");
+//      store.append(site, row);                        // rows of the sheet's columns
+//      ...
+//      store.scanRows(site, from, to, [](const WSMDataRow &row) { ... });
+//
+//  A site's rows are kept in memory until SERIES_SEGMENT_ROWS have arrived, then sorted by etime
+//  and written as a segment; flush() and close() write what there is.  Scans find the segments
+//  and then the blocks of a time range from their headers and sparse indexes and decode only
+//  those, from the mapped file, then the rows not yet written.  A row that arrives after later
+//  ones have been written is kept in its own segment and comes out of scans with it.
+//
+//  retain() is the retention: the event segments of a site that end before a cutoff are replaced by
+//  hourly rollups (WSMRollup.h) of their events, merged with the rollups already kept, so old
+//  history shrinks to pump cycles, run times and TRH ranges per hour instead of being deleted.
+//  The site's file is rewritten beside it and renamed over it.
+//
+//  One thread uses a store at a time.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMSeriesSegment.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct WSMSeriesStats {
+    uint64_t sites = 0;
+    uint64_t eventSegments = 0;
+    uint64_t rollupSegments = 0;
+    uint64_t events = 0;            // written, and waiting to be
+    uint64_t rollups = 0;
+    uint64_t bytes = 0;             // of the files
+};
+
+class WSMSeriesStore {
+    public:
+        // a block of events, and the rows of it in the range scanned
+        typedef std::function<void(const WSMSeriesBlock &block, unsigned int begin, unsigned int end)> BlockScan;
+        typedef std::function<void(const WSMDataRow &row)> RowScan;
+        typedef std::function<void(const WSMRollup &rollup)> RollupScan;
+
+        WSMSeriesStore();
+        ~WSMSeriesStore();
+
+        // open the store in directory, creating it if need be, and map its sites' files.  A segment
+        //  cut short at the end of a file (a crash while it was written) is cut off.  sync false
+        //  leaves out the fdatasync() after each segment.
+        bool open(const char *directory, bool sync = true);
+
+        // write the rows waiting, then unmap and close the files
+        void close();
+
+        // add a row of site; false if its file can't be written
+        bool append(std::string_view site, const WSMDataRow &row);
+
+        // write every site's waiting rows as segments
+        bool flush();
+
+        // the sites, as their files are named
+        std::vector<std::string> sites() const;
+
+        // the events of site with from <= etime < to, a block at a time; returns the rows
+        uint64_t scan(std::string_view site, int64_t from, int64_t to, const BlockScan &scan) const;
+        uint64_t scanRows(std::string_view site, int64_t from, int64_t to, const RowScan &scan) const;
+
+        // the rollups of site starting from <= start < to
+        uint64_t scanRollups(std::string_view site, int64_t from, int64_t to, const RollupScan &scan) const;
+
+        // roll every site's event segments that end before cutoff up into hourly rollups
+        bool retain(int64_t cutoff);
+
+        WSMSeriesStats stats() const;
+
+        // the name of site's file, less ".wsms": letters, digits, '-' and '_' are kept
+        static std::string fileName(std::string_view site);
+
+    private:
+        struct Segment {
+            size_t offset;
+            WSMSegmentKind kind;
+            int64_t firstEtime;
+            int64_t lastEtime;
+            uint32_t rows;
+        };
+
+        struct Site {
+            std::string path;
+            int fd = -1;
+            const uint8_t *map = nullptr;
+            size_t size = 0;                // of the file, all whole segments
+            std::vector<Segment> segments;
+            std::vector<WSMDataRow> waiting;
+        };
+
+        Site *find(std::string_view site) const;
+        bool openSite(const std::string &name);
+        bool load(Site &site);
+        bool remap(Site &site);
+        void unmap(Site &site);
+        bool writeSegments(Site &site, const std::vector<uint8_t> &bytes);
+        bool seal(Site &site);
+        bool retainSite(Site &site, int64_t cutoff);
+
+        std::string _directory;
+        bool _sync;
+        std::map<std::string, std::unique_ptr<Site>> _sites;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,202 @@
+/***************************************************************************************************/
+// FirmwareSimulator.cpp
+//  Discrete event simulator for the whole WellSystemMonitor sketch.  See FirmwareSimulator.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "FirmwareSimulator.h"
+#include "WSMEventJournal.h"
+#include "WSMPublishBatcher.h"
+#include "WSMWebhook.h"
+#include "application.h"
+
+#include <algorithm>
+#include <cmath>
+
+// from the sketch
+void setup();
+void loop();
+extern WSMPublishBatcher batcher;
+extern WSMEventJournal journal;
+
+namespace {
+
+    // these must match WellSystemMonitor.ino
+    const uint16_t WELL_PUMP_SENSOR_PIN = A0;
+    const uint16_t PRESSURE_PUMP_SENSOR_PIN = A1;
+    const uint16_t BUTTON_PIN = D4;
+    const uint16_t HT_SWITCH_PIN = D1;
+    const uint64_t PUMP_DEBOUNCE_MS = 1000;
+    const uint64_t BUTTON_DEBOUNCE_MS = 100;
+    const uint64_t HT_SWITCH_DEBOUNCE_MS = 50;
+    const uint64_t PARTICLE_DHT_PUBLISH_INTERVAL = 1800000;
+
+    // the polled inputs (WSMDebouncer) need the pin stable for more than the debounce delay and
+    // the pump sensors (WSMEdgeCapture) for the delay itself, so wake just after it, twice to be sure
+    const uint64_t DEBOUNCE_WAKES = 2;
+
+    // a TRH publication the sketch missed (see above) is retried this many times, 1 ms apart
+    const unsigned int TRH_RETRIES = 4;
+
+    const double TWO_PI = 6.283185307179586;
+
+    uint64_t debounceDelay(uint16_t pin) {
+        if(pin == WELL_PUMP_SENSOR_PIN || pin == PRESSURE_PUMP_SENSOR_PIN) {
+            return PUMP_DEBOUNCE_MS;
+        } else if(pin == BUTTON_PIN) {
+            return BUTTON_DEBOUNCE_MS;
+        } else if(pin == HT_SWITCH_PIN) {
+            return HT_SWITCH_DEBOUNCE_MS;
+        }
+        return 0;
+    }
+
+}   // namespace
+
+FirmwareSimulator::FirmwareSimulator(const SimulatorConfig &config)
+    : _config(config), _pumps(config.pumps), _scriptIndex(0), _nextTRHMs(0), _loops(0), _edges(0),
+      _publishes(0), _rejected(0), _hour(0), _hourPublishes(0), _peakHourPublishes(0), _publishBytes(0),
+      _events(0), _eventsDropped(0) {
+    std::stable_sort(_config.script.begin(), _config.script.end(),
+                     [](const ScriptedPinChange &a, const ScriptedPinChange &b) { return a.uptimeMs < b.uptimeMs; });
+}
+
+void FirmwareSimulator::wakeAt(uint64_t uptimeMs) {
+    _wakes.push(uptimeMs);
+}
+
+void FirmwareSimulator::pinChanged(uint64_t uptimeMs, uint16_t pin, uint8_t level) {
+    ParticleHost::schedulePin(uptimeMs, pin, level);    // an interrupt sees the edge at its own time
+    _edges++;
+    wakeAt(uptimeMs);
+    for(uint64_t i = 1; i <= DEBOUNCE_WAKES; i++) {
+        wakeAt(uptimeMs + debounceDelay(pin) + i);
+    }
+}
+
+// set the pins for every pump and scripted edge up to and including nowMs
+void FirmwareSimulator::applyEdgesDue(uint64_t nowMs) {
+    while(_pumps.peekTime() <= nowMs) {
+        RelayEdge edge = _pumps.next();
+        uint16_t pin = edge.pump == PRESSURE_PUMP ? PRESSURE_PUMP_SENSOR_PIN : WELL_PUMP_SENSOR_PIN;
+        pinChanged(edge.uptimeMs, pin, edge.on ? LOW : HIGH);   // the relay contact pulls the input low
+    }
+    while(_scriptIndex < _config.script.size() && _config.script[_scriptIndex].uptimeMs <= nowMs) {
+        const ScriptedPinChange &change = _config.script[_scriptIndex++];
+        pinChanged(change.uptimeMs, change.pin, change.level);
+    }
+}
+
+void FirmwareSimulator::run(ParticleHost::PublishSink sink) {
+    const uint64_t startUnixTime = _config.pumps.startUnixTime;
+    const float utcOffsetHours = _config.pumps.utcOffsetHours;
+
+    ParticleHost::reset();
+    ParticleHost::setPublishCapture(false);
+    ParticleHost::setUnixTime((time_t)startUnixTime);
+    ParticleHost::setMillisOffset(_config.millisOffset);
+
+    // DHT11 readings follow the season and the time of day
+    ParticleHost::setDHTModel([startUnixTime, utcOffsetHours](float &celsius, float &humidity, int &status) {
+        double localDays = ((double)startUnixTime + ParticleHost::uptimeMillis() / 1000.0 + utcOffsetHours * 3600.0) / 86400.0;
+        double season = -std::cos(TWO_PI * (std::fmod(localDays, 365.2425) - 15.0) / 365.2425);   // -1 Jan, +1 Jul
+        double daily = -std::cos(TWO_PI * (localDays - std::floor(localDays) - 0.125));          // warmest mid afternoon
+        celsius = (float)(13.0 + 9.0 * season + 4.0 * daily);
+        humidity = (float)(std::min(95.0, std::max(15.0, 65.0 - 15.0 * season - 10.0 * daily)));
+        status = 0;
+    });
+
+    ParticleHost::setPublishRateLimit(_config.publishRateLimit);
+    _publishes = 0;
+    _hour = 0;
+    _hourPublishes = 0;
+    _peakHourPublishes = 0;
+    _publishBytes = 0;
+    ParticleHost::setPublishSink([this, sink](const ParticleHost::PublishRecord &record) {
+        _publishes++;
+        _publishBytes += record.data.size();
+        uint64_t hour = record.uptimeMs / 3600000;
+        _hourPublishes = hour == _hour ? _hourPublishes + 1 : 1;
+        _hour = hour;
+        _peakHourPublishes = std::max(_peakHourPublishes, _hourPublishes);
+
+        expandBatch(record, [this, &sink](const ParticleHost::PublishRecord &event) {
+            if(event.name == "wsmEventTRH") {
+                _nextTRHMs = event.uptimeMs + PARTICLE_DHT_PUBLISH_INTERVAL;
+                wakeAt(_nextTRHMs);
+            }
+            if(sink) {
+                sink(event);
+            }
+        });
+    });
+
+    setup();
+
+    const uint64_t endMs = _config.durationMs;
+    uint64_t nowMs = ParticleHost::uptimeMillis();
+    uint64_t nextDHTMs = _config.dhtPeriodMs ? nowMs : UINT64_MAX;
+    unsigned int trhRetries = 0;
+    _nextTRHMs = nowMs;     // the first pass publishes the restart and the first TRH
+    wakeAt(nowMs);
+
+    while(nowMs < endMs) {
+        if(_config.exactLoopMs == 0) {
+            // jump to the next wake, edge or DHT sample
+            uint64_t next = std::min(_pumps.peekTime(), nextDHTMs);
+            if(!_wakes.empty()) {
+                next = std::min(next, _wakes.top());
+            }
+            if(_scriptIndex < _config.script.size()) {
+                next = std::min(next, _config.script[_scriptIndex].uptimeMs);
+            }
+            nowMs = std::max(next, nowMs);
+            if(nowMs >= endMs) {
+                break;
+            }
+        }
+        ParticleHost::advanceTo(nowMs);
+        applyEdgesDue(nowMs);
+        while(!_wakes.empty() && _wakes.top() <= nowMs) {
+            _wakes.pop();
+        }
+        if(nowMs >= nextDHTMs) {
+            // one pass starts the reading, the next one collects it
+            wakeAt(nowMs + 1);
+            nextDHTMs = nowMs + _config.dhtPeriodMs;
+        }
+
+        loop();
+        _loops++;
+
+        // journaled events are handed to the batcher as fast as the drain rate allows
+        if(journal.unsent() > 0 && Particle.connected()) {
+            wakeAt(nowMs + std::max<uint64_t>(1, journal.msUntilNext()));
+        }
+
+        // batched events are published once they are old enough (or on a retry)
+        if(batcher.pending()) {
+            wakeAt(nowMs + std::max<uint64_t>(1, batcher.msUntilDue()));
+        }
+
+        // a TRH publication moves _nextTRHMs on; if it did not, look again shortly
+        if(nowMs >= _nextTRHMs && trhRetries < TRH_RETRIES) {
+            trhRetries++;
+            wakeAt(nowMs + 1);
+        } else if(nowMs < _nextTRHMs) {
+            trhRetries = 0;
+        }
+
+        if(_config.exactLoopMs != 0) {
+            nowMs += _config.exactLoopMs;
+        }
+    }
+    ParticleHost::advanceTo(endMs);
+    _rejected = ParticleHost::publishesRejected();
+    _events = batcher.get_events();
+    _eventsDropped = batcher.get_eventsDropped();
+    ParticleHost::setPublishSink(ParticleHost::PublishSink());
+}
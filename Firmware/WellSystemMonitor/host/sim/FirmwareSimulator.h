@@ -0,0 +1,92 @@
+#ifndef FIRMWARESIMULATOR_H_INCLUDE
+#define FIRMWARESIMULATOR_H_INCLUDE
+/***************************************************************************************************/
+// FirmwareSimulator.h
+//  Discrete event simulator for the whole WellSystemMonitor sketch.  Drives setup() and loop()
+//  with simulated A0/A1 relay contacts (from a PumpModel), scripted D4 button and D1 toggle
+//  changes and simulated DHT11 readings.
+//
+//  Instead of spinning loop() the simulator jumps virtual time straight to the next moment at
+//  which loop() can do something: a contact edge, the end of a debounce window, the half hour TRH
+//  publication or a DHT11 sample.  A year of pump activity runs in well under a second.
+//
+//  The cloud refuses publishes over the Particle limit of one a second (in bursts of four), as the
+//  real one does.  The sink sees the publications as the wsmWriteData script does: each wsmEventBatch
+//  is passed on as the separate events it carries (sim/WSMWebhook.h).
+//
+//  The sketch keeps its state in globals and function statics, so only one simulation can be run
+//  per process.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "PumpModel.h"
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+// a scripted change of an input pin
+struct ScriptedPinChange {
+    uint64_t uptimeMs;
+    uint16_t pin;
+    uint8_t level;
+};
+
+struct SimulatorConfig {
+    PumpModelConfig pumps;                  // pump model; also sets the wall clock start time
+    uint64_t durationMs = 365ULL * 86400000ULL;
+    uint32_t millisOffset = 0;              // millis() at uptime zero; places the 49 day rollover
+    uint32_t dhtPeriodMs = 300000;          // extra DHT11 sample wakes; 0 samples only on other wakes
+    uint32_t exactLoopMs = 0;               // run loop() every exactLoopMs instead; 0 is event driven
+    std::vector<ScriptedPinChange> script;  // button, toggle or other pin changes, in any order
+    bool publishRateLimit = true;           // refuse publishes over the Particle limit
+};
+
+class FirmwareSimulator {
+    public:
+        FirmwareSimulator(const SimulatorConfig &config);
+
+        // run the sketch from reset for config.durationMs; every publication is passed to sink
+        void run(ParticleHost::PublishSink sink);
+
+        uint64_t loopCount() const { return _loops; }
+        uint64_t edgeCount() const { return _edges; }
+
+        // Particle.publish() calls that reached the cloud, before batches are split, and those refused
+        uint64_t publishCount() const { return _publishes; }
+        uint64_t publishesRejected() const { return _rejected; }
+        uint64_t peakPublishesPerHour() const { return _peakHourPublishes; }
+        uint64_t publishedBytes() const { return _publishBytes; }    // event data of those publishes
+
+        // wsmEvent* events the sketch's batcher was given, and those it had to drop
+        uint64_t eventCount() const { return _events; }
+        uint64_t eventsDropped() const { return _eventsDropped; }
+
+    private:
+        void wakeAt(uint64_t uptimeMs);
+        void applyEdgesDue(uint64_t nowMs);
+        void pinChanged(uint64_t uptimeMs, uint16_t pin, uint8_t level);
+
+        SimulatorConfig _config;
+        PumpModel _pumps;
+        std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> _wakes;
+        size_t _scriptIndex;
+        uint64_t _nextTRHMs;        // when the sketch should next publish wsmEventTRH
+        uint64_t _loops;
+        uint64_t _edges;
+        uint64_t _publishes;
+        uint64_t _rejected;
+        uint64_t _hour;             // uptime hour of the last publish
+        uint64_t _hourPublishes;    // publishes in that hour
+        uint64_t _peakHourPublishes;
+        uint64_t _publishBytes;
+        uint64_t _events;
+        uint64_t _eventsDropped;
+};
+
+#endif  // end of header duplication prevention
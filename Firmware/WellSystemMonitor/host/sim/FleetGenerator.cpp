@@ -0,0 +1,292 @@
+/***************************************************************************************************/
+// FleetGenerator.cpp
+//  See FleetGenerator.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "FleetGenerator.h"
+#include "JSONWriter.h"
+#include "ParticleHost.h"
+#include "WSMAlertProcessor.h"
+#include "WSMEventPack.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <thread>
+#include <utility>
+
+namespace {
+
+    const uint64_t HALF_HOUR_MS = 1800000;      // PARTICLE_DHT_PUBLISH_INTERVAL and ALERT_TICK_INTERVAL
+    const double TWO_PI = 6.283185307179586;
+    const double DAYS_PER_YEAR = 365.25;
+
+    // the site's limits and rules, as the sketch sets them up (WellSystemMonitor.ino)
+    struct FleetSiteLimits : WSMAlertLimits {
+        FleetSiteLimits() {
+            deviationSigmas = 4.0;          // DEVIATION_ALERT_SIGMAS
+            ppCycles10Minutes = 6;          // PP_SHORT_CYCLE_10_MINUTES
+            ppCyclesHour = 24;              // PP_SHORT_CYCLE_HOUR
+        }
+    };
+    const WSMAlertRule WP_FREEZE = {"wsmAlertWPFreeze", ALERT_ON_WP_ON, MEASURE_TEMPERATURE, ALERT_AT_MOST, 32.0, 48,
+                                    ALERT_OWN_HOLDOFF, 0, 1, "WP came on at ", " degrees F."};
+
+    const float TIME_ZONES[] = {-5.0, -6.0, -7.0, -8.0, -9.0, -10.0};
+    const PumpFault FAULTS[] = {FAULT_WATERLOGGED_TANK, FAULT_PP_RUNS_LONG, FAULT_FLOAT_STUCK, FAULT_WP_SHORT_RUN};
+
+    // a virtual device: its well system, its well house and the sketch's handling of both
+    class FleetDevice {
+        public:
+            FleetDevice(uint32_t id, const FleetConfig &config);
+
+            uint32_t id() const { return _id; }
+
+            // ms from the start of the run until its next publication may be due
+            uint64_t nextMs() {
+                return std::min(_nextHalfHourMs, _bootMs + _pumps.peekTime());
+            }
+
+            // publish what is due at nextMs(); alerts go to the thread's publish sink
+            void step(uint64_t startUnixTime, const std::function<void(const char *, const char *)> &emit);
+
+        private:
+            static PumpModelConfig pumpConfig(uint32_t id, const FleetConfig &config, std::mt19937 &rng,
+                                              uint64_t bootMs);
+            float uniform(float low, float high) {
+                return std::uniform_real_distribution<float>(low, high)(_rng);
+            }
+
+            void halfHour(time_t now, const std::function<void(const char *, const char *)> &emit);
+
+            uint32_t _id;
+            std::mt19937 _rng;
+            uint64_t _bootMs;               // of the run, when the device came up
+            PumpModel _pumps;
+            WSMAlertProcessor _alerter;
+            uint64_t _nextHalfHourMs;
+            uint64_t _ppOnMs;               // uptime of the last PP and WP on
+            uint64_t _wpOnMs;
+
+            // the well house, in degrees F and percent, and the drift of the DHT11 reading them
+            float _tempMean;
+            float _tempSeason;              // amplitude over the year, coldest in mid January
+            float _tempDay;                 // amplitude over the day, coldest at 5 am
+            float _rhMean;
+            float _rhDay;                   // against the temperature: highest when it is coldest
+            float _tempDrift;
+            float _rhDrift;
+    };
+
+    FleetDevice::FleetDevice(uint32_t id, const FleetConfig &config)
+        : _id(id),
+          _rng(config.seed * 2654435761u + id),
+          _bootMs(std::uniform_int_distribution<uint64_t>(0, HALF_HOUR_MS - 1)(_rng)),
+          _pumps(pumpConfig(id, config, _rng, _bootMs)),
+          _alerter(FleetSiteLimits()),
+          _nextHalfHourMs(_bootMs + HALF_HOUR_MS),
+          _ppOnMs(0),
+          _wpOnMs(0) {
+        _alerter.addRule(WP_FREEZE);
+        _alerter.begin();
+        _tempMean = uniform(45.0, 70.0);
+        _tempSeason = uniform(8.0, 20.0);
+        _tempDay = uniform(2.0, 6.0);
+        _rhMean = uniform(35.0, 70.0);
+        _rhDay = uniform(4.0, 10.0);
+        _tempDrift = 0.0;
+        _rhDrift = 0.0;
+    }
+
+    // the typical well system, varied for the device
+    PumpModelConfig FleetDevice::pumpConfig(uint32_t id, const FleetConfig &config, std::mt19937 &rng,
+                                            uint64_t bootMs) {
+        std::uniform_real_distribution<float> spread(0.0, 1.0);
+        PumpModelConfig pumps = config.pumps;
+        pumps.startUnixTime = config.startUnixTime + bootMs / 1000;
+        pumps.utcOffsetHours = TIME_ZONES[id % (sizeof(TIME_ZONES) / sizeof(TIME_ZONES[0]))];
+        pumps.ppCyclesPerDay *= 0.5f + spread(rng);
+        pumps.ppRunMinutes *= 0.85f + 0.3f * spread(rng);
+        pumps.wpTriggerMinutes *= 0.85f + 0.3f * spread(rng);
+        pumps.wpRunMinutes *= 0.9f + 0.2f * spread(rng);
+        pumps.seed = rng();
+        if(spread(rng) < config.faultFraction) {
+            pumps.fault = FAULTS[rng() % (sizeof(FAULTS) / sizeof(FAULTS[0]))];
+            pumps.faultStartMs = (uint64_t)(spread(rng) * config.durationMs);
+        }
+        return pumps;
+    }
+
+    void FleetDevice::step(uint64_t startUnixTime, const std::function<void(const char *, const char *)> &emit) {
+        uint64_t edgeMs = _bootMs + _pumps.peekTime();
+        uint64_t nowMs = std::min(_nextHalfHourMs, edgeMs);
+        time_t now = (time_t)(startUnixTime + nowMs / 1000);
+        ParticleHost::setThreadUnixTime(now);
+        if(_nextHalfHourMs <= edgeMs) {
+            halfHour(now, emit);
+            _nextHalfHourMs += HALF_HOUR_MS;
+            return;
+        }
+
+        // publishPPchange() and publishWPchange(): the alert processor first, then the journal
+        RelayEdge edge = _pumps.next();
+        WSMJournalRecord record = {0, false, (uint32_t)now, 0.0, 0.0};
+        unsigned int alertCount = _alerter.get_alertCount();
+        if(edge.pump == PRESSURE_PUMP && edge.on) {
+            _ppOnMs = edge.uptimeMs;
+            record.kind = JOURNAL_PP_ON;
+            _alerter.ppTurnedOn();
+        } else if(edge.pump == PRESSURE_PUMP) {
+            record.kind = JOURNAL_PP_OFF;
+            record.value1 = (float)(edge.uptimeMs - _ppOnMs) / 60000.0;
+            _alerter.ppTurnedOff(record.value1);
+        } else if(edge.on) {
+            _wpOnMs = edge.uptimeMs;
+            record.kind = JOURNAL_WP_ON;
+            _alerter.wpTurnedOn();
+        } else {
+            record.kind = JOURNAL_WP_OFF;
+            record.value1 = (float)(edge.uptimeMs - _wpOnMs) / 60000;
+            _alerter.wpTurnedOff(record.value1);
+        }
+        record.alert = _alerter.get_alertCount() != alertCount;
+
+        char json[JSON_EVENT_SIZE];
+        emit(WSMEventPack::eventJSON(record, _pumps.config().utcOffsetHours, json, sizeof(json)), json);
+
+    }   // end of step()
+
+    // publishTRHTask() with the smoothed readings, then alertTimeTick(), which share a period
+    void FleetDevice::halfHour(time_t now, const std::function<void(const char *, const char *)> &emit) {
+        double localDays = (now + _pumps.config().utcOffsetHours * 3600.0) / 86400.0;
+        double hour = (localDays - std::floor(localDays)) * 24.0;
+        double season = -std::cos(TWO_PI * (std::fmod(localDays, DAYS_PER_YEAR) - 15.0) / DAYS_PER_YEAR);
+        double day = -std::cos(TWO_PI * (hour - 5.0) / 24.0);
+
+        // the DHT11 drifts slowly about its calibration; the ten point average leaves some noise
+        std::normal_distribution<float> step(0.0, 1.0);
+        _tempDrift = 0.995f * _tempDrift + 0.1f * step(_rng);
+        _rhDrift = 0.995f * _rhDrift + 0.3f * step(_rng);
+        float temp = _tempMean + _tempSeason * (float)season + _tempDay * (float)day + _tempDrift + uniform(-0.3, 0.3);
+        float rh = _rhMean - _rhDay * (float)day + _rhDrift + uniform(-0.5, 0.5);
+        rh = std::min(std::max(rh, 5.0f), 95.0f);
+        _alerter.temperatureReading(temp);
+
+        WSMJournalRecord record = {JOURNAL_TRH, false, (uint32_t)now, temp, rh};
+        char json[JSON_EVENT_SIZE];
+        emit(WSMEventPack::eventJSON(record, _pumps.config().utcOffsetHours, json, sizeof(json)), json);
+
+        _alerter.halfHourTimeTick();
+    }
+
+}   // namespace
+
+void FleetStats::merge(const FleetStats &other) {
+    devices += other.devices;
+    trh += other.trh;
+    ppEvents += other.ppEvents;
+    wpEvents += other.wpEvents;
+    alerts += other.alerts;
+    bytes += other.bytes;
+    maxLagMs = std::max(maxLagMs, other.maxLagMs);
+    seconds = std::max(seconds, other.seconds);
+}
+
+FleetGenerator::FleetGenerator(const FleetConfig &config) : _config(config) {
+    _numThreads = config.threads > 0 ? config.threads : (int)std::thread::hardware_concurrency();
+    _numThreads = std::max(1, std::min(_numThreads, (int)std::max(config.devices, 1u)));
+}
+
+FleetStats FleetGenerator::run(const FleetSink &sink, const FleetIdle &idle) {
+    _threadStats.assign(_numThreads, FleetStats());
+    std::vector<std::thread> threads;
+    for(int t = 0; t < _numThreads; t++) {
+        threads.emplace_back(&FleetGenerator::work, this, t, std::cref(sink), std::cref(idle));
+    }
+    FleetStats total;
+    for(int t = 0; t < _numThreads; t++) {
+        threads[t].join();
+        total.merge(_threadStats[t]);
+    }
+    return total;
+}
+
+// run devices thread, thread + threads, ... in time order
+void FleetGenerator::work(int thread, const FleetSink &sink, const FleetIdle &idle) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point started = Clock::now();
+    FleetStats stats;
+
+    std::vector<FleetDevice> devices;
+    devices.reserve(_config.devices / _numThreads + 1);
+    for(uint32_t id = thread; id < _config.devices; id += _numThreads) {
+        devices.emplace_back(id, _config);
+    }
+    stats.devices = devices.size();
+
+    // the device being stepped, and what it publishes
+    FleetDevice *current = nullptr;
+    auto publish = [&](const char *name, const char *data, bool alert) {
+        if(alert) {
+            stats.alerts++;
+        } else if(strcmp(name, "wsmEventTRH") == 0) {
+            stats.trh++;
+        } else if(strcmp(name, "wsmEventPPstatus") == 0) {
+            stats.ppEvents++;
+        } else {
+            stats.wpEvents++;
+        }
+        stats.bytes += strlen(name) + strlen(data);
+        if(sink) {
+            sink(thread, FleetPublication{current->id(), (uint32_t)Time.now(), name, data, alert});
+        }
+    };
+    ParticleHost::setThreadPublishSink([&](const ParticleHost::PublishRecord &record) {
+        publish(record.name.c_str(), record.data.c_str(), true);
+    });
+    std::function<void(const char *, const char *)> emit = [&](const char *name, const char *data) {
+        publish(name, data, false);
+    };
+
+    typedef std::pair<uint64_t, uint32_t> Due;     // ms of the run, index in devices
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> due;
+    for(uint32_t i = 0; i < devices.size(); i++) {
+        due.push(Due(devices[i].nextMs(), i));
+    }
+    while(!due.empty() && due.top().first < _config.durationMs) {
+        Due next = due.top();
+        due.pop();
+        if(_config.speed > 0.0) {
+            Clock::time_point at = started + std::chrono::duration_cast<Clock::duration>(
+                                                 std::chrono::duration<double>(next.first / 1000.0 / _config.speed));
+            Clock::time_point now = Clock::now();
+            if(at > now) {
+                if(idle) {
+                    idle(thread);
+                }
+                std::this_thread::sleep_until(at);
+            } else {
+                stats.maxLagMs = std::max(stats.maxLagMs, std::chrono::duration<double, std::milli>(now - at).count());
+            }
+        }
+        current = &devices[next.second];
+        current->step(_config.startUnixTime, emit);
+        due.push(Due(current->nextMs(), next.second));
+    }
+    if(idle) {
+        idle(thread);
+    }
+
+    ParticleHost::setThreadPublishSink(ParticleHost::PublishSink());
+    ParticleHost::setThreadUnixTime(0);
+    stats.seconds = std::chrono::duration<double>(Clock::now() - started).count();
+    _threadStats[thread] = stats;
+
+}   // end of work()
@@ -0,0 +1,95 @@
+#ifndef FLEETGENERATOR_H_INCLUDE
+#define FLEETGENERATOR_H_INCLUDE
+/***************************************************************************************************/
+// FleetGenerator.h
+//  Traffic of a fleet of WSM devices, for sizing an ingest or alerting service.  Each virtual device
+//  has its own well system (a PumpModel, with its own demand, run times and time zone), its own
+//  well house temperature and humidity with DHT11 drift, and its own WSMAlertProcessor with the
+//  sketch's limits and site rules.  It publishes what the sketch publishes, in the same formats:
+//
+//  - wsmEventTRH every half hour from boot, as publishTRH() journals it, then the alert tick
+//  - wsmEventPPstatus and wsmEventWPstatus on each relay change, as publishPPchange() and
+//    publishWPchange() journal them, after any alert the change raised
+//  - wsmAlert*, built and published by the alert processor itself
+//
+//  The events are published one by one, as they would reach the webhook without batching
+//  (WSMEventPack::eventJSON()).  The devices come up over the first half hour of the run; a
+//  fraction of them can develop a pump fault part way through, to raise alerts.
+//
+//  The devices are shared out over the threads (device d runs on thread d % threads) and each
+//  thread runs its own in time order, with nothing shared between the threads but the counters
+//  summed at the end, so the events per second grow with the cores.  A device's publications do
+//  not depend on the number of threads.  At a speed the threads publish each event when it is
+//  due, speed times faster than real time; at speed 0 as fast as they can.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "PumpModel.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+struct FleetConfig {
+    unsigned int devices = 1000;
+    int threads = 0;                        // 0 uses every core
+    uint64_t startUnixTime = 1704067200;    // wall clock time at the start of the run
+    uint64_t durationMs = 86400000;         // virtual time the fleet runs for
+    double speed = 0.0;                     // virtual seconds per second; 1 is real time, 0 as fast as possible
+    PumpModelConfig pumps;                  // the typical well system; each device varies it
+    float faultFraction = 0.0;              // devices that develop a pump fault during the run
+    uint32_t seed = 1;
+};
+
+// a publication of a device
+struct FleetPublication {
+    uint32_t device;        // 0 .. devices - 1
+    uint32_t etime;         // Time.now() when it was published
+    const char *name;       // the event name
+    const char *data;       // the event data; both valid during the call only
+    bool alert;             // a wsmAlert*
+};
+
+// called on the thread that runs the device, for each of its publications in order
+typedef std::function<void(int thread, const FleetPublication &publication)> FleetSink;
+
+// called when a thread is about to wait for its next event to be due, to flush what it has
+typedef std::function<void(int thread)> FleetIdle;
+
+struct FleetStats {
+    uint64_t devices = 0;
+    uint64_t trh = 0;               // wsmEventTRH
+    uint64_t ppEvents = 0;          // wsmEventPPstatus
+    uint64_t wpEvents = 0;          // wsmEventWPstatus
+    uint64_t alerts = 0;            // wsmAlert*
+    uint64_t bytes = 0;             // event names and data
+    double maxLagMs = 0.0;          // at a speed, the latest an event was published after it was due
+    double seconds = 0.0;           // wall time; the longest thread's, when summed
+
+    uint64_t events() const { return trh + ppEvents + wpEvents + alerts; }
+    void merge(const FleetStats &other);
+};
+
+class FleetGenerator {
+    public:
+        explicit FleetGenerator(const FleetConfig &config);
+
+        // run the fleet for config.durationMs of virtual time and return the totals; each thread
+        //  creates and runs its own devices.  sink may be empty to only count the publications.
+        FleetStats run(const FleetSink &sink, const FleetIdle &idle = FleetIdle());
+
+        int numThreads() const { return _numThreads; }
+        const std::vector<FleetStats> &threadStats() const { return _threadStats; }    // of the last run()
+
+    private:
+        void work(int thread, const FleetSink &sink, const FleetIdle &idle);
+
+        FleetConfig _config;
+        int _numThreads;
+        std::vector<FleetStats> _threadStats;
+};
+
+#endif  // end of header duplication prevention
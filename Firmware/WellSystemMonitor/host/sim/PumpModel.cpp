@@ -0,0 +1,153 @@
+/***************************************************************************************************/
+// PumpModel.cpp
+//  Stochastic model of a well system for the host simulators.  See PumpModel.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "PumpModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    const double MS_PER_DAY = 86400000.0;
+    const double DAYS_PER_YEAR = 365.2425;
+    const double TWO_PI = 6.283185307179586;
+    const uint64_t PP_MIN_GAP_MS = 30000;       // the tank pressure switch needs time to reset
+    const uint64_t WP_START_DELAY_MS = 5000;    // float switch to WP relay
+
+    // relative household demand through the day, averaging 1.0
+    const double HOURLY_DEMAND[24] = {
+        0.33, 0.33, 0.33, 0.33, 0.33, 0.33,     // night
+        1.78, 1.78, 1.78,                       // morning
+        1.00, 1.00, 1.00, 1.00, 1.00, 1.00, 1.00, 1.00,     // day
+        1.67, 1.67, 1.67, 1.67,                 // evening
+        0.67, 0.67, 0.67                        // late evening
+    };
+    const double PEAK_HOURLY_DEMAND = 1.78;
+
+    const float WATERLOGGED_RUN_MINUTES = 0.2;
+    const double WATERLOGGED_DEMAND_FACTOR = 8.0;
+    const float LONG_RUN_MINUTES = 3.5;
+    const float WP_SHORT_RUN_MINUTES = 12.0;
+
+}   // namespace
+
+PumpModel::PumpModel(const PumpModelConfig &config)
+    : _config(config), _rng(config.seed), _sequence(0), _ppFreeAt(0), _wpFreeAt(0), _accumulatedPPMinutes(0.0) {
+    _wpTrigger = positiveNormal(_config.wpTriggerMinutes, _config.wpTriggerSigma, 1.0);
+    double seasonalMean = 1.0 + _config.summerDemandBoost / 2.0;
+    double peakFactor = PEAK_HOURLY_DEMAND * (1.0 + _config.summerDemandBoost) / seasonalMean;
+    if(_config.fault == FAULT_WATERLOGGED_TANK) {
+        peakFactor *= WATERLOGGED_DEMAND_FACTOR;
+    }
+    _peakRatePerMs = _config.ppCyclesPerDay * peakFactor / MS_PER_DAY;
+}
+
+RelayEdge PumpModel::next() {
+    peekTime();
+    RelayEdge edge = _edges.top().edge;
+    _edges.pop();
+    return edge;
+}
+
+// a new PP run can not start before _ppFreeAt, so any queued edge before then is final
+uint64_t PumpModel::peekTime() {
+    while(_edges.empty() || _edges.top().edge.uptimeMs >= _ppFreeAt) {
+        scheduleNextPPRun();
+    }
+    return _edges.top().edge.uptimeMs;
+}
+
+bool PumpModel::faultActive(uint64_t uptimeMs) const {
+    return _config.fault != FAULT_NONE && uptimeMs >= _config.faultStartMs;
+}
+
+// demand rate (PP cycles per ms) at a given uptime, from the local time of day and season
+double PumpModel::demandRatePerMs(uint64_t uptimeMs) const {
+    double localSeconds = (double)_config.startUnixTime + uptimeMs / 1000.0 + _config.utcOffsetHours * 3600.0;
+    double days = localSeconds / 86400.0;
+    int hour = (int)((days - std::floor(days)) * 24.0);
+    double dayOfYear = std::fmod(days, DAYS_PER_YEAR);
+    double season = 0.5 * (1.0 - std::cos(TWO_PI * (dayOfYear - 15.0) / DAYS_PER_YEAR));  // 0 mid Jan, 1 mid Jul
+    double seasonal = (1.0 + _config.summerDemandBoost * season) / (1.0 + _config.summerDemandBoost / 2.0);
+
+    double rate = _config.ppCyclesPerDay * HOURLY_DEMAND[std::min(std::max(hour, 0), 23)] * seasonal / MS_PER_DAY;
+    if(faultActive(uptimeMs) && _config.fault == FAULT_WATERLOGGED_TANK) {
+        rate *= WATERLOGGED_DEMAND_FACTOR;
+    }
+    return rate;
+}
+
+float PumpModel::positiveNormal(float mean, float sigma, float minimum) {
+    std::normal_distribution<float> distribution(mean, sigma);
+    return std::max(distribution(_rng), minimum);
+}
+
+// draw the next PP run from the demand process (Poisson, by thinning) and any WP run it triggers
+void PumpModel::scheduleNextPPRun() {
+    std::exponential_distribution<double> interval(_peakRatePerMs);
+    std::uniform_real_distribution<double> accept(0.0, 1.0);
+
+    double t = (double)_ppFreeAt;
+    do {
+        t += interval(_rng);
+    } while(accept(_rng) * _peakRatePerMs > demandRatePerMs((uint64_t)t));
+    uint64_t start = (uint64_t)t;
+
+    float runMinutes;
+    if(faultActive(start) && _config.fault == FAULT_WATERLOGGED_TANK) {
+        runMinutes = positiveNormal(WATERLOGGED_RUN_MINUTES, 0.05, 0.05);
+    } else if(faultActive(start) && _config.fault == FAULT_PP_RUNS_LONG) {
+        runMinutes = positiveNormal(LONG_RUN_MINUTES, 0.3, 0.1);
+    } else {
+        runMinutes = positiveNormal(_config.ppRunMinutes, _config.ppRunSigma, 0.1);
+    }
+    uint64_t end = start + (uint64_t)(runMinutes * 60000.0);
+    addEdge(start, PRESSURE_PUMP, true);
+    addEdge(end, PRESSURE_PUMP, false);
+    _ppFreeAt = end + PP_MIN_GAP_MS;
+
+    // the reservoir float starts the WP once the PP has emptied it
+    _accumulatedPPMinutes += runMinutes;
+    if(_accumulatedPPMinutes >= _wpTrigger && end >= _wpFreeAt &&
+       !(faultActive(end) && _config.fault == FAULT_FLOAT_STUCK)) {
+        float wpMinutes;
+        if(faultActive(end) && _config.fault == FAULT_WP_SHORT_RUN) {
+            wpMinutes = positiveNormal(WP_SHORT_RUN_MINUTES, 2.0, 1.0);
+        } else {
+            wpMinutes = positiveNormal(_config.wpRunMinutes, _config.wpRunSigma, 1.0);
+        }
+        uint64_t wpStart = end + WP_START_DELAY_MS;
+        _wpFreeAt = wpStart + (uint64_t)(wpMinutes * 60000.0);
+        addEdge(wpStart, WELL_PUMP, true);
+        addEdge(_wpFreeAt, WELL_PUMP, false);
+        _accumulatedPPMinutes = 0.0;
+        _wpTrigger = positiveNormal(_config.wpTriggerMinutes, _config.wpTriggerSigma, 1.0);
+    }
+}
+
+// queue a contact change, preceded by contact bounce if configured
+void PumpModel::addEdge(uint64_t uptimeMs, PumpId pump, bool on) {
+    if(_config.bounceMs > 0 && _config.bounceEdges > 0) {
+        std::uniform_int_distribution<uint32_t> offset(1, _config.bounceMs > 1 ? _config.bounceMs - 1 : 1);
+        std::vector<uint32_t> offsets;
+        for(unsigned int i = 0; i < (_config.bounceEdges & ~1u); i++) {
+            offsets.push_back(offset(_rng));
+        }
+        std::sort(offsets.begin(), offsets.end());
+        _edges.push(QueuedEdge{RelayEdge{uptimeMs, pump, on}, _sequence++});
+        bool level = on;
+        for(uint32_t o : offsets) {
+            level = !level;
+            _edges.push(QueuedEdge{RelayEdge{uptimeMs + o, pump, level}, _sequence++});
+        }
+        _edges.push(QueuedEdge{RelayEdge{uptimeMs + _config.bounceMs, pump, on}, _sequence++});
+    } else {
+        _edges.push(QueuedEdge{RelayEdge{uptimeMs, pump, on}, _sequence++});
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef PUMPMODEL_H_INCLUDE
+#define PUMPMODEL_H_INCLUDE
+/***************************************************************************************************/
+// PumpModel.h
+//  Stochastic model of a well system for the host simulators.  Produces the relay contact edges
+//  seen on the WSM sensor inputs, in time order:
+//
+//  - Pressure Pump (PP): household demand draws down the pressure tank; each drawdown runs the PP
+//    for about a minute and a half.  Demand follows the time of day and the season.
+//  - Well Pump (WP): the PP empties the reservoir; once enough PP run time has accumulated the
+//    float sensor starts the WP, which refills the reservoir in about half an hour.
+//
+//  Faults can be switched on part way through a run to provoke the WSM alerts.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <vector>
+
+// which pump a relay edge belongs to
+enum PumpId {
+    PRESSURE_PUMP = 0,
+    WELL_PUMP = 1
+};
+
+// well system faults
+enum PumpFault {
+    FAULT_NONE,
+    FAULT_WATERLOGGED_TANK,     // bladder failure: PP short cycles many times an hour
+    FAULT_PP_RUNS_LONG,         // leak or weak pump: PP runs for several minutes
+    FAULT_FLOAT_STUCK,          // reservoir float stuck: WP never comes on
+    FAULT_WP_SHORT_RUN          // WP shuts off early
+};
+
+struct PumpModelConfig {
+    uint64_t startUnixTime = 1704067200;    // wall clock time at uptime zero (2024-01-01 UTC)
+    float utcOffsetHours = -8.0;            // local time of the site, for the daily demand cycle
+    float ppCyclesPerDay = 24.0;            // average PP cycles per day over the year
+    float summerDemandBoost = 0.5;          // extra demand at mid summer (0.5 = +50%)
+    float ppRunMinutes = 1.4;               // mean PP run time
+    float ppRunSigma = 0.15;
+    float wpTriggerMinutes = 20.0;          // accumulated PP minutes that empty the reservoir
+    float wpTriggerSigma = 2.0;
+    float wpRunMinutes = 28.0;              // mean WP run time
+    float wpRunSigma = 2.0;
+    uint32_t bounceMs = 0;                  // relay contact bounce window; 0 for clean edges
+    unsigned int bounceEdges = 4;           // extra edges within the bounce window
+    PumpFault fault = FAULT_NONE;
+    uint64_t faultStartMs = 0;              // uptime at which the fault begins
+    uint32_t seed = 1;
+};
+
+// one change of a relay contact
+struct RelayEdge {
+    uint64_t uptimeMs;      // when the contact changes
+    PumpId pump;
+    bool on;                // contact closed (pump running)
+};
+
+class PumpModel {
+    public:
+        PumpModel(const PumpModelConfig &config);
+
+        // next relay edge in time order; the model is unbounded so this always succeeds
+        RelayEdge next();
+
+        // time of the next edge without consuming it
+        uint64_t peekTime();
+
+        const PumpModelConfig &config() const { return _config; }
+
+    private:
+        // queued edges keep their insertion order when they fall on the same millisecond
+        struct QueuedEdge {
+            RelayEdge edge;
+            uint64_t sequence;
+        };
+        struct EdgeLater {
+            bool operator()(const QueuedEdge &a, const QueuedEdge &b) const {
+                if(a.edge.uptimeMs != b.edge.uptimeMs) {
+                    return a.edge.uptimeMs > b.edge.uptimeMs;
+                }
+                return a.sequence > b.sequence;
+            }
+        };
+
+        void scheduleNextPPRun();
+        void addEdge(uint64_t uptimeMs, PumpId pump, bool on);
+        double demandRatePerMs(uint64_t uptimeMs) const;
+        float positiveNormal(float mean, float sigma, float minimum);
+        bool faultActive(uint64_t uptimeMs) const;
+
+        PumpModelConfig _config;
+        std::mt19937_64 _rng;
+        std::priority_queue<QueuedEdge, std::vector<QueuedEdge>, EdgeLater> _edges;
+        uint64_t _sequence;
+        uint64_t _ppFreeAt;             // uptime when the PP can start again
+        uint64_t _wpFreeAt;             // uptime when the WP has stopped
+        float _accumulatedPPMinutes;    // PP run time since the WP last ran
+        float _wpTrigger;               // accumulated PP minutes that start the next WP run
+        double _peakRatePerMs;          // upper bound of the demand rate, for thinning
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,146 @@
+/***************************************************************************************************/
+// WSMWebhook.cpp
+//  Splits wsmEventBatch publications into their events.  See WSMWebhook.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMWebhook.h"
+#include "WSMEventPack.h"
+#include "WSMPackDecoder.h"
+
+#include <cstdlib>
+#include <cstring>
+
+const char *const WSM_BATCH_EVENT = "wsmEventBatch";
+const char *const WSM_SHEET_HEADER =
+    "Time Stamp,Temperature (F),Humidity (%),Pressure Pump,Well Pump,PP On Time (min),WP On Time (min),Event,"
+    "Publication Time";
+
+namespace {
+
+    const char BATCH_PREFIX[] = "{\"events\":[";
+    const char ITEM_PREFIX[] = "{\"ev\":\"";
+
+    // the end of the flat JSON object starting at data[begin], or npos
+    size_t objectEnd(const std::string &data, size_t begin) {
+        bool inString = false;
+        for(size_t i = begin + 1; i < data.size(); i++) {
+            char c = data[i];
+            if(inString) {
+                if(c == '\\') {
+                    i++;
+                } else if(c == '"') {
+                    inString = false;
+                }
+            } else if(c == '"') {
+                inString = true;
+            } else if(c == '}') {
+                return i;
+            } else if(c == '{' || c == '[') {
+                return std::string::npos;   // the events are flat objects
+            }
+        }
+        return std::string::npos;
+    }
+
+    // the raw text of a value in a flat JSON object, without quotes; empty if the key is missing
+    std::string jsonValue(const std::string &json, const char *key) {
+        std::string pattern = std::string("\"") + key + "\":";
+        size_t pos = json.find(pattern);
+        if(pos == std::string::npos) {
+            return "";
+        }
+        pos += pattern.size();
+        if(pos < json.size() && json[pos] == '"') {
+            size_t end = json.find('"', pos + 1);
+            return json.substr(pos + 1, end == std::string::npos ? std::string::npos : end - pos - 1);
+        }
+        size_t end = json.find_first_of(",}", pos);
+        return json.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    }
+
+    // pass on an event that happened at unixTime, out of a publication made at record's time
+    void passEvent(const ParticleHost::PublishRecord &record, ParticleHost::PublishRecord &event, time_t unixTime,
+                   const ParticleHost::PublishSink &sink) {
+        uint64_t backMs = (uint64_t)(record.unixTime - unixTime) * 1000;
+        event.unixTime = unixTime;
+        event.uptimeMs = backMs <= record.uptimeMs ? record.uptimeMs - backMs : 0;
+        sink(event);
+    }
+
+    size_t expandPack(const ParticleHost::PublishRecord &record, const ParticleHost::PublishSink &sink) {
+        WSMPackDecoder decoder;
+        decoder.decode(record.data.c_str());
+        for(const WSMPackedEvent &packed : decoder.events()) {
+            ParticleHost::PublishRecord event;
+            event.name = packed.name;
+            event.data = packed.data;
+            passEvent(record, event, (time_t)packed.record.etime, sink);
+        }
+        return decoder.events().size();
+    }
+
+}   // namespace
+
+size_t expandBatch(const ParticleHost::PublishRecord &record, const ParticleHost::PublishSink &sink) {
+    if(record.name == EVENT_PACK_NAME) {
+        return expandPack(record, sink);
+    } else if(record.name != WSM_BATCH_EVENT) {
+        sink(record);
+        return 1;
+    }
+
+    const std::string &data = record.data;
+    const size_t prefixLength = sizeof(BATCH_PREFIX) - 1;
+    const size_t itemPrefixLength = sizeof(ITEM_PREFIX) - 1;
+    if(data.compare(0, prefixLength, BATCH_PREFIX) != 0) {
+        return 0;
+    }
+
+    size_t passed = 0;
+    size_t pos = prefixLength;
+    while(pos < data.size() && data[pos] == '{') {
+        size_t end = objectEnd(data, pos);
+        if(end == std::string::npos || data.compare(pos, itemPrefixLength, ITEM_PREFIX) != 0) {
+            break;
+        }
+        size_t nameBegin = pos + itemPrefixLength;
+        size_t nameEnd = data.find('"', nameBegin);
+        if(nameEnd == std::string::npos || nameEnd > end) {
+            break;
+        }
+
+        ParticleHost::PublishRecord event;
+        event.name = data.substr(nameBegin, nameEnd - nameBegin);
+        size_t elements = nameEnd + 1;  // ',' before the event's own elements, or its '}'
+        if(data[elements] == ',') {
+            elements++;
+        }
+        event.data = "{" + data.substr(elements, end + 1 - elements);
+        size_t etime = event.data.find("\"etime\":");
+        time_t unixTime = etime != std::string::npos ? (time_t)strtoll(event.data.c_str() + etime + 8, nullptr, 10)
+                                                     : record.unixTime;
+        passEvent(record, event, unixTime, sink);
+        passed++;
+
+        pos = end + 1;
+        if(pos < data.size() && data[pos] == ',') {
+            pos++;
+        }
+    }
+    return passed;
+}
+
+std::string sheetRow(const ParticleHost::PublishRecord &event) {
+    std::string row = jsonValue(event.data, "etime");
+    const char *const COLUMNS[] = {"temp", "rh", "pp", "wp", "ppon", "wpon"};
+    for(const char *column : COLUMNS) {
+        row += ",";
+        row += jsonValue(event.data, column);
+    }
+    row += "," + event.name + "," + jsonValue(event.data, "loctime");
+    return row;
+}
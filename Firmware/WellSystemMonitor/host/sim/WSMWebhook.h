@@ -0,0 +1,37 @@
+#ifndef WSMWEBHOOK_H_INCLUDE
+#define WSMWEBHOOK_H_INCLUDE
+/***************************************************************************************************/
+// WSMWebhook.h
+//  The cloud side of the wsmEvent* publications, as the Particle webhook and the wsmWriteData
+//  script see them.  A wsmEventBatch publication (src/WSMPublishBatcher.h) or a wsmEventPack
+//  publication (src/WSMEventPack.h) carries several events; expandBatch() turns either back into
+//  the publications the events would have been on their own, so host programs can treat batched,
+//  packed and single events alike.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+
+#include <string>
+
+// the event name the sketch publishes its batches under
+extern const char *const WSM_BATCH_EVENT;
+
+// pass each event in a wsmEventBatch or wsmEventPack to sink as its own publication, in order: the
+// name is the event's "ev" (or its kind), the data is the event's JSON, unixTime is its "etime" and
+// uptimeMs is moved back by the same amount.  Any other publication is passed to sink unchanged.
+// Returns the number of publications passed on; a malformed batch passes on the events before the
+// fault.
+size_t expandBatch(const ParticleHost::PublishRecord &record, const ParticleHost::PublishSink &sink);
+
+// the column titles of the sheet
+extern const char *const WSM_SHEET_HEADER;
+
+// an event as the CSV row wsmWriteData appends to the sheet for it: etime, temp, rh, pp, wp, ppon,
+// wpon, event, local time
+std::string sheetRow(const ParticleHost::PublishRecord &event);
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,14 @@
+/***************************************************************************************************/
+// WSM_Alert_Dev.cpp
+//  Host build wrapper for AlertTester/WSM_Alert_Dev.ino.  Adds the prototypes that the Particle
+//  build would generate and then compiles the unmodified test sketch.
+/***************************************************************************************************/
+#include "application.h"
+
+void setup();
+void loop();
+void executeTestCase(unsigned int testcase);
+void printVar();
+bool buttonPressed();
+
+#include "WSM_Alert_Dev.ino"
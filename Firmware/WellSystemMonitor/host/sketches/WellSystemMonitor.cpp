@@ -0,0 +1,36 @@
+/***************************************************************************************************/
+// WellSystemMonitor.cpp
+//  Host build wrapper for src/WellSystemMonitor.ino.  The Particle build preprocesses a .ino file
+//  by adding prototypes for every function it defines; this file does the same by hand and then
+//  compiles the sketch.  Keep the prototypes in step with the sketch.
+/***************************************************************************************************/
+#include "application.h"
+
+String dateTimeString();
+void reportDeviceRestart();
+void wellPumpEdge();
+void pressurePumpEdge();
+void setup();
+void loop();
+void createSensorJSON(char *json, size_t size);
+int loopProfileQuery(String argument);
+void publishParticleEvent(String message);
+void sampleDHT();
+void publishTRHTask();
+void alertTimeTick();
+void publishPumpStats();
+void writeLoopProfile();
+void bootIndicatorOff();
+void bootIndicatorOn();
+void flashIndicator();
+void nbFlashIndicator(boolean flash);
+system_tick_t diff(system_tick_t _current, system_tick_t _last);
+int startReadDHT(boolean _startRead);
+void moveServo(boolean _switchState);
+void meterDisplay(float _displayValue, int _lowestValue, int _highestValue);
+void publishTRH(float temp, float rh);
+void publishPPchange(int newPPstatus, system_tick_t changeTime);
+void publishWPchange(int newWPstatus, system_tick_t changeTime);
+void drainJournal();
+
+#include "WellSystemMonitor.ino"
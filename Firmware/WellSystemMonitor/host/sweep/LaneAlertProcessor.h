@@ -0,0 +1,188 @@
+#ifndef LANEALERTPROCESSOR_H_INCLUDE
+#define LANEALERTPROCESSOR_H_INCLUDE
+/***************************************************************************************************/
+// LaneAlertProcessor.h
+//  WSMAlertProcessor for LANES limit combinations at once, for the limit sweeps.  The alert
+//  processor state (one float and six counters) is held as a structure of arrays, one array
+//  element per combination, and every event advances all of them with straight line, branch free
+//  loops over the lanes.  The compiler turns each loop into a few vector instructions (SSE2 by
+//  default; AVX2, AVX-512 or NEON with WSM_HOST_NATIVE), so 8 or 16 combinations cost about as
+//  much as one.
+//
+//  The arithmetic is the scalar class's, operation for operation (float compares and one float
+//  add, in the same order), so every lane is bit identical to a WSMAlertProcessor constructed
+//  with the same limits.  Alerts are rare: a lane mask says which lanes alerted on an event and
+//  only those are recorded, without building or publishing the alert strings.
+//
+//  Keep the logic in step with alerts #1 to #7 of WSMAlertProcessor.cpp (the others are not swept);
+//  threshold_sweep_test compares the two.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMAlertProcessor.h"
+
+#include <cstdint>
+
+// which alert a lane raised; the same numbering as SweepAlertType
+enum LaneAlert {
+    LANE_PP_ON_TOO_LONG,
+    LANE_PP_ON_TOO_SHORT,
+    LANE_WP_ON_TOO_LONG,
+    LANE_WP_ON_TOO_SHORT,
+    LANE_WP_NOT_COME_ON,
+    LANE_WP_ON_TOO_SOON,
+    LANE_PP_NOT_RUN
+};
+
+template<int LANES> class LaneAlertProcessor {
+    public:
+        static const int NUM_LANES = LANES;
+
+        // set the limits of one lane; call begin() after setting them all
+        void setLimits(int lane, const WSMAlertLimits &limits) {
+            _ppOnTooShort[lane] = limits.ppOnTooShort;
+            _ppOnTooLong[lane] = limits.ppOnTooLong;
+            _wpOnTooShort[lane] = limits.wpOnTooShort;
+            _wpOnTooLong[lane] = limits.wpOnTooLong;
+            _wpRunTooSoon[lane] = limits.wpRunTooSoon;
+            _wpRunTooLong[lane] = limits.wpRunTooLong;
+            _oneDay[lane] = limits.oneDay;
+            _threeDays[lane] = limits.threeDays;
+        }
+
+        // as WSMAlertProcessor::begin(), in every lane
+        void begin() {
+            for(int i = 0; i < LANES; i++) {
+                _ppAccumulatedOnTime[i] = 0.0f;
+                _timeBetweenPPevents[i] = 0;
+                _ppAlertHoldoff[i] = _oneDay[i];
+                _wpAlertHoldoff[i] = _oneDay[i];
+                _interPumpAlertHoldoff[i] = _oneDay[i];
+                _ppNotRunAlertHoldoff[i] = _threeDays[i];
+            }
+        }
+
+        // Each event method returns true if any lane alerted; alerted(lane) and alert(lane) then
+        // say which lanes and which alert.  An event raises at most one alert per lane except
+        // ppTurnedOff(), which can raise a run time alert and a WP not come on alert: those are
+        // alert(lane) and secondAlert(lane).
+
+        bool halfHourTimeTick() {
+            uint32_t any = 0;
+            for(int i = 0; i < LANES; i++) {
+                _ppAlertHoldoff[i] += _ppAlertHoldoff[i] < _oneDay[i];
+                _wpAlertHoldoff[i] += _wpAlertHoldoff[i] < _oneDay[i];
+                _interPumpAlertHoldoff[i] += _interPumpAlertHoldoff[i] < _oneDay[i];
+                _ppNotRunAlertHoldoff[i] += _ppNotRunAlertHoldoff[i] < _threeDays[i];
+
+                uint32_t counting = _timeBetweenPPevents[i] < _oneDay[i];
+                uint32_t alert = !counting & (_ppNotRunAlertHoldoff[i] >= _threeDays[i]);
+                _timeBetweenPPevents[i] = counting ? _timeBetweenPPevents[i] + 1 : _oneDay[i];
+                _ppNotRunAlertHoldoff[i] = alert ? 0 : _ppNotRunAlertHoldoff[i];
+                _alerted[i] = alert;
+                _alert[i] = LANE_PP_NOT_RUN;
+                any |= alert;
+            }
+            return any != 0;
+        }
+
+        bool ppTurnedOn() {
+            for(int i = 0; i < LANES; i++) {
+                _timeBetweenPPevents[i] = 0;
+            }
+            return false;
+        }
+
+        bool ppTurnedOff(float runTime) {
+            uint32_t any = 0;
+            for(int i = 0; i < LANES; i++) {
+                uint32_t allowed = _ppAlertHoldoff[i] >= _oneDay[i];
+                uint32_t tooShort = allowed & (runTime < _ppOnTooShort[i]);
+                uint32_t tooLong = allowed & !tooShort & (runTime > _ppOnTooLong[i]);
+                uint32_t runAlert = tooShort | tooLong;
+                _ppAlertHoldoff[i] = runAlert ? 0 : _ppAlertHoldoff[i];
+
+                uint32_t accumulating = _ppAccumulatedOnTime[i] < _wpRunTooLong[i];
+                uint32_t notComeOn = !accumulating & (_interPumpAlertHoldoff[i] >= _oneDay[i]);
+                _ppAccumulatedOnTime[i] = accumulating ? _ppAccumulatedOnTime[i] + runTime : _wpRunTooLong[i];
+                _interPumpAlertHoldoff[i] = notComeOn ? 0 : _interPumpAlertHoldoff[i];
+
+                // the run time alert is published first
+                _alerted[i] = runAlert | (notComeOn << 1);
+                _alert[i] = tooShort ? LANE_PP_ON_TOO_SHORT : (tooLong ? LANE_PP_ON_TOO_LONG : LANE_WP_NOT_COME_ON);
+                any |= runAlert | notComeOn;
+            }
+            return any != 0;
+        }
+
+        bool wpTurnedOn() {
+            uint32_t any = 0;
+            for(int i = 0; i < LANES; i++) {
+                uint32_t alert = (_interPumpAlertHoldoff[i] >= _oneDay[i]) &
+                                 (_ppAccumulatedOnTime[i] < _wpRunTooSoon[i]);
+                _interPumpAlertHoldoff[i] = alert ? 0 : _interPumpAlertHoldoff[i];
+                _ppAccumulatedOnTime[i] = 0.0f;
+                _alerted[i] = alert;
+                _alert[i] = LANE_WP_ON_TOO_SOON;
+                any |= alert;
+            }
+            return any != 0;
+        }
+
+        bool wpTurnedOff(float runTime) {
+            uint32_t any = 0;
+            for(int i = 0; i < LANES; i++) {
+                uint32_t allowed = _wpAlertHoldoff[i] >= _oneDay[i];
+                uint32_t tooShort = allowed & (runTime < _wpOnTooShort[i]);
+                uint32_t tooLong = allowed & !tooShort & (runTime > _wpOnTooLong[i]);
+                uint32_t alert = tooShort | tooLong;
+                _wpAlertHoldoff[i] = alert ? 0 : _wpAlertHoldoff[i];
+                _alerted[i] = alert;
+                _alert[i] = tooShort ? LANE_WP_ON_TOO_SHORT : LANE_WP_ON_TOO_LONG;
+                any |= alert;
+            }
+            return any != 0;
+        }
+
+        // results of the last event method
+        bool alerted(int lane) const { return (_alerted[lane] & 1) != 0; }
+        LaneAlert alert(int lane) const { return (LaneAlert)_alert[lane]; }
+        bool secondAlert(int lane) const { return (_alerted[lane] & 2) != 0; }
+        bool anyAlert(int lane) const { return _alerted[lane] != 0; }
+
+        // the state of one lane, as the WSMAlertProcessor get_* methods
+        float get_ppAccumulatedOnTime(int lane) const { return _ppAccumulatedOnTime[lane]; }
+        unsigned int get_timeBetweenPPevents(int lane) const { return _timeBetweenPPevents[lane]; }
+        unsigned int get_ppAlertHoldoff(int lane) const { return _ppAlertHoldoff[lane]; }
+        unsigned int get_wpAlertHoldoff(int lane) const { return _wpAlertHoldoff[lane]; }
+        unsigned int get_interPumpAlertHoldoff(int lane) const { return _interPumpAlertHoldoff[lane]; }
+        unsigned int get_ppNotRunAlertHoldoff(int lane) const { return _ppNotRunAlertHoldoff[lane]; }
+
+    private:
+        // limits
+        alignas(64) float _ppOnTooShort[LANES];
+        alignas(64) float _ppOnTooLong[LANES];
+        alignas(64) float _wpOnTooShort[LANES];
+        alignas(64) float _wpOnTooLong[LANES];
+        alignas(64) float _wpRunTooSoon[LANES];
+        alignas(64) float _wpRunTooLong[LANES];
+        alignas(64) uint32_t _oneDay[LANES];
+        alignas(64) uint32_t _threeDays[LANES];
+
+        // state
+        alignas(64) float _ppAccumulatedOnTime[LANES];
+        alignas(64) uint32_t _timeBetweenPPevents[LANES];
+        alignas(64) uint32_t _ppAlertHoldoff[LANES];
+        alignas(64) uint32_t _wpAlertHoldoff[LANES];
+        alignas(64) uint32_t _interPumpAlertHoldoff[LANES];
+        alignas(64) uint32_t _ppNotRunAlertHoldoff[LANES];
+
+        // last event's alerts
+        alignas(64) uint32_t _alerted[LANES];
+        alignas(64) uint32_t _alert[LANES];
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,334 @@
+/***************************************************************************************************/
+// ThresholdSweep.cpp
+//  Backtests alert limit combinations against recorded history.  See ThresholdSweep.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ThresholdSweep.h"
+#include "LaneAlertProcessor.h"
+#include "ParticleHost.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+    const char *ALERT_NAMES[NUM_ALERT_TYPES] = {
+        "wsmAlertPPOnTooLong",
+        "wsmAlertPPOnTooShort",
+        "wsmAlertWPOnTooLong",
+        "wsmAlertWPOnTooShort",
+        "wsmAlertWPNotComeOn",
+        "wsmAlertWPOnTooSoon",
+        "wsmAlertPPNotRun",
+    };
+
+    const int64_t DEFAULT_WINDOW = 12 * 3600;      // seconds either side of an incident
+
+    bool incidentBefore(const SweepIncident &a, const SweepIncident &b) {
+        return a.etime < b.etime;
+    }
+
+}   // namespace
+
+SweepAlertType alertTypeFromName(const char *name) {
+    for(int i = 0; i < NUM_ALERT_TYPES; i++) {
+        if(strcmp(name, ALERT_NAMES[i]) == 0) {
+            return (SweepAlertType)i;
+        }
+    }
+    return ALERT_ANY;
+}
+
+const char *alertTypeName(SweepAlertType type) {
+    return type < NUM_ALERT_TYPES ? ALERT_NAMES[type] : "any";
+}
+
+/******************************************** grid *********************************************/
+SweepGrid::SweepGrid() {
+    WSMAlertLimits defaults;
+    ppOnTooShort.push_back(defaults.ppOnTooShort);
+    ppOnTooLong.push_back(defaults.ppOnTooLong);
+    wpOnTooShort.push_back(defaults.wpOnTooShort);
+    wpOnTooLong.push_back(defaults.wpOnTooLong);
+    wpRunTooSoon.push_back(defaults.wpRunTooSoon);
+    wpRunTooLong.push_back(defaults.wpRunTooLong);
+    oneDay.push_back(defaults.oneDay);
+    threeDays.push_back(defaults.threeDays);
+}
+
+uint64_t SweepGrid::size() const {
+    return (uint64_t)ppOnTooShort.size() * ppOnTooLong.size() * wpOnTooShort.size() * wpOnTooLong.size() *
+           wpRunTooSoon.size() * wpRunTooLong.size() * oneDay.size() * threeDays.size();
+}
+
+// decode a grid index, first limit varying fastest
+WSMAlertLimits SweepGrid::limits(uint64_t index) const {
+    WSMAlertLimits limits;
+    limits.ppOnTooShort = ppOnTooShort[index % ppOnTooShort.size()];
+    index /= ppOnTooShort.size();
+    limits.ppOnTooLong = ppOnTooLong[index % ppOnTooLong.size()];
+    index /= ppOnTooLong.size();
+    limits.wpOnTooShort = wpOnTooShort[index % wpOnTooShort.size()];
+    index /= wpOnTooShort.size();
+    limits.wpOnTooLong = wpOnTooLong[index % wpOnTooLong.size()];
+    index /= wpOnTooLong.size();
+    limits.wpRunTooSoon = wpRunTooSoon[index % wpRunTooSoon.size()];
+    index /= wpRunTooSoon.size();
+    limits.wpRunTooLong = wpRunTooLong[index % wpRunTooLong.size()];
+    index /= wpRunTooLong.size();
+    limits.oneDay = oneDay[index % oneDay.size()];
+    index /= oneDay.size();
+    limits.threeDays = threeDays[index % threeDays.size()];
+    return limits;
+}
+
+bool SweepResult::betterThan(const SweepResult &other) const {
+    if(missed != other.missed) {
+        return missed < other.missed;
+    }
+    if(falseAlerts != other.falseAlerts) {
+        return falseAlerts < other.falseAlerts;
+    }
+    if(distance != other.distance) {
+        return distance < other.distance;
+    }
+    if(alerts != other.alerts) {
+        return alerts < other.alerts;
+    }
+    return index < other.index;
+}
+
+/******************************************** sweep ********************************************/
+ThresholdSweep::ThresholdSweep() : _window(DEFAULT_WINDOW), _scalar(false), _steals(0) {}
+
+// the same mapping as HistoryReplay: rows the firmware would not have fed to the alerter are dropped
+void ThresholdSweep::addEvent(const WSMDataRow &row) {
+    SweepEvent event;
+    event.etime = row.etime;
+    event.runTime = 0.0f;
+    switch(row.event) {
+        case WSM_EVENT_TRH:
+            event.kind = SweepEvent::TICK;
+            break;
+        case WSM_EVENT_PP_STATUS:
+            if(row.pp == 1) {
+                event.kind = SweepEvent::PP_ON;
+            } else if(row.pp == 0 && !std::isnan(row.ppon)) {
+                event.kind = SweepEvent::PP_OFF;
+                event.runTime = row.ppon;
+            } else {
+                return;
+            }
+            break;
+        case WSM_EVENT_WP_STATUS:
+            if(row.wp == 1) {
+                event.kind = SweepEvent::WP_ON;
+            } else if(row.wp == 0 && !std::isnan(row.wpon)) {
+                event.kind = SweepEvent::WP_OFF;
+                event.runTime = row.wpon;
+            } else {
+                return;
+            }
+            break;
+        default:
+            return;
+    }
+    _events.push_back(event);
+}
+
+uint64_t ThresholdSweep::load(WSMDataReader &reader) {
+    size_t before = _events.size();
+    WSMDataRow row;
+    while(reader.next(row)) {
+        addEvent(row);
+    }
+    return _events.size() - before;
+}
+
+void ThresholdSweep::addIncident(const SweepIncident &incident) {
+    _incidents.insert(std::upper_bound(_incidents.begin(), _incidents.end(), incident, incidentBefore), incident);
+}
+
+bool ThresholdSweep::loadIncidents(const char *path) {
+    FILE *file = fopen(path, "r");
+    if(file == nullptr) {
+        return false;
+    }
+    char line[256];
+    while(fgets(line, sizeof(line), file) != nullptr) {
+        char *p = line + strspn(line, " \t");
+        if(*p == '#' || *p == '\r' || *p == '\n' || *p == '\0') {
+            continue;
+        }
+        SweepIncident incident;
+        char *end;
+        incident.etime = strtoll(p, &end, 10);
+        if(end == p) {
+            continue;
+        }
+        char name[64];
+        incident.type = sscanf(end, "%63s", name) == 1 ? alertTypeFromName(name) : ALERT_ANY;
+        addIncident(incident);
+    }
+    fclose(file);
+    return true;
+}
+
+SweepResult ThresholdSweep::evaluate(const WSMAlertLimits &limits, uint64_t index) const {
+    SweepResult result;
+    result.index = index;
+    result.limits = limits;
+
+    // the alerts land here, stamped with the etime of the event that raised them
+    std::vector<SweepIncident> alerts;
+    int64_t etime = 0;
+    ParticleHost::setThreadPublishSink([&](const ParticleHost::PublishRecord &record) {
+        alerts.push_back(SweepIncident{etime, alertTypeFromName(record.name.c_str())});
+    });
+
+    WSMAlertProcessor alerter(limits);
+    alerter.begin();
+    for(const SweepEvent &event : _events) {
+        etime = event.etime;
+        switch(event.kind) {
+            case SweepEvent::TICK:
+                alerter.halfHourTimeTick();
+                break;
+            case SweepEvent::PP_ON:
+                alerter.ppTurnedOn();
+                break;
+            case SweepEvent::PP_OFF:
+                alerter.ppTurnedOff(event.runTime);
+                break;
+            case SweepEvent::WP_ON:
+                alerter.wpTurnedOn();
+                break;
+            case SweepEvent::WP_OFF:
+                alerter.wpTurnedOff(event.runTime);
+                break;
+        }
+    }
+    ParticleHost::setThreadPublishSink(ParticleHost::PublishSink());
+
+    score(alerts, result);
+    return result;
+}
+
+void ThresholdSweep::evaluateLanes(const SweepGrid &grid, uint64_t first, int count, SweepResult *results) const {
+    LaneAlertProcessor<SWEEP_LANES> lanes;
+    for(int lane = 0; lane < SWEEP_LANES; lane++) {
+        // spare lanes repeat the last combination and are ignored
+        lanes.setLimits(lane, grid.limits(first + (lane < count ? lane : count - 1)));
+    }
+    lanes.begin();
+
+    std::vector<SweepIncident> alerts[SWEEP_LANES];
+    for(const SweepEvent &event : _events) {
+        bool alerted = false;
+        switch(event.kind) {
+            case SweepEvent::TICK:
+                alerted = lanes.halfHourTimeTick();
+                break;
+            case SweepEvent::PP_ON:
+                alerted = lanes.ppTurnedOn();
+                break;
+            case SweepEvent::PP_OFF:
+                alerted = lanes.ppTurnedOff(event.runTime);
+                break;
+            case SweepEvent::WP_ON:
+                alerted = lanes.wpTurnedOn();
+                break;
+            case SweepEvent::WP_OFF:
+                alerted = lanes.wpTurnedOff(event.runTime);
+                break;
+        }
+        if(!alerted) {
+            continue;
+        }
+        for(int lane = 0; lane < count; lane++) {
+            if(lanes.alerted(lane)) {
+                alerts[lane].push_back(SweepIncident{event.etime, (SweepAlertType)lanes.alert(lane)});
+            }
+            if(lanes.secondAlert(lane)) {
+                alerts[lane].push_back(SweepIncident{event.etime, ALERT_WP_NOT_COME_ON});
+            }
+        }
+    }
+
+    for(int lane = 0; lane < count; lane++) {
+        SweepResult &result = results[lane];
+        result = SweepResult();
+        result.index = first + lane;
+        result.limits = grid.limits(first + lane);
+        score(alerts[lane], result);
+    }
+}
+
+void ThresholdSweep::score(const std::vector<SweepIncident> &alerts, SweepResult &result) const {
+    result.alerts = (uint32_t)alerts.size();
+    std::vector<bool> matched(alerts.size(), false);
+    for(size_t i = 0; i < alerts.size(); i++) {
+        if(alerts[i].type < NUM_ALERT_TYPES) {
+            result.alertsByType[alerts[i].type]++;
+        }
+    }
+
+    // alerts are in etime order, so the candidates for each incident are a contiguous run
+    for(const SweepIncident &incident : _incidents) {
+        SweepIncident first{incident.etime - _window, ALERT_ANY};
+        size_t i = std::lower_bound(alerts.begin(), alerts.end(), first, incidentBefore) - alerts.begin();
+        int64_t nearest = -1;
+        for(; i < alerts.size() && alerts[i].etime <= incident.etime + _window; i++) {
+            if(incident.type != ALERT_ANY && alerts[i].type != incident.type) {
+                continue;
+            }
+            matched[i] = true;
+            int64_t distance = std::llabs(alerts[i].etime - incident.etime);
+            if(nearest < 0 || distance < nearest) {
+                nearest = distance;
+            }
+        }
+        if(nearest >= 0) {
+            result.detected++;
+            result.distance += (double)nearest;
+        } else {
+            result.missed++;
+        }
+    }
+    for(bool m : matched) {
+        if(!m) {
+            result.falseAlerts++;
+        }
+    }
+}
+
+std::vector<SweepResult> ThresholdSweep::run(const SweepGrid &grid, int numThreads) {
+    uint64_t size = grid.size();
+    std::vector<SweepResult> results(size);
+    WorkStealingPool pool(numThreads);
+    if(_scalar) {
+        pool.run(size, [&](uint64_t index, int) {
+            results[index] = evaluate(grid.limits(index), index);
+        });
+    } else {
+        // one task per group of SWEEP_LANES combinations
+        pool.run((size + SWEEP_LANES - 1) / SWEEP_LANES, [&](uint64_t group, int) {
+            uint64_t first = group * SWEEP_LANES;
+            int count = (int)(size - first < (uint64_t)SWEEP_LANES ? size - first : SWEEP_LANES);
+            evaluateLanes(grid, first, count, &results[first]);
+        });
+    }
+    _steals = pool.steals();
+
+    std::sort(results.begin(), results.end(),
+              [](const SweepResult &a, const SweepResult &b) { return a.betterThan(b); });
+    return results;
+}
@@ -0,0 +1,133 @@
+#ifndef THRESHOLDSWEEP_H_INCLUDE
+#define THRESHOLDSWEEP_H_INCLUDE
+/***************************************************************************************************/
+// ThresholdSweep.h
+//  Backtests a grid of WSMAlertProcessor limit combinations against a recorded event history.
+//  Every combination runs the unmodified alert processor over the whole history, the way the
+//  firmware would have fed it, and its alerts are scored against labelled incidents:
+//
+//  - an incident is detected if a matching alert was raised within the match window of it
+//  - an alert with no incident within the window is a false alert
+//  - the distance is the sum over detected incidents of the time to the nearest matching alert
+//
+//  Results are ranked by missed incidents, then false alerts, then distance, then total alerts.
+//  With no incidents that is simply the fewest alerts first.
+//
+//  The combinations are spread over all cores with WorkStealingPool, SWEEP_LANES at a time in a
+//  LaneAlertProcessor, which is bit identical to WSMAlertProcessor.  evaluate() runs the scalar
+//  WSMAlertProcessor itself; setScalar(true) makes run() use it too, for comparison.  Each worker
+//  thread sends the scalar alert processors' publications to its own sink
+//  (ParticleHost::setThreadPublishSink).
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMAlertProcessor.h"
+#include "WSMDataReader.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// the seven alerts, numbered as in WSMAlertProcessor
+enum SweepAlertType {
+    ALERT_PP_ON_TOO_LONG,       // #1
+    ALERT_PP_ON_TOO_SHORT,      // #2
+    ALERT_WP_ON_TOO_LONG,       // #3
+    ALERT_WP_ON_TOO_SHORT,      // #4
+    ALERT_WP_NOT_COME_ON,       // #5
+    ALERT_WP_ON_TOO_SOON,       // #6
+    ALERT_PP_NOT_RUN,           // #7
+    NUM_ALERT_TYPES,
+    ALERT_ANY = NUM_ALERT_TYPES // an incident that any alert detects
+};
+
+// the alert type for a wsmAlert* event name, or ALERT_ANY if it is not one
+SweepAlertType alertTypeFromName(const char *name);
+const char *alertTypeName(SweepAlertType type);
+
+// an alert processor call, in history order
+struct SweepEvent {
+    enum Kind : uint8_t { TICK, PP_ON, PP_OFF, WP_ON, WP_OFF };
+    int64_t etime;
+    Kind kind;
+    float runTime;      // PP_OFF and WP_OFF
+};
+
+// a known problem that the alerts should have caught
+struct SweepIncident {
+    int64_t etime;
+    SweepAlertType type;
+};
+
+// the values to try for each limit; the grid is every combination
+struct SweepGrid {
+    std::vector<float> ppOnTooShort;
+    std::vector<float> ppOnTooLong;
+    std::vector<float> wpOnTooShort;
+    std::vector<float> wpOnTooLong;
+    std::vector<float> wpRunTooSoon;
+    std::vector<float> wpRunTooLong;
+    std::vector<unsigned int> oneDay;
+    std::vector<unsigned int> threeDays;
+
+    SweepGrid();        // every limit at its WSMAlertLimits default
+    uint64_t size() const;
+    WSMAlertLimits limits(uint64_t index) const;    // index 0 .. size() - 1
+};
+
+struct SweepResult {
+    uint64_t index;                 // into the grid
+    WSMAlertLimits limits;
+    uint32_t alerts = 0;
+    uint32_t alertsByType[NUM_ALERT_TYPES] = {};
+    uint32_t detected = 0;          // incidents with a matching alert in the window
+    uint32_t missed = 0;
+    uint32_t falseAlerts = 0;       // alerts with no incident in the window
+    double distance = 0.0;          // seconds, summed over detected incidents
+
+    bool betterThan(const SweepResult &other) const;
+};
+
+// combinations evaluated together by one LaneAlertProcessor
+const int SWEEP_LANES = 16;
+
+class ThresholdSweep {
+    public:
+        ThresholdSweep();
+
+        // append the alert processor calls for a log's rows; returns the number of events added
+        uint64_t load(WSMDataReader &reader);
+        void addEvent(const WSMDataRow &row);
+        void addIncident(const SweepIncident &incident);
+        bool loadIncidents(const char *path);   // "<etime> [wsmAlert name]" per line, # comments
+
+        void setMatchWindow(int64_t seconds) { _window = seconds; }
+        void setScalar(bool scalar) { _scalar = scalar; }
+
+        // run one combination on the calling thread
+        SweepResult evaluate(const WSMAlertLimits &limits, uint64_t index = 0) const;
+
+        // run combinations first .. first + count - 1 (count <= SWEEP_LANES) together on the calling thread
+        void evaluateLanes(const SweepGrid &grid, uint64_t first, int count, SweepResult *results) const;
+
+        // run every combination in the grid on numThreads threads (0: all cores), best first
+        std::vector<SweepResult> run(const SweepGrid &grid, int numThreads = 0);
+
+        const std::vector<SweepEvent> &events() const { return _events; }
+        const std::vector<SweepIncident> &incidents() const { return _incidents; }
+        uint64_t steals() const { return _steals; }
+
+    private:
+        void score(const std::vector<SweepIncident> &alerts, SweepResult &result) const;
+
+        std::vector<SweepEvent> _events;
+        std::vector<SweepIncident> _incidents;     // sorted by etime
+        int64_t _window;
+        bool _scalar;
+        uint64_t _steals;
+};
+
+#endif  // end of header duplication prevention
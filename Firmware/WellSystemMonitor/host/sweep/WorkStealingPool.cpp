@@ -0,0 +1,98 @@
+/***************************************************************************************************/
+// WorkStealingPool.cpp
+//  Work stealing thread pool for the host tools.  See WorkStealingPool.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WorkStealingPool.h"
+
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(int numThreads) : _numThreads(numThreads), _remaining(0), _steals(0) {
+    if(_numThreads <= 0) {
+        _numThreads = (int)std::thread::hardware_concurrency();
+    }
+    if(_numThreads <= 0) {
+        _numThreads = 1;
+    }
+    for(int i = 0; i < _numThreads; i++) {
+        _workers.emplace_back(new Worker);
+    }
+}
+
+bool WorkStealingPool::popLocal(int worker, Range &range) {
+    Worker &w = *_workers[worker];
+    std::lock_guard<std::mutex> guard(w.lock);
+    if(w.ranges.empty()) {
+        return false;
+    }
+    range = w.ranges.back();
+    w.ranges.pop_back();
+    return true;
+}
+
+// take the oldest (largest) range from the first other worker that has one
+bool WorkStealingPool::steal(int thief, Range &range) {
+    for(int i = 1; i < _numThreads; i++) {
+        Worker &victim = *_workers[(thief + i) % _numThreads];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if(!victim.ranges.empty()) {
+            range = victim.ranges.front();
+            victim.ranges.pop_front();
+            _steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::work(int worker, const Task &task, uint64_t grain) {
+    Range range;
+    while(_remaining.load(std::memory_order_acquire) > 0) {
+        if(!popLocal(worker, range) && !steal(worker, range)) {
+            std::this_thread::yield();      // the last ranges are running on other workers
+            continue;
+        }
+        // keep splitting until the range is small enough to run; the halves stay stealable
+        while(range.end - range.begin > grain) {
+            uint64_t middle = range.begin + (range.end - range.begin) / 2;
+            {
+                Worker &w = *_workers[worker];
+                std::lock_guard<std::mutex> guard(w.lock);
+                w.ranges.push_back(Range{middle, range.end});
+            }
+            range.end = middle;
+        }
+        for(uint64_t t = range.begin; t < range.end; t++) {
+            task(t, worker);
+        }
+        _remaining.fetch_sub(range.end - range.begin, std::memory_order_acq_rel);
+    }
+}
+
+void WorkStealingPool::run(uint64_t numTasks, const Task &task, uint64_t grain) {
+    if(grain == 0) {
+        grain = 1;
+    }
+    _steals = 0;
+    _remaining = numTasks;
+    for(int i = 0; i < _numThreads; i++) {
+        uint64_t begin = numTasks * i / _numThreads;
+        uint64_t end = numTasks * (i + 1) / _numThreads;
+        if(end > begin) {
+            _workers[i]->ranges.push_back(Range{begin, end});
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for(int i = 1; i < _numThreads; i++) {
+        threads.emplace_back(&WorkStealingPool::work, this, i, std::cref(task), grain);
+    }
+    work(0, task, grain);       // the calling thread is worker 0
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+}
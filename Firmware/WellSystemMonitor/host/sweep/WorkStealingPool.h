@@ -0,0 +1,60 @@
+#ifndef WORKSTEALINGPOOL_H_INCLUDE
+#define WORKSTEALINGPOOL_H_INCLUDE
+/***************************************************************************************************/
+// WorkStealingPool.h
+//  Runs a numbered set of independent tasks on all cores.  Each worker starts with an equal share
+//  of the task numbers as one range in its own deque.  A worker takes ranges from the back of its
+//  own deque, splitting any range bigger than the grain size and pushing the upper half back, so
+//  its deque always holds the largest untouched ranges at the front.  A worker whose deque is
+//  empty steals from the front of another worker's deque.  Uneven task costs (a limit combination
+//  that raises many alerts costs more to evaluate) are evened out without a shared queue.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class WorkStealingPool {
+    public:
+        // called once for each task number, with the number of the worker running it
+        typedef std::function<void(uint64_t task, int worker)> Task;
+
+        // numThreads 0 uses every core
+        explicit WorkStealingPool(int numThreads = 0);
+
+        // run tasks 0 .. numTasks - 1 and wait for them all; grain is the most tasks taken at once
+        void run(uint64_t numTasks, const Task &task, uint64_t grain = 1);
+
+        int numThreads() const { return _numThreads; }
+        uint64_t steals() const { return _steals; }     // ranges stolen during the last run()
+
+    private:
+        struct Range {
+            uint64_t begin;
+            uint64_t end;
+        };
+
+        struct Worker {
+            std::mutex lock;
+            std::deque<Range> ranges;
+        };
+
+        bool popLocal(int worker, Range &range);
+        bool steal(int thief, Range &range);
+        void work(int worker, const Task &task, uint64_t grain);
+
+        int _numThreads;
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::atomic<uint64_t> _remaining;
+        std::atomic<uint64_t> _steals;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,315 @@
+/***************************************************************************************************/
+// AlertRouterTest.cpp
+//  Checks the alert router (dispatch/WSMAlertRouter.h): a lone alert sent at once as the
+//  WSM_Send_Alert script sends it; the alerts that follow sent as one digest when the window ends;
+//  the same alert from several devices of a site sent once; the token bucket holding back messages
+//  but no alert; the recipients of a site and the default ones; refusals; a failing sink tried
+//  again; routes from a file; the mailbox; and alerts submitted from several threads to the
+//  dispatcher.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "TestCheck.h"
+#include "WSMAlertDispatcher.h"
+#include "WSMMailbox.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+const char DEVICE_A[] = "e00fce68a1b2c3d4e5f60001";
+const char DEVICE_B[] = "e00fce68a1b2c3d4e5f60002";
+
+// 2022-09-27 11:51:01 UTC, 04:51:01 in the script's time zone
+const char ALERT_DATA[] = "{\"etime\":1664279461,\"msg\":\"PP on for 3.5 minutes.\"}";
+
+// the messages a router sent
+struct Sent {
+    std::vector<WSMAlertMessage> messages;
+    bool accept = true;
+
+    WSMAlertSink sink() {
+        return [this](const WSMAlertMessage &message) {
+            if(!accept) {
+                return false;
+            }
+            messages.push_back(message);
+            return true;
+        };
+    }
+};
+
+static void testImmediate() {
+    Sent sent;
+    WSMAlertRouterConfig config;
+    WSMAlertRouter router(config, sent.sink());
+    router.addRecipient("*", "owner@example.com");
+    check(router.route(DEVICE_A, "wsmAlertPPOnTooLong", ALERT_DATA, 0), "immediate alert routed");
+    check(sent.messages.size() == 1 && router.held() == 0, "immediate alert sent at once");
+    if(sent.messages.size() == 1) {
+        const WSMAlertMessage &message = sent.messages[0];
+        check(message.subject == "WSM ALERT: The PP was on too long", "immediate subject the script's");
+        check(message.body == "PP on for 3.5 minutes. at: 2022-09-27 04:51:01", "immediate body the script's");
+        check(message.recipient == "owner@example.com" && message.site == DEVICE_A && !message.digest,
+              "immediate recipient and site");
+    }
+    check(router.poll(1) == INT64_MAX, "nothing due after an immediate alert");
+
+    // standard time in winter, and the hour daylight time starts
+    router.route(DEVICE_A, "wsmAlertWPOnTooSoon", "{\"etime\":1704067200,\"msg\":\"WP ran 5 min early.\"}",
+                 config.dedupeWindowMs);
+    router.route(DEVICE_A, "wsmAlertPPNotRun", "{\"etime\":1710064800,\"msg\":\"PP did not run.\"}",
+                 2 * config.dedupeWindowMs);
+    check(sent.messages.size() == 3 && sent.messages[1].body == "WP ran 5 min early. at: 2023-12-31 16:00:00" &&
+          sent.messages[2].body == "PP did not run. at: 2024-03-10 03:00:00", "local time follows daylight time");
+}
+
+static void testDigest() {
+    Sent sent;
+    WSMAlertRouterConfig config;
+    WSMAlertRouter router(config, sent.sink());
+    router.addRecipient("*", "owner@example.com");
+    router.route(DEVICE_A, "wsmAlertPPOnTooLong", ALERT_DATA, 0);
+    router.route(DEVICE_A, "wsmAlertWPNotComeOn", "{\"etime\":1664279521,\"msg\":\"WP did not come on.\"}", 10000);
+    router.route(DEVICE_A, "wsmAlertPPShortCycling", "{\"etime\":1664279581,\"msg\":\"PP cycled 9 times.\"}", 20000);
+    check(sent.messages.size() == 1 && router.held() == 2, "alerts within the window held");
+    check(router.poll(config.digestWindowMs - 1) == config.digestWindowMs, "digest due when the window ends");
+    check(sent.messages.size() == 1, "digest not sent before the window ends");
+    check(router.poll(config.digestWindowMs) == INT64_MAX, "nothing due after the digest");
+    check(sent.messages.size() == 2 && router.held() == 0, "digest sent when the window ends");
+    if(sent.messages.size() == 2) {
+        const WSMAlertMessage &digest = sent.messages[1];
+        check(digest.digest && digest.alerts.size() == 2, "digest of the held alerts");
+        check(digest.subject == std::string("WSM ALERT: 2 alerts from ") + DEVICE_A, "digest subject");
+        check(digest.body == "The WP did not come on: WP did not come on. at: 2022-09-27 04:52:01\n"
+                             "The PP is short cycling: PP cycled 9 times. at: 2022-09-27 04:53:01\n",
+              "digest body");
+    }
+    const WSMAlertRouterStats &stats = router.stats();
+    check(stats.received == 3 && stats.messages == 2 && stats.digests == 1 && stats.alertsSent == 3,
+          "digest stats");
+}
+
+static void testDedupe() {
+    Sent sent;
+    WSMAlertRouterConfig config;
+    WSMAlertRouter router(config, sent.sink());
+    router.mapDevice(DEVICE_A, "smith");
+    router.mapDevice(DEVICE_B, "smith");
+    router.addRecipient("smith", "smith@example.com");
+    router.route(DEVICE_A, "wsmAlertWPFreeze", "{\"etime\":1664279461,\"msg\":\"WP on at 30 F.\"}", 0);
+    router.route(DEVICE_A, "wsmAlertPPOnTooLong", ALERT_DATA, 1000);
+    router.route(DEVICE_B, "wsmAlertPPOnTooLong", ALERT_DATA, 2000);
+    router.route(DEVICE_A, "wsmAlertPPOnTooLong", ALERT_DATA, 3000);
+    router.poll(config.digestWindowMs);
+    check(sent.messages.size() == 2, "duplicates not sent again");
+    if(sent.messages.size() == 2) {
+        const WSMAlertMessage &message = sent.messages[1];
+        check(message.alerts.size() == 1 && message.alerts[0].reports == 3 && message.alerts[0].devices == 2,
+              "duplicates counted on the alert");
+        check(message.body.find("(reported 3 times by 2 devices)") != std::string::npos, "duplicates in the body");
+        check(message.site == "smith", "devices mapped to their site");
+    }
+    check(router.stats().duplicates == 2, "duplicates counted");
+
+    // once the dedupe window is over the alert is a new one
+    router.route(DEVICE_B, "wsmAlertPPOnTooLong", ALERT_DATA, 1000 + config.dedupeWindowMs);
+    check(sent.messages.size() == 3 && router.stats().duplicates == 2, "alert new again after the dedupe window");
+}
+
+static void testTokenBucket() {
+    Sent sent;
+    WSMAlertRouterConfig config;
+    config.digestWindowMs = 1000;
+    config.dedupeWindowMs = 0;
+    config.messagesPerHour = 6.0;
+    config.burst = 2.0;
+    WSMAlertRouter router(config, sent.sink());
+    router.addRecipient("*", "owner@example.com");
+
+    // an alert a second for ten minutes: the bucket allows two, then one each ten minutes
+    int64_t nowMs = 0;
+    for(int i = 0; i < 600; i++, nowMs += 1000) {
+        router.poll(nowMs);
+        router.route(DEVICE_A, WSM_ALERT_KINDS[i % ALERT_KINDS].event, ALERT_DATA, nowMs);
+    }
+    check(sent.messages.size() == 2, "token bucket allows a burst");
+    check(router.stats().throttled > 0, "token bucket throttles");
+    int64_t next = router.poll(nowMs);
+    check(next > nowMs && next <= 600000 + 2000, "throttled digest due when a token comes back");
+    router.poll(602000);
+    check(sent.messages.size() == 3 && router.held() == 0, "throttled alerts sent in one digest");
+    check(router.stats().alertsSent == 600, "no alert dropped by the token bucket");
+    if(sent.messages.size() == 3) {
+        check(sent.messages[2].body.find("and 578 more") != std::string::npos, "long digest counts the rest");
+    }
+}
+
+static void testRecipients() {
+    Sent sent;
+    WSMAlertRouter router(WSMAlertRouterConfig(), sent.sink());
+    router.mapDevice(DEVICE_A, "smith");
+    router.addRecipient("smith", "smith@example.com");
+    router.addRecipient("smith", "5551234567@vtext.com");
+    router.addRecipient("*", "ops@example.com");
+    router.route(DEVICE_A, "wsmAlertPPNotRun", ALERT_DATA, 0);
+    router.route(DEVICE_B, "wsmAlertPPNotRun", ALERT_DATA, 0);
+    check(sent.messages.size() == 3, "a message for each recipient");
+    if(sent.messages.size() == 3) {
+        check(sent.messages[0].recipient == "smith@example.com" && sent.messages[1].recipient == "5551234567@vtext.com",
+              "site recipients");
+        check(sent.messages[2].recipient == "ops@example.com" && sent.messages[2].site == DEVICE_B,
+              "default recipient for a site without its own");
+    }
+}
+
+static void testRefused() {
+    Sent sent;
+    WSMAlertRouter router(WSMAlertRouterConfig(), sent.sink());
+    check(!router.route(DEVICE_A, "wsmAlertPPOnTooLong", ALERT_DATA, 0), "site without recipient refused");
+    router.addRecipient("*", "owner@example.com");
+    check(!router.route(DEVICE_A, "wsmEventPPstatus", ALERT_DATA, 0), "non alert event refused");
+    check(!router.route(DEVICE_A, "wsmAlertPPOnTooLong", "{\"etime\":1664279461}", 0), "alert without msg refused");
+    check(!router.route(DEVICE_A, "wsmAlertPPOnTooLong", "not json", 0), "malformed alert refused");
+    check(router.stats().refused == 4 && router.stats().received == 0 && sent.messages.empty(), "refusals counted");
+    check(alertKind("wsmAlertWPFreeze") == (int)ALERT_KINDS - 1 && alertKind("wsmAlert") == -1, "alert kinds");
+}
+
+static void testRetry() {
+    Sent sent;
+    sent.accept = false;
+    WSMAlertRouterConfig config;
+    WSMAlertRouter router(config, sent.sink());
+    router.addRecipient("*", "owner@example.com");
+    router.route(DEVICE_A, "wsmAlertWPOnTooLong", ALERT_DATA, 0);
+    check(router.stats().failures == 1 && router.held() == 1, "failed delivery held");
+    check(router.poll(1) == config.retryMs, "failed delivery tried again after retryMs");
+    router.poll(config.retryMs);
+    check(router.stats().failures == 2 && router.held() == 1, "failed again, still held");
+    sent.accept = true;
+    router.poll(2 * config.retryMs);
+    check(sent.messages.size() == 1 && router.held() == 0 && router.stats().messages == 1, "delivered on retry");
+}
+
+static void testRoutesAndMailbox() {
+    const char *routesPath = "alert_router_test.routes";
+    const char *mailboxPath = "alert_router_test.mbox";
+    FILE *file = fopen(routesPath, "w");
+    fputs("# the Smiths' two monitors\n"
+          "device e00fce68a1b2c3d4e5f60001 smith\n"
+          "device e00fce68a1b2c3d4e5f60002 smith   # barn\n"
+          "\n"
+          "recipient smith smith@example.com\n"
+          "recipient * ops@example.com\n", file);
+    fclose(file);
+    remove(mailboxPath);
+
+    WSMMailbox mailbox;
+    check(mailbox.open(mailboxPath), "mailbox opened");
+    WSMAlertRouter router(WSMAlertRouterConfig(), [&](const WSMAlertMessage &message) {
+        return mailbox.deliver(message);
+    });
+    std::string error;
+    check(router.loadRoutes(routesPath, error), "routes loaded");
+    router.route(DEVICE_B, "wsmAlertWPOnTooShort", "{\"etime\":1664279461,\"msg\":\"From the WP: 2 s.\"}", 0);
+    router.route("e00fce68a1b2c3d4e5f60099", "wsmAlertPPOnTooLong", ALERT_DATA, 0);
+    router.flush(0);
+    mailbox.close();
+    check(mailbox.delivered() == 2, "mailbox delivered");
+
+    std::string text;
+    file = fopen(mailboxPath, "r");
+    char buffer[4096];
+    size_t length = file != nullptr ? fread(buffer, 1, sizeof(buffer) - 1, file) : 0;
+    buffer[length] = '\0';
+    text = buffer;
+    if(file != nullptr) {
+        fclose(file);
+    }
+    check(text.find("To: smith@example.com\nSubject: WSM ALERT: The WP was on too short\n") != std::string::npos,
+          "mailbox routed to the site");
+    check(text.find("To: ops@example.com\nSubject: WSM ALERT: The PP was on too long\n") != std::string::npos,
+          "mailbox routed to the default");
+    check(text.find("X-WSM-Site: smith\nX-WSM-Alerts: 1\n") != std::string::npos, "mailbox headers");
+    check(text.find("\n>From the WP: 2 s. at: 2022-09-27 04:51:01\n") != std::string::npos, "mailbox quotes From");
+    check(text.compare(0, 5, "From ") == 0, "mailbox starts a mail");
+
+    file = fopen(routesPath, "w");
+    fputs("recipient smith\n", file);
+    fclose(file);
+    WSMAlertRouter bad(WSMAlertRouterConfig(), [](const WSMAlertMessage &) { return true; });
+    check(!bad.loadRoutes(routesPath, error) && error == "recipient smith\n", "bad route reported");
+    check(!bad.loadRoutes("no_such_file.routes", error), "missing routes reported");
+    remove(routesPath);
+    remove(mailboxPath);
+}
+
+static void testDispatcher() {
+    const int PRODUCERS = 4;
+    const int ALERTS = 2500;
+    WSMAlertRouterConfig config;
+    config.digestWindowMs = 20;
+    const uint64_t FIRST_REPORTS = 50 * ALERT_KINDS;     // each alert of each device, once
+    std::atomic<uint64_t> alerts(0);
+    uint64_t latest = 0;
+    WSMAlertRouter router(config, [&](const WSMAlertMessage &message) {
+        alerts += message.alerts.size();
+        for(const WSMRoutedAlert &alert : message.alerts) {
+            latest = std::max(latest, WSMAlertDispatcher::nowMicros() - alert.receivedUs);
+        }
+        return true;
+    });
+    router.addRecipient("*", "owner@example.com");
+
+    WSMAlertDispatcher dispatcher(router);
+    dispatcher.start();
+    std::vector<std::thread> producers;
+    for(int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&dispatcher, p]() {
+            char device[32];
+            for(int i = 0; i < ALERTS; i++) {
+                snprintf(device, sizeof(device), "%024x", (p * ALERTS + i) % 50);
+                dispatcher.submit(device, WSM_ALERT_KINDS[i % ALERT_KINDS].event, ALERT_DATA);
+            }
+        });
+    }
+    for(std::thread &producer : producers) {
+        producer.join();
+    }
+    // the digests come due on their own
+    for(int wait = 0; wait < 5000 && alerts.load() < FIRST_REPORTS; wait++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    bool sentWhenDue = alerts.load() == FIRST_REPORTS;
+    dispatcher.stop(true);
+
+    const WSMAlertRouterStats &stats = router.stats();
+    check(dispatcher.submitted() == PRODUCERS * ALERTS && dispatcher.routed() == PRODUCERS * ALERTS,
+          "dispatcher routed every alert");
+    check(stats.received == PRODUCERS * ALERTS, "dispatcher received every alert");
+    check(stats.received - stats.duplicates == FIRST_REPORTS && stats.alertsSent == FIRST_REPORTS,
+          "dispatcher deduped across threads");
+    check(dispatcher.wakes() <= dispatcher.submitted(), "dispatcher wakes");
+    check(sentWhenDue && router.held() == 0 && latest > 0, "dispatcher sent the digests when due");
+}
+
+int main() {
+    testImmediate();
+    testDigest();
+    testDedupe();
+    testTokenBucket();
+    testRecipients();
+    testRefused();
+    testRetry();
+    testRoutesAndMailbox();
+    testDispatcher();
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
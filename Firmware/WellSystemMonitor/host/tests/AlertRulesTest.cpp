@@ -0,0 +1,142 @@
+/***************************************************************************************************/
+// AlertRulesTest.cpp
+//  Checks the alert rule table of WSMAlertProcessor: the fixed rules, which rules addRule()
+//  refuses, the order of a trigger's rules, a rule on its own holdoff and one sharing a fixed
+//  alert's, and the two site rules the table was made for, PP cycles per hour and a WP run in
+//  freezing weather.  That the fixed rules alert exactly as the branches they replaced is checked
+//  by alert_tester_host, history_replay_test and threshold_sweep_test.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "WSMAlertProcessor.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// the names of the alerts published since the last call
+static std::vector<std::string> takeAlerts() {
+    std::vector<std::string> names;
+    for(const ParticleHost::PublishRecord &record : ParticleHost::published()) {
+        names.push_back(record.name);
+        printf("  %s %s\n", record.name.c_str(), record.data.c_str());
+    }
+    ParticleHost::clearPublished();
+    return names;
+}
+
+// a PP cycle of ½ minute, a minute after the last
+static void ppCycle(WSMAlertProcessor &alerter) {
+    ParticleHost::setUnixTime(Time.now() + 60);
+    alerter.ppTurnedOn();
+    alerter.ppTurnedOff(0.5f);
+}
+
+int main() {
+    const WSMAlertRule PP_CYCLING = {"wsmAlertPPCycling", ALERT_ON_PP_ON, MEASURE_PP_CYCLES_LAST_HOUR, ALERT_ABOVE,
+                                     12.0f, 4, ALERT_OWN_HOLDOFF, 0, 0, "PP came on ", " times in the last hour."};
+    const WSMAlertRule WP_FREEZE = {"wsmAlertWPFreeze", ALERT_ON_WP_ON, MEASURE_TEMPERATURE, ALERT_AT_MOST,
+                                    32.0f, 48, ALERT_OWN_HOLDOFF, 5, 1, "WP came on at ", " degrees F."};
+
+    // the table
+    WSMAlertProcessor full;
+    const unsigned int FIXED = 7;
+    check(full.get_ruleCount() == FIXED, "the seven fixed rules");
+    WSMAlertRule bad = PP_CYCLING;
+    bad.trigger = ALERT_TRIGGERS;
+    bool refused = !full.addRule(bad);
+    bad = PP_CYCLING;
+    bad.holdoff = ALERT_FIXED_HOLDOFFS;     // a counter that no rule has made
+    refused = refused && !full.addRule(bad);
+    bad = PP_CYCLING;
+    bad.eventName = NULL;
+    refused = refused && !full.addRule(bad);
+    check(refused && full.get_ruleCount() == FIXED, "rules that are not valid are refused");
+    unsigned int added = 0;
+    while(full.addRule(PP_CYCLING)) {
+        added++;
+    }
+    check(added == ALERT_MAX_RULES - FIXED && full.get_ruleCount() == ALERT_MAX_RULES, "up to ALERT_MAX_RULES rules");
+
+    // PP cycles per hour: more than 12 in the last hour, on a counter of its own
+    WSMAlertProcessor alerter;
+    check(alerter.addRule(PP_CYCLING) && alerter.addRule(WP_FREEZE), "site rules added");
+    ParticleHost::reset();
+    ParticleHost::setUnixTime(1767225600);
+    alerter.begin();
+    for(int i = 0; i < 8; i++) {
+        ppCycle(alerter);
+    }
+    alerter.halfHourTimeTick();
+    for(int i = 0; i < 4; i++) {
+        ppCycle(alerter);
+    }
+    check(takeAlerts().empty(), "12 cycles in the hour");
+    ppCycle(alerter);
+    std::vector<std::string> alerts = takeAlerts();
+    check(alerts.size() == 1 && alerts[0] == "wsmAlertPPCycling" &&
+          ParticleHost::published().empty(), "the 13th raises wsmAlertPPCycling");
+    alerter.halfHourTimeTick();
+    for(int i = 0; i < 12; i++) {
+        ppCycle(alerter);
+    }
+    check(takeAlerts().empty(), "held off for 4 ticks");
+    alerter.halfHourTimeTick();
+    alerter.halfHourTimeTick();
+    alerter.halfHourTimeTick();
+    ParticleHost::setUnixTime(Time.now() + 3600);
+    ppCycle(alerter);
+    check(takeAlerts().empty(), "the count is of the last hour");
+    for(int i = 0; i < 12; i++) {
+        ppCycle(alerter);
+    }
+    check(takeAlerts().size() == 1 && alerter.get_ppAlertHoldoff() == 48, "again after the holdoff, on its own counter");
+
+    // freezing: no reading, no alert; then one, after the fixed alert of the same event
+    alerter.wpTurnedOn();
+    alerter.wpTurnedOff(30.0f);
+    check(takeAlerts().empty(), "no temperature reading, no freeze alert");
+    alerter.temperatureReading(30.5f);
+    for(int i = 0; i < 15; i++) {
+        ppCycle(alerter);
+    }
+    alerter.wpTurnedOn();       // after only 7.5 minutes of PP
+    alerter.wpTurnedOff(30.0f);
+    const std::vector<ParticleHost::PublishRecord> &published = ParticleHost::published();
+    check(published.size() == 2 && published[0].name == "wsmAlertWPOnTooSoon" && published[1].name == "wsmAlertWPFreeze" &&
+          published[1].data.find("\"msg\":\"WP came on at 30.5 degrees F.\"") != std::string::npos,
+          "WP on too soon, then the freeze alert");
+    takeAlerts();
+    alerter.wpTurnedOn();
+    check(takeAlerts().empty() && alerter.get_alertCount() == 4, "each held off for a day");
+
+    // a site rule sharing the PP run time alerts' counter; priority orders it after them
+    const WSMAlertRule PP_SLOW = {"wsmAlertPPSlow", ALERT_ON_PP_OFF, MEASURE_PP_RUN_TIME, ALERT_ABOVE, 2.0f, 48,
+                                  ALERT_HOLDOFF_PP, 9, 6, "PP on for ", " minutes, slower than usual."};
+    WSMAlertProcessor shared;
+    shared.addRule(PP_SLOW);
+    ParticleHost::reset();
+    shared.begin();
+    shared.ppTurnedOn();
+    shared.ppTurnedOff(2.5f);
+    shared.ppTurnedOn();
+    shared.ppTurnedOff(3.5f);
+    alerts = takeAlerts();
+    check(alerts.size() == 1 && alerts[0] == "wsmAlertPPSlow", "a shared counter: the site rule alerts");
+    for(int tick = 0; tick < 48; tick++) {
+        shared.halfHourTimeTick();
+    }
+    takeAlerts();   // PP did not run
+    shared.ppTurnedOn();
+    shared.ppTurnedOff(3.5f);
+    alerts = takeAlerts();
+    check(alerts.size() == 1 && alerts[0] == "wsmAlertPPOnTooLong", "and the fixed rule first holds it off");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+/***************************************************************************************************/
+// AlertStateTest.cpp
+//  Checks that the alert state survives a restart: WSMStateStore's slots (round trip, versions,
+//  only changed bytes written, a power loss at every byte of a save), that a WSMAlertProcessor
+//  restarted at every point of a stream of pump events raises exactly the alerts of one that ran
+//  through, and that a corrupted snapshot or a changed rule table falls back to the defaults.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "WSMAlertProcessor.h"
+#include "WSMStateStore.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+const int STATE_ADDRESS = 1024;
+
+static std::vector<uint8_t> readEEPROM() {
+    std::vector<uint8_t> bytes(EEPROM.length());
+    for(size_t i = 0; i < bytes.size(); i++) {
+        bytes[i] = EEPROM.read((int)i);
+    }
+    return bytes;
+}
+
+static void writeEEPROM(const std::vector<uint8_t> &bytes) {
+    for(size_t i = 0; i < bytes.size(); i++) {
+        EEPROM.write((int)i, bytes[i]);
+    }
+}
+
+struct TestState {
+    uint32_t counter;
+    float values[20];
+};
+
+static TestState testState(uint32_t n) {
+    TestState state;
+    state.counter = n;
+    for(int i = 0; i < 20; i++) {
+        state.values[i] = (float)(n * 100 + (i < 3 ? i : 0));   // a few bytes change per save
+    }
+    return state;
+}
+
+static void testStore() {
+    ParticleHost::reset();
+    WSMStateStore store(STATE_ADDRESS, sizeof(TestState), 3);
+    TestState state = testState(99);
+    check(!store.load(&state) && state.counter == 99, "erased EEPROM: nothing to load");
+
+    bool same = true;
+    unsigned int written = 0;
+    for(uint32_t n = 0; n < 600; n++) {     // the sequence number wraps
+        TestState saved = testState(n);
+        written = store.save(&saved);
+        WSMStateStore reader(STATE_ADDRESS, sizeof(TestState), 3);
+        same = same && reader.load(&state) && memcmp(&state, &saved, sizeof(state)) == 0;
+    }
+    check(same, "the newest snapshot loads, across the sequence number wrap");
+    check(written < sizeof(TestState) / 2, "only the changed bytes are written");
+    printf("  %u of %zu bytes written by a save\n", written, STATE_HEADER_SIZE + sizeof(TestState));
+
+    WSMStateStore other(STATE_ADDRESS, sizeof(TestState), 4);
+    WSMStateStore longer(STATE_ADDRESS, sizeof(TestState) + 4, 3);
+    uint8_t big[sizeof(TestState) + 4];
+    check(!other.load(&state) && !longer.load(big), "a snapshot of another version or size is not loaded");
+    check(WSMStateStore().save(&state) == 0 && !WSMStateStore().load(&state), "no address, nothing kept");
+
+    // a power loss at every byte of a save: the bytes are written in order, so the EEPROM holds
+    //  the first k of them; the load is the snapshot before, or the new one once it is all there
+    TestState before = testState(1000), after = testState(1001);
+    WSMStateStore writer(STATE_ADDRESS, sizeof(TestState), 3);
+    writer.load(&state);
+    writer.save(&before);
+    std::vector<uint8_t> old = readEEPROM();
+    writer.save(&after);
+    std::vector<uint8_t> updated = readEEPROM();
+    std::vector<size_t> changed;
+    for(size_t i = 0; i < old.size(); i++) {
+        if(old[i] != updated[i]) {
+            changed.push_back(i);
+        }
+    }
+    bool recovered = true;
+    for(size_t k = 0; k <= changed.size(); k++) {
+        std::vector<uint8_t> cut = old;
+        for(size_t i = 0; i < k; i++) {
+            cut[changed[i]] = updated[changed[i]];
+        }
+        writeEEPROM(cut);
+        WSMStateStore reader(STATE_ADDRESS, sizeof(TestState), 3);
+        const TestState &expected = k == changed.size() ? after : before;
+        recovered = recovered && reader.load(&state) && memcmp(&state, &expected, sizeof(state)) == 0;
+    }
+    check(recovered, "a save cut short loads the snapshot before it");
+}
+
+// a stream of pump events over three days: normal cycles, long and short runs, a WP that does not
+//  come on, a day with the PP off and an hour of short cycling
+struct PumpEvent {
+    time_t time;
+    int kind;       // 0 tick, 1 PP on, 2 PP off, 3 WP on, 4 WP off
+    float runTime;
+};
+
+static std::vector<PumpEvent> pumpEvents() {
+    std::mt19937 random(17);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<PumpEvent> events;
+    time_t start = 1767225600;
+    int ppCycles = 0;
+    for(time_t t = start; t < start + 3 * 86400; t += 300) {
+        if((t - start) % 1800 == 0) {
+            events.push_back(PumpEvent{t, 0, 0.0f});
+        }
+        bool off = t >= start + 36000 && t < start + 36000 + 86400 + 3600;    // PP does not run
+        bool cycling = t >= start + 2 * 86400 + 36000 && t < start + 2 * 86400 + 36000 + 3600;
+        if(!off && (cycling || (t - start) % 2400 == 0)) {
+            float run = uniform(random) < 0.05f ? 3.5f : 0.6f + uniform(random);
+            events.push_back(PumpEvent{t, 1, 0.0f});
+            events.push_back(PumpEvent{t + 60, 2, run});
+            if(++ppCycles % 6 == 0 && t < start + 36000) {    // the first 10 hours only: then #5
+                events.push_back(PumpEvent{t + 120, 3, 0.0f});
+                events.push_back(PumpEvent{t + 1800, 4, ppCycles % 12 == 0 ? 45.0f : 30.0f});
+            }
+        }
+    }
+    return events;
+}
+
+static void apply(WSMAlertProcessor &alerter, const PumpEvent &event) {
+    ParticleHost::setUnixTime(event.time);
+    switch(event.kind) {
+        case 0: alerter.halfHourTimeTick(); break;
+        case 1: alerter.ppTurnedOn(); break;
+        case 2: alerter.ppTurnedOff(event.runTime); break;
+        case 3: alerter.wpTurnedOn(); break;
+        default: alerter.wpTurnedOff(event.runTime); break;
+    }
+}
+
+static WSMAlertLimits siteLimits() {
+    WSMAlertLimits limits;
+    limits.ppCycles10Minutes = 6;
+    limits.ppCyclesHour = 10;
+    return limits;
+}
+
+const WSMAlertRule PP_LONG_DAY = {"wsmAlertPPBusyDay", ALERT_ON_PP_ON, MEASURE_PP_CYCLES_DAY, ALERT_ABOVE, 20.0f, 96,
+                                  ALERT_OWN_HOLDOFF, 0, 0, "PP came on ", " times in a day."};
+
+// the alerts published, and the state at the end
+static std::string alertsAndState(WSMAlertProcessor &alerter, const std::vector<ParticleHost::PublishRecord> &published) {
+    std::string result;
+    for(const ParticleHost::PublishRecord &record : published) {
+        result += record.name + " " + record.data + "\n";
+    }
+    char state[200];
+    snprintf(state, sizeof(state), "%a %u %u %u %u %u %u %u %u\n", alerter.get_ppAccumulatedOnTime(),
+             alerter.get_timeBetweenPPevents(), alerter.get_ppAlertHoldoff(), alerter.get_wpAlertHoldoff(),
+             alerter.get_interPumpAlertHoldoff(), alerter.get_ppNotRunAlertHoldoff(), alerter.get_shortCycleHoldoff(),
+             alerter.get_ppCycles().count(CYCLES_DAY, Time.now()), alerter.get_wpCycles().count(CYCLES_DAY, Time.now()));
+    return result + state;
+}
+
+static void testRestart() {
+    std::vector<PumpEvent> events = pumpEvents();
+
+    // run through, without a restart
+    ParticleHost::reset();
+    WSMAlertProcessor through(siteLimits());
+    through.addRule(PP_LONG_DAY);
+    through.begin();
+    for(const PumpEvent &event : events) {
+        apply(through, event);
+    }
+    std::string expected = alertsAndState(through, ParticleHost::published());
+    printf("  %zu events, %u alerts\n", events.size(), through.get_alertCount());
+
+    // restarted after each event
+    bool same = true, restored = true;
+    size_t firstDifferent = 0;
+    for(size_t crash = 0; crash <= events.size() && same; crash++) {
+        ParticleHost::reset();
+        {
+            WSMAlertProcessor first(siteLimits());
+            first.addRule(PP_LONG_DAY);
+            first.persist(STATE_ADDRESS);
+            first.begin();
+            restored = restored && !first.get_restored();
+            for(size_t i = 0; i < crash; i++) {
+                apply(first, events[i]);
+            }
+        }
+        WSMAlertProcessor second(siteLimits());
+        second.addRule(PP_LONG_DAY);
+        second.persist(STATE_ADDRESS);
+        second.begin();
+        restored = restored && second.get_restored() == (crash > 0);
+        for(size_t i = crash; i < events.size(); i++) {
+            apply(second, events[i]);
+        }
+        same = alertsAndState(second, ParticleHost::published()) == expected;
+        firstDifferent = crash;
+    }
+    if(!same) {
+        printf("  differs after a restart at event %zu\n", firstDifferent);
+    }
+    check(restored, "begin() restores the snapshot, and only when there is one");
+    check(same, "a restart at every event raises the alerts of a run without one");
+    const char *const KINDS[] = {"wsmAlertPPOnTooLong", "wsmAlertWPOnTooLong", "wsmAlertWPNotComeOn", "wsmAlertWPOnTooSoon",
+                                 "wsmAlertPPNotRun", "wsmAlertPPShortCycling", "wsmAlertPPBusyDay"};
+    bool all = true;
+    for(const char *kind : KINDS) {
+        all = all && expected.find(std::string(kind) + " ") != std::string::npos;
+    }
+    check(all, "and the stream raises alerts of each kind");
+}
+
+static void testFallback() {
+    std::vector<PumpEvent> events = pumpEvents();
+    ParticleHost::reset();
+    WSMAlertProcessor first(siteLimits());
+    first.addRule(PP_LONG_DAY);
+    first.persist(STATE_ADDRESS);
+    first.begin();
+    for(size_t i = 0; i < events.size() / 5; i++) {
+        apply(first, events[i]);
+    }
+    check(first.get_ppAlertHoldoff() < 48, "a PP alert is being held off");
+    uint64_t writes = 0;
+    for(int i = 0; i < ALERT_STATE_EEPROM_SIZE; i++) {
+        writes += ParticleHost::eepromWrites(STATE_ADDRESS + i);
+    }
+    printf("  %.1f EEPROM bytes written per event\n", (double)writes / (double)(events.size() / 5));
+    std::vector<uint8_t> saved = readEEPROM();
+
+    // a new site rule: the fixed holdoffs are restored, the site rule's starts ready to alert
+    WSMAlertProcessor changed(siteLimits());
+    changed.addRule(PP_LONG_DAY);
+    changed.addRule(PP_LONG_DAY);
+    changed.persist(STATE_ADDRESS);
+    changed.begin();
+    check(changed.get_restored() && changed.get_ppAlertHoldoff() == first.get_ppAlertHoldoff() &&
+          changed.get_ppAccumulatedOnTime() == first.get_ppAccumulatedOnTime(), "a changed rule table keeps the fixed state");
+
+    // both slots corrupted: the defaults
+    writeEEPROM(saved);
+    EEPROM.write(STATE_ADDRESS + STATE_HEADER_SIZE + 5, (uint8_t)~EEPROM.read(STATE_ADDRESS + STATE_HEADER_SIZE + 5));
+    int other = STATE_ADDRESS + ALERT_STATE_EEPROM_SIZE / 2;
+    EEPROM.write(other + STATE_HEADER_SIZE + 5, (uint8_t)~EEPROM.read(other + STATE_HEADER_SIZE + 5));
+    WSMAlertProcessor corrupted(siteLimits());
+    corrupted.addRule(PP_LONG_DAY);
+    corrupted.persist(STATE_ADDRESS);
+    corrupted.begin();
+    check(!corrupted.get_restored() && corrupted.get_ppAlertHoldoff() == 48 && corrupted.get_ppAccumulatedOnTime() == 0.0f,
+          "a corrupted snapshot falls back to the defaults");
+    check(STATE_ADDRESS + ALERT_STATE_EEPROM_SIZE <= (int)EEPROM.length(), "the state fits after the journal");
+    printf("  ALERT_STATE_EEPROM_SIZE %d bytes\n", ALERT_STATE_EEPROM_SIZE);
+}
+
+int main() {
+    testStore();
+    testRestart();
+    testFallback();
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
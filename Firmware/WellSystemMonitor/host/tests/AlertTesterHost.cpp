@@ -0,0 +1,110 @@
+/***************************************************************************************************/
+// AlertTesterHost.cpp
+//  Runs the unmodified AlertTester sketch (AlertTester/WSM_Alert_Dev.ino) against the host Device
+//  OS stand-in.  Each button press on D0 is scripted, the sketch's loop() is run in virtual time
+//  and the wsmAlert* publications are checked against what the serial monitor says to expect.
+//
+//  NOTE: test cases 4 to 6 use a PP run time of 0.49 minutes, which predates the 10/4/2024 change
+//  of PP_ON_TOO_SHORT_LIMIT to 0.3 minutes, so they no longer produce alerts.  A 0.29 minute run
+//  is checked separately at the end.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "WSMAlertProcessor.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// from the test sketch
+void setup();
+void loop();
+extern WSMAlertProcessor alerter;
+
+const uint16_t BUTTON_PIN = D0;
+const int NUM_TEST_CASES = 21;
+
+// the alert each test case should publish, or nullptr if the holdoff (or limit) suppresses it
+static const char *const EXPECTED_ALERT[NUM_TEST_CASES + 1] = {
+    nullptr,
+    "wsmAlertPPOnTooLong", nullptr, "wsmAlertPPOnTooLong",          // tests 1 - 3
+    nullptr, nullptr, nullptr,                                      // tests 4 - 6
+    "wsmAlertWPOnTooLong", nullptr, "wsmAlertWPOnTooLong",          // tests 7 - 9
+    "wsmAlertWPOnTooShort", nullptr, "wsmAlertWPOnTooShort",        // tests 10 - 12
+    "wsmAlertWPNotComeOn", nullptr, "wsmAlertWPNotComeOn",          // tests 13 - 15
+    "wsmAlertWPOnTooSoon", nullptr, "wsmAlertWPOnTooSoon",          // tests 16 - 18
+    "wsmAlertPPNotRun", nullptr, "wsmAlertPPNotRun"                 // tests 19 - 21
+};
+
+// run loop() once per millisecond of virtual time
+static void runLoop(unsigned int ms) {
+    for(unsigned int i = 0; i < ms; i++) {
+        loop();
+        ParticleHost::advanceMillis(1);
+    }
+}
+
+// press and release the test button, return the publications it caused
+static std::vector<ParticleHost::PublishRecord> pressButton() {
+    ParticleHost::clearPublished();
+    ParticleHost::setPin(BUTTON_PIN, LOW);
+    runLoop(50);
+    ParticleHost::setPin(BUTTON_PIN, HIGH);
+    runLoop(50);
+    return ParticleHost::published();
+}
+
+int main() {
+    int failures = 0;
+
+    ParticleHost::reset();
+    ParticleHost::setUnixTime(1664279461);
+    setup();
+
+    for(int testCase = 1; testCase <= NUM_TEST_CASES; testCase++) {
+        std::vector<ParticleHost::PublishRecord> published = pressButton();
+        const char *expected = EXPECTED_ALERT[testCase];
+
+        bool pass;
+        if(expected == nullptr) {
+            pass = published.empty();
+        } else {
+            pass = published.size() == 1 && published[0].name == expected &&
+                   published[0].data.find("\"etime\":") != std::string::npos;
+        }
+
+        printf("Test %2d: expected %-22s got", testCase, expected ? expected : "no alert");
+        for(const ParticleHost::PublishRecord &record : published) {
+            printf(" %s %s", record.name.c_str(), record.data.c_str());
+        }
+        printf("%s %s\n", published.empty() ? " no alert" : "", pass ? "PASS" : "FAIL");
+        if(!pass) {
+            failures++;
+        }
+    }
+
+    // one more press runs off the end of the test list
+    if(!pressButton().empty() ||
+       ParticleHost::serialOutput().find("No more test cases") == std::string::npos) {
+        printf("Test 22: expected end of tests FAIL\n");
+        failures++;
+    }
+
+    // PP on too short at the current 0.3 minute limit
+    ParticleHost::clearPublished();
+    alerter.ppTurnedOn();
+    alerter.ppTurnedOff(0.29);
+    const std::vector<ParticleHost::PublishRecord> &tooShort = ParticleHost::published();
+    bool pass = tooShort.size() == 1 && tooShort[0].name == "wsmAlertPPOnTooShort";
+    printf("PP on too short at 0.29 minutes: %s\n", pass ? "PASS" : "FAIL");
+    if(!pass) {
+        failures++;
+    }
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+/***************************************************************************************************/
+// BaselineTest.cpp
+//  Checks the learned baselines (src/WSMBaseline.h) and the adaptive deviation alerts of
+//  WSMAlertProcessor: nothing is reported while learning or for a long run of normal values, the
+//  learned percentiles are near the true ones, a small and a large tank each get their own range,
+//  a drift is reported once and becomes the new normal; the alerts go out under their own one day
+//  holdoffs and are off by default; the time between PP cycles is not learned from a clock the
+//  cloud has not set, or past the PP not run window; and the recorded history raises them ahead
+//  of its incident.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "HistoryReplay.h"
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "WSMAlertProcessor.h"
+#include "WSMBaseline.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+static const float SIGMAS = 4.0f;
+
+// learn count values; the verdicts other than learning and normal
+static unsigned int learn(WSMBaseline &baseline, std::normal_distribution<float> values, std::mt19937 &random,
+                          unsigned int count) {
+    unsigned int reported = 0;
+    for(unsigned int i = 0; i < count; i++) {
+        WSMBaselineVerdict verdict = baseline.add(values(random), SIGMAS);
+        reported += verdict == BASELINE_LEARNING || verdict == BASELINE_NORMAL ? 0 : 1;
+    }
+    return reported;
+}
+
+static unsigned int countAlerts(const char *name) {
+    unsigned int count = 0;
+    for(const ParticleHost::PublishRecord &record : ParticleHost::published()) {
+        count += record.name == name ? 1 : 0;
+    }
+    return count;
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "data/WSMDataHistory.csv";
+    std::mt19937 random(14);
+
+    // nothing while learning, however odd the values
+    WSMBaseline baseline;
+    unsigned int reported = 0;
+    for(unsigned int i = 0; i < BASELINE_WARMUP; i++) {
+        reported += baseline.add(i % 7 == 0 ? 50.0f : 1.0f, SIGMAS) != BASELINE_LEARNING ? 1 : 0;
+    }
+    check(reported == 0 && baseline.count() == BASELINE_WARMUP, "nothing reported while learning");
+
+    // a long run of normal values: nothing reported, and the percentiles, which wander by a few
+    // hundredths, near the true ones on average
+    std::normal_distribution<float> pp(1.4f, 0.15f);
+    baseline.begin();
+    reported = learn(baseline, pp, random, 10000);
+    double lowSum = 0.0, highSum = 0.0;
+    for(int i = 0; i < 1900; i++) {
+        reported += learn(baseline, pp, random, 100);
+        lowSum += baseline.low();
+        highSum += baseline.high();
+    }
+    printf("mean %.3f deviation %.3f low %.3f high %.3f limits %.3f to %.3f\n", baseline.mean(), baseline.deviation(),
+           lowSum / 1900, highSum / 1900, baseline.lowLimit(), baseline.highLimit());
+    check(reported == 0, "200000 normal values, nothing reported");
+    check(std::fabs(lowSum / 1900 - (1.4 - 2.326 * 0.15)) < 0.01 && std::fabs(highSum / 1900 - (1.4 + 2.326 * 0.15)) < 0.01,
+          "1st and 99th percentiles learned");
+
+    // a small and a large tank: the same run time is normal for one and short for the other
+    WSMBaseline smallTank, largeTank;
+    learn(smallTank, std::normal_distribution<float>(0.45f, 0.03f), random, 500);
+    learn(largeTank, std::normal_distribution<float>(1.8f, 0.06f), random, 500);
+    check(smallTank.add(0.5f, SIGMAS) == BASELINE_NORMAL && largeTank.add(0.9f, SIGMAS) == BASELINE_LOW &&
+          smallTank.add(1.4f, SIGMAS) == BASELINE_HIGH && largeTank.add(2.2f, SIGMAS) == BASELINE_NORMAL,
+          "each tank its own range");
+
+    // a lasting shift of a deviation and a half: reported once, soon, then the new normal
+    baseline.begin();
+    learn(baseline, pp, random, 1000);
+    std::normal_distribution<float> shifted(1.625f, 0.15f);
+    unsigned int firstDrift = 0, drifts = 0;
+    for(unsigned int i = 1; i <= 2000; i++) {
+        WSMBaselineVerdict verdict = baseline.add(shifted(random), SIGMAS);
+        if(verdict == BASELINE_DRIFT_UP) {
+            drifts++;
+            firstDrift = firstDrift == 0 ? i : firstDrift;
+        }
+    }
+    printf("drift reported after %u values; baseline now %.3f\n", firstDrift, baseline.mean());
+    check(drifts == 1 && firstDrift > 0 && firstDrift <= 30, "a drift reported once, within 30 values");
+    check(std::fabs(baseline.mean() - 1.625f) < 0.03f && learn(baseline, shifted, random, 20000) == 0,
+          "then the new normal");
+
+    // the alert processor: WP cycles of 30 minutes after every 8 PP cycles of 2 minutes, 40 minutes
+    // apart; then a 1 minute PP run, which is inside the fixed limits
+    WSMAlertLimits limits;
+    limits.deviationSigmas = SIGMAS;
+    WSMAlertProcessor alerter(limits);
+    ParticleHost::reset();
+    ParticleHost::setUnixTime(1767225600);
+    alerter.begin();
+    std::normal_distribution<float> runs(2.0f, 0.05f);
+    for(int i = 1; i <= 400; i++) {
+        ParticleHost::setUnixTime(Time.now() + 2400);
+        alerter.ppTurnedOn();
+        alerter.ppTurnedOff(runs(random));
+        if(i % 8 == 0) {
+            alerter.wpTurnedOn();
+            alerter.wpTurnedOff(30.0f);
+        }
+    }
+    check(ParticleHost::published().empty() && alerter.get_ppRunBaseline().count() == 400 &&
+          alerter.get_ppIntervalBaseline().count() == 399 && alerter.get_wpRunBaseline().count() == 50 &&
+          alerter.get_ppPerWpBaseline().count() == 50, "learned without alerts");
+    ParticleHost::setUnixTime(Time.now() + 2400);
+    alerter.ppTurnedOn();
+    alerter.ppTurnedOff(1.0f);
+    const std::vector<ParticleHost::PublishRecord> &published = ParticleHost::published();
+    if(!published.empty()) {
+        printf("%s %s\n", published.back().name.c_str(), published.back().data.c_str());
+    }
+    check(countAlerts("wsmAlertPPDeviation") == 1 && alerter.get_alertCount() == 1 &&
+          published.back().data.find("PP run time of 1.000000 minutes is below the learned range.") != std::string::npos,
+          "a short PP run raises wsmAlertPPDeviation");
+    for(int i = 0; i < 4; i++) {       // and the cycles come much closer together
+        ParticleHost::setUnixTime(Time.now() + 120);
+        alerter.ppTurnedOn();
+        alerter.ppTurnedOff(1.0f);
+    }
+    check(countAlerts("wsmAlertPPDeviation") == 1 && alerter.get_ppDeviationHoldoff() == 0, "held off for a day");
+    for(unsigned int tick = 0; tick < limits.oneDay; tick++) {
+        alerter.halfHourTimeTick();
+    }
+    ParticleHost::setUnixTime(Time.now() + 120);
+    alerter.ppTurnedOn();
+    alerter.ppTurnedOff(0.9f);
+    check(countAlerts("wsmAlertPPDeviation") == 2 && alerter.get_wpDeviationHoldoff() == limits.oneDay,
+          "again after the holdoff; the WP holdoff is separate");
+
+    // the PP cycle interval is only learned on a clock the cloud has set, and not past the PP not
+    // run window: after a power loss the clock reads 1970 until it is set
+    WSMAlertProcessor unset(limits);
+    ParticleHost::reset();
+    unset.begin();
+    ParticleHost::setTimeValid(false);
+    ParticleHost::setUnixTime(3600);
+    for(int i = 0; i < 3; i++) {
+        ParticleHost::setUnixTime(Time.now() + 2400);
+        unset.ppTurnedOn();
+        unset.ppTurnedOff(2.0f);
+    }
+    ParticleHost::setTimeValid(true);
+    ParticleHost::setUnixTime(1767225600);
+    for(int i = 0; i < 3; i++) {
+        ParticleHost::setUnixTime(Time.now() + 2400);
+        unset.ppTurnedOn();
+        unset.ppTurnedOff(2.0f);
+    }
+    unsigned int before = unset.get_ppIntervalBaseline().count();
+    ParticleHost::setUnixTime(Time.now() + (time_t)limits.oneDay * 1800 + 60);
+    unset.ppTurnedOn();
+    unset.ppTurnedOff(2.0f);
+    check(before == 2 && unset.get_ppIntervalBaseline().count() == 2 &&
+          std::fabs(unset.get_ppIntervalBaseline().mean() - 40.0f) < 0.01f,
+          "cycle interval learned only on a set clock, within the PP not run window");
+
+    // off by default: nothing learned, nothing raised
+    WSMAlertProcessor fixedOnly;
+    ParticleHost::reset();
+    fixedOnly.begin();
+    for(int i = 1; i <= 400; i++) {
+        ParticleHost::setUnixTime(Time.now() + 2400);
+        fixedOnly.ppTurnedOn();
+        fixedOnly.ppTurnedOff(2.0f);
+        if(i % 8 == 0) {
+            fixedOnly.wpTurnedOn();
+            fixedOnly.wpTurnedOff(30.0f);
+        }
+    }
+    fixedOnly.ppTurnedOn();
+    fixedOnly.ppTurnedOff(1.0f);
+    check(ParticleHost::published().empty() && fixedOnly.get_ppRunBaseline().count() == 0, "off by default");
+
+    // the recorded history: the four fixed alerts, and PP drifts ahead of the August incident
+    WSMDataReader reader;
+    if(!reader.open(path)) {
+        check(false, "open the recorded history");
+    } else {
+        HistoryReplay replay(limits);
+        std::vector<ReplayAlert> alerts;
+        replay.run(reader, [&](const ReplayAlert &alert) {
+            printf("  line %llu %s %s\n", (unsigned long long)alert.lineNumber, alert.name.c_str(), alert.data.c_str());
+            alerts.push_back(alert);
+        });
+        unsigned int fixed = 0, deviations = 0;
+        uint64_t firstDeviationLine = 0;
+        for(const ReplayAlert &alert : alerts) {
+            if(alert.name == "wsmAlertPPDeviation" || alert.name == "wsmAlertWPDeviation") {
+                deviations++;
+                firstDeviationLine = firstDeviationLine == 0 ? alert.lineNumber : firstDeviationLine;
+            } else {
+                fixed++;
+            }
+        }
+        check(fixed == 4 && deviations > 0 && deviations <= 3 && firstDeviationLine < 629,
+              "recorded history: the fixed alerts, and deviations before the second WP on too long");
+    }
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+/***************************************************************************************************/
+// BootSequenceTest.cpp
+//  Checks WSMBootSequence (each phase once and in order, the BootTimes JSON) and then boots the
+//  WellSystemMonitor sketch with the cloud away: setup() returns without waiting, a pressure pump
+//  change during the restart indicator is in the first sensor reports, the indicator goes on, off
+//  and on again from the scheduler, and System Restart is published only once the cloud is back.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "application.h"
+#include <WSMBootSequence.h>
+#include <JSONWriter.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// from the sketch
+void setup();
+void loop();
+
+const uint16_t PRESSURE_PUMP_SENSOR_PIN = A1;
+const uint16_t INDICATOR_PIN = D5;
+const uint64_t LOOP_PERIOD_MS = 10;
+
+// run loop() every LOOP_PERIOD_MS of virtual time until the given uptime
+static void runTo(uint64_t uptimeMs) {
+    while(ParticleHost::uptimeMillis() < uptimeMs) {
+        loop();
+        ParticleHost::advanceMillis(LOOP_PERIOD_MS);
+    }
+}
+
+// the number of publications with the given name and data
+static int countPublished(const char *name, const char *data) {
+    int count = 0;
+    for(const ParticleHost::PublishRecord &record : ParticleHost::published()) {
+        if(record.name == name && record.data.find(data) != std::string::npos) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void testSequence() {
+    WSMBootSequence boot;
+    char json[JSON_EVENT_SIZE];
+
+    boot.begin(12);
+    check(boot.phase() == BOOT_SETUP && boot.at(BOOT_SETUP) == 12, "setup phase");
+    boot.write(json, sizeof(json));
+    check(strcmp(json, "{\"setup\":12}") == 0, "setup phase JSON");
+
+    // the cloud is not looked at before the first sample, nor the publish before the cloud
+    check(!boot.cloudConnected(13, true), "cloud waits for the first sample");
+    boot.published(13);
+    check(boot.phase() == BOOT_SETUP, "publish waits for the cloud");
+
+    check(boot.sampled(14) && boot.phase() == BOOT_FIRST_SAMPLE, "first sample");
+    check(!boot.sampled(24) && boot.at(BOOT_FIRST_SAMPLE) == 14, "first sample only once");
+    check(!boot.cloudConnected(34, false), "cloud not connected");
+    check(boot.cloudConnected(2210, true) && boot.phase() == BOOT_CLOUD_CONNECTED, "cloud connected");
+    check(!boot.cloudConnected(2220, true) && boot.at(BOOT_CLOUD_CONNECTED) == 2210, "cloud connected only once");
+    boot.published(2211);
+    boot.published(2300);
+    check(boot.done() && boot.at(BOOT_FIRST_PUBLISH) == 2211, "first publish only once");
+
+    bool fits = boot.write(json, sizeof(json));
+    check(fits && strcmp(json, "{\"setup\":12,\"sample\":14,\"cloud\":2210,\"publish\":2211}") == 0, "BootTimes JSON");
+    check(!boot.write(json, 20), "BootTimes JSON overflow");
+
+    // a restart starts over
+    boot.begin(5);
+    check(boot.phase() == BOOT_SETUP && boot.at(BOOT_CLOUD_CONNECTED) == 0, "begin() starts over");
+}
+
+static void testSketch() {
+    ParticleHost::reset();
+    ParticleHost::setUnixTime(1664279461);
+    ParticleHost::setDHTReading(17.0, 60.0);
+    ParticleHost::setCloudConnected(false);
+
+    // the pressure pump comes on 100 ms into the boot
+    ParticleHost::schedulePin(100, PRESSURE_PUMP_SENSOR_PIN, LOW);
+
+    setup();
+    check(ParticleHost::uptimeMillis() == 0, "setup() does not wait");
+    check(ParticleHost::outputLevel(INDICATOR_PIN) == HIGH, "indicator on at the restart");
+    check(ParticleHost::variable("BootTimes") == "{\"setup\":0}", "BootTimes after setup()");
+
+    runTo(LOOP_PERIOD_MS);
+    check(ParticleHost::variable("BootTimes") == "{\"setup\":0,\"sample\":0}", "inputs sampled on the first pass");
+    check(ParticleHost::variable("SensorReport").find("\"PressurePump\":0") != std::string::npos,
+          "sensor report on the first pass");
+
+    // the pump change is reported once it has held for the debounce delay, during the indicator's
+    // off time, which setup() used to spend in delay()
+    runTo(700);
+    check(ParticleHost::outputLevel(INDICATOR_PIN) == LOW, "indicator off at 600 ms");
+    runTo(1200);
+    check(ParticleHost::variable("SensorReport").find("\"PressurePump\":1") != std::string::npos,
+          "pump change during the boot reported");
+    check(ParticleHost::outputLevel(INDICATOR_PIN) == LOW, "indicator still off");
+    runTo(1810);
+    check(ParticleHost::outputLevel(INDICATOR_PIN) == HIGH, "indicator on at 1800 ms");
+
+    // the cloud is away: the indicator flashes and the restart report waits
+    bool flashed = false;
+    while(ParticleHost::uptimeMillis() < 5000) {
+        runTo(ParticleHost::uptimeMillis() + LOOP_PERIOD_MS);
+        flashed = flashed || ParticleHost::outputLevel(INDICATOR_PIN) == LOW;
+    }
+    check(flashed, "indicator flashes while the cloud is away");
+    check(countPublished("WSM", "System Restart") == 0, "restart report waits for the cloud");
+    check(ParticleHost::variable("BootTimes") == "{\"setup\":0,\"sample\":0}", "BootTimes while the cloud is away");
+
+    ParticleHost::setCloudConnected(true);
+    runTo(8000);
+    check(countPublished("WSM", "System Restart") == 1, "restart reported once the cloud is connected");
+    // the report is sent behind what the queue held through the outage, on its retry backoff
+    check(ParticleHost::variable("BootTimes") == "{\"setup\":0,\"sample\":0,\"cloud\":5000,\"publish\":7060}",
+          "BootTimes once the restart report has been sent");
+    check(ParticleHost::outputLevel(INDICATOR_PIN) == HIGH, "indicator on with the cloud connected");
+
+    // a later outage does not report the restart again
+    ParticleHost::setCloudConnected(false);
+    runTo(10000);
+    ParticleHost::setCloudConnected(true);
+    runTo(12000);
+    check(countPublished("WSM", "System Restart") == 1, "restart reported only once");
+}
+
+int main() {
+    testSequence();
+    testSketch();
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
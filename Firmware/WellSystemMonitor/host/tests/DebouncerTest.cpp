@@ -0,0 +1,117 @@
+/***************************************************************************************************/
+// DebouncerTest.cpp
+//  Checks the table driven debouncer (src/WSMDebouncer.h): on random bouncing inputs, at random
+//  loop() periods and across the millis() rollover, every channel changes on the same passes and
+//  to the same values as one readPinDebounced() per pin did; channels that change together are
+//  reported in one mask; the table is limited to 64 channels and begin() starts it again.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "WSMDebouncer.h"
+#include "application.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// the sketch's ty_debouncePin and readPinDebounced(), as the reference
+struct DebouncePin {
+    unsigned int pinNumber;
+    bool value;
+    bool lastReadValue;
+    system_tick_t beginTime;
+    system_tick_t debounceDelay;
+};
+
+static bool readPinDebounced(DebouncePin *pin) {
+    bool stateChanged = false;
+    bool currentReadValue = digitalRead(pin->pinNumber) != 0;
+    system_tick_t timeNow = millis();
+    if(currentReadValue != pin->lastReadValue) {
+        pin->beginTime = timeNow;
+        pin->lastReadValue = currentReadValue;
+    } else if(timeNow - pin->beginTime > pin->debounceDelay && pin->value != currentReadValue) {
+        pin->value = currentReadValue;
+        stateChanged = true;
+    }
+    return stateChanged;
+}
+
+int main() {
+    // 24 channels, one on each host pin, with assorted delays and starting values
+    std::mt19937 random(11);
+    std::vector<WSMDebounceChannel> table;
+    std::vector<DebouncePin> pins;
+    for(uint16_t pin = 0; pin < TOTAL_PINS; pin++) {
+        system_tick_t delay = (system_tick_t)(pin * 37 % 1000 + 20);
+        bool value = pin % 3 == 0;
+        table.push_back(WSMDebounceChannel{pin, value, delay});
+        pins.push_back(DebouncePin{pin, value, value, 0, delay});
+    }
+    WSMDebouncer debouncer(table.data(), (unsigned int)table.size());
+    check(debouncer.channels() == TOTAL_PINS, "24 channels");
+
+    ParticleHost::reset();
+    ParticleHost::setMillisOffset(0xFFFFFFFFu - 60000u);     // the rollover a minute in
+    debouncer.begin();
+    std::uniform_int_distribution<uint32_t> loopMs(1, 120);
+    std::uniform_int_distribution<uint32_t> anyPin(0, TOTAL_PINS - 1);
+    std::uniform_int_distribution<uint32_t> percent(0, 99);
+    bool same = true;
+    uint64_t changes = 0, multiple = 0;
+    for(uint32_t pass = 0; pass < 200000 && same; pass++) {
+        // bursts of bounce on a few pins, then quiet
+        if(percent(random) < ((pass / 500) % 2 ? 30 : 2)) {
+            ParticleHost::setPin((uint16_t)anyPin(random), percent(random) < 50 ? HIGH : LOW);
+        }
+        WSMChannelMask changed = debouncer.sample();
+        WSMChannelMask expected = 0;
+        for(size_t i = 0; i < pins.size(); i++) {
+            if(readPinDebounced(&pins[i])) {
+                expected |= WSMDebouncer::bit((unsigned int)i);
+            }
+            same = same && debouncer.value((unsigned int)i) == pins[i].value;
+        }
+        same = same && changed == expected;
+        changes += (uint64_t)__builtin_popcountll(changed);
+        multiple += __builtin_popcountll(changed) > 1 ? 1 : 0;
+        ParticleHost::advanceMillis(loopMs(random));
+    }
+    printf("%llu changes, %llu passes with more than one\n", (unsigned long long)changes, (unsigned long long)multiple);
+    check(same && changes > 1000 && multiple > 0, "same changes as readPinDebounced() on every pass");
+
+    // two channels that settle on the same pass come back in one mask
+    const WSMDebounceChannel PAIR[] = {{D3, true, 50}, {D6, true, 50}, {D7, true, 50}};
+    WSMDebouncer pair(PAIR, 3);
+    ParticleHost::reset();
+    pair.begin();
+    pair.sample();
+    ParticleHost::setPin(D3, LOW);
+    ParticleHost::setPin(D7, LOW);
+    pair.sample();
+    ParticleHost::advanceMillis(50);
+    check(pair.sample() == 0, "not before the debounce delay");
+    ParticleHost::advanceMillis(1);
+    WSMChannelMask changed = pair.sample();
+    check(changed == (WSMDebouncer::bit(0) | WSMDebouncer::bit(2)) && pair.values() == WSMDebouncer::bit(1),
+          "both changes in one mask");
+    check(pair.sample() == 0, "reported once");
+    pair.begin();
+    check(pair.values() == 7, "begin() restores the table values");
+
+    // at most 64 channels
+    std::vector<WSMDebounceChannel> many(70, WSMDebounceChannel{D3, true, 10});
+    WSMDebouncer full(many.data(), (unsigned int)many.size());
+    ParticleHost::setPin(D3, LOW);
+    full.sample();
+    ParticleHost::advanceMillis(11);
+    check(full.channels() == DEBOUNCE_MAX_CHANNELS && full.sample() == ~(WSMChannelMask)0, "64 channels");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
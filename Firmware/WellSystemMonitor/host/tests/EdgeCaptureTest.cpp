@@ -0,0 +1,291 @@
+/***************************************************************************************************/
+// EdgeCaptureTest.cpp
+//  Checks the interrupt driven pump sensor capture (src/WSMEdgeCapture.h) with bouncing edge
+//  trains at microsecond times: changes are timestamped at the relay's first edge whatever the
+//  loop() period, glitches shorter than the debounce delay are ignored, an overrun ring and a lost
+//  EXTI line are recovered by reading the pin, and the sketch publishes ppon and wpon run times
+//  within a millisecond of the ground truth.  The old polled debouncer is run on the same trains
+//  for comparison.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "WSMEdgeCapture.h"
+#include "WSMWebhook.h"
+#include "application.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// from the sketch
+void setup();
+void loop();
+
+const uint16_t WELL_PUMP_SENSOR_PIN = A0;
+const uint16_t PRESSURE_PUMP_SENSOR_PIN = A1;
+const uint16_t DHT_PIN = D2;
+const uint16_t TEST_PIN = A2;               // a line of its own
+const system_tick_t DEBOUNCE_MS = 1000;
+
+static WSMEdgeCapture testCapture(TEST_PIN, true, DEBOUNCE_MS);
+static void testEdge() {
+    testCapture.capture();
+}
+
+static WSMEdgeCapture wellCapture(WELL_PUMP_SENSOR_PIN, true, DEBOUNCE_MS);
+static void wellEdge() {
+    wellCapture.capture();
+}
+
+// a relay contact that moves to level at uptimeUs, bouncing for up to bounceUs with an even number
+// of extra edges first; returns the first edge
+static uint64_t scheduleContact(std::mt19937 &random, uint16_t pin, uint64_t uptimeUs, uint8_t level,
+                                uint32_t bounceUs, unsigned int bounces) {
+    std::uniform_int_distribution<uint32_t> offset(1, bounceUs > 1 ? bounceUs - 1 : 1);
+    std::vector<uint32_t> offsets;
+    for(unsigned int i = 0; i < bounces * 2; i++) {
+        offsets.push_back(offset(random));
+    }
+    std::sort(offsets.begin(), offsets.end());
+    ParticleHost::schedulePinMicros(uptimeUs, pin, level);
+    uint8_t bounced = level;
+    for(uint32_t o : offsets) {
+        bounced = !bounced;
+        ParticleHost::schedulePinMicros(uptimeUs + o, pin, bounced);
+    }
+    if(bounces > 0) {
+        ParticleHost::schedulePinMicros(uptimeUs + bounceUs, pin, level);
+    }
+    return uptimeUs;
+}
+
+// the largest difference in ms between true run times and run times from the change times, as the
+// sketch works them out; -1 if there are changes missing
+static double runTimeError(const std::vector<uint64_t> &truth, const std::vector<system_tick_t> &times) {
+    if(times.size() != truth.size()) {
+        return -1.0;
+    }
+    double error = 0.0;
+    for(size_t i = 0; i + 1 < truth.size(); i += 2) {
+        double trueMs = (truth[i + 1] - truth[i]) / 1000.0;
+        error = std::max(error, std::fabs((double)(system_tick_t)(times[i + 1] - times[i]) - trueMs));
+    }
+    return error;
+}
+
+// readPinDebounced() as the sketch had it, for comparison
+struct PolledPin {
+    bool value = true;
+    bool lastReadValue = true;
+    system_tick_t beginTime = 0;
+
+    bool read(uint16_t pin) {
+        bool current = digitalRead(pin) != 0;
+        system_tick_t now = millis();
+        if(current != lastReadValue) {
+            beginTime = now;
+            lastReadValue = current;
+        } else if(now - beginTime > DEBOUNCE_MS && value != current) {
+            value = current;
+            return true;
+        }
+        return false;
+    }
+};
+
+// pump cycles on the test pin, with loop() every loopMs and now and then a pass that blocks
+// stallMs; returns the largest run time error in ms, or -1 if a change was missed, and the same for
+// the polled debouncer in polledError (a stall can hide a short cycle from it altogether)
+static double runCycles(unsigned int cycles, uint32_t loopMs, uint32_t stallMs, double &polledError,
+                        unsigned int &changes, unsigned int &polledChanges) {
+    std::mt19937 random(loopMs * 7919 + stallMs);
+    std::uniform_int_distribution<uint32_t> runMs(1500, 600000);
+    std::uniform_int_distribution<uint32_t> bounceUs(0, 20000);
+    std::uniform_int_distribution<unsigned int> bounces(0, 6);
+
+    ParticleHost::reset();
+    ParticleHost::setMillisOffset(0xFFFFFFFFu - 20 * 60000u);   // the rollover during the run
+    testCapture.begin(testEdge);
+    PolledPin polled;
+    polled.beginTime = millis();
+
+    // the contact edges, closed (LOW) then open, with their true times
+    std::vector<uint64_t> truth;
+    uint64_t t = 2000000;
+    for(unsigned int i = 0; i < cycles; i++) {
+        truth.push_back(scheduleContact(random, TEST_PIN, t, LOW, bounceUs(random), bounces(random)));
+        t += (uint64_t)runMs(random) * 1000 + random() % 1000;
+        truth.push_back(scheduleContact(random, TEST_PIN, t, HIGH, bounceUs(random), bounces(random)));
+        t += (uint64_t)runMs(random) * 1000 + random() % 1000;
+    }
+
+    std::vector<system_tick_t> captured, polledTimes;
+    uint64_t passes = 0;
+    while(ParticleHost::uptimeMicros() < t + 5000000) {
+        while(testCapture.changed()) {
+            captured.push_back(testCapture.changeMillis());
+        }
+        if(polled.read(TEST_PIN)) {
+            polledTimes.push_back(millis());
+        }
+        ParticleHost::advanceMillis(++passes % 97 == 0 ? stallMs : loopMs);
+    }
+    changes = (unsigned int)captured.size();
+    polledChanges = (unsigned int)polledTimes.size();
+    polledError = runTimeError(truth, polledTimes);
+    return runTimeError(truth, captured);
+}
+
+// the events the sketch published, with every pack split into its events
+static std::vector<ParticleHost::PublishRecord> publishedEvents() {
+    std::vector<ParticleHost::PublishRecord> events;
+    for(const ParticleHost::PublishRecord &record : ParticleHost::published()) {
+        expandBatch(record, [&](const ParticleHost::PublishRecord &event) { events.push_back(event); });
+    }
+    return events;
+}
+
+// pull a numeric field out of a flat JSON payload
+static double jsonNumber(const std::string &json, const char *key) {
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = json.find(pattern);
+    if(pos == std::string::npos) {
+        return -1.0;
+    }
+    return atof(json.c_str() + pos + pattern.size());
+}
+
+int main() {
+    // run times against the truth, for loop() periods from quick to very slow
+    const uint32_t LOOP_MS[] = {1, 10, 100, 250};
+    for(uint32_t loopMs : LOOP_MS) {
+        double polledError;
+        unsigned int changes, polledChanges;
+        double error = runCycles(40, loopMs, 3000, polledError, changes, polledChanges);
+        printf("loop every %u ms, 3 s stalls: captured %u changes, run time error %.3f ms; "
+               "polled %u changes, error %.3f ms\n", (unsigned int)loopMs, changes, error, polledChanges, polledError);
+        char what[80];
+        snprintf(what, sizeof(what), "run times to the millisecond with loop() every %u ms", (unsigned int)loopMs);
+        check(error >= 0.0 && error <= 1.0, what);
+    }
+    check(testCapture.get_overruns() == 0 && testCapture.get_resyncs() == 0 && testCapture.get_edges() > 80,
+          "every edge through the ring");
+
+    // a glitch shorter than the debounce delay is not a change, and a bounce back to the old
+    // level restarts the debounce
+    ParticleHost::reset();
+    testCapture.begin(testEdge);
+    ParticleHost::advanceMillis(5000);
+    ParticleHost::setPin(TEST_PIN, LOW);
+    ParticleHost::advanceMillis(900);
+    ParticleHost::setPin(TEST_PIN, HIGH);
+    ParticleHost::advanceMillis(5000);
+    check(!testCapture.changed() && testCapture.value(), "a 900 ms glitch is ignored");
+    ParticleHost::setPin(TEST_PIN, LOW);
+    ParticleHost::advanceMillis(999);
+    check(!testCapture.changed(), "not a change before the debounce delay");
+    ParticleHost::advanceMillis(1);
+    check(testCapture.changed() && !testCapture.value() && testCapture.changeMillis() == 10900 &&
+          !testCapture.changed(), "a change after the debounce delay, timed at its first edge");
+
+    // several changes in one late pass come out one at a time, in order
+    ParticleHost::schedulePin(20000, TEST_PIN, HIGH);
+    ParticleHost::schedulePin(23000, TEST_PIN, LOW);
+    ParticleHost::schedulePin(26500, TEST_PIN, HIGH);
+    ParticleHost::advanceMillis(30000);
+    std::vector<system_tick_t> times;
+    std::vector<bool> values;
+    while(testCapture.changed()) {
+        times.push_back(testCapture.changeMillis());
+        values.push_back(testCapture.value());
+    }
+    check(times == std::vector<system_tick_t>({20000, 23000, 26500}) &&
+          values == std::vector<bool>({true, false, true}), "three changes from one late pass");
+
+    // more edges than the ring holds: the overrun is counted and the pin read puts it right
+    ParticleHost::reset();
+    testCapture.begin(testEdge);
+    for(unsigned int i = 0; i < EDGE_CAPTURE_SIZE + 9; i++) {
+        ParticleHost::schedulePinMicros(1000000 + i * 100, TEST_PIN, i % 2 ? HIGH : LOW);
+    }
+    ParticleHost::advanceMillis(3000);
+    bool change = testCapture.changed();
+    check(!change && testCapture.get_overruns() == 9 && testCapture.get_resyncs() == 1, "overrun counted, pin read");
+    ParticleHost::advanceMillis(1000);
+    check(testCapture.changed() && !testCapture.value() && testCapture.changeMillis() == 3000,
+          "level right after an overrun, timed when it was found");
+
+    // D2 takes the EXTI line from A0 while the DHT11 is read: an edge then is missed by the
+    // interrupt and found by reading the pin; attach() takes the line back
+    ParticleHost::reset();
+    wellCapture.begin(wellEdge);
+    check(ParticleHost::interruptAttached(WELL_PUMP_SENSOR_PIN), "A0 attached");
+    attachInterrupt(DHT_PIN, testEdge, FALLING);
+    check(!ParticleHost::interruptAttached(WELL_PUMP_SENSOR_PIN), "D2 takes A0's line");
+    ParticleHost::advanceMillis(1000);
+    ParticleHost::setPin(WELL_PUMP_SENSOR_PIN, LOW);
+    ParticleHost::advanceMillis(20);
+    detachInterrupt(DHT_PIN);
+    check(!wellCapture.changed() && wellCapture.get_edges() == 0 && wellCapture.get_resyncs() == 1,
+          "missed edge found by reading the pin");
+    check(wellCapture.attach() && ParticleHost::interruptAttached(WELL_PUMP_SENSOR_PIN), "attach() takes the line back");
+    ParticleHost::advanceMillis(1000);
+    check(wellCapture.changed() && !wellCapture.value() && wellCapture.changeMillis() == 1020,
+          "missed edge timed when it was found");
+    check(!attachInterrupt(D0, testEdge, CHANGE) && !attachInterrupt(A5, testEdge, CHANGE), "no interrupt on D0 or A5");
+
+    // the sketch: bouncing pump cycles, published run times against the truth
+    ParticleHost::reset();
+    ParticleHost::setUnixTime(1704067200);
+    ParticleHost::setDHTAcquireTime(25);
+    std::mt19937 random(2026);
+    std::uniform_int_distribution<uint32_t> bounceUs(100, 15000);
+    std::uniform_int_distribution<unsigned int> bounces(1, 5);
+    struct Cycle {
+        uint16_t pin;
+        uint64_t onUs;
+        uint64_t offUs;
+    };
+    const Cycle CYCLES[] = {
+        {PRESSURE_PUMP_SENSOR_PIN, 60123457, 143579123},
+        {PRESSURE_PUMP_SENSOR_PIN, 400000321, 401500999},
+        {WELL_PUMP_SENSOR_PIN, 402777777, 1902345678},
+        {PRESSURE_PUMP_SENSOR_PIN, 2000005001, 2075432101},
+        {PRESSURE_PUMP_SENSOR_PIN, 2100987654, 2103096543},
+    };
+    for(const Cycle &cycle : CYCLES) {
+        scheduleContact(random, cycle.pin, cycle.onUs, LOW, bounceUs(random), bounces(random));
+        scheduleContact(random, cycle.pin, cycle.offUs, HIGH, bounceUs(random), bounces(random));
+    }
+    setup();
+    while(ParticleHost::uptimeMillis() < 2103097 + 400000) {
+        loop();
+        ParticleHost::advanceMillis(37);
+    }
+    std::vector<double> measured;
+    for(const ParticleHost::PublishRecord &event : publishedEvents()) {
+        if(event.name == "wsmEventPPstatus" && jsonNumber(event.data, "pp") == 0.0) {
+            measured.push_back(jsonNumber(event.data, "ppon"));
+        } else if(event.name == "wsmEventWPstatus" && jsonNumber(event.data, "wp") == 0.0) {
+            measured.push_back(jsonNumber(event.data, "wpon"));
+        }
+    }
+    bool within = measured.size() == sizeof(CYCLES) / sizeof(CYCLES[0]);
+    for(size_t i = 0; within && i < measured.size(); i++) {
+        double trueMinutes = (CYCLES[i].offUs - CYCLES[i].onUs) / 60000000.0;
+        printf("    run %.6f minutes, published %.6f (%+.3f ms)\n", trueMinutes, measured[i],
+               (measured[i] - trueMinutes) * 60000.0);
+        within = std::fabs(measured[i] - trueMinutes) * 60000.0 <= 1.0;
+    }
+    check(within, "sketch publishes run times within a millisecond, loop() every 37 ms");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+/***************************************************************************************************/
+// EventJournalTest.cpp
+//  Checks WSMEventJournal: events come out in order at the drain rate, confirmed events are not
+//  sent again after a reboot and unconfirmed ones are, the sequence numbers wrap, the writes are
+//  spread evenly over the ring, a full ring drops its oldest events, and a record cut short by a
+//  power loss (the EEPROM file truncated at every byte of it) is skipped without losing the rest.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "WSMEventJournal.h"
+#include "application.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <unistd.h>
+
+const system_tick_t DRAIN_MS = 1000;
+const char *const EEPROM_FILE = "event_journal_test.eeprom";
+
+// the n-th test event: kinds in turn, n in etime and value1
+static WSMJournalRecord event(int n) {
+    WSMJournalRecord record;
+    record.kind = (uint8_t)(JOURNAL_TRH + n % 5);
+    record.alert = n % 7 == 0;
+    record.etime = 1704067200 + (uint32_t)n;
+    record.value1 = n * 0.5f;
+    record.value2 = 40.0f + n;
+    return record;
+}
+
+static bool same(const WSMJournalRecord &record, int n) {
+    WSMJournalRecord expected = event(n);
+    return record.kind == expected.kind && record.alert == expected.alert && record.etime == expected.etime &&
+           record.value1 == expected.value1 && record.value2 == expected.value2;
+}
+
+// take out every event there is, waiting out the drain rate; true if they are first, first + 1, ...
+static bool drainsInOrder(WSMEventJournal &journal, int first, int count) {
+    WSMJournalRecord record;
+    for(int n = first; n < first + count; n++) {
+        ParticleHost::advanceMillis(journal.msUntilNext());
+        if(!journal.next(record) || !same(record, n)) {
+            return false;
+        }
+    }
+    return !journal.next(record) && journal.msUntilNext() == 0xFFFFFFFF;
+}
+
+// power off and on: the EEPROM keeps its contents when it is backed by a file
+static void reboot(WSMEventJournal &journal) {
+    ParticleHost::reset();
+    journal.begin();
+}
+
+int main() {
+    // order and drain rate
+    ParticleHost::reset();
+    WSMEventJournal journal(0, 16, DRAIN_MS);
+    journal.begin();
+    for(int n = 0; n < 10; n++) {
+        journal.append(event(n));
+    }
+    WSMJournalRecord record;
+    bool burst = true;
+    for(int n = 0; n < (int)JOURNAL_DRAIN_BURST; n++) {
+        burst = burst && journal.next(record) && same(record, n);
+    }
+    check(burst && !journal.next(record), "a burst, then nothing");
+    check(journal.msUntilNext() == DRAIN_MS, "the next event a drain interval later");
+    ParticleHost::advanceMillis(DRAIN_MS - 1);
+    check(!journal.next(record), "not before the drain interval");
+    ParticleHost::advanceMillis(1);
+    check(journal.next(record) && same(record, 4) && !journal.next(record), "one per drain interval");
+    check(journal.pending() == 10 && journal.unsent() == 5, "taken out, not drained");
+
+    // a reboot resends what was taken out but not confirmed, and only that
+    journal.confirm(3);
+    check(journal.pending() == 7 && journal.get_drained() == 3, "confirmed events drained");
+    ParticleHost::setEEPROMFile(EEPROM_FILE);
+    EEPROM.clear();
+    journal.begin();
+    for(int n = 0; n < 10; n++) {
+        journal.append(event(n));
+    }
+    ParticleHost::advanceMillis(DRAIN_MS * JOURNAL_DRAIN_BURST);
+    for(int n = 0; n < 5; n++) {
+        journal.next(record);
+    }
+    journal.confirm(3);
+    reboot(journal);
+    check(journal.get_recovered() == 7 && journal.pending() == 7 && journal.get_corrupt() == 0, "undrained events recovered");
+    check(drainsInOrder(journal, 3, 7), "unconfirmed events sent again, in order");
+    journal.confirm(7);
+    reboot(journal);
+    check(journal.pending() == 0 && journal.get_recovered() == 0, "nothing to send after everything was confirmed");
+    journal.append(event(10));
+    check(drainsInOrder(journal, 10, 1), "appends continue after the recovered records");
+    ParticleHost::setEEPROMFile(nullptr);
+
+    // the sequence numbers wrap and every record of the ring is written equally often
+    ParticleHost::reset();
+    WSMEventJournal ring(0, 8, DRAIN_MS);
+    ring.begin();
+    const int MANY = 1001;
+    bool allDrained = true;
+    for(int n = 0; n < MANY; n++) {
+        ring.append(event(n));
+        allDrained = allDrained && drainsInOrder(ring, n, 1);
+        ring.confirm(1);
+    }
+    check(allDrained && ring.get_drained() == MANY, "1001 events through an 8 record ring");
+    uint64_t fewest = ~0ULL, most = 0;
+    for(int slot = 0; slot < 8; slot++) {
+        for(int byte = 0; byte < JOURNAL_RECORD_SIZE; byte++) {
+            uint64_t writes = ParticleHost::eepromWrites(slot * JOURNAL_RECORD_SIZE + byte);
+            fewest = std::min(fewest, writes);
+            most = std::max(most, writes);
+        }
+    }
+    printf("EEPROM writes per byte: %llu to %llu\n", (unsigned long long)fewest, (unsigned long long)most);
+    check(most <= (MANY + 7) / 8 * 3 && fewest >= MANY / 8, "writes spread evenly over the ring");
+    check(ParticleHost::eepromWrites(8 * JOURNAL_RECORD_SIZE) == 0, "nothing written past the ring");
+    for(int n = MANY; n < MANY + 3; n++) {
+        ring.append(event(n));
+    }
+    ParticleHost::setEEPROMFile(EEPROM_FILE);
+    EEPROM.clear();
+    ring.begin();
+    for(int n = 0; n < 300; n++) {
+        ring.append(event(n));
+        ParticleHost::advanceMillis(ring.msUntilNext());
+        ring.next(record);
+        ring.confirm(n < 297 ? 1 : 0);
+    }
+    reboot(ring);
+    check(ring.pending() == 3 && drainsInOrder(ring, 297, 3), "recovered across the sequence number wrap");
+    ParticleHost::setEEPROMFile(nullptr);
+
+    // a full ring makes way for the newest events
+    ParticleHost::reset();
+    ring.begin();
+    bool keptUntilFull = true;
+    bool droppedAfter = true;
+    for(int n = 0; n < 12; n++) {
+        bool kept = ring.append(event(n));
+        keptUntilFull = keptUntilFull && (kept || n >= 8);
+        droppedAfter = droppedAfter && (!kept || n < 8);
+    }
+    check(keptUntilFull && droppedAfter && ring.get_dropped() == 4 && ring.pending() == 8, "oldest events dropped when full");
+    check(drainsInOrder(ring, 4, 8), "the newest events kept, in order");
+
+    // events taken out, then overwritten before they were confirmed, are not confirmed twice
+    ParticleHost::reset();
+    ring.begin();
+    for(int n = 0; n < 8; n++) {
+        ring.append(event(n));
+    }
+    ring.next(record);
+    ring.next(record);
+    ring.append(event(8));
+    ring.confirm(2);
+    check(ring.pending() == 7 && ring.unsent() == 7 && ring.get_drained() == 1, "overwritten events confirmed");
+    check(drainsInOrder(ring, 2, 7), "the rest still sent");
+
+    // power loss: the file cut off at every byte of the last record
+    bool allRecovered = true;
+    for(int cut = 0; cut <= JOURNAL_RECORD_SIZE; cut++) {
+        ParticleHost::setEEPROMFile(EEPROM_FILE);
+        EEPROM.clear();
+        WSMEventJournal cutShort(0, 8, DRAIN_MS);
+        cutShort.begin();
+        for(int n = 0; n < 5; n++) {
+            cutShort.append(event(n));
+        }
+        if(truncate(EEPROM_FILE, 4 * JOURNAL_RECORD_SIZE + cut) != 0) {
+            allRecovered = false;
+            break;
+        }
+        reboot(cutShort);
+        bool whole = cut == JOURNAL_RECORD_SIZE;
+        bool recovered = cutShort.pending() == (whole ? 5u : 4u) &&
+                         cutShort.get_corrupt() == (cut == 0 || whole ? 0u : 1u);
+
+        // the damaged record is written over and the journal goes on from there
+        cutShort.append(event(whole ? 5 : 4));
+        reboot(cutShort);
+        recovered = recovered && cutShort.get_corrupt() == 0 && drainsInOrder(cutShort, 0, whole ? 6 : 5);
+        if(!recovered) {
+            printf("cut %d bytes into the record: %u pending, %u corrupt\n", cut, cutShort.pending(), cutShort.get_corrupt());
+        }
+        allRecovered = allRecovered && recovered;
+    }
+    check(allRecovered, "a record cut short by a power loss is skipped");
+    ParticleHost::setEEPROMFile(nullptr);
+    remove(EEPROM_FILE);
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
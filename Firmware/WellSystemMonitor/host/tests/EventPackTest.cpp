@@ -0,0 +1,166 @@
+/***************************************************************************************************/
+// EventPackTest.cpp
+//  Checks the wsmEventPack encoding (src/WSMEventPack.h) against the reference decoder
+//  (uplink/WSMPackDecoder.h): events come back in order with the JSON the sketch published them
+//  with, time deltas of either sign, the pack fills up to the publish limit, malformed packs are
+//  refused, and the batcher keeps packed and JSON events in order.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "JSONWriter.h"
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "WSMEventPack.h"
+#include "WSMPackDecoder.h"
+#include "WSMPublishBatcher.h"
+#include "WSMWebhook.h"
+#include "application.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static WSMJournalRecord event(uint8_t kind, uint32_t etime, float value1 = 0.0f, float value2 = 0.0f, bool alert = false) {
+    WSMJournalRecord record;
+    record.kind = kind;
+    record.alert = alert;
+    record.etime = etime;
+    record.value1 = value1;
+    record.value2 = value2;
+    return record;
+}
+
+// the JSON the sketch published for an event
+static std::string sketchJSON(const WSMJournalRecord &record) {
+    char json[JSON_EVENT_SIZE];
+    WSMEventPack::eventJSON(record, Time.zone(), json, sizeof(json));
+    return json;
+}
+
+// any bytes in base64, for malformed packs
+static std::string base64(const std::vector<uint8_t> &bytes) {
+    const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string text;
+    for(size_t i = 0; i < bytes.size(); i += 3) {
+        uint32_t group = (uint32_t)bytes[i] << 16;
+        group |= i + 1 < bytes.size() ? (uint32_t)bytes[i + 1] << 8 : 0;
+        group |= i + 2 < bytes.size() ? bytes[i + 2] : 0;
+        text += ALPHABET[(group >> 18) & 0x3F];
+        text += ALPHABET[(group >> 12) & 0x3F];
+        text += i + 1 < bytes.size() ? ALPHABET[(group >> 6) & 0x3F] : '=';
+        text += i + 2 < bytes.size() ? ALPHABET[group & 0x3F] : '=';
+    }
+    return text;
+}
+
+static std::string encoded(const WSMEventPack &pack) {
+    char text[PUBLISH_DATA_LIMIT + 1];
+    pack.encode(text, sizeof(text));
+    return text;
+}
+
+int main() {
+    ParticleHost::reset();
+    ParticleHost::setUnixTime(1704067200);
+    Time.zone(-8);
+
+    // a day's worth of events comes back exactly as the sketch published them
+    std::vector<WSMJournalRecord> day = {
+        event(JOURNAL_TRH, 1704067200, 61.25f, 48.5f),
+        event(JOURNAL_PP_ON, 1704067290),
+        event(JOURNAL_PP_OFF, 1704067374, (float)84000 / 60000.0),
+        event(JOURNAL_WP_ON, 1704067380, 0.0f, 0.0f, true),
+        event(JOURNAL_WP_OFF, 1704069060, (float)1680000 / 60000),
+        event(JOURNAL_PP_ON, 1704069000),     // the clock moved back
+        event(JOURNAL_PP_OFF, 1704069001, (float)1234 / 60000.0),
+        event(JOURNAL_WP_OFF, 1704069002, (float)7199999 / 60000),
+        event(JOURNAL_TRH, 1704070800, -12.5f, 0.0f),
+    };
+    WSMEventPack pack;
+    pack.clear();
+    for(const WSMJournalRecord &record : day) {
+        pack.add(record);
+    }
+    std::string text = encoded(pack);
+    printf("%u events in %zu bytes, %zu in base64: %s\n", pack.count(), pack.size(), text.size(), text.c_str());
+    WSMPackDecoder decoder;
+    bool decoded = decoder.decode(text.c_str());
+    check(decoded && decoder.version() == 1 && decoder.zone() == -8.0f && decoder.events().size() == day.size(),
+          "pack decodes");
+    bool same = decoded;
+    size_t jsonBytes = 0;
+    for(size_t i = 0; same && i < day.size(); i++) {
+        const WSMPackedEvent &packed = decoder.events()[i];
+        char json[JSON_EVENT_SIZE];
+        same = packed.data == sketchJSON(day[i]) &&
+               packed.name == std::string(WSMEventPack::eventJSON(day[i], -8.0f, json, sizeof(json))) &&
+               packed.record.etime == day[i].etime && packed.record.alert == day[i].alert;
+        if(!same) {
+            printf("    decoded: %s\n    sketch:  %s\n", packed.data.c_str(), sketchJSON(day[i]).c_str());
+        }
+        jsonBytes += packed.data.size();
+    }
+    check(same, "events come back as the sketch published them, in order");
+    printf("JSON %zu bytes, packed %zu bytes\n", jsonBytes, text.size());
+    check(text.size() * 5 < jsonBytes, "a fifth of the JSON size");
+
+    // TRH values are kept to hundredths
+    pack.clear();
+    pack.add(event(JOURNAL_TRH, 1704067200, 46.476643f, 70.167656f));
+    decoder.decode(encoded(pack).c_str());
+    check(decoder.events().size() == 1 && decoder.events()[0].data ==
+          "{\"etime\":1704067200,\"temp\":46.480000,\"rh\":70.169998,\"loctime\":\"2023-12-31 16:00:00\"}",
+          "TRH in hundredths");
+
+    // a pack fills up to the publish limit, and refuses an event that does not fit
+    pack.clear();
+    unsigned int added = 0;
+    while(pack.add(event(added % 2 ? JOURNAL_PP_OFF : JOURNAL_PP_ON, 1704067200 + 90 * added, 1.4f))) {
+        added++;
+    }
+    size_t before = pack.size();
+    text = encoded(pack);
+    printf("%u pump events in a pack, %zu bytes, %zu in base64\n", added, pack.size(), text.size());
+    check(pack.count() == added && pack.size() == before && added > 80, "more than 80 pump events in a pack");
+    check(text.size() <= PUBLISH_DATA_LIMIT && pack.size() > EVENT_PACK_SIZE - 16, "filled to the publish limit");
+    check(decoder.decode(text.c_str()) && decoder.events().size() == added, "a full pack decodes");
+    char small[8];
+    check(pack.encode(small, sizeof(small)) == 0 && small[0] == '\0', "encode() refuses a short buffer");
+
+    // malformed packs
+    check(!decoder.decode("AQ!A") && std::string(decoder.error()) == "not base64", "not base64");
+    check(!decoder.decode(base64({2, 0}).c_str()) && std::string(decoder.error()) == "unknown version",
+          "unknown version");
+    check(!decoder.decode(base64({1, 0, 0x3F, 0}).c_str()) && std::string(decoder.error()) == "unknown event",
+          "unknown event");
+    pack.clear();
+    pack.add(event(JOURNAL_PP_ON, 1704067200));
+    pack.add(event(JOURNAL_PP_OFF, 1704067290, 1.5f));
+    std::vector<uint8_t> cut(pack.bytes(), pack.bytes() + pack.size() - 1);     // the last byte lost
+    check(!decoder.decode(base64(cut).c_str()) && std::string(decoder.error()) == "cut short" &&
+          decoder.events().size() == 1, "a cut short pack keeps the events before the fault");
+
+    // the batcher publishes records as packs, and keeps them in order with JSON events
+    WSMPublishBatcher batcher("wsmEventBatch", 300000);
+    batcher.begin();
+    batcher.add(day[1]);
+    batcher.add(day[2]);
+    batcher.add("wsmEventTest", "{\"etime\":1704067380}");
+    batcher.add(day[3]);
+    batcher.flush();
+    std::vector<std::string> names;
+    std::vector<std::string> published;
+    for(const ParticleHost::PublishRecord &record : ParticleHost::published()) {
+        published.push_back(record.name);
+        expandBatch(record, [&](const ParticleHost::PublishRecord &expanded) { names.push_back(expanded.name); });
+    }
+    check(published == std::vector<std::string>({"wsmEventPack", "wsmEventBatch", "wsmEventPack"}) &&
+          names == std::vector<std::string>({"wsmEventPPstatus", "wsmEventPPstatus", "wsmEventTest", "wsmEventWPstatus"}) &&
+          batcher.get_eventsPublished() == 4, "packed and JSON events kept in order");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/***************************************************************************************************/
+// FirmwareHostTest.cpp
+//  Runs the unmodified WellSystemMonitor sketch against the host Device OS stand-in and checks the
+//  publications for a restart, a TRH report, a pressure pump cycle and a well pump cycle that
+//  spans the 49 day millis() rollover, and for pump cycles during a cloud outage, which are
+//  journaled and published once the cloud is back.  The events arrive in wsmEventPack
+//  publications and are checked as the events they carry.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "WSMWebhook.h"
+#include "application.h"
+
+#include <cstdio>
+#include <string>
+
+// from the sketch
+void setup();
+void loop();
+
+const uint16_t WELL_PUMP_SENSOR_PIN = A0;
+const uint16_t PRESSURE_PUMP_SENSOR_PIN = A1;
+const uint64_t LOOP_PERIOD_MS = 10;
+const uint64_t BATCH_MAX_AGE_MS = 300000;
+
+// run loop() every LOOP_PERIOD_MS of virtual time
+static void runFor(uint64_t ms) {
+    uint64_t end = ParticleHost::uptimeMillis() + ms;
+    while(ParticleHost::uptimeMillis() < end) {
+        loop();
+        ParticleHost::advanceMillis(LOOP_PERIOD_MS);
+    }
+}
+
+// the publications so far, with every batch split into its events
+static std::vector<ParticleHost::PublishRecord> published;
+
+static void expandPublished() {
+    published.clear();
+    for(const ParticleHost::PublishRecord &record : ParticleHost::published()) {
+        expandBatch(record, [](const ParticleHost::PublishRecord &event) { published.push_back(event); });
+    }
+}
+
+// find the first publication with the given name and data, or nullptr
+static const ParticleHost::PublishRecord *findPublished(const char *name, const char *data) {
+    expandPublished();
+    for(const ParticleHost::PublishRecord &record : published) {
+        if(record.name == name && record.data.find(data) != std::string::npos) {
+            return &record;
+        }
+    }
+    return nullptr;
+}
+
+// find the last publication with the given name, or nullptr
+static const ParticleHost::PublishRecord *lastPublished(const char *name) {
+    expandPublished();
+    for(size_t i = published.size(); i > 0; i--) {
+        if(published[i - 1].name == name) {
+            return &published[i - 1];
+        }
+    }
+    return nullptr;
+}
+
+// pull a numeric field out of a flat JSON payload
+static double jsonNumber(const std::string &json, const char *key) {
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = json.find(pattern);
+    if(pos == std::string::npos) {
+        return -1.0;
+    }
+    return atof(json.c_str() + pos + pattern.size());
+}
+
+int main() {
+    ParticleHost::reset();
+    ParticleHost::setUnixTime(1664279461);
+    // place the millis() rollover 30 minutes after boot
+    ParticleHost::setMillisOffset(0xFFFFFFFFu - 30 * 60000u);
+    ParticleHost::setDHTReading(17.0, 60.0);
+
+    setup();
+    runFor(1000);
+
+    check(findPublished("WSM", "System Restart") != nullptr, "restart published");
+    check(lastPublished("wsmEventTRH") != nullptr, "TRH published on first loop");
+    check(ParticleHost::variable("SensorReport").find("\"Project\":\"Well System Monitor\"") != std::string::npos,
+          "SensorReport variable");
+
+    // pressure pump runs for 2 minutes; both events go out in one pack 5 minutes after the first
+    uint64_t publishes = ParticleHost::publishCount();
+    ParticleHost::setPin(PRESSURE_PUMP_SENSOR_PIN, LOW);
+    runFor(5000);
+    check(lastPublished("wsmEventPPstatus") == nullptr, "PP on held in the batch");
+    runFor(2 * 60000 - 5000);
+    ParticleHost::setPin(PRESSURE_PUMP_SENSOR_PIN, HIGH);
+    runFor(BATCH_MAX_AGE_MS - 2 * 60000 + 5000);
+    check(ParticleHost::publishCount() == publishes + 1 && ParticleHost::published().back().name == "wsmEventPack",
+          "PP cycle published in one pack");
+    const ParticleHost::PublishRecord *ppOn = findPublished("wsmEventPPstatus", "\"pp\":1");
+    check(ppOn != nullptr && jsonNumber(ppOn->data, "pp") == 1.0, "PP on published");
+    const ParticleHost::PublishRecord *ppOff = lastPublished("wsmEventPPstatus");
+    double ppon = ppOff ? jsonNumber(ppOff->data, "ppon") : -1.0;
+    check(ppOff != nullptr && jsonNumber(ppOff->data, "pp") == 0.0 && ppon > 1.99 && ppon < 2.01,
+          "PP off published with 2 minute run time");
+
+    // well pump runs for 25 minutes across the millis() rollover; coming on raises an alert, which
+    // sends the WP on event straight away
+    ParticleHost::setPin(WELL_PUMP_SENSOR_PIN, LOW);
+    runFor(5000);
+    const ParticleHost::PublishRecord *wpOn = lastPublished("wsmEventWPstatus");
+    check(wpOn != nullptr && jsonNumber(wpOn->data, "wp") == 1.0, "WP on published with the alert");
+    runFor(25 * 60000 - 5000);
+    ParticleHost::setPin(WELL_PUMP_SENSOR_PIN, HIGH);
+    runFor(BATCH_MAX_AGE_MS + 5000);
+    const ParticleHost::PublishRecord *wpOff = lastPublished("wsmEventWPstatus");
+    double wpon = wpOff ? jsonNumber(wpOff->data, "wpon") : -1.0;
+    check(wpOff != nullptr && wpon > 24.99 && wpon < 25.01, "WP run time across millis() rollover");
+
+    // only 2 minutes of PP run time had accumulated when the WP came on
+    check(lastPublished("wsmAlertWPOnTooSoon") != nullptr, "WP on too soon alert");
+
+    // three PP cycles while the cloud is away come out in order, with the times they happened
+    ParticleHost::setCloudConnected(false);
+    size_t before = published.size();
+    time_t outageStart = Time.now();
+    for(int cycle = 0; cycle < 3; cycle++) {
+        ParticleHost::setPin(PRESSURE_PUMP_SENSOR_PIN, LOW);
+        runFor(60000);
+        ParticleHost::setPin(PRESSURE_PUMP_SENSOR_PIN, HIGH);
+        runFor(60000);
+    }
+    ParticleHost::setCloudConnected(true);
+    runFor(BATCH_MAX_AGE_MS + 10000);
+    expandPublished();
+    bool inOrder = published.size() == before + 6;
+    for(size_t i = before; inOrder && i < published.size(); i++) {
+        double etime = jsonNumber(published[i].data, "etime");
+        inOrder = published[i].name == "wsmEventPPstatus" &&
+                  jsonNumber(published[i].data, "pp") == ((i - before) % 2 == 0 ? 1.0 : 0.0) &&
+                  etime >= outageStart + 60.0 * (i - before) && etime < outageStart + 60.0 * (i - before) + 5;
+    }
+    check(inOrder, "events of a cloud outage published in order when it is back");
+
+    std::string stats = ParticleHost::variable("PublishStats");
+    check(stats.find("\"events\":12,\"published\":12,\"dropped\":0") != std::string::npos, "PublishStats variable");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+/***************************************************************************************************/
+// FirmwareSimulatorTest.cpp
+//  Simulates a year of a healthy well system, through seven millis() rollovers, and checks that
+//  the sketch publishes a TRH report every half hour, reports every pump cycle with a sensible
+//  run time and raises no alerts.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "FirmwareSimulator.h"
+#include "TestCheck.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// pull a numeric field out of a flat JSON payload
+static double jsonNumber(const std::string &json, const char *key) {
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = json.find(pattern);
+    if(pos == std::string::npos) {
+        return -1.0;
+    }
+    return atof(json.c_str() + pos + pattern.size());
+}
+
+int main() {
+    SimulatorConfig config;
+    config.durationMs = 365ULL * 86400000ULL;
+    config.millisOffset = 0xF0000000u;  // first rollover after about 3 days
+    config.pumps.seed = 7;
+
+    uint64_t trh = 0, ppOn = 0, ppOff = 0, wpOn = 0, wpOff = 0, alerts = 0, badRunTimes = 0;
+    time_t lastTRH = 0;
+    uint64_t badTRHIntervals = 0;
+
+    FirmwareSimulator simulator(config);
+    simulator.run([&](const ParticleHost::PublishRecord &record) {
+        if(record.name == "wsmEventTRH") {
+            if(lastTRH != 0 && record.unixTime - lastTRH != 1800) {
+                badTRHIntervals++;
+            }
+            lastTRH = record.unixTime;
+            trh++;
+        } else if(record.name == "wsmEventPPstatus") {
+            if(jsonNumber(record.data, "pp") == 1.0) {
+                ppOn++;
+            } else {
+                ppOff++;
+                double runTime = jsonNumber(record.data, "ppon");
+                if(runTime < 0.1 || runTime > 3.0) {
+                    badRunTimes++;
+                }
+            }
+        } else if(record.name == "wsmEventWPstatus") {
+            if(jsonNumber(record.data, "wp") == 1.0) {
+                wpOn++;
+            } else {
+                wpOff++;
+                double runTime = jsonNumber(record.data, "wpon");
+                if(runTime < 20.0 || runTime > 40.0) {
+                    badRunTimes++;
+                }
+            }
+        } else if(record.name.compare(0, 8, "wsmAlert") == 0) {
+            printf("unexpected %s %s\n", record.name.c_str(), record.data.c_str());
+            alerts++;
+        }
+    });
+
+    printf("%llu loop passes, %llu TRH, %llu PP cycles, %llu WP cycles\n",
+           (unsigned long long)simulator.loopCount(), (unsigned long long)trh,
+           (unsigned long long)ppOff, (unsigned long long)wpOff);
+    check(trh == 365 * 48, "one TRH report every half hour");
+    check(badTRHIntervals == 0, "TRH reports exactly 30 minutes apart");
+    check(ppOn > 365 * 10 && ppOn - ppOff <= 1, "PP cycles reported");
+    check(wpOn > 365 && wpOn - wpOff <= 1, "WP cycles reported");
+    check(badRunTimes == 0, "run times within limits across millis() rollovers");
+    check(alerts == 0, "no alerts for a healthy system");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
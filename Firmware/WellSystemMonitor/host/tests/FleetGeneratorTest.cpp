@@ -0,0 +1,180 @@
+/***************************************************************************************************/
+// FleetGeneratorTest.cpp
+//  Checks the fleet load generator (sim/FleetGenerator.h): each device's publications the same on
+//  any number of threads; every event in the firmware's format, as the ingest service reads it, and
+//  every alert the alert processor's; the TRH reports, pump cycles and WP runs of a month without
+//  faults; the alerts that faulty pumps raise; and the pace of a run at a speed.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "FleetGenerator.h"
+#include "TestCheck.h"
+#include "WSMWebhookPost.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+// FNV-1a of each device's publications, in order; each device runs on one thread only
+struct DeviceHashes {
+    std::vector<uint64_t> hashes;
+
+    explicit DeviceHashes(unsigned int devices) : hashes(devices, 14695981039346656037ULL) {}
+
+    void add(const FleetPublication &publication) {
+        uint64_t &hash = hashes[publication.device];
+        for(const char *text : {publication.name, "\n", publication.data, "\n"}) {
+            for(const char *p = text; *p != '\0'; p++) {
+                hash = (hash ^ (uint8_t)*p) * 1099511628211ULL;
+            }
+        }
+    }
+};
+
+static void testThreads() {
+    FleetConfig config;
+    config.devices = 40;
+    config.durationMs = 3ULL * 86400000ULL;
+    config.faultFraction = 0.5;
+
+    config.threads = 1;
+    DeviceHashes one(config.devices);
+    FleetGenerator single(config);
+    FleetStats oneStats = single.run([&](int, const FleetPublication &publication) { one.add(publication); });
+
+    config.threads = 3;
+    DeviceHashes three(config.devices);
+    FleetGenerator shared(config);
+    FleetStats threeStats = shared.run([&](int, const FleetPublication &publication) { three.add(publication); });
+
+    check(shared.numThreads() == 3 && shared.threadStats()[2].devices == 13, "devices shared out over the threads");
+    check(oneStats.events() > 0 && oneStats.events() == threeStats.events() && oneStats.alerts == threeStats.alerts,
+          "same events on 1 and 3 threads");
+    check(one.hashes == three.hashes, "each device's publications the same on 1 and 3 threads");
+
+    config.seed = 2;
+    DeviceHashes other(config.devices);
+    FleetGenerator reseeded(config);
+    reseeded.run([&](int, const FleetPublication &publication) { other.add(publication); });
+    check(other.hashes != three.hashes, "another seed, other publications");
+}
+
+static void testFormats() {
+    FleetConfig config;
+    config.devices = 24;
+    config.threads = 2;
+    config.durationMs = 5ULL * 86400000ULL;
+    config.faultFraction = 1.0;
+
+    std::vector<std::vector<uint32_t>> etimes(config.devices);
+    std::atomic<int> badEvents(0);
+    std::atomic<int> badAlerts(0);
+    std::vector<std::vector<WSMIngestRow>> rows(config.threads);
+    FleetGenerator fleet(config);
+    FleetStats stats = fleet.run([&](int thread, const FleetPublication &publication) {
+        etimes[publication.device].push_back(publication.etime);
+        if(publication.alert) {
+            char start[64];
+            snprintf(start, sizeof(start), "{\"etime\":%u,\"msg\":\"", publication.etime);
+            if(strncmp(publication.name, "wsmAlert", 8) != 0 || strncmp(publication.data, start, strlen(start)) != 0) {
+                badAlerts++;
+            }
+            return;
+        }
+        WSMWebhookPost post;
+        post.event = publication.name;
+        post.data = publication.data;
+        rows[thread].clear();
+        if(webhookRows(post, rows[thread]) != 1 || rows[thread][0].row.etime != publication.etime) {
+            badEvents++;
+        }
+    });
+
+    bool ordered = true;
+    for(const std::vector<uint32_t> &device : etimes) {
+        for(size_t i = 1; i < device.size(); i++) {
+            ordered = ordered && device[i - 1] <= device[i];
+        }
+    }
+    check(stats.events() > 0 && badEvents == 0, "every event is a sheet row, at its etime");
+    check(stats.alerts > 0 && badAlerts == 0, "every alert in the alert processor's format");
+    check(ordered, "each device's publications in time order");
+}
+
+static void testMonth() {
+    const unsigned int DAYS = 30;
+    FleetConfig config;
+    config.devices = 50;
+    config.durationMs = DAYS * 86400000ULL;
+
+    std::atomic<uint64_t> wpRuns(0);
+    FleetGenerator fleet(config);
+    FleetStats stats = fleet.run([&](int, const FleetPublication &publication) {
+        if(strstr(publication.data, "\"wpon\":") != nullptr) {
+            wpRuns++;
+        }
+    });
+
+    double ppPerDay = stats.ppEvents / 2.0 / config.devices / DAYS;
+    double wpPerDay = wpRuns / (double)config.devices / DAYS;
+    printf("  %.1f PP cycles and %.2f WP runs a device a day, %llu alerts\n", ppPerDay, wpPerDay,
+           (unsigned long long)stats.alerts);
+    check(stats.trh == config.devices * (DAYS * 48 - 1), "a TRH report every half hour from boot");
+    check(ppPerDay > 0.5 * config.pumps.ppCyclesPerDay && ppPerDay < 1.5 * config.pumps.ppCyclesPerDay,
+          "PP cycles a day as the pump model's");
+    check(wpPerDay > 0.5 && wpPerDay < 3.0, "the WP refills after the PP has run");
+    check(stats.alerts < config.devices * DAYS / 10, "few alerts without faults");
+}
+
+static void testFaults() {
+    FleetConfig config;
+    config.devices = 40;
+    config.durationMs = 10ULL * 86400000ULL;
+    config.faultFraction = 1.0;
+
+    std::vector<std::set<std::string>> names(2);
+    config.threads = 2;
+    FleetGenerator two(config);
+    two.run([&](int thread, const FleetPublication &publication) {
+        if(publication.alert) {
+            names[thread].insert(publication.name);
+        }
+    });
+    names[0].insert(names[1].begin(), names[1].end());
+    check(names[0].count("wsmAlertPPShortCycling") == 1 && names[0].count("wsmAlertPPOnTooShort") == 1,
+          "a waterlogged tank alerts");
+    check(names[0].count("wsmAlertPPOnTooLong") == 1, "a PP that runs long alerts");
+    check(names[0].count("wsmAlertWPNotComeOn") == 1, "a stuck float alerts");
+    check(names[0].count("wsmAlertWPOnTooShort") == 1, "a WP that runs short alerts");
+}
+
+static void testSpeed() {
+    FleetConfig config;
+    config.devices = 10;
+    config.threads = 2;
+    config.durationMs = 3600000;
+    config.speed = 36000.0;
+
+    std::atomic<int> idles(0);
+    FleetGenerator fleet(config);
+    FleetStats stats = fleet.run(FleetSink(), [&](int) { idles++; });
+    check(stats.events() > 0 && stats.seconds >= 0.095, "an hour at 36000x takes a tenth of a second");
+    check(idles > 2, "the threads wait for their events");
+}
+
+int main() {
+    testThreads();
+    testFormats();
+    testMonth();
+    testFaults();
+    testSpeed();
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
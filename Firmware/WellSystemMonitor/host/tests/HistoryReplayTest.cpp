@@ -0,0 +1,85 @@
+/***************************************************************************************************/
+// HistoryReplayTest.cpp
+//  Replays the recorded history in data/WSMDataHistory.csv through WSMAlertProcessor and checks
+//  the row counts and the alerts raised, then checks the reader against quoted fields, CRLF line
+//  ends, blank and over-long lines.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "HistoryReplay.h"
+#include "TestCheck.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static void replayRecordedHistory(const char *path) {
+    WSMDataReader reader;
+    if(!reader.open(path)) {
+        check(false, "open the recorded history");
+        return;
+    }
+
+    std::vector<ReplayAlert> alerts;
+    HistoryReplay replay;
+    ReplayStats stats = replay.run(reader, [&](const ReplayAlert &alert) { alerts.push_back(alert); });
+
+    check(stats.rows == 2064 && reader.linesSkipped() == 2, "all data rows read, title and header skipped");
+    check(stats.trhRows == 908 && stats.ppRows == 1091 && stats.wpRows == 65 && stats.ignoredRows == 0,
+          "rows by event");
+    check(alerts.size() == 4, "four alerts in the recorded history");
+    if(alerts.size() == 4) {
+        check(alerts[0].name == "wsmAlertWPOnTooSoon" && alerts[0].etime == 1654166160 && alerts[0].lineNumber == 40,
+              "WP on too soon after a short PP run");
+        check(alerts[1].name == "wsmAlertWPOnTooLong" && alerts[1].lineNumber == 76, "first WP on too long");
+        check(alerts[2].name == "wsmAlertWPOnTooLong" && alerts[2].lineNumber == 629, "second WP on too long");
+        check(alerts[3].name == "wsmAlertWPNotComeOn" && alerts[3].etime == 1660604007 &&
+              alerts[3].lineNumber == 830, "WP did not come on");
+    }
+}
+
+static void readAwkwardFile() {
+    FILE *file = tmpfile();
+    if(file == nullptr) {
+        check(false, "create a temporary file");
+        return;
+    }
+    fputs("\"Time Stamp\",\"Temperature (F)\"\r\n", file);
+    fputs("\r\n", file);
+    fputs("\"1700000000\",\"61.5\",\"40\",,,,,\"wsmEventTRH\",\"2023-11-14, 14:13:20\"\r\n", file);
+    fputs("1700000060,,,1,,,,wsmEventPPstatus\r\n", file);
+    fputs(std::string(100000, 'x').c_str(), file);
+    fputs("\n", file);
+    fputs("1700000150,,,0,,1.5,,wsmEventPPstatus,x\n", file);
+    fputs("1700000200,,,,,,,wsmEventSomethingElse", file);     // no final newline
+    rewind(file);
+
+    WSMDataReader reader;
+    reader.attach(file);
+    WSMDataRow rows[4];
+    int numRows = 0;
+    while(numRows < 4 && reader.next(rows[numRows])) {
+        numRows++;
+    }
+    check(numRows == 4 && !reader.next(rows[0]), "four data rows");
+    check(reader.linesSkipped() == 3 && reader.lineNumber() == 7, "header, blank and over-long lines skipped");
+    if(numRows == 4) {
+        check(rows[0].etime == 1700000000 && rows[0].temp == 61.5f && rows[0].rh == 40.0f &&
+              rows[0].event == WSM_EVENT_TRH, "quoted TRH row");
+        check(rows[1].pp == 1 && rows[1].wp == -1 && rows[1].event == WSM_EVENT_PP_STATUS, "PP on row with CRLF");
+        check(rows[2].pp == 0 && rows[2].ppon == 1.5f && rows[2].wpon != rows[2].wpon, "PP off row");
+        check(rows[3].etime == 1700000200 && rows[3].event == WSM_EVENT_OTHER, "last line without newline");
+    }
+    fclose(file);
+}
+
+int main(int argc, char *argv[]) {
+    replayRecordedHistory(argc > 1 ? argv[1] : "WSMDataHistory.csv");
+    readAwkwardFile();
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,438 @@
+/***************************************************************************************************/
+// IngestTest.cpp
+//  Checks the ingest service (ingest/): the zero copy JSON reader, the webhook form and its
+//  published_at time, the rows of single, batched and packed events (the same rows, whichever way
+//  they came) and malformed posts; the store's group commit from many threads, its records read
+//  back in each thread's order and the cut off of a record left unfinished; then the server over
+//  loopback: replies, keep-alive and pipelining, errors, the stats and posts from 8 connections.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "JSONWriter.h"
+#include "TestCheck.h"
+#include "WSMEventPack.h"
+#include "WSMIngestServer.h"
+#include "WSMJsonReader.h"
+
+#include <arpa/inet.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+const char STORE_PATH[] = "ingest_test.store";
+const char SITE[] = "e00fce68a1b2c3d4e5f60718";
+const unsigned int STORE_THREADS = 16;
+const unsigned int STORE_APPENDS = 500;
+const unsigned int CLIENT_THREADS = 8;
+const unsigned int CLIENT_POSTS = 200;
+
+static WSMJournalRecord event(uint8_t kind, uint32_t etime, float value1 = 0.0f, float value2 = 0.0f) {
+    WSMJournalRecord record;
+    record.kind = kind;
+    record.alert = false;
+    record.etime = etime;
+    record.value1 = value1;
+    record.value2 = value2;
+    return record;
+}
+
+// a day of a site's events
+static std::vector<WSMJournalRecord> day() {
+    std::vector<WSMJournalRecord> events;
+    uint32_t etime = 1664236800;
+    for(int i = 0; i < 12; i++) {
+        events.push_back(event(JOURNAL_TRH, etime, 16.25f + i * 0.5f, 60.75f - i));
+        events.push_back(event(JOURNAL_PP_ON, etime + 600));
+        events.push_back(event(JOURNAL_PP_OFF, etime + 690, 1.5f + i / 60.0f));
+        if(i % 4 == 3) {
+            events.push_back(event(JOURNAL_WP_ON, etime + 900));
+            events.push_back(event(JOURNAL_WP_OFF, etime + 2700, 30.0f + i));
+        }
+        etime += 7200;
+    }
+    return events;
+}
+
+static std::string formEncode(const std::string &text) {
+    static const char HEX[] = "0123456789ABCDEF";
+    std::string encoded;
+    for(unsigned char c : text) {
+        if(isalnum(c) || c == '-' || c == '.' || c == '_') {
+            encoded += (char)c;
+        } else if(c == ' ') {
+            encoded += '+';
+        } else {
+            encoded += '%';
+            encoded += HEX[c >> 4];
+            encoded += HEX[c & 0xF];
+        }
+    }
+    return encoded;
+}
+
+static std::string formBody(const std::string &event, const std::string &data, const char *site = SITE) {
+    return "event=" + event + "&data=" + formEncode(data) + "&published_at=2022-09-27T11%3A51%3A02.123Z&coreid=" + site;
+}
+
+// the rows of a form body, decoded as the server does; -1 if refused
+static int rowsOf(std::string body, std::vector<WSMIngestRow> &rows, const char **error = nullptr) {
+    body.push_back('\0');   // the spare byte
+    WSMWebhookPost post;
+    if(!parseWebhookForm(&body[0], body.size() - 1, post)) {
+        return -1;
+    }
+    return webhookRows(post, rows, error);
+}
+
+static bool sameFloat(float a, float b, float tolerance) {
+    return (std::isnan(a) && std::isnan(b)) || std::fabs(a - b) <= tolerance;
+}
+
+static bool sameRow(const WSMDataRow &a, const WSMDataRow &b) {
+    return a.etime == b.etime && a.event == b.event && a.pp == b.pp && a.wp == b.wp && sameFloat(a.temp, b.temp, 0.005f) &&
+           sameFloat(a.rh, b.rh, 0.005f) && sameFloat(a.ppon, b.ppon, 1e-4f) && sameFloat(a.wpon, b.wpon, 1e-4f);
+}
+
+static void testJsonReader() {
+    WSMJsonReader json;
+    std::string text = " { \"etime\" : 1664279461, \"ppon\":1.433333 ,\"msg\":\"say \\\"hi\\\"\",\"ok\":true}, {}";
+    double value;
+    std::string_view msg;
+    check(json.read(text) && json.size() == 4 && json.length() == text.find("},") + 1, "flat object read");
+    check(json.number("etime", value) && value == 1664279461.0 && json.number("ppon", value) && value == 1.433333 &&
+          !json.number("msg", value) && !json.number("missing", value) && !json.number("ok", value), "numbers");
+    check(json.string("msg", msg) && msg == "say \\\"hi\\\"" && msg.data() > text.data() &&
+          msg.data() < text.data() + text.size(), "strings point into the text, still escaped");
+    check(json.read(text.substr(json.length() + 1)) && json.size() == 0, "empty object");
+    check(!json.read("{\"a\":{\"b\":1}}") && !json.read("{\"a\":[1]}") && !json.read("{\"a\":1") &&
+          !json.read("{\"a\" 1}") && !json.read("[1]") && !json.read("{\"a\":\"open}") && !json.read("{\"a\":}"),
+          "malformed and nested refused");
+    std::string many = "{";
+    for(unsigned int i = 0; i <= WSMJsonReader::MAX_MEMBERS; i++) {
+        many += (i ? ",\"k" : "\"k") + std::to_string(i) + "\":" + std::to_string(i);
+    }
+    check(!json.read(many + "}"), "too many members refused");
+}
+
+static void testForm() {
+    std::string body = "event=wsmEventTRH&data=%7B%22etime%22%3A1%7D&x&published_at=2022-09-27T11%3A51%3A02.123Z"
+                       "&coreid=abc&extra=a+b";
+    body.push_back('\0');
+    WSMWebhookPost post;
+    check(parseWebhookForm(&body[0], body.size() - 1, post) && post.event == "wsmEventTRH" &&
+          post.data == "{\"etime\":1}" && post.data.data()[post.data.size()] == '\0' &&
+          post.publishedAt == "2022-09-27T11:51:02.123Z" && post.coreid == "abc", "form decoded in place");
+    std::string bad = "event=wsmEventTRH&data=%7";
+    bad.push_back('\0');
+    std::string noData = "event=wsmEventTRH";
+    noData.push_back('\0');
+    check(!parseWebhookForm(&bad[0], bad.size() - 1, post) && !parseWebhookForm(&noData[0], noData.size() - 1, post),
+          "bad escape and missing data refused");
+
+    // against timegm() over the range the devices run in
+    bool same = true;
+    for(time_t t = 0; t < 4102444800; t += 86400 * 37 + 3671) {
+        struct tm utc;
+        gmtime_r(&t, &utc);
+        char text[32];
+        strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S.000Z", &utc);
+        int64_t parsed;
+        same = same && parsePublishedAt(text, parsed) && parsed == (int64_t)t;
+    }
+    int64_t parsed;
+    check(same && parsePublishedAt("2024-02-29T23:59:59Z", parsed) && parsed == 1709251199 &&
+          !parsePublishedAt("2024-13-01T00:00:00Z", parsed) && !parsePublishedAt("yesterday", parsed), "published_at");
+}
+
+static void testRows() {
+    std::vector<WSMJournalRecord> events = day();
+
+    // one post per event
+    std::vector<WSMIngestRow> singles;
+    char json[JSON_EVENT_SIZE];
+    bool one = true;
+    for(const WSMJournalRecord &record : events) {
+        const char *name = WSMEventPack::eventJSON(record, -8.0f, json, sizeof(json));
+        one = one && rowsOf(formBody(name, json), singles) == 1;
+    }
+    const WSMIngestRow &first = singles[0];
+    const WSMIngestRow &off = singles[2];
+    check(one && singles.size() == events.size(), "one row per event");
+    check(first.row.event == WSM_EVENT_TRH && first.row.etime == 1664236800 && first.row.temp == 16.25f &&
+          first.row.rh == 60.75f && first.row.pp == -1 && std::isnan(first.row.ppon) && first.publishedAt == 1664279462 &&
+          memcmp(first.site, SITE, INGEST_SITE_SIZE) == 0, "TRH row");
+    check(off.row.event == WSM_EVENT_PP_STATUS && off.row.pp == 0 && off.row.wp == -1 && off.row.ppon == 1.5f &&
+          std::isnan(off.row.temp), "PP row");
+
+    // the same events batched, as the sketch's wsmEventBatch, and packed
+    std::vector<WSMIngestRow> batched, packed;
+    std::string batch = "{\"events\":[";
+    WSMEventPack pack;
+    pack.clear();
+    bool fits = true;
+    for(size_t i = 0; i < events.size(); i++) {
+        const char *name = WSMEventPack::eventJSON(events[i], -8.0f, json, sizeof(json));
+        batch += std::string(i ? "," : "") + "{\"ev\":\"" + name + "\"," + (json + 1);
+        fits = fits && pack.add(events[i]);
+    }
+    batch += "]}";
+    char packText[EVENT_PACK_SIZE * 2];
+    pack.encode(packText, sizeof(packText));
+    bool same = rowsOf(formBody("wsmEventBatch", batch), batched) == (int)events.size() &&
+                rowsOf(formBody(EVENT_PACK_NAME, packText), packed) == (int)events.size() && fits;
+    for(size_t i = 0; same && i < events.size(); i++) {
+        same = sameRow(batched[i].row, singles[i].row) && sameRow(packed[i].row, singles[i].row) &&
+               packed[i].publishedAt == singles[i].publishedAt;
+    }
+    check(same, "batched and packed events give the same rows");
+
+    // malformed posts add nothing
+    std::vector<WSMIngestRow> rows(3);
+    const char *error = "";
+    std::string cut = batch.substr(0, batch.size() / 2);
+    check(rowsOf(formBody("wsmEventBatch", cut), rows, &error) == -1 && rows.size() == 3 &&
+          strcmp(error, "malformed data") == 0, "cut short batch refused whole");
+    check(rowsOf(formBody("wsmAlertPPLong", "{\"etime\":1}"), rows, &error) == -1 && strcmp(error, "not a wsmEvent") == 0 &&
+          rowsOf(formBody("wsmEventPPstatus", "{\"pp\":1}"), rows) == -1 &&
+          rowsOf(formBody(EVENT_PACK_NAME, "AQ!!"), rows) == -1 && rows.size() == 3, "unknown events and bad data refused");
+
+    // values no row can hold
+    bool refused = true;
+    for(const char *data : {"{\"etime\":1,\"pp\":1e30}", "{\"etime\":1,\"wp\":2}", "{\"etime\":1,\"pp\":0.5}",
+                            "{\"etime\":1e300,\"pp\":1}", "{\"etime\":-1e19,\"pp\":1}", "{\"etime\":1,\"ppon\":1e39}"}) {
+        refused = refused && rowsOf(formBody("wsmEventPPstatus", data), rows, &error) == -1 &&
+                  strcmp(error, "malformed data") == 0;
+    }
+    std::string batchOut = "{\"events\":[{\"ev\":\"wsmEventWPstatus\",\"etime\":1,\"wp\":1e30}]}";
+    check(refused && rowsOf(formBody("wsmEventBatch", batchOut), rows) == -1 && rows.size() == 3,
+          "out of range values refused");
+}
+
+static WSMIngestRow storeRow(unsigned int thread, unsigned int n) {
+    WSMIngestRow row;
+    memset(&row, 0, sizeof(row));
+    row.row.etime = n;
+    row.row.temp = row.row.rh = row.row.wpon = NAN;
+    row.row.ppon = n / 60.0f;
+    row.row.pp = 0;
+    row.row.wp = -1;
+    row.row.event = WSM_EVENT_PP_STATUS;
+    row.publishedAt = 1000000 + n;
+    snprintf(row.site, sizeof(row.site), "thread%u", thread);
+    return row;
+}
+
+static void testStore() {
+    remove(STORE_PATH);
+    WSMIngestStore store;
+    check(store.open(STORE_PATH) && store.records() == 0, "new store");
+
+    std::vector<std::thread> threads;
+    for(unsigned int t = 0; t < STORE_THREADS; t++) {
+        threads.emplace_back([&store, t]() {
+            for(unsigned int n = 0; n < STORE_APPENDS; n++) {
+                WSMIngestRow rows[2] = {storeRow(t, 2 * n), storeRow(t, 2 * n + 1)};
+                store.append(rows, 2);
+            }
+        });
+    }
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+    uint64_t appends = STORE_THREADS * STORE_APPENDS;
+    printf("%llu appends in %llu commits\n", (unsigned long long)appends, (unsigned long long)store.commits());
+    check(store.records() == 2 * appends && store.commits() < appends, "appends from many threads grouped");
+    store.close();
+
+    std::vector<unsigned int> next(STORE_THREADS, 0);
+    bool inOrder = true;
+    int64_t records = WSMIngestStore::read(STORE_PATH, [&](const WSMIngestRow &row) {
+        unsigned int t = (unsigned int)atoi(row.site + 6);
+        WSMIngestRow expected = storeRow(t, next[t]++);
+        inOrder = inOrder && t < STORE_THREADS && memcmp(&row.row.etime, &expected.row.etime, 8) == 0 &&
+                  row.row.ppon == expected.row.ppon && std::isnan(row.row.temp) && row.row.pp == 0 && row.row.wp == -1 &&
+                  row.row.event == WSM_EVENT_PP_STATUS && row.publishedAt == expected.publishedAt;
+    });
+    check(records == (int64_t)(2 * appends) && inOrder, "records read back in each thread's order");
+
+    // a crash in the middle of a write: a record that fails its CRC, then part of one
+    uint8_t record[INGEST_RECORD_SIZE];
+    WSMIngestStore::encode(storeRow(0, 12345), record);
+    record[5] ^= 1;
+    FILE *file = fopen(STORE_PATH, "ab");
+    fwrite(record, 1, sizeof(record), file);
+    fwrite(record, 1, 7, file);
+    fclose(file);
+    check(WSMIngestStore::read(STORE_PATH, nullptr) == (int64_t)(2 * appends), "torn tail not read");
+    WSMIngestRow more = storeRow(1, 99999);
+    check(store.open(STORE_PATH) && store.truncatedBytes() == INGEST_RECORD_SIZE + 7 && store.records() == 2 * appends &&
+          store.append(&more, 1), "torn tail cut off, appends go on");
+    store.close();
+    check(WSMIngestStore::read(STORE_PATH, nullptr) == (int64_t)(2 * appends + 1), "appended after the cut");
+}
+
+// a blocking client connection to the server
+class Client {
+    public:
+        explicit Client(uint16_t port) {
+            sockaddr_in address;
+            memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_port = htons(port);
+            inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+            _fd = socket(AF_INET, SOCK_STREAM, 0);
+            connect(_fd, (sockaddr *)&address, sizeof(address));
+        }
+        ~Client() { close(_fd); }
+
+        void send(const std::string &text) { ::send(_fd, text.data(), text.size(), MSG_NOSIGNAL); }
+
+        // the next reply as "<status> <body>"; "" if the connection closed
+        std::string reply() {
+            while(true) {
+                size_t headEnd = _received.find("\r\n\r\n");
+                if(headEnd != std::string::npos) {
+                    size_t header = _received.find("Content-Length: ");
+                    size_t length = strtoul(_received.c_str() + header + 16, nullptr, 10);
+                    if(_received.size() >= headEnd + 4 + length) {
+                        std::string text = _received.substr(9, 4) + _received.substr(headEnd + 4, length);
+                        _received.erase(0, headEnd + 4 + length);
+                        return text;
+                    }
+                }
+                char buffer[4096];
+                ssize_t n = recv(_fd, buffer, sizeof(buffer), 0);
+                if(n <= 0) {
+                    return "";
+                }
+                _received.append(buffer, n);
+            }
+        }
+
+    private:
+        int _fd;
+        std::string _received;
+};
+
+static std::string postRequest(const std::string &body, bool close = false) {
+    return "POST /wsm HTTP/1.1\r\nHost: test\r\nContent-Type: application/x-www-form-urlencoded\r\nContent-Length: " +
+           std::to_string(body.size()) + (close ? "\r\nConnection: close" : "") + "\r\n\r\n" + body;
+}
+
+static void testServer() {
+    remove(STORE_PATH);
+    WSMIngestStore store;
+    WSMIngestServer server(store);
+    check(store.open(STORE_PATH) && server.start(0, "127.0.0.1") && server.port() != 0, "server started");
+
+    char json[JSON_EVENT_SIZE];
+    std::vector<std::string> posts;
+    for(const WSMJournalRecord &record : day()) {
+        const char *name = WSMEventPack::eventJSON(record, -8.0f, json, sizeof(json));
+        posts.push_back(postRequest(formBody(name, json)));
+    }
+    {
+        Client client(server.port());
+        client.send(posts[0]);
+        check(client.reply() == "200 1\n", "post stored");
+
+        // three posts in one send, the second split across two
+        std::string pipelined = posts[1] + posts[2] + posts[3];
+        client.send(pipelined.substr(0, posts[1].size() + 20));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        client.send(pipelined.substr(posts[1].size() + 20));
+        check(client.reply() == "200 1\n" && client.reply() == "200 1\n" && client.reply() == "200 1\n",
+              "keep-alive and pipelined posts");
+
+        // a batch of no events stores nothing, and does not wait for a commit that never comes
+        client.send(postRequest(formBody("wsmEventBatch", "{\"events\":[]}")));
+        check(client.reply() == "200 0\n", "empty batch answered");
+
+        client.send(postRequest(formBody("wsmEventPPstatus", "{\"pp\":")));
+        check(client.reply() == "400 malformed data\n", "malformed post refused");
+        client.send(postRequest(formBody("wsmEventPPstatus", "{\"etime\":1,\"pp\":1e30}")));
+        check(client.reply() == "400 malformed data\n", "out of range post refused");
+        client.send("GET /other HTTP/1.1\r\n\r\nPUT / HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+        check(client.reply().compare(0, 4, "404 ") == 0 && client.reply().compare(0, 4, "405 ") == 0,
+              "other paths and methods refused");
+        client.send("GET /stats HTTP/1.1\r\n\r\n");
+        check(client.reply() == "200 {\"posts\":5,\"events\":4,\"refused\":4,\"records\":4,\"commits\":4}\n", "stats");
+        client.send(postRequest(formBody("wsmEventTRH", json), true));
+        check(client.reply().compare(0, 4, "200 ") == 0 && client.reply() == "", "Connection: close honoured");
+    }
+    {
+        Client client(server.port());
+        client.send(postRequest(std::string(INGEST_REQUEST_SIZE, 'x')));
+        check(client.reply().compare(0, 4, "413 ") == 0 && client.reply() == "", "too long refused and closed");
+    }
+    // a Content-Length that would wrap the length check, or is not a length at all
+    {
+        Client client(server.port());
+        client.send("POST / HTTP/1.1\r\nContent-Length: 18446744073709551615\r\n\r\nevent=x");
+        check(client.reply().compare(0, 4, "413 ") == 0 && client.reply() == "", "largest Content-Length refused and closed");
+    }
+    for(const char *length : {"18446744073709551616", "-1", "12x", ""}) {
+        Client client(server.port());
+        client.send(std::string("POST / HTTP/1.1\r\nContent-Length: ") + length + "\r\n\r\nevent=x");
+        check(client.reply() == "400 bad Content-Length\n" && client.reply() == "",
+              (std::string("Content-Length \"") + length + "\" refused and closed").c_str());
+    }
+
+    // posts from several connections at once, one site each
+    uint64_t before = store.records();
+    std::vector<std::thread> threads;
+    std::vector<unsigned int> stored(CLIENT_THREADS, 0);
+    for(unsigned int t = 0; t < CLIENT_THREADS; t++) {
+        threads.emplace_back([&, t]() {
+            Client client(server.port());
+            std::string site = "site" + std::to_string(t);
+            for(unsigned int n = 0; n < CLIENT_POSTS; n++) {
+                std::string data = "{\"etime\":" + std::to_string(n) + ",\"pp\":1}";
+                client.send(postRequest(formBody("wsmEventPPstatus", data, site.c_str())));
+                stored[t] += client.reply() == "200 1\n";
+            }
+        });
+    }
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+    bool all = true;
+    for(unsigned int count : stored) {
+        all = all && count == CLIENT_POSTS;
+    }
+    check(all && store.records() == before + CLIENT_THREADS * CLIENT_POSTS, "posts from 8 connections stored");
+    server.stop();
+    store.close();
+
+    std::vector<int64_t> next(CLIENT_THREADS, 0);
+    bool inOrder = true;
+    WSMIngestStore::read(STORE_PATH, [&](const WSMIngestRow &row) {
+        if(strncmp(row.site, "site", 4) == 0) {
+            unsigned int t = (unsigned int)atoi(row.site + 4);
+            inOrder = inOrder && t < CLIENT_THREADS && row.row.etime == next[t]++ && row.row.pp == 1;
+        }
+    });
+    check(inOrder, "each connection's rows in order");
+    remove(STORE_PATH);
+}
+
+int main() {
+    testJsonReader();
+    testForm();
+    testRows();
+    testStore();
+    testServer();
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
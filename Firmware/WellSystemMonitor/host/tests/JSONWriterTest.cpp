@@ -0,0 +1,103 @@
+/***************************************************************************************************/
+// JSONWriterTest.cpp
+//  Checks src/JSONWriter: number and string formatting, escaping, overflow handling, and that
+//  formatFloat() and formatTime() write what String(float, decimals) and Time.format() write.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "JSONWriter.h"
+#include "TestCheck.h"
+#include "application.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+int main() {
+    {
+        char buffer[JSON_EVENT_SIZE];
+        JSONWriter json(buffer, sizeof(buffer));
+        json.key("etime", (time_t)1704067200);
+        json.key("pp", 1);
+        json.key("n", -42);
+        json.key("u", 4000000000u);
+        json.key("ppon", 1.4f, 6);
+        json.key("loctime", "2023-12-31 16:00:00");
+        json.end();
+        check(strcmp(buffer, "{\"etime\":1704067200,\"pp\":1,\"n\":-42,\"u\":4000000000,\"ppon\":1.400000,"
+                             "\"loctime\":\"2023-12-31 16:00:00\"}") == 0 && !json.overflow(), "typed elements");
+    }
+    {
+        char buffer[64];
+        JSONWriter json(buffer, sizeof(buffer));
+        json.key("msg", "say \"hi\"\\\n\t\x01");
+        json.end();
+        check(strcmp(buffer, "{\"msg\":\"say \\\"hi\\\"\\\\\\n\\t\\u0001\"}") == 0, "strings are escaped");
+    }
+    {
+        char buffer[8];
+        JSONWriter empty(buffer, sizeof(buffer));
+        empty.end();
+        check(strcmp(buffer, "{}") == 0 && !empty.overflow(), "empty object");
+    }
+    {
+        char buffer[24];
+        JSONWriter json(buffer, sizeof(buffer));
+        json.key("a", 1);
+        json.key("long", "this does not fit in the buffer");
+        json.key("b", 2);
+        json.end();
+        check(json.overflow() && strcmp(buffer, "{\"a\":1}") == 0, "overflow keeps the elements that fit");
+    }
+
+    // formatFloat against String(float, decimals) (printf), including ties and negative zero
+    std::mt19937 random(11);
+    bool same = true;
+    char mine[64];
+    const float SPECIAL[] = {0.0f, -0.0f, 0.5f, 1.5f, 2.5f, -0.001f, 0.125f, 0.375f, 1e-7f, 123456.789f, 3.0e12f,
+                             1.0e20f, -1.0e20f, NAN, INFINITY};
+    for(float value : SPECIAL) {
+        for(int decimals = 0; decimals <= 6; decimals++) {
+            JSONWriter::formatFloat(mine, sizeof(mine), value, decimals);
+            same = same && String(value, decimals).str() == mine;
+        }
+    }
+    for(int i = 0; i < 1000000; i++) {
+        uint32_t bits = random();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        if(!std::isfinite(value) || fabsf(value) > 1e12f) {
+            value = (float)(random() % 2000000) / 1000.0f - 1000.0f;
+        }
+        int decimals = random() % 7;
+        JSONWriter::formatFloat(mine, sizeof(mine), value, decimals);
+        if(String(value, decimals).str() != mine) {
+            printf("%.9g with %d decimals: %s, String gives %s\n", value, decimals, mine,
+                   String(value, decimals).c_str());
+            same = false;
+            break;
+        }
+    }
+    check(same, "formatFloat matches String(float, decimals)");
+    check(JSONWriter::formatFloat(mine, 4, 123.456f, 2) == 0, "formatFloat reports a short buffer");
+
+    // formatTime against Time.format() in UTC, across leap years and centuries
+    bool sameTime = true;
+    char timeString[TIME_STRING_SIZE];
+    Time.zone(0);
+    for(time_t t = -2208988800; t < 4102444800 && sameTime; t += 86400 * 7 + 3671) {
+        JSONWriter::formatTime(timeString, t);
+        sameTime = Time.format(t, "%F %T").str() == timeString;
+        if(!sameTime) {
+            printf("%lld: %s, Time.format gives %s\n", (long long)t, timeString, Time.format(t, "%F %T").c_str());
+        }
+    }
+    check(sameTime, "formatTime matches Time.format(\"%F %T\")");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
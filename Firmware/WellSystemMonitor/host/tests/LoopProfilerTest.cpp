@@ -0,0 +1,192 @@
+/***************************************************************************************************/
+// LoopProfilerTest.cpp
+//  Checks WSMLoopProfiler (buckets, stage and pass times, the longest pass and its stage, the JSON)
+//  on virtual time alone, which System.ticks() then counts on the host, and then runs the
+//  WellSystemMonitor sketch with every wsmEventPack publish blocking for 3 s while the pressure
+//  pump changes.  The pump run times must come out to the millisecond, so a slow publish does not
+//  stretch the pump debounce, and the profile must put the stalls in the publish stage, not in the
+//  inputs, through the loopProfile function and the LoopProfile variable.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "application.h"
+#include <WSMLoopProfiler.h>
+#include <WSMPumpStats.h>
+#include <JSONWriter.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// from the sketch
+void setup();
+void loop();
+extern WSMPumpStats pumpStats;
+
+const uint16_t PRESSURE_PUMP_SENSOR_PIN = A1;
+const uint64_t LOOP_PERIOD_MS = 10;
+const uint64_t STALL_MS = 3000;
+
+// run loop() every LOOP_PERIOD_MS of virtual time
+static void runFor(uint64_t ms) {
+    uint64_t end = ParticleHost::uptimeMillis() + ms;
+    while(ParticleHost::uptimeMillis() < end) {
+        loop();
+        ParticleHost::advanceMillis(LOOP_PERIOD_MS);
+    }
+}
+
+// pull a numeric field out of a flat JSON payload
+static double jsonNumber(const std::string &json, const char *key) {
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = json.find(pattern);
+    if(pos == std::string::npos) {
+        return -1.0;
+    }
+    return atof(json.c_str() + pos + pattern.size());
+}
+
+static void testBuckets() {
+    bool good = WSMLoopProfiler::bucket(0) == 0 && WSMLoopProfiler::bucket(1) == 0 && WSMLoopProfiler::bucket(2) == 1 &&
+                WSMLoopProfiler::bucket(3) == 1 && WSMLoopProfiler::bucket(4) == 2 &&
+                WSMLoopProfiler::bucket(0xFFFFFFFF) == PROFILE_BUCKETS - 1;
+    for(unsigned int k = 1; k < PROFILE_BUCKETS; k++) {
+        uint32_t lowest = WSMLoopProfiler::bucketMicros(k);
+        good = good && WSMLoopProfiler::bucket(lowest) == k && WSMLoopProfiler::bucket(lowest - 1) == k - 1;
+    }
+    check(good, "log2 buckets");
+}
+
+static void testStages() {
+    ParticleHost::reset();
+    ParticleHost::setRealTicks(false);
+    const char *const names[] = {"fast", "slow"};
+    WSMLoopProfiler profiler(names, 2);
+    profiler.begin();
+
+    // 20 passes of about 96 us and 6 ms, then one with a 3 s stall in the fast stage
+    for(int i = 0; i < 20; i++) {
+        profiler.startPass();
+        ParticleHost::advanceMicros(96);
+        profiler.lap(0);
+        ParticleHost::advanceMicros(6000);
+        profiler.lap(1);
+        profiler.endPass();
+    }
+    check(profiler.stage(0).count == 20 && profiler.stage(0).buckets[6] == 20, "fast stage in the 64 us bucket");
+    check(profiler.stage(1).count == 20 && profiler.stage(1).buckets[12] == 20, "slow stage in the 4096 us bucket");
+    check(profiler.maxStage() == 1, "longest pass from the slow stage");
+    uint32_t mean = (uint32_t)(profiler.pass().totalMicros / profiler.pass().count);
+    check(profiler.pass().count == 20 && mean >= 6096 && mean < 6200, "pass mean");
+
+    profiler.startPass();
+    ParticleHost::advanceMillis(STALL_MS);
+    profiler.lap(0);
+    profiler.lap(1);
+    profiler.endPass();
+    check(profiler.maxStage() == 0 && profiler.stage(0).maxMicros >= STALL_MS * 1000 &&
+          profiler.stage(0).maxMicros < STALL_MS * 1000 + 1000 && profiler.stage(0).maxAt == millis(),
+          "stall found in the fast stage");
+    check(profiler.stage(1).maxMicros < 6200 && profiler.stage(1).buckets[0] == 1, "slow stage not charged with it");
+
+    char json[JSON_EVENT_SIZE * 4];
+    check(profiler.writeSummary(json, sizeof(json)) &&
+          std::string(json).find("\"passes\":21,") != std::string::npos &&
+          std::string(json).find("\"maxStage\":\"fast\",\"fast\":300") != std::string::npos,
+          "summary JSON");
+    check(profiler.writeStage(1, json, sizeof(json)) &&
+          std::string(json).find("{\"stage\":\"slow\",\"count\":21,") == 0 &&
+          std::string(json).find("\"0\":1,\"4096\":20}") != std::string::npos,
+          "stage JSON");
+    check(profiler.writeStage(2, json, sizeof(json)) && std::string(json).find("{\"stage\":\"loop\"") == 0 &&
+          !profiler.writeStage(3, json, sizeof(json)), "pass JSON");
+    check(profiler.find("slow") == 1 && profiler.find("loop") == 2 && profiler.find("other") == -1, "find()");
+
+    profiler.begin();
+    check(profiler.pass().count == 0 && profiler.stage(0).maxMicros == 0 && profiler.maxStage() == -1,
+          "begin() starts over");
+}
+
+// the pack publishes block for STALL_MS, and the pressure pump changes a third of the way into
+// each one; the times it changed are the truth
+static std::vector<uint64_t> pumpChanges;
+
+static void slowPublish(const ParticleHost::PublishRecord &record) {
+    if(record.name != "wsmEventPack") {
+        return;
+    }
+    uint64_t at = ParticleHost::uptimeMillis() + STALL_MS / 3;
+    ParticleHost::schedulePin(at, PRESSURE_PUMP_SENSOR_PIN, pumpChanges.size() % 2 == 0 ? LOW : HIGH);
+    pumpChanges.push_back(at);
+    ParticleHost::advanceMillis(STALL_MS);
+}
+
+static void testSlowPublish() {
+    ParticleHost::reset();
+    ParticleHost::setRealTicks(false);
+    ParticleHost::setUnixTime(1664279461);
+    ParticleHost::setDHTReading(17.0, 60.0);
+
+    setup();
+    runFor(1000);
+
+    // a well pump cycle starts the chain of packs
+    ParticleHost::setPublishSink(slowPublish);
+    ParticleHost::setPin(A0, LOW);
+    runFor(60000);
+    ParticleHost::setPin(A0, HIGH);
+    runFor(3 * 3600000);
+    ParticleHost::setPublishSink(nullptr);
+
+    // every complete PP cycle, to the millisecond
+    unsigned int cycles = pumpChanges.size() / 2;
+    double truth = 0.0;
+    for(unsigned int i = 0; i < cycles; i++) {
+        truth += (double)(pumpChanges[2 * i + 1] - pumpChanges[2 * i]) / 60000.0;
+    }
+    truth /= cycles;
+    const WSMRunningStats &runs = pumpStats.runStats(PUMP_PP);
+    check(cycles >= 10 && runs.count() == cycles, "every PP cycle counted");
+    check(runs.mean() > truth - 0.5 / 60000.0 && runs.mean() < truth + 0.5 / 60000.0,
+          "PP run times to the millisecond through 3 s publishes");
+
+    // the stalls are the publish stage's; the inputs never waited on them
+    int publishMax = ParticleHost::callFunction("loopProfile", "publish");
+    std::string stage = ParticleHost::variable("LoopProfile");
+    check(publishMax >= (int)(STALL_MS * 1000) && stage.find("{\"stage\":\"publish\"") == 0 &&
+          jsonNumber(stage, "2097152") >= cycles * 2, "stalls in the publish stage histogram");
+    int inputsMax = ParticleHost::callFunction("loopProfile", "inputs");
+    check(inputsMax >= 0 && inputsMax < 1000 && jsonNumber(ParticleHost::variable("LoopProfile"), "max") == inputsMax,
+          "inputs stage not stalled");
+    int passMax = ParticleHost::callFunction("loopProfile", "");
+    std::string summary = ParticleHost::variable("LoopProfile");
+    check(passMax >= publishMax && summary.find("\"maxStage\":\"publish\"") != std::string::npos &&
+          jsonNumber(summary, "passes") > 1000000, "summary names the publish stage");
+    check(ParticleHost::callFunction("loopProfile", "bogus") == -1 && ParticleHost::variable("LoopProfile") == summary,
+          "unknown stage refused");
+
+    // the view stays through the refresh every minute, and reset starts over
+    ParticleHost::callFunction("loopProfile", "loop");
+    runFor(61000);
+    check(ParticleHost::variable("LoopProfile").find("{\"stage\":\"loop\"") == 0, "view kept on refresh");
+    ParticleHost::callFunction("loopProfile", "reset");
+    check(jsonNumber(ParticleHost::variable("LoopProfile"), "passes") == 0.0, "reset");
+    runFor(61000);
+    double passes = jsonNumber(ParticleHost::variable("LoopProfile"), "passes");
+    check(passes > 0 && passes <= 6100 && jsonNumber(ParticleHost::variable("LoopProfile"), "max") < 1000000,
+          "refreshed every minute");
+}
+
+int main() {
+    testBuckets();
+    testStages();
+    testSlowPublish();
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+/***************************************************************************************************/
+// PublishBatcherTest.cpp
+//  Checks WSMPublishBatcher: the batch payload and its size limit, flushing on size, age and
+//  request, retries and dropping while the publishes fail, the counters, and that a stream of
+//  events faster than the Particle publish limit gets through batched where it is cut down
+//  published one by one.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "JSONWriter.h"
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "WSMPublishBatcher.h"
+#include "WSMWebhook.h"
+#include "application.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+const system_tick_t MAX_AGE_MS = 300000;
+
+// a pressure pump off event as the sketch builds it: 82 bytes, 98 in a batch
+static std::string ppOffEvent(int n) {
+    char data[128];
+    snprintf(data, sizeof(data), "{\"etime\":%d,\"pp\":0,\"ppon\":1.400000,\"loctime\":\"2024-01-01 00:00:00\"}",
+             1704067200 + n);
+    return data;
+}
+
+// every event published so far, batches split
+static std::vector<ParticleHost::PublishRecord> events() {
+    std::vector<ParticleHost::PublishRecord> result;
+    for(const ParticleHost::PublishRecord &record : ParticleHost::published()) {
+        expandBatch(record, [&](const ParticleHost::PublishRecord &event) { result.push_back(event); });
+    }
+    return result;
+}
+
+static void restart(WSMPublishBatcher &batcher) {
+    ParticleHost::reset();
+    ParticleHost::setUnixTime(1704067200);
+    batcher.begin();
+}
+
+int main() {
+    WSMPublishBatcher batcher("wsmEventBatch", MAX_AGE_MS);
+
+    // payload format
+    restart(batcher);
+    batcher.add("wsmEventPPstatus", "{\"etime\":1704067200,\"pp\":1}");
+    batcher.add("wsmEventTest", "{}");
+    check(ParticleHost::publishCount() == 0 && batcher.pending(), "events held");
+    check(batcher.flush() && !batcher.pending(), "flush");
+    check(ParticleHost::published().size() == 1 && ParticleHost::published()[0].name == "wsmEventBatch" &&
+          ParticleHost::published()[0].data ==
+              "{\"events\":[{\"ev\":\"wsmEventPPstatus\",\"etime\":1704067200,\"pp\":1},{\"ev\":\"wsmEventTest\"}]}",
+          "batch payload");
+    std::vector<ParticleHost::PublishRecord> split = events();
+    check(split.size() == 2 && split[0].name == "wsmEventPPstatus" && split[0].data == "{\"etime\":1704067200,\"pp\":1}" &&
+          split[1].name == "wsmEventTest" && split[1].data == "{}", "batch splits back into the events");
+    check(batcher.flush() && ParticleHost::publishCount() == 1, "flushing an empty batch publishes nothing");
+
+    // size: every publish stays under the limit and the events come out in order
+    restart(batcher);
+    const int MANY = 100;
+    for(int i = 0; i < MANY; i++) {
+        batcher.add("wsmEventPPstatus", ppOffEvent(i).c_str());
+    }
+    batcher.flush();
+    size_t largest = 0;
+    for(const ParticleHost::PublishRecord &record : ParticleHost::published()) {
+        largest = std::max(largest, record.data.size());
+    }
+    split = events();
+    bool inOrder = split.size() == MANY;
+    for(size_t i = 0; inOrder && i < split.size(); i++) {
+        inOrder = split[i].name == "wsmEventPPstatus" && split[i].data == ppOffEvent((int)i) &&
+                  split[i].unixTime == 1704067200 + (time_t)i;
+    }
+    printf("%d events in %llu publishes, largest %zu bytes\n", MANY, (unsigned long long)ParticleHost::publishCount(), largest);
+    check(largest <= PUBLISH_DATA_LIMIT && largest > PUBLISH_DATA_LIMIT - 98, "batches filled up to the publish limit");
+    check(ParticleHost::publishCount() == (MANY + 5) / 6, "six events per publish");
+    check(inOrder, "every event published once, in order");
+
+    // age: the batch goes out maxAge after its first event, across the millis() rollover
+    restart(batcher);
+    ParticleHost::setMillisOffset(0xFFFFFFFFu - 1000);
+    batcher.begin();
+    batcher.add("wsmEventPPstatus", ppOffEvent(0).c_str());
+    ParticleHost::advanceMillis(120000);
+    batcher.add("wsmEventPPstatus", ppOffEvent(1).c_str());
+    check(batcher.msUntilDue() == MAX_AGE_MS - 120000, "due maxAge after the first event");
+    ParticleHost::advanceMillis(MAX_AGE_MS - 120000 - 1);
+    batcher.process();
+    check(ParticleHost::publishCount() == 0, "not published before maxAge");
+    ParticleHost::advanceMillis(1);
+    batcher.process();
+    check(ParticleHost::publishCount() == 1 && events().size() == 2, "published at maxAge");
+    check(batcher.msUntilDue() == 0xFFFFFFFF, "nothing due when empty");
+
+    // publishNow() sends the batch first
+    restart(batcher);
+    batcher.add("wsmEventPPstatus", ppOffEvent(0).c_str());
+    batcher.publishNow("wsmEventTRH", "{\"etime\":1704067201}");
+    split = events();
+    check(ParticleHost::publishCount() == 2 && split.size() == 2 && split[0].name == "wsmEventPPstatus" &&
+          split[1].name == "wsmEventTRH", "publishNow() keeps the events in order");
+
+    // a failed publish is retried a second later; the batch keeps filling meanwhile
+    restart(batcher);
+    batcher.add("wsmEventPPstatus", ppOffEvent(0).c_str());
+    ParticleHost::setCloudConnected(false);
+    check(!batcher.flush() && batcher.pending() && batcher.get_publishFailures() == 1, "failed flush keeps the batch");
+    batcher.add("wsmEventPPstatus", ppOffEvent(1).c_str());
+    ParticleHost::setCloudConnected(true);
+    ParticleHost::advanceMillis(999);
+    batcher.process();
+    check(ParticleHost::publishCount() == 0, "no retry within a second");
+    ParticleHost::advanceMillis(1);
+    batcher.process();
+    check(ParticleHost::publishCount() == 1 && events().size() == 2 && batcher.get_eventsDropped() == 0,
+          "retried after a second");
+
+    // while the cloud is away, a full batch makes way for newer events
+    restart(batcher);
+    ParticleHost::setCloudConnected(false);
+    for(int i = 0; i < 20; i++) {
+        batcher.add("wsmEventPPstatus", ppOffEvent(i).c_str());
+        ParticleHost::advanceMillis(1000);
+        batcher.process();
+    }
+    ParticleHost::setCloudConnected(true);
+    batcher.flush();
+    split = events();
+    check(batcher.get_events() == 20 && batcher.get_eventsDropped() == 18 && batcher.get_eventsPublished() == 2 &&
+          split.size() == 2 && split[0].data == ppOffEvent(18) && split[1].data == ppOffEvent(19),
+          "oldest events dropped while disconnected");
+    char stats[JSON_EVENT_SIZE];
+    batcher.writeStats(stats, sizeof(stats));
+    printf("%s\n", stats);
+    check(std::string(stats).find("\"events\":20,\"published\":2,\"dropped\":18,\"dropPct\":90.00,\"publishes\":1,") == 1,
+          "stats");
+    check(batcher.statsChanged() && !batcher.statsChanged(), "stats change flag");
+
+    // publishes per hour
+    restart(batcher);
+    for(int i = 0; i < 7; i++) {
+        batcher.publishNow("wsmEventTRH", "{\"etime\":1704067200}");
+    }
+    ParticleHost::advanceMillis(3600000);
+    batcher.process();
+    batcher.publishNow("wsmEventTRH", "{\"etime\":1704067200}");
+    check(batcher.get_publishesLastHour() == 7, "publishes in the last hour");
+
+    // events every 600 ms for ten minutes, against the one a second publish limit
+    uint64_t published[2] = {}, dropped[2] = {};
+    for(int batched = 0; batched < 2; batched++) {
+        restart(batcher);
+        ParticleHost::setPublishRateLimit(true);
+        uint64_t lost = 0;
+        for(int i = 0; i < 1000; i++) {
+            std::string data = ppOffEvent(i);
+            if(batched) {
+                batcher.add("wsmEventPPstatus", data.c_str());
+            } else if(!Particle.publish("wsmEventPPstatus", data.c_str(), PRIVATE)) {
+                lost++;
+            }
+            ParticleHost::advanceMillis(600);
+            batcher.process();
+        }
+        batcher.flush();
+        published[batched] = ParticleHost::publishCount();
+        dropped[batched] = batched ? batcher.get_eventsDropped() : lost;
+        printf("%s: 1000 events, %llu publishes, %llu events dropped\n", batched ? "batched" : "one by one",
+               (unsigned long long)published[batched], (unsigned long long)dropped[batched]);
+    }
+    check(dropped[0] > 300, "one by one exceeds the publish limit");
+    check(dropped[1] == 0 && published[1] < 200 && events().size() == 1000, "batched publishes every event");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
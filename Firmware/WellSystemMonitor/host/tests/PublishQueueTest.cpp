@@ -0,0 +1,394 @@
+/***************************************************************************************************/
+// PublishQueueTest.cpp
+//  Checks WSMPublishQueue: order, the two drop policies and their counts, the retry backoff on a
+//  fake clock, payloads that don't fit and the stats JSON; that the journal keeps the events of a
+//  pack the full queue refused pending until the batcher's retry sends it; then pushes 10,000 events a second for
+//  two seconds, with each policy, through a worker thread whose publisher takes 200 us a publish.
+//  Every event must come out once, in order and whole (a slot dropped while the worker copied it
+//  must never be published), and enqueued, sent, dropped and refused must add up.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "application.h"
+#include <WSMPublishQueue.h>
+#include <WSMPublishBatcher.h>
+#include <WSMEventJournal.h>
+#include <JSONWriter.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+const unsigned int STRESS_RATE = 10000;     // events a second
+const unsigned int STRESS_EVENTS = 20000;
+const unsigned int SLOW_PUBLISH_US = 200;
+
+// the fake publisher and clock of the single threaded checks
+static std::vector<std::string> sent;
+static bool publishWorks = true;
+static system_tick_t fakeNow = 0;
+
+static bool fakePublish(const char *eventName, const char *eventData) {
+    if(!publishWorks) {
+        return false;
+    }
+    sent.push_back(std::string(eventName) + " " + eventData);
+    return true;
+}
+
+static system_tick_t fakeClock() {
+    return fakeNow;
+}
+
+static void restart(WSMPublishQueue &queue) {
+    queue.begin();
+    sent.clear();
+    publishWorks = true;
+    fakeNow = 0;
+}
+
+static void drain(WSMPublishQueue &queue) {
+    while(queue.service()) {
+    }
+}
+
+static void testOrderAndPolicies() {
+    WSMPublishQueue newest(DROP_NEWEST, fakePublish, fakeClock);
+    restart(newest);
+    check(!newest.startWorker(), "no worker thread on the host");
+
+    bool accepted = true;
+    for(unsigned int i = 0; i < PUBLISH_QUEUE_SLOTS; i++) {
+        accepted = accepted && newest.publish("ev", std::to_string(i).c_str(), 2);
+    }
+    check(accepted && newest.waiting() == PUBLISH_QUEUE_SLOTS, "ring filled");
+    check(!newest.publish("ev", "late", 3) && newest.get_refused() == 1 && newest.get_dropped() == 0 &&
+          newest.get_eventsDropped() == 0, "DROP_NEWEST refuses when full, and drops nothing");
+    newest.process();
+    bool inOrder = sent.size() == PUBLISH_QUEUE_SLOTS;
+    for(unsigned int i = 0; inOrder && i < sent.size(); i++) {
+        inOrder = sent[i] == "ev " + std::to_string(i);
+    }
+    check(inOrder && newest.get_sent() == PUBLISH_QUEUE_SLOTS && newest.get_eventsSent() == 2 * PUBLISH_QUEUE_SLOTS &&
+          newest.get_enqueued() == PUBLISH_QUEUE_SLOTS && newest.waiting() == 0, "published in order");
+
+    WSMPublishQueue oldest(DROP_OLDEST, fakePublish, fakeClock);
+    restart(oldest);
+    for(unsigned int i = 0; i < PUBLISH_QUEUE_SLOTS + 3; i++) {
+        accepted = oldest.publish("ev", std::to_string(i).c_str(), i);
+    }
+    check(accepted && oldest.get_dropped() == 3 && oldest.get_eventsDropped() == 0 + 1 + 2 &&
+          oldest.waiting() == PUBLISH_QUEUE_SLOTS, "DROP_OLDEST takes the oldest slots");
+    drain(oldest);
+    check(sent.size() == PUBLISH_QUEUE_SLOTS && sent.front() == "ev 3" && sent.back() == "ev 10", "the newest published");
+
+    // the event in the worker's hands is not dropped
+    restart(oldest);
+    publishWorks = false;
+    for(unsigned int i = 0; i < PUBLISH_QUEUE_SLOTS; i++) {
+        oldest.publish("ev", std::to_string(i).c_str());
+    }
+    oldest.service();   // takes 0, which fails
+    oldest.publish("ev", std::to_string(PUBLISH_QUEUE_SLOTS).c_str());
+    oldest.publish("ev", "new");   // drops 1
+    publishWorks = true;
+    fakeNow = PUBLISH_RETRY_MS;
+    drain(oldest);
+    check(sent.size() == PUBLISH_QUEUE_SLOTS + 1 && sent.front() == "ev 0" && sent[1] == "ev 2" && sent.back() == "ev new",
+          "the event in hand kept");
+
+    // what can't be published
+    std::string longName(PUBLISH_NAME_SIZE, 'n');
+    std::string longData(PUBLISH_DATA_LIMIT + 1, 'd');
+    restart(newest);
+    check(!newest.publish(longName.c_str(), "x") && !newest.publish("ev", longData.c_str(), 4) &&
+          newest.publish("ev", longData.c_str() + 1) && newest.get_dropped() == 2 && newest.get_eventsDropped() == 4 &&
+          newest.get_refused() == 0,
+          "too long refused, the publish limit accepted");
+}
+
+// the sketch's drainJournal(): the journal's events go to the batcher, which publishes through the
+// queue, and are confirmed once the queue has sent or dropped them
+struct JournalDrain {
+    WSMEventJournal &journal;
+    WSMPublishBatcher &batcher;
+    WSMPublishQueue &queue;
+    unsigned int lastHandled = 0;
+    WSMJournalRecord record;
+    bool taken = false;
+
+    // take out and batch what the journal lets go
+    void drain() {
+        while(!batcher.retrying()) {
+            if(!taken && !(taken = journal.next(record))) {
+                break;
+            }
+            if(batcher.add(record)) {
+                taken = false;
+            }
+        }
+    }
+
+    void confirmHandled() {
+        unsigned int handled = queue.get_eventsSent() + queue.get_eventsDropped();
+        journal.confirm(handled - lastHandled);
+        lastHandled = handled;
+    }
+};
+
+static void testJournalAccounting() {
+    ParticleHost::reset();
+    WSMPublishQueue queue(DROP_NEWEST, fakePublish, fakeClock);
+    restart(queue);
+    WSMEventJournal journal(0, 16, 0);
+    journal.begin();
+    WSMPublishBatcher batcher("wsmEventBatch", 60000);
+    batcher.publishVia(&queue);
+    batcher.begin();
+    JournalDrain drainer{journal, batcher, queue};
+    auto confirmHandled = [&]() { drainer.confirmHandled(); };
+    auto drain = [&]() { drainer.drain(); };
+
+    // the queue full of other publications refuses the pack
+    for(unsigned int i = 0; i < PUBLISH_QUEUE_SLOTS; i++) {
+        queue.publish("WSM", "other");
+    }
+    WSMJournalRecord record = {JOURNAL_PP_ON, false, 1664279461, 0.0f, 0.0f};
+    for(int i = 0; i < 3; i++) {
+        record.etime++;
+        journal.append(record);
+    }
+    drain();
+    check(!batcher.flush() && queue.get_refused() == 1, "full queue refuses the pack");
+    confirmHandled();
+    check(journal.pending() == 3 && queue.get_eventsDropped() == 0 && batcher.get_eventsDropped() == 0,
+          "refused pack's events still pending");
+
+    // the queue empties; the batcher's retry goes, and its events are drained once
+    queue.process();
+    confirmHandled();
+    check(journal.pending() == 3 && batcher.pending(), "pending until the retry");
+    ParticleHost::advanceMillis(batcher.msUntilDue());
+    batcher.process();
+    queue.process();
+    confirmHandled();
+    check(journal.pending() == 0 && journal.get_drained() == 3 && queue.get_eventsSent() == 3, "retried pack drained once");
+
+    // an event taken out but not yet published stays pending
+    record.etime++;
+    journal.append(record);
+    drain();
+    queue.process();
+    confirmHandled();
+    check(journal.pending() == 1 && journal.unsent() == 0, "event in the batcher not drained");
+}
+
+// more journaled events than a pack holds, while the queue is full: the batcher must not drop the
+// held pack to make room, and the journal must not count any of them drained until they are sent
+static void testJournalFullQueue() {
+    ParticleHost::reset();
+    WSMPublishQueue queue(DROP_NEWEST, fakePublish, fakeClock);
+    restart(queue);
+    WSMEventJournal journal(0, JOURNAL_MAX_RECORDS, 0);
+    journal.begin();
+    WSMPublishBatcher batcher("wsmEventBatch", 60000);
+    batcher.publishVia(&queue);
+    batcher.begin();
+    JournalDrain drainer{journal, batcher, queue};
+
+    for(unsigned int i = 0; i < PUBLISH_QUEUE_SLOTS; i++) {
+        queue.publish("WSM", "other");
+    }
+    WSMJournalRecord record = {JOURNAL_TRH, false, 1664279461, 71.5f, 48.25f};
+    for(unsigned int i = 0; i < JOURNAL_MAX_RECORDS; i++) {
+        record.etime += 600;
+        record.value1 += 0.37f;
+        journal.append(record);
+    }
+    // drain as loop() would, for a minute with the queue full
+    for(int pass = 0; pass < 60; pass++) {
+        drainer.drain();
+        batcher.process();
+        drainer.confirmHandled();
+        ParticleHost::advanceMillis(1000);
+    }
+    check(batcher.retrying() && batcher.get_eventsDropped() == 0 && journal.pending() == JOURNAL_MAX_RECORDS &&
+          journal.get_drained() == 0, "full queue: pack held, nothing dropped or drained");
+
+    // the queue empties: every event goes, and is drained once
+    for(int pass = 0; pass < 600 && journal.pending() > 0; pass++) {
+        queue.process();
+        drainer.drain();
+        batcher.process();
+        if(!batcher.retrying()) {
+            batcher.flush();
+        }
+        queue.process();
+        drainer.confirmHandled();
+        ParticleHost::advanceMillis(1000);
+    }
+    check(journal.pending() == 0 && journal.get_drained() == JOURNAL_MAX_RECORDS &&
+          queue.get_eventsSent() == JOURNAL_MAX_RECORDS && batcher.get_eventsDropped() == 0 &&
+          journal.get_dropped() == 0, "every journaled event sent and drained once");
+}
+
+static void testBackoff() {
+    WSMPublishQueue queue(DROP_NEWEST, fakePublish, fakeClock);
+    restart(queue);
+    publishWorks = false;
+    queue.publish("ev", "retried");
+
+    // attempts at 0, then 1, 2, 4, 8, 16, 16 s after each failure
+    std::vector<system_tick_t> tried;
+    for(fakeNow = 0; fakeNow <= 70000; fakeNow += 100) {
+        if(queue.service()) {
+            tried.push_back(fakeNow);
+        }
+    }
+    std::vector<system_tick_t> expected = {0, 1000, 3000, 7000, 15000, 31000, 47000, 63000};
+    check(tried == expected && queue.get_failed() == expected.size() && queue.get_sent() == 0, "retry backoff");
+
+    publishWorks = true;
+    fakeNow = 79000;
+    check(queue.service() && sent.size() == 1 && queue.get_sent() == 1, "sent after the backoff");
+
+    // the backoff starts over after a success
+    publishWorks = false;
+    queue.publish("ev", "again");
+    queue.service();
+    fakeNow += PUBLISH_RETRY_MS - 1;
+    bool early = queue.service();
+    fakeNow += 1;
+    check(!early && queue.service() && queue.get_failed() == expected.size() + 2, "backoff starts over");
+
+    // the counts, across the rollover of the clock
+    restart(queue);
+    fakeNow = 0xFFFFFFFF - 500;
+    publishWorks = false;
+    queue.publish("ev", "rollover");
+    queue.service();
+    fakeNow += PUBLISH_RETRY_MS;
+    publishWorks = true;
+    check(queue.service() && sent.size() == 1, "backoff across the millis() rollover");
+    check(queue.statsChanged() && !queue.statsChanged(), "statsChanged() once");
+    char json[JSON_EVENT_SIZE];
+    queue.writeStats(json, sizeof(json));
+    check(std::string(json) == "{\"enqueued\":1,\"sent\":1,\"failed\":1,\"dropped\":0,\"refused\":0,\"waiting\":0}", "stats JSON");
+}
+
+// the stress test's slow publisher, on the worker thread: events go out as "<sequence>" with
+// their sequence repeated to fill the payload, so that a torn copy shows
+static std::vector<unsigned int> stressSent;
+static unsigned int stressTorn = 0;
+
+static std::string stressPayload(unsigned int sequence) {
+    std::string payload;
+    std::string word = std::to_string(sequence) + ";";
+    while(payload.size() + word.size() <= 200 + sequence % 300) {
+        payload += word;
+    }
+    return payload;
+}
+
+static bool slowPublish(const char *eventName, const char *eventData) {
+    unsigned int sequence = (unsigned int)strtoul(eventData, NULL, 10);
+    if(std::string(eventName) != "ev" + std::to_string(sequence % 7) || eventData != stressPayload(sequence)) {
+        stressTorn++;
+    }
+    stressSent.push_back(sequence);
+    std::this_thread::sleep_for(std::chrono::microseconds(SLOW_PUBLISH_US));
+    return true;
+}
+
+static system_tick_t steadyMillis() {
+    return (system_tick_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void testStress(WSMDropPolicy policy, const char *name) {
+    WSMPublishQueue queue(policy, slowPublish, steadyMillis);
+    queue.begin();
+    stressSent.clear();
+    stressTorn = 0;
+
+    std::vector<std::string> payloads(STRESS_EVENTS);
+    for(unsigned int i = 0; i < STRESS_EVENTS; i++) {
+        payloads[i] = stressPayload(i);
+    }
+
+    std::atomic<bool> stop(false);
+    std::thread worker([&]() {
+        while(true) {
+            if(!queue.service()) {
+                if(stop.load() && queue.waiting() == 0) {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    });
+
+    // STRESS_RATE events a second, on schedule
+    unsigned int accepted = 0;
+    unsigned int acceptedEvents = 0;
+    double producerNanos = 0.0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(unsigned int i = 0; i < STRESS_EVENTS; i++) {
+        std::this_thread::sleep_until(start + std::chrono::microseconds((uint64_t)i * 1000000 / STRESS_RATE));
+        std::string eventName = "ev" + std::to_string(i % 7);
+        std::chrono::steady_clock::time_point before = std::chrono::steady_clock::now();
+        bool ok = queue.publish(eventName.c_str(), payloads[i].c_str(), 1 + i % 3);
+        producerNanos += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - before).count();
+        if(ok) {
+            accepted++;
+            acceptedEvents += 1 + i % 3;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stop.store(true);
+    worker.join();
+
+    bool ordered = true;
+    for(size_t i = 1; i < stressSent.size(); i++) {
+        ordered = ordered && stressSent[i] > stressSent[i - 1];
+    }
+
+    printf("%s: %u events in %.2f s (%.0f/s), %u sent, %u dropped, %u refused, publish() %.0f ns\n", name, STRESS_EVENTS,
+           seconds, STRESS_EVENTS / seconds, queue.get_sent(), queue.get_dropped(), queue.get_refused(),
+           producerNanos / STRESS_EVENTS);
+    std::string what = std::string(name) + " ";
+    check(STRESS_EVENTS / seconds > STRESS_RATE * 0.9, (what + "pushed at the stress rate").c_str());
+    check(ordered && stressTorn == 0 && stressSent.size() == queue.get_sent(), (what + "sent in order and whole").c_str());
+    check(queue.get_sent() + queue.get_dropped() + queue.get_refused() == STRESS_EVENTS && queue.waiting() == 0 &&
+          queue.get_eventsSent() + queue.get_eventsDropped() == acceptedEvents,
+          (what + "every event sent, dropped or refused").c_str());
+    check(queue.get_dropped() + queue.get_refused() > 0 && queue.get_sent() > STRESS_EVENTS / 10,
+          (what + "slow publisher overrun").c_str());
+    if(policy == DROP_NEWEST) {
+        check(accepted == queue.get_enqueued() && accepted == queue.get_sent() && acceptedEvents == queue.get_eventsSent(),
+              (what + "refused events counted").c_str());
+    } else {
+        check(accepted == STRESS_EVENTS && queue.get_enqueued() == STRESS_EVENTS && stressSent.back() == STRESS_EVENTS - 1,
+              (what + "newest events kept").c_str());
+    }
+}
+
+int main() {
+    testOrderAndPolicies();
+    testBackoff();
+    testJournalAccounting();
+    testJournalFullQueue();
+    testStress(DROP_NEWEST, "DROP_NEWEST");
+    testStress(DROP_OLDEST, "DROP_OLDEST");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
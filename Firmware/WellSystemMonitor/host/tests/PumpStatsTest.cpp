@@ -0,0 +1,190 @@
+/***************************************************************************************************/
+// PumpStatsTest.cpp
+//  Checks the streaming pump statistics (src/WSMPumpStats.h): Welford's mean and deviation against
+//  two passes over the values, the P² percentiles against the sorted values, the hour's cycles and
+//  duty cycle for runs that span hours and the millis() rollover, PP cycles per WP cycle and the
+//  summary; then two simulated weeks of the sketch, whose hourly wsmPumpStats summaries must agree
+//  with the pump events it published.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "FirmwareSimulator.h"
+#include "JSONWriter.h"
+#include "TestCheck.h"
+#include "WSMPumpStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// pull a numeric field out of a flat JSON payload
+static double jsonNumber(const std::string &json, const char *key) {
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = json.find(pattern);
+    if(pos == std::string::npos) {
+        return -1.0;
+    }
+    return atof(json.c_str() + pos + pattern.size());
+}
+
+// the exact percentile, by nearest rank
+static double exactPercentile(std::vector<double> values, double p) {
+    std::sort(values.begin(), values.end());
+    size_t rank = (size_t)std::ceil(p * values.size());
+    return values[rank == 0 ? 0 : rank - 1];
+}
+
+static void checkPercentiles(const char *what, std::vector<double> values, double tolerance) {
+    WSMP2Quantile p50(0.50f), p95(0.95f), p99(0.99f);
+    for(double value : values) {
+        p50.add((float)value);
+        p95.add((float)value);
+        p99.add((float)value);
+    }
+    double e50 = exactPercentile(values, 0.50), e95 = exactPercentile(values, 0.95), e99 = exactPercentile(values, 0.99);
+    double worst = std::max(std::fabs(p50.value() - e50) / e50,
+                            std::max(std::fabs(p95.value() - e95) / e95, std::fabs(p99.value() - e99) / e99));
+    printf("%-10s p50 %.4f (%.4f)  p95 %.4f (%.4f)  p99 %.4f (%.4f)\n", what, p50.value(), e50, p95.value(), e95,
+           p99.value(), e99);
+    check(worst < tolerance, what);
+}
+
+int main() {
+    std::mt19937 random(13);
+
+    // Welford against two passes
+    std::lognormal_distribution<double> runTimes(-0.9, 0.35);
+    std::vector<double> values;
+    WSMRunningStats stats;
+    for(int i = 0; i < 100000; i++) {
+        values.push_back(runTimes(random) + 1000.0);  // a large offset, which loses a naive sum of squares
+        stats.add(values.back());
+    }
+    double mean = 0.0, squares = 0.0;
+    for(double value : values) {
+        mean += value;
+    }
+    mean /= values.size();
+    for(double value : values) {
+        squares += (value - mean) * (value - mean);
+    }
+    double variance = squares / (values.size() - 1);
+    check(stats.count() == 100000 && std::fabs(stats.mean() - mean) < 1e-9 &&
+          std::fabs(stats.variance() - variance) / variance < 1e-6, "Welford mean and variance");
+
+    // P² against the sorted values
+    values.clear();
+    for(int i = 0; i < 20000; i++) {
+        values.push_back(runTimes(random));
+    }
+    checkPercentiles("lognormal", values, 0.01);
+    std::uniform_real_distribution<double> uniform(20.0, 40.0);
+    values.clear();
+    for(int i = 0; i < 5000; i++) {
+        values.push_back(uniform(random));
+    }
+    checkPercentiles("uniform", values, 0.01);
+    values.clear();
+    for(int i = 0; i < 200; i++) {
+        values.push_back(runTimes(random));
+    }
+    checkPercentiles("200 runs", values, 0.10);    // a few samples above the 99th
+    WSMP2Quantile few(0.5f);
+    few.add(3.0f);
+    few.add(1.0f);
+    few.add(2.0f);
+    check(few.value() == 2.0f && WSMP2Quantile(0.95f).value() == 0.0f, "exact for five values or fewer");
+
+    // the hour's cycles and duty cycle, across the millis() rollover
+    WSMPumpStats pumps;
+    const system_tick_t HOUR = 3600000;
+    system_tick_t start = 0xFFFFFFFFu - HOUR / 2;
+    pumps.begin(start);
+    pumps.pumpOff(PUMP_PP, start + 1000);                   // no on: ignored
+    pumps.pumpOn(PUMP_PP, start + 60000);
+    pumps.pumpOff(PUMP_PP, start + 90000);                  // 30 s
+    pumps.pumpOn(PUMP_WP, start + HOUR / 2);                // 40 minutes, 30 of them in this hour
+    pumps.pumpOn(PUMP_PP, start + HOUR - 20000);            // 60 s, 20 of them in this hour
+    pumps.closeHour(start + HOUR);
+    check(pumps.cyclesLastHour(PUMP_PP) == 2 && std::fabs(pumps.dutyLastHour(PUMP_PP) - 50.0f / 3600.0f) < 1e-6f &&
+          pumps.cyclesLastHour(PUMP_WP) == 1 && std::fabs(pumps.dutyLastHour(PUMP_WP) - 0.5f) < 1e-6f,
+          "cycles and duty cycle of the first hour");
+    pumps.pumpOff(PUMP_PP, start + HOUR + 40000);
+    pumps.pumpOff(PUMP_WP, start + HOUR + 600000);
+    pumps.closeHour(start + 2 * HOUR);
+    check(pumps.cyclesLastHour(PUMP_PP) == 0 && std::fabs(pumps.dutyLastHour(PUMP_PP) - 40.0f / 3600.0f) < 1e-6f &&
+          std::fabs(pumps.dutyLastHour(PUMP_WP) - 600.0f / 3600.0f) < 1e-6f, "runs carried into the next hour");
+    check(pumps.runStats(PUMP_PP).count() == 2 && std::fabs(pumps.runStats(PUMP_PP).mean() - 0.75) < 1e-6 &&
+          std::fabs(pumps.runStats(PUMP_WP).mean() - 40.0) < 1e-4, "run times across the rollover");
+
+    // PP cycles per WP cycle; the count before the first WP cycle is not one
+    const unsigned int PP_CYCLES[] = {4, 7, 9, 5};
+    system_tick_t t = start + 3 * HOUR;
+    for(unsigned int count : PP_CYCLES) {
+        for(unsigned int i = 0; i < count; i++) {
+            pumps.pumpOn(PUMP_PP, t += 1000);
+            pumps.pumpOff(PUMP_PP, t += 20000);
+        }
+        pumps.pumpOn(PUMP_WP, t += 1000);
+        pumps.pumpOff(PUMP_WP, t += 60000);
+    }
+    check(pumps.ppPerWp().count() == 4 && std::fabs(pumps.ppPerWp().mean() - 6.5) < 1e-9 && pumps.ppPerLastWp() == 5,
+          "PP cycles per WP cycle");     // 1 + 4, 7, 9, 5
+
+    char summary[JSON_EVENT_SIZE * 3];
+    pumps.closeHour(t);
+    pumps.writeSummary(summary, sizeof(summary), 1767225600);
+    printf("%s (%zu bytes)\n", summary, strlen(summary));
+    check(summary[strlen(summary) - 1] == '}' && jsonNumber(summary, "etime") == 1767225600 &&
+          jsonNumber(summary, "pph") == 25 && jsonNumber(summary, "ppn") == 27 && jsonNumber(summary, "wpn") == 5 &&
+          jsonNumber(summary, "ppwp") == 6.5 && jsonNumber(summary, "ppwpl") == 5, "summary");
+
+    // the sketch, for two weeks: an hourly summary that agrees with the pump events
+    SimulatorConfig config;
+    config.durationMs = 14ULL * 86400000ULL;
+    config.millisOffset = 0xFF000000u;      // a rollover after about 4.6 hours
+    config.pumps.seed = 13;
+    std::vector<double> ppRuns;
+    uint64_t summaries = 0, hourCycles = 0, ppOnEvents = 0, badIntervals = 0;
+    time_t lastSummary = 0;
+    std::string last;
+    FirmwareSimulator simulator(config);
+    simulator.run([&](const ParticleHost::PublishRecord &record) {
+        if(record.name == "wsmPumpStats") {
+            if(lastSummary != 0 && record.unixTime - lastSummary != 3600) {
+                badIntervals++;
+            }
+            lastSummary = record.unixTime;
+            summaries++;
+            hourCycles += (uint64_t)jsonNumber(record.data, "pph");
+            last = record.data;
+        } else if(record.name == "wsmEventPPstatus") {
+            if(jsonNumber(record.data, "pp") == 1.0) {
+                ppOnEvents++;
+            } else {
+                ppRuns.push_back(jsonNumber(record.data, "ppon"));
+            }
+        }
+    });
+    double eventMean = 0.0;
+    for(double run : ppRuns) {
+        eventMean += run;
+    }
+    eventMean /= ppRuns.size();
+    printf("%llu summaries, %llu PP cycles in them, %llu PP on events; last %s\n", (unsigned long long)summaries,
+           (unsigned long long)hourCycles, (unsigned long long)ppOnEvents, last.c_str());
+    check(summaries == 14 * 24 - 1 && badIntervals == 0, "a summary every hour");
+    check(hourCycles <= ppOnEvents && hourCycles + 30 > ppOnEvents, "the hours' cycles are the PP events");
+    check(jsonNumber(last, "ppn") >= ppRuns.size() - 30 && std::fabs(jsonNumber(last, "ppm") - eventMean) < 0.02 &&
+          std::fabs(jsonNumber(last, "pp50") - exactPercentile(ppRuns, 0.5)) < 0.05, "the run time statistics are the PP events'");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
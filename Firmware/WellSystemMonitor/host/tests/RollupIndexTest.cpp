@@ -0,0 +1,334 @@
+/***************************************************************************************************/
+// RollupIndexTest.cpp
+//  Checks the rollup index (series/WSMRollupIndex.h) against the events themselves: ranges of the
+//  recorded history and of a year of simulated events, with their alerts, summed up from the rows
+//  one by one; hourly and daily series; the PP run time between WP runs of a scripted day; rows
+//  that arrive before a site's first half hour or long after its last; and the index saved, loaded
+//  and refused when damaged.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "HistoryReplay.h"
+#include "TestCheck.h"
+#include "WSMRollup.h"
+#include "WSMRollupIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+
+const char INDEX_PATH[] = "rollup_index_test.index";
+const char SITE[] = "e00fce68a1b2c3d4e5f60718";
+const int64_t START = 1700000000;
+const unsigned int YEAR_ROWS = 70000;
+const unsigned int RANGES = 400;
+
+static uint32_t nextRandom(uint32_t &state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static uint64_t wideRandom(uint32_t &state) {
+    return (uint64_t)nextRandom(state) << 24 | nextRandom(state);
+}
+
+static WSMDataRow emptyRow(int64_t etime, WSMEventType event) {
+    WSMDataRow row;
+    row.etime = etime;
+    row.temp = row.rh = row.ppon = row.wpon = NAN;
+    row.pp = row.wp = -1;
+    row.event = event;
+    return row;
+}
+
+// a year of a site: a TRH report each half hour, the pressure pump cycling and the well pump
+//  filling the tank now and then
+static std::vector<WSMDataRow> year() {
+    std::vector<WSMDataRow> rows;
+    uint32_t state = 11;
+    int64_t etime = START;
+    int64_t nextTRH = START;
+    float temp = 55.0f;
+    float rh = 60.0f;
+    while(rows.size() < YEAR_ROWS) {
+        etime += 60 + nextRandom(state) % 1800;
+        while(nextTRH <= etime) {
+            temp += (int)(nextRandom(state) % 21 - 10) / 10.0f;
+            rh = std::min(100.0f, std::max(0.0f, rh + (int)(nextRandom(state) % 11 - 5) / 10.0f));
+            WSMDataRow row = emptyRow(nextTRH, WSM_EVENT_TRH);
+            row.temp = temp;
+            row.rh = rh;
+            rows.push_back(row);
+            nextTRH += 1800;
+        }
+        bool well = nextRandom(state) % 10 == 0;
+        WSMDataRow on = emptyRow(etime, well ? WSM_EVENT_WP_STATUS : WSM_EVENT_PP_STATUS);
+        (well ? on.wp : on.pp) = 1;
+        rows.push_back(on);
+        etime += 20 + nextRandom(state) % (well ? 1800 : 120);
+        WSMDataRow off = emptyRow(etime, on.event);
+        (well ? off.wp : off.pp) = 0;
+        (well ? off.wpon : off.ppon) = (etime - on.etime) / 60.0f;
+        rows.push_back(off);
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const WSMDataRow &a, const WSMDataRow &b) {
+        return a.etime < b.etime;
+    });
+    return rows;
+}
+
+static std::vector<WSMDataRow> recorded(const char *path) {
+    std::vector<WSMDataRow> rows;
+    WSMDataReader reader;
+    WSMDataRow row;
+    if(reader.open(path)) {
+        while(reader.next(row)) {
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+static int64_t slotStart(int64_t etime) {
+    return etime - ((etime % ROLLUP_SLOT_SECONDS) + ROLLUP_SLOT_SECONDS) % ROLLUP_SLOT_SECONDS;
+}
+
+// the aggregates of the rows whose half hour starts in [from, to), summed up one by one
+static WSMRangeStats expected(const std::vector<WSMDataRow> &rows, const std::vector<int64_t> &alerts,
+                              int64_t from, int64_t to) {
+    WSMRangeStats stats;
+    stats.clear();
+    uint64_t ppSinceWP = 0;
+    bool wpSeen = false;
+    for(const WSMDataRow &row : rows) {
+        int64_t start = slotStart(row.etime);
+        bool in = start >= from && start < to;
+        if(row.event == WSM_EVENT_PP_STATUS && row.pp == 0 && !std::isnan(row.ppon)) {
+            uint32_t ms = (uint32_t)runMillis(row.ppon);
+            ppSinceWP += ms;
+            if(in) {
+                stats.ppCycles++;
+                stats.ppMs += ms;
+                stats.ppMaxMs = std::max(stats.ppMaxMs, ms);
+            }
+        } else if(row.event == WSM_EVENT_WP_STATUS && row.wp == 1) {
+            if(in && wpSeen) {
+                stats.wpGaps++;
+                stats.gapMs += ppSinceWP;
+                stats.gapMaxMs = std::max(stats.gapMaxMs, (uint32_t)ppSinceWP);
+            }
+            ppSinceWP = 0;
+            wpSeen = true;
+        } else if(row.event == WSM_EVENT_WP_STATUS && row.wp == 0 && !std::isnan(row.wpon) && in) {
+            uint32_t ms = (uint32_t)runMillis(row.wpon);
+            stats.wpCycles++;
+            stats.wpMs += ms;
+            stats.wpMaxMs = std::max(stats.wpMaxMs, ms);
+        } else if(row.event == WSM_EVENT_TRH && !std::isnan(row.temp) && !std::isnan(row.rh) && in) {
+            int32_t temp = hundredths(row.temp);
+            int32_t rh = hundredths(row.rh);
+            stats.tempMin = stats.trhCount == 0 ? temp : std::min(stats.tempMin, temp);
+            stats.tempMax = stats.trhCount == 0 ? temp : std::max(stats.tempMax, temp);
+            stats.rhMin = stats.trhCount == 0 ? rh : std::min(stats.rhMin, rh);
+            stats.rhMax = stats.trhCount == 0 ? rh : std::max(stats.rhMax, rh);
+            stats.tempSum += temp;
+            stats.rhSum += rh;
+            stats.trhCount++;
+        }
+    }
+    for(int64_t alert : alerts) {
+        int64_t start = slotStart(alert);
+        stats.alerts += start >= from && start < to;
+    }
+    return stats;
+}   // end of expected()
+
+// the half hours of the index in [from, to)
+static uint64_t slotsIn(const WSMRollupIndex &index, int64_t from, int64_t to) {
+    int64_t first, end;
+    if(!index.span(SITE, first, end)) {
+        return 0;
+    }
+    int64_t lo = std::max(slotStart(from - 1) + ROLLUP_SLOT_SECONDS, first);    // the first half hour from from
+    int64_t hi = std::min(slotStart(to - 1) + ROLLUP_SLOT_SECONDS, end);
+    return hi <= lo ? 0 : (uint64_t)((hi - lo) / ROLLUP_SLOT_SECONDS);
+}
+
+static bool randomRanges(const WSMRollupIndex &index, const std::vector<WSMDataRow> &rows,
+                         const std::vector<int64_t> &alerts, uint32_t seed) {
+    int64_t first = rows.front().etime - 7200;
+    int64_t span = rows.back().etime + 7200 - first;
+    bool same = true;
+    for(unsigned int i = 0; same && i < RANGES; i++) {
+        int64_t from = first + (int64_t)(wideRandom(seed) % span);
+        int64_t to = from + (int64_t)(wideRandom(seed) % (i % 4 == 0 ? span : 3 * 86400));
+        if(i % 3 == 0) {
+            from = slotStart(from);     // on half hours, as the dashboard asks
+            to = slotStart(to);
+        }
+        WSMRangeStats want = expected(rows, alerts, from, to);
+        want.slots = slotsIn(index, from, to);
+        same = index.range(SITE, from, to) == want;
+    }
+    return same;
+}
+
+static void recordedHistory(const char *path) {
+    std::vector<WSMDataRow> rows = recorded(path);
+    std::vector<int64_t> alerts;
+    WSMDataReader reader;
+    HistoryReplay replay;
+    if(reader.open(path)) {
+        replay.run(reader, [&](const ReplayAlert &alert) { alerts.push_back(alert.etime); });
+    }
+    WSMRollupIndex index;
+    for(const WSMDataRow &row : rows) {
+        index.add(SITE, row);
+    }
+    for(int64_t alert : alerts) {
+        index.addAlert(SITE, alert);
+    }
+    WSMRangeStats all = index.range(SITE, INT64_MIN, INT64_MAX);
+    check(!rows.empty() && !alerts.empty() && all.alerts == alerts.size(), "recorded history and its alerts indexed");
+    check(randomRanges(index, rows, alerts, 5), "ranges of the recorded history are its rows'");
+}
+
+static void simulatedYear(const std::vector<WSMDataRow> &rows) {
+    std::vector<int64_t> alerts;
+    uint32_t state = 3;
+    for(int i = 0; i < 500; i++) {
+        alerts.push_back(rows[nextRandom(state) % rows.size()].etime);
+    }
+    WSMRollupIndex index;
+    bool added = true;
+    for(const WSMDataRow &row : rows) {
+        index.add(SITE, row);
+    }
+    for(int64_t alert : alerts) {
+        added = index.addAlert(SITE, alert) && added;
+    }
+    check(added, "year indexed");
+    check(randomRanges(index, rows, alerts, 9), "ranges of the year are its rows'");
+
+    // hours and days add up to the whole
+    int64_t from = slotStart(rows.front().etime) - 86400;
+    int64_t to = rows.back().etime + 86400;
+    WSMRangeStats all = index.range(SITE, from, to);
+    std::vector<WSMRangeStats> hours, days;
+    index.series(SITE, from, to, 3600, hours);
+    index.series(SITE, from, to, 86400, days);
+    WSMRangeStats hourSum, daySum;
+    hourSum.clear();
+    daySum.clear();
+    for(const WSMRangeStats &hour : hours) {
+        hourSum.merge(hour);
+    }
+    for(const WSMRangeStats &day : days) {
+        daySum.merge(day);
+    }
+    check(hourSum == all && daySum == all && days.size() == (size_t)((to - from + 86399) / 86400),
+          "hourly and daily series add up to the range");
+    bool daysRight = true;
+    for(size_t d = 0; d < days.size(); d += 37) {
+        WSMRangeStats want = expected(rows, alerts, from + (int64_t)d * 86400, from + (int64_t)(d + 1) * 86400);
+        want.slots = days[d].slots;
+        daysRight = daysRight && days[d] == want;
+    }
+    check(daysRight, "days are their rows'");
+
+    printf("a year: %llu half hours, %llu bytes in memory\n", (unsigned long long)all.slots,
+           (unsigned long long)index.bytes());
+
+    // saved and loaded
+    unlink(INDEX_PATH);
+    WSMRollupIndex loaded;
+    check(index.save(INDEX_PATH) && loaded.load(INDEX_PATH), "index saved and loaded");
+    FILE *file = fopen(INDEX_PATH, "rb");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    printf("a year saved: %ld bytes, %.2f bytes a half hour\n", size, (double)size / all.slots);
+    check(size < (long)all.slots * 12, "saved in under 12 bytes a half hour");
+    check(randomRanges(loaded, rows, alerts, 9) && loaded.range(SITE, from, to) == all, "loaded ranges the same");
+
+    // the PP run time since the WP came on carries over a save
+    WSMDataRow wpOn = emptyRow(rows.back().etime + 60, WSM_EVENT_WP_STATUS);
+    wpOn.wp = 1;
+    index.add(SITE, wpOn);
+    loaded.add(SITE, wpOn);
+    check(index.range(SITE, from, INT64_MAX) == loaded.range(SITE, from, INT64_MAX), "loaded index carries on");
+
+    file = fopen(INDEX_PATH, "r+b");
+    fseek(file, size / 2, SEEK_SET);
+    int byte = fgetc(file);
+    fseek(file, size / 2, SEEK_SET);
+    fputc(byte ^ 0x01, file);
+    fclose(file);
+    check(!loaded.load(INDEX_PATH) && loaded.sites().empty(), "damaged index refused");
+    unlink(INDEX_PATH);
+}   // end of simulatedYear()
+
+static void scripted() {
+    WSMRollupIndex index;
+    int64_t t = 1700006400;     // on the hour
+    auto pump = [&](WSMEventType event, int64_t at, float minutes) {
+        WSMDataRow on = emptyRow(at, event);
+        (event == WSM_EVENT_PP_STATUS ? on.pp : on.wp) = 1;
+        WSMDataRow off = emptyRow(at + (int64_t)(minutes * 60), event);
+        (event == WSM_EVENT_PP_STATUS ? off.pp : off.wp) = 0;
+        (event == WSM_EVENT_PP_STATUS ? off.ppon : off.wpon) = minutes;
+        index.add(SITE, on);
+        index.add(SITE, off);
+    };
+    pump(WSM_EVENT_WP_STATUS, t, 25.0f);
+    pump(WSM_EVENT_PP_STATUS, t + 3600, 1.5f);
+    pump(WSM_EVENT_PP_STATUS, t + 7200, 2.0f);
+    pump(WSM_EVENT_WP_STATUS, t + 9000, 30.0f);
+    pump(WSM_EVENT_PP_STATUS, t + 12600, 4.0f);
+    pump(WSM_EVENT_WP_STATUS, t + 14400, 20.0f);
+
+    WSMRangeStats all = index.range(SITE, t, t + 86400);
+    check(all.wpCycles == 3 && all.wpGaps == 2 && all.gapMs == 450000 && all.gapMaxMs == 240000 &&
+          std::fabs(all.gapAverageMinutes() - 3.75f) < 1e-6f,
+          "PP run time between WP runs");
+    check(all.ppCycles == 3 && all.ppMaxMs == 240000 && std::fabs(all.ppAverageMinutes() - 2.5f) < 1e-6f &&
+          std::isnan(all.tempAverage()) && all.slots == 9,
+          "cycles and run times of a scripted day");
+    WSMRangeStats half = index.range(SITE, t + 9000, t + 10800);
+    check(half.slots == 1 && half.wpGaps == 1 && half.gapMs == 210000 && half.wpCycles == 0,
+          "WP gap in the half hour the WP came on");
+
+    // earlier than the first half hour, and months after the last
+    WSMDataRow trh = emptyRow(t - 40 * 86400 + 10, WSM_EVENT_TRH);
+    trh.temp = 40.25f;
+    trh.rh = 70.5f;
+    check(index.add(SITE, trh), "row before the first half hour");
+    trh.etime = t + 200 * 86400 + 10;
+    trh.temp = 80.75f;
+    check(index.add(SITE, trh), "row months after the last");
+    WSMRangeStats everything = index.range(SITE, INT64_MIN, INT64_MAX);
+    check(everything.trhCount == 2 && everything.tempMin == 4025 && everything.tempMax == 8075 &&
+          everything.ppCycles == 3 && everything.slots == (uint64_t)(240 * 48 + 1) &&
+          index.range(SITE, t, t + 14400).ppCycles == all.ppCycles,
+          "index grown both ways");
+    trh.etime = t + 30 * 366 * 86400;
+    check(!index.add(SITE, trh) && index.range(SITE, INT64_MIN, INT64_MAX) == everything,
+          "row past twenty years refused");
+    check(index.range("no such site", INT64_MIN, INT64_MAX).slots == 0, "unknown site is empty");
+}   // end of scripted()
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "data/WSMDataHistory.csv";
+    recordedHistory(path);
+    simulatedYear(year());
+    scripted();
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+/***************************************************************************************************/
+// SchedulerTest.cpp
+//  Checks the cooperative scheduler (src/WSMScheduler.h) on a virtual clock: tasks run in the order
+//  they are due, periodic tasks keep their cadence on late passes and skip whole missed periods,
+//  tasks due days ahead run on time, stop() and start() work from inside a task, run() does
+//  nothing before nextDue(), and random tasks and clock steps, up to a year at a time, run the same
+//  tasks on the same passes as a list of due times does.  Then millis() across its rollover.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "WSMScheduler.h"
+#include "application.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// the virtual clock
+static uint64_t clockMs = 0;
+static uint64_t virtualClock() { return clockMs; }
+
+// the tasks record which of them ran, and when
+static std::vector<int> calls;
+static std::vector<uint64_t> callTimes;
+static WSMScheduler *current = nullptr;
+
+template<int N> void task() {
+    calls.push_back(N);
+    callTimes.push_back(clockMs);
+}
+
+static void clearCalls() {
+    calls.clear();
+    callTimes.clear();
+}
+
+// a task that stops itself on its third run
+static int selfStopId = -1;
+static int selfStopRuns = 0;
+static void selfStop() {
+    if(++selfStopRuns == 3) {
+        current->stop(selfStopId);
+    }
+}
+
+// a task that runs again 5 ms later, then every 100 ms
+static int restartId = -1;
+static int restartRuns = 0;
+static void restart() {
+    if(++restartRuns == 1) {
+        current->start(restartId, 5);
+    }
+}
+
+typedef void (*TaskList)();
+static const TaskList TASKS[SCHEDULER_MAX_TASKS] = {
+    task<0>, task<1>, task<2>, task<3>, task<4>, task<5>, task<6>, task<7>,
+    task<8>, task<9>, task<10>, task<11>, task<12>, task<13>, task<14>, task<15>
+};
+
+int main() {
+    WSMScheduler scheduler(virtualClock);
+    current = &scheduler;
+
+    // in due order; the same due time in the order scheduled
+    clockMs = 1000;
+    scheduler.begin();
+    scheduler.after(300, task<0>);
+    scheduler.after(20, task<1>);
+    scheduler.after(300, task<2>);
+    scheduler.after(5000, task<3>);
+    scheduler.after(0, task<4>);
+    clockMs += 10000;
+    check(scheduler.run() && calls == std::vector<int>({4, 1, 0, 2, 3}), "in due order, ties in the order scheduled");
+    clearCalls();
+    check(!scheduler.run() && scheduler.nextDue() == ~(uint64_t)0, "one time tasks run once");
+
+    // the fast path and the time to the next task
+    clockMs = 0;
+    scheduler.begin();
+    scheduler.every(250, task<0>, 100);
+    clockMs = 99;
+    check(!scheduler.run() && scheduler.nextDue() == 100 && scheduler.msUntilNext() == 1, "nothing before nextDue()");
+    clockMs = 100;
+    check(scheduler.run() && calls.size() == 1, "due on time");
+    uint64_t wakes = 0;
+    for(clockMs = 101; clockMs < 350; clockMs++) {
+        wakes += scheduler.msUntilNext() == 0 ? 1 : 0;
+        scheduler.run();
+    }
+    check(calls.size() == 1 && wakes <= SCHEDULER_LEVELS && scheduler.msUntilNext() == 0 && scheduler.run() &&
+          calls.size() == 2, "on time again a period later, with few wakes on the way");
+    clearCalls();
+
+    // a periodic task keeps its cadence on late passes and skips the periods it missed
+    clockMs = 0;
+    scheduler.begin();
+    scheduler.every(100, task<0>);
+    std::mt19937 random(12);
+    std::uniform_int_distribution<uint32_t> step(1, 60);
+    bool cadence = true;
+    while(clockMs < 100000) {
+        uint64_t before = calls.size();
+        scheduler.run();
+        if(calls.size() != before) {
+            // once per period, on the first pass at or after it
+            cadence = cadence && calls.size() == before + 1 && callTimes.back() / 100 == (callTimes.size() - 1) &&
+                      callTimes.back() % 100 < 60;
+        }
+        clockMs += step(random);
+    }
+    check(cadence && calls.size() == 1000, "periodic cadence on late passes");
+    clearCalls();
+    clockMs += 3750;
+    scheduler.run();
+    clockMs = clockMs / 100 * 100 + 100;
+    scheduler.run();
+    check(calls.size() == 2 && callTimes[1] % 100 == 0, "missed periods are skipped");
+    clearCalls();
+
+    // far beyond the 4.66 hours of the wheel, exactly on time
+    clockMs = 123456789;
+    scheduler.begin();
+    const uint64_t TEN_DAYS = 10ull * 24 * 3600 * 1000;
+    scheduler.after((system_tick_t)TEN_DAYS, task<0>);
+    scheduler.every(3600000 * 7, task<1>, 3600000 * 5);
+    clockMs += TEN_DAYS - 1;
+    scheduler.run();
+    std::vector<int> before = calls;
+    clockMs += 1;
+    scheduler.run();
+    check(std::count(before.begin(), before.end(), 0) == 0 && calls.back() == 0 && callTimes.back() == 123456789 + TEN_DAYS,
+          "ten days ahead, on the millisecond");
+    clearCalls();
+    clockMs = 0;
+    scheduler.begin();
+    scheduler.every(3600000 * 7, task<1>, 3600000 * 5);
+    bool onTime = true;
+    for(int i = 0; i < 200; i++) {
+        uint64_t due = 3600000ull * 5 + (uint64_t)i * 3600000 * 7;
+        clockMs = due - 1;
+        scheduler.run();
+        onTime = onTime && calls.size() == (size_t)i && scheduler.nextDue() == due;
+        clockMs = due;
+        scheduler.run();
+        onTime = onTime && calls.size() == (size_t)i + 1;
+    }
+    check(onTime, "a 7 hour period, 200 times");
+    clearCalls();
+
+    // stop() and start(), from outside and from inside a task; -1 when full
+    clockMs = 0;
+    scheduler.begin();
+    int stopped = scheduler.every(10, task<0>);
+    selfStopId = scheduler.every(10, selfStop);
+    restartId = scheduler.every(100, restart);
+    scheduler.stop(stopped);
+    for(clockMs = 0; clockMs <= 400; clockMs++) {
+        scheduler.run();
+    }
+    check(calls.empty() && !scheduler.active(stopped), "stopped");
+    check(selfStopRuns == 3 && !scheduler.active(selfStopId), "stopped from inside the task");
+    check(restartRuns == 5, "started again from inside the task");     // at 0, 5, 105, 205, 305
+    scheduler.start(stopped, 1);
+    clockMs++;
+    check(scheduler.run() && calls.size() == 1 && scheduler.active(stopped), "started again");
+    clearCalls();
+    int added = 0;
+    while(scheduler.every(1000, task<0>) >= 0) {
+        added++;
+    }
+    check(added == SCHEDULER_MAX_TASKS - 3, "no more than SCHEDULER_MAX_TASKS");
+
+    // random tasks and clock steps against a list of due times
+    clockMs = 5;
+    scheduler.begin();
+    std::vector<uint64_t> due(SCHEDULER_MAX_TASKS);
+    std::vector<uint64_t> period(SCHEDULER_MAX_TASKS);
+    std::uniform_int_distribution<uint32_t> percent(0, 99);
+    for(int i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+        const uint64_t PERIODS[] = {1, 7, 64, 150, 4096, 4000, 1800000, 262144, 16777216, 86400000};
+        period[i] = PERIODS[i % 10] + (i >= 10 ? random() % 1000 : 0);
+        uint64_t first = random() % (period[i] * 2);
+        due[i] = clockMs + first;
+        scheduler.every((system_tick_t)period[i], TASKS[i], (system_tick_t)first);
+    }
+    bool same = true;
+    uint64_t passes = 0, runs = 0;
+    for(; passes < 300000 && same; passes++) {
+        uint32_t roll = percent(random);
+        clockMs += roll < 60 ? 1 + random() % 5 : roll < 95 ? random() % 5000 : roll < 99 ? random() % 100000000 : 365ull * 86400000;
+        clearCalls();
+        scheduler.run();
+        std::vector<int> expected;
+        for(int i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+            if(due[i] <= clockMs) {
+                expected.push_back(i);
+                due[i] += ((clockMs - due[i]) / period[i] + 1) * period[i];
+            }
+        }
+        std::vector<int> ran = calls;
+        std::sort(ran.begin(), ran.end());
+        same = ran == expected;
+        runs += calls.size();
+        uint64_t next = *std::min_element(due.begin(), due.end());
+        same = same && scheduler.nextDue() <= next;
+    }
+    printf("%llu passes, %llu runs, the clock at %.1f years\n", (unsigned long long)passes, (unsigned long long)runs,
+           clockMs / (365.0 * 86400000));
+    check(same && runs > 300000, "random tasks and steps run as their due times say");
+
+    // millis(), across its rollover
+    ParticleHost::reset();
+    ParticleHost::setMillisOffset(0xFFFFFFFFu - 10000u);
+    WSMScheduler byMillis;
+    clearCalls();
+    byMillis.every(1000, task<0>, 1000);
+    bool everySecond = true;
+    for(int ms = 0; ms < 30000; ms++) {
+        clockMs = (uint64_t)ms;
+        byMillis.run();
+        everySecond = everySecond && calls.size() == (size_t)(ms / 1000);
+        ParticleHost::advanceMillis(1);
+    }
+    check(everySecond && byMillis.now() > 0xFFFFFFFFull, "millis() across the rollover");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,380 @@
+/***************************************************************************************************/
+// SeriesStoreTest.cpp
+//  Checks the series store (series/): bit packing, the recorded history through a segment and back
+//  (to 0.01 and the millisecond, missing values kept), range scans of a store of many segments
+//  against a plain filter and the blocks they decode, the rows not yet written, a late row, reopening
+//  and the cut off of a segment left unfinished; then retention, whose rollups must be those of the
+//  rows themselves, before and after a reopen.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "TestCheck.h"
+#include "WSMBitPacking.h"
+#include "WSMSeriesStore.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+const char STORE_DIRECTORY[] = "series_store_test.store";
+const char SITE[] = "e00fce68a1b2c3d4e5f60718";
+const int64_t START = 1700000000;
+const unsigned int SYNTHETIC_ROWS = 20000;
+
+static uint32_t nextRandom(uint32_t &state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+// the same value, as it is kept
+static bool sameValue(float stored, float original, bool millis) {
+    if(std::isnan(original) || std::isnan(stored)) {
+        return std::isnan(original) && std::isnan(stored);
+    }
+    return millis ? runMillis(stored) == runMillis(original) : hundredths(stored) == hundredths(original);
+}
+
+static bool sameRow(const WSMDataRow &stored, const WSMDataRow &original) {
+    return stored.etime == original.etime && stored.event == original.event && stored.pp == original.pp &&
+           stored.wp == original.wp && sameValue(stored.temp, original.temp, false) &&
+           sameValue(stored.rh, original.rh, false) && sameValue(stored.ppon, original.ppon, true) &&
+           sameValue(stored.wpon, original.wpon, true);
+}
+
+static WSMDataRow emptyRow(int64_t etime, WSMEventType event) {
+    WSMDataRow row;
+    row.etime = etime;
+    row.temp = row.rh = row.ppon = row.wpon = NAN;
+    row.pp = row.wp = -1;
+    row.event = event;
+    return row;
+}
+
+// some months of a site: a TRH report each half hour, the pressure pump cycling and the well pump
+//  filling the tank now and then
+static std::vector<WSMDataRow> synthetic() {
+    std::vector<WSMDataRow> rows;
+    uint32_t state = 7;
+    int64_t etime = START;
+    int64_t nextTRH = START;
+    float temp = 55.0f;
+    float rh = 60.0f;
+    while(rows.size() < SYNTHETIC_ROWS) {
+        etime += 60 + nextRandom(state) % 900;
+        while(nextTRH <= etime) {
+            temp += (int)(nextRandom(state) % 21 - 10) / 10.0f;
+            rh += (int)(nextRandom(state) % 11 - 5) / 10.0f;
+            WSMDataRow row = emptyRow(nextTRH, WSM_EVENT_TRH);
+            row.temp = temp;
+            row.rh = rh;
+            rows.push_back(row);
+            nextTRH += 1800;
+        }
+        bool well = nextRandom(state) % 8 == 0;
+        WSMDataRow on = emptyRow(etime, well ? WSM_EVENT_WP_STATUS : WSM_EVENT_PP_STATUS);
+        (well ? on.wp : on.pp) = 1;
+        rows.push_back(on);
+        etime += 20 + nextRandom(state) % (well ? 600 : 90);
+        WSMDataRow off = emptyRow(etime, on.event);
+        (well ? off.wp : off.pp) = 0;
+        (well ? off.wpon : off.ppon) = (etime - on.etime) / 60.0f;
+        rows.push_back(off);
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const WSMDataRow &a, const WSMDataRow &b) {
+        return a.etime < b.etime;
+    });
+    return rows;
+}
+
+static std::vector<WSMDataRow> recorded(const char *path) {
+    std::vector<WSMDataRow> rows;
+    WSMDataReader reader;
+    WSMDataRow row;
+    if(reader.open(path)) {
+        while(reader.next(row)) {
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+static void removeStore() {
+    if(DIR *dir = opendir(STORE_DIRECTORY)) {
+        while(dirent *entry = readdir(dir)) {
+            if(entry->d_name[0] != '.') {
+                unlink((std::string(STORE_DIRECTORY) + "/" + entry->d_name).c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(STORE_DIRECTORY);
+}
+
+static std::string sitePath() {
+    return std::string(STORE_DIRECTORY) + "/" + WSMSeriesStore::fileName(SITE) + ".wsms";
+}
+
+static std::vector<WSMDataRow> scanAll(const WSMSeriesStore &store, int64_t from, int64_t to) {
+    std::vector<WSMDataRow> rows;
+    store.scanRows(SITE, from, to, [&](const WSMDataRow &row) { rows.push_back(row); });
+    return rows;
+}
+
+static bool sameRows(const std::vector<WSMDataRow> &stored, const std::vector<WSMDataRow> &original) {
+    if(stored.size() != original.size()) {
+        return false;
+    }
+    for(size_t i = 0; i < stored.size(); i++) {
+        if(!sameRow(stored[i], original[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::map<int64_t, WSMRollup> rollupsOf(const std::vector<WSMDataRow> &rows) {
+    std::map<int64_t, WSMRollup> hours;
+    for(const WSMDataRow &row : rows) {
+        int64_t start = rollupStart(row.etime);
+        auto inserted = hours.emplace(start, WSMRollup());
+        if(inserted.second) {
+            inserted.first->second.clear(start);
+        }
+        inserted.first->second.add(row);
+    }
+    return hours;
+}
+
+static std::map<int64_t, WSMRollup> storedRollups(const WSMSeriesStore &store) {
+    std::map<int64_t, WSMRollup> hours;
+    store.scanRollups(SITE, INT64_MIN, INT64_MAX, [&](const WSMRollup &rollup) {
+        auto inserted = hours.emplace(rollup.start, rollup);
+        if(!inserted.second) {
+            inserted.first->second.merge(rollup);
+        }
+    });
+    return hours;
+}
+
+static void bitPacking() {
+    std::vector<uint8_t> bytes;
+    std::vector<std::pair<uint32_t, unsigned int>> written;
+    uint32_t state = 1;
+    WSMBitWriter writer(bytes);
+    for(int i = 0; i < 5000; i++) {
+        unsigned int width = nextRandom(state) % 33;
+        uint32_t value = width == 0 ? 0 : (uint32_t)(((uint64_t)nextRandom(state) << 16 ^ nextRandom(state)) &
+                                                     ((1ull << width) - 1));
+        writer.write(value, width);
+        written.push_back({value, width});
+    }
+    writer.flush();
+    bytes.resize(bytes.size() + 8, 0);
+    WSMBitReader reader(bytes.data());
+    bool same = true;
+    for(const auto &value : written) {
+        same = same && reader.read(value.second) == value.first;
+    }
+    check(same, "bit packed values read back");
+    check(bitWidth(0) == 0 && bitWidth(1) == 1 && bitWidth(255) == 8 && bitWidth(0xFFFFFFFFu) == 32,
+          "bit widths");
+    check(unzigzag(zigzag(-1)) == -1 && zigzag(-1) == 1 && zigzag(1) == 2 &&
+          unzigzag(zigzag(INT32_MIN)) == INT32_MIN && unzigzag(zigzag(INT32_MAX)) == INT32_MAX,
+          "zigzag");
+}
+
+static void segments(const std::vector<WSMDataRow> &history) {
+    std::vector<uint8_t> bytes;
+    encodeEvents(history.data(), std::min<size_t>(history.size(), SERIES_SEGMENT_ROWS), bytes);
+    WSMSegmentView view;
+    check(view.attach(bytes.data(), bytes.size()), "segment of the recorded history attaches");
+    check(bytes.size() % 8 == 0 && view.header().bytes == bytes.size(), "segment padded to 8 bytes");
+    std::vector<WSMDataRow> decoded;
+    WSMSeriesBlock block;
+    for(unsigned int b = 0; b < view.blocks(); b++) {
+        view.decode(b, block);
+        for(unsigned int r = 0; r < block.rows; r++) {
+            decoded.push_back(block.row(r));
+        }
+    }
+    std::vector<WSMDataRow> original(history.begin(), history.begin() + decoded.size());
+    check(!history.empty() && decoded.size() == std::min<size_t>(history.size(), SERIES_SEGMENT_ROWS) &&
+          sameRows(decoded, original),
+          "recorded history decodes to 0.01 and the millisecond");
+    printf("recorded history: %zu rows in %zu bytes, %.2f bytes per row\n", decoded.size(), bytes.size(),
+           (double)bytes.size() / decoded.size());
+
+    std::vector<uint8_t> damaged(bytes);
+    damaged[12] ^= 1;
+    check(!view.attach(damaged.data(), damaged.size()), "damaged header refused");
+    check(!view.attach(bytes.data(), bytes.size() - 8), "segment cut short refused");
+
+    std::vector<WSMRollup> rollups;
+    for(const auto &hour : rollupsOf(history)) {
+        rollups.push_back(hour.second);
+    }
+    bytes.clear();
+    encodeRollups(rollups.data(), std::min<size_t>(rollups.size(), SERIES_SEGMENT_ROWS), bytes);
+    bool same = view.attach(bytes.data(), bytes.size()) && view.kind() == SEGMENT_ROLLUPS;
+    size_t at = 0;
+    WSMRollup decodedRollups[SERIES_BLOCK_ROWS];
+    for(unsigned int b = 0; same && b < view.blocks(); b++) {
+        view.decode(b, decodedRollups);
+        for(unsigned int r = 0; r < view.block(b).rows; r++) {
+            same = same && decodedRollups[r] == rollups[at++];
+        }
+    }
+    check(same && at == std::min<size_t>(rollups.size(), SERIES_SEGMENT_ROWS), "rollups decode exactly");
+}   // end of segments()
+
+static void scans(const std::vector<WSMDataRow> &rows) {
+    removeStore();
+    WSMSeriesStore store;
+    check(store.open(STORE_DIRECTORY, false), "store opens");
+    bool appended = true;
+    for(const WSMDataRow &row : rows) {
+        appended = store.append(SITE, row) && appended;
+    }
+    check(appended, "rows appended");
+    WSMSeriesStats stats = store.stats();
+    check(stats.events == rows.size() && stats.eventSegments == rows.size() / SERIES_SEGMENT_ROWS,
+          "full segments written, the rest waiting");
+    check(sameRows(scanAll(store, INT64_MIN, INT64_MAX), rows), "whole history scanned, waiting rows and all");
+
+    store.flush();
+    stats = store.stats();
+    printf("%llu rows in %llu bytes, %.2f bytes per row\n", (unsigned long long)stats.events,
+           (unsigned long long)stats.bytes, (double)stats.bytes / stats.events);
+    check(stats.eventSegments == (rows.size() + SERIES_SEGMENT_ROWS - 1) / SERIES_SEGMENT_ROWS &&
+          stats.bytes < rows.size() * 6,
+          "flushed, under 6 bytes per row");
+
+    // ranges against a plain filter
+    uint32_t state = 3;
+    int64_t span = rows.back().etime - rows.front().etime;
+    bool same = true;
+    for(int i = 0; i < 50; i++) {
+        int64_t from = rows.front().etime - 1000 + (int64_t)(nextRandom(state) % (span + 2000));
+        int64_t to = from + (i % 5 == 0 ? 0 : (int64_t)(nextRandom(state) % (span / 4)));
+        std::vector<WSMDataRow> expected;
+        for(const WSMDataRow &row : rows) {
+            if(row.etime >= from && row.etime < to) {
+                expected.push_back(row);
+            }
+        }
+        same = same && sameRows(scanAll(store, from, to), expected);
+    }
+    check(same, "50 ranges scan the rows a filter finds");
+
+    // a day in the middle decodes only its own blocks
+    int64_t from = rows[rows.size() / 2].etime;
+    int64_t to = from + 86400;
+    unsigned int blocks = 0;
+    unsigned int decoded = 0;
+    uint64_t found = store.scan(SITE, from, to, [&](const WSMSeriesBlock &block, unsigned int, unsigned int) {
+        blocks++;
+        decoded += block.rows;
+    });
+    check(found > 0 && blocks <= found / SERIES_BLOCK_ROWS + 2 && decoded < found + 2 * SERIES_BLOCK_ROWS,
+          "a day's scan decodes only the blocks around it");
+    check(store.scanRows("no such site", INT64_MIN, INT64_MAX, [](const WSMDataRow &) {}) == 0,
+          "unknown site scans nothing");
+
+    // a row arriving after later ones were written
+    WSMDataRow late = rows[100];
+    late.etime += 1;
+    store.append(SITE, late);
+    store.flush();
+    std::vector<WSMDataRow> around = scanAll(store, late.etime, late.etime + 1);
+    check(around.size() == 1 && sameRow(around[0], late), "late row scanned in its range");
+    check(store.stats().events == rows.size() + 1, "late row counted");
+
+    // reopened, then a segment left unfinished at the end
+    store.close();
+    check(store.open(STORE_DIRECTORY, false) && store.sites().size() == 1 && store.stats().events == rows.size() + 1,
+          "store reopens with its rows");
+    std::vector<WSMDataRow> before = scanAll(store, INT64_MIN, INT64_MAX);
+    store.close();
+    std::vector<uint8_t> partial;
+    encodeEvents(rows.data(), 500, partial);
+    FILE *file = fopen(sitePath().c_str(), "ab");
+    fwrite(partial.data(), 1, partial.size() / 2, file);
+    fclose(file);
+    check(store.open(STORE_DIRECTORY, false) && sameRows(scanAll(store, INT64_MIN, INT64_MAX), before),
+          "unfinished segment cut off at reopen");
+    store.close();
+}   // end of scans()
+
+static void retention(const std::vector<WSMDataRow> &rows) {
+    removeStore();
+    WSMSeriesStore store;
+    store.open(STORE_DIRECTORY, false);
+    for(const WSMDataRow &row : rows) {
+        store.append(SITE, row);
+    }
+    store.flush();
+    std::vector<WSMDataRow> kept = scanAll(store, INT64_MIN, INT64_MAX);
+    std::map<int64_t, WSMRollup> expected = rollupsOf(kept);
+    uint64_t bytes = store.stats().bytes;
+
+    // part of the history, then the rest
+    int64_t cutoff = rows[rows.size() / 2].etime;
+    check(store.retain(cutoff), "retained half");
+    WSMSeriesStats stats = store.stats();
+    std::vector<WSMDataRow> events = scanAll(store, INT64_MIN, INT64_MAX);
+    std::map<int64_t, WSMRollup> hours = storedRollups(store);
+    for(const auto &hour : rollupsOf(events)) {
+        auto inserted = hours.emplace(hour.first, hour.second);
+        if(!inserted.second) {
+            inserted.first->second.merge(hour.second);
+        }
+    }
+    check(stats.rollupSegments > 0 && stats.events < kept.size() && !events.empty() && events.front().etime >= 0 &&
+          hours == expected,
+          "rollups and the events kept add up to the history");
+    bool recent = true;
+    for(const WSMDataRow &row : kept) {
+        recent = recent && (row.etime < cutoff || scanAll(store, row.etime, row.etime + 1).size() > 0);
+    }
+    check(recent, "events after the cutoff kept");
+
+    check(store.retain(INT64_MAX), "retained all");
+    stats = store.stats();
+    printf("%llu rollups in %llu bytes, from %llu bytes of events\n", (unsigned long long)stats.rollups,
+           (unsigned long long)stats.bytes, (unsigned long long)bytes);
+    check(stats.events == 0 && storedRollups(store) == expected, "rollups are those of the rows");
+    check(stats.bytes < bytes / 2, "rollups half the events' size or less");
+    store.close();
+    check(store.open(STORE_DIRECTORY, false) && storedRollups(store) == expected, "rollups survive a reopen");
+    check(store.retain(INT64_MAX) && storedRollups(store) == expected, "retaining again changes nothing");
+
+    int64_t from = expected.begin()->first + 7 * ROLLUP_SECONDS;
+    unsigned int count = 0;
+    store.scanRollups(SITE, from, from + 24 * ROLLUP_SECONDS, [&](const WSMRollup &rollup) {
+        count += rollup.start >= from && rollup.start < from + 24 * ROLLUP_SECONDS;
+    });
+    check(count == 24, "a day of rollups scanned");
+    store.close();
+    removeStore();
+}   // end of retention()
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "data/WSMDataHistory.csv";
+    bitPacking();
+    segments(recorded(path));
+    std::vector<WSMDataRow> rows = synthetic();
+    scans(rows);
+    retention(rows);
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
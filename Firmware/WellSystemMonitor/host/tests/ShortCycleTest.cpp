@@ -0,0 +1,206 @@
+/***************************************************************************************************/
+// ShortCycleTest.cpp
+//  Checks the short cycling alert: that the bucket rings of WSMCycleCounter count what a list of
+//  every cycle would, that the alert is raised at the 7th PP cycle in 10 minutes and the 25th in
+//  an hour under one shared holdoff, that 120 simulated days of the sketch raise it once the
+//  pressure tank is waterlogged and not before, and that the recorded history (argv[1]) never
+//  raises it, and that the cycles of a clock the cloud has not set yet are not counted.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "FirmwareSimulator.h"
+#include "HistoryReplay.h"
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "WSMCycleCounter.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// the cycles of times in the bucket of now and the buckets - 1 before it
+static unsigned int bruteCount(const std::vector<time_t> &times, time_t now, time_t buckets, time_t bucketSeconds) {
+    unsigned int count = 0;
+    for(time_t time : times) {
+        if(time / bucketSeconds > now / bucketSeconds - buckets) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void testCounter() {
+    std::mt19937 random(16);
+    WSMCycleCounter counter;
+    counter.begin();
+    std::vector<time_t> times;
+    time_t now = 1767225600;
+    bool same = true;
+    for(int n = 0; n < 20000 && same; n++) {
+        // mostly short cycling, sometimes a quiet spell, now and then a day or more off line
+        unsigned int pick = random() % 100;
+        now += pick < 80 ? random() % 120 : pick < 98 ? random() % 7200 : 86400 + random() % 86400;
+        if(random() % 4 != 0) {
+            counter.add(now);
+            times.push_back(now);
+        }
+        same = counter.count(CYCLES_10_MINUTES, now) == bruteCount(times, now, 10, 60) &&
+               counter.count(CYCLES_HOUR, now) == bruteCount(times, now, 12, 300) &&
+               counter.count(CYCLES_DAY, now) == bruteCount(times, now, 24, 3600);
+    }
+    check(same, "the rings count as a list of every cycle");
+
+    counter.begin();
+    counter.add(now);
+    counter.add(now - 600);     // the clock stepped back
+    check(counter.count(CYCLES_10_MINUTES, now - 600) == 2 && counter.count(CYCLES_10_MINUTES, now) == 2,
+          "a clock stepped back counts into the current bucket");
+    check(counter.count(CYCLES_10_MINUTES, now + 600) == 0 && counter.count(CYCLES_HOUR, now + 600) == 2 &&
+          counter.count(CYCLES_DAY, now + 30 * 86400) == 0, "each ring expires on its own horizon");
+
+    WSMBucketRing<2, 60> ring;
+    for(int i = 0; i < 70000; i++) {
+        ring.add(now);
+    }
+    check(ring.count(now) == 0xFFFF && ring.count(now + 60) == 0xFFFF && ring.count(now + 120) == 0,
+          "a bucket saturates");
+}
+
+// the names of the short cycling alerts published since the last call, and their messages
+static std::vector<std::string> takeShortCycling() {
+    std::vector<std::string> messages;
+    for(const ParticleHost::PublishRecord &record : ParticleHost::published()) {
+        if(record.name == "wsmAlertPPShortCycling") {
+            messages.push_back(record.data);
+            printf("  %s %s\n", record.name.c_str(), record.data.c_str());
+        }
+    }
+    ParticleHost::clearPublished();
+    return messages;
+}
+
+static void ppCycles(WSMAlertProcessor &alerter, int cycles, int secondsApart) {
+    for(int i = 0; i < cycles; i++) {
+        ParticleHost::setUnixTime(Time.now() + secondsApart);
+        alerter.ppTurnedOn();
+        alerter.ppTurnedOff(0.5f);
+    }
+}
+
+static void testAlert() {
+    WSMAlertLimits limits;
+    check(WSMAlertProcessor(limits).get_ruleCount() == 7, "off by default");
+    limits.ppCycles10Minutes = 6;
+    limits.ppCyclesHour = 24;
+    WSMAlertProcessor alerter(limits);
+    check(alerter.get_ruleCount() == 9, "two rules when the limits are set");
+
+    ParticleHost::reset();
+    ParticleHost::setUnixTime(1767225600);      // on a 10 minute boundary
+    alerter.begin();
+    ppCycles(alerter, 6, 60);
+    check(takeShortCycling().empty(), "6 cycles in 10 minutes");
+    ppCycles(alerter, 1, 60);
+    std::vector<std::string> messages = takeShortCycling();
+    check(messages.size() == 1 && messages[0].find("\"msg\":\"PP came on 7 times in 10 minutes.\"") != std::string::npos &&
+          alerter.get_shortCycleHoldoff() == 0, "the 7th raises wsmAlertPPShortCycling");
+    ppCycles(alerter, 30, 60);
+    check(takeShortCycling().empty(), "held off, for both horizons");
+
+    // a day later: 25 cycles in an hour, never more than 5 in 10 minutes
+    for(int tick = 0; tick < 48; tick++) {
+        alerter.halfHourTimeTick();
+    }
+    ParticleHost::setUnixTime(Time.now() + 86400);
+    takeShortCycling();
+    ppCycles(alerter, 24, 120);
+    check(takeShortCycling().empty(), "24 cycles in an hour");
+    ppCycles(alerter, 1, 120);
+    messages = takeShortCycling();
+    check(messages.size() == 1 && messages[0].find("\"msg\":\"PP came on 25 times in an hour.\"") != std::string::npos,
+          "the 25th in an hour raises it");
+    check(alerter.get_ppCycles().count(CYCLES_DAY, Time.now()) == 25 &&
+          alerter.get_wpCycles().count(CYCLES_DAY, Time.now()) == 0, "the cycles of the last day");
+}
+
+// after a power loss the clock reads near 1970 until the cloud sets it; the windows, at real time,
+// must not take those cycles into their newest bucket
+static void testUnsyncedClock() {
+    WSMAlertLimits limits;
+    limits.ppCycles10Minutes = 6;
+    limits.ppCyclesHour = 24;
+    WSMAlertProcessor alerter(limits);
+    ParticleHost::reset();
+    ParticleHost::setUnixTime(1767225600);
+    alerter.begin();
+    ppCycles(alerter, 3, 60);
+    takeShortCycling();
+
+    ParticleHost::setTimeValid(false);
+    ParticleHost::setUnixTime(86400);
+    ppCycles(alerter, 10, 30);
+    alerter.halfHourTimeTick();
+    check(takeShortCycling().empty() && alerter.get_shortCycleHoldoff() != 0, "no alert while the clock is not set");
+
+    ParticleHost::setTimeValid(true);
+    ParticleHost::setUnixTime(1767225600 + 3600);
+    check(alerter.get_ppCycles().count(CYCLES_HOUR, Time.now()) == 0 &&
+          alerter.get_ppCycles().count(CYCLES_DAY, Time.now()) == 3, "cycles of the unset clock not counted");
+    ppCycles(alerter, 6, 60);
+    check(takeShortCycling().empty(), "counting again once the clock is set");
+}
+
+// a waterlogged pressure tank from day 60 of 120 simulated days of the sketch
+static void testSimulated() {
+    SimulatorConfig config;
+    config.durationMs = 120ULL * 86400000ULL;
+    config.pumps.seed = 3;
+    config.pumps.fault = FAULT_WATERLOGGED_TANK;
+    config.pumps.faultStartMs = 60ULL * 86400000ULL;
+    time_t faultStart = (time_t)(config.pumps.startUnixTime + config.pumps.faultStartMs / 1000);
+    unsigned int before = 0, after = 0;
+    FirmwareSimulator simulator(config);
+    simulator.run([&](const ParticleHost::PublishRecord &record) {
+        if(record.name == "wsmAlertPPShortCycling") {
+            (record.unixTime < faultStart ? before : after)++;
+        }
+    });
+    printf("  %u short cycling alerts before the fault, %u after\n", before, after);
+    check(before == 0 && after > 0, "the sketch raises it only for the waterlogged tank");
+}
+
+static void testHistory(const char *path) {
+    WSMDataReader reader;
+    if(!reader.open(path)) {
+        check(false, "open the recorded history");
+        return;
+    }
+    WSMAlertLimits limits;
+    limits.ppCycles10Minutes = 6;
+    limits.ppCyclesHour = 24;
+    HistoryReplay replay(limits);
+    unsigned int shortCycling = 0;
+    replay.run(reader, [&](const ReplayAlert &alert) {
+        shortCycling += alert.name == "wsmAlertPPShortCycling" ? 1 : 0;
+    });
+    check(shortCycling == 0, "the recorded history never short cycles");
+}
+
+int main(int argc, char *argv[]) {
+    if(argc < 2) {
+        fprintf(stderr, "usage: short_cycle_test WSMDataHistory.csv\n");
+        return 2;
+    }
+    testCounter();
+    testAlert();
+    testUnsyncedClock();
+    testSimulated();
+    testHistory(argv[1]);
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
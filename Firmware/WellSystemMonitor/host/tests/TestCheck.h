@@ -0,0 +1,25 @@
+#ifndef TESTCHECK_H_INCLUDE
+#define TESTCHECK_H_INCLUDE
+/***************************************************************************************************/
+// TestCheck.h
+//  The checks of the host tests: check() prints "what: PASS" or "what: FAIL" and counts the
+//  failures, which main() prints and turns into the exit status.  Each test is one program, so
+//  each has its own count.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <cstdio>
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    printf("%s: %s\n", what, condition ? "PASS" : "FAIL");
+    if(!condition) {
+        failures++;
+    }
+}
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,199 @@
+/***************************************************************************************************/
+// ThresholdSweepTest.cpp
+//  Checks that the work stealing pool runs every task exactly once, that a sweep over
+//  data/WSMDataHistory.csv with the default limits raises the same alerts as the replay, that the
+//  parallel sweep matches running each combination alone, that the ranking picks the limit
+//  that catches a labelled incident without a false alert, and that every lane of
+//  LaneAlertProcessor is bit identical to WSMAlertProcessor.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "LaneAlertProcessor.h"
+#include "ParticleHost.h"
+#include "TestCheck.h"
+#include "ThresholdSweep.h"
+#include "WorkStealingPool.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static bool sameResult(const SweepResult &a, const SweepResult &b) {
+    return a.alerts == b.alerts && memcmp(a.alertsByType, b.alertsByType, sizeof(a.alertsByType)) == 0 &&
+           a.detected == b.detected && a.missed == b.missed && a.falseAlerts == b.falseAlerts &&
+           a.distance == b.distance;
+}
+
+static void testPool() {
+    const uint64_t NUM_TASKS = 100000;
+    std::unique_ptr<std::atomic<int>[]> runs(new std::atomic<int>[NUM_TASKS]);
+    for(uint64_t i = 0; i < NUM_TASKS; i++) {
+        runs[i] = 0;
+    }
+    WorkStealingPool pool(4);
+    std::atomic<int> strangers(0);     // tasks run by a worker number outside the pool
+    pool.run(NUM_TASKS, [&](uint64_t task, int worker) {
+        if(worker < 0 || worker >= pool.numThreads()) {
+            strangers++;
+        }
+        // make the first worker's share slow so the others have to steal it
+        if(task < NUM_TASKS / 4 && task % 64 == 0) {
+            for(volatile int spin = 0; spin < 20000; spin++) {}
+        }
+        runs[task]++;
+    }, 7);
+    bool once = true;
+    for(uint64_t i = 0; i < NUM_TASKS; i++) {
+        once = once && runs[i] == 1;
+    }
+    check(once && strangers == 0, "every task run exactly once, by one of the pool's workers");
+    pool.run(0, [&](uint64_t, int) { once = false; });
+    check(once, "no tasks, nothing run");
+}
+
+// random limits and a random event stream with plenty of alerts; compare the state of every lane
+// with a scalar processor after every event
+static void testLanes() {
+    const int LANES = 16;
+    std::mt19937 random(2024);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+    LaneAlertProcessor<LANES> lanes;
+    std::vector<std::unique_ptr<WSMAlertProcessor>> scalar;
+    for(int lane = 0; lane < LANES; lane++) {
+        WSMAlertLimits limits;
+        limits.ppOnTooShort = uniform(random) * 0.6f;
+        limits.ppOnTooLong = 1.0f + uniform(random) * 2.0f;
+        limits.wpOnTooShort = 10.0f + uniform(random) * 15.0f;
+        limits.wpOnTooLong = 30.0f + uniform(random) * 15.0f;
+        limits.wpRunTooSoon = uniform(random) * 15.0f;
+        limits.wpRunTooLong = 5.0f + uniform(random) * 30.0f;
+        limits.oneDay = 1 + random() % 60;
+        limits.threeDays = 1 + random() % 200;
+        lanes.setLimits(lane, limits);
+        scalar.emplace_back(new WSMAlertProcessor(limits));
+        scalar.back()->begin();
+    }
+    lanes.begin();
+
+    std::vector<std::string> scalarAlerts[LANES];
+    int current = 0;
+    ParticleHost::setThreadPublishSink([&](const ParticleHost::PublishRecord &record) {
+        scalarAlerts[current].push_back(record.name);
+    });
+
+    std::vector<std::string> laneAlerts[LANES];
+    bool identical = true;
+    for(int n = 0; n < 200000 && identical; n++) {
+        int kind = random() % 5;
+        float runTime = kind == 2 ? uniform(random) * 4.0f : uniform(random) * 60.0f;
+        bool any = false;
+        switch(kind) {
+            case 0: any = lanes.halfHourTimeTick(); break;
+            case 1: any = lanes.ppTurnedOn(); break;
+            case 2: any = lanes.ppTurnedOff(runTime); break;
+            case 3: any = lanes.wpTurnedOn(); break;
+            case 4: any = lanes.wpTurnedOff(runTime); break;
+        }
+        for(int lane = 0; lane < LANES; lane++) {
+            current = lane;
+            WSMAlertProcessor &alerter = *scalar[lane];
+            switch(kind) {
+                case 0: alerter.halfHourTimeTick(); break;
+                case 1: alerter.ppTurnedOn(); break;
+                case 2: alerter.ppTurnedOff(runTime); break;
+                case 3: alerter.wpTurnedOn(); break;
+                case 4: alerter.wpTurnedOff(runTime); break;
+            }
+            if(any && lanes.alerted(lane)) {
+                laneAlerts[lane].push_back(alertTypeName((SweepAlertType)lanes.alert(lane)));
+            }
+            if(any && lanes.secondAlert(lane)) {
+                laneAlerts[lane].push_back(alertTypeName(ALERT_WP_NOT_COME_ON));
+            }
+            float accumulated = lanes.get_ppAccumulatedOnTime(lane);
+            float expected = alerter.get_ppAccumulatedOnTime();
+            identical = identical && memcmp(&accumulated, &expected, sizeof(float)) == 0 &&
+                        lanes.get_timeBetweenPPevents(lane) == alerter.get_timeBetweenPPevents() &&
+                        lanes.get_ppAlertHoldoff(lane) == alerter.get_ppAlertHoldoff() &&
+                        lanes.get_wpAlertHoldoff(lane) == alerter.get_wpAlertHoldoff() &&
+                        lanes.get_interPumpAlertHoldoff(lane) == alerter.get_interPumpAlertHoldoff() &&
+                        lanes.get_ppNotRunAlertHoldoff(lane) == alerter.get_ppNotRunAlertHoldoff() &&
+                        laneAlerts[lane].size() == scalarAlerts[lane].size() &&
+                        (laneAlerts[lane].empty() || laneAlerts[lane].back() == scalarAlerts[lane].back());
+        }
+    }
+    ParticleHost::setThreadPublishSink(ParticleHost::PublishSink());
+
+    size_t numAlerts = 0;
+    for(int lane = 0; lane < LANES; lane++) {
+        numAlerts += scalarAlerts[lane].size();
+    }
+    printf("%zu alerts across %d lanes\n", numAlerts, LANES);
+    check(identical && numAlerts > 10000, "every lane bit identical to WSMAlertProcessor");
+}
+
+int main(int argc, char *argv[]) {
+    testPool();
+    testLanes();
+
+    ThresholdSweep sweep;
+    WSMDataReader reader;
+    if(!reader.open(argc > 1 ? argv[1] : "WSMDataHistory.csv")) {
+        check(false, "open the recorded history");
+        return 1;
+    }
+    check(sweep.load(reader) == 2064, "every row of the recorded history is an alerter call");
+
+    SweepResult defaults = sweep.evaluate(WSMAlertLimits());
+    check(defaults.alerts == 4 && defaults.alertsByType[ALERT_WP_ON_TOO_SOON] == 1 &&
+          defaults.alertsByType[ALERT_WP_ON_TOO_LONG] == 2 && defaults.alertsByType[ALERT_WP_NOT_COME_ON] == 1,
+          "default limits raise the replay's four alerts");
+
+    // a WP run of 43.52 minutes on 8/14/2022 was a real problem; the 41.38 minute run a week earlier was not
+    sweep.addIncident(SweepIncident{1660515689, ALERT_WP_ON_TOO_LONG});
+    SweepGrid grid;
+    grid.wpOnTooLong = {38.0f, 40.0f, 42.0f, 44.0f, 46.0f};
+    grid.ppOnTooShort = {0.1f, 0.3f, 0.5f};
+    grid.oneDay = {24, 48, 96};
+    std::vector<SweepResult> results = sweep.run(grid, 4);
+    check(results.size() == grid.size() && grid.size() == 45, "every combination evaluated");
+
+    bool same = true;
+    for(const SweepResult &result : results) {
+        same = same && sameResult(result, sweep.evaluate(grid.limits(result.index), result.index));
+    }
+    check(same, "parallel results match each combination run alone");
+
+    sweep.setScalar(true);
+    std::vector<SweepResult> scalarResults = sweep.run(grid, 4);
+    sweep.setScalar(false);
+    same = scalarResults.size() == results.size();
+    for(size_t i = 0; same && i < results.size(); i++) {
+        same = results[i].index == scalarResults[i].index && sameResult(results[i], scalarResults[i]);
+    }
+    check(same, "lane sweep ranks exactly as the scalar sweep");
+
+    check(results[0].limits.wpOnTooLong == 42.0f && results[0].detected == 1 &&
+          results[0].alertsByType[ALERT_WP_ON_TOO_LONG] == 1, "42 minutes catches the incident and only it");
+    // 44 minutes still catches the 44.43 minute run that followed it, an hour and a half late
+    bool missedAbove = true;
+    for(const SweepResult &result : results) {
+        if(result.limits.wpOnTooLong == 44.0f) {
+            missedAbove = missedAbove && result.detected == 1 && result.distance == 1660521303.0 - 1660515689.0;
+        } else if(result.limits.wpOnTooLong == 46.0f) {
+            missedAbove = missedAbove && result.missed == 1;
+        }
+    }
+    check(missedAbove, "later detection at 44 minutes, missed at 46");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
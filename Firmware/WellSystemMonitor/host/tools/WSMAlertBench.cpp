@@ -0,0 +1,200 @@
+/***************************************************************************************************/
+// WSMAlertBench.cpp
+//  Measures the alert rule table of WSMAlertProcessor (src/WSMAlertProcessor.h) with its fixed rules
+//  and with 64 rules, against the hand written branches that alerts #1 to #7 replaced: the time
+//  per pump event over a stream of healthy pump cycles (a PP cycle every 40 minutes, a WP cycle
+//  after every tenth, a ½ hour tick), in which nothing alerts, so every rule is evaluated in full.
+//  The site rules are spread over the five triggers and never hold.
+//
+//  usage: wsm_alert_bench [--rounds N]      (default 200 rounds of a year of events)
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "WSMAlertProcessor.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+// the branches of WSMAlertProcessor before the rule table, counting the alerts instead of
+// publishing them
+struct BranchAlerts {
+    WSMAlertLimits limits;
+    float ppAccumulatedOnTime;
+    unsigned int timeBetweenPPevents;
+    unsigned int ppAlertHoldoff, wpAlertHoldoff, interPumpAlertHoldoff, ppNotRunAlertHoldoff;
+    unsigned int alerts;
+
+    void begin() {
+        ppAccumulatedOnTime = 0.0f;
+        timeBetweenPPevents = 0;
+        ppAlertHoldoff = wpAlertHoldoff = interPumpAlertHoldoff = limits.oneDay;
+        ppNotRunAlertHoldoff = limits.threeDays;
+        alerts = 0;
+    }
+
+    void halfHourTimeTick() {
+        ppAlertHoldoff += ppAlertHoldoff < limits.oneDay ? 1 : 0;
+        wpAlertHoldoff += wpAlertHoldoff < limits.oneDay ? 1 : 0;
+        interPumpAlertHoldoff += interPumpAlertHoldoff < limits.oneDay ? 1 : 0;
+        ppNotRunAlertHoldoff += ppNotRunAlertHoldoff < limits.threeDays ? 1 : 0;
+        if(timeBetweenPPevents < limits.oneDay) {
+            timeBetweenPPevents++;
+        } else {
+            if(ppNotRunAlertHoldoff >= limits.threeDays) {
+                alerts++;
+                ppNotRunAlertHoldoff = 0;
+            }
+            timeBetweenPPevents = limits.oneDay;
+        }
+    }
+
+    void ppTurnedOn() {
+        timeBetweenPPevents = 0;
+    }
+
+    void ppTurnedOff(float runTime) {
+        if(ppAlertHoldoff >= limits.oneDay && (runTime < limits.ppOnTooShort || runTime > limits.ppOnTooLong)) {
+            alerts++;
+            ppAlertHoldoff = 0;
+        }
+        if(ppAccumulatedOnTime < limits.wpRunTooLong) {
+            ppAccumulatedOnTime += runTime;
+        } else {
+            if(interPumpAlertHoldoff >= limits.oneDay) {
+                alerts++;
+                interPumpAlertHoldoff = 0;
+            }
+            ppAccumulatedOnTime = limits.wpRunTooLong;
+        }
+    }
+
+    void wpTurnedOn() {
+        if(interPumpAlertHoldoff >= limits.oneDay && ppAccumulatedOnTime < limits.wpRunTooSoon) {
+            alerts++;
+            interPumpAlertHoldoff = 0;
+        }
+        ppAccumulatedOnTime = 0.0f;
+    }
+
+    void wpTurnedOff(float runTime) {
+        if(wpAlertHoldoff >= limits.oneDay && (runTime < limits.wpOnTooShort || runTime > limits.wpOnTooLong)) {
+            alerts++;
+            wpAlertHoldoff = 0;
+        }
+    }
+};
+
+struct PumpEvent {
+    time_t time;
+    WSMAlertTrigger trigger;
+    float runTime;
+};
+
+static double seconds(const std::function<void()> &run) {
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    run();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+template<class Alerter> static void replay(Alerter &alerter, const std::vector<PumpEvent> &events) {
+    for(const PumpEvent &event : events) {
+        ParticleHost::setUnixTime(event.time);
+        switch(event.trigger) {
+            case ALERT_ON_TICK:
+                alerter.halfHourTimeTick();
+                break;
+            case ALERT_ON_PP_ON:
+                alerter.ppTurnedOn();
+                break;
+            case ALERT_ON_PP_OFF:
+                alerter.ppTurnedOff(event.runTime);
+                break;
+            case ALERT_ON_WP_ON:
+                alerter.wpTurnedOn();
+                break;
+            default:
+                alerter.wpTurnedOff(event.runTime);
+                break;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int rounds = 200;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            rounds = (unsigned int)strtoul(argv[++i], nullptr, 0);
+        } else {
+            fprintf(stderr, "usage: wsm_alert_bench [--rounds N]\n");
+            return 2;
+        }
+    }
+
+    // a year of healthy pump events: a tick every ½ hour, a PP cycle every 40 minutes and a WP
+    // cycle after every tenth
+    std::mt19937 random(15);
+    std::normal_distribution<float> ppRun(1.1f, 0.05f), wpRun(30.0f, 1.0f);
+    std::vector<PumpEvent> events;
+    unsigned int ppCycles = 0;
+    for(unsigned int minute = 0; minute < 365 * 24 * 60; minute += 10) {
+        time_t time = 1767225600 + minute * 60;
+        if(minute % 30 == 0) {
+            events.push_back(PumpEvent{time, ALERT_ON_TICK, 0.0f});
+        }
+        if(minute % 40 == 0) {
+            events.push_back(PumpEvent{time, ALERT_ON_PP_ON, 0.0f});
+            events.push_back(PumpEvent{time + 66, ALERT_ON_PP_OFF, ppRun(random)});
+            if(++ppCycles % 10 == 0) {
+                events.push_back(PumpEvent{time + 120, ALERT_ON_WP_ON, 0.0f});
+                events.push_back(PumpEvent{time + 1920, ALERT_ON_WP_OFF, wpRun(random)});
+            }
+        }
+    }
+
+    // the site rules: every trigger and measure, never holding
+    WSMAlertProcessor fixed, many;
+    for(unsigned int i = 0; many.get_ruleCount() < ALERT_MAX_RULES; i++) {
+        WSMAlertRule rule = {"wsmAlertBench", (uint8_t)(i % ALERT_TRIGGERS), (uint8_t)(i % ALERT_MEASURES),
+                             (uint8_t)(i % 2 ? ALERT_ABOVE : ALERT_AT_LEAST), 1.0e6f, 48, ALERT_OWN_HOLDOFF,
+                             (uint8_t)i, 0, "bench ", "."};
+        many.addRule(rule);
+    }
+    BranchAlerts branches;
+
+    ParticleHost::reset();
+    double branchTime = seconds([&]() {
+        for(unsigned int round = 0; round < rounds; round++) {
+            branches.begin();
+            replay(branches, events);
+        }
+    });
+    double fixedTime = seconds([&]() {
+        for(unsigned int round = 0; round < rounds; round++) {
+            fixed.begin();
+            replay(fixed, events);
+        }
+    });
+    double manyTime = seconds([&]() {
+        for(unsigned int round = 0; round < rounds; round++) {
+            many.begin();
+            replay(many, events);
+        }
+    });
+
+    double perEvent = 1e9 / ((double)rounds * events.size());
+    printf("%u rounds of %zu pump events (%u, %u, %u alerts)\n", rounds, events.size(), branches.alerts,
+           fixed.get_alertCount(), many.get_alertCount());
+    printf("branches          %6.2f ns per event\n", branchTime * perEvent);
+    printf("%2u rules (table)  %6.2f ns per event\n", fixed.get_ruleCount(), fixedTime * perEvent);
+    printf("%2u rules (table)  %6.2f ns per event\n", many.get_ruleCount(), manyTime * perEvent);
+    return 0;
+}
@@ -0,0 +1,322 @@
+/***************************************************************************************************/
+// WSMAlertRouter.cpp
+//  Routes wsmAlert* events to their recipients (dispatch/WSMAlertRouter.h): from a Particle event
+//  stream, or from a burst of alerts made up to measure the router.
+//
+//  usage: wsm_alert_router [--routes FILE] [--mailbox FILE] [--window MS] [--rate N] --in FILE|-
+//         wsm_alert_router [--mailbox FILE] [--window MS] [--rate N] --bench N
+//                          [--sites S] [--devices D] [--recipients R] [--producers P]
+//
+//  --routes reads the sites of the devices and their recipients (see WSMAlertRouter::loadRoutes());
+//  --mailbox appends the messages to an mbox file, and without it they are printed.  --window is
+//  the digest window (60000 ms) and --rate the messages a site and recipient get an hour (6).
+//
+//  --in routes the wsmAlert* lines of an event stream, as wsm_fleet --out writes it, on the
+//  alerts' own times, and sends what is still held at the end:
+//
+//      wsm_fleet --devices 1000 --days 7 --faults 0.1 --out - | wsm_alert_router --in - --mailbox alerts.mbox
+//
+//  --bench submits N alerts at once from P threads (4), from D devices (10000) of S sites (1000)
+//  with R recipients each (1), to a router on its own thread (WSMAlertDispatcher.h) with a digest
+//  window of 200 ms, and reports how fast they are submitted and routed and how long each took to
+//  be delivered, alone or in a digest.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMAlertDispatcher.h"
+#include "WSMJsonReader.h"
+#include "WSMMailbox.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void usage() {
+    fprintf(stderr,
+            "usage: wsm_alert_router [--routes FILE] [--mailbox FILE] [--window MS] [--rate N] --in FILE|-\n"
+            "       wsm_alert_router [--mailbox FILE] [--window MS] [--rate N] --bench N\n"
+            "                        [--sites S] [--devices D] [--recipients R] [--producers P]\n");
+    exit(2);
+}
+
+namespace {
+
+    struct BenchOptions {
+        unsigned int alerts = 0;
+        unsigned int sites = 1000;
+        unsigned int devices = 10000;
+        unsigned int recipients = 1;
+        unsigned int producers = 4;
+    };
+
+    void printMessage(const WSMAlertMessage &message) {
+        printf("To: %s\nSubject: %s\n%s\n\n", message.recipient.c_str(), message.subject.c_str(),
+               message.body.c_str());
+    }
+
+    // the data of an event stream line, unescaped: only \" \\ \/ and \n occur in the firmware's
+    void unescape(std::string_view text, std::string &out) {
+        out.clear();
+        for(size_t i = 0; i < text.size(); i++) {
+            char c = text[i];
+            if(c == '\\' && i + 1 < text.size()) {
+                c = text[++i];
+                c = c == 'n' ? '\n' : c;
+            }
+            out += c;
+        }
+    }
+
+    std::string coreid(unsigned int device) {
+        char text[32];
+        snprintf(text, sizeof(text), "%024x", 0xE0000 + device);
+        return text;
+    }
+
+    double percentile(std::vector<uint64_t> &values, double fraction) {
+        if(values.empty()) {
+            return 0.0;
+        }
+        size_t i = std::min(values.size() - 1, (size_t)(fraction * values.size()));
+        std::nth_element(values.begin(), values.begin() + i, values.end());
+        return values[i] / 1000.0;
+    }
+
+    void printLatency(const char *name, std::vector<uint64_t> &latencies) {
+        if(latencies.empty()) {
+            return;
+        }
+        uint64_t most = *std::max_element(latencies.begin(), latencies.end());
+        printf("  %-10s %7zu alerts: p50 %.2f ms, p99 %.2f ms, max %.2f ms\n", name, latencies.size(),
+               percentile(latencies, 0.50), percentile(latencies, 0.99), most / 1000.0);
+    }
+
+    // the wsmAlert* lines of the stream at path, on their etimes
+    int replay(WSMAlertRouter &router, const char *path) {
+        FILE *in = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+        if(in == nullptr) {
+            fprintf(stderr, "can't read %s\n", path);
+            return 1;
+        }
+        char line[1024];
+        std::string data;
+        WSMJsonReader json;
+        WSMJsonReader alert;
+        int64_t nowMs = 0;
+        uint64_t lines = 0;
+        while(fgets(line, sizeof(line), in) != nullptr) {
+            lines++;
+            std::string_view event, escaped, device;
+            double etime;
+            if(!json.read(line) || !json.string("event", event) || event.substr(0, 8) != "wsmAlert") {
+                continue;
+            }
+            json.string("data", escaped);
+            json.string("coreid", device);
+            unescape(escaped, data);
+            // the devices' lines are each in order, not with each other's
+            if(alert.read(data) && alert.number("etime", etime)) {
+                nowMs = std::max(nowMs, (int64_t)etime * 1000);
+            }
+            router.poll(nowMs);
+            router.route(device, event, data, nowMs);
+        }
+        if(in != stdin) {
+            fclose(in);
+        }
+        router.poll(nowMs);
+        router.flush(nowMs);
+        fprintf(stderr, "%llu lines\n", (unsigned long long)lines);
+        return 0;
+    }
+
+    // n alerts at once, and how long they take
+    int bench(WSMAlertRouterConfig config, const BenchOptions &options, WSMMailbox *mailbox) {
+        std::vector<uint64_t> alone;
+        std::vector<uint64_t> digested;
+        std::atomic<uint64_t> lastSentUs(0);
+        WSMAlertRouter router(config, [&](const WSMAlertMessage &message) {
+            if(mailbox != nullptr && !mailbox->deliver(message)) {
+                return false;
+            }
+            uint64_t now = WSMAlertDispatcher::nowMicros();
+            for(const WSMRoutedAlert &alert : message.alerts) {
+                (message.digest ? digested : alone).push_back(now - alert.receivedUs);
+            }
+            lastSentUs = now;
+            return true;
+        });
+        for(unsigned int d = 0; d < options.devices; d++) {
+            char site[32];
+            snprintf(site, sizeof(site), "site%u", d % options.sites);
+            router.mapDevice(coreid(d), site);
+        }
+        for(unsigned int s = 0; s < options.sites; s++) {
+            for(unsigned int r = 0; r < options.recipients; r++) {
+                char site[32], recipient[64];
+                snprintf(site, sizeof(site), "site%u", s);
+                snprintf(recipient, sizeof(recipient), "owner%u@site%u.example.com", r, s);
+                router.addRecipient(site, recipient);
+            }
+        }
+
+        // the alerts, made before the clock starts
+        std::vector<std::vector<std::string>> devices(options.producers);
+        std::vector<std::vector<const char *>> events(options.producers);
+        std::vector<std::vector<std::string>> datas(options.producers);
+        uint32_t seed = 1;
+        int64_t etime = (int64_t)time(nullptr);
+        for(unsigned int i = 0; i < options.alerts; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            unsigned int p = i % options.producers;
+            unsigned int kind = (seed >> 8) % ALERT_KINDS;
+            char data[128];
+            snprintf(data, sizeof(data), "{\"etime\":%lld,\"msg\":\"Alert %u: on for %u.%u minutes.\"}",
+                     (long long)etime, i, (seed >> 4) % 60, (seed >> 12) % 10);
+            devices[p].push_back(coreid((seed >> 16) % options.devices));
+            events[p].push_back(WSM_ALERT_KINDS[kind].event);
+            datas[p].push_back(data);
+        }
+
+        WSMAlertDispatcher dispatcher(router);
+        dispatcher.start();
+        uint64_t startUs = WSMAlertDispatcher::nowMicros();
+        std::vector<std::thread> producers;
+        for(unsigned int p = 0; p < options.producers; p++) {
+            producers.emplace_back([&, p]() {
+                for(size_t i = 0; i < datas[p].size(); i++) {
+                    dispatcher.submit(devices[p][i], events[p][i], datas[p][i]);
+                }
+            });
+        }
+        for(std::thread &producer : producers) {
+            producer.join();
+        }
+        uint64_t submittedUs = WSMAlertDispatcher::nowMicros();
+        while(dispatcher.routed() < options.alerts) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        uint64_t routedUs = WSMAlertDispatcher::nowMicros();
+        // the digests are sent a window after the first alerts; done once none has been for two
+        uint64_t quietUs = 2 * (uint64_t)config.digestWindowMs * 1000 + 50000;
+        while(WSMAlertDispatcher::nowMicros() - std::max(routedUs, lastSentUs.load()) < quietUs) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        uint64_t deliveredUs = lastSentUs.load();
+        dispatcher.stop();
+        uint64_t held = router.held();
+        dispatcher.stop(true);
+
+        const WSMAlertRouterStats &stats = router.stats();
+        printf("%u alerts from %u producers, %u devices, %u sites, %u recipient%s each\n", options.alerts,
+               options.producers, options.devices, options.sites, options.recipients,
+               options.recipients == 1 ? "" : "s");
+        printf("submitted in %.1f ms, %.0f alerts/s\n", (submittedUs - startUs) / 1000.0,
+               options.alerts / ((submittedUs - startUs) / 1e6));
+        printf("routed in %.1f ms, %.0f alerts/s, in %llu wakes\n", (routedUs - startUs) / 1000.0,
+               options.alerts / ((routedUs - startUs) / 1e6), (unsigned long long)dispatcher.wakes());
+        printf("delivered in %.1f ms: %llu messages (%llu digests) with %llu alerts; %llu duplicates, "
+               "%llu throttled\n", (deliveredUs - startUs) / 1000.0, (unsigned long long)stats.messages,
+               (unsigned long long)stats.digests, (unsigned long long)stats.alertsSent,
+               (unsigned long long)stats.duplicates, (unsigned long long)stats.throttled);
+        printf("latency, first report to delivery:\n");
+        printLatency("alone", alone);
+        printLatency("in digests", digested);
+        if(held > 0) {
+            printf("%llu alerts still held for a token\n", (unsigned long long)held);
+        }
+        return held == 0 ? 0 : 1;
+
+    }   // end of bench()
+
+}   // namespace
+
+int main(int argc, char *argv[]) {
+    WSMAlertRouterConfig config;
+    BenchOptions options;
+    const char *routesPath = nullptr;
+    const char *mailboxPath = nullptr;
+    const char *inPath = nullptr;
+    bool windowSet = false;
+
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if(i + 1 >= argc) {
+            usage();
+        } else if(strcmp(arg, "--routes") == 0) {
+            routesPath = argv[++i];
+        } else if(strcmp(arg, "--mailbox") == 0) {
+            mailboxPath = argv[++i];
+        } else if(strcmp(arg, "--window") == 0) {
+            config.digestWindowMs = atoll(argv[++i]);
+            windowSet = true;
+        } else if(strcmp(arg, "--rate") == 0) {
+            config.messagesPerHour = atof(argv[++i]);
+        } else if(strcmp(arg, "--in") == 0) {
+            inPath = argv[++i];
+        } else if(strcmp(arg, "--bench") == 0) {
+            options.alerts = (unsigned int)atoi(argv[++i]);
+        } else if(strcmp(arg, "--sites") == 0) {
+            options.sites = (unsigned int)atoi(argv[++i]);
+        } else if(strcmp(arg, "--devices") == 0) {
+            options.devices = (unsigned int)atoi(argv[++i]);
+        } else if(strcmp(arg, "--recipients") == 0) {
+            options.recipients = (unsigned int)atoi(argv[++i]);
+        } else if(strcmp(arg, "--producers") == 0) {
+            options.producers = (unsigned int)atoi(argv[++i]);
+        } else {
+            usage();
+        }
+    }
+    if((inPath == nullptr) == (options.alerts == 0) || config.digestWindowMs < 0 || config.messagesPerHour <= 0.0 ||
+       options.sites < 1 || options.devices < 1 || options.producers < 1) {
+        usage();
+    }
+
+    WSMMailbox mailbox;
+    if(mailboxPath != nullptr && !mailbox.open(mailboxPath)) {
+        fprintf(stderr, "can't write %s\n", mailboxPath);
+        return 1;
+    }
+    if(options.alerts > 0) {
+        if(!windowSet) {
+            config.digestWindowMs = 200;
+        }
+        return bench(config, options, mailboxPath != nullptr ? &mailbox : nullptr);
+    }
+
+    WSMAlertRouter router(config, [&](const WSMAlertMessage &message) {
+        if(mailboxPath == nullptr) {
+            printMessage(message);
+            return true;
+        }
+        return mailbox.deliver(message);
+    });
+    if(routesPath == nullptr) {
+        router.addRecipient("*", "wsm-alerts@localhost");
+    } else {
+        std::string error;
+        if(!router.loadRoutes(routesPath, error)) {
+            fprintf(stderr, "bad routes in %s: %s\n", routesPath, error.c_str());
+            return 1;
+        }
+    }
+    int result = replay(router, inPath);
+    const WSMAlertRouterStats &stats = router.stats();
+    fprintf(stderr, "%llu alerts (%llu refused, %llu duplicates): %llu messages, %llu digests, %llu throttled\n",
+            (unsigned long long)stats.received, (unsigned long long)stats.refused,
+            (unsigned long long)stats.duplicates, (unsigned long long)stats.messages,
+            (unsigned long long)stats.digests, (unsigned long long)stats.throttled);
+    return result;
+
+}   // end of main()
@@ -0,0 +1,127 @@
+/***************************************************************************************************/
+// WSMDebounceBench.cpp
+//  Measures the table driven debouncer (src/WSMDebouncer.h) against one readPinDebounced() call per
+//  pin, as the sketch had it, for 4, 16 and 64 channels: the time per channel per loop() pass with
+//  the inputs quiet and with every input bouncing.  The host has 24 pins, so channels past the
+//  24th read the same pins again.  Both read their pins through the host digitalRead().
+//
+//  usage: wsm_debounce_bench [--passes N]      (default 2000000 passes per measurement)
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "WSMDebouncer.h"
+#include "application.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+// the sketch's ty_debouncePin and readPinDebounced(), for comparison
+struct DebouncePin {
+    unsigned int pinNumber;
+    bool value;
+    bool lastReadValue;
+    system_tick_t beginTime;
+    system_tick_t debounceDelay;
+};
+
+static bool readPinDebounced(DebouncePin *pin) {
+    bool stateChanged = false;
+    bool currentReadValue = digitalRead(pin->pinNumber) != 0;
+    system_tick_t timeNow = millis();
+    if(currentReadValue != pin->lastReadValue) {
+        pin->beginTime = timeNow;
+        pin->lastReadValue = currentReadValue;
+    } else if(timeNow - pin->beginTime > pin->debounceDelay && pin->value != currentReadValue) {
+        pin->value = currentReadValue;
+        stateChanged = true;
+    }
+    return stateChanged;
+}
+
+static double seconds(const std::function<void()> &run) {
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    run();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+// one pass of virtual time; when bouncing, a pin changes on about one pass in eight
+static void nextPass(uint32_t pass, bool bouncing) {
+    ParticleHost::advanceMillis(1);
+    if(bouncing) {
+        uint16_t pin = (uint16_t)((pass * 7) % TOTAL_PINS);
+        ParticleHost::setPin(pin, (pass / 8) % 2 ? HIGH : LOW);
+    }
+}
+
+static void measure(unsigned int count, uint32_t passes, bool bouncing) {
+    std::vector<WSMDebounceChannel> table;
+    std::vector<DebouncePin> pins;
+    for(unsigned int i = 0; i < count; i++) {
+        uint16_t pin = (uint16_t)(i % TOTAL_PINS);
+        table.push_back(WSMDebounceChannel{pin, true, 20});
+        pins.push_back(DebouncePin{pin, true, true, 0, 20});
+    }
+    WSMDebouncer debouncer(table.data(), count);
+
+    // the time of the passes alone, which both include
+    ParticleHost::reset();
+    double baseline = seconds([&]() {
+        for(uint32_t pass = 0; pass < passes; pass++) {
+            nextPass(pass, bouncing);
+        }
+    });
+
+    ParticleHost::reset();
+    debouncer.begin();
+    uint64_t tableChanges = 0;
+    double tableTime = seconds([&]() {
+        for(uint32_t pass = 0; pass < passes; pass++) {
+            WSMChannelMask changed = debouncer.sample();
+            tableChanges += (uint64_t)__builtin_popcountll(changed);
+            nextPass(pass, bouncing);
+        }
+    });
+
+    ParticleHost::reset();
+    uint64_t pinChanges = 0;
+    double pinTime = seconds([&]() {
+        for(uint32_t pass = 0; pass < passes; pass++) {
+            for(DebouncePin &pin : pins) {
+                pinChanges += readPinDebounced(&pin) ? 1 : 0;
+            }
+            nextPass(pass, bouncing);
+        }
+    });
+
+    double perChannel = 1e9 / ((double)passes * count);
+    printf("%2u channels  %-8s  table %6.2f ns   per pin %6.2f ns   per channel per pass   (%llu, %llu changes)\n",
+           count, bouncing ? "bouncing" : "quiet", (tableTime - baseline) * perChannel, (pinTime - baseline) * perChannel,
+           (unsigned long long)tableChanges, (unsigned long long)pinChanges);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t passes = 2000000;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else {
+            fprintf(stderr, "usage: wsm_debounce_bench [--passes N]\n");
+            return 2;
+        }
+    }
+
+    const unsigned int COUNTS[] = {4, 16, 64};
+    for(unsigned int count : COUNTS) {
+        measure(count, passes, false);
+        measure(count, passes, true);
+    }
+    return 0;
+}
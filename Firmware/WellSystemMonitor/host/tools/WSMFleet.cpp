@@ -0,0 +1,146 @@
+/***************************************************************************************************/
+// WSMFleet.cpp
+//  Runs a fleet of virtual WSM devices (sim/FleetGenerator.h) and reports how many events a second
+//  it generates, for sizing an ingest or alerting service.
+//
+//  usage: wsm_fleet [--devices N] [--threads N] [--days D | --hours H] [--speed X] [--faults F]
+//                   [--start UNIXTIME] [--seed N] [--out FILE]
+//
+//  --devices defaults to 1000 and --days to 1; --threads to every core.  --speed runs the fleet X
+//  times faster than real time (1 is real time); without it the fleet runs as fast as it can.
+//  --faults is the fraction of the devices that develop a pump fault during the run (0).  --out
+//  writes each publication to FILE ("-" for stdout) as a line of the Particle event stream:
+//
+//      {"event":"wsmEventPPstatus","data":"{\"etime\":1704069000,...}","published_at":"2024-01-01T00:30:00.000Z","coreid":"0000000000000000000e0007"}
+//
+//  Each device's lines are in order; the threads write theirs in blocks.  For example, ten thousand
+//  devices at an hour a second:
+//
+//      wsm_fleet --devices 10000 --hours 2 --speed 3600 --out - | ...
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "FleetGenerator.h"
+#include "JSONWriter.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <vector>
+
+const size_t OUT_BLOCK_SIZE = 65536;    // each thread writes its lines out in blocks of this size
+
+static void usage() {
+    fprintf(stderr,
+            "usage: wsm_fleet [--devices N] [--threads N] [--days D | --hours H] [--speed X] [--faults F]\n"
+            "                 [--start UNIXTIME] [--seed N] [--out FILE]\n");
+    exit(2);
+}
+
+int main(int argc, char *argv[]) {
+    FleetConfig config;
+    double hours = 24.0;
+    const char *outPath = nullptr;
+
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if(i + 1 >= argc) {
+            usage();
+        } else if(strcmp(arg, "--devices") == 0) {
+            config.devices = (unsigned int)atoi(argv[++i]);
+        } else if(strcmp(arg, "--threads") == 0) {
+            config.threads = atoi(argv[++i]);
+        } else if(strcmp(arg, "--days") == 0) {
+            hours = atof(argv[++i]) * 24.0;
+        } else if(strcmp(arg, "--hours") == 0) {
+            hours = atof(argv[++i]);
+        } else if(strcmp(arg, "--speed") == 0) {
+            config.speed = atof(argv[++i]);
+        } else if(strcmp(arg, "--faults") == 0) {
+            config.faultFraction = (float)atof(argv[++i]);
+        } else if(strcmp(arg, "--start") == 0) {
+            config.startUnixTime = strtoull(argv[++i], nullptr, 10);
+        } else if(strcmp(arg, "--seed") == 0) {
+            config.seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if(strcmp(arg, "--out") == 0) {
+            outPath = argv[++i];
+        } else {
+            usage();
+        }
+    }
+    if(config.devices < 1 || hours <= 0.0 || config.speed < 0.0 || config.threads < 0) {
+        usage();
+    }
+    config.durationMs = (uint64_t)(hours * 3600000.0);
+
+    FILE *out = nullptr;
+    if(outPath != nullptr) {
+        out = strcmp(outPath, "-") == 0 ? stdout : fopen(outPath, "w");
+        if(out == nullptr) {
+            fprintf(stderr, "can't write %s\n", outPath);
+            return 1;
+        }
+    }
+
+    FleetGenerator fleet(config);
+    std::vector<std::string> blocks(fleet.numThreads());
+    std::mutex outLock;
+    FleetIdle flush = [&](int thread) {
+        std::lock_guard<std::mutex> guard(outLock);
+        fwrite(blocks[thread].data(), 1, blocks[thread].size(), out);
+        fflush(out);
+        blocks[thread].clear();
+    };
+    FleetSink sink = [&](int thread, const FleetPublication &publication) {
+        char publishedAt[32];
+        char coreid[32];
+        char line[512];
+        time_t published = publication.etime;
+        strftime(publishedAt, sizeof(publishedAt), "%Y-%m-%dT%H:%M:%S.000Z", gmtime(&published));
+        snprintf(coreid, sizeof(coreid), "%024x", 0xE0000 + publication.device);
+        JSONWriter json(line, sizeof(line));
+        json.key("event", publication.name);
+        json.key("data", publication.data);
+        json.key("published_at", publishedAt);
+        json.key("coreid", coreid);
+        json.end();
+        std::string &block = blocks[thread];
+        block.append(json.c_str(), json.length());
+        block += '\n';
+        if(block.size() >= OUT_BLOCK_SIZE) {
+            flush(thread);
+        }
+    };
+
+    fprintf(stderr, "%u devices on %d threads for %.1f hours", config.devices, fleet.numThreads(), hours);
+    if(config.speed > 0.0) {
+        fprintf(stderr, " at %gx real time", config.speed);
+    }
+    fputs("\n", stderr);
+    FleetStats stats = out != nullptr ? fleet.run(sink, flush) : fleet.run(FleetSink());
+    if(out != nullptr && out != stdout) {
+        fclose(out);
+    }
+
+    fprintf(stderr, "%llu events: %llu TRH, %llu PP, %llu WP, %llu alerts; %.1f MB of names and data\n",
+            (unsigned long long)stats.events(), (unsigned long long)stats.trh, (unsigned long long)stats.ppEvents,
+            (unsigned long long)stats.wpEvents, (unsigned long long)stats.alerts, stats.bytes / 1e6);
+    fprintf(stderr, "%.2f s, %.0f events/s; %.1f events a device a day\n", stats.seconds,
+            stats.events() / stats.seconds, stats.events() / (hours / 24.0) / config.devices);
+    for(int t = 0; t < fleet.numThreads(); t++) {
+        const FleetStats &thread = fleet.threadStats()[t];
+        fprintf(stderr, "  thread %d: %llu devices, %.0f events/s\n", t, (unsigned long long)thread.devices,
+                thread.events() / thread.seconds);
+    }
+    if(config.speed > 0.0) {
+        fprintf(stderr, "latest event %.1f ms after it was due\n", stats.maxLagMs);
+    }
+    return 0;
+
+}   // end of main()
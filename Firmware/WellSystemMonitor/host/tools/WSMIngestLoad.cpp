@@ -0,0 +1,337 @@
+/***************************************************************************************************/
+// WSMIngestLoad.cpp
+//  Load generator for the ingest service (wsm_ingestd, ingest/WSMIngestServer.h): keeps N
+//  connections posting wsmEvent* webhook forms, as the Particle webhook sends them, for a number
+//  of seconds and reports the events per second stored and the ingest latency of the posts (from
+//  sending the post to its 200, which the service sends once the rows are on disk).
+//
+//  usage: wsm_ingest_load [--host A] [--port N] [--connections N] [--seconds S] [--rate R]
+//                         [--sites N] [--pack N] [--local STORE [--no-sync]]
+//
+//  --connections defaults to 64 and --seconds to 10.  Without --rate each connection posts as soon
+//  as its last post is answered; with it the connections share R posts a second on a fixed
+//  schedule, and latency is counted from when a post was due, so a stall is not hidden.  The
+//  posts come from --sites devices (default 16), each one's TRH, PP and WP events in turn, or with
+//  --pack N as wsmEventPack posts of N events.  --local runs the service in this process on a
+//  store file instead of posting to --host:--port (127.0.0.1:8080), and reports its group commits.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMIngestServer.h"
+#include "WSMEventPack.h"
+#include "JSONWriter.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+const unsigned int POSTS_PER_CONNECTION = 256;  // prepared posts each connection cycles through
+const uint32_t FIRST_ETIME = 1760000000;
+
+typedef std::chrono::steady_clock Clock;
+
+struct LoadOptions {
+    const char *host = "127.0.0.1";
+    int port = 8080;
+    unsigned int connections = 64;
+    double seconds = 10.0;
+    double rate = 0.0;              // posts a second, all connections; 0 as fast as answered
+    unsigned int sites = 16;
+    unsigned int pack = 0;          // events per wsmEventPack; 0 posts single events
+};
+
+struct ConnectionResult {
+    std::vector<std::string> posts;         // prepared before the run
+    std::vector<unsigned int> postEvents;   // events in each post
+    std::vector<double> latencies;  // microseconds
+    uint64_t events = 0;
+    uint64_t errors = 0;
+};
+
+static void usage() {
+    fprintf(stderr,
+            "usage: wsm_ingest_load [--host A] [--port N] [--connections N] [--seconds S] [--rate R]\n"
+            "                       [--sites N] [--pack N] [--local STORE [--no-sync]]\n");
+    exit(2);
+}
+
+static std::string formEncode(const char *text) {
+    static const char HEX[] = "0123456789ABCDEF";
+    std::string encoded;
+    for(const char *p = text; *p != '\0'; p++) {
+        unsigned char c = (unsigned char)*p;
+        if(isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            encoded += (char)c;
+        } else {
+            encoded += '%';
+            encoded += HEX[c >> 4];
+            encoded += HEX[c & 0xF];
+        }
+    }
+    return encoded;
+}
+
+// the n'th event of a site: a TRH report, then PP cycles with a WP cycle after every fourth
+static WSMJournalRecord siteEvent(unsigned int site, uint64_t n) {
+    const uint8_t KINDS[] = {JOURNAL_TRH, JOURNAL_PP_ON, JOURNAL_PP_OFF, JOURNAL_PP_ON, JOURNAL_PP_OFF, JOURNAL_PP_ON,
+                             JOURNAL_PP_OFF, JOURNAL_PP_ON, JOURNAL_PP_OFF, JOURNAL_WP_ON, JOURNAL_WP_OFF};
+    WSMJournalRecord record;
+    record.kind = KINDS[n % sizeof(KINDS)];
+    record.alert = false;
+    record.etime = FIRST_ETIME + (uint32_t)(n * 173) + site;
+    record.value1 = record.kind == JOURNAL_TRH ? 15.0f + (float)(n % 50) / 10.0f : 1.0f + (float)(n % 40) / 60.0f;
+    record.value2 = record.kind == JOURNAL_TRH ? 55.0f + (float)(n % 30) / 10.0f : 0.0f;
+    return record;
+}
+
+// the HTTP request of a webhook post
+static std::string request(const char *event, const char *data, uint32_t etime, const std::string &coreid) {
+    char publishedAt[32];
+    time_t published = etime + 1;
+    strftime(publishedAt, sizeof(publishedAt), "%Y-%m-%dT%H:%M:%S.000Z", gmtime(&published));
+    std::string body = "event=" + std::string(event) + "&data=" + formEncode(data) + "&published_at=" +
+                       formEncode(publishedAt) + "&coreid=" + coreid;
+    return "POST / HTTP/1.1\r\nHost: wsm\r\nContent-Type: application/x-www-form-urlencoded\r\nContent-Length: " +
+           std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+// a connection's posts, and the events in each
+static void preparePosts(const LoadOptions &options, unsigned int connection, std::vector<std::string> &posts,
+                         std::vector<unsigned int> &events) {
+    unsigned int site = connection % options.sites;
+    char coreid[INGEST_SITE_SIZE + 1];
+    snprintf(coreid, sizeof(coreid), "%024x", 0xE0000 + site);
+    uint64_t n = (uint64_t)(connection / options.sites) * POSTS_PER_CONNECTION * std::max(options.pack, 1u);
+    char json[JSON_EVENT_SIZE];
+    char packText[EVENT_PACK_SIZE * 2];
+    for(unsigned int i = 0; i < POSTS_PER_CONNECTION; i++) {
+        if(options.pack == 0) {
+            WSMJournalRecord record = siteEvent(site, n++);
+            const char *name = WSMEventPack::eventJSON(record, -8.0f, json, sizeof(json));
+            posts.push_back(request(name, json, record.etime, coreid));
+            events.push_back(1);
+        } else {
+            WSMEventPack pack;
+            pack.clear();
+            uint32_t etime = 0;
+            while(pack.count() < options.pack) {
+                WSMJournalRecord record = siteEvent(site, n);
+                if(!pack.add(record)) {
+                    break;
+                }
+                etime = record.etime;
+                n++;
+            }
+            pack.encode(packText, sizeof(packText));
+            posts.push_back(request(EVENT_PACK_NAME, packText, etime, coreid));
+            events.push_back(pack.count());
+        }
+    }
+}
+
+static int connectTo(const LoadOptions &options) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)options.port);
+    if(inet_pton(AF_INET, options.host, &address.sin_addr) != 1) {
+        return -1;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    if(fd < 0 || connect(fd, (sockaddr *)&address, sizeof(address)) != 0) {
+        if(fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return fd;
+}
+
+// send a post and read its reply; false if the connection failed or the reply was not a 200
+static bool post(int fd, const std::string &request, std::string &reply) {
+    const char *p = request.data();
+    size_t left = request.size();
+    while(left > 0) {
+        ssize_t n = send(fd, p, left, MSG_NOSIGNAL);
+        if(n <= 0) {
+            return false;
+        }
+        p += n;
+        left -= n;
+    }
+
+    reply.clear();
+    char buffer[1024];
+    size_t headEnd = std::string::npos;
+    size_t length = 0;
+    while(headEnd == std::string::npos || reply.size() < headEnd + 4 + length) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if(n <= 0) {
+            return false;
+        }
+        reply.append(buffer, n);
+        if(headEnd == std::string::npos && (headEnd = reply.find("\r\n\r\n")) != std::string::npos) {
+            size_t header = reply.find("Content-Length: ");
+            length = header < headEnd ? strtoul(reply.c_str() + header + 16, nullptr, 10) : 0;
+        }
+    }
+    return reply.compare(0, 12, "HTTP/1.1 200") == 0;
+}
+
+static void runConnection(const LoadOptions &options, unsigned int connection, Clock::time_point start,
+                          Clock::time_point end, ConnectionResult &result) {
+    const std::vector<std::string> &posts = result.posts;
+    int fd = connectTo(options);
+    if(fd < 0) {
+        result.errors++;
+        return;
+    }
+
+    // with a rate, this connection's posts are due every interval, offset from the others
+    double interval = options.rate > 0.0 ? options.connections / options.rate : 0.0;
+    Clock::time_point due = start + std::chrono::duration_cast<Clock::duration>(
+                                        std::chrono::duration<double>(interval * connection / options.connections));
+    std::string reply;
+    for(uint64_t i = 0;; i++) {
+        if(interval > 0.0) {
+            std::this_thread::sleep_until(due);
+        } else {
+            due = Clock::now();
+        }
+        if(due >= end) {
+            break;
+        }
+        unsigned int k = (unsigned int)(i % POSTS_PER_CONNECTION);
+        if(post(fd, posts[k], reply)) {
+            result.latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - due).count());
+            result.events += result.postEvents[k];
+        } else {
+            result.errors++;
+            close(fd);
+            fd = connectTo(options);
+            if(fd < 0) {
+                return;
+            }
+        }
+        due += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interval));
+    }
+    close(fd);
+}
+
+static double percentile(std::vector<double> &sorted, double p) {
+    if(sorted.empty()) {
+        return 0.0;
+    }
+    size_t at = std::min(sorted.size() - 1, (size_t)(p * sorted.size()));
+    return sorted[at];
+}
+
+int main(int argc, char *argv[]) {
+    LoadOptions options;
+    const char *localPath = nullptr;
+    bool sync = true;
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if(strcmp(arg, "--no-sync") == 0) {
+            sync = false;
+            continue;
+        }
+        if(i + 1 >= argc) {
+            usage();
+        }
+        const char *value = argv[++i];
+        if(strcmp(arg, "--host") == 0) {
+            options.host = value;
+        } else if(strcmp(arg, "--port") == 0) {
+            options.port = atoi(value);
+        } else if(strcmp(arg, "--connections") == 0) {
+            options.connections = (unsigned int)atoi(value);
+        } else if(strcmp(arg, "--seconds") == 0) {
+            options.seconds = atof(value);
+        } else if(strcmp(arg, "--rate") == 0) {
+            options.rate = atof(value);
+        } else if(strcmp(arg, "--sites") == 0) {
+            options.sites = (unsigned int)atoi(value);
+        } else if(strcmp(arg, "--pack") == 0) {
+            options.pack = (unsigned int)atoi(value);
+        } else if(strcmp(arg, "--local") == 0) {
+            localPath = value;
+        } else {
+            usage();
+        }
+    }
+    if(options.connections == 0 || options.sites == 0 || options.seconds <= 0.0) {
+        usage();
+    }
+
+    WSMIngestStore store;
+    WSMIngestServer server(store);
+    if(localPath != nullptr) {
+        if(!store.open(localPath, sync) || !server.start(0, "127.0.0.1")) {
+            fprintf(stderr, "can't run the service on %s\n", localPath);
+            return 1;
+        }
+        options.host = "127.0.0.1";
+        options.port = server.port();
+    }
+    uint64_t recordsBefore = store.records();
+
+    std::vector<ConnectionResult> results(options.connections);
+    for(unsigned int c = 0; c < options.connections; c++) {
+        preparePosts(options, c, results[c].posts, results[c].postEvents);
+    }
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now() + std::chrono::milliseconds(100);   // after the connections are made
+    Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+    for(unsigned int c = 0; c < options.connections; c++) {
+        threads.emplace_back(runConnection, std::cref(options), c, start, end, std::ref(results[c]));
+    }
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> latencies;
+    uint64_t events = 0, errors = 0;
+    for(const ConnectionResult &result : results) {
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        events += result.events;
+        errors += result.errors;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    printf("%zu posts in %.2f s, %llu events (%.0f events/s, %.0f posts/s), %llu errors\n", latencies.size(), seconds,
+           (unsigned long long)events, events / seconds, latencies.size() / seconds, (unsigned long long)errors);
+    printf("latency us: p50 %.0f  p90 %.0f  p99 %.0f  p99.9 %.0f  max %.0f\n", percentile(latencies, 0.50),
+           percentile(latencies, 0.90), percentile(latencies, 0.99), percentile(latencies, 0.999),
+           latencies.empty() ? 0.0 : latencies.back());
+
+    if(localPath != nullptr) {
+        server.stop();
+        store.close();
+        uint64_t stored = store.records() - recordsBefore;
+        printf("store: %llu records in %llu commits (%.1f events a commit)%s\n", (unsigned long long)stored,
+               (unsigned long long)store.commits(), store.commits() ? (double)stored / store.commits() : 0.0,
+               sync ? "" : ", not synced");
+        if(stored != events) {
+            fprintf(stderr, "stored %llu events of %llu\n", (unsigned long long)stored, (unsigned long long)events);
+            return 1;
+        }
+    }
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+/***************************************************************************************************/
+// WSMIngestd.cpp
+//  The ingest service: takes the wsmEvent* webhook posts over HTTP and appends their rows to a
+//  store file (ingest/WSMIngestServer.h), in place of the wsmWriteData script.  Point the webhooks
+//  at http://<host>:<port>/ with the default form body.  Runs until interrupted, then writes its
+//  counts to stderr.
+//
+//  usage: wsm_ingestd [--port N] [--address A] [--no-sync] STORE
+//         wsm_ingestd --dump STORE
+//
+//  --port defaults to 8080 and --address to 0.0.0.0.  --no-sync leaves out the fdatasync() of each
+//  group commit.  --dump writes the rows of a store as CSV in the sheet's columns, then the
+//  published_at time and the site, so that the other tools read it:
+//
+//      wsm_ingestd --dump wsm.store | wsm_replay -
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMIngestServer.h"
+
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static void usage() {
+    fprintf(stderr,
+            "usage: wsm_ingestd [--port N] [--address A] [--no-sync] STORE\n"
+            "       wsm_ingestd --dump STORE\n");
+    exit(2);
+}
+
+// a float cell, blank if missing
+static void cell(float value) {
+    if(std::isnan(value)) {
+        fputs(",", stdout);
+    } else {
+        printf(",%.7g", value);
+    }
+}
+
+static void flagCell(int value) {
+    if(value < 0) {
+        fputs(",", stdout);
+    } else {
+        printf(",%d", value);
+    }
+}
+
+static int dump(const char *path) {
+    static const char *const NAMES[] = {"wsmEventTRH", "wsmEventPPstatus", "wsmEventWPstatus", ""};
+    int64_t records = WSMIngestStore::read(path, [](const WSMIngestRow &stored) {
+        const WSMDataRow &row = stored.row;
+        printf("%lld", (long long)row.etime);
+        cell(row.temp);
+        cell(row.rh);
+        flagCell(row.pp);
+        flagCell(row.wp);
+        cell(row.ppon);
+        cell(row.wpon);
+        printf(",%s,%lld,%.*s\n", NAMES[row.event <= WSM_EVENT_OTHER ? row.event : WSM_EVENT_OTHER],
+               (long long)stored.publishedAt, (int)strnlen(stored.site, INGEST_SITE_SIZE), stored.site);
+    });
+    if(records < 0) {
+        fprintf(stderr, "can't open %s\n", path);
+        return 1;
+    }
+    fprintf(stderr, "%lld records\n", (long long)records);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int port = 8080;
+    const char *address = "0.0.0.0";
+    bool sync = true;
+    bool dumping = false;
+    const char *path = nullptr;
+
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if(arg[0] != '-') {
+            if(path != nullptr) {
+                usage();
+            }
+            path = arg;
+        } else if(strcmp(arg, "--no-sync") == 0) {
+            sync = false;
+        } else if(strcmp(arg, "--dump") == 0) {
+            dumping = true;
+        } else if(i + 1 < argc && strcmp(arg, "--port") == 0) {
+            port = atoi(argv[++i]);
+        } else if(i + 1 < argc && strcmp(arg, "--address") == 0) {
+            address = argv[++i];
+        } else {
+            usage();
+        }
+    }
+    if(path == nullptr || port < 0 || port > 65535) {
+        usage();
+    }
+    if(dumping) {
+        return dump(path);
+    }
+
+    // the signals are taken by sigwait() below, not by whichever thread they land on
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    WSMIngestStore store;
+    if(!store.open(path, sync)) {
+        fprintf(stderr, "can't open %s\n", path);
+        return 1;
+    }
+    if(store.truncatedBytes() > 0) {
+        fprintf(stderr, "%s: cut off %llu bytes of a record left unfinished\n", path,
+                (unsigned long long)store.truncatedBytes());
+    }
+    WSMIngestServer server(store);
+    if(!server.start((uint16_t)port, address)) {
+        fprintf(stderr, "can't listen on %s:%d\n", address, port);
+        return 1;
+    }
+    fprintf(stderr, "listening on %s:%u, %llu records in %s\n", address, server.port(),
+            (unsigned long long)store.records(), path);
+
+    int signal;
+    sigwait(&signals, &signal);
+    server.stop();
+    store.close();
+    fprintf(stderr, "%llu posts, %llu events, %llu refused, %llu records\n", (unsigned long long)server.posts(),
+            (unsigned long long)server.events(), (unsigned long long)server.refused(),
+            (unsigned long long)store.records());
+    return 0;
+}
@@ -0,0 +1,121 @@
+/***************************************************************************************************/
+// WSMJournalBench.cpp
+//  Measures WSMEventJournal (src/WSMEventJournal.h) on the host: appends, drains (next() and
+//  confirm()) and recovery (begin() over a full ring), with the EEPROM in memory and backed by
+//  a file that every EEPROM write goes through to, and the EEPROM bytes written per event.
+//
+//  usage: wsm_journal_bench [--records N] [--events N] [--file PATH]
+//
+//  --records is the ring size (default 64, as in the sketch), --events the events appended and
+//  drained per measurement (default 100000), --file the EEPROM file (default wsm_journal.eeprom,
+//  removed afterwards).
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ParticleHost.h"
+#include "WSMEventJournal.h"
+#include "application.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+static double seconds(const std::function<void()> &run) {
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    run();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+static WSMJournalRecord event(uint32_t n) {
+    WSMJournalRecord record;
+    record.kind = JOURNAL_PP_OFF;
+    record.alert = false;
+    record.etime = 1704067200 + n;
+    record.value1 = 1.4f;
+    record.value2 = 0.0f;
+    return record;
+}
+
+static void measure(const char *backing, unsigned int numRecords, uint32_t events) {
+    WSMEventJournal journal(0, numRecords, 0);  // no drain limit: time the journal, not the rate
+    EEPROM.clear();
+    journal.begin();
+
+    // append and drain in step, as the sketch does while connected
+    WSMJournalRecord record;
+    double inStep = seconds([&]() {
+        for(uint32_t n = 0; n < events; n++) {
+            journal.append(event(n));
+            journal.next(record);
+            journal.confirm(1);
+        }
+    });
+    uint64_t written = 0;
+    for(int address = 0; address < (int)(numRecords * JOURNAL_RECORD_SIZE); address++) {
+        written += ParticleHost::eepromWrites(address);
+    }
+
+    // a backlog: fill the ring while offline, then drain it
+    double appending = 0.0, draining = 0.0, recovering = 0.0;
+    uint32_t backlog = 0;
+    for(uint32_t done = 0; done < events; done += numRecords) {
+        appending += seconds([&]() {
+            for(unsigned int i = 0; i < numRecords; i++) {
+                journal.append(event(done + i));
+            }
+        });
+        recovering += seconds([&]() { journal.begin(); });
+        draining += seconds([&]() {
+            while(journal.next(record)) {
+                journal.confirm(1);
+                backlog++;
+            }
+        });
+    }
+    uint32_t recoveries = (events + numRecords - 1) / numRecords;
+
+    printf("%-7s append+drain %8.0f events/s   append %8.0f/s   drain %8.0f/s   recover %4u records %7.1f us"
+           "   %.1f bytes written per event\n",
+           backing, events / inStep, backlog / appending, backlog / draining, numRecords,
+           recovering * 1e6 / recoveries, (double)written / events);
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int numRecords = 64;
+    uint32_t events = 100000;
+    const char *path = "wsm_journal.eeprom";
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--records") == 0 && i + 1 < argc) {
+            numRecords = (unsigned int)atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            events = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else if(strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else {
+            fprintf(stderr, "usage: wsm_journal_bench [--records N] [--events N] [--file PATH]\n");
+            return 2;
+        }
+    }
+    if(numRecords < 2 || numRecords > JOURNAL_MAX_RECORDS ||
+       numRecords * JOURNAL_RECORD_SIZE > EEPROM.length() || events == 0) {
+        fprintf(stderr, "--records must be 2 to %u (and fit the EEPROM), --events at least 1\n", JOURNAL_MAX_RECORDS);
+        return 2;
+    }
+
+    ParticleHost::reset();
+    measure("memory", numRecords, events);
+    if(!ParticleHost::setEEPROMFile(path)) {
+        fprintf(stderr, "can't open %s\n", path);
+        return 1;
+    }
+    ParticleHost::reset();
+    measure("file", numRecords, events);
+    ParticleHost::setEEPROMFile(nullptr);
+    remove(path);
+    return 0;
+}
@@ -0,0 +1,348 @@
+/***************************************************************************************************/
+// WSMPayloadBench.cpp
+//  Counts the heap allocations and measures the time taken to build and publish each WSM payload:
+//  the wsmEvent* publications, the seven wsmAlert* publications, the SensorReport variable and
+//  the makeNameValuePair*() helpers.  Each payload is built twice: by the firmware (JSONWriter),
+//  and by the String concatenation the firmware used before, kept here as the reference.  The
+//  two must produce the same bytes.  Events are published in packs (src/WSMEventPack.h); their
+//  payload is the event as the decoder expands it (sim/WSMWebhook.h).  Every event is journaled
+//  first; its time includes the journal write, the drain into the pack and the pack publishes.
+//
+//  usage: wsm_payload_bench [--iterations N] [--check]
+//
+//  --check exits with an error if a firmware payload allocates or differs from the reference.
+//  Allocations are counted in operator new, which is where the host String gets its memory.  The
+//  host String keeps strings of up to 15 characters without allocating (std::string's small string
+//  optimization), so the String counts are lower than on the device.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "JSONWriter.h"
+#include "ParticleHost.h"
+#include "TPPUtils.h"
+#include "WSMAlertProcessor.h"
+#include "WSMEventJournal.h"
+#include "WSMPublishBatcher.h"
+#include "WSMWebhook.h"
+#include "application.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+
+// the sketch functions under test (sketches/WellSystemMonitor.cpp)
+void publishTRH(float temp, float rh);
+void publishPPchange(int newPPstatus, system_tick_t changeTime);
+void publishWPchange(int newWPstatus, system_tick_t changeTime);
+void createSensorJSON(char *json, size_t size);
+void drainJournal();
+extern WSMPublishBatcher batcher;
+extern WSMEventJournal journal;
+
+const system_tick_t JOURNAL_DRAIN_MS = 1000;    // JOURNAL_DRAIN_INTERVAL in WellSystemMonitor.ino
+
+/************************************** allocation counting ****************************************/
+static uint64_t allocations = 0;
+
+void *operator new(size_t size) {
+    allocations++;
+    void *p = malloc(size == 0 ? 1 : size);
+    if(p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    free(p);
+}
+
+/************************************ reference payloads *******************************************/
+// the payloads built the way the firmware built them before JSONWriter
+
+static String referenceTRH(float temp, float rh) {
+    String eData = "";
+    eData += "{\"etime\":";
+    eData += String(Time.now());
+    eData += ",\"temp\":";
+    eData += String(temp);
+    eData += ",\"rh\":";
+    eData += String(rh);
+    eData += ",\"loctime\":\"";
+    eData += String(Time.format("%F %T"));
+    eData += "\"}";
+    return eData;
+}
+
+static String referencePumpOff(const char *pump, const char *onName, float pumpTime) {
+    String eData = "";
+    eData += "{\"etime\":";
+    eData += String(Time.now());
+    eData += ",\"";
+    eData += pump;
+    eData += "\":";
+    eData += String(0);
+    eData += ",\"";
+    eData += onName;
+    eData += "\":";
+    eData += String(pumpTime);
+    eData += ",\"loctime\":\"";
+    eData += String(Time.format("%F %T"));
+    eData += "\"}";
+    return eData;
+}
+
+static String referenceAlert(const char *before, float value, const char *after) {
+    String eData = "{\"etime\":";
+    eData += String(Time.now());
+    eData += ",\"msg\":\"";
+    if(before != nullptr) {
+        eData += before;
+        eData += String(value);
+    }
+    eData += after;
+    eData += "\"}";
+    return eData;
+}
+
+static String referencePair(const String &name, const String &value) {
+    String nameValuePair = "";
+    nameValuePair += "\"" + name + "\"";
+    nameValuePair += ":";
+    nameValuePair += "\"" + value + "\"";
+    return nameValuePair;
+}
+
+static String referenceSensorJSON() {
+    String json = "";
+    json += referencePair("Project", "Well System Monitor");
+    json += ",\"JSONVersion\":" + String(2);
+    json += "," + referencePair("Time", Time.format("%F %T"));
+    json += ",\"PushButton\":" + String(0);
+    json += ",\"Toggle\":" + String(1);
+    json += ",\"WellPump\":" + String(0);
+    json += ",\"PressurePump\":" + String(1);
+    json += ",\"TEMP\":" + String(61.25f, 2);
+    json += ",\"RH\":" + String(48.5f, 2);
+    json = "{" + json + "}";
+    return json;
+}
+
+/****************************************** benchmark **********************************************/
+struct Measurement {
+    double allocationsPerCall;
+    double nsPerCall;
+};
+
+static Measurement measure(uint64_t iterations, const std::function<void()> &build) {
+    build();    // first call outside the count: lazily created statics
+    uint64_t before = allocations;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    for(uint64_t i = 0; i < iterations; i++) {
+        build();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return Measurement{(double)(allocations - before) / iterations, seconds * 1e9 / iterations};
+}
+
+// the data of the last publish that build() makes, or of the last event in it if it is a pack
+static std::string publishedData(const std::function<void()> &build) {
+    std::string data;
+    ParticleHost::setPublishSink([&](const ParticleHost::PublishRecord &record) {
+        expandBatch(record, [&](const ParticleHost::PublishRecord &event) { data = event.data; });
+    });
+    build();
+    ParticleHost::setPublishSink(ParticleHost::PublishSink());
+    return data;
+}
+
+static int failures = 0;
+static bool checkMode = false;
+
+static void report(const char *name, const std::string &firmware, const std::string &reference,
+                   const Measurement &withString, const Measurement &withWriter, bool heapFree = true) {
+    bool same = firmware == reference;
+    printf("%-22s %4zu bytes  String: %5.1f allocs %7.0f ns   JSONWriter: %4.1f allocs %6.0f ns  %s\n",
+           name, firmware.size(), withString.allocationsPerCall, withString.nsPerCall,
+           withWriter.allocationsPerCall, withWriter.nsPerCall, same ? "" : "DIFFERS");
+    if(!same) {
+        printf("    firmware:  %s\n    reference: %s\n", firmware.c_str(), reference.c_str());
+    }
+    if(!same || (heapFree && withWriter.allocationsPerCall != 0.0)) {
+        failures++;
+    }
+}
+
+// an alert processor whose limits make a single call raise exactly one alert, every time
+static WSMAlertProcessor *alertingProcessor(float wpRunTooLong) {
+    WSMAlertLimits limits;
+    limits.oneDay = 0;
+    limits.threeDays = 0;
+    limits.wpRunTooLong = wpRunTooLong;
+    WSMAlertProcessor *alerter = new WSMAlertProcessor(limits);
+    alerter->begin();
+    return alerter;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t iterations = 200000;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = strtoull(argv[++i], nullptr, 0);
+        } else if(strcmp(argv[i], "--check") == 0) {
+            checkMode = true;
+        } else {
+            fprintf(stderr, "usage: wsm_payload_bench [--iterations N] [--check]\n");
+            return 2;
+        }
+    }
+    if(iterations == 0) {
+        iterations = 1;
+    }
+
+    ParticleHost::setUnixTime(1704067200);
+    Time.zone(-8);
+    ParticleHost::setPublishCapture(false);     // nothing is kept, so publishing itself does not allocate
+    batcher.begin();
+    journal.begin();
+
+    // event payloads: each goes through the journal, which hands out one event a second
+    {
+        std::function<void()> firmware = []() {
+            publishTRH(61.25f, 48.5f);
+            drainJournal();
+        };
+        // the measurements move the clock on, so the payloads are compared first
+        std::string data = publishedData(firmware);
+        std::string reference = referenceTRH(61.25f, 48.5f).str();
+        report("wsmEventTRH", data, reference,
+               measure(iterations, []() { referenceTRH(61.25f, 48.5f); }), measure(iterations, []() {
+                   publishTRH(61.25f, 48.5f);
+                   ParticleHost::advanceMillis(JOURNAL_DRAIN_MS);
+                   drainJournal();
+               }));
+    }
+    {
+        std::function<void()> firmware = []() {
+            publishPPchange(1, millis());
+            drainJournal();
+            ParticleHost::advanceMillis(84000);
+            publishPPchange(0, millis());
+            drainJournal();
+            batcher.flush();
+        };
+        std::string data = publishedData(firmware);
+        std::string reference = referencePumpOff("pp", "ppon", 1.4f).str();
+        report("wsmEventPPstatus", data, reference,
+               measure(iterations, []() { referencePumpOff("pp", "ppon", 1.4f); }), measure(iterations, []() {
+                   publishPPchange(0, millis());
+                   ParticleHost::advanceMillis(JOURNAL_DRAIN_MS);
+                   drainJournal();
+               }));
+    }
+    {
+        std::function<void()> firmware = []() {
+            publishWPchange(1, millis());
+            drainJournal();
+            ParticleHost::advanceMillis(1680000);
+            publishWPchange(0, millis());
+            drainJournal();
+            batcher.flush();
+        };
+        std::string data = publishedData(firmware);
+        std::string reference = referencePumpOff("wp", "wpon", 28.0f).str();
+        report("wsmEventWPstatus", data, reference,
+               measure(iterations, []() { referencePumpOff("wp", "wpon", 28.0f); }), measure(iterations, []() {
+                   publishWPchange(0, millis());
+                   ParticleHost::advanceMillis(JOURNAL_DRAIN_MS);
+                   drainJournal();
+               }));
+    }
+
+    // alert payloads
+    struct AlertCase {
+        const char *name;
+        const char *before;
+        float value;
+        const char *after;
+        float wpRunTooLong;
+        std::function<void(WSMAlertProcessor &)> raise;
+    };
+    const AlertCase ALERTS[] = {
+        {"wsmAlertPPOnTooLong", "PP on for ", 5.0f, " minutes.", 1e30f, [](WSMAlertProcessor &a) { a.ppTurnedOff(5.0f); }},
+        {"wsmAlertPPOnTooShort", "PP on for ", 0.1f, " minutes.", 1e30f, [](WSMAlertProcessor &a) { a.ppTurnedOff(0.1f); }},
+        {"wsmAlertWPOnTooLong", "WP on for ", 50.0f, " minutes.", 1e30f, [](WSMAlertProcessor &a) { a.wpTurnedOff(50.0f); }},
+        {"wsmAlertWPOnTooShort", "WP on for ", 5.0f, " minutes.", 1e30f, [](WSMAlertProcessor &a) { a.wpTurnedOff(5.0f); }},
+        {"wsmAlertWPNotComeOn", "WP did not come on after PP run for > ", 0.0f, " minutes.", 0.0f,
+            [](WSMAlertProcessor &a) { a.ppTurnedOff(1.0f); }},
+        {"wsmAlertWPOnTooSoon", "WP came on after PP run for only ", 0.0f, " minutes.", 1e30f,
+            [](WSMAlertProcessor &a) { a.wpTurnedOn(); }},
+        {"wsmAlertPPNotRun", nullptr, 0.0f, "PP did not run for at least the last day.", 1e30f,
+            [](WSMAlertProcessor &a) { a.halfHourTimeTick(); }},
+    };
+    for(const AlertCase &alert : ALERTS) {
+        WSMAlertProcessor *alerter = alertingProcessor(alert.wpRunTooLong);
+        std::function<void()> firmware = [&]() { alert.raise(*alerter); };
+        uint64_t published = ParticleHost::publishCount();
+        std::string data = publishedData(firmware);
+        if(ParticleHost::publishCount() != published + 1) {
+            printf("%s: expected one publish\n", alert.name);
+            failures++;
+        }
+        report(alert.name, data, referenceAlert(alert.before, alert.value, alert.after).str(),
+               measure(iterations, [&]() { referenceAlert(alert.before, alert.value, alert.after); }),
+               measure(iterations, firmware));
+        delete alerter;
+    }
+
+    // the SensorReport variable, and the name value pair helpers, which still return a String
+    {
+        char json[JSON_EVENT_SIZE * 2];
+        Measurement withWriter = measure(iterations, [&]() { createSensorJSON(json, sizeof(json)); });
+        Measurement withString = measure(iterations, []() { referenceSensorJSON(); });
+        printf("%-22s %4zu bytes  String: %5.1f allocs %7.0f ns   JSONWriter: %4.1f allocs %6.0f ns\n",
+               "SensorReport", strlen(json), withString.allocationsPerCall, withString.nsPerCall,
+               withWriter.allocationsPerCall, withWriter.nsPerCall);
+        if(withWriter.allocationsPerCall != 0.0) {
+            failures++;
+        }
+
+        String name("Project"), value("Well System Monitor");
+        report("makeNameValuePair", makeNameValuePair(name, value).str(), referencePair(name, value).str(),
+               measure(iterations, [&]() { referencePair(name, value); }),
+               measure(iterations, [&]() { makeNameValuePair(name, value); }), false);   // returns a String
+        if(makeNameValuePairFloat("TEMP", 61.256f).str() != "\"TEMP\":61.26") {
+            printf("makeNameValuePairFloat: %s\n", makeNameValuePairFloat("TEMP", 61.256f).c_str());
+            failures++;
+        }
+    }
+
+    if(checkMode) {
+        printf("%d failure(s)\n", failures);
+        return failures == 0 ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+/***************************************************************************************************/
+// WSMReplay.cpp
+//  Replays recorded WSM event logs (CSV exports of the Google sheet) through WSMAlertProcessor and
+//  writes the alerts that would have been raised, one line per alert:
+//      <etime> <tab> <alert name> <tab> <alert data> <tab> <file>:<line>
+//  A summary with the replay rate is written to stderr.
+//
+//  usage: wsm_replay [--quiet] [--deviation-sigmas N] FILE...     ("-" reads stdin)
+//
+//  Each file is replayed from a freshly initialized alert processor.  --deviation-sigmas turns on
+//  the adaptive deviation alerts, as the sketch has them (4).
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "HistoryReplay.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char USAGE[] = "usage: wsm_replay [--quiet] [--deviation-sigmas N] FILE...\n";
+
+int main(int argc, char *argv[]) {
+    bool quiet = false;
+    WSMAlertLimits limits;
+    int numFiles = 0;
+    int errors = 0;
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+            continue;
+        } else if(strcmp(argv[i], "--deviation-sigmas") == 0 && i + 1 < argc) {
+            limits.deviationSigmas = (float)atof(argv[++i]);
+            continue;
+        } else if(argv[i][0] == '-' && argv[i][1] != '\0') {
+            fprintf(stderr, USAGE);
+            return 2;
+        }
+
+        const char *path = argv[i];
+        numFiles++;
+        WSMDataReader reader;
+        if(!reader.open(path)) {
+            fprintf(stderr, "can't open %s\n", path);
+            errors++;
+            continue;
+        }
+
+        HistoryReplay replay(limits);
+        std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+        ReplayStats stats = replay.run(reader, [&](const ReplayAlert &alert) {
+            if(!quiet) {
+                printf("%lld\t%s\t%s\t%s:%llu\n", (long long)alert.etime, alert.name.c_str(), alert.data.c_str(),
+                       path, (unsigned long long)alert.lineNumber);
+            }
+        });
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        fprintf(stderr, "%s: %llu rows (%llu TRH, %llu PP, %llu WP, %llu ignored), %llu lines skipped, %llu alerts\n",
+                path, (unsigned long long)stats.rows, (unsigned long long)stats.trhRows,
+                (unsigned long long)stats.ppRows, (unsigned long long)stats.wpRows,
+                (unsigned long long)stats.ignoredRows, (unsigned long long)reader.linesSkipped(),
+                (unsigned long long)stats.alerts);
+        if(seconds > 0) {
+            fprintf(stderr, "%s: %.3f s, %.2f million rows/s, %.1f MB/s\n", path, seconds,
+                    stats.rows / seconds / 1e6, reader.bytesRead() / seconds / 1e6);
+        }
+    }
+
+    if(numFiles == 0) {
+        fprintf(stderr, USAGE);
+        return 2;
+    }
+    return errors == 0 ? 0 : 1;
+}
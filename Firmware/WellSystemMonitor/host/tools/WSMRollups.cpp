@@ -0,0 +1,251 @@
+/***************************************************************************************************/
+// WSMRollups.cpp
+//  Builds and queries a rollup index (series/WSMRollupIndex.h): the half hour aggregates of each
+//  site, for the dashboard's questions over any span of time.
+//
+//  usage: wsm_rollups INDEX --build FILE [--site NAME] [--sites N] [--ingest]
+//         wsm_rollups INDEX --query SITE [--from UNIXTIME] [--to UNIXTIME] [--step SECONDS]
+//         wsm_rollups INDEX --bench N
+//
+//  --build indexes the rows of a CSV export of the sheet ("-" is not allowed: the file is read
+//  twice) as site NAME ("site"), and the alerts that replaying them through WSMAlertProcessor
+//  raises (the sheet has no alerts); with --ingest, the rows of an ingest store (wsm_ingestd) as
+//  the sites they came from.  --sites indexes each row for N sites instead (NAME-0 ...), to size
+//  a fleet's index.  The index is then saved to INDEX.
+//
+//  --query writes a site's aggregates from --from to --to (default: all of it) as CSV, one line
+//  per --step seconds (default: one line), e.g. PP cycles per day for a year:
+//
+//      wsm_rollups wsm.index --query site --from 1704067200 --to 1735689600 --step 86400
+//
+//  --bench times N ranges of random lengths over every site, after loading the index.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "HistoryReplay.h"
+#include "WSMIngestStore.h"
+#include "WSMRollupIndex.h"
+
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static void usage() {
+    fprintf(stderr,
+            "usage: wsm_rollups INDEX --build FILE [--site NAME] [--sites N] [--ingest]\n"
+            "       wsm_rollups INDEX --query SITE [--from UNIXTIME] [--to UNIXTIME] [--step SECONDS]\n"
+            "       wsm_rollups INDEX --bench N\n");
+    exit(2);
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+// a float cell, blank if missing
+static void cell(float value) {
+    if(std::isnan(value)) {
+        fputs(",", stdout);
+    } else {
+        printf(",%.2f", value);
+    }
+}
+
+static int build(const char *path, const char *file, const std::string &site, int sites, bool ingest) {
+    std::vector<std::string> names;
+    for(int i = 0; i < sites; i++) {
+        names.push_back(sites == 1 ? site : site + "-" + std::to_string(i));
+    }
+    WSMRollupIndex index;
+    uint64_t rows = 0;
+    uint64_t alerts = 0;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    if(ingest) {
+        int64_t records = WSMIngestStore::read(file, [&](const WSMIngestRow &stored) {
+            std::string from(stored.site, strnlen(stored.site, INGEST_SITE_SIZE));
+            if(sites == 1) {
+                index.add(from, stored.row);
+            }
+            for(int i = 0; sites > 1 && i < sites; i++) {
+                index.add(from + "-" + std::to_string(i), stored.row);
+            }
+            rows++;
+        });
+        if(records < 0) {
+            fprintf(stderr, "can't open %s\n", file);
+            return 1;
+        }
+    } else {
+        WSMDataReader reader;
+        if(strcmp(file, "-") == 0 || !reader.open(file)) {
+            fprintf(stderr, "can't open %s\n", file);
+            return 1;
+        }
+        WSMDataRow row;
+        while(reader.next(row)) {
+            for(const std::string &name : names) {
+                index.add(name, row);
+            }
+            rows++;
+        }
+        WSMDataReader again;
+        again.open(file);
+        HistoryReplay replay;
+        replay.run(again, [&](const ReplayAlert &alert) {
+            for(const std::string &name : names) {
+                index.addAlert(name, alert.etime);
+            }
+            alerts++;
+        });
+    }
+    double seconds = secondsSince(started);
+    fprintf(stderr, "%llu rows and %llu alerts to %d site(s) in %.2f s, %.2f million rows/s, %.1f MB in memory\n",
+            (unsigned long long)rows, (unsigned long long)alerts, sites, seconds, rows * sites / seconds / 1e6,
+            index.bytes() / 1e6);
+
+    started = std::chrono::steady_clock::now();
+    if(!index.save(path)) {
+        fprintf(stderr, "can't write %s\n", path);
+        return 1;
+    }
+    FILE *saved = fopen(path, "rb");
+    fseek(saved, 0, SEEK_END);
+    long size = ftell(saved);
+    fclose(saved);
+    fprintf(stderr, "saved %s in %.2f s, %.2f MB\n", path, secondsSince(started), size / 1e6);
+    return 0;
+
+}   // end of build()
+
+static int query(const WSMRollupIndex &index, const char *site, int64_t from, int64_t to, int64_t step) {
+    int64_t first, end;
+    if(!index.span(site, first, end)) {
+        fprintf(stderr, "no site %s\n", site);
+        return 1;
+    }
+    from = from == LLONG_MIN ? first : from;
+    to = to == LLONG_MAX ? end : to;
+    std::vector<WSMRangeStats> buckets;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    index.series(site, from, to, step > 0 ? step : to - from, buckets);
+    double seconds = secondsSince(started);
+
+    printf("start,half_hours,pp_cycles,pp_avg_min,pp_max_min,wp_cycles,wp_avg_min,wp_max_min,"
+           "wp_gaps,gap_avg_min,gap_max_min,trh,temp_min,temp_max,temp_avg,rh_min,rh_max,rh_avg,alerts\n");
+    int64_t start = from;
+    for(const WSMRangeStats &stats : buckets) {
+        printf("%lld,%llu,%llu", (long long)start, (unsigned long long)stats.slots,
+               (unsigned long long)stats.ppCycles);
+        cell(stats.ppAverageMinutes());
+        cell(stats.ppCycles > 0 ? stats.ppMaxMs / 60000.0f : NAN);
+        printf(",%llu", (unsigned long long)stats.wpCycles);
+        cell(stats.wpAverageMinutes());
+        cell(stats.wpCycles > 0 ? stats.wpMaxMs / 60000.0f : NAN);
+        printf(",%llu", (unsigned long long)stats.wpGaps);
+        cell(stats.gapAverageMinutes());
+        cell(stats.wpGaps > 0 ? stats.gapMaxMs / 60000.0f : NAN);
+        printf(",%llu", (unsigned long long)stats.trhCount);
+        cell(stats.trhCount > 0 ? stats.tempMin / 100.0f : NAN);
+        cell(stats.trhCount > 0 ? stats.tempMax / 100.0f : NAN);
+        cell(stats.tempAverage());
+        cell(stats.trhCount > 0 ? stats.rhMin / 100.0f : NAN);
+        cell(stats.trhCount > 0 ? stats.rhMax / 100.0f : NAN);
+        cell(stats.rhAverage());
+        printf(",%llu\n", (unsigned long long)stats.alerts);
+        start += step > 0 ? step : to - from;
+    }
+    fprintf(stderr, "%zu ranges in %.6f s\n", buckets.size(), seconds);
+    return 0;
+
+}   // end of query()
+
+static int bench(const WSMRollupIndex &index, int count) {
+    uint32_t state = 1;
+    uint64_t cycles = 0;
+    std::vector<std::string> sites = index.sites();
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    for(int i = 0; i < count; i++) {
+        const std::string &site = sites[i % sites.size()];
+        int64_t first, end;
+        index.span(site, first, end);
+        state = state * 1664525u + 1013904223u;
+        int64_t from = first + (int64_t)((uint64_t)state * (uint64_t)(end - first) >> 32);
+        state = state * 1664525u + 1013904223u;
+        int64_t to = from + (int64_t)((uint64_t)state * (uint64_t)(end - from) >> 32);
+        cycles += index.range(site, from, to).ppCycles;
+    }
+    double seconds = secondsSince(started);
+    fprintf(stderr, "%d ranges over %zu sites in %.3f s, %.0f ns a range (%llu PP cycles)\n", count, sites.size(),
+            seconds, seconds / count * 1e9, (unsigned long long)cycles);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = nullptr;
+    const char *building = nullptr;
+    const char *querying = nullptr;
+    std::string site = "site";
+    int sites = 1;
+    bool ingest = false;
+    int64_t from = LLONG_MIN;
+    int64_t to = LLONG_MAX;
+    int64_t step = 0;
+    int benchRanges = 0;
+
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if(arg[0] != '-') {
+            if(path != nullptr) {
+                usage();
+            }
+            path = arg;
+        } else if(strcmp(arg, "--ingest") == 0) {
+            ingest = true;
+        } else if(i + 1 < argc && strcmp(arg, "--build") == 0) {
+            building = argv[++i];
+        } else if(i + 1 < argc && strcmp(arg, "--site") == 0) {
+            site = argv[++i];
+        } else if(i + 1 < argc && strcmp(arg, "--sites") == 0) {
+            sites = atoi(argv[++i]);
+        } else if(i + 1 < argc && strcmp(arg, "--query") == 0) {
+            querying = argv[++i];
+        } else if(i + 1 < argc && strcmp(arg, "--from") == 0) {
+            from = atoll(argv[++i]);
+        } else if(i + 1 < argc && strcmp(arg, "--to") == 0) {
+            to = atoll(argv[++i]);
+        } else if(i + 1 < argc && strcmp(arg, "--step") == 0) {
+            step = atoll(argv[++i]);
+        } else if(i + 1 < argc && strcmp(arg, "--bench") == 0) {
+            benchRanges = atoi(argv[++i]);
+        } else {
+            usage();
+        }
+    }
+    int commands = (building != nullptr) + (querying != nullptr) + (benchRanges > 0);
+    if(path == nullptr || commands != 1 || sites < 1 || step < 0) {
+        usage();
+    }
+    if(building != nullptr) {
+        return build(path, building, site, sites, ingest);
+    }
+
+    WSMRollupIndex index;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    if(!index.load(path)) {
+        fprintf(stderr, "can't read %s\n", path);
+        return 1;
+    }
+    fprintf(stderr, "loaded %zu sites from %s in %.3f s\n", index.sites().size(), path, secondsSince(started));
+    if(querying != nullptr) {
+        return query(index, querying, from, to, step);
+    }
+    return bench(index, benchRanges);
+
+}   // end of main()
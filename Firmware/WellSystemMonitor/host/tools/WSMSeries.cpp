@@ -0,0 +1,246 @@
+/***************************************************************************************************/
+// WSMSeries.cpp
+//  Loads and queries a series store (series/WSMSeriesStore.h), a directory of every site's history.
+//
+//  usage: wsm_series [--no-sync] STORE --import FILE [--site NAME] [--sites N] [--ingest]
+//         wsm_series STORE --retain DAYS [--now UNIXTIME]
+//         wsm_series STORE --query SITE [--from UNIXTIME] [--to UNIXTIME] [--rollups] [--count]
+//         wsm_series STORE --stats
+//
+//  --import appends the rows of a CSV export of the sheet ("-" reads stdin) to site NAME ("site"),
+//  or with --ingest the rows of an ingest store (wsm_ingestd) to the sites they came from.
+//  --sites appends each row to N sites instead (NAME-0 ... NAME-N-1), to size a fleet's store.
+//  --retain rolls the events older than DAYS before --now (default the time now) up into hourly
+//  rollups.  --query writes a site's events in the sheet's columns, or its rollups, as CSV; --count
+//  only counts them.  Each command writes what it did and how fast to stderr.
+//
+//      wsm_simulator --days 3650 --sheet | wsm_series history --import - --sites 100
+//      wsm_series history --retain 365 --now 2070000000
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMIngestStore.h"
+#include "WSMSeriesStore.h"
+
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+static void usage() {
+    fprintf(stderr,
+            "usage: wsm_series [--no-sync] STORE --import FILE [--site NAME] [--sites N] [--ingest]\n"
+            "       wsm_series STORE --retain DAYS [--now UNIXTIME]\n"
+            "       wsm_series STORE --query SITE [--from UNIXTIME] [--to UNIXTIME] [--rollups] [--count]\n"
+            "       wsm_series STORE --stats\n");
+    exit(2);
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+// a float cell, blank if missing
+static void cell(float value) {
+    if(std::isnan(value)) {
+        fputs(",", stdout);
+    } else {
+        printf(",%.7g", value);
+    }
+}
+
+static void flagCell(int value) {
+    if(value < 0) {
+        fputs(",", stdout);
+    } else {
+        printf(",%d", value);
+    }
+}
+
+static void printStats(const WSMSeriesStore &store) {
+    WSMSeriesStats stats = store.stats();
+    fprintf(stderr, "%llu sites, %llu events in %llu segments, %llu rollups in %llu segments, %.1f MB",
+            (unsigned long long)stats.sites, (unsigned long long)stats.events,
+            (unsigned long long)stats.eventSegments, (unsigned long long)stats.rollups,
+            (unsigned long long)stats.rollupSegments, stats.bytes / 1e6);
+    if(stats.events + stats.rollups > 0) {
+        fprintf(stderr, ", %.2f bytes per row", (double)stats.bytes / (stats.events + stats.rollups));
+    }
+    fputs("\n", stderr);
+}
+
+static int import(WSMSeriesStore &store, const char *path, const std::string &site, int sites, bool ingest) {
+    std::vector<std::string> names;
+    for(int i = 0; i < sites; i++) {
+        names.push_back(sites == 1 ? site : site + "-" + std::to_string(i));
+    }
+    uint64_t rows = 0;
+    bool ok = true;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    if(ingest) {
+        int64_t records = WSMIngestStore::read(path, [&](const WSMIngestRow &stored) {
+            std::string from(stored.site, strnlen(stored.site, INGEST_SITE_SIZE));
+            if(sites == 1) {
+                ok = store.append(from, stored.row) && ok;
+            }
+            for(int i = 0; sites > 1 && i < sites; i++) {
+                ok = store.append(from + "-" + std::to_string(i), stored.row) && ok;
+            }
+            rows++;
+        });
+        if(records < 0) {
+            fprintf(stderr, "can't open %s\n", path);
+            return 1;
+        }
+    } else {
+        WSMDataReader reader;
+        if(!reader.open(path)) {
+            fprintf(stderr, "can't open %s\n", path);
+            return 1;
+        }
+        WSMDataRow row;
+        while(reader.next(row)) {
+            for(const std::string &name : names) {
+                ok = store.append(name, row) && ok;
+            }
+            rows++;
+        }
+    }
+    ok = store.flush() && ok;
+    double seconds = secondsSince(started);
+    fprintf(stderr, "%llu rows to %d site(s) in %.2f s, %.2f million rows/s\n", (unsigned long long)rows, sites,
+            seconds, rows * sites / seconds / 1e6);
+    printStats(store);
+    return ok ? 0 : 1;
+
+}   // end of import()
+
+static int query(const WSMSeriesStore &store, const char *site, int64_t from, int64_t to, bool rollups, bool count) {
+    static const char *const NAMES[] = {"wsmEventTRH", "wsmEventPPstatus", "wsmEventWPstatus", ""};
+    uint64_t rows;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    if(rollups) {
+        rows = store.scanRollups(site, from, to, [&](const WSMRollup &rollup) {
+            if(count) {
+                return;
+            }
+            printf("%lld,%u,%u,%u,%u,%u,%u,%u", (long long)rollup.start, rollup.ppCycles, rollup.ppMs,
+                   rollup.ppMaxMs, rollup.wpCycles, rollup.wpMs, rollup.wpMaxMs, rollup.trhCount);
+            if(rollup.trhCount > 0) {
+                printf(",%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", rollup.tempMin / 100.0, rollup.tempMax / 100.0,
+                       rollup.tempSum / 100.0 / rollup.trhCount, rollup.rhMin / 100.0, rollup.rhMax / 100.0,
+                       rollup.rhSum / 100.0 / rollup.trhCount);
+            } else {
+                printf(",,,,,,\n");
+            }
+        });
+    } else if(count) {
+        rows = store.scan(site, from, to, [](const WSMSeriesBlock &, unsigned int, unsigned int) {});
+    } else {
+        rows = store.scanRows(site, from, to, [](const WSMDataRow &row) {
+            printf("%lld", (long long)row.etime);
+            cell(row.temp);
+            cell(row.rh);
+            flagCell(row.pp);
+            flagCell(row.wp);
+            cell(row.ppon);
+            cell(row.wpon);
+            printf(",%s\n", NAMES[row.event <= WSM_EVENT_OTHER ? row.event : WSM_EVENT_OTHER]);
+        });
+    }
+    double seconds = secondsSince(started);
+    fprintf(stderr, "%llu %s in %.4f s, %.2f million/s\n", (unsigned long long)rows, rollups ? "rollups" : "events",
+            seconds, rows / seconds / 1e6);
+    return 0;
+
+}   // end of query()
+
+int main(int argc, char *argv[]) {
+    const char *path = nullptr;
+    const char *importing = nullptr;
+    const char *querying = nullptr;
+    std::string site = "site";
+    int sites = 1;
+    bool ingest = false;
+    bool sync = true;
+    double retainDays = -1.0;
+    int64_t now = (int64_t)time(nullptr);
+    int64_t from = LLONG_MIN;
+    int64_t to = LLONG_MAX;
+    bool rollups = false;
+    bool count = false;
+    bool statsOnly = false;
+
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if(arg[0] != '-') {
+            if(path != nullptr) {
+                usage();
+            }
+            path = arg;
+        } else if(strcmp(arg, "--no-sync") == 0) {
+            sync = false;
+        } else if(strcmp(arg, "--ingest") == 0) {
+            ingest = true;
+        } else if(strcmp(arg, "--rollups") == 0) {
+            rollups = true;
+        } else if(strcmp(arg, "--count") == 0) {
+            count = true;
+        } else if(strcmp(arg, "--stats") == 0) {
+            statsOnly = true;
+        } else if(i + 1 < argc && strcmp(arg, "--import") == 0) {
+            importing = argv[++i];
+        } else if(i + 1 < argc && strcmp(arg, "--site") == 0) {
+            site = argv[++i];
+        } else if(i + 1 < argc && strcmp(arg, "--sites") == 0) {
+            sites = atoi(argv[++i]);
+        } else if(i + 1 < argc && strcmp(arg, "--retain") == 0) {
+            retainDays = atof(argv[++i]);
+        } else if(i + 1 < argc && strcmp(arg, "--now") == 0) {
+            now = atoll(argv[++i]);
+        } else if(i + 1 < argc && strcmp(arg, "--query") == 0) {
+            querying = argv[++i];
+        } else if(i + 1 < argc && strcmp(arg, "--from") == 0) {
+            from = atoll(argv[++i]);
+        } else if(i + 1 < argc && strcmp(arg, "--to") == 0) {
+            to = atoll(argv[++i]);
+        } else {
+            usage();
+        }
+    }
+    int commands = (importing != nullptr) + (querying != nullptr) + (retainDays >= 0.0) + statsOnly;
+    if(path == nullptr || commands != 1 || sites < 1) {
+        usage();
+    }
+
+    WSMSeriesStore store;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    if(!store.open(path, sync)) {
+        fprintf(stderr, "can't open %s\n", path);
+        return 1;
+    }
+    fprintf(stderr, "opened %s in %.4f s\n", path, secondsSince(started));
+
+    if(importing != nullptr) {
+        return import(store, importing, site, sites, ingest);
+    } else if(querying != nullptr) {
+        return query(store, querying, from, to, rollups, count);
+    } else if(retainDays >= 0.0) {
+        printStats(store);
+        started = std::chrono::steady_clock::now();
+        bool ok = store.retain(now - (int64_t)(retainDays * 86400.0));
+        fprintf(stderr, "retained %g days in %.2f s\n", retainDays, secondsSince(started));
+        printStats(store);
+        return ok ? 0 : 1;
+    }
+    printStats(store);
+    return 0;
+
+}   // end of main()
@@ -0,0 +1,194 @@
+/***************************************************************************************************/
+// WSMSimulator.cpp
+//  Command line front end for the whole firmware simulator (sim/FirmwareSimulator.h).  Runs the
+//  WellSystemMonitor sketch against a simulated well system and writes the publication stream,
+//  one line per publication:  <etime> <tab> <event name> <tab> <event data>
+//
+//  By default only the wsmEvent* and wsmAlert* publications are written; --all adds the "WSM"
+//  debug publications.  --sheet writes the wsmEvent* publications as the rows the wsmWriteData
+//  script appends to the Google sheet instead, as CSV.  Batched and packed events (wsmEventBatch,
+//  wsmEventPack) are written as the separate events they carry.  A summary, with the publish rate,
+//  the data bytes and the events dropped, is written to stderr.
+//
+//  usage: wsm_simulator [--days N] [--seed N] [--start UNIXTIME] [--millis-offset N]
+//                       [--cycles-per-day N] [--bounce-ms N] [--fault NAME] [--fault-day N]
+//                       [--dht-period-s N] [--exact-loop-ms N] [--script FILE] [--all] [--sheet] [--quiet]
+//
+//  faults: waterlogged, pp-long, float-stuck, wp-short
+//  script file: one pin change per line, "<seconds after reset> <pin> <level>", e.g. "3600 D4 0"
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "FirmwareSimulator.h"
+#include "WSMWebhook.h"
+#include "application.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+static void usage() {
+    fprintf(stderr,
+            "usage: wsm_simulator [--days N] [--seed N] [--start UNIXTIME] [--millis-offset N]\n"
+            "                     [--cycles-per-day N] [--bounce-ms N] [--fault NAME] [--fault-day N]\n"
+            "                     [--dht-period-s N] [--exact-loop-ms N] [--script FILE] [--all] [--sheet] [--quiet]\n"
+            "faults: waterlogged, pp-long, float-stuck, wp-short\n");
+    exit(2);
+}
+
+static bool parseFault(const char *name, PumpFault &fault) {
+    static const struct { const char *name; PumpFault fault; } FAULTS[] = {
+        {"none", FAULT_NONE},
+        {"waterlogged", FAULT_WATERLOGGED_TANK},
+        {"pp-long", FAULT_PP_RUNS_LONG},
+        {"float-stuck", FAULT_FLOAT_STUCK},
+        {"wp-short", FAULT_WP_SHORT_RUN},
+    };
+    for(const auto &f : FAULTS) {
+        if(strcmp(name, f.name) == 0) {
+            fault = f.fault;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parsePin(const char *name, uint16_t &pin) {
+    if((name[0] == 'A' || name[0] == 'D') && name[1] >= '0' && name[1] <= '7' && name[2] == '\0') {
+        pin = (uint16_t)((name[0] == 'A' ? A0 : D0) + (name[1] - '0'));
+        return true;
+    }
+    return false;
+}
+
+// read "<seconds> <pin> <level>" lines; blank lines and lines starting with # are ignored
+static bool readScript(const char *path, std::vector<ScriptedPinChange> &script) {
+    FILE *file = fopen(path, "r");
+    if(file == nullptr) {
+        fprintf(stderr, "can't open script %s\n", path);
+        return false;
+    }
+    char line[256];
+    int lineNumber = 0;
+    while(fgets(line, sizeof(line), file) != nullptr) {
+        lineNumber++;
+        double seconds;
+        char pinName[8];
+        int level;
+        if(line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0') {
+            continue;
+        }
+        uint16_t pin;
+        if(sscanf(line, "%lf %7s %d", &seconds, pinName, &level) != 3 || !parsePin(pinName, pin)) {
+            fprintf(stderr, "%s:%d: expected \"<seconds> <pin> <level>\"\n", path, lineNumber);
+            fclose(file);
+            return false;
+        }
+        script.push_back(ScriptedPinChange{(uint64_t)(seconds * 1000.0), pin, (uint8_t)(level ? HIGH : LOW)});
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    SimulatorConfig config;
+    double days = 365.0;
+    double faultDay = 0.0;
+    bool all = false;
+    bool sheet = false;
+    bool quiet = false;
+
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if(strcmp(arg, "--all") == 0) {
+            all = true;
+            continue;
+        } else if(strcmp(arg, "--sheet") == 0) {
+            sheet = true;
+            continue;
+        } else if(strcmp(arg, "--quiet") == 0) {
+            quiet = true;
+            continue;
+        }
+        if(value == nullptr) {
+            usage();
+        }
+        i++;
+        if(strcmp(arg, "--days") == 0) {
+            days = atof(value);
+        } else if(strcmp(arg, "--seed") == 0) {
+            config.pumps.seed = (uint32_t)strtoul(value, nullptr, 0);
+        } else if(strcmp(arg, "--start") == 0) {
+            config.pumps.startUnixTime = strtoull(value, nullptr, 0);
+        } else if(strcmp(arg, "--millis-offset") == 0) {
+            config.millisOffset = (uint32_t)strtoul(value, nullptr, 0);
+        } else if(strcmp(arg, "--cycles-per-day") == 0) {
+            config.pumps.ppCyclesPerDay = (float)atof(value);
+        } else if(strcmp(arg, "--bounce-ms") == 0) {
+            config.pumps.bounceMs = (uint32_t)strtoul(value, nullptr, 0);
+        } else if(strcmp(arg, "--fault") == 0) {
+            if(!parseFault(value, config.pumps.fault)) {
+                usage();
+            }
+        } else if(strcmp(arg, "--fault-day") == 0) {
+            faultDay = atof(value);
+        } else if(strcmp(arg, "--dht-period-s") == 0) {
+            config.dhtPeriodMs = (uint32_t)(atof(value) * 1000.0);
+        } else if(strcmp(arg, "--exact-loop-ms") == 0) {
+            config.exactLoopMs = (uint32_t)strtoul(value, nullptr, 0);
+        } else if(strcmp(arg, "--script") == 0) {
+            if(!readScript(value, config.script)) {
+                return 1;
+            }
+        } else {
+            usage();
+        }
+    }
+    config.durationMs = (uint64_t)(days * 86400000.0);
+    config.pumps.faultStartMs = (uint64_t)(faultDay * 86400000.0);
+
+    std::map<std::string, uint64_t> counts;
+    FirmwareSimulator simulator(config);
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+    if(sheet && !quiet) {
+        printf("%s\n", WSM_SHEET_HEADER);
+    }
+    simulator.run([&](const ParticleHost::PublishRecord &record) {
+        counts[record.name]++;
+        if(quiet) {
+            return;
+        }
+        if(sheet) {
+            if(record.name.compare(0, 8, "wsmEvent") == 0) {
+                printf("%s\n", sheetRow(record).c_str());
+            }
+        } else if(all || record.name.compare(0, 3, "wsm") == 0) {
+            printf("%lld\t%s\t%s\n", (long long)record.unixTime, record.name.c_str(), record.data.c_str());
+        }
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    fprintf(stderr, "simulated %.1f days in %.3f s (%.0fx real time): %llu loop passes, %llu pin edges\n",
+            days, seconds, seconds > 0 ? days * 86400.0 / seconds : 0.0,
+            (unsigned long long)simulator.loopCount(), (unsigned long long)simulator.edgeCount());
+    uint64_t events = simulator.eventCount();
+    fprintf(stderr, "%llu Particle.publish calls (%.1f per hour, at most %llu in an hour, %.0f data bytes a day), "
+            "%llu refused; %llu events, %llu dropped (%.2f%%)\n",
+            (unsigned long long)simulator.publishCount(), days > 0 ? simulator.publishCount() / (days * 24.0) : 0.0,
+            (unsigned long long)simulator.peakPublishesPerHour(), days > 0 ? simulator.publishedBytes() / days : 0.0,
+            (unsigned long long)simulator.publishesRejected(),
+            (unsigned long long)events, (unsigned long long)simulator.eventsDropped(),
+            events ? 100.0 * simulator.eventsDropped() / events : 0.0);
+    for(const auto &count : counts) {
+        fprintf(stderr, "  %-24s %llu\n", count.first.c_str(), (unsigned long long)count.second);
+    }
+    return 0;
+}
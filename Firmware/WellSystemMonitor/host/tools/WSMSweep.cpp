@@ -0,0 +1,162 @@
+/***************************************************************************************************/
+// WSMSweep.cpp
+//  Sweeps a grid of WSMAlertProcessor limits over recorded WSM event logs (CSV exports of the
+//  Google sheet, or wsm_simulator --sheet output) on all cores and prints the best combinations
+//  (sweep/ThresholdSweep.h), one line per combination:
+//      <rank> detected missed false alerts distance(h) ppShort ppLong wpShort wpLong wpSoon wpLate oneDay threeDays
+//  A summary is written to stderr.
+//
+//  usage: wsm_sweep [LIMIT SPEC]... [--incidents FILE] [--window-hours N] [--threads N] [--top N]
+//                   [--scalar] FILE...
+//
+//  limits: --pp-short, --pp-long, --wp-short, --wp-long, --wp-soon, --wp-late (minutes),
+//          --one-day, --three-days (half hour ticks)
+//  spec:   a single value "0.3", a list "0.2,0.3,0.4" or a range "0.1:0.6:0.05" (from:to:step)
+//  Limits that are not given stay at their defaults.  The incidents file has one labelled
+//  incident per line, "<etime> [wsmAlert name]"; without a name any alert detects it.  --scalar
+//  runs one WSMAlertProcessor per combination instead of SWEEP_LANES combinations per
+//  LaneAlertProcessor; the results are the same.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "ThresholdSweep.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static void usage() {
+    fprintf(stderr,
+            "usage: wsm_sweep [LIMIT SPEC]... [--incidents FILE] [--window-hours N] [--threads N] [--top N]\n"
+            "                 [--scalar] FILE...\n"
+            "limits: --pp-short --pp-long --wp-short --wp-long --wp-soon --wp-late (minutes)\n"
+            "        --one-day --three-days (half hour ticks)\n"
+            "spec: 0.3 | 0.2,0.3,0.4 | 0.1:0.6:0.05\n");
+    exit(2);
+}
+
+// parse a value, list or from:to:step range
+template<typename T> static bool parseSpec(const char *spec, std::vector<T> &values) {
+    values.clear();
+    double from, to, step;
+    char extra;
+    if(sscanf(spec, "%lf:%lf:%lf%c", &from, &to, &step, &extra) == 3) {
+        if(step <= 0.0 || to < from) {
+            return false;
+        }
+        // count the steps so rounding does not drop the last value
+        long long steps = (long long)((to - from) / step + 1e-6);
+        for(long long i = 0; i <= steps; i++) {
+            values.push_back((T)(from + i * step));
+        }
+        return true;
+    }
+    const char *p = spec;
+    while(*p != '\0') {
+        char *end;
+        double value = strtod(p, &end);
+        if(end == p || (*end != ',' && *end != '\0')) {
+            return false;
+        }
+        values.push_back((T)value);
+        p = *end == ',' ? end + 1 : end;
+    }
+    return !values.empty();
+}
+
+int main(int argc, char *argv[]) {
+    SweepGrid grid;
+    ThresholdSweep sweep;
+    const char *incidentsPath = nullptr;
+    int numThreads = 0;
+    int top = 20;
+    std::vector<const char *> paths;
+
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if(arg[0] != '-' || arg[1] == '\0') {
+            paths.push_back(arg);
+            continue;
+        } else if(strcmp(arg, "--scalar") == 0) {
+            sweep.setScalar(true);
+            continue;
+        }
+        if(i + 1 >= argc) {
+            usage();
+        }
+        const char *value = argv[++i];
+        bool ok = true;
+        if(strcmp(arg, "--pp-short") == 0) {
+            ok = parseSpec(value, grid.ppOnTooShort);
+        } else if(strcmp(arg, "--pp-long") == 0) {
+            ok = parseSpec(value, grid.ppOnTooLong);
+        } else if(strcmp(arg, "--wp-short") == 0) {
+            ok = parseSpec(value, grid.wpOnTooShort);
+        } else if(strcmp(arg, "--wp-long") == 0) {
+            ok = parseSpec(value, grid.wpOnTooLong);
+        } else if(strcmp(arg, "--wp-soon") == 0) {
+            ok = parseSpec(value, grid.wpRunTooSoon);
+        } else if(strcmp(arg, "--wp-late") == 0) {
+            ok = parseSpec(value, grid.wpRunTooLong);
+        } else if(strcmp(arg, "--one-day") == 0) {
+            ok = parseSpec(value, grid.oneDay);
+        } else if(strcmp(arg, "--three-days") == 0) {
+            ok = parseSpec(value, grid.threeDays);
+        } else if(strcmp(arg, "--incidents") == 0) {
+            incidentsPath = value;
+        } else if(strcmp(arg, "--window-hours") == 0) {
+            sweep.setMatchWindow((int64_t)(atof(value) * 3600.0));
+        } else if(strcmp(arg, "--threads") == 0) {
+            numThreads = atoi(value);
+        } else if(strcmp(arg, "--top") == 0) {
+            top = atoi(value);
+        } else {
+            usage();
+        }
+        if(!ok) {
+            fprintf(stderr, "bad value for %s: %s\n", arg, value);
+            usage();
+        }
+    }
+    if(paths.empty()) {
+        usage();
+    }
+
+    for(const char *path : paths) {
+        WSMDataReader reader;
+        if(!reader.open(path)) {
+            fprintf(stderr, "can't open %s\n", path);
+            return 1;
+        }
+        sweep.load(reader);
+    }
+    if(incidentsPath != nullptr && !sweep.loadIncidents(incidentsPath)) {
+        fprintf(stderr, "can't open %s\n", incidentsPath);
+        return 1;
+    }
+
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    std::vector<SweepResult> results = sweep.run(grid, numThreads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    printf("# rank detected missed false alerts distance(h) ppShort ppLong wpShort wpLong wpSoon wpLate oneDay threeDays\n");
+    for(size_t i = 0; i < results.size() && (int)i < top; i++) {
+        const SweepResult &r = results[i];
+        printf("%zu %u %u %u %u %.1f %g %g %g %g %g %g %u %u\n", i + 1, r.detected, r.missed, r.falseAlerts,
+               r.alerts, r.distance / 3600.0, r.limits.ppOnTooShort, r.limits.ppOnTooLong, r.limits.wpOnTooShort,
+               r.limits.wpOnTooLong, r.limits.wpRunTooSoon, r.limits.wpRunTooLong, r.limits.oneDay,
+               r.limits.threeDays);
+    }
+
+    fprintf(stderr, "%zu events, %zu incidents, %zu combinations in %.3f s (%.0f combinations/s, "
+            "%.0f million events/s, %llu steals)\n",
+            sweep.events().size(), sweep.incidents().size(), results.size(), seconds,
+            seconds > 0 ? results.size() / seconds : 0.0,
+            seconds > 0 ? results.size() * (double)sweep.events().size() / seconds / 1e6 : 0.0,
+            (unsigned long long)sweep.steals());
+    return 0;
+}
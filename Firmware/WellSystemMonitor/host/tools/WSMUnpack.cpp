@@ -0,0 +1,178 @@
+/***************************************************************************************************/
+// WSMUnpack.cpp
+//  Expands wsmEventPack publications (src/WSMEventPack.h) back into the JSON events the sheet and
+//  the other tools know, with the reference decoder (uplink/WSMPackDecoder.h).  Each input line is
+//  one publication, either
+//
+//      a pack payload on its own:                  AWAB...
+//      a line of "particle subscribe" output:      {"name":"wsmEventPack","data":"AWAB...",...}
+//      a wsm_simulator style line:                 <time> <tab> <event name> <tab> <event data>
+//
+//  and each event is written as <etime> <tab> <event name> <tab> <event data>, or with --sheet as
+//  the CSV row the wsmWriteData script appends.  wsmEventBatch publications are split and other
+//  publications are passed through.  --stats writes the packed and JSON sizes to stderr.
+//
+//  usage: wsm_unpack [--sheet] [--stats] [FILE]...     (no FILE, or "-", reads stdin)
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMEventPack.h"
+#include "WSMPackDecoder.h"
+#include "WSMWebhook.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct UnpackStats {
+    uint64_t packs = 0;
+    uint64_t packedBytes = 0;   // pack payloads, as published
+    uint64_t events = 0;
+    uint64_t jsonBytes = 0;     // data of the events, as published one by one
+    uint64_t errors = 0;
+};
+
+// a quoted string value in a flat JSON object; empty if the key is missing
+static std::string jsonString(const std::string &json, const char *key) {
+    std::string pattern = std::string("\"") + key + "\":\"";
+    size_t pos = json.find(pattern);
+    if(pos == std::string::npos) {
+        return "";
+    }
+    pos += pattern.size();
+    std::string value;
+    for(; pos < json.size() && json[pos] != '"'; pos++) {
+        if(json[pos] == '\\' && pos + 1 < json.size()) {
+            pos++;
+        }
+        value += json[pos];
+    }
+    return value;
+}
+
+// the publication on one input line; false if there is none
+static bool parseLine(const std::string &line, ParticleHost::PublishRecord &record) {
+    record = ParticleHost::PublishRecord();
+    if(line.empty()) {
+        return false;
+    }
+    if(line[0] == '{') {
+        record.name = jsonString(line, "name");
+        record.data = jsonString(line, "data");
+        return !record.name.empty();
+    }
+    size_t tab = line.find('\t');
+    if(tab != std::string::npos) {
+        size_t second = line.find('\t', tab + 1);
+        if(second == std::string::npos) {
+            return false;
+        }
+        record.unixTime = (time_t)strtoll(line.c_str(), nullptr, 10);
+        record.name = line.substr(tab + 1, second - tab - 1);
+        record.data = line.substr(second + 1);
+        return true;
+    }
+    record.name = EVENT_PACK_NAME;
+    record.data = line;
+    return true;
+}
+
+static void unpack(FILE *file, const char *path, bool sheet, UnpackStats &stats) {
+    ParticleHost::PublishSink write = [&](const ParticleHost::PublishRecord &event) {
+        stats.events++;
+        stats.jsonBytes += event.data.size();
+        if(sheet) {
+            if(event.name.compare(0, 8, "wsmEvent") == 0) {
+                printf("%s\n", sheetRow(event).c_str());
+            }
+        } else {
+            printf("%lld\t%s\t%s\n", (long long)event.unixTime, event.name.c_str(), event.data.c_str());
+        }
+    };
+
+    WSMPackDecoder decoder;
+    std::string line;
+    uint64_t lineNumber = 0;
+    int c;
+    do {
+        c = fgetc(file);
+        if(c != '\n' && c != EOF) {
+            if(c != '\r') {
+                line += (char)c;
+            }
+            continue;
+        }
+        lineNumber++;
+        ParticleHost::PublishRecord record;
+        if(parseLine(line, record)) {
+            if(record.name == EVENT_PACK_NAME) {
+                stats.packs++;
+                stats.packedBytes += record.data.size();
+                if(!decoder.decode(record.data.c_str())) {
+                    fprintf(stderr, "%s:%llu: %s\n", path, (unsigned long long)lineNumber, decoder.error());
+                    stats.errors++;
+                }
+                for(const WSMPackedEvent &packed : decoder.events()) {
+                    ParticleHost::PublishRecord event;
+                    event.name = packed.name;
+                    event.data = packed.data;
+                    event.unixTime = (time_t)packed.record.etime;
+                    write(event);
+                }
+            } else {
+                expandBatch(record, write);
+            }
+        }
+        line.clear();
+    } while(c != EOF);
+}
+
+int main(int argc, char *argv[]) {
+    bool sheet = false;
+    bool showStats = false;
+    std::vector<const char *> paths;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--sheet") == 0) {
+            sheet = true;
+        } else if(strcmp(argv[i], "--stats") == 0) {
+            showStats = true;
+        } else if(argv[i][0] == '-' && argv[i][1] != '\0') {
+            fprintf(stderr, "usage: wsm_unpack [--sheet] [--stats] [FILE]...\n");
+            return 2;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if(paths.empty()) {
+        paths.push_back("-");
+    }
+
+    UnpackStats stats;
+    if(sheet) {
+        printf("%s\n", WSM_SHEET_HEADER);
+    }
+    for(const char *path : paths) {
+        bool useStdin = strcmp(path, "-") == 0;
+        FILE *file = useStdin ? stdin : fopen(path, "r");
+        if(file == nullptr) {
+            fprintf(stderr, "can't open %s\n", path);
+            return 1;
+        }
+        unpack(file, useStdin ? "stdin" : path, sheet, stats);
+        if(!useStdin) {
+            fclose(file);
+        }
+    }
+
+    if(showStats) {
+        fprintf(stderr, "%llu packs, %llu bytes; %llu events, %llu bytes as JSON (%.1fx)\n",
+                (unsigned long long)stats.packs, (unsigned long long)stats.packedBytes,
+                (unsigned long long)stats.events, (unsigned long long)stats.jsonBytes,
+                stats.packedBytes ? (double)stats.jsonBytes / stats.packedBytes : 0.0);
+    }
+    return stats.errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/***************************************************************************************************/
+// WSMPackDecoder.cpp
+//  Decodes wsmEventPack publications.  See WSMPackDecoder.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMPackDecoder.h"
+#include "JSONWriter.h"
+#include "WSMEventPack.h"
+
+namespace {
+
+    // the 6 bit value of a base64 character, or -1
+    int base64Value(char c) {
+        if(c >= 'A' && c <= 'Z') {
+            return c - 'A';
+        } else if(c >= 'a' && c <= 'z') {
+            return c - 'a' + 26;
+        } else if(c >= '0' && c <= '9') {
+            return c - '0' + 52;
+        } else if(c == '+') {
+            return 62;
+        } else if(c == '/') {
+            return 63;
+        }
+        return -1;
+    }
+
+    int32_t unzigzag(uint32_t value) {
+        return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+    }
+
+}   // namespace
+
+bool WSMPackDecoder::decode(const char *payload) {
+    _bytes.clear();
+    _events.clear();
+    _version = 0;
+    _zone = 0.0f;
+    _error = "";
+
+    // base64, with or without padding
+    uint32_t group = 0;
+    int bits = 0;
+    const char *p = payload;
+    for(; *p != '\0' && *p != '='; p++) {
+        int value = base64Value(*p);
+        if(value < 0) {
+            return fail("not base64");
+        }
+        group = (group << 6) | (uint32_t)value;
+        bits += 6;
+        if(bits >= 8) {
+            bits -= 8;
+            _bytes.push_back((uint8_t)(group >> bits));
+        }
+    }
+    for(; *p == '='; p++) {
+    }
+    if(*p != '\0' || bits >= 6) {
+        return fail("not base64");
+    }
+
+    if(_bytes.size() < 2) {
+        return fail("cut short");
+    }
+    _version = _bytes[0];
+    if(_version != EVENT_PACK_VERSION) {
+        return fail("unknown version");
+    }
+    _zone = (int8_t)_bytes[1] / 4.0f;
+
+    size_t pos = 2;
+    uint32_t etime = 0;
+    while(pos < _bytes.size()) {
+        WSMPackedEvent event;
+        WSMJournalRecord &record = event.record;
+        uint8_t kind = _bytes[pos++];
+        record.kind = kind & ~EVENT_PACK_ALERT;
+        record.alert = (kind & EVENT_PACK_ALERT) != 0;
+        record.value1 = 0.0f;
+        record.value2 = 0.0f;
+        if(record.kind < JOURNAL_TRH || record.kind > JOURNAL_WP_OFF) {
+            return fail("unknown event");
+        }
+
+        uint32_t delta, value1 = 0, value2 = 0;
+        if(!varint(pos, delta)) {
+            return fail("cut short");
+        }
+        etime += (uint32_t)unzigzag(delta);
+        record.etime = etime;
+        switch(record.kind) {
+            case JOURNAL_TRH:
+                if(!varint(pos, value1) || !varint(pos, value2)) {
+                    return fail("cut short");
+                }
+                record.value1 = unzigzag(value1) / 100.0f;
+                record.value2 = unzigzag(value2) / 100.0f;
+                break;
+            case JOURNAL_PP_OFF:
+                if(!varint(pos, value1)) {
+                    return fail("cut short");
+                }
+                record.value1 = (float)value1 / 60000.0;    // as publishPPchange() works it out
+                break;
+            case JOURNAL_WP_OFF:
+                if(!varint(pos, value1)) {
+                    return fail("cut short");
+                }
+                record.value1 = (float)value1 / 60000;      // as publishWPchange() works it out
+                break;
+            default:
+                break;
+        }
+
+        char json[JSON_EVENT_SIZE];
+        event.name = WSMEventPack::eventJSON(record, _zone, json, sizeof(json));
+        event.data = json;
+        _events.push_back(event);
+    }
+    return true;
+}   // end of decode()
+
+// Private methods
+
+bool WSMPackDecoder::fail(const char *error) {
+    _error = error;
+    return false;
+}   // end of fail()
+
+bool WSMPackDecoder::varint(size_t &pos, uint32_t &value) const {
+    value = 0;
+    for(int shift = 0; shift < 35; shift += 7) {
+        if(pos >= _bytes.size()) {
+            return false;
+        }
+        uint8_t byte = _bytes[pos++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;   // longer than 32 bits
+}   // end of varint()
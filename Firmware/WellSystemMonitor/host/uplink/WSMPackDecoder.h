@@ -0,0 +1,51 @@
+#ifndef WSMPACKDECODER_H_INCLUDE
+#define WSMPACKDECODER_H_INCLUDE
+/***************************************************************************************************/
+// WSMPackDecoder.h
+//  Reference decoder for the wsmEventPack uplink encoding (src/WSMEventPack.h): turns a pack back
+//  into its events, as the journal records the sketch packed and as the JSON publications the
+//  events would have been on their own, byte for byte as the sketch wrote them before packing
+//  (run times are exact below about two hours; temperatures and humidities are kept to 0.01).
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "WSMEventJournal.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct WSMPackedEvent {
+    WSMJournalRecord record;
+    const char *name;       // wsmEventTRH, wsmEventPPstatus or wsmEventWPstatus
+    std::string data;       // the JSON the event was published with before packing
+};
+
+class WSMPackDecoder {
+    public:
+        // decode a base64 pack, replacing the events of the last one.  Returns false if the pack is
+        // not valid base64, is of an unknown version or is cut short; the events before the fault
+        // are kept.
+        bool decode(const char *payload);
+
+        const std::vector<WSMPackedEvent> &events() const { return _events; }
+        int version() const { return _version; }
+        float zone() const { return _zone; }                // time zone of the pack, in hours
+        size_t packedSize() const { return _bytes.size(); } // bytes after base64 decoding
+        const char *error() const { return _error; }        // why decode() failed
+
+    private:
+        bool fail(const char *error);
+        bool varint(size_t &pos, uint32_t &value) const;
+
+        std::vector<uint8_t> _bytes;
+        std::vector<WSMPackedEvent> _events;
+        int _version = 0;
+        float _zone = 0.0f;
+        const char *_error = "";
+};
+
+#endif  // end of header duplication prevention
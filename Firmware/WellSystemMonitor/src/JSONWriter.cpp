@@ -0,0 +1,246 @@
+/***************************************************************************************************/
+// JSONWriter.cpp
+//  Fixed buffer JSON object writer.  See JSONWriter.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <JSONWriter.h>
+#include <math.h>
+#include <string.h>
+
+// write an unsigned value in decimal at the end of digits[], return the first digit
+static char *formatUnsigned(char *end, uint64_t value) {
+    char *p = end;
+    do {
+        *--p = (char)('0' + value % 10);
+        value /= 10;
+    } while(value != 0);
+    return p;
+}
+
+JSONWriter::JSONWriter(char *buffer, size_t size) :
+    _buffer(buffer), _size(size), _length(0), _pending(0), _started(false), _overflow(false) {
+    if(_size > 0) {
+        _buffer[0] = '\0';
+    }
+}
+
+// append text to the element being written; false if it does not fit with the closing brace
+bool JSONWriter::append(const char *text, size_t length) {
+    if(_pending + length + 2 > _size) {     // leave room for '}' and the terminator
+        _overflow = true;
+        return false;
+    }
+    memcpy(_buffer + _pending, text, length);
+    _pending += length;
+    return true;
+}
+
+bool JSONWriter::appendEscaped(const char *text) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    for(const char *p = text; *p != '\0'; p++) {
+        unsigned char c = (unsigned char)*p;
+        char escaped[6] = {'\\', 0, 0, 0, 0, 0};
+        size_t length = 2;
+        switch(c) {
+            case '"':  escaped[1] = '"'; break;
+            case '\\': escaped[1] = '\\'; break;
+            case '\n': escaped[1] = 'n'; break;
+            case '\r': escaped[1] = 'r'; break;
+            case '\t': escaped[1] = 't'; break;
+            default:
+                if(c >= 0x20) {
+                    if(!append(p, 1)) {
+                        return false;
+                    }
+                    continue;
+                }
+                escaped[1] = 'u';
+                escaped[2] = '0';
+                escaped[3] = '0';
+                escaped[4] = HEX_DIGITS[c >> 4];
+                escaped[5] = HEX_DIGITS[c & 0x0f];
+                length = 6;
+                break;
+        }
+        if(!append(escaped, length)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// start an element with its separator and "name":
+bool JSONWriter::beginElement(const char *name) {
+    _pending = _length;
+    if(_overflow) {
+        return false;   // once an element is dropped, later ones are too, so none are out of order
+    }
+    return append(_started ? "," : "{", 1) && append("\"", 1) && appendEscaped(name) && append("\":", 2);
+}
+
+void JSONWriter::commit() {
+    _length = _pending;
+    _started = true;
+    _buffer[_length] = '\0';
+}
+
+void JSONWriter::rollback() {
+    _pending = _length;
+    if(_size > 0) {
+        _buffer[_length] = '\0';
+    }
+}
+
+void JSONWriter::key(const char *name, int value) {
+    char digits[12];
+    char *first = formatUnsigned(digits + sizeof(digits), value < 0 ? 0U - (unsigned int)value : (unsigned int)value);
+    if(value < 0) {
+        *--first = '-';
+    }
+    if(beginElement(name) && append(first, digits + sizeof(digits) - first)) {
+        commit();
+    } else {
+        rollback();
+    }
+}
+
+void JSONWriter::key(const char *name, unsigned int value) {
+    char digits[12];
+    char *first = formatUnsigned(digits + sizeof(digits), value);
+    if(beginElement(name) && append(first, digits + sizeof(digits) - first)) {
+        commit();
+    } else {
+        rollback();
+    }
+}
+
+void JSONWriter::key(const char *name, time_t value) {
+    char digits[24];
+    uint64_t magnitude = value < 0 ? 0ULL - (uint64_t)value : (uint64_t)value;
+    char *first = formatUnsigned(digits + sizeof(digits), magnitude);
+    if(value < 0) {
+        *--first = '-';
+    }
+    if(beginElement(name) && append(first, digits + sizeof(digits) - first)) {
+        commit();
+    } else {
+        rollback();
+    }
+}
+
+void JSONWriter::key(const char *name, float value, int decimals) {
+    char number[48];
+    size_t length = formatFloat(number, sizeof(number), value, decimals);
+    if(length > 0 && beginElement(name) && append(number, length)) {
+        commit();
+    } else {
+        if(length == 0) {
+            _overflow = true;
+        }
+        rollback();
+    }
+}
+
+void JSONWriter::key(const char *name, const char *value) {
+    if(beginElement(name) && append("\"", 1) && appendEscaped(value) && append("\"", 1)) {
+        commit();
+    } else {
+        rollback();
+    }
+}
+
+void JSONWriter::end() {
+    if(_size < 3) {
+        _overflow = true;
+        return;
+    }
+    if(!_started) {
+        _buffer[_length++] = '{';   // an empty object
+    }
+    _buffer[_length++] = '}';       // append() always leaves room for this
+    _buffer[_length] = '\0';
+    _pending = _length;
+    _started = true;
+    _overflow = _overflow || _length + 1 > _size;
+}
+
+// The float is exact in a double, and so is the float times 10^decimals for up to 9 decimals
+// (24 + 21 bits), so rounding that product to an integer rounds the decimal expansion of the float
+// exactly as printf("%.*f") does, ties to even.  Larger values fall back to snprintf.
+size_t JSONWriter::formatFloat(char *buffer, size_t size, float value, int decimals) {
+    static const double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    if(decimals < 0) {
+        decimals = 0;
+    } else if(decimals > 9) {
+        decimals = 9;
+    }
+
+    double scaled = fabs((double)value) * POWERS_OF_TEN[decimals];
+    if(!(scaled < 9.0e15)) {    // too big for exact integer arithmetic, or not a number
+        int n = snprintf(buffer, size, "%.*f", decimals, (double)value);
+        return n > 0 && (size_t)n < size ? (size_t)n : 0;
+    }
+
+    uint64_t digits = (uint64_t)nearbyint(scaled);
+    uint64_t divisor = (uint64_t)POWERS_OF_TEN[decimals];
+    char text[32];
+    char *end = text + sizeof(text);
+    char *p = end;
+    if(decimals > 0) {
+        uint64_t fraction = digits % divisor;
+        for(int i = 0; i < decimals; i++) {
+            *--p = (char)('0' + fraction % 10);
+            fraction /= 10;
+        }
+        *--p = '.';
+    }
+    p = formatUnsigned(p, digits / divisor);
+    if(signbit(value)) {
+        *--p = '-';     // printf keeps the sign of a negative value that rounds to zero
+    }
+
+    size_t length = end - p;
+    if(length + 1 > size) {
+        return 0;
+    }
+    memcpy(buffer, p, length);
+    buffer[length] = '\0';
+    return length;
+}
+
+// civil date from days since 1970-01-01 (H. Hinnant's algorithm), good for any time_t
+void JSONWriter::formatTime(char *buffer, time_t time) {
+    int64_t days = time / 86400;
+    int64_t seconds = time % 86400;
+    if(seconds < 0) {
+        seconds += 86400;
+        days--;
+    }
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned int dayOfEra = (unsigned int)(days - era * 146097);
+    unsigned int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned int monthIndex = (5 * dayOfYear + 2) / 153;
+    unsigned int day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    unsigned int month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    int64_t year = (int64_t)yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+    unsigned int fields[] = {(unsigned int)(year % 10000), month, day, (unsigned int)(seconds / 3600),
+                             (unsigned int)(seconds / 60 % 60), (unsigned int)(seconds % 60)};
+    const char separators[] = {'-', '-', ' ', ':', ':', '\0'};
+    char *p = buffer;
+    for(int i = 0; i < 6; i++) {
+        if(i == 0) {
+            *p++ = (char)('0' + fields[0] / 1000);
+            *p++ = (char)('0' + fields[0] / 100 % 10);
+        }
+        *p++ = (char)('0' + fields[i] / 10 % 10);
+        *p++ = (char)('0' + fields[i] % 10);
+        *p++ = separators[i];
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef JSONWRITER_H_INCLUDE
+#define JSONWRITER_H_INCLUDE
+/***************************************************************************************************/
+// JSONWriter.h
+//  Builds a flat JSON object in a fixed size buffer supplied by the caller (usually a local char
+//  array), without using String or the heap:
+//
+//      char eData[JSON_EVENT_SIZE];
+//      JSONWriter json(eData, sizeof(eData));
+//      json.key("etime", Time.now());
+//      json.key("temp", temp, 6);
+//      json.end();
+//      if(!json.overflow()) Particle.publish("wsmEventTRH", eData, PRIVATE);
+//
+//  The output is byte for byte what the String concatenation it replaces produced: floats are
+//  written with a fixed number of decimals, like String(float, decimals).  String values are
+//  escaped.  If an element does not fit, it is dropped, overflow() is set and the buffer is left
+//  holding the elements that did fit.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+
+// big enough for any of the WSM event and alert payloads
+const size_t JSON_EVENT_SIZE = 128;
+
+// "YYYY-MM-DD hh:mm:ss" and the terminating null
+const size_t TIME_STRING_SIZE = 20;
+
+class JSONWriter {
+    public:
+        // the buffer must stay valid while the writer is used; it always holds a terminated string
+        JSONWriter(char *buffer, size_t size);
+
+        // "name":value elements; the opening brace is written before the first one
+        void key(const char *name, int value);
+        void key(const char *name, unsigned int value);
+        void key(const char *name, time_t value);
+        void key(const char *name, float value, int decimals);    // as String(value, decimals)
+        void key(const char *name, const char *value);            // a quoted, escaped string
+
+        // close the object; an object with no elements is written as {}
+        void end();
+
+        bool overflow() const { return _overflow; }
+        size_t length() const { return _length; }
+        const char *c_str() const { return _buffer; }
+
+        // write value with a fixed number of decimals (0 to 9) into buffer, as String(value, decimals)
+        // does, and terminate it; returns the length, or 0 if it did not fit
+        static size_t formatFloat(char *buffer, size_t size, float value, int decimals);
+
+        // write a time as Time.format(time, "%F %T") does, with no time zone applied; use
+        // Time.local() for local time.  buffer must hold TIME_STRING_SIZE characters.
+        static void formatTime(char *buffer, time_t time);
+
+    private:
+        bool beginElement(const char *name);
+        bool append(const char *text, size_t length);
+        bool appendEscaped(const char *text);
+        void commit();
+        void rollback();
+
+        char *_buffer;
+        size_t _size;
+        size_t _length;     // committed length
+        size_t _pending;    // length including the element being written
+        bool _started;
+        bool _overflow;
+};
+
+#endif  // end of header duplication prevention
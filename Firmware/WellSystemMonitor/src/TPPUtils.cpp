@@ -11,6 +11,7 @@
 /***************************************************************************************************/
 #include <TPPUtils.h>
 #include <WSMGlobals.h>
+#include <JSONWriter.h>
 
 /*************************************** parser() **********************************************/
 // parser(): parse a comma delimited string into its individual substrings.
@@ -60,7 +61,7 @@ int parser(String source)
 //  Return:  true if function is ready to be triggered again, otherwise false
 //
 
-boolean nbBlink(byte numBlinks, unsigned long blinkTime)
+boolean nbBlink(byte numBlinks, system_tick_t blinkTime)
 {
 	const byte READY = 0;
 	const byte LED_ON = 1;
@@ -69,8 +70,8 @@ boolean nbBlink(byte numBlinks, unsigned long blinkTime)
 
 
 	static byte state = READY;
-	static unsigned long lastTime;
-	static unsigned long newTime;
+	static system_tick_t lastTime;
+	static system_tick_t newTime;
 	static byte blinks;
 
 	newTime = millis();
@@ -136,28 +137,54 @@ boolean nbBlink(byte numBlinks, unsigned long blinkTime)
 //      String value -  the "value"
 // return
 //      a string of the format "name":"value" for use in making JSON
+//
+// These build the pair with a JSONWriter on the stack, so the only heap allocation is the String
+// returned.  New code should write whole objects with JSONWriter instead.
+
+// the single element of the object that writer has written into json, without the braces
+static String nameValuePair(char *json, JSONWriter &writer)
+{
+	writer.end();
+	if(writer.overflow() || writer.length() < 2)
+	{
+		return String("");
+	}
+	json[writer.length() - 1] = '\0';	// drop the closing brace
+	return String(json + 1);
+}
+
 String makeNameValuePair(String name, String value)
 {
-	String nameValuePair = "";
-	nameValuePair += DOUBLEQ + name + DOUBLEQ;
-	nameValuePair += ":";
-	nameValuePair += DOUBLEQ + value + DOUBLEQ;
-	return nameValuePair;
+	char json[JSON_EVENT_SIZE];
+	JSONWriter writer(json, sizeof(json));
+	writer.key(name.c_str(), value.c_str());
+	return nameValuePair(json, writer);
 }
-String makeNameValuePairLong(String name, long value)
+String makeNameValuePairLong(String name, int32_t value)
 {
-	String nameValuePair = "";
-	nameValuePair += DOUBLEQ + name + DOUBLEQ;
-	nameValuePair += ":";
-	nameValuePair += String(value);
-	return nameValuePair;
+	char json[JSON_EVENT_SIZE];
+	JSONWriter writer(json, sizeof(json));
+	writer.key(name.c_str(), (int)value);
+	return nameValuePair(json, writer);
 }
 String makeNameValuePairFloat(String name, float value)
 {
-	String nameValuePair = "";
-	nameValuePair += DOUBLEQ + name + DOUBLEQ;
-	nameValuePair += ":";
-	nameValuePair += String(value,2);
-	return nameValuePair;
+	char json[JSON_EVENT_SIZE];
+	JSONWriter writer(json, sizeof(json));
+	writer.key(name.c_str(), value, 2);
+	return nameValuePair(json, writer);
 }
 /*********************************** end of makeNameValuePair() ********************************************/
+
+/*************************************** crc16() ***********************************************/
+// crc16(): CRC-16/CCITT of the EEPROM records (WSMEventJournal, WSMStateStore)
+uint16_t crc16(uint16_t crc, const uint8_t *data, size_t length) {
+    for(size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for(int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+/*********************************** end of crc16() ********************************************/
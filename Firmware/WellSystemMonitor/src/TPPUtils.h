@@ -19,11 +19,14 @@
 int parser(String source);
 
 // blink the D7 LED without blocking
-boolean nbBlink(byte numBlinks, unsigned long blinkTime);
+boolean nbBlink(byte numBlinks, system_tick_t blinkTime);
 
 // make a JSON element of "name":"value"
 String makeNameValuePair(String name, String value);
-String makeNameValuePairLong(String name, long value);
+String makeNameValuePairLong(String name, int32_t value);
 String makeNameValuePairFloat(String name, float value);
 
+// CRC-16/CCITT (polynomial 0x1021) of length bytes, continuing from crc; start with 0xFFFF
+uint16_t crc16(uint16_t crc, const uint8_t *data, size_t length);
+
 #endif  // end of header duplication prevention
@@ -9,15 +9,161 @@
  * version 1.0: 8/1/2022.  Initial release
  * version 1.1: 8/5/2022.  Fixed up published string format
  * version 1.2: 8/9/2022.  Completed unit testing and verified all alerts and holdoffs appear to work.
+ * 2026: Alert payloads are built with JSONWriter on the stack instead of by String concatenation.
+ * 2026: Counts the alerts published (get_alertCount()) so the sketch can publish its pending
+ *  events as soon as an alert goes out.
+ * 2026: Adaptive deviation alerts #8 and #9 against learned baselines (WSMBaseline).
+ * 2026: Alerts #1 to #7 are rules in a table, evaluated by evaluate() and published through
+ *  publishAlert(), in place of a branch, a holdoff variable and a publish method each.
+ * 2026: Short cycling alert #10 from the PP cycles counted over 10 minutes and an hour.
+ * 2026: The alert state can be kept in EEPROM (WSMStateStore) and restored by begin().
+ * 2026: The alerts can be published through a WSMPublishQueue (publishVia()).
  * 
  *******************************************************************************/
 #include <WSMAlertProcessor.h>
+#include <JSONWriter.h>
+#include <TPPUtils.h>
+#include <math.h>
+#include <string.h>
+
+// publishAlert(): build {"etime":<now>,"msg":"<before><value><after>"} on the stack and publish it,
+//  through queue if there is one.  The fixed alerts write the value with 6 decimals, as
+//  String(float) does; pass a null before to leave it out.
+static void publishAlert(WSMPublishQueue *queue, const char *eventName, const char *before, float value,
+                         unsigned int decimals, const char *after) {
+    char msg[JSON_EVENT_SIZE];
+    size_t length = 0;
+    msg[0] = '\0';
+    if(before != NULL) {
+        length = strlen(before);
+        memcpy(msg, before, length);
+        length += JSONWriter::formatFloat(msg + length, sizeof(msg) - length, value, decimals);
+    }
+    size_t afterLength = strlen(after);
+    if(length + afterLength < sizeof(msg)) {
+        memcpy(msg + length, after, afterLength + 1);
+    }
+
+    char eData[JSON_EVENT_SIZE];
+    JSONWriter json(eData, sizeof(eData));
+    json.key("etime", Time.now());
+    json.key("msg", msg);
+    json.end();
+    if(queue != NULL) {
+        queue->publish(eventName, eData);
+    } else {
+        Particle.publish(eventName, eData, PRIVATE);
+    }
+}
 
-// Constructor
-WSMAlertProcessor::WSMAlertProcessor() {
+// the layout of WSMAlertState; change it when the layout changes, so that an old snapshot is not
+//  restored
+static const uint8_t ALERT_STATE_VERSION = 1;
+
+// Constructors
+WSMAlertProcessor::WSMAlertProcessor() : WSMAlertProcessor(WSMAlertLimits()) {
     // follow convention and put all initializations in begin() method   
 }   // end of Constructor
 
+WSMAlertProcessor::WSMAlertProcessor(const WSMAlertLimits &limits) :
+    PP_ON_TOO_SHORT_LIMIT(limits.ppOnTooShort),
+    PP_ON_TOO_LONG_LIMIT(limits.ppOnTooLong),
+    WP_ON_TOO_SHORT_LIMIT(limits.wpOnTooShort),
+    WP_ON_TOO_LONG_LIMIT(limits.wpOnTooLong),
+    WP_RUN_TOO_SOON_LIMIT(limits.wpRunTooSoon),
+    WP_RUN_TOO_LONG_LIMIT(limits.wpRunTooLong),
+    ONE_DAY(limits.oneDay),
+    THREE_DAYS(limits.threeDays),
+    DEVIATION_SIGMAS(limits.deviationSigmas),
+    _queue(NULL),
+    _restored(false) {
+    // the limits are fixed for the life of the object; all other initializations are in begin()
+
+    // the holdoffs of the fixed alerts
+    _holdoffCount = ALERT_FIXED_HOLDOFFS;
+    for(unsigned int i = 0; i < ALERT_FIXED_HOLDOFFS; i++) {
+        _holdoffLimits[i] = (uint16_t)ONE_DAY;
+    }
+    _holdoffLimits[ALERT_HOLDOFF_PP_NOT_RUN] = (uint16_t)THREE_DAYS;
+
+    // alerts #1 to #7, in the order the branches they replace tested them
+    const uint16_t oneDay = (uint16_t)ONE_DAY;
+    const WSMAlertRule FIXED_RULES[] = {
+        {"wsmAlertPPOnTooShort", ALERT_ON_PP_OFF, MEASURE_PP_RUN_TIME, ALERT_BELOW, PP_ON_TOO_SHORT_LIMIT,
+            oneDay, ALERT_HOLDOFF_PP, 0, 6, "PP on for ", " minutes."},                                        // #2
+        {"wsmAlertPPOnTooLong", ALERT_ON_PP_OFF, MEASURE_PP_RUN_TIME, ALERT_ABOVE, PP_ON_TOO_LONG_LIMIT,
+            oneDay, ALERT_HOLDOFF_PP, 1, 6, "PP on for ", " minutes."},                                        // #1
+        {"wsmAlertWPNotComeOn", ALERT_ON_PP_OFF, MEASURE_PP_ACCUMULATED, ALERT_AT_LEAST, WP_RUN_TOO_LONG_LIMIT,
+            oneDay, ALERT_HOLDOFF_INTER_PUMP, 2, 6, "WP did not come on after PP run for > ", " minutes."},    // #5
+        {"wsmAlertWPOnTooSoon", ALERT_ON_WP_ON, MEASURE_PP_ACCUMULATED, ALERT_BELOW, WP_RUN_TOO_SOON_LIMIT,
+            oneDay, ALERT_HOLDOFF_INTER_PUMP, 0, 6, "WP came on after PP run for only ", " minutes."},         // #6
+        {"wsmAlertWPOnTooShort", ALERT_ON_WP_OFF, MEASURE_WP_RUN_TIME, ALERT_BELOW, WP_ON_TOO_SHORT_LIMIT,
+            oneDay, ALERT_HOLDOFF_WP, 0, 6, "WP on for ", " minutes."},                                        // #4
+        {"wsmAlertWPOnTooLong", ALERT_ON_WP_OFF, MEASURE_WP_RUN_TIME, ALERT_ABOVE, WP_ON_TOO_LONG_LIMIT,
+            oneDay, ALERT_HOLDOFF_WP, 1, 6, "WP on for ", " minutes."},                                        // #3
+        {"wsmAlertPPNotRun", ALERT_ON_TICK, MEASURE_PP_IDLE_TICKS, ALERT_AT_LEAST, (float)ONE_DAY,
+            (uint16_t)THREE_DAYS, ALERT_HOLDOFF_PP_NOT_RUN, 0, 6, NULL, "PP did not run for at least the last day."}   // #7
+    };
+    _ruleCount = 0;
+    for(const WSMAlertRule &rule : FIXED_RULES) {
+        addRule(rule);
+    }
+
+    // alert #10, for the limits that are set; the two share a holdoff
+    if(limits.ppCycles10Minutes > 0) {
+        addRule({"wsmAlertPPShortCycling", ALERT_ON_PP_ON, MEASURE_PP_CYCLES_10_MINUTES, ALERT_ABOVE,
+                 (float)limits.ppCycles10Minutes, oneDay, ALERT_HOLDOFF_SHORT_CYCLE, 0, 0, "PP came on ", " times in 10 minutes."});
+    }
+    if(limits.ppCyclesHour > 0) {
+        addRule({"wsmAlertPPShortCycling", ALERT_ON_PP_ON, MEASURE_PP_CYCLES_LAST_HOUR, ALERT_ABOVE,
+                 (float)limits.ppCyclesHour, oneDay, ALERT_HOLDOFF_SHORT_CYCLE, 1, 0, "PP came on ", " times in an hour."});
+    }
+}   // end of Constructor
+
+// addRule(): insert a rule after the rules of its trigger with the same or a lower priority number
+bool WSMAlertProcessor::addRule(const WSMAlertRule &rule) {
+    if(_ruleCount >= ALERT_MAX_RULES || rule.eventName == NULL || rule.after == NULL ||
+       rule.trigger >= ALERT_TRIGGERS || rule.measure >= ALERT_MEASURES ||
+       rule.compare == 0 || rule.compare > (ALERT_BELOW | ALERT_EQUAL | ALERT_ABOVE)) {
+        return false;
+    }
+    unsigned int holdoff = rule.holdoff;
+    if(holdoff == ALERT_OWN_HOLDOFF) {
+        if(_holdoffCount >= ALERT_MAX_HOLDOFFS) {
+            return false;
+        }
+        holdoff = _holdoffCount++;
+        _holdoffLimits[holdoff] = 0;
+    } else if(holdoff >= _holdoffCount) {
+        return false;
+    }
+    if(rule.holdoffTicks > _holdoffLimits[holdoff]) {
+        _holdoffLimits[holdoff] = rule.holdoffTicks;
+    }
+    _holdoffs[holdoff] = _holdoffLimits[holdoff];   // so that its first alert will happen
+
+    unsigned int at = _ruleCount;
+    while(at > 0 && (_rules[at - 1].trigger > rule.trigger ||
+                     (_rules[at - 1].trigger == rule.trigger && _rules[at - 1].priority > rule.priority))) {
+        _rules[at] = _rules[at - 1];
+        at--;
+    }
+    _rules[at] = rule;
+    _rules[at].holdoff = (uint8_t)holdoff;
+    _ruleCount++;
+
+    // where each trigger's rules begin
+    unsigned int i = 0;
+    for(unsigned int trigger = 0; trigger <= ALERT_TRIGGERS; trigger++) {
+        while(i < _ruleCount && _rules[i].trigger < trigger) {
+            i++;
+        }
+        _first[trigger] = (uint8_t)i;
+    }
+    return true;
+
+}   // end of addRule()
+
 // Initialization
 void WSMAlertProcessor::begin() {
     // initialize all of the internal variables.
@@ -25,15 +171,40 @@ void WSMAlertProcessor::begin() {
     // initialize accumulators to zero
     _ppAccumulatedOnTime = 0.0; // accumulation of PP run imes
     _timeBetweenPPevents = 0;  // accumulation of ½ hour “ticks” for how long PP didn't come on
+    _ppCycles.begin();
+    _wpCycles.begin();
 
-    // initialize holdoff to max values so that first alerts will happen
-    _ppAlertHoldoff = ONE_DAY;   // holdoff between new sms alerts for PP conditions.
-    _wpAlertHoldoff = ONE_DAY;   // holdoff between new sms alerts for WP conditions.
-    _interPumpAlertHoldoff = ONE_DAY;    // holdoff between new sms alerts for WP-PP conditions.
+    // initialize holdoffs to max values so that first alerts will happen
+    for(unsigned int i = 0; i < _holdoffCount; i++) {
+        _holdoffs[i] = _holdoffLimits[i];
+    }
     _interPPrunTime = ONE_DAY;   // holdoff between new sms alerts for inter PP condition.
-    _ppNotRunAlertHoldoff = THREE_DAYS; // holdoff between new sms alerts for no PP condition.
+
+    for(unsigned int i = 0; i < ALERT_MEASURES; i++) {
+        _measures[i] = 0.0;
+    }
+    _measures[MEASURE_TEMPERATURE] = NAN;   // no reading yet
+
+    _alertCount = 0;    // alerts published since begin()
+
+    // nothing learned yet for the adaptive alerts
+    _ppRunBaseline.begin();
+    _ppIntervalBaseline.begin();
+    _wpRunBaseline.begin();
+    _ppPerWpBaseline.begin();
+    _lastPPOnTime = 0;
+
+    // pick up where we left off before a restart
+    _rulesKey = rulesKey();
+    _restored = restoreState();
 }
 
+// persist(): the state is saved to EEPROM from here on
+void WSMAlertProcessor::persist(int eepromAddress) {
+    _store = WSMStateStore(eepromAddress, sizeof(WSMAlertState), ALERT_STATE_VERSION);
+
+}   // end of persist()
+
 // Methods for testing purposes
 float WSMAlertProcessor::get_ppAccumulatedOnTime() {
     return _ppAccumulatedOnTime;
@@ -46,17 +217,17 @@ unsigned int WSMAlertProcessor::get_timeBetweenPPevents() {
 }   // end of get_timeBetweenPPevents()
 
 unsigned int WSMAlertProcessor::get_ppAlertHoldoff() {
-    return _ppAlertHoldoff;
+    return _holdoffs[ALERT_HOLDOFF_PP];
 
 }   // end of get_timeBetweenPPevents()
 
 unsigned int WSMAlertProcessor::get_wpAlertHoldoff() {
-    return _wpAlertHoldoff;
+    return _holdoffs[ALERT_HOLDOFF_WP];
 
 }   // end of get_wpAlertHoldoff()
 
 unsigned int WSMAlertProcessor::get_interPumpAlertHoldoff() {
-    return _interPumpAlertHoldoff;
+    return _holdoffs[ALERT_HOLDOFF_INTER_PUMP];
 
 }   // end of get_interPumpAlertHoldoff()
 
@@ -66,53 +237,55 @@ unsigned int WSMAlertProcessor::get_interPPrunTime() {
 }   // end of get_interPPrunTime()
 
 unsigned int WSMAlertProcessor::get_ppNotRunAlertHoldoff() {
-    return _ppNotRunAlertHoldoff;
+    return _holdoffs[ALERT_HOLDOFF_PP_NOT_RUN];
 
 }   // end of et_ppNotRunAlertHoldoff()
 
+unsigned int WSMAlertProcessor::get_alertCount() {
+    return _alertCount;
+
+}   // end of get_alertCount()
+
+unsigned int WSMAlertProcessor::get_ppDeviationHoldoff() {
+    return _holdoffs[ALERT_HOLDOFF_PP_DEVIATION];
+
+}   // end of get_ppDeviationHoldoff()
+
+unsigned int WSMAlertProcessor::get_wpDeviationHoldoff() {
+    return _holdoffs[ALERT_HOLDOFF_WP_DEVIATION];
+
+}   // end of get_wpDeviationHoldoff()
+
+unsigned int WSMAlertProcessor::get_shortCycleHoldoff() {
+    return _holdoffs[ALERT_HOLDOFF_SHORT_CYCLE];
+
+}   // end of get_shortCycleHoldoff()
+
 // Methods for processing WSM data into alert events
 
-// halfHourTimeTick(): called every ½ hour (when publishTRH() is called).  
+// halfHourTimeTick(): called every ½ hour (by the sketch's alert tick timer).  
 //  This method increments all of the ½ hour time tick variables.  
 //  It clamps all such variables if the variable value already exceeds the holdoff threshold, 
 //  so that the values don’t get needlessly large.  
 //  Generates an alert for “PP has not run for greater than a threshold time”.
 void WSMAlertProcessor::halfHourTimeTick() {
-//    if(_timeBetweenPPevents < ONE_DAY) {
-//        _timeBetweenPPevents++;
-//    }
-    
-    if(_ppAlertHoldoff < ONE_DAY) {
-        _ppAlertHoldoff++;
-    }
-
-    if(_wpAlertHoldoff < ONE_DAY) {
-        _wpAlertHoldoff++;
+    for(unsigned int i = 0; i < _holdoffCount; i++) {
+        if(_holdoffs[i] < _holdoffLimits[i]) {
+            _holdoffs[i]++;
+        }
     }
 
-    if(_interPumpAlertHoldoff < ONE_DAY) {
-        _interPumpAlertHoldoff++;
-    }
-    
-    if(_ppNotRunAlertHoldoff < THREE_DAYS) {
-        _ppNotRunAlertHoldoff++;
-    }
-    
-    // we must test to see if PP didn't run at all for a long time
+    // we must test to see if PP didn't run at all for a long time (alert #7)
+    _measures[MEASURE_PP_IDLE_TICKS] = (float)_timeBetweenPPevents;
+    countCycles(Time.now());
+    evaluate(ALERT_ON_TICK);
     if(_timeBetweenPPevents < ONE_DAY) {
         _timeBetweenPPevents++;
     } else {
-        if (_ppNotRunAlertHoldoff >= THREE_DAYS) {
-            // generate PP not run after too long time alert #7
-            publishPPNotRun(_timeBetweenPPevents);
-
-            // reset the alert holdoff
-            _ppNotRunAlertHoldoff = 0;
-        }
         // clamp at one day
         _timeBetweenPPevents = ONE_DAY;  
-
     }
+    saveState();
         
 } // end halfHourTimeTick()
 
@@ -121,62 +294,72 @@ void WSMAlertProcessor::ppTurnedOn() {
     // pp has run, so reset alert counter
     _timeBetweenPPevents = 0;
 
+    // count the cycle; has the PP come on too many times? (alert #10)
+    time_t now = Time.now();
+    if(Time.isValid()) {
+        _ppCycles.add(now);
+    }
+    _measures[MEASURE_PP_IDLE_TICKS] = 0.0;
+    countCycles(now);
+    evaluate(ALERT_ON_PP_ON);
+
+    // learn the time between PP cycles, on a clock the cloud has set
+    if(DEVIATION_SIGMAS > 0.0 && Time.isValid()) {
+        float interval = (float)(now - _lastPPOnTime) / 60.0;
+        // only short intervals: a long one is the PP not run alert's business, and one longer than
+        //  the PP not run window (the clock set since the last cycle) is not learned at all
+        if(_lastPPOnTime != 0 && interval > 0.0 && interval <= ONE_DAY * 30.0) {
+            checkDeviation(_ppIntervalBaseline, interval, "PP cycle interval", false, true);
+        }
+        _lastPPOnTime = now;
+    }
+    saveState();
+
 }  // end ppTurnedOn()
         
 // ppTurnedOff():  called every time the PP turns off with PP run time as argument
 void WSMAlertProcessor::ppTurnedOff(float runTime) {
-    // evaluate PP on time for too short or too long alert
-    if(_ppAlertHoldoff >= ONE_DAY) {    // we can generate an alert, if needed
-        if(runTime < PP_ON_TOO_SHORT_LIMIT) {
-            // publish PP too short run alert #2
-            publishPPOnTooShortAlert(runTime);
-
-            // reset the holdoff
-            _ppAlertHoldoff = 0;
-        } else 
-        if(runTime > PP_ON_TOO_LONG_LIMIT) {
-            // publish PP too long run alert #1
-            publishPPOnTooLongAlert(runTime);
-
-            // reset the holdoff
-            _ppAlertHoldoff = 0;
-        }
-    }
+    // evaluate PP on time for too short or too long (alerts #2 and #1), and if WP didn't come on
+    //  after too much PP run time (alert #5)
+    _measures[MEASURE_PP_RUN_TIME] = runTime;
+    _measures[MEASURE_PP_ACCUMULATED] = _ppAccumulatedOnTime;
+    evaluate(ALERT_ON_PP_OFF);
 
-    // accumulate the PP on time. Evaluate if WP didn't come on after too much PP run time
+    // accumulate the PP on time
     if(_ppAccumulatedOnTime < WP_RUN_TOO_LONG_LIMIT) {
         _ppAccumulatedOnTime += runTime;
-
-    } else {    // alert if WP didn't come on when it should have
-        if(_interPumpAlertHoldoff >= ONE_DAY) { // we can generate alert
-            // publish the alert #5
-            publishWPNotComeOnAlert(_ppAccumulatedOnTime);
-
-            // reset holdoff
-            _interPumpAlertHoldoff = 0;
-
-        }
-
+    } else {
         _ppAccumulatedOnTime = WP_RUN_TOO_LONG_LIMIT;  // clamp to the alert limit
     }
+
+    // learn the PP run time
+    if(DEVIATION_SIGMAS > 0.0) {
+        checkDeviation(_ppRunBaseline, runTime, "PP run time", false);
+    }
+    saveState();
     return;
 
 }   // end ppTurnedOff()
 
 // wpTurnedOn():  called every time the WP comes on
 void WSMAlertProcessor::wpTurnedOn() {
-    // was accumulated PP on times < threshold when WP came on?
-    if(_interPumpAlertHoldoff >= ONE_DAY) {     // we can generate an alert, if needed
-        if(_ppAccumulatedOnTime < WP_RUN_TOO_SOON_LIMIT) {
-            // publish WP came on too soon alert #6
-            publishWPOnTooSoon(_ppAccumulatedOnTime);
-
-            // reset the alert holdoff
-            _interPumpAlertHoldoff = 0;
-        }
+    // was accumulated PP on times < threshold when WP came on? (alert #6)
+    time_t now = Time.now();
+    if(Time.isValid()) {
+        _wpCycles.add(now);
+    }
+    _measures[MEASURE_PP_ACCUMULATED] = _ppAccumulatedOnTime;
+    countCycles(now);
+    evaluate(ALERT_ON_WP_ON);
+
+    // learn the PP run time between WP cycles
+    if(DEVIATION_SIGMAS > 0.0) {
+        checkDeviation(_ppPerWpBaseline, _ppAccumulatedOnTime, "PP run time between WP cycles", true);
     }
+
     // since WP came on, reset the PP accumulated run times (between WP events)
     _ppAccumulatedOnTime = 0.0;
+    saveState();
     return;
 
 }   // end wpTurnedOn()
@@ -184,116 +367,171 @@ void WSMAlertProcessor::wpTurnedOn() {
 
 // wpTurnedOff():  called every time the WP turns off with WP run time as argument
 void WSMAlertProcessor::wpTurnedOff(float runTime) {
-    // evaluate WP on time for too long or too short
-    if(_wpAlertHoldoff >= ONE_DAY) {    // we can generate an alert, if needed
-        if(runTime < WP_ON_TOO_SHORT_LIMIT) {
-            // publish WP too short run alert #4
-            pubLishWPOnTooShortAlert(runTime);
+    // evaluate WP on time for too short or too long (alerts #4 and #3)
+    _measures[MEASURE_WP_RUN_TIME] = runTime;
+    evaluate(ALERT_ON_WP_OFF);
 
-            // reset the holdoff
-            _wpAlertHoldoff = 0;
-        } else 
-        if(runTime > WP_ON_TOO_LONG_LIMIT) {
-            // publish WP too long run alert #3
+    // learn the WP run time
+    if(DEVIATION_SIGMAS > 0.0) {
+        checkDeviation(_wpRunBaseline, runTime, "WP run time", true);
+    }
+    saveState();
+
+}   // end wpTurnedOff()
+
+// temperatureReading(): called with each new temperature (degrees F), for the rules that look at it
+void WSMAlertProcessor::temperatureReading(float degreesF) {
+    _measures[MEASURE_TEMPERATURE] = degreesF;
+
+}   // end temperatureReading()
+
+// countCycles(): the cycle measures, up to now.  Until the cloud has set the clock, now is near
+//  1970 and every cycle would land in the bucket the restored windows left off at: count nothing,
+//  and leave the windows as they were.
+void WSMAlertProcessor::countCycles(time_t now) {
+    bool valid = Time.isValid();
+    _measures[MEASURE_PP_CYCLES_10_MINUTES] = valid ? (float)_ppCycles.count(CYCLES_10_MINUTES, now) : 0.0;
+    _measures[MEASURE_PP_CYCLES_LAST_HOUR] = valid ? (float)_ppCycles.count(CYCLES_HOUR, now) : 0.0;
+    _measures[MEASURE_PP_CYCLES_DAY] = valid ? (float)_ppCycles.count(CYCLES_DAY, now) : 0.0;
+    _measures[MEASURE_WP_CYCLES_LAST_HOUR] = valid ? (float)_wpCycles.count(CYCLES_HOUR, now) : 0.0;
+    _measures[MEASURE_WP_CYCLES_DAY] = valid ? (float)_wpCycles.count(CYCLES_DAY, now) : 0.0;
+
+}   // end countCycles()
+
+// evaluate(): run the rules of a pump event against the measures.  A rule whose holdoff allows and
+//  whose comparison holds publishes its alert and resets its holdoff, which holds off the rules
+//  after it that share the counter.
+void WSMAlertProcessor::evaluate(WSMAlertTrigger trigger) {
+    for(unsigned int i = _first[trigger]; i < _first[trigger + 1]; i++) {
+        const WSMAlertRule &rule = _rules[i];
+        uint16_t &holdoff = _holdoffs[rule.holdoff];
+        if(holdoff < rule.holdoffTicks) {
+            continue;   // held off
+        }
 
-            publishWPOnTooLongAlert(runTime);
+        // below, equal or above, as the bits of WSMAlertCompare; none of them for a NAN
+        float value = _measures[rule.measure];
+        unsigned int outcome = (unsigned int)(value < rule.threshold) | (unsigned int)(value == rule.threshold) << 1 |
+                               (unsigned int)(value > rule.threshold) << 2;
+        if(rule.compare & outcome) {
+            publishAlert(_queue, rule.eventName, rule.before, value, rule.decimals, rule.after);
+            _alertCount++;
 
             // reset the holdoff
-            _wpAlertHoldoff = 0;
+            holdoff = 0;
         }
     }
 
+}   // end evaluate()
 
-}   // end wpTurnedOff()
+// checkDeviation():  learn a value into its baseline and raise a deviation alert if it is far
+//  outside what was learned, or recent values have drifted, and the PP or WP holdoff allows;
+//  lowOnly: only values below the range, or a drift down
+void WSMAlertProcessor::checkDeviation(WSMBaseline &baseline, float value, const char *what, bool wp, bool lowOnly) {
+    WSMBaselineVerdict verdict = baseline.add(value, DEVIATION_SIGMAS);
+    if(verdict == BASELINE_LEARNING || verdict == BASELINE_NORMAL) {
+        return;
+    }
+    if(lowOnly && (verdict == BASELINE_HIGH || verdict == BASELINE_DRIFT_UP)) {
+        return;
+    }
 
-// methods for publishing the seven alerts
-
-// publishPPOnTooLongAlert():  Alert published for PP running too long
-//  argument is the PP run time
-void WSMAlertProcessor::publishPPOnTooLongAlert(float onTime){      // alert #1
-    // code to build json string and publish to Particle cloud
-    String eData = "{\"etime\":";
-    eData += String(Time.now());
-    eData += ",\"msg\":\"PP on for ";
-    eData += String(onTime);
-    eData += " minutes.\"}";
-    Particle.publish("wsmAlertPPOnTooLong", eData, PRIVATE);
-
-} // end of publishPPOnTooLongAlert()
-
-// publishPPOnTooShortAlert():  Alert published for PP running too short of a time
-//  argument is PP run time
-void WSMAlertProcessor::publishPPOnTooShortAlert(float onTime){    // alert #2
-    // code to build json string and publish to Particle cloud
-    String eData = "{\"etime\":";
-    eData += String(Time.now());
-    eData += ",\"msg\":\"PP on for ";
-    eData += String(onTime);
-    eData += " minutes.\"}";
-    Particle.publish("wsmAlertPPOnTooShort", eData, PRIVATE);
-        
-} // end of publishPPOnTooShortAlert()
-
-// publishWPOnTooLongAlert():  Alert published for WP running too long
-//  argument is the WP run time
-void WSMAlertProcessor::publishWPOnTooLongAlert(float onTime){     // alert #3
-    // code to build json string and publish to Particle cloud
-    String eData = "{\"etime\":";
-    eData += String(Time.now());
-    eData += ",\"msg\":\"WP on for ";
-    eData += String(onTime);
-    eData += " minutes.\"}";
-    Particle.publish("wsmAlertWPOnTooLong", eData, PRIVATE);
-       
-} // end of publishWPOnTooLongAlert()
-
-// publishWPOnTooShortAlert():  Alert published for WP running too short of a time
-//  argument is the WP run time
-void WSMAlertProcessor::pubLishWPOnTooShortAlert(float onTime){    // alert #4
-    // code to build json string and publish to Particle cloud
-    String eData = "{\"etime\":";
-    eData += String(Time.now());
-    eData += ",\"msg\":\"WP on for ";
-    eData += String(onTime);
-    eData += " minutes.\"}";
-    Particle.publish("wsmAlertWPOnTooShort", eData, PRIVATE);
-    
-} // end of pubLishWPOnTooShortAlert()
-
-// publishWPNotComeOnAlert(): alert published when WP doesn't come on after a lot of PP activity
-//  argument is the accumulated PP run time since last WP run
-void WSMAlertProcessor::publishWPNotComeOnAlert(float accumulatedPPTime){  // alert #5
-    // code to build json string and publish to Particle cloud
-    String eData = "{\"etime\":";
-    eData += String(Time.now());
-    eData += ",\"msg\":\"WP did not come on after PP run for > ";
-    eData += String(accumulatedPPTime);
-    eData += " minutes.\"}";
-    Particle.publish("wsmAlertWPNotComeOn", eData, PRIVATE);
-        
-} // end of publishWPNotComeOnAlert()
-
-// publishWPOnTooSoon(): alert published when WP came on after not enough accumulated PP run time
-//  argument is the accumulated PP run time since last WP run
-void WSMAlertProcessor::publishWPOnTooSoon(float accumulatedPPTime){      // alert #6
-    // code to build json string and publish to Particle cloud
-    String eData = "{\"etime\":";
-    eData += String(Time.now());
-    eData += ",\"msg\":\"WP came on after PP run for only ";
-    eData += String(accumulatedPPTime);
-    eData += " minutes.\"}";
-    Particle.publish("wsmAlertWPOnTooSoon", eData, PRIVATE);
-
-} // end of publishWPOnTooSoon()
-
-// publishPPNotRun(): alert published if PP hasn't run for a day or more
-//  argument it the time since the last PP run (in 1/2 hour ticks).
-void WSMAlertProcessor::publishPPNotRun(unsigned int tickTime){    // alert #7
-    // code to build json string and publish to Particle cloud
-    String eData = "{\"etime\":";
-    eData += String(Time.now());
-    eData += ",\"msg\":\"PP did not run for at least the last day.\"}";
-    Particle.publish("wsmAlertPPNotRun", eData, PRIVATE);    
-
-} // end of publishPPNotRun()
+    uint16_t &holdoff = _holdoffs[wp ? ALERT_HOLDOFF_WP_DEVIATION : ALERT_HOLDOFF_PP_DEVIATION];
+    if(holdoff >= ONE_DAY) {    // we can generate an alert
+        if(verdict == BASELINE_DRIFT_UP || verdict == BASELINE_DRIFT_DOWN) {
+            value = baseline.recent();
+        }
+        publishDeviationAlert(wp ? "wsmAlertWPDeviation" : "wsmAlertPPDeviation", what, verdict, value);
+
+        // reset the holdoff
+        holdoff = 0;
+    }
+}   // end checkDeviation()
+
+// publishDeviationAlert(): alert published when a value, or the recent mean of its values, is
+//  far from the site's learned baseline
+void WSMAlertProcessor::publishDeviationAlert(const char *eventName, const char *what, WSMBaselineVerdict verdict,
+                                              float value) {     // alerts #8 and #9
+    bool drift = verdict == BASELINE_DRIFT_UP || verdict == BASELINE_DRIFT_DOWN;
+    char before[JSON_EVENT_SIZE / 2];
+    size_t length = strlen(what);
+    if(length > sizeof(before) - 12) {
+        length = sizeof(before) - 12;
+    }
+    memcpy(before, what, length);
+    strcpy(before + length, drift ? " averages " : " of ");
+
+    const char *after = " minutes is below the learned range.";
+    if(verdict == BASELINE_HIGH) {
+        after = " minutes is above the learned range.";
+    } else if(verdict == BASELINE_DRIFT_UP) {
+        after = " minutes, drifted up from the baseline.";
+    } else if(verdict == BASELINE_DRIFT_DOWN) {
+        after = " minutes, drifted down from the baseline.";
+    }
+    publishAlert(_queue, eventName, before, value, 6, after);
+    _alertCount++;
+
+} // end of publishDeviationAlert()
+
+// rulesKey(): a site rule's holdoff counter is the next free one when it is added, so a changed
+//  table may give a counter to another rule
+uint16_t WSMAlertProcessor::rulesKey() {
+    uint16_t key = 0xFFFF;
+    for(unsigned int i = 0; i < _ruleCount; i++) {
+        key = crc16(key, (const uint8_t *)_rules[i].eventName, strlen(_rules[i].eventName));
+        key = crc16(key, &_rules[i].holdoff, 1);
+    }
+    return key;
 
+}   // end of rulesKey()
+
+// restoreState(): the snapshot, within the limits of this firmware; the holdoffs of the site rules
+//  only if the table is the one they were kept for.  The time since the PP last came on is not
+//  restored: the PP may have run while we were down.
+bool WSMAlertProcessor::restoreState() {
+    WSMAlertState state;
+    if(!_store.load(&state) || !(state.ppAccumulatedOnTime >= 0.0)) {
+        return false;
+    }
+    _ppAccumulatedOnTime = state.ppAccumulatedOnTime;   // ppTurnedOff() clamps it
+    _timeBetweenPPevents = state.timeBetweenPPevents < ONE_DAY ? state.timeBetweenPPevents : ONE_DAY;
+    unsigned int holdoffs = ALERT_FIXED_HOLDOFFS;
+    if(state.rulesKey == _rulesKey && state.holdoffCount == _holdoffCount) {
+        holdoffs = _holdoffCount;
+    }
+    for(unsigned int i = 0; i < holdoffs; i++) {
+        _holdoffs[i] = state.holdoffs[i] < _holdoffLimits[i] ? state.holdoffs[i] : _holdoffLimits[i];
+    }
+    memcpy((void *)&_ppCycles, (const void *)&state.ppCycles, sizeof(_ppCycles));
+    memcpy((void *)&_wpCycles, (const void *)&state.wpCycles, sizeof(_wpCycles));
+    memcpy((void *)&_ppRunBaseline, (const void *)&state.baselines[0], sizeof(WSMBaseline));
+    memcpy((void *)&_ppIntervalBaseline, (const void *)&state.baselines[1], sizeof(WSMBaseline));
+    memcpy((void *)&_wpRunBaseline, (const void *)&state.baselines[2], sizeof(WSMBaseline));
+    memcpy((void *)&_ppPerWpBaseline, (const void *)&state.baselines[3], sizeof(WSMBaseline));
+    return true;
+
+}   // end of restoreState()
+
+// saveState(): only the bytes that changed reach the EEPROM
+void WSMAlertProcessor::saveState() {
+    if(!_store.enabled()) {
+        return;
+    }
+    // byte for byte, padding too, so that only what changed is written
+    WSMAlertState state;
+    memset((void *)&state, 0, sizeof(state));
+    state.ppAccumulatedOnTime = _ppAccumulatedOnTime;
+    state.timeBetweenPPevents = _timeBetweenPPevents;
+    state.rulesKey = _rulesKey;
+    state.holdoffCount = (uint16_t)_holdoffCount;
+    memcpy(state.holdoffs, _holdoffs, sizeof(state.holdoffs));
+    memcpy((void *)&state.ppCycles, (const void *)&_ppCycles, sizeof(_ppCycles));
+    memcpy((void *)&state.wpCycles, (const void *)&_wpCycles, sizeof(_wpCycles));
+    memcpy((void *)&state.baselines[0], (const void *)&_ppRunBaseline, sizeof(WSMBaseline));
+    memcpy((void *)&state.baselines[1], (const void *)&_ppIntervalBaseline, sizeof(WSMBaseline));
+    memcpy((void *)&state.baselines[2], (const void *)&_wpRunBaseline, sizeof(WSMBaseline));
+    memcpy((void *)&state.baselines[3], (const void *)&_ppPerWpBaseline, sizeof(WSMBaseline));
+    _store.save(&state);
+
+}   // end of saveState()
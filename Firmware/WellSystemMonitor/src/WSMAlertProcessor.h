@@ -9,58 +9,227 @@
  * version 1.0: 8/9/2022.  Initial release
  * version 1.1: 8/23/22.  Fixed initialization bug 
  * 10/4/2024: Changed pp on too short limit to 0.3 minutes based on field experience with 30 gallon tank
+ * 2026: Limits can be passed to the constructor (WSMAlertLimits) so that they can be tuned per
+ *  installation; the defaults are unchanged.
+ * 2026: Adaptive deviation alerts (#8, #9): each site's PP and WP run times, the time between PP
+ *  cycles and the PP run time between WP cycles are learned (WSMBaseline), and a value far outside
+ *  what was learned, or a drift of recent behaviour, raises an alert under its own one day holdoff.
+ *  Off unless WSMAlertLimits::deviationSigmas is set.
+ * 2026: The seven fixed alerts are rows of a rule table (WSMAlertRule) evaluated by one loop, with
+ *  their holdoffs in one array of counters; a site adds its own alerts with addRule().
+ * 2026: Short cycling alert (#10): the PP and WP cycles of the last 10 minutes, hour and day are
+ *  counted (WSMCycleCounter), and the PP coming on too many times in 10 minutes or an hour raises
+ *  wsmAlertPPShortCycling under its own one day holdoff.  Off unless WSMAlertLimits::ppCycles10Minutes
+ *  or ppCyclesHour is set.  Nothing is counted until the cloud has set the clock (Time.isValid()).
+ * 2026: The alert state (PP run time since the WP, ticks since the PP ran, the holdoffs, cycle
+ *  counts and learned baselines) can be kept in EEPROM (persist()), saved after every event, so
+ *  that a restart neither forgets it nor repeats an alert that is being held off.
+ * 2026: The alerts can be published through a WSMPublishQueue (publishVia()), from its worker
+ *  thread, so that raising one does not wait on the cloud.
  * 
  *******************************************************************************/
 #ifndef wsmap
 #define wsmap
 
 #include "application.h"
+#include "WSMBaseline.h"
+#include "WSMCycleCounter.h"
+#include "WSMStateStore.h"
+#include "WSMPublishQueue.h"
+
+// Alert limits.  The defaults are the limits for our installation.
+struct WSMAlertLimits {
+    float ppOnTooShort = 0.3; // PP should not run <= 1/3 minute
+    float ppOnTooLong = 3.0;  // PP should not run >= 3 minutes
+    float wpOnTooShort = 20.0; // WP should not run <= 20 minutes
+    float wpOnTooLong = 40.0; // WP should not run >= 40 minutes
+    float wpRunTooSoon = 10.0;  // WP should not come on if total PP ontime <= 10 minutes
+    float wpRunTooLong = 30.0;  // WP should come on if total PP ontime >= 30 minutes
+    unsigned int oneDay = 48; // alert holdoff and PP not run time: one day = 48 half hour ticks
+    unsigned int threeDays = 144;  // PP not run alert holdoff: three days = 144 half hour ticks
+    unsigned int ppCycles10Minutes = 0; // short cycling: PP should not come on more than this many times
+    unsigned int ppCyclesHour = 0;      // in 10 minutes, or in an hour; 0 turns the alert off
+    float deviationSigmas = 0.0;    // adaptive alerts: recent behaviour may drift this many standard
+                                    // errors from the learned baseline; 0 turns them off
+};
+
+// Alert rules.  Each alert is a rule: on a pump event (its trigger) it compares one measure of the
+//  pump state with its threshold and, when its holdoff counter has reached holdoffTicks, publishes
+//  its event with the message before + value + after and resets the counter.  Rules that share a
+//  counter hold each other off; the rules of a trigger are evaluated lowest priority number first,
+//  which is also the order their alerts are published in.  The fixed alerts are built from
+//  WSMAlertLimits; a site adds its own with addRule(), for example:
+//
+//      // the WP came on with the well house at or below 32 F; held off for a day on its own counter
+//      const WSMAlertRule WP_FREEZE = {"wsmAlertWPFreeze", ALERT_ON_WP_ON, MEASURE_TEMPERATURE, ALERT_AT_MOST,
+//                                      32.0, 48, ALERT_OWN_HOLDOFF, 0, 1, "WP came on at ", " degrees F."};
+//      alerter.addRule(WP_FREEZE);
+
+// the pump events that rules are evaluated on
+enum WSMAlertTrigger {
+    ALERT_ON_TICK,      // halfHourTimeTick()
+    ALERT_ON_PP_ON,     // ppTurnedOn()
+    ALERT_ON_PP_OFF,    // ppTurnedOff()
+    ALERT_ON_WP_ON,     // wpTurnedOn()
+    ALERT_ON_WP_OFF,    // wpTurnedOff()
+    ALERT_TRIGGERS
+};
+
+// the pump state that rules look at
+enum WSMAlertMeasure {
+    MEASURE_PP_RUN_TIME,        // the PP run that just ended (minutes)
+    MEASURE_WP_RUN_TIME,        // the WP run that just ended (minutes)
+    MEASURE_PP_ACCUMULATED,     // PP run time since the WP last came on, not counting a run that just ended (minutes)
+    MEASURE_PP_IDLE_TICKS,      // ½ hour ticks since the PP last came on, up to one day
+    MEASURE_PP_CYCLES_10_MINUTES,   // PP cycles in the last 10 minutes (WSMCycleCounter.h)
+    MEASURE_PP_CYCLES_LAST_HOUR,    // PP cycles in the last hour
+    MEASURE_PP_CYCLES_DAY,      // PP cycles in the last day
+    MEASURE_WP_CYCLES_LAST_HOUR,    // WP cycles in the last hour
+    MEASURE_WP_CYCLES_DAY,      // WP cycles in the last day
+    MEASURE_TEMPERATURE,        // the last temperatureReading(); NAN, which fails every comparison, before one
+    ALERT_MEASURES
+};
+
+// how a rule compares its measure with its threshold: the outcomes that alert, as bits, so that
+//  the comparison is a mask test rather than a branch; ALERT_BELOW | ALERT_ABOVE is "not equal"
+enum WSMAlertCompare {
+    ALERT_BELOW = 1,    // measure <  threshold
+    ALERT_EQUAL = 2,    // measure == threshold
+    ALERT_AT_MOST = 3,  // measure <= threshold
+    ALERT_ABOVE = 4,    // measure >  threshold
+    ALERT_AT_LEAST = 6  // measure >= threshold
+};
+
+// the holdoff counters of the fixed alerts; a rule may share one of these, or have its own
+enum {
+    ALERT_HOLDOFF_PP,           // PP run time alerts #1 and #2
+    ALERT_HOLDOFF_WP,           // WP run time alerts #3 and #4
+    ALERT_HOLDOFF_INTER_PUMP,   // WP-PP alerts #5 and #6
+    ALERT_HOLDOFF_PP_NOT_RUN,   // alert #7
+    ALERT_HOLDOFF_PP_DEVIATION, // alert #8
+    ALERT_HOLDOFF_WP_DEVIATION, // alert #9
+    ALERT_HOLDOFF_SHORT_CYCLE,  // alert #10
+    ALERT_FIXED_HOLDOFFS,
+    ALERT_OWN_HOLDOFF = 0xFF    // addRule(): a new counter for this rule
+};
+
+const unsigned int ALERT_MAX_RULES = 64;    // the fixed alerts' seven to nine and the site's
+const unsigned int ALERT_MAX_HOLDOFFS = ALERT_MAX_RULES;
+
+struct WSMAlertRule {
+    const char *eventName;  // the event published, "wsmAlert..."
+    uint8_t trigger;        // WSMAlertTrigger
+    uint8_t measure;        // WSMAlertMeasure
+    uint8_t compare;        // WSMAlertCompare
+    float threshold;
+    uint16_t holdoffTicks;  // ½ hour ticks after an alert on its counter before the rule alerts again
+    uint8_t holdoff;        // its holdoff counter: ALERT_HOLDOFF_* or ALERT_OWN_HOLDOFF
+    uint8_t priority;       // lowest first among the rules of a trigger
+    uint8_t decimals;       // of the value in the message
+    const char *before;     // message text before the value; NULL leaves out the value
+    const char *after;      // message text after the value
+};
+
+// the state that persist() keeps in EEPROM
+struct WSMAlertState {
+    float ppAccumulatedOnTime;
+    uint32_t timeBetweenPPevents;
+    uint16_t rulesKey;          // of the rule table: the holdoffs of site rules are restored only
+    uint16_t holdoffCount;      //  to the table they were kept for
+    uint16_t holdoffs[ALERT_MAX_HOLDOFFS];
+    WSMCycleCounter ppCycles;
+    WSMCycleCounter wpCycles;
+    WSMBaseline baselines[4];   // PP run time, PP cycle interval, WP run time, PP run between WP cycles
+};
+
+// the EEPROM that persist() takes
+const int ALERT_STATE_EEPROM_SIZE = 2 * (STATE_HEADER_SIZE + (int)sizeof(WSMAlertState));
 
 class WSMAlertProcessor  {
     private:
         // Constants
-        const float PP_ON_TOO_SHORT_LIMIT = 0.3; // PP should not run <= 1/3 minute
-        const float PP_ON_TOO_LONG_LIMIT = 3.0;  // PP should not run >= 3 minutes
-        const float WP_ON_TOO_SHORT_LIMIT = 20.0; // WP should not run <= 20 minutes
-        const float WP_ON_TOO_LONG_LIMIT = 40.0; // WP should not run >= 40 minutes
-        const float WP_RUN_TOO_SOON_LIMIT = 10.0;  // WP should not come on if total PP ontime <= 10 minutes
-        const float WP_RUN_TOO_LONG_LIMIT = 30.0;  // WP should come on if total PP ontime >= 30 minutes
-        const unsigned int ONE_DAY = 48; // one day = 24 hours = 48 half hour ticks
-        const unsigned int THREE_DAYS = 144;  // three days = 3 x 48 = 144 half hour ticks
+        const float PP_ON_TOO_SHORT_LIMIT;
+        const float PP_ON_TOO_LONG_LIMIT;
+        const float WP_ON_TOO_SHORT_LIMIT;
+        const float WP_ON_TOO_LONG_LIMIT;
+        const float WP_RUN_TOO_SOON_LIMIT;
+        const float WP_RUN_TOO_LONG_LIMIT;
+        const unsigned int ONE_DAY;
+        const unsigned int THREE_DAYS;
+        const float DEVIATION_SIGMAS;
 
         // Variables
         float _ppAccumulatedOnTime; // accumulation of PP run imes
         unsigned int _timeBetweenPPevents;  // accumulation of ½ hour “ticks”
-        unsigned int _ppAlertHoldoff;   // holdoff between new sms alerts for PP conditions.
-        unsigned int _wpAlertHoldoff;   // holdoff between new sms alerts for WP conditions.
-        unsigned int _interPumpAlertHoldoff;    // holdoff between new sms alerts for WP-PP conditions.
         unsigned int _interPPrunTime;   // holdoff between new sms alerts for inter PP condition.
-        unsigned int _ppNotRunAlertHoldoff; // holdoff between new sms alerts for no PP condition.
+        WSMCycleCounter _ppCycles;  // PP cycles over the last 10 minutes, hour and day
+        WSMCycleCounter _wpCycles;  // WP cycles over the same
+        unsigned int _alertCount;   // alerts published since begin()
+        WSMPublishQueue *_queue;    // the alerts are published through it; NULL for directly
+
+        // the rules, ordered by trigger and priority; the rules of trigger t are _first[t] up to
+        //  _first[t + 1]
+        WSMAlertRule _rules[ALERT_MAX_RULES];
+        unsigned int _ruleCount;
+        uint8_t _first[ALERT_TRIGGERS + 1];
+        float _measures[ALERT_MEASURES];    // the pump state, as the rules see it
+
+        // holdoff counters, shared by the rules that name them; each counts ½ hour ticks up to its
+        //  limit, the longest holdoff of its rules
+        uint16_t _holdoffs[ALERT_MAX_HOLDOFFS];
+        uint16_t _holdoffLimits[ALERT_MAX_HOLDOFFS];
+        unsigned int _holdoffCount;
+
+        // the learned baselines of the adaptive alerts
+        WSMBaseline _ppRunBaseline;     // PP run time (minutes)
+        WSMBaseline _ppIntervalBaseline;    // time between PP cycles (minutes)
+        WSMBaseline _wpRunBaseline;     // WP run time (minutes)
+        WSMBaseline _ppPerWpBaseline;   // accumulated PP run time when the WP comes on (minutes)
+        time_t _lastPPOnTime;           // Time.now() when the PP last came on, once the clock was set; 0 before
+
+        // the state kept in EEPROM, if persist() was called
+        WSMStateStore _store;
+        uint16_t _rulesKey;             // of the rule table, from begin()
+        bool _restored;                 // begin() restored it
 
         // Private methods (internal use only)
-        void publishPPOnTooLongAlert(float onTime);     // alert #1
-        void publishPPOnTooShortAlert(float onTime);    // alert #2
-        void publishWPOnTooLongAlert(float onTime);     // alert #3
-        void pubLishWPOnTooShortAlert(float onTime);    // alert #4
-        void publishWPNotComeOnAlert(float accumulatedPPTime);  // alert #5
-        void publishWPOnTooSoon(float accumulatedPPTime);   // alert #6
-        void publishPPNotRun(unsigned int tickTime);    // alert #7
+        void countCycles(time_t now);   // the cycle measures, up to now
+        void evaluate(WSMAlertTrigger trigger);     // alerts #1 to #7, #10 and the site's rules
+        void checkDeviation(WSMBaseline &baseline, float value, const char *what, bool wp, bool lowOnly = false);
+        void publishDeviationAlert(const char *eventName, const char *what, WSMBaselineVerdict verdict,
+                                   float value);   // alerts #8 (PP) and #9 (WP)
+        uint16_t rulesKey();            // CRC of the rules' event names and holdoff counters
+        bool restoreState();            // from _store, if it has a good snapshot
+        void saveState();               // to _store, after every event
 
     public:
-        // Constructor
+        // Constructors
         WSMAlertProcessor();
+        WSMAlertProcessor(const WSMAlertLimits &limits);
+
+        // add a site rule; false if the table is full or the rule is not valid.  Before begin().
+        bool addRule(const WSMAlertRule &rule);
+        unsigned int get_ruleCount() { return _ruleCount; }
+
+        // keep the alert state in ALERT_STATE_EEPROM_SIZE bytes of EEPROM from eepromAddress, saved
+        //  after every event, so that begin() restores it after a restart.  Before begin().
+        void persist(int eepromAddress);
+
+        // publish the alerts through queue, NULL to publish directly (the default)
+        void publishVia(WSMPublishQueue *queue) { _queue = queue; }
 
-        // Initialization
+        // Initialization; restores the persisted state if there is a good snapshot of it
         void begin();
         
         // Methods for generating alerts
-        void halfHourTimeTick();    // called every ½ hour when publishTRH() is called
+        void halfHourTimeTick();    // called every ½ hour, by the sketch's alert tick timer
         void ppTurnedOn();  // called from the function publishPPchange(), if the PP has come on
         void ppTurnedOff(float runTime);    // called from the function publishPPchange(), 
                                             // if the PP has turned off.
         void wpTurnedOn();  // called from the function publishWPchange(), if the WP has come on.
         void wpTurnedOff(float runTime);    // called from the function publishWPchange(), 
                                             // if the WP has turned off.
+        void temperatureReading(float degreesF);    // called from loop() with each new temperature
 
         // Methods for testing purposes
         float get_ppAccumulatedOnTime(); 
@@ -70,6 +239,17 @@ class WSMAlertProcessor  {
         unsigned int get_interPumpAlertHoldoff();
         unsigned int get_interPPrunTime();
         unsigned int get_ppNotRunAlertHoldoff();
+        unsigned int get_alertCount();  // alerts published since begin(); also used by the sketch
+        unsigned int get_ppDeviationHoldoff();
+        unsigned int get_wpDeviationHoldoff();
+        const WSMBaseline &get_ppRunBaseline() { return _ppRunBaseline; }
+        const WSMBaseline &get_ppIntervalBaseline() { return _ppIntervalBaseline; }
+        const WSMBaseline &get_wpRunBaseline() { return _wpRunBaseline; }
+        const WSMBaseline &get_ppPerWpBaseline() { return _ppPerWpBaseline; }
+        unsigned int get_shortCycleHoldoff();
+        WSMCycleCounter &get_ppCycles() { return _ppCycles; }
+        WSMCycleCounter &get_wpCycles() { return _wpCycles; }
+        bool get_restored() { return _restored; }   // begin() restored the persisted state
 };
 
 #endif
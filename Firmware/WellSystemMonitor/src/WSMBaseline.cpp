@@ -0,0 +1,92 @@
+/***************************************************************************************************/
+// WSMBaseline.cpp
+//  A learned baseline of one measurement.  See WSMBaseline.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMBaseline.h>
+#include <math.h>
+
+// EWMA weights of the baseline and of recent behaviour
+static const float SLOW_ALPHA = 0.01f;
+static const float FAST_ALPHA = 0.1f;
+
+// the standard error of the fast mean, per baseline deviation: sqrt(FAST_ALPHA / (2 - FAST_ALPHA))
+static const float FAST_ERROR = 0.2294f;
+
+// the percentiles tracked, their starting distance from the mean in deviations (as for normal
+// values), and the size of their steps in deviations
+static const float LOW_P = 0.01f;
+static const float HIGH_P = 0.99f;
+static const float START_SIGMAS = 2.326f;
+static const float QUANTILE_STEP = 0.05f;
+
+void WSMBaseline::begin() {
+    _count = 0;
+    _drifting = false;
+    _mean = 0.0f;
+    _variance = 0.0f;
+    _recent = 0.0f;
+    _low = 0.0f;
+    _high = 0.0f;
+}
+
+float WSMBaseline::deviation() const {
+    return sqrtf(_variance);
+}
+
+WSMBaselineVerdict WSMBaseline::add(float value, float sigmas) {
+    // a value outside the learned range, judged before it is learned
+    WSMBaselineVerdict verdict = BASELINE_LEARNING;
+    if(_count >= BASELINE_WARMUP) {
+        if(value > highLimit()) {
+            verdict = BASELINE_HIGH;
+        } else if(value < lowLimit()) {
+            verdict = BASELINE_LOW;
+        } else {
+            verdict = BASELINE_NORMAL;
+        }
+    }
+
+    // the EWMAs; while there are few values they are plain averages
+    if(_count < 0xFFFF) {
+        _count++;
+    }
+    float slow = 1.0f / _count > SLOW_ALPHA ? 1.0f / _count : SLOW_ALPHA;
+    float fast = 1.0f / _count > FAST_ALPHA ? 1.0f / _count : FAST_ALPHA;
+    float delta = value - _mean;
+    _mean += slow * delta;
+    _variance = (1.0f - slow) * (_variance + slow * delta * delta);
+    _recent += fast * (value - _recent);
+    float sd = deviation();
+
+    // the percentiles
+    if(_count == BASELINE_WARMUP) {
+        _low = _mean - START_SIGMAS * sd;
+        _high = _mean + START_SIGMAS * sd;
+    } else if(_count > BASELINE_WARMUP) {
+        float step = QUANTILE_STEP * sd;
+        _low += step * (value < _low ? LOW_P - 1.0f : LOW_P);
+        _high += step * (value < _high ? HIGH_P - 1.0f : HIGH_P);
+    }
+
+    // recent behaviour against the baseline
+    if(_count > BASELINE_WARMUP && sigmas > 0.0f) {
+        float drift = (_recent - _mean) / (FAST_ERROR * sd);
+        if(sd == 0.0f) {
+            drift = 0.0f;
+        }
+        if(!_drifting && fabsf(drift) > sigmas) {
+            _drifting = true;
+            if(verdict == BASELINE_NORMAL) {
+                verdict = drift > 0.0f ? BASELINE_DRIFT_UP : BASELINE_DRIFT_DOWN;
+            }
+        } else if(_drifting && fabsf(drift) < sigmas / 2.0f) {
+            _drifting = false;
+        }
+    }
+    return verdict;
+}   // end of add()
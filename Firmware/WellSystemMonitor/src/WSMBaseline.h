@@ -0,0 +1,76 @@
+#ifndef WSMBASELINE_H_INCLUDE
+#define WSMBASELINE_H_INCLUDE
+/***************************************************************************************************/
+// WSMBaseline.h
+//  Learns what is normal for one measurement of a site (a pump's run time, the time between pump
+//  cycles) and says when a new value is not.  The fixed alert limits suit one tank size; a
+//  baseline learns a 30 gallon tank's short PP runs and a 120 gallon tank's long ones alike.
+//
+//  Per value, in constant time and 24 bytes:
+//
+//      slow EWMA mean and variance     the baseline, over the last few hundred values
+//      fast EWMA mean                  recent behaviour, over the last ten or so values
+//      1st and 99th percentiles        started from the warmup's mean and deviation, then tracked
+//                                      by stochastic approximation: a value above the estimate
+//                                      moves it up by p steps, one below it down by 1 - p, steps
+//                                      scaled by the baseline deviation, so that it settles where
+//                                      a fraction p of the values fall below it
+//
+//  After BASELINE_WARMUP values, add() reports a value outside the learned range widened by the
+//  range's own width on each side (for normal values that is beyond 7 sigma), or recent behaviour
+//  that has drifted from the baseline by more than sigmas standard errors of the fast mean; a drift
+//  is reported once, until it has come back within half that.  Every value is learned, so a lasting
+//  change is reported once and then becomes the new normal.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+
+// values learned before anything is reported
+const unsigned int BASELINE_WARMUP = 50;
+
+// what add() found
+enum WSMBaselineVerdict {
+    BASELINE_LEARNING,  // still in the warmup
+    BASELINE_NORMAL,
+    BASELINE_HIGH,      // above the learned range
+    BASELINE_LOW,       // below the learned range
+    BASELINE_DRIFT_UP,  // recent values are higher than the baseline
+    BASELINE_DRIFT_DOWN
+};
+
+class WSMBaseline {
+    public:
+        WSMBaseline() { begin(); }
+
+        // Initialization: nothing learned
+        void begin();
+
+        // learn a value; sigmas is how far the recent mean may drift, in its standard errors
+        WSMBaselineVerdict add(float value, float sigmas);
+
+        unsigned int count() const { return _count; }
+        float mean() const { return _mean; }            // the baseline
+        float deviation() const;
+        float recent() const { return _recent; }        // the fast mean
+        float low() const { return _low; }              // 1st percentile
+        float high() const { return _high; }            // 99th percentile
+
+        // the values outside these are reported
+        float lowLimit() const { return _low - (_high - _low); }
+        float highLimit() const { return _high + (_high - _low); }
+
+    private:
+        uint16_t _count;    // values learned, up to 65535
+        bool _drifting;     // a drift has been reported
+        float _mean;
+        float _variance;
+        float _recent;
+        float _low;
+        float _high;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,58 @@
+/***************************************************************************************************/
+// WSMBootSequence.cpp
+//  Boot phases and their times.  See WSMBootSequence.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMBootSequence.h>
+#include <JSONWriter.h>
+
+// the JSON names of the phases
+static const char *const PHASE_NAMES[BOOT_PHASES] = {"setup", "sample", "cloud", "publish"};
+
+void WSMBootSequence::begin(system_tick_t now) {
+    for(unsigned int i = 0; i < BOOT_PHASES; i++) {
+        _at[i] = 0;
+    }
+    _phase = BOOT_SETUP;
+    _at[BOOT_SETUP] = now;
+}
+
+bool WSMBootSequence::sampled(system_tick_t now) {
+    if(_phase != BOOT_SETUP) {
+        return false;
+    }
+    reach(BOOT_FIRST_SAMPLE, now);
+    return true;
+}
+
+bool WSMBootSequence::cloudConnected(system_tick_t now, bool connected) {
+    if(_phase != BOOT_FIRST_SAMPLE || !connected) {
+        return false;
+    }
+    reach(BOOT_CLOUD_CONNECTED, now);
+    return true;
+}
+
+void WSMBootSequence::published(system_tick_t now) {
+    if(_phase == BOOT_CLOUD_CONNECTED) {
+        reach(BOOT_FIRST_PUBLISH, now);
+    }
+}
+
+bool WSMBootSequence::write(char *json, size_t size) const {
+    JSONWriter writer(json, size);
+    for(unsigned int i = 0; i <= (unsigned int)_phase; i++) {
+        writer.key(PHASE_NAMES[i], (unsigned int)_at[i]);
+    }
+    writer.end();
+    return !writer.overflow();
+}
+
+void WSMBootSequence::reach(WSMBootPhase phase, system_tick_t now) {
+    _phase = phase;
+    _at[phase] = now;
+}
@@ -0,0 +1,65 @@
+#ifndef WSMBOOTSEQUENCE_H_INCLUDE
+#define WSMBOOTSEQUENCE_H_INCLUDE
+/***************************************************************************************************/
+// WSMBootSequence.h
+//  The phases of a boot, in order, and when each was reached.  setup() does not wait for anything:
+//  the inputs are sampled from the first pass of loop(), and the restart is reported once the cloud
+//  is connected, while the indicator shows the restart from the scheduler.  loop() moves the
+//  sequence on:
+//
+//      BOOT_SETUP              setup() entered (begin())
+//      BOOT_FIRST_SAMPLE       the first pass of loop() sampled the inputs (sampled())
+//      BOOT_CLOUD_CONNECTED    the first pass after that with the cloud connected (cloudConnected())
+//      BOOT_FIRST_PUBLISH      the restart report sent to the cloud by the publish queue (published())
+//
+//  The times are millis() when each phase was reached, which on the Photon is milliseconds since
+//  the reset; write() gives them as {"setup":12,"sample":13,"cloud":2210,"publish":2211}, leaving
+//  out the phases not reached yet.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+
+enum WSMBootPhase {
+    BOOT_SETUP,
+    BOOT_FIRST_SAMPLE,
+    BOOT_CLOUD_CONNECTED,
+    BOOT_FIRST_PUBLISH,
+    BOOT_PHASES
+};
+
+class WSMBootSequence {
+    public:
+        WSMBootSequence() { begin(0); }
+
+        // Initialization: setup() entered at now
+        void begin(system_tick_t now);
+
+        // loop() sampled the inputs; true the first time
+        bool sampled(system_tick_t now);
+
+        // true once: on the first call after the first sample that finds the cloud connected, when
+        //  the restart is to be reported
+        bool cloudConnected(system_tick_t now, bool connected);
+
+        // the publish queue has sent the restart report
+        void published(system_tick_t now);
+
+        WSMBootPhase phase() const { return _phase; }   // the last phase reached
+        bool done() const { return _phase == BOOT_FIRST_PUBLISH; }
+        system_tick_t at(WSMBootPhase phase) const { return _at[phase]; }  // millis() when reached
+
+        // the times of the phases reached as JSON; false if it did not fit in size
+        bool write(char *json, size_t size) const;
+
+    private:
+        void reach(WSMBootPhase phase, system_tick_t now);
+
+        WSMBootPhase _phase;
+        system_tick_t _at[BOOT_PHASES];
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,33 @@
+/***************************************************************************************************/
+// WSMCycleCounter.cpp
+//  Pump cycles over the last 10 minutes, hour and day.  See WSMCycleCounter.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMCycleCounter.h>
+
+void WSMCycleCounter::begin() {
+    _tenMinutes.begin();
+    _hour.begin();
+    _day.begin();
+}
+
+void WSMCycleCounter::add(time_t now) {
+    _tenMinutes.add(now);
+    _hour.add(now);
+    _day.add(now);
+}
+
+unsigned int WSMCycleCounter::count(WSMCycleHorizon horizon, time_t now) {
+    switch(horizon) {
+        case CYCLES_10_MINUTES:
+            return _tenMinutes.count(now);
+        case CYCLES_HOUR:
+            return _hour.count(now);
+        default:
+            return _day.count(now);
+    }
+}   // end of count()
@@ -0,0 +1,107 @@
+#ifndef WSMCYCLECOUNTER_H_INCLUDE
+#define WSMCYCLECOUNTER_H_INCLUDE
+/***************************************************************************************************/
+// WSMCycleCounter.h
+//  Counts a pump's cycles over the last 10 minutes, hour and day, so that a pump that short cycles
+//  (a waterlogged bladder tank has the PP come on 40 times an hour, every run of a normal length)
+//  can be seen.  Each horizon is a ring of time buckets:
+//
+//      10 minutes      10 buckets of 1 minute
+//      1 hour          12 buckets of 5 minutes
+//      24 hours        24 buckets of 1 hour
+//
+//  A cycle adds one to the current bucket of each ring and to the ring's total.  As time moves
+//  into a new bucket, the oldest is taken off the total and cleared, so add() and count() are
+//  constant time (a jump of more than a ring's length clears it in one pass of its buckets).  A
+//  count is of the current bucket and the ones before it in the ring: the last 9 to 10 minutes,
+//  55 to 60 minutes or 23 to 24 hours.  Buckets are aligned to the clock (Time.now()); a clock that
+//  steps back counts into the current bucket.  The three rings take 92 bytes of counts.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+
+// events in the last BUCKETS buckets of BUCKET_SECONDS each
+template<unsigned int BUCKETS, unsigned int BUCKET_SECONDS> class WSMBucketRing {
+    public:
+        WSMBucketRing() { begin(); }
+
+        // Initialization: no events
+        void begin() {
+            for(unsigned int i = 0; i < BUCKETS; i++) {
+                _counts[i] = 0;
+            }
+            _bucket = 0;
+            _head = 0;
+            _total = 0;
+        }
+
+        void add(time_t now) {
+            advance(now);
+            if(_counts[_head] < 0xFFFF) {
+                _counts[_head]++;
+                _total++;
+            }
+        }
+
+        unsigned int count(time_t now) {
+            advance(now);
+            return _total;
+        }
+
+    private:
+        // move the head to now's bucket, clearing the buckets passed over
+        void advance(time_t now) {
+            uint32_t bucket = (uint32_t)(now / BUCKET_SECONDS);
+            if(bucket <= _bucket) {
+                return;     // the same bucket, or the clock stepped back
+            }
+            if(bucket - _bucket >= BUCKETS) {
+                for(unsigned int i = 0; i < BUCKETS; i++) {
+                    _counts[i] = 0;
+                }
+                _total = 0;
+            } else {
+                for(uint32_t step = _bucket; step < bucket; step++) {
+                    _head = _head + 1 < BUCKETS ? _head + 1 : 0;
+                    _total -= _counts[_head];
+                    _counts[_head] = 0;
+                }
+            }
+            _bucket = bucket;
+        }
+
+        uint16_t _counts[BUCKETS];
+        uint32_t _bucket;       // the clock's bucket number of _counts[_head]
+        uint32_t _total;        // the sum of _counts
+        unsigned int _head;     // the index of the current bucket in _counts
+};
+
+// the horizons
+enum WSMCycleHorizon {
+    CYCLES_10_MINUTES,
+    CYCLES_HOUR,
+    CYCLES_DAY
+};
+
+class WSMCycleCounter {
+    public:
+        // Initialization: no cycles
+        void begin();
+
+        // a cycle started at now (Time.now())
+        void add(time_t now);
+
+        // the cycles in the horizon up to now
+        unsigned int count(WSMCycleHorizon horizon, time_t now);
+
+    private:
+        WSMBucketRing<10, 60> _tenMinutes;
+        WSMBucketRing<12, 300> _hour;
+        WSMBucketRing<24, 3600> _day;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,63 @@
+/***************************************************************************************************/
+// WSMDebouncer.cpp
+//  Table driven debouncing of polled input pins.  See WSMDebouncer.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMDebouncer.h>
+
+// the lowest set bit of a non-zero mask
+static inline unsigned int lowestBit(WSMChannelMask mask) {
+    return (unsigned int)__builtin_ctzll(mask);
+}
+
+WSMDebouncer::WSMDebouncer(const WSMDebounceChannel *channels, unsigned int count) :
+    _count(count > DEBOUNCE_MAX_CHANNELS ? DEBOUNCE_MAX_CHANNELS : count),
+    _initial(0) {
+    for(unsigned int i = 0; i < _count; i++) {
+        _pin[i] = channels[i].pin;
+        _debounceMs[i] = channels[i].debounceMs;
+        if(channels[i].value) {
+            _initial |= bit(i);
+        }
+    }
+    begin();
+}
+
+void WSMDebouncer::begin() {
+    _raw = _initial;
+    _values = _initial;
+    for(unsigned int i = 0; i < _count; i++) {
+        _beginTime[i] = 0;
+    }
+}
+
+WSMChannelMask WSMDebouncer::sample() {
+    system_tick_t now = millis();
+
+    WSMChannelMask raw = 0;
+    for(unsigned int i = 0; i < _count; i++) {
+        raw |= (WSMChannelMask)(digitalRead(_pin[i]) != 0) << i;
+    }
+
+    // pins that moved since the last pass start their timers again
+    WSMChannelMask moved = raw ^ _raw;
+    _raw = raw;
+    for(WSMChannelMask m = moved; m != 0; m &= m - 1) {
+        _beginTime[lowestBit(m)] = now;
+    }
+
+    // pins that held a level other than their value: a change once they have held it long enough
+    WSMChannelMask changed = 0;
+    for(WSMChannelMask m = (raw ^ _values) & ~moved; m != 0; m &= m - 1) {
+        unsigned int i = lowestBit(m);
+        if(now - _beginTime[i] > _debounceMs[i]) {
+            changed |= bit(i);
+        }
+    }
+    _values ^= changed;
+    return changed;
+}   // end of sample()
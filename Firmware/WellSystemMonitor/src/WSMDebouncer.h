@@ -0,0 +1,69 @@
+#ifndef WSMDEBOUNCER_H_INCLUDE
+#define WSMDEBOUNCER_H_INCLUDE
+/***************************************************************************************************/
+// WSMDebouncer.h
+//  Debounces any number of polled input pins (up to 64) in one pass.  The sketch describes its
+//  inputs in a table of channels; sample() reads every channel and returns a mask with a bit set
+//  for each channel whose debounced value changed, so a new input is a table entry and a test of
+//  its bit in loop():
+//
+//      const WSMDebounceChannel INPUTS[] = {{BUTTON_PIN, false, 100}, {FLOAT_PIN, true, 500}};
+//      WSMDebouncer inputs(INPUTS, 2);
+//      ...
+//      WSMChannelMask changed = inputs.sample();
+//      if(changed & WSMDebouncer::bit(1)) { ... inputs.value(1) ... }
+//
+//  A channel's value changes when its pin has read the other level on every pass for longer than
+//  its debounce delay, exactly as readPinDebounced() did.  The state is kept as arrays per field
+//  rather than a structure per pin: the raw and debounced levels of all channels are two bit
+//  masks, so one XOR finds the pins that moved since the last pass and another the channels whose
+//  level differs from their value; only those channels' timers are looked at.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+
+// the most channels a debouncer has
+const unsigned int DEBOUNCE_MAX_CHANNELS = 64;
+
+// one bit per channel, channel 0 in the lowest bit
+typedef uint64_t WSMChannelMask;
+
+// a table entry
+struct WSMDebounceChannel {
+    uint16_t pin;
+    bool value;                 // the debounced value assumed before the first sample()
+    system_tick_t debounceMs;   // the pin must hold a new level longer than this to count
+};
+
+class WSMDebouncer {
+    public:
+        // channels past DEBOUNCE_MAX_CHANNELS are ignored; the table is copied
+        WSMDebouncer(const WSMDebounceChannel *channels, unsigned int count);
+
+        // Initialization: every channel back to its table value
+        void begin();
+
+        // read every channel; the channels whose debounced value changed
+        WSMChannelMask sample();
+
+        bool value(unsigned int channel) const { return (_values >> channel) & 1; }
+        WSMChannelMask values() const { return _values; }  // all debounced values
+        unsigned int channels() const { return _count; }
+
+        static WSMChannelMask bit(unsigned int channel) { return (WSMChannelMask)1 << channel; }
+
+    private:
+        unsigned int _count;
+        uint16_t _pin[DEBOUNCE_MAX_CHANNELS];
+        system_tick_t _debounceMs[DEBOUNCE_MAX_CHANNELS];
+        system_tick_t _beginTime[DEBOUNCE_MAX_CHANNELS];   // millis() when the pin last moved
+        WSMChannelMask _initial;    // table values
+        WSMChannelMask _raw;        // the levels read on the last pass
+        WSMChannelMask _values;     // the debounced values
+};
+
+#endif  // end of header duplication prevention
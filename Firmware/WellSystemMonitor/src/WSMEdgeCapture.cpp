@@ -0,0 +1,127 @@
+/***************************************************************************************************/
+// WSMEdgeCapture.cpp
+//  Interrupt driven capture of a relay contact input.  See WSMEdgeCapture.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMEdgeCapture.h>
+
+WSMEdgeCapture::WSMEdgeCapture(uint16_t pin, bool value, system_tick_t debounceMs) :
+    _pin(pin),
+    _initialValue(value),
+    _debounceMicros(debounceMs * 1000),
+    _handler(NULL) {
+    // follow convention and put all initializations in begin() method
+}
+
+void WSMEdgeCapture::begin(wiring_interrupt_handler_t handler) {
+    _head.store(0);
+    _tail.store(0);
+    _edges.store(0);
+    _overruns.store(0);
+
+    _value = _initialValue;
+    _rawLevel = _initialValue ? HIGH : LOW;
+    _rawMicros = micros();
+    _inBounce = false;
+    _bounceMicros = _rawMicros;
+    _changeMillis = millis();
+    _resyncs = 0;
+
+    _handler = handler;
+    attach();
+}
+
+bool WSMEdgeCapture::attach() {
+    return _handler != NULL && attachInterrupt(_pin, _handler, CHANGE);
+}
+
+void WSMEdgeCapture::capture() {
+    WSMEdge edge;
+    edge.micros = micros();
+    edge.level = pinReadFast(_pin) ? HIGH : LOW;
+    _edges.fetch_add(1, std::memory_order_relaxed);
+
+    unsigned int head = _head.load(std::memory_order_relaxed);
+    if(head - _tail.load(std::memory_order_acquire) >= EDGE_CAPTURE_SIZE) {
+        _overruns.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    _ring[head & (EDGE_CAPTURE_SIZE - 1)] = edge;
+    _head.store(head + 1, std::memory_order_release);
+}   // end of capture()
+
+bool WSMEdgeCapture::changed() {
+    uint32_t nowMicros = micros();
+    bool resynced = false;
+
+    while(true) {
+        WSMEdge edge;
+        bool haveEdge = false;
+        bool fromRing = false;
+        unsigned int tail = _tail.load(std::memory_order_relaxed);
+        if(tail != _head.load(std::memory_order_acquire)) {
+            edge = _ring[tail & (EDGE_CAPTURE_SIZE - 1)];
+            haveEdge = true;
+            fromRing = true;
+        } else if(!resynced) {
+            // the ring is empty: the pin should be at the level of the last edge
+            resynced = true;
+            uint8_t level = pinReadFast(_pin) ? HIGH : LOW;
+            if(level != _rawLevel) {
+                edge.micros = micros();
+                edge.level = level;
+                haveEdge = true;
+                _resyncs++;
+            }
+        }
+
+        // the level before this edge (or up to now) may have lasted long enough to count; if so
+        // the edge stays in the ring for the next call
+        if(settle(haveEdge ? edge.micros : nowMicros)) {
+            return true;
+        }
+        if(!haveEdge) {
+            return false;
+        }
+        apply(edge);
+        if(fromRing) {
+            _tail.store(tail + 1, std::memory_order_release);
+        }
+    }
+}   // end of changed()
+
+// Private methods
+
+// take an edge into the raw level
+void WSMEdgeCapture::apply(const WSMEdge &edge) {
+    if(edge.level == _rawLevel) {
+        return;     // the pin bounced back before the interrupt read it
+    }
+    _rawLevel = edge.level;
+    _rawMicros = edge.micros;
+    if(_rawLevel != (_value ? HIGH : LOW) && !_inBounce) {
+        _inBounce = true;
+        _bounceMicros = edge.micros;
+    }
+}   // end of apply()
+
+// the raw level has been steady from _rawMicros to untilMicros; true if that makes a change
+bool WSMEdgeCapture::settle(uint32_t untilMicros) {
+    if((int32_t)(untilMicros - _rawMicros) < (int32_t)_debounceMicros) {
+        return false;   // (an edge the interrupt timed just before a level read by changed())
+    }
+    _inBounce = false;
+    bool level = _rawLevel == HIGH;
+    if(level == _value) {
+        return false;   // back where it was: the bounce was a glitch
+    }
+    _value = level;
+
+    // millis() at the first edge of the bounce
+    _changeMillis = millis() - (micros() - _bounceMicros) / 1000;
+    return true;
+}   // end of settle()
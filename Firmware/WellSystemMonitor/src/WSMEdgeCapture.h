@@ -0,0 +1,97 @@
+#ifndef WSMEDGECAPTURE_H_INCLUDE
+#define WSMEDGECAPTURE_H_INCLUDE
+/***************************************************************************************************/
+// WSMEdgeCapture.h
+//  Interrupt driven capture of a relay contact input.  Polling the pump sensor pins once a loop()
+//  pass timestamps a change only as closely as loop() comes round, and a pass that blocks (a
+//  publish, a DHT11 read) moves it later still.  Here a CHANGE interrupt records every raw edge,
+//  with its micros() time and the pin level, in a small ring, and changed() debounces in loop()
+//  from the recorded edge times instead of from when it happens to look:
+//
+//      - a new level counts once the pin has stayed at it for debounceMs, as readPinDebounced() had
+//      - the change is timestamped at the first edge of the bounce that led to it, the moment the
+//        contact actually moved, so that a pump's run time is the relay closure interval to the
+//        millisecond whenever loop() gets round to it
+//
+//  The ring is a single producer (the interrupt), single consumer (loop()) queue: capture() only
+//  writes the head and changed() only writes the tail, so neither needs to turn interrupts off.
+//  An edge that finds the ring full is counted as an overrun and dropped.  After each pass through
+//  the ring changed() reads the pin, and a level the edges do not account for (edges dropped, or
+//  missed while the interrupt was not attached) is taken as an edge at that moment; without the
+//  interrupt at all this is the polled debouncer it replaces.
+//
+//  On the Photon pins share EXTI lines (D2, A0 and A3 are one), and the PietteTech_DHT library
+//  attaches D2 for each reading; attach() is called again after a reading to take the line back.
+//
+//  changed() must be called at least every half an hour: the micros() timestamps wrap after 71
+//  minutes.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+#include <atomic>
+
+// edges the ring holds; a power of two
+const unsigned int EDGE_CAPTURE_SIZE = 32;
+
+// a raw edge as the interrupt saw it
+struct WSMEdge {
+    uint32_t micros;    // micros() at the interrupt
+    uint8_t level;      // the pin level read in the interrupt
+};
+
+class WSMEdgeCapture {
+    public:
+        // value is the debounced level assumed at begin(), before the pin has been read
+        WSMEdgeCapture(uint16_t pin, bool value, system_tick_t debounceMs);
+
+        // Initialization: attaches handler, which must call capture(), to the pin
+        void begin(wiring_interrupt_handler_t handler);
+
+        // attach the handler again, after another pin on the EXTI line has had it; false if the
+        // pin has no interrupt, in which case the pin is polled
+        bool attach();
+
+        // record an edge; call from the pin's interrupt handler only
+        void capture();
+
+        // debounce the recorded edges; true when the debounced level has changed, which may be
+        // more than once per call (call until false)
+        bool changed();
+
+        bool value() const { return _value; }                       // the debounced level
+        system_tick_t changeMillis() const { return _changeMillis; } // millis() at the last change
+
+        // counters since begin()
+        unsigned int get_edges() const { return _edges.load(std::memory_order_relaxed); }
+        unsigned int get_overruns() const { return _overruns.load(std::memory_order_relaxed); }
+        unsigned int get_resyncs() const { return _resyncs; }   // levels found by reading the pin
+
+    private:
+        void apply(const WSMEdge &edge);
+        bool settle(uint32_t untilMicros);
+
+        const uint16_t _pin;
+        const bool _initialValue;
+        const uint32_t _debounceMicros;
+        wiring_interrupt_handler_t _handler;
+
+        WSMEdge _ring[EDGE_CAPTURE_SIZE];
+        std::atomic<unsigned int> _head;    // edges written; only capture() changes it
+        std::atomic<unsigned int> _tail;    // edges taken out; only changed() changes it
+        std::atomic<unsigned int> _edges;
+        std::atomic<unsigned int> _overruns;
+
+        bool _value;                // the debounced level
+        uint8_t _rawLevel;          // the level after the last edge taken out
+        uint32_t _rawMicros;        // when the pin went to it
+        bool _inBounce;             // the pin has left _value since it was last stable at it
+        uint32_t _bounceMicros;     // the first edge away from _value
+        system_tick_t _changeMillis;
+        unsigned int _resyncs;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,225 @@
+/***************************************************************************************************/
+// WSMEventJournal.cpp
+//  EEPROM journal of wsmEvent* events.  See WSMEventJournal.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMEventJournal.h>
+#include <TPPUtils.h>
+#include <string.h>
+
+static const uint8_t TAG_EMPTY = 0xFF;
+static const uint8_t TAG_PENDING = 0x80;
+static const uint8_t TAG_ALERT = 0x40;
+static const uint8_t TAG_KIND = 0x3F;
+
+// the CRC of a record: the tag without the pending bit, the sequence number and bytes 4-15
+static uint16_t recordCRC(const uint8_t *bytes) {
+    uint8_t header[2] = {(uint8_t)(bytes[0] & ~TAG_PENDING), bytes[1]};
+    return crc16(crc16(0xFFFF, header, sizeof(header)), bytes + 4, JOURNAL_RECORD_SIZE - 4);
+}
+
+static void put32(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+WSMEventJournal::WSMEventJournal(int eepromAddress, unsigned int numRecords, system_tick_t drainIntervalMs) :
+    _eepromAddress(eepromAddress),
+    _numRecords(numRecords < 2 ? 2 : (numRecords > JOURNAL_MAX_RECORDS ? JOURNAL_MAX_RECORDS : numRecords)),
+    _drainIntervalMs(drainIntervalMs) {
+    // follow convention and put all initializations in begin() method
+}
+
+void WSMEventJournal::begin() {
+    _head = 0;
+    _sequence = 0;
+    _tail = 0;
+    _pending = 0;
+    _sent = 0;
+    _lostSent = 0;
+    _tokens = JOURNAL_DRAIN_BURST;
+    _tokenMs = millis();
+
+    _appended = 0;
+    _drained = 0;
+    _dropped = 0;
+    _recovered = 0;
+    _corrupt = 0;
+
+    // the newest record: every valid sequence number is within _numRecords of it, so measured from
+    // any one of them, the newest is the furthest ahead
+    int newest = -1;
+    uint8_t reference = 0;
+    int ahead = 0;
+    for(unsigned int slot = 0; slot < _numRecords; slot++) {
+        WSMJournalRecord record;
+        uint8_t sequence;
+        bool drained;
+        if(!readSlot(slot, record, sequence, drained)) {
+            if(EEPROM.read(address(slot)) != TAG_EMPTY) {
+                _corrupt++;
+            }
+            continue;
+        }
+        if(newest < 0) {
+            reference = sequence;
+        }
+        int distance = (int8_t)(uint8_t)(sequence - reference);
+        if(newest < 0 || distance > ahead) {
+            newest = (int)slot;
+            ahead = distance;
+        }
+    }
+    if(newest < 0) {
+        return;     // empty
+    }
+    _head = ((unsigned int)newest + 1) % _numRecords;
+    _sequence = (uint8_t)(reference + ahead + 1);
+
+    // the undrained records run back from the newest
+    uint8_t expected = (uint8_t)(_sequence - 1);
+    unsigned int slot = (unsigned int)newest;
+    while(_pending < _numRecords) {
+        WSMJournalRecord record;
+        uint8_t sequence;
+        bool drained;
+        if(!readSlot(slot, record, sequence, drained) || drained || sequence != expected) {
+            break;
+        }
+        _pending++;
+        _tail = slot;
+        expected--;
+        slot = (slot + _numRecords - 1) % _numRecords;
+    }
+    if(_pending == 0) {
+        _tail = _head;
+    }
+    _recovered = _pending;
+}   // end of begin()
+
+bool WSMEventJournal::append(const WSMJournalRecord &record) {
+    bool kept = true;
+    if(_pending == _numRecords) {
+        // full: the oldest undrained record makes way
+        _tail = (_tail + 1) % _numRecords;
+        _pending--;
+        _dropped++;
+        if(_sent > 0) {
+            _sent--;
+            _lostSent++;
+        }
+        kept = false;
+    }
+
+    uint8_t bytes[JOURNAL_RECORD_SIZE];
+    bytes[0] = (uint8_t)(TAG_PENDING | (record.alert ? TAG_ALERT : 0) | (record.kind & TAG_KIND));
+    bytes[1] = _sequence;
+    put32(bytes + 4, record.etime);
+    memcpy(bytes + 8, &record.value1, 4);
+    memcpy(bytes + 12, &record.value2, 4);
+    uint16_t crc = recordCRC(bytes);
+    bytes[2] = (uint8_t)crc;
+    bytes[3] = (uint8_t)(crc >> 8);
+
+    // empty tag, record, then the tag: a record cut short reads as empty or fails its CRC
+    int at = address(_head);
+    uint8_t body[JOURNAL_RECORD_SIZE - 1];
+    memcpy(body, bytes + 1, sizeof(body));
+    EEPROM.write(at, TAG_EMPTY);
+    EEPROM.put(at + 1, body);
+    EEPROM.write(at, bytes[0]);
+
+    if(_pending == 0) {
+        _tail = _head;
+    }
+    _head = (_head + 1) % _numRecords;
+    _sequence++;
+    _pending++;
+    _appended++;
+    return kept;
+}   // end of append()
+
+bool WSMEventJournal::next(WSMJournalRecord &record) {
+    if(msUntilNext() != 0) {
+        return false;
+    }
+    uint8_t sequence;
+    bool drained;
+    readSlot((_tail + _sent) % _numRecords, record, sequence, drained);
+    _sent++;
+    _tokens--;
+    return true;
+}   // end of next()
+
+void WSMEventJournal::confirm(unsigned int count) {
+    unsigned int lost = count < _lostSent ? count : _lostSent;
+    _lostSent -= lost;
+    count -= lost;
+    while(count > 0 && _sent > 0) {
+        int at = address(_tail);
+        EEPROM.write(at, (uint8_t)(EEPROM.read(at) & ~TAG_PENDING));
+        _tail = (_tail + 1) % _numRecords;
+        _pending--;
+        _sent--;
+        _drained++;
+        count--;
+    }
+}   // end of confirm()
+
+system_tick_t WSMEventJournal::msUntilNext() {
+    if(_sent >= _pending) {
+        return 0xFFFFFFFF;
+    }
+    refill();
+    if(_tokens > 0) {
+        return 0;
+    }
+    system_tick_t elapsed = millis() - _tokenMs;
+    return elapsed >= _drainIntervalMs ? 0 : _drainIntervalMs - elapsed;
+}   // end of msUntilNext()
+
+// Private methods
+
+// add a token per drain interval since the last one, up to a full burst
+void WSMEventJournal::refill() {
+    system_tick_t now = millis();
+    if(_tokens >= JOURNAL_DRAIN_BURST || _drainIntervalMs == 0) {
+        _tokens = JOURNAL_DRAIN_BURST;
+        _tokenMs = now;     // a full bucket starts counting again from now
+        return;
+    }
+    system_tick_t added = (now - _tokenMs) / _drainIntervalMs;
+    if(added > 0) {
+        _tokens = _tokens + added >= JOURNAL_DRAIN_BURST ? JOURNAL_DRAIN_BURST : _tokens + added;
+        _tokenMs += added * _drainIntervalMs;
+    }
+}   // end of refill()
+
+// decode one record; false if it is empty or damaged
+bool WSMEventJournal::readSlot(unsigned int slot, WSMJournalRecord &record, uint8_t &sequence, bool &drained) const {
+    uint8_t bytes[JOURNAL_RECORD_SIZE];
+    EEPROM.get(address(slot), bytes);
+    uint8_t kind = bytes[0] & TAG_KIND;
+    if(bytes[0] == TAG_EMPTY || kind < JOURNAL_TRH || kind > JOURNAL_WP_OFF ||
+       recordCRC(bytes) != (uint16_t)(bytes[2] | (bytes[3] << 8))) {
+        return false;
+    }
+    record.kind = kind;
+    record.alert = (bytes[0] & TAG_ALERT) != 0;
+    record.etime = get32(bytes + 4);
+    memcpy(&record.value1, bytes + 8, 4);
+    memcpy(&record.value2, bytes + 12, 4);
+    sequence = bytes[1];
+    drained = (bytes[0] & TAG_PENDING) == 0;
+    return true;
+}   // end of readSlot()
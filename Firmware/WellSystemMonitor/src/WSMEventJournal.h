@@ -0,0 +1,114 @@
+#ifndef WSMEVENTJOURNAL_H_INCLUDE
+#define WSMEVENTJOURNAL_H_INCLUDE
+/***************************************************************************************************/
+// WSMEventJournal.h
+//  A fixed size, append only journal of wsmEvent* events in EEPROM, so that the events of a cloud
+//  outage, or of one that is cut short by a reset or a power loss, are published once the cloud is
+//  back.  Events are appended as they happen and taken out in order by next(), in bursts of up to
+//  JOURNAL_DRAIN_BURST and then one per drain interval, so a backlog goes out no faster than the
+//  cloud takes it; confirm() marks them drained once they have been published.
+//
+//  The journal is a ring of 16 byte records:
+//
+//      0     tag: 0xFF empty, 0x80 | alert 0x40 | kind pending, the same without 0x80 drained
+//      1     sequence number, one more than the previous record's (mod 256)
+//      2-3   CRC-16/CCITT of bytes 1 and 4-15 and the tag without 0x80
+//      4-7   etime
+//      8-11  value1 (float): TRH temperature, or pump run time in minutes
+//      12-15 value2 (float): TRH humidity
+//
+//  There are no head or tail pointers in EEPROM: every append writes the next record of the ring,
+//  so the writes are spread evenly over it, and begin() finds the newest record from the sequence
+//  numbers and the oldest undrained one by walking back from there.  An append writes the tag as
+//  empty, then the record, then the pending tag, so a record cut short by a power loss fails its
+//  CRC and is skipped.  Drained only clears the top bit of the tag.  When the ring is full of
+//  undrained records, the oldest one is overwritten and counted as dropped.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+
+// the events in the journal
+enum WSMJournalKind {
+    JOURNAL_TRH = 1,
+    JOURNAL_PP_ON,
+    JOURNAL_PP_OFF,
+    JOURNAL_WP_ON,
+    JOURNAL_WP_OFF
+};
+
+struct WSMJournalRecord {
+    uint8_t kind;       // WSMJournalKind
+    bool alert;         // the event raised an alert
+    uint32_t etime;     // Time.now() when the event happened
+    float value1;       // TRH temperature, or pump run time in minutes
+    float value2;       // TRH humidity
+};
+
+// EEPROM bytes per record
+const int JOURNAL_RECORD_SIZE = 16;
+
+// the sequence numbers order at most this many records
+const unsigned int JOURNAL_MAX_RECORDS = 128;
+
+// next() returns up to this many events at once, then one per drain interval
+const unsigned int JOURNAL_DRAIN_BURST = 4;
+
+class WSMEventJournal {
+    public:
+        // the journal takes numRecords * JOURNAL_RECORD_SIZE bytes of EEPROM from eepromAddress
+        WSMEventJournal(int eepromAddress, unsigned int numRecords, system_tick_t drainIntervalMs);
+
+        // Initialization: recovers the journal from EEPROM
+        void begin();
+
+        // journal an event; false if the oldest undrained event had to be overwritten for it
+        bool append(const WSMJournalRecord &record);
+
+        // the oldest event not yet taken out; false if there is none or the drain rate has been
+        // used up
+        bool next(WSMJournalRecord &record);
+
+        // the oldest count events taken out by next() have been published (or given up on)
+        void confirm(unsigned int count);
+
+        unsigned int pending() const { return _pending; }           // not drained yet
+        unsigned int unsent() const { return _pending - _sent; }    // not taken out by next() yet
+        system_tick_t msUntilNext();    // until next() can return an event; 0xFFFFFFFF if none
+
+        // counters since begin()
+        unsigned int get_appended() const { return _appended; }
+        unsigned int get_drained() const { return _drained; }
+        unsigned int get_dropped() const { return _dropped; }
+        unsigned int get_recovered() const { return _recovered; }   // undrained events found by begin()
+        unsigned int get_corrupt() const { return _corrupt; }       // records begin() found damaged
+
+    private:
+        int address(unsigned int slot) const { return _eepromAddress + (int)slot * JOURNAL_RECORD_SIZE; }
+        bool readSlot(unsigned int slot, WSMJournalRecord &record, uint8_t &sequence, bool &drained) const;
+        void refill();
+
+        const int _eepromAddress;
+        const unsigned int _numRecords;
+        const system_tick_t _drainIntervalMs;
+
+        unsigned int _head;         // the slot the next append writes
+        uint8_t _sequence;          // the sequence number it gets
+        unsigned int _tail;         // the slot of the oldest undrained event
+        unsigned int _pending;      // undrained events from _tail
+        unsigned int _sent;         // of those, taken out by next()
+        unsigned int _lostSent;     // taken out by next(), then overwritten before confirm()
+        unsigned int _tokens;       // events next() can return right away
+        system_tick_t _tokenMs;     // millis() when the last token was added
+
+        unsigned int _appended;
+        unsigned int _drained;
+        unsigned int _dropped;
+        unsigned int _recovered;
+        unsigned int _corrupt;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,147 @@
+/***************************************************************************************************/
+// WSMEventPack.cpp
+//  Compact uplink encoding of wsmEvent* events.  See WSMEventPack.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMEventPack.h>
+#include <JSONWriter.h>
+#include <math.h>
+#include <string.h>
+
+static const char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// the most bytes one event takes: kind, etime delta and two 5 byte varints
+static const size_t MAX_EVENT_SIZE = 16;
+
+static size_t putVarint(uint8_t *p, uint32_t value) {
+    size_t length = 0;
+    while(value >= 0x80) {
+        p[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p[length++] = (uint8_t)value;
+    return length;
+}
+
+static uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+// a value in hundredths, limited to what fits in an int32_t
+static int32_t hundredths(float value) {
+    float scaled = roundf(value * 100.0f);
+    if(!(scaled > -2.0e9f)) {   // also catches NaN
+        return -2000000000;
+    }
+    return scaled < 2.0e9f ? (int32_t)scaled : 2000000000;
+}
+
+WSMEventPack::WSMEventPack() : _length(0), _count(0), _lastEtime(0) {
+    // clear() starts a pack; it reads the time zone, which is not set up yet during construction
+}
+
+void WSMEventPack::clear() {
+    _bytes[0] = EVENT_PACK_VERSION;
+    _bytes[1] = (uint8_t)(int8_t)lroundf(Time.zone() * 4.0f);
+    _length = 2;
+    _count = 0;
+    _lastEtime = 0;
+}   // end of clear()
+
+bool WSMEventPack::add(const WSMJournalRecord &record) {
+    uint8_t event[MAX_EVENT_SIZE];
+    size_t length = 0;
+    event[length++] = (uint8_t)(record.kind | (record.alert ? EVENT_PACK_ALERT : 0));
+    length += putVarint(event + length, zigzag((int32_t)(record.etime - _lastEtime)));
+    switch(record.kind) {
+        case JOURNAL_TRH:
+            length += putVarint(event + length, zigzag(hundredths(record.value1)));
+            length += putVarint(event + length, zigzag(hundredths(record.value2)));
+            break;
+        case JOURNAL_PP_OFF:
+        case JOURNAL_WP_OFF: {
+            // the sketch's run time is milliseconds / 60000: keep the milliseconds
+            double ms = record.value1 > 0.0f ? floor(record.value1 * 60000.0 + 0.5) : 0.0;
+            length += putVarint(event + length, ms < 4294967295.0 ? (uint32_t)ms : 0xFFFFFFFF);
+            break;
+        }
+        default:
+            break;
+    }
+
+    if(_length + length > EVENT_PACK_SIZE) {
+        return false;
+    }
+    memcpy(_bytes + _length, event, length);
+    _length += length;
+    _count++;
+    _lastEtime = record.etime;
+    return true;
+}   // end of add()
+
+size_t WSMEventPack::encode(char *text, size_t size) const {
+    size_t textLength = (_length + 2) / 3 * 4;
+    if(size <= textLength) {
+        if(size > 0) {
+            text[0] = '\0';
+        }
+        return 0;
+    }
+    char *p = text;
+    for(size_t i = 0; i < _length; i += 3) {
+        uint32_t group = (uint32_t)_bytes[i] << 16;
+        if(i + 1 < _length) {
+            group |= (uint32_t)_bytes[i + 1] << 8;
+        }
+        if(i + 2 < _length) {
+            group |= _bytes[i + 2];
+        }
+        *p++ = BASE64[(group >> 18) & 0x3F];
+        *p++ = BASE64[(group >> 12) & 0x3F];
+        *p++ = i + 1 < _length ? BASE64[(group >> 6) & 0x3F] : '=';
+        *p++ = i + 2 < _length ? BASE64[group & 0x3F] : '=';
+    }
+    *p = '\0';
+    return textLength;
+}   // end of encode()
+
+const char *WSMEventPack::eventJSON(const WSMJournalRecord &record, float zone, char *json, size_t size) {
+    char timeString[TIME_STRING_SIZE];
+    const char *eventName;
+
+    // the local time of the event, as Time.local() was when it happened
+    JSONWriter::formatTime(timeString, (time_t)record.etime + (time_t)(zone * 3600));
+    JSONWriter writer(json, size);
+    writer.key("etime", (time_t)record.etime);
+
+    switch(record.kind) {
+        case JOURNAL_TRH:
+            eventName = "wsmEventTRH";
+            writer.key("temp", record.value1, 6);
+            writer.key("rh", record.value2, 6);
+            break;
+        case JOURNAL_PP_ON:
+        case JOURNAL_PP_OFF:
+            eventName = "wsmEventPPstatus";
+            writer.key("pp", record.kind == JOURNAL_PP_ON ? 1 : 0);
+            if(record.kind == JOURNAL_PP_OFF) {
+                writer.key("ppon", record.value1, 6);
+            }
+            break;
+        default:
+            eventName = "wsmEventWPstatus";
+            writer.key("wp", record.kind == JOURNAL_WP_ON ? 1 : 0);
+            if(record.kind == JOURNAL_WP_OFF) {
+                writer.key("wpon", record.value1, 6);
+            }
+            break;
+    }
+    writer.key("loctime", timeString);
+    writer.end();
+
+    return eventName;
+}   // end of eventJSON()
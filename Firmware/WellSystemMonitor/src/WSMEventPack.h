@@ -0,0 +1,70 @@
+#ifndef WSMEVENTPACK_H_INCLUDE
+#define WSMEVENTPACK_H_INCLUDE
+/***************************************************************************************************/
+// WSMEventPack.h
+//  The compact uplink encoding of wsmEvent* events.  The JSON events repeat "etime", a formatted
+//  "loctime" and their run times as decimal text; a pack carries the same information in a few
+//  bytes per event and is published, base64 encoded, as wsmEventPack.  The wsmWriteData script and
+//  the host decoder (host/uplink/WSMPackDecoder.h) turn it back into the JSON events.
+//
+//  Version 1, after base64 decoding:
+//
+//      byte     version (1)
+//      byte     time zone, in quarter hours (signed)
+//      then for each event:
+//      byte     kind (WSMJournalKind), | 0x80 if the event raised an alert
+//      varint   etime minus the previous event's etime (0 before the first), zigzag encoded
+//      varint   wsmEventTRH: temperature in hundredths, zigzag encoded
+//      varint   wsmEventTRH: humidity in hundredths, zigzag encoded
+//      varint   PP or WP off: run time in milliseconds
+//
+//  A varint is 7 bits a byte, least significant first, with the top bit set on all but the last
+//  byte; zigzag encoding maps 0, -1, 1, -2 ... to 0, 1, 2, 3 ...  A pump off event takes about 7
+//  bytes against 98 as a JSON batch item, and a pack holds 465 bytes, which is 620 in base64.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+#include "WSMEventJournal.h"
+
+// the event name packs are published under
+const char EVENT_PACK_NAME[] = "wsmEventPack";
+
+const uint8_t EVENT_PACK_VERSION = 1;
+const uint8_t EVENT_PACK_ALERT = 0x80;     // in the kind byte
+
+// the most bytes in a pack: base64 encoded, it stays within the 622 byte publish limit
+const size_t EVENT_PACK_SIZE = 465;
+
+class WSMEventPack {
+    public:
+        WSMEventPack();
+
+        // start an empty pack, in the current time zone; call before the first add()
+        void clear();
+
+        // add an event; false, and the pack is unchanged, if it does not fit
+        bool add(const WSMJournalRecord &record);
+
+        unsigned int count() const { return _count; }      // events in the pack
+        size_t size() const { return _length; }             // bytes, before base64
+        const uint8_t *bytes() const { return _bytes; }
+
+        // the pack in base64, terminated; returns the length, or 0 if text is too small
+        size_t encode(char *text, size_t size) const;
+
+        // the data of an event as it is published on its own, for a time zone of zone hours;
+        // returns the event name
+        static const char *eventJSON(const WSMJournalRecord &record, float zone, char *json, size_t size);
+
+    private:
+        uint8_t _bytes[EVENT_PACK_SIZE];
+        size_t _length;
+        unsigned int _count;
+        uint32_t _lastEtime;        // etime of the last event added
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,123 @@
+/***************************************************************************************************/
+// WSMLoopProfiler.cpp
+//  Stage times of loop().  See WSMLoopProfiler.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMLoopProfiler.h>
+#include <JSONWriter.h>
+
+WSMLoopProfiler::WSMLoopProfiler(const char *const *stageNames, unsigned int stages)
+    : _names(stageNames), _stages(stages < PROFILE_MAX_STAGES ? stages : PROFILE_MAX_STAGES) {
+    begin();
+}
+
+void WSMLoopProfiler::begin() {
+    memset(_profiles, 0, sizeof(_profiles));
+    memset(&_pass, 0, sizeof(_pass));
+    memset(_lapMicros, 0, sizeof(_lapMicros));
+    _ticksPerMicro = System.ticksPerMicrosecond();
+    _maxStage = -1;
+    _passStart = _lapStart = System.ticks();
+}
+
+void WSMLoopProfiler::startPass() {
+    for(unsigned int i = 0; i < _stages; i++) {
+        _lapMicros[i] = 0;
+    }
+    _passStart = _lapStart = System.ticks();
+}
+
+void WSMLoopProfiler::lap(unsigned int stage) {
+    uint32_t now = System.ticks();
+    if(stage < _stages) {
+        uint32_t micros = (now - _lapStart) / _ticksPerMicro;
+        _lapMicros[stage] += micros;
+        count(_profiles[stage], micros);
+    }
+    _lapStart = now;
+}
+
+void WSMLoopProfiler::endPass() {
+    uint32_t micros = (System.ticks() - _passStart) / _ticksPerMicro;
+    if(count(_pass, micros)) {
+        // a new longest pass: which stage took most of it
+        _maxStage = 0;
+        for(unsigned int i = 1; i < _stages; i++) {
+            if(_lapMicros[i] > _lapMicros[_maxStage]) {
+                _maxStage = i;
+            }
+        }
+    }
+}
+
+int WSMLoopProfiler::find(const char *name) const {
+    for(unsigned int i = 0; i < _stages; i++) {
+        if(strcmp(name, _names[i]) == 0) {
+            return i;
+        }
+    }
+    return strcmp(name, "loop") == 0 ? (int)_stages : -1;
+}
+
+unsigned int WSMLoopProfiler::bucket(uint32_t micros) {
+    if(micros < 2) {
+        return 0;
+    }
+    unsigned int log2 = 31 - __builtin_clz(micros);
+    return log2 < PROFILE_BUCKETS ? log2 : PROFILE_BUCKETS - 1;
+}
+
+bool WSMLoopProfiler::writeSummary(char *json, size_t size) const {
+    JSONWriter writer(json, size);
+    writer.key("passes", (unsigned int)_pass.count);
+    writer.key("mean", (unsigned int)(_pass.count ? _pass.totalMicros / _pass.count : 0));
+    writer.key("max", (unsigned int)_pass.maxMicros);
+    writer.key("maxAt", (unsigned int)_pass.maxAt);
+    writer.key("maxStage", _maxStage < 0 ? "" : _names[_maxStage]);
+    for(unsigned int i = 0; i < _stages; i++) {
+        writer.key(_names[i], (unsigned int)_profiles[i].maxMicros);
+    }
+    writer.end();
+    return !writer.overflow();
+
+}   // end of writeSummary()
+
+bool WSMLoopProfiler::writeStage(unsigned int stage, char *json, size_t size) const {
+    if(stage > _stages) {
+        return false;
+    }
+    const WSMStageProfile &profile = stage == _stages ? _pass : _profiles[stage];
+    JSONWriter writer(json, size);
+    writer.key("stage", stage == _stages ? "loop" : _names[stage]);
+    writer.key("count", (unsigned int)profile.count);
+    writer.key("mean", (unsigned int)(profile.count ? profile.totalMicros / profile.count : 0));
+    writer.key("max", (unsigned int)profile.maxMicros);
+    writer.key("maxAt", (unsigned int)profile.maxAt);
+    for(unsigned int i = 0; i < PROFILE_BUCKETS; i++) {
+        if(profile.buckets[i] != 0) {
+            char name[12];
+            snprintf(name, sizeof(name), "%u", (unsigned int)bucketMicros(i));
+            writer.key(name, (unsigned int)profile.buckets[i]);
+        }
+    }
+    writer.end();
+    return !writer.overflow();
+
+}   // end of writeStage()
+
+// count a time; true if it is the profile's longest
+bool WSMLoopProfiler::count(WSMStageProfile &profile, uint32_t micros) {
+    profile.count++;
+    profile.totalMicros += micros;
+    profile.buckets[bucket(micros)]++;
+    if(micros > profile.maxMicros || profile.count == 1) {
+        profile.maxMicros = micros;
+        profile.maxAt = millis();
+        return true;
+    }
+    return false;
+}
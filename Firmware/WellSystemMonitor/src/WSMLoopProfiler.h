@@ -0,0 +1,103 @@
+#ifndef WSMLOOPPROFILER_H_INCLUDE
+#define WSMLOOPPROFILER_H_INCLUDE
+/***************************************************************************************************/
+// WSMLoopProfiler.h
+//  Times the stages of loop() with the cycle counter (System.ticks(), the DWT cycle counter on the
+//  Photon).  The sketch names its stages in a table and marks the end of each one; each mark is one
+//  read of the counter and the time since the last mark goes to the stage:
+//
+//      const char *const STAGES[] = {"inputs", "publish"};
+//      WSMLoopProfiler profiler(STAGES, 2);
+//      ...
+//      profiler.startPass();
+//      inputs.sample();
+//      profiler.lap(0);
+//      batcher.process();
+//      profiler.lap(1);
+//      profiler.endPass();
+//
+//  Every stage, and the whole pass, keeps a histogram of its times in log2 buckets of microseconds
+//  (bucket 0 holds 0 and 1 us, bucket k 2^k to 2^(k+1) - 1 us, the last bucket everything from 2^23
+//  us, about 8.4 s, up), its mean and its longest time, with millis() when it happened.  The longest
+//  pass also keeps the stage that took most of it.  The counter wraps after 2^32 ticks, 35.8 s on the
+//  Photon, so a longer stage is counted short.
+//
+//  writeSummary() gives the longest time of each stage:
+//      {"passes":52310,"mean":91,"max":2103411,"maxAt":86460213,"maxStage":"publish","dht":42,...}
+//  writeStage() one stage's histogram, a key for each bucket that is not empty, named for its
+//  shortest time in us:
+//      {"stage":"publish","count":52310,"mean":19,"max":2103391,"maxAt":86460213,"0":3020,"2":41377,...}
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+
+// the most stages a profiler has
+const unsigned int PROFILE_MAX_STAGES = 8;
+
+// histogram buckets per stage
+const unsigned int PROFILE_BUCKETS = 24;
+
+// the times of one stage, or of the whole pass
+struct WSMStageProfile {
+    uint32_t count;                     // times counted
+    uint64_t totalMicros;
+    uint32_t maxMicros;
+    system_tick_t maxAt;                // millis() at the end of the longest time
+    uint32_t buckets[PROFILE_BUCKETS];
+};
+
+class WSMLoopProfiler {
+    public:
+        // stages past PROFILE_MAX_STAGES are ignored; the names must stay valid
+        WSMLoopProfiler(const char *const *stageNames, unsigned int stages);
+
+        // Initialization, and to start counting over
+        void begin();
+
+        // at the top of loop()
+        void startPass();
+
+        // the end of a stage: the time since startPass() or the last lap() is the stage's
+        void lap(unsigned int stage);
+
+        // at the end of loop(): the time since startPass() is the pass's
+        void endPass();
+
+        unsigned int stages() const { return _stages; }
+        const char *name(unsigned int stage) const { return _names[stage]; }
+        const WSMStageProfile &stage(unsigned int stage) const { return _profiles[stage]; }
+        const WSMStageProfile &pass() const { return _pass; }
+        int maxStage() const { return _maxStage; }      // the stage that took most of the longest pass; -1 before a pass
+
+        // the stage of the given name, stages() for "loop" (the whole pass), or -1
+        int find(const char *name) const;
+
+        // the bucket of a time, and the shortest time in a bucket
+        static unsigned int bucket(uint32_t micros);
+        static uint32_t bucketMicros(unsigned int bucket) { return bucket == 0 ? 0 : (uint32_t)1 << bucket; }
+
+        // the longest time of each stage as JSON; false if it did not fit in size
+        bool writeSummary(char *json, size_t size) const;
+
+        // one stage's (stages() for the pass) histogram as JSON; false if it did not fit in size
+        bool writeStage(unsigned int stage, char *json, size_t size) const;
+
+    private:
+        bool count(WSMStageProfile &profile, uint32_t micros);    // true for a new longest time
+
+        const char *const *_names;
+        unsigned int _stages;
+        uint32_t _ticksPerMicro;
+        uint32_t _passStart;        // ticks at startPass()
+        uint32_t _lapStart;         // ticks at the last lap()
+        uint32_t _lapMicros[PROFILE_MAX_STAGES];    // this pass's stage times
+        int _maxStage;
+        WSMStageProfile _profiles[PROFILE_MAX_STAGES];
+        WSMStageProfile _pass;
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,235 @@
+/***************************************************************************************************/
+// WSMPublishBatcher.cpp
+//  Batches wsmEvent* payloads into fewer publications.  See WSMPublishBatcher.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMPublishBatcher.h>
+#include <JSONWriter.h>
+#include <string.h>
+
+static const char BATCH_PREFIX[] = "{\"events\":[";
+static const char BATCH_SUFFIX[] = "]}";
+static const char ITEM_PREFIX[] = "{\"ev\":\"";
+
+static const system_tick_t RETRY_MS = 1000;        // the publish budget is one a second
+static const system_tick_t ONE_HOUR_MS = 3600000;
+
+WSMPublishBatcher::WSMPublishBatcher(const char *batchEventName, system_tick_t maxAgeMs) :
+    _batchEventName(batchEventName), _maxAgeMs(maxAgeMs), _queue(NULL) {
+    // follow convention and put all initializations in begin() method
+}
+
+void WSMPublishBatcher::begin() {
+    _payload[0] = '\0';
+    _length = 0;
+    _packed = false;
+    _count = 0;
+    _oldestMs = 0;
+    _failedMs = 0;
+    _failed = false;
+
+    _events = 0;
+    _eventsPublished = 0;
+    _eventsDropped = 0;
+    _publishes = 0;
+    _publishFailures = 0;
+    _hourStartMs = millis();
+    _publishesThisHour = 0;
+    _publishesLastHour = 0;
+    _statsChanged = true;
+}   // end of begin()
+
+bool WSMPublishBatcher::add(const char *eventName, const char *eventData) {
+    _events++;
+    _statsChanged = true;
+
+    // the item is {"ev":"<eventName>" followed by the elements of eventData
+    size_t dataLength = strlen(eventData);
+    if(dataLength < 2 || eventData[0] != '{') {
+        _eventsDropped++;
+        return false;
+    }
+    const char *elements = eventData + 1;
+    size_t elementsLength = dataLength - 1;
+    bool empty = elements[0] == '}';
+    size_t nameLength = strlen(eventName);
+    size_t itemLength = sizeof(ITEM_PREFIX) - 1 + nameLength + 1 + (empty ? 0 : 1) + elementsLength;
+
+    if(sizeof(BATCH_PREFIX) - 1 + itemLength + sizeof(BATCH_SUFFIX) - 1 > PUBLISH_DATA_LIMIT) {
+        // too big to go in any batch: publish it on its own, in order
+        flush();
+        if(publish(eventName, eventData, 1)) {
+            _eventsPublished++;
+            return true;
+        }
+        _eventsDropped++;
+        return false;
+    }
+
+    if(_count > 0 && (_packed || _length + 1 + itemLength + sizeof(BATCH_SUFFIX) - 1 > PUBLISH_DATA_LIMIT)) {
+        makeRoom();
+    }
+
+    char *p;
+    if(_count == 0) {
+        memcpy(_payload, BATCH_PREFIX, sizeof(BATCH_PREFIX) - 1);
+        _length = sizeof(BATCH_PREFIX) - 1;
+        _packed = false;
+        _oldestMs = millis();
+        p = _payload + _length;
+    } else {
+        p = _payload + _length;
+        *p++ = ',';
+    }
+    memcpy(p, ITEM_PREFIX, sizeof(ITEM_PREFIX) - 1);
+    p += sizeof(ITEM_PREFIX) - 1;
+    memcpy(p, eventName, nameLength);
+    p += nameLength;
+    *p++ = '"';
+    if(!empty) {
+        *p++ = ',';
+    }
+    memcpy(p, elements, elementsLength);
+    p += elementsLength;
+    *p = '\0';
+    _length = p - _payload;
+    _count++;
+    return true;
+}   // end of add()
+
+bool WSMPublishBatcher::add(const WSMJournalRecord &record) {
+    // publish the batch to make way, but don't drop it: the caller keeps the event if it can't go
+    if(_count > 0 && (!_packed || !_pack.add(record)) && !flush()) {
+        return false;
+    }
+    _events++;
+    _statsChanged = true;
+    if(_count == 0) {
+        _pack.clear();
+        _packed = true;
+        _oldestMs = millis();
+        if(!_pack.add(record)) {
+            _eventsDropped++;   // can't happen: an empty pack takes any event
+            return false;
+        }
+    }
+    _count++;
+    return true;
+}   // end of add()
+
+bool WSMPublishBatcher::publishNow(const char *eventName, const char *eventData) {
+    _events++;
+    _statsChanged = true;
+    flush();
+    if(publish(eventName, eventData, 1)) {
+        _eventsPublished++;
+        return true;
+    }
+    _eventsDropped++;
+    return false;
+}   // end of publishNow()
+
+bool WSMPublishBatcher::flush() {
+    if(_count == 0) {
+        return true;
+    }
+    bool published;
+    if(_packed) {
+        _pack.encode(_payload, sizeof(_payload));
+        published = publish(EVENT_PACK_NAME, _payload, _count);
+    } else {
+        memcpy(_payload + _length, BATCH_SUFFIX, sizeof(BATCH_SUFFIX));
+        published = publish(_batchEventName, _payload, _count);
+        _payload[_length] = '\0';
+    }
+    if(!published) {
+        _failed = true;
+        _failedMs = millis();
+        return false;
+    }
+    _eventsPublished += _count;
+    _count = 0;
+    _length = 0;
+    _failed = false;
+    return true;
+}   // end of flush()
+
+void WSMPublishBatcher::process() {
+    system_tick_t now = millis();
+
+    // publishes per hour
+    system_tick_t elapsed = now - _hourStartMs;
+    if(elapsed >= ONE_HOUR_MS) {
+        _publishesLastHour = elapsed < 2 * ONE_HOUR_MS ? _publishesThisHour : 0;
+        _publishesThisHour = 0;
+        _hourStartMs = now - elapsed % ONE_HOUR_MS;
+        _statsChanged = true;
+    }
+
+    if(_count > 0 && msUntilDue() == 0) {
+        flush();
+    }
+}   // end of process()
+
+system_tick_t WSMPublishBatcher::msUntilDue() const {
+    if(_count == 0) {
+        return 0xFFFFFFFF;
+    }
+    system_tick_t start = _failed ? _failedMs : _oldestMs;
+    system_tick_t wait = _failed ? RETRY_MS : _maxAgeMs;
+    system_tick_t elapsed = millis() - start;   // unsigned arithmetic is right across the rollover
+    return elapsed >= wait ? 0 : wait - elapsed;
+}   // end of msUntilDue()
+
+void WSMPublishBatcher::writeStats(char *json, size_t size) const {
+    JSONWriter writer(json, size);
+    writer.key("events", _events);
+    writer.key("published", _eventsPublished);
+    writer.key("dropped", _eventsDropped);
+    writer.key("dropPct", _events == 0 ? 0.0f : 100.0f * _eventsDropped / _events, 2);
+    writer.key("publishes", _publishes);
+    writer.key("failures", _publishFailures);
+    writer.key("lastHour", _publishesLastHour);
+    writer.end();
+}   // end of writeStats()
+
+bool WSMPublishBatcher::statsChanged() {
+    bool changed = _statsChanged;
+    _statsChanged = false;
+    return changed;
+}   // end of statsChanged()
+
+// Private methods
+
+bool WSMPublishBatcher::publish(const char *eventName, const char *eventData, unsigned int events) {
+    _statsChanged = true;
+    bool published = _queue != NULL ? _queue->publish(eventName, eventData, events)
+                                    : Particle.publish(eventName, eventData, PRIVATE);
+    if(published) {
+        _publishes++;
+        _publishesThisHour++;
+        return true;
+    }
+    _publishFailures++;
+    return false;
+}   // end of publish()
+
+// publish the batch to make way for an event that does not go in it; if the batch still can't be
+// published, drop it
+void WSMPublishBatcher::makeRoom() {
+    if(!flush()) {
+        drop();
+    }
+}   // end of makeRoom()
+
+void WSMPublishBatcher::drop() {
+    _eventsDropped += _count;
+    _count = 0;
+    _length = 0;
+    _failed = false;
+    _payload[0] = '\0';
+}   // end of drop()
@@ -0,0 +1,112 @@
+#ifndef WSMPUBLISHBATCHER_H_INCLUDE
+#define WSMPUBLISHBATCHER_H_INCLUDE
+/***************************************************************************************************/
+// WSMPublishBatcher.h
+//  Collects wsmEvent* payloads into one publication so that a short cycling pump does not run
+//  through the Particle publish budget (one a second on average).  Each event's JSON object gets
+//  its event name added as "ev" and goes into a single array:
+//
+//      wsmEventBatch  {"events":[{"ev":"wsmEventPPstatus","etime":...,"pp":1,...},{"ev":...}]}
+//
+//  Journaled events can be added as records instead, which go into a compact wsmEventPack
+//  (WSMEventPack.h) of up to 465 bytes.  A batch holds one kind or the other: adding the other
+//  kind publishes the batch first, so that the events stay in order.
+//
+//  The batch is published when the next event would take it over the 622 byte publish limit, when
+//  its oldest event is maxAgeMs old, or when flush() is called (the sketch does that as soon as an
+//  alert has been raised).  The wsmWriteData script writes a batch as one row per event.
+//
+//  A publish that fails (rate limited, or not connected to the cloud) is retried from process()
+//  once a second.  While the batch is held it keeps filling; an event that does not fit then
+//  displaces the whole held batch, and those events are counted as dropped.  A journaled event is
+//  never dropped that way: add() refuses it instead, and the journal still has it.
+//
+//  publishVia() hands the batches to a WSMPublishQueue instead, which publishes them from its
+//  worker thread; a publish then counts as done once the queue has taken it, and a refusal (the
+//  queue full) as a failure.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+#include "WSMEventPack.h"
+#include "WSMPublishQueue.h"
+
+class WSMPublishBatcher {
+    public:
+        // batchEventName is the name the batch is published under; it must stay valid
+        WSMPublishBatcher(const char *batchEventName, system_tick_t maxAgeMs);
+
+        // Initialization
+        void begin();
+
+        // publish through queue, NULL to publish directly (the default)
+        void publishVia(WSMPublishQueue *queue) { _queue = queue; }
+
+        // queue an event; eventData is the JSON object it would be published with on its own.
+        // Returns false if the event was dropped.
+        bool add(const char *eventName, const char *eventData);
+
+        // queue a journaled event in the pack.  Returns false, and does not take the event, if the
+        // batch it does not fit in could not be published; add it again once retrying() is false.
+        bool add(const WSMJournalRecord &record);
+
+        // publish an event on its own, right after the batch so that the events stay in order
+        bool publishNow(const char *eventName, const char *eventData);
+
+        // publish the batch now; true if it was published or there was nothing to publish
+        bool flush();
+
+        // call every loop(): publishes an aged batch, retries a failed publish, counts the hours
+        void process();
+
+        bool pending() const { return _count > 0; }
+        bool retrying() const { return _failed; }   // the batch failed to publish; process() retries it
+        system_tick_t msUntilDue() const;   // until process() next publishes; 0xFFFFFFFF if nothing is queued
+
+        // counters since begin()
+        unsigned int get_events() const { return _events; }     // passed to add() or publishNow()
+        unsigned int get_eventsPublished() const { return _eventsPublished; }
+        unsigned int get_eventsDropped() const { return _eventsDropped; }
+        unsigned int get_publishes() const { return _publishes; }
+        unsigned int get_publishFailures() const { return _publishFailures; }
+        unsigned int get_publishesLastHour() const { return _publishesLastHour; }   // the last complete hour
+
+        // {"events":..,"published":..,"dropped":..,"dropPct":..,"publishes":..,"failures":..,"lastHour":..}
+        void writeStats(char *json, size_t size) const;
+
+        // true once after any counter has changed
+        bool statsChanged();
+
+    private:
+        bool publish(const char *eventName, const char *eventData, unsigned int events);
+        void makeRoom();
+        void drop();
+
+        const char *_batchEventName;
+        const system_tick_t _maxAgeMs;
+        WSMPublishQueue *_queue;
+
+        char _payload[PUBLISH_DATA_LIMIT + 1];
+        size_t _length;             // the payload without the closing "]}"
+        WSMEventPack _pack;
+        bool _packed;               // the events are in _pack, not in _payload
+        unsigned int _count;        // events in the batch
+        system_tick_t _oldestMs;    // millis() when the first event in the payload was added
+        system_tick_t _failedMs;    // millis() of the last failed publish of the payload
+        bool _failed;
+
+        unsigned int _events;
+        unsigned int _eventsPublished;
+        unsigned int _eventsDropped;
+        unsigned int _publishes;
+        unsigned int _publishFailures;
+        system_tick_t _hourStartMs;
+        unsigned int _publishesThisHour;
+        unsigned int _publishesLastHour;
+        bool _statsChanged;
+};
+
+#endif  // end of header duplication prevention
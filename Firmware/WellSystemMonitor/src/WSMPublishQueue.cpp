@@ -0,0 +1,170 @@
+/***************************************************************************************************/
+// WSMPublishQueue.cpp
+//  Publishes from a worker thread.  See WSMPublishQueue.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMPublishQueue.h>
+#include <JSONWriter.h>
+
+// how long the worker sleeps when there is nothing it can publish
+static const system_tick_t WORKER_IDLE_MS = 10;
+
+static bool particlePublish(const char *eventName, const char *eventData) {
+    return Particle.publish(eventName, eventData, PRIVATE);
+}
+
+WSMPublishQueue::WSMPublishQueue(WSMDropPolicy policy, WSMPublishFunction publisher, WSMMillisFunction clock) :
+    _policy(policy),
+    _publisher(publisher != NULL ? publisher : particlePublish),
+    _clock(clock != NULL ? clock : millis),
+    _worker(false) {
+    begin();
+}
+
+void WSMPublishQueue::begin() {
+    _head.store(0);
+    _tail.store(0);
+    _holding = false;
+    _retryMs = 0;
+    _failedMs = 0;
+    _enqueued.store(0);
+    _sent.store(0);
+    _failed.store(0);
+    _dropped.store(0);
+    _refused.store(0);
+    _eventsSent.store(0);
+    _eventsDropped.store(0);
+    _statsChanged.store(true);
+}
+
+bool WSMPublishQueue::startWorker() {
+#if PLATFORM_THREADING
+    if(!_worker) {
+        new Thread("publisher", workerMain, this);
+        _worker = true;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool WSMPublishQueue::publish(const char *eventName, const char *eventData, unsigned int events) {
+    size_t nameLength = strlen(eventName);
+    size_t dataLength = strlen(eventData);
+    if(nameLength >= PUBLISH_NAME_SIZE || dataLength > PUBLISH_DATA_LIMIT) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        _eventsDropped.fetch_add(events, std::memory_order_relaxed);
+        _statsChanged.store(true);
+        return false;
+    }
+
+    unsigned int head = _head.load(std::memory_order_relaxed);
+    unsigned int tail = _tail.load(std::memory_order_acquire);
+    if(head - tail >= PUBLISH_QUEUE_SLOTS) {
+        if(_policy == DROP_NEWEST) {
+            // not dropped: the caller still has it
+            _refused.fetch_add(1, std::memory_order_relaxed);
+            _statsChanged.store(true);
+            return false;
+        }
+        // take the oldest slot from the worker; if it took the slot first, there is room anyway
+        unsigned int oldestEvents = _slots[tail & (PUBLISH_QUEUE_SLOTS - 1)].events;
+        if(_tail.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel)) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            _eventsDropped.fetch_add(oldestEvents, std::memory_order_relaxed);
+        }
+    }
+
+    WSMPublishSlot &slot = _slots[head & (PUBLISH_QUEUE_SLOTS - 1)];
+    slot.events = (uint16_t)events;
+    memcpy(slot.name, eventName, nameLength + 1);
+    memcpy(slot.data, eventData, dataLength + 1);
+    _head.store(head + 1, std::memory_order_release);
+    _enqueued.fetch_add(1, std::memory_order_relaxed);
+    _statsChanged.store(true);
+    return true;
+
+}   // end of publish()
+
+void WSMPublishQueue::process() {
+    if(_worker) {
+        return;
+    }
+    while(service()) {
+        // publish until the ring is empty or a publish has failed
+    }
+}
+
+bool WSMPublishQueue::service() {
+    if(!_holding && !take()) {
+        return false;
+    }
+    system_tick_t now = _clock();
+    if(_retryMs != 0 && now - _failedMs < _retryMs) {
+        return false;   // backing off
+    }
+
+    if(_publisher(_inHand.name, _inHand.data)) {
+        _holding = false;
+        _retryMs = 0;
+        _sent.fetch_add(1, std::memory_order_relaxed);
+        _eventsSent.fetch_add(_inHand.events, std::memory_order_relaxed);
+    } else {
+        _failedMs = now;
+        _retryMs = _retryMs == 0 ? PUBLISH_RETRY_MS : _retryMs * 2;
+        if(_retryMs > PUBLISH_RETRY_MAX_MS) {
+            _retryMs = PUBLISH_RETRY_MAX_MS;
+        }
+        _failed.fetch_add(1, std::memory_order_relaxed);
+    }
+    _statsChanged.store(true);
+    return true;
+
+}   // end of service()
+
+unsigned int WSMPublishQueue::waiting() const {
+    unsigned int tail = _tail.load(std::memory_order_acquire);
+    return _head.load(std::memory_order_acquire) - tail;
+}
+
+void WSMPublishQueue::writeStats(char *json, size_t size) const {
+    JSONWriter writer(json, size);
+    writer.key("enqueued", get_enqueued());
+    writer.key("sent", get_sent());
+    writer.key("failed", get_failed());
+    writer.key("dropped", get_dropped());
+    writer.key("refused", get_refused());
+    writer.key("waiting", waiting());
+    writer.end();
+}   // end of writeStats()
+
+// Private methods
+
+// copy the oldest slot out, then move the tail past it.  If publish() dropped the slot meanwhile
+// (DROP_OLDEST), the tail has moved and the copy may be half overwritten: try the next one.
+bool WSMPublishQueue::take() {
+    unsigned int tail = _tail.load(std::memory_order_acquire);
+    while(tail != _head.load(std::memory_order_acquire)) {
+        memcpy(&_inHand, &_slots[tail & (PUBLISH_QUEUE_SLOTS - 1)], sizeof(_inHand));
+        if(_tail.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel)) {
+            _holding = true;
+            return true;
+        }
+        // tail now holds the new tail
+    }
+    return false;
+}   // end of take()
+
+void WSMPublishQueue::workerMain(void *queue) {
+    WSMPublishQueue *self = (WSMPublishQueue *)queue;
+    while(true) {
+        if(!self->service()) {
+            delay(WORKER_IDLE_MS);
+        }
+    }
+}   // end of workerMain()
@@ -0,0 +1,146 @@
+#ifndef WSMPUBLISHQUEUE_H_INCLUDE
+#define WSMPUBLISHQUEUE_H_INCLUDE
+/***************************************************************************************************/
+// WSMPublishQueue.h
+//  Takes Particle.publish() off the application thread.  Even with SYSTEM_THREAD(ENABLED) a publish
+//  can hold loop() up for seconds on a weak Wi-Fi link; here publish() copies the event name and
+//  data into a slot of a fixed ring and returns, and a worker thread takes the slots out in order
+//  and publishes them:
+//
+//      WSMPublishQueue publisher(DROP_NEWEST);
+//      ...
+//      publisher.startWorker();                            // in setup()
+//      publisher.publish("wsmPumpStats", json);            // anywhere on the application thread
+//
+//  The ring is a single producer (the application thread), single consumer (the worker) queue of
+//  PUBLISH_QUEUE_SLOTS slots: publish() only writes the head and the worker takes a slot by copying
+//  it out and moving the tail on, so neither takes a lock.  When the ring is full the policy says
+//  which event goes:
+//
+//      DROP_NEWEST     publish() refuses the new event and returns false, as Particle.publish()
+//                      does when it can't publish; the caller keeps it and tries again, so it
+//                      is counted as refused, not dropped
+//      DROP_OLDEST     publish() moves the tail on past the oldest waiting event and takes its
+//                      slot.  Should the worker have been copying that slot, its move of the
+//                      tail fails and it drops the copy.
+//
+//  A publish that fails (not connected, rate limited) is retried by the worker, 1 s later, then
+//  after twice as long each time up to 16 s, until it goes; the event in the worker's hands is not
+//  dropped.  publish() can say how many events a payload carries (a wsmEventPack holds several), so
+//  that the sender knows how many of its events have been sent or thrown away: the dropped counts
+//  are only of those (a slot taken by DROP_OLDEST, a payload too long to publish), never of one
+//  the caller still holds.
+//
+//  On the Photon the worker is a Device OS thread.  Where there are no threads (the host build,
+//  which does not model them) startWorker() returns false and process() sends the queue from
+//  loop() instead.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+#include <atomic>
+
+// the most event data that Particle.publish() accepts
+const size_t PUBLISH_DATA_LIMIT = 622;
+
+// the longest event name, and its terminating null
+const size_t PUBLISH_NAME_SIZE = 64;
+
+// slots in the ring; a power of two
+const unsigned int PUBLISH_QUEUE_SLOTS = 8;
+
+// the retry backoff
+const system_tick_t PUBLISH_RETRY_MS = 1000;
+const system_tick_t PUBLISH_RETRY_MAX_MS = 16000;
+
+// which event goes when the ring is full
+enum WSMDropPolicy {
+    DROP_NEWEST,
+    DROP_OLDEST
+};
+
+// publishes one event; true if it went
+typedef bool (*WSMPublishFunction)(const char *eventName, const char *eventData);
+
+// milliseconds, for the backoff
+typedef system_tick_t (*WSMMillisFunction)();
+
+// one event waiting to be published
+struct WSMPublishSlot {
+    uint16_t events;                        // the events it carries, for the sender's counts
+    char name[PUBLISH_NAME_SIZE];
+    char data[PUBLISH_DATA_LIMIT + 1];
+};
+
+class WSMPublishQueue {
+    public:
+        // publisher NULL: Particle.publish(name, data, PRIVATE); clock NULL: millis()
+        WSMPublishQueue(WSMDropPolicy policy, WSMPublishFunction publisher = NULL, WSMMillisFunction clock = NULL);
+
+        // Initialization: empty, counters cleared; not while the worker is running
+        void begin();
+
+        // start the worker thread; false if there are no threads, when process() must be called
+        bool startWorker();
+
+        // queue an event carrying events events; false if it was too long (dropped) or refused
+        //  (DROP_NEWEST and full; the caller keeps it).  Application thread only.
+        bool publish(const char *eventName, const char *eventData, unsigned int events = 0);
+
+        // without a worker thread, call every loop(): publishes what is waiting and due
+        void process();
+
+        // the worker's step: take a slot if there is none in hand, and publish it if it is due.
+        //  True if it tried to publish.  The worker thread only (or process()).
+        bool service();
+
+        unsigned int waiting() const;       // events in the ring, not counting the one in hand
+
+        // counters since begin()
+        unsigned int get_enqueued() const { return _enqueued.load(std::memory_order_relaxed); }
+        unsigned int get_sent() const { return _sent.load(std::memory_order_relaxed); }
+        unsigned int get_failed() const { return _failed.load(std::memory_order_relaxed); }    // attempts
+        unsigned int get_dropped() const { return _dropped.load(std::memory_order_relaxed); }
+        unsigned int get_refused() const { return _refused.load(std::memory_order_relaxed); }   // DROP_NEWEST and full
+        unsigned int get_eventsSent() const { return _eventsSent.load(std::memory_order_relaxed); }
+        unsigned int get_eventsDropped() const { return _eventsDropped.load(std::memory_order_relaxed); }
+
+        // {"enqueued":..,"sent":..,"failed":..,"dropped":..,"refused":..,"waiting":..}
+        void writeStats(char *json, size_t size) const;
+
+        // true once after any counter has changed
+        bool statsChanged() { return _statsChanged.exchange(false); }
+
+    private:
+        bool take();                // copy the oldest slot into _inHand; false if there is none
+        static void workerMain(void *queue);
+
+        const WSMDropPolicy _policy;
+        const WSMPublishFunction _publisher;
+        const WSMMillisFunction _clock;
+        bool _worker;               // the worker thread is running
+
+        WSMPublishSlot _slots[PUBLISH_QUEUE_SLOTS];
+        std::atomic<unsigned int> _head;    // slots written; only publish() changes it
+        std::atomic<unsigned int> _tail;    // slots taken out, by the worker or dropped by publish()
+
+        // the worker's
+        WSMPublishSlot _inHand;
+        bool _holding;              // _inHand holds an event to publish
+        system_tick_t _retryMs;     // the backoff after the last failure; 0 before one
+        system_tick_t _failedMs;    // when it failed
+
+        std::atomic<unsigned int> _enqueued;
+        std::atomic<unsigned int> _sent;
+        std::atomic<unsigned int> _failed;
+        std::atomic<unsigned int> _dropped;
+        std::atomic<unsigned int> _refused;
+        std::atomic<unsigned int> _eventsSent;
+        std::atomic<unsigned int> _eventsDropped;
+        std::atomic<bool> _statsChanged;
+};
+
+#endif  // end of header duplication prevention
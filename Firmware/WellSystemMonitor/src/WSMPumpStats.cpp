@@ -0,0 +1,254 @@
+/***************************************************************************************************/
+// WSMPumpStats.cpp
+//  Streaming statistics of the pump cycles.  See WSMPumpStats.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMPumpStats.h>
+#include <JSONWriter.h>
+#include <math.h>
+
+// WSMRunningStats
+
+void WSMRunningStats::begin() {
+    _count = 0;
+    _mean = 0.0;
+    _m2 = 0.0;
+}
+
+void WSMRunningStats::add(double value) {
+    _count++;
+    double delta = value - _mean;
+    _mean += delta / _count;
+    _m2 += delta * (value - _mean);
+}
+
+double WSMRunningStats::variance() const {
+    return _count < 2 ? 0.0 : _m2 / (_count - 1);
+}
+
+double WSMRunningStats::stddev() const {
+    return sqrt(variance());
+}
+
+// WSMP2Quantile
+
+WSMP2Quantile::WSMP2Quantile(float p) :
+    _p(p) {
+    begin();
+}
+
+void WSMP2Quantile::begin() {
+    _count = 0;
+}
+
+void WSMP2Quantile::add(float value) {
+    // the first five values are the markers
+    if(_count < 5) {
+        _height[_count++] = value;
+        if(_count == 5) {
+            for(int i = 1; i < 5; i++) {    // insertion sort
+                for(int j = i; j > 0 && _height[j] < _height[j - 1]; j--) {
+                    float t = _height[j];
+                    _height[j] = _height[j - 1];
+                    _height[j - 1] = t;
+                }
+            }
+            for(int i = 0; i < 5; i++) {
+                _position[i] = i + 1;
+            }
+            _desired[0] = 1.0f;
+            _desired[1] = 1.0f + 2.0f * _p;
+            _desired[2] = 1.0f + 4.0f * _p;
+            _desired[3] = 3.0f + 2.0f * _p;
+            _desired[4] = 5.0f;
+            _increment[0] = 0.0f;
+            _increment[1] = _p / 2.0f;
+            _increment[2] = _p;
+            _increment[3] = (1.0f + _p) / 2.0f;
+            _increment[4] = 1.0f;
+        }
+        return;
+    }
+    _count++;
+
+    // the cell the value falls in; the end markers take new extremes
+    int k;
+    if(value < _height[0]) {
+        _height[0] = value;
+        k = 0;
+    } else if(value >= _height[4]) {
+        _height[4] = value;
+        k = 3;
+    } else {
+        k = 0;
+        while(value >= _height[k + 1]) {
+            k++;
+        }
+    }
+    for(int i = k + 1; i < 5; i++) {
+        _position[i]++;
+    }
+    for(int i = 0; i < 5; i++) {
+        _desired[i] += _increment[i];
+    }
+
+    // the middle markers move a position towards where they should be when they can
+    for(int i = 1; i < 4; i++) {
+        float d = _desired[i] - _position[i];
+        if((d >= 1.0f && _position[i + 1] - _position[i] > 1) || (d <= -1.0f && _position[i - 1] - _position[i] < -1)) {
+            int step = d >= 0.0f ? 1 : -1;
+            float height = parabolic(i, step);
+            if(_height[i - 1] < height && height < _height[i + 1]) {
+                _height[i] = height;
+            } else {
+                _height[i] = linear(i, step);
+            }
+            _position[i] += step;
+        }
+    }
+}   // end of add()
+
+float WSMP2Quantile::parabolic(int i, int d) const {
+    float below = (float)(_position[i] - _position[i - 1]);
+    float above = (float)(_position[i + 1] - _position[i]);
+    return _height[i] + (float)d / (below + above) *
+           ((below + d) * (_height[i + 1] - _height[i]) / above + (above - d) * (_height[i] - _height[i - 1]) / below);
+}
+
+float WSMP2Quantile::linear(int i, int d) const {
+    return _height[i] + d * (_height[i + d] - _height[i]) / (float)(_position[i + d] - _position[i]);
+}
+
+float WSMP2Quantile::value() const {
+    if(_count == 0) {
+        return 0.0f;
+    }
+    if(_count > 5) {
+        return _height[2];
+    }
+    // too few for the markers: the nearest rank of the values so far
+    float sorted[5];
+    for(unsigned int i = 0; i < _count; i++) {
+        unsigned int j = i;
+        for(; j > 0 && sorted[j - 1] > _height[i]; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = _height[i];
+    }
+    int rank = (int)ceilf(_p * _count) - 1;
+    return sorted[rank < 0 ? 0 : rank];
+}   // end of value()
+
+// WSMPumpStats
+
+WSMPumpStats::WSMPumpStats() {
+    begin(0);
+}
+
+void WSMPumpStats::begin(system_tick_t nowMs) {
+    for(int pump = 0; pump < PUMPS; pump++) {
+        Pump &p = _pumps[pump];
+        p.runStats.begin();
+        p.p50.begin();
+        p.p95.begin();
+        p.p99.begin();
+        p.on = false;
+        p.onMs = 0;
+        p.cycles = 0;
+        p.onTimeMs = 0;
+        p.cyclesLastHour = 0;
+        p.dutyLastHour = 0.0f;
+    }
+    _hourStartMs = nowMs;
+    _ppPerWp.begin();
+    _ppSinceWp = 0;
+    _ppPerLastWp = 0;
+    _wpSeen = false;
+}   // end of begin()
+
+void WSMPumpStats::pumpOn(WSMPump pump, system_tick_t changeMs) {
+    Pump &p = _pumps[pump];
+    if(p.on) {
+        return;
+    }
+    p.on = true;
+    p.onMs = changeMs;
+    p.cycles++;
+
+    // the PP cycles between one WP cycle and the next; the count before the first is partial
+    if(pump == PUMP_PP) {
+        _ppSinceWp++;
+    } else {
+        if(_wpSeen) {
+            _ppPerWp.add(_ppSinceWp);
+            _ppPerLastWp = _ppSinceWp;
+        }
+        _wpSeen = true;
+        _ppSinceWp = 0;
+    }
+}   // end of pumpOn()
+
+void WSMPumpStats::pumpOff(WSMPump pump, system_tick_t changeMs) {
+    Pump &p = _pumps[pump];
+    if(!p.on) {
+        return;
+    }
+    p.on = false;
+    p.onTimeMs += inHour(p.onMs, changeMs);
+
+    float minutes = (float)(changeMs - p.onMs) / 60000.0f;
+    p.runStats.add(minutes);
+    p.p50.add(minutes);
+    p.p95.add(minutes);
+    p.p99.add(minutes);
+}   // end of pumpOff()
+
+void WSMPumpStats::closeHour(system_tick_t nowMs) {
+    system_tick_t hourMs = nowMs - _hourStartMs;
+    for(int pump = 0; pump < PUMPS; pump++) {
+        Pump &p = _pumps[pump];
+        if(p.on) {
+            p.onTimeMs += inHour(p.onMs, nowMs);
+        }
+        p.cyclesLastHour = p.cycles;
+        p.dutyLastHour = hourMs == 0 ? 0.0f : (float)p.onTimeMs / (float)hourMs;
+        p.cycles = 0;
+        p.onTimeMs = 0;
+    }
+    _hourStartMs = nowMs;
+}   // end of closeHour()
+
+system_tick_t WSMPumpStats::inHour(system_tick_t startMs, system_tick_t endMs) const {
+    if((int32_t)(startMs - _hourStartMs) < 0) {
+        startMs = _hourStartMs;     // the run began in an earlier hour
+    }
+    return (int32_t)(endMs - startMs) > 0 ? endMs - startMs : 0;
+}
+
+void WSMPumpStats::writeSummary(char *json, size_t size, time_t etime) const {
+    static const char *const KEYS[PUMPS][8] = {
+        {"pph", "ppd", "ppn", "ppm", "pps", "pp50", "pp95", "pp99"},
+        {"wph", "wpd", "wpn", "wpm", "wps", "wp50", "wp95", "wp99"}
+    };
+
+    JSONWriter writer(json, size);
+    writer.key("etime", etime);
+    for(int pump = 0; pump < PUMPS; pump++) {
+        const Pump &p = _pumps[pump];
+        writer.key(KEYS[pump][0], p.cyclesLastHour);
+        writer.key(KEYS[pump][1], p.dutyLastHour, 3);
+        writer.key(KEYS[pump][2], p.runStats.count());
+        writer.key(KEYS[pump][3], (float)p.runStats.mean(), 2);
+        writer.key(KEYS[pump][4], (float)p.runStats.stddev(), 2);
+        writer.key(KEYS[pump][5], p.p50.value(), 2);
+        writer.key(KEYS[pump][6], p.p95.value(), 2);
+        writer.key(KEYS[pump][7], p.p99.value(), 2);
+    }
+    writer.key("ppwp", (float)_ppPerWp.mean(), 1);
+    writer.key("ppwpl", _ppPerLastWp);
+    writer.end();
+}   // end of writeSummary()
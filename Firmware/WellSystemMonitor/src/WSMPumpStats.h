@@ -0,0 +1,133 @@
+#ifndef WSMPUMPSTATS_H_INCLUDE
+#define WSMPUMPSTATS_H_INCLUDE
+/***************************************************************************************************/
+// WSMPumpStats.h
+//  Streaming statistics of the pump cycles, kept on the device in fixed memory and updated in
+//  constant time from publishPPchange() and publishWPchange(), so that trends do not need the
+//  event rows of the sheet:
+//
+//      per pump, since begin():  run time count, mean and standard deviation (Welford), and the
+//                                50th, 95th and 99th percentiles of run time (P² estimates)
+//      per pump, for the hour:   cycles (pump turned on) and duty cycle (on time / hour)
+//      PP cycles per WP cycle:   the mean, and the count for the last WP cycle
+//
+//  The sketch calls closeHour() every hour and publishes the summary that writeSummary() makes:
+//
+//      wsmPumpStats  {"etime":...,"pph":12,"ppd":0.31,"ppn":340,"ppm":0.42,"pps":0.05,"pp50":0.41,
+//                     "pp95":0.50,"pp99":0.53,"wph":1,...,"ppwp":9.8,"ppwpl":10}
+//
+//  run times in minutes, as in the wsmEvent*status events.  The hour's mean run time follows from
+//  two summaries: (n2 * m2 - n1 * m1) / (n2 - n1).
+//
+//  The P² algorithm (Jain and Chlamtac, 1985) keeps five markers per percentile and moves them
+//  with a parabolic fit as values arrive; it needs no stored values, and after a few dozen cycles
+//  it is within a few percent of the exact percentile (the 99th takes a few hundred).
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+
+// mean and variance of a stream of values, by Welford's method
+class WSMRunningStats {
+    public:
+        WSMRunningStats() { begin(); }
+        void begin();
+        void add(double value);
+
+        unsigned int count() const { return _count; }
+        double mean() const { return _mean; }
+        double variance() const;        // sample variance; 0 for fewer than 2 values
+        double stddev() const;
+
+    private:
+        unsigned int _count;
+        double _mean;
+        double _m2;     // sum of the squared differences from the mean
+};
+
+// one percentile of a stream of values, by the P² algorithm
+class WSMP2Quantile {
+    public:
+        WSMP2Quantile(float p);      // 0 < p < 1
+        void begin();
+        void add(float value);
+
+        unsigned int count() const { return _count; }
+        float value() const;        // the estimate; exact for 5 values or fewer, 0 for none
+
+    private:
+        float parabolic(int i, int d) const;
+        float linear(int i, int d) const;
+
+        float _p;
+        unsigned int _count;
+        float _height[5];       // the markers' values
+        int32_t _position[5];   // their positions, 1 to count
+        float _desired[5];      // where they should be
+        float _increment[5];    // how far each desired position moves per value
+};
+
+// the pumps that statistics are kept for
+enum WSMPump {
+    PUMP_PP,
+    PUMP_WP,
+    PUMPS
+};
+
+class WSMPumpStats {
+    public:
+        WSMPumpStats();
+
+        // Initialization: no cycles; the hour starts at nowMs (millis())
+        void begin(system_tick_t nowMs);
+
+        // a pump relay closed or opened at changeMs (millis()); an off without an on is ignored
+        void pumpOn(WSMPump pump, system_tick_t changeMs);
+        void pumpOff(WSMPump pump, system_tick_t changeMs);
+
+        // end the hour at nowMs: the hour's cycles and duty cycle are kept for the summary, and a
+        // new hour starts
+        void closeHour(system_tick_t nowMs);
+
+        // the summary of the last closed hour and the statistics so far, as JSON
+        void writeSummary(char *json, size_t size, time_t etime) const;
+
+        const WSMRunningStats &runStats(WSMPump pump) const { return _pumps[pump].runStats; }
+        float percentile50(WSMPump pump) const { return _pumps[pump].p50.value(); }
+        float percentile95(WSMPump pump) const { return _pumps[pump].p95.value(); }
+        float percentile99(WSMPump pump) const { return _pumps[pump].p99.value(); }
+        unsigned int cyclesLastHour(WSMPump pump) const { return _pumps[pump].cyclesLastHour; }
+        float dutyLastHour(WSMPump pump) const { return _pumps[pump].dutyLastHour; }
+        const WSMRunningStats &ppPerWp() const { return _ppPerWp; }
+        unsigned int ppPerLastWp() const { return _ppPerLastWp; }
+
+    private:
+        struct Pump {
+            Pump() : p50(0.50f), p95(0.95f), p99(0.99f) {}
+            WSMRunningStats runStats;   // minutes
+            WSMP2Quantile p50;
+            WSMP2Quantile p95;
+            WSMP2Quantile p99;
+            bool on;
+            system_tick_t onMs;         // millis() when it turned on
+            unsigned int cycles;        // this hour
+            system_tick_t onTimeMs;     // this hour
+            unsigned int cyclesLastHour;
+            float dutyLastHour;
+        };
+
+        // the part of a run from startMs to endMs that falls in this hour
+        system_tick_t inHour(system_tick_t startMs, system_tick_t endMs) const;
+
+        Pump _pumps[PUMPS];
+        system_tick_t _hourStartMs;
+        WSMRunningStats _ppPerWp;
+        unsigned int _ppSinceWp;    // PP cycles since the WP last turned on
+        unsigned int _ppPerLastWp;
+        bool _wpSeen;               // the WP has turned on since begin()
+};
+
+#endif  // end of header duplication prevention
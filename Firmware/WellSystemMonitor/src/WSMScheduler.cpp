@@ -0,0 +1,270 @@
+/***************************************************************************************************/
+// WSMScheduler.cpp
+//  A cooperative scheduler on a hierarchical timer wheel.  See WSMScheduler.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMScheduler.h>
+
+// the time the wheel covers; tasks due further ahead wait in the far list
+static const int WHEEL_BITS = SCHEDULER_LEVELS * SCHEDULER_SLOT_BITS;
+
+static const uint64_t NEVER = ~(uint64_t)0;
+
+WSMScheduler::WSMScheduler(WSMClockFunction clock) :
+    _clock(clock),
+    _lastMillis(0),
+    _rollovers(0) {
+    begin();
+}
+
+void WSMScheduler::begin() {
+    for(int id = 0; id < SCHEDULER_MAX_TASKS; id++) {
+        _tasks[id].task = NULL;
+        _tasks[id].list = NONE;
+    }
+    for(int list = 0; list < LISTS; list++) {
+        _head[list] = NONE;
+        _tail[list] = NONE;
+    }
+    for(int level = 0; level < SCHEDULER_LEVELS; level++) {
+        _occupied[level] = 0;
+    }
+    _time = now();
+    _nextDue = NEVER;
+    _running = NONE;
+    _runs = 0;
+}
+
+uint64_t WSMScheduler::now() {
+    if(_clock != NULL) {
+        return _clock();
+    }
+    system_tick_t millisNow = millis();
+    if(millisNow < _lastMillis) {
+        _rollovers += (uint64_t)1 << 32;
+    }
+    _lastMillis = millisNow;
+    return _rollovers | millisNow;
+}
+
+uint64_t WSMScheduler::msUntilNext() {
+    uint64_t timeNow = now();
+    return _nextDue > timeNow ? _nextDue - timeNow : 0;
+}
+
+int WSMScheduler::every(system_tick_t periodMs, WSMTaskFunction task, system_tick_t firstMs) {
+    int id = add(periodMs, task);
+    if(id != NONE) {
+        start(id, firstMs);
+    }
+    return id;
+}
+
+int WSMScheduler::after(system_tick_t delayMs, WSMTaskFunction task) {
+    int id = addTask(0, task);
+    if(id != NONE) {
+        schedule(id, now() + delayMs);
+    }
+    return id;
+}
+
+int WSMScheduler::add(system_tick_t periodMs, WSMTaskFunction task) {
+    return addTask(periodMs == 0 ? 1 : periodMs, task);
+}
+
+int WSMScheduler::addTask(system_tick_t periodMs, WSMTaskFunction task) {
+    for(int id = 0; id < SCHEDULER_MAX_TASKS; id++) {
+        if(_tasks[id].task == NULL) {
+            _tasks[id].task = task;
+            _tasks[id].periodMs = periodMs;
+            _tasks[id].list = NONE;
+            return id;
+        }
+    }
+    return NONE;
+}
+
+void WSMScheduler::start(int id, system_tick_t firstMs) {
+    if(id < 0 || id >= SCHEDULER_MAX_TASKS || _tasks[id].task == NULL) {
+        return;
+    }
+    if(_tasks[id].list != NONE) {
+        unlink(id);
+    }
+    schedule(id, now() + firstMs);
+}
+
+void WSMScheduler::stop(int id) {
+    if(id < 0 || id >= SCHEDULER_MAX_TASKS || _tasks[id].task == NULL) {
+        return;
+    }
+    if(_tasks[id].list != NONE) {
+        unlink(id);
+    }
+    if(id == _running) {
+        _running = NONE;    // not rescheduled when it returns
+    }
+}
+
+bool WSMScheduler::active(int id) const {
+    if(id < 0 || id >= SCHEDULER_MAX_TASKS || _tasks[id].task == NULL) {
+        return false;
+    }
+    return _tasks[id].list != NONE || id == _running;
+}
+
+void WSMScheduler::schedule(int id, uint64_t expires) {
+    _tasks[id].expires = expires;
+    place(id);
+    if(expires < _nextDue) {
+        _nextDue = nextEvent();
+    }
+}
+
+// put a task in its list: due, the slot of the highest level at which its due time differs from
+// the wheel's time, or far
+void WSMScheduler::place(int id) {
+    uint64_t expires = _tasks[id].expires;
+    int list;
+    if(expires <= _time) {
+        list = DUE_LIST;
+    } else if((expires ^ _time) >> WHEEL_BITS) {
+        list = FAR_LIST;
+    } else {
+        int level = (63 - __builtin_clzll(expires ^ _time)) / SCHEDULER_SLOT_BITS;
+        int slot = (int)(expires >> (level * SCHEDULER_SLOT_BITS)) & (SCHEDULER_SLOTS - 1);
+        _occupied[level] |= (uint64_t)1 << slot;
+        list = level * SCHEDULER_SLOTS + slot;
+    }
+
+    Task &task = _tasks[id];
+    task.list = (int16_t)list;
+    task.next = NONE;
+    task.prev = _tail[list];
+    if(_tail[list] == NONE) {
+        _head[list] = (int8_t)id;
+    } else {
+        _tasks[_tail[list]].next = (int8_t)id;
+    }
+    _tail[list] = (int8_t)id;
+}   // end of place()
+
+void WSMScheduler::unlink(int id) {
+    Task &task = _tasks[id];
+    int list = task.list;
+    if(task.prev == NONE) {
+        _head[list] = task.next;
+    } else {
+        _tasks[task.prev].next = task.next;
+    }
+    if(task.next == NONE) {
+        _tail[list] = task.prev;
+    } else {
+        _tasks[task.next].prev = task.prev;
+    }
+    if(_head[list] == NONE && list < FAR_LIST) {
+        _occupied[list / SCHEDULER_SLOTS] &= ~((uint64_t)1 << (list % SCHEDULER_SLOTS));
+    }
+    task.list = NONE;
+}   // end of unlink()
+
+// the wheel has reached a slot (or the far list's turn): its tasks move down, in order
+void WSMScheduler::cascade(int list) {
+    int id = _head[list];
+    _head[list] = NONE;
+    _tail[list] = NONE;
+    if(list < FAR_LIST) {
+        _occupied[list / SCHEDULER_SLOTS] &= ~((uint64_t)1 << (list % SCHEDULER_SLOTS));
+    }
+    while(id != NONE) {
+        int next = _tasks[id].next;
+        place(id);
+        id = next;
+    }
+}   // end of cascade()
+
+// the earliest time at which the wheel has something to do: a slot with tasks, or the far list
+uint64_t WSMScheduler::nextEvent() const {
+    if(_head[DUE_LIST] != NONE) {
+        return _time;
+    }
+    uint64_t next = NEVER;
+    for(int level = 0; level < SCHEDULER_LEVELS; level++) {
+        int shift = level * SCHEDULER_SLOT_BITS;
+        int slot = (int)(_time >> shift) & (SCHEDULER_SLOTS - 1);
+        uint64_t later = slot == SCHEDULER_SLOTS - 1 ? 0 : _occupied[level] & (~(uint64_t)0 << (slot + 1));
+        if(later != 0) {
+            uint64_t rotation = _time >> (shift + SCHEDULER_SLOT_BITS) << (shift + SCHEDULER_SLOT_BITS);
+            uint64_t at = rotation | ((uint64_t)__builtin_ctzll(later) << shift);
+            if(at < next) {
+                next = at;
+            }
+        }
+    }
+    if(_head[FAR_LIST] != NONE) {
+        uint64_t turn = ((_time >> WHEEL_BITS) + 1) << WHEEL_BITS;
+        if(turn < next) {
+            next = turn;
+        }
+    }
+    return next;
+}   // end of nextEvent()
+
+bool WSMScheduler::run() {
+    uint64_t timeNow = now();
+    if(timeNow < _nextDue) {
+        return false;   // nothing is due
+    }
+
+    bool ran = false;
+    uint64_t next;
+    while((next = nextEvent()) <= timeNow) {
+        _time = next;
+
+        // the slots that begin now move down, the highest level first; the tasks due now end up due
+        if(_head[FAR_LIST] != NONE && (_time & (((uint64_t)1 << WHEEL_BITS) - 1)) == 0) {
+            cascade(FAR_LIST);
+        }
+        for(int level = SCHEDULER_LEVELS - 1; level >= 0; level--) {
+            int shift = level * SCHEDULER_SLOT_BITS;
+            if((_time & (((uint64_t)1 << shift) - 1)) == 0) {
+                int slot = (int)(_time >> shift) & (SCHEDULER_SLOTS - 1);
+                if(_occupied[level] & ((uint64_t)1 << slot)) {
+                    cascade(level * SCHEDULER_SLOTS + slot);
+                }
+            }
+        }
+
+        while(_head[DUE_LIST] != NONE) {
+            int id = _head[DUE_LIST];
+            unlink(id);
+            _running = id;
+            _tasks[id].task();
+            _runs++;
+            ran = true;
+
+            // unless it stopped or started itself: a periodic task is due a period later, or as
+            // many periods later as it takes to be in the future; a one time task is done
+            if(_running == id && _tasks[id].list == NONE) {
+                Task &task = _tasks[id];
+                if(task.periodMs == 0) {
+                    task.task = NULL;
+                } else {
+                    uint64_t missed = timeNow >= task.expires ? (timeNow - task.expires) / task.periodMs : 0;
+                    task.expires += (missed + 1) * task.periodMs;
+                    place(id);
+                }
+            }
+            _running = NONE;
+        }
+    }
+
+    // nothing happens before the next event, so the wheel can move up to now
+    _time = timeNow;
+    _nextDue = nextEvent();
+    return ran;
+}   // end of run()
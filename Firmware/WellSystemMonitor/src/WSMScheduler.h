@@ -0,0 +1,123 @@
+#ifndef WSMSCHEDULER_H_INCLUDE
+#define WSMSCHEDULER_H_INCLUDE
+/***************************************************************************************************/
+// WSMScheduler.h
+//  A cooperative scheduler for the periodic work of loop(): the DHT sample, the TRH publication,
+//  the alert processor's half hour tick and the indicator flash are tasks with a period, and
+//  run() from loop() calls the ones that are due:
+//
+//      void sampleDHT() { ... }
+//      WSMScheduler scheduler;
+//      ...
+//      scheduler.every(DHT_SAMPLE_INTERVAL, sampleDHT);     // in setup()
+//      ...
+//      scheduler.run();                                    // in loop()
+//
+//  Time is a 64 bit count of milliseconds, from millis() with its rollovers counted, or from a
+//  clock function so that host tests can move time on as far and as fast as they like.  A task
+//  runs on the pass at or after it is due, then again a period after it was due, so a late pass
+//  does not move the cadence; when a whole period has been missed the missed runs are skipped.
+//
+//  The tasks are kept in a hierarchical timer wheel: 4 levels of 64 slots, the first of 1 ms
+//  slots, each next one of slots 64 times longer, together 2^24 ms (4.66 hours), and a list for
+//  the tasks due later than that.  A task goes in the slot of the highest level at which its due
+//  time differs from now, so scheduling is a few bit operations and a list insert; as time reaches
+//  a slot its tasks move down a level, at most 4 times before they run.  A bit map per level marks
+//  the occupied slots, so the time of the next slot to look at is found without walking empty
+//  ones, and run() returns at once when that time has not come.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+
+// the most tasks a scheduler has
+const int SCHEDULER_MAX_TASKS = 16;
+
+// the timer wheel: levels of 2^SCHEDULER_SLOT_BITS slots
+const int SCHEDULER_LEVELS = 4;
+const int SCHEDULER_SLOT_BITS = 6;
+const int SCHEDULER_SLOTS = 1 << SCHEDULER_SLOT_BITS;
+
+// a task is called with no arguments from run()
+typedef void (*WSMTaskFunction)();
+
+// returns the time in milliseconds; it must never go backwards
+typedef uint64_t (*WSMClockFunction)();
+
+class WSMScheduler {
+    public:
+        // clock NULL: millis(), with its rollovers counted
+        WSMScheduler(WSMClockFunction clock = NULL);
+
+        // Initialization: no tasks
+        void begin();
+
+        // add a task that runs every periodMs (at least 1), the first time firstMs from now;
+        // returns the task id, or -1 when there are already SCHEDULER_MAX_TASKS
+        int every(system_tick_t periodMs, WSMTaskFunction task, system_tick_t firstMs = 0);
+
+        // add a task that runs once, delayMs from now; the id is free again once it has run
+        int after(system_tick_t delayMs, WSMTaskFunction task);
+
+        // add a periodic task that does not run until start()
+        int add(system_tick_t periodMs, WSMTaskFunction task);
+
+        // (re)schedule a task to run firstMs from now, then every period
+        void start(int id, system_tick_t firstMs = 0);
+
+        // the task does not run again until start(); a task may stop itself
+        void stop(int id);
+
+        bool active(int id) const;
+
+        // call the tasks that are due, in the order they were due; false if none were
+        bool run();
+
+        uint64_t now();                 // the clock
+        // run() has nothing to do before this: a task is due, or the tasks of a slot move down
+        uint64_t nextDue() const { return _nextDue; }
+        uint64_t msUntilNext();         // until nextDue(); 0 when run() has something to do
+
+        unsigned int get_runs() const { return _runs; }
+
+    private:
+        // list numbers: the wheel slots, then the far future and the tasks that are due
+        static const int FAR_LIST = SCHEDULER_LEVELS * SCHEDULER_SLOTS;
+        static const int DUE_LIST = FAR_LIST + 1;
+        static const int LISTS = DUE_LIST + 1;
+        static const int8_t NONE = -1;
+
+        struct Task {
+            WSMTaskFunction task;   // NULL: the id is free
+            uint64_t expires;       // when it is due
+            system_tick_t periodMs; // 0: runs once
+            int16_t list;           // the list it is in, or NONE when it is stopped
+            int8_t next;            // the list is doubly linked through the tasks
+            int8_t prev;
+        };
+
+        int addTask(system_tick_t periodMs, WSMTaskFunction task);
+        void schedule(int id, uint64_t expires);
+        void place(int id);
+        void unlink(int id);
+        void cascade(int list);
+        uint64_t nextEvent() const;
+
+        WSMClockFunction _clock;
+        system_tick_t _lastMillis;  // for counting millis() rollovers
+        uint64_t _rollovers;
+        uint64_t _time;             // the wheel has been advanced to here
+        uint64_t _nextDue;
+        int _running;               // the task being called, or NONE
+        unsigned int _runs;         // task calls
+
+        Task _tasks[SCHEDULER_MAX_TASKS];
+        int8_t _head[LISTS];
+        int8_t _tail[LISTS];
+        uint64_t _occupied[SCHEDULER_LEVELS];  // a bit per slot with tasks in it
+};
+
+#endif  // end of header duplication prevention
@@ -0,0 +1,94 @@
+/***************************************************************************************************/
+// WSMStateStore.cpp
+//  Snapshots of state in EEPROM.  See WSMStateStore.h
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include <WSMStateStore.h>
+#include <TPPUtils.h>
+
+WSMStateStore::WSMStateStore(int eepromAddress, size_t stateSize, uint8_t version)
+    : _address(eepromAddress), _size(stateSize), _version(version), _newest(-1), _sequence(0) {
+}
+
+// load(): the newer of the good slots
+bool WSMStateStore::load(void *state) {
+    _newest = -1;
+    if(_address < 0) {
+        return false;
+    }
+    uint8_t sequence[2];
+    bool good[2] = {slotGood(0, sequence[0]), slotGood(1, sequence[1])};
+    if(good[0] && good[1]) {
+        _newest = (int8_t)(sequence[1] - sequence[0]) > 0 ? 1 : 0;
+    } else if(good[0] || good[1]) {
+        _newest = good[0] ? 0 : 1;
+    } else {
+        return false;
+    }
+    _sequence = sequence[_newest];
+    uint8_t *bytes = (uint8_t *)state;
+    int at = address(_newest) + STATE_HEADER_SIZE;
+    for(size_t i = 0; i < _size; i++) {
+        bytes[i] = EEPROM.read(at + (int)i);
+    }
+    return true;
+
+}   // end of load()
+
+// save(): the other slot, header and state, writing only the bytes that change
+unsigned int WSMStateStore::save(const void *state) {
+    if(_address < 0) {
+        return 0;
+    }
+    int slot = _newest == 0 ? 1 : 0;
+    uint8_t sequence = _newest < 0 ? 0 : (uint8_t)(_sequence + 1);
+    uint16_t check = crc(_version, sequence, (const uint8_t *)state);
+    uint8_t header[STATE_HEADER_SIZE] = {_version, sequence, (uint8_t)check, (uint8_t)(check >> 8)};
+
+    unsigned int written = 0;
+    int at = address(slot);
+    for(int i = 0; i < STATE_HEADER_SIZE + (int)_size; i++) {
+        uint8_t value = i < STATE_HEADER_SIZE ? header[i] : ((const uint8_t *)state)[i - STATE_HEADER_SIZE];
+        if(EEPROM.read(at + i) != value) {
+            EEPROM.write(at + i, value);
+            written++;
+        }
+    }
+    _newest = slot;
+    _sequence = sequence;
+    return written;
+
+}   // end of save()
+
+bool WSMStateStore::slotGood(int slot, uint8_t &sequence) {
+    int at = address(slot);
+    uint8_t header[STATE_HEADER_SIZE];
+    EEPROM.get(at, header);
+    if(header[0] != _version) {
+        return false;
+    }
+    sequence = header[1];
+
+    // the CRC, a block at a time
+    uint8_t sizeBytes[2] = {(uint8_t)_size, (uint8_t)(_size >> 8)};
+    uint16_t check = crc16(crc16(0xFFFF, header, 2), sizeBytes, sizeof(sizeBytes));
+    uint8_t block[32];
+    for(size_t done = 0; done < _size; done += sizeof(block)) {
+        size_t length = _size - done < sizeof(block) ? _size - done : sizeof(block);
+        for(size_t i = 0; i < length; i++) {
+            block[i] = EEPROM.read(at + STATE_HEADER_SIZE + (int)(done + i));
+        }
+        check = crc16(check, block, length);
+    }
+    return check == (uint16_t)(header[2] | (header[3] << 8));
+
+}   // end of slotGood()
+
+uint16_t WSMStateStore::crc(uint8_t version, uint8_t sequence, const uint8_t *state) const {
+    uint8_t header[4] = {version, sequence, (uint8_t)_size, (uint8_t)(_size >> 8)};
+    return crc16(crc16(0xFFFF, header, sizeof(header)), state, _size);
+}
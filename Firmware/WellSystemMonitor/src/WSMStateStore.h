@@ -0,0 +1,59 @@
+#ifndef WSMSTATESTORE_H_INCLUDE
+#define WSMSTATESTORE_H_INCLUDE
+/***************************************************************************************************/
+// WSMStateStore.h
+//  Keeps a snapshot of an object's state in EEPROM, so that after a restart (a firmware update, a
+//  power blip, a System Restart) it picks up where it left off.  The snapshot is a fixed size
+//  block of bytes, written to two slots in turn:
+//
+//      0     version of the state's layout; a snapshot of another version is not loaded
+//      1     sequence number, one more than the other slot's (mod 256)
+//      2-3   CRC-16/CCITT of bytes 0-1, the state's size and the state
+//      4-    the state
+//
+//  save() writes the slot that does not hold the newest snapshot, so a save cut short by a power
+//  loss or a reset fails its CRC and load() returns the snapshot before it; a slot of another
+//  version or size fails it too.  Only the bytes that differ from what the slot holds are
+//  written, which keeps the wear on the Photon's flash emulated EEPROM and the time of a save
+//  down.  load() reads both slots once, so it adds little to the boot.
+//
+//  Use of this software is subject to the Terms of Use which can be found at:
+//  https://github.com/TeamPracticalProjects/SISProject/blob/master/SISDocs/Terms_of_Use_License_and_Disclaimer.pdf
+//
+//  (c) 2026 by Bob Glicksman and Jim Schrempp, Team Practical Projects
+/***************************************************************************************************/
+#include "application.h"
+
+// EEPROM bytes per slot before the state
+const int STATE_HEADER_SIZE = 4;
+
+class WSMStateStore {
+    public:
+        // a state of stateSize bytes in 2 * (STATE_HEADER_SIZE + stateSize) bytes of EEPROM from
+        //  eepromAddress; an address < 0 keeps nothing
+        WSMStateStore(int eepromAddress = -1, size_t stateSize = 0, uint8_t version = 0);
+
+        // the EEPROM a state of stateSize bytes takes
+        static int eepromSize(size_t stateSize) { return 2 * (STATE_HEADER_SIZE + (int)stateSize); }
+
+        // the newest good snapshot into state; false, leaving state as it was, if there is none
+        bool load(void *state);
+
+        // write a snapshot of state; the EEPROM bytes written
+        unsigned int save(const void *state);
+
+        bool enabled() const { return _address >= 0; }
+
+    private:
+        int address(int slot) const { return _address + slot * (STATE_HEADER_SIZE + (int)_size); }
+        bool slotGood(int slot, uint8_t &sequence);     // a good snapshot of this version and size
+        uint16_t crc(uint8_t version, uint8_t sequence, const uint8_t *state) const;
+
+        int _address;
+        size_t _size;
+        uint8_t _version;
+        int _newest;            // slot of the newest good snapshot; -1 for none
+        uint8_t _sequence;      // its sequence number
+};
+
+#endif  // end of header duplication prevention
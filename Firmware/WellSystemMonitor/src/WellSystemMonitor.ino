@@ -46,14 +46,58 @@
     2022.08.17 BG:  Added in Alert processing code
     2022.08.23 BG:  Fixed initialization issue with PP and WP.  Added comment about not changing the time tick
                         constant because it is used for Alert Processing as well as for TRH logging.
+    2026:           The event payloads and the sensor report are built with JSONWriter in stack buffers
+                        instead of by String concatenation, so publishing uses no heap.
+    2026:           Pump events are batched (WSMPublishBatcher) into wsmEventBatch publications, published
+                        when full, after BATCH_MAX_AGE or as soon as an alert is raised, so that a short
+                        cycling pump stays within the publish budget.  PublishStats reports the counts.
+    2026:           Events are journaled in EEPROM (WSMEventJournal) and published from there in order once
+                        the cloud is connected, so they survive cloud outages and restarts.
+    2026:           Journaled events are published in the compact wsmEventPack encoding (WSMEventPack)
+                        instead of as JSON, several dozen to a publication.
+    2026:           The pump sensors are read by interrupt (WSMEdgeCapture): edges are timestamped as they
+                        happen and debounced in loop(), so run times are the relay closure intervals.
+    2026:           The polled inputs are debounced together from a table of channels (WSMDebouncer); a new
+                        input is an entry in mg_inputChannels and a test of its bit in loop().
+    2026:           The periodic work of loop() is scheduled on a timer wheel (WSMScheduler): the DHT sample,
+                        the TRH publication, the indicator flash, and the alert processor's half hour tick,
+                        which now has its own timer instead of riding on publishTRH().
+    2026:           Pump statistics are kept on the device (WSMPumpStats): run time mean, deviation and
+                        percentiles, cycles and duty cycle per hour, and PP cycles per WP cycle,
+                        published hourly as wsmPumpStats and readable as the PumpStats variable.
+    2026:           The alert processor also learns this site's run times and cycle intervals and raises
+                        wsmAlertPPDeviation / wsmAlertWPDeviation when they depart from what it learned.
+    2026:           The alerts are rules in a table; this site's own are in mg_siteAlertRules, starting with
+                        wsmAlertWPFreeze when the WP comes on at or below WP_FREEZE_TEMP.
+    2026:           wsmAlertPPShortCycling when the PP comes on more than PP_SHORT_CYCLE_10_MINUTES times in
+                        10 minutes or PP_SHORT_CYCLE_HOUR times in an hour (sliding window cycle counts).
+    2026:           The alert state is kept in EEPROM after the journal, so a restart neither forgets the PP
+                        run time since the WP nor repeats an alert that was being held off.
+    2026:           setup() no longer waits 1.8 s: the inputs are sampled from the first pass of loop(), the
+                        restart indicator runs from the scheduler and System Restart is published once the
+                        cloud is connected.  The boot phase times are the BootTimes variable (WSMBootSequence).
+    2026:           The stages of loop() are timed with the cycle counter (WSMLoopProfiler): log2 histograms and
+                        the longest pass in the LoopProfile variable, chosen with the loopProfile function.
+    2026:           Everything is published through a queue (WSMPublishQueue) by a worker thread, so loop()
+                        only copies the payload; the queue's counts are the PublishQueue variable.
 
 ***********************************************************************************************************/
 // #define IFTTT_NOTIFY    // comment out if IFTTT alarm notification is not desired
 
 #include <WSMGlobals.h>
 #include <TPPUtils.h>
+#include <JSONWriter.h>     // heap free JSON payloads
 #include <PietteTech_DHT.h> // non-blocking library for DHT11
 #include <WSMAlertProcessor.h>  // the alert generation library
+#include <WSMPublishBatcher.h>  // batches the events into fewer publications
+#include <WSMEventJournal.h>    // keeps the events in EEPROM until they are published
+#include <WSMEdgeCapture.h>     // interrupt driven pump sensor edges
+#include <WSMDebouncer.h>       // debounces the polled inputs
+#include <WSMScheduler.h>       // runs the periodic tasks of loop()
+#include <WSMPumpStats.h>       // streaming statistics of the pump cycles
+#include <WSMBootSequence.h>    // the boot phases and their times
+#include <WSMLoopProfiler.h>    // times the stages of loop()
+#include <WSMPublishQueue.h>    // publishes from a worker thread
 
 // Constants and definitions
 #define DHTTYPE  DHT11              // Sensor type DHT11/21/22/AM2301/AM2302
@@ -69,6 +113,29 @@ const bool HT_SWITCH_HUMIDITY = false;
 const bool HT_SWITCH_TEMPERATURE = true;
 #define DHT_SAMPLE_INTERVAL   4000  // Sample every 4 seconds; must not be less than the time required to read DHT
 #define PARTICLE_DHT_PUBLISH_INTERVAL 1800000 // Publish values every 30 minutes
+#define ALERT_TICK_INTERVAL 1800000 // The alert processor counts time in ½ hour ticks; DO NOT CHANGE
+#define FLASH_INTERVAL 150          // The indicator flashes 150 ms on and off when the cloud is not connected
+#define BOOT_INDICATOR_OFF 600      // At a restart the indicator is on for 600 ms, then off
+#define BOOT_INDICATOR_ON 1800      //  until 1800 ms, then on (or flashing) as usual
+#define PUMP_STATS_INTERVAL 3600000 // Publish the pump statistics every hour
+#define LOOP_PROFILE_INTERVAL 60000 // Refresh the LoopProfile variable every minute
+#define DEVIATION_ALERT_SIGMAS 4.0  // Deviation alert when recent pump behaviour drifts this many standard errors
+#define WP_FREEZE_TEMP 32.0         // Alert if the WP comes on with the well house at or below freezing (F)
+#define PP_SHORT_CYCLE_10_MINUTES 6 // Short cycling alert if the PP comes on more than this many times in 10 minutes
+#define PP_SHORT_CYCLE_HOUR 24      //   or in an hour (a waterlogged pressure tank)
+#define BATCH_MAX_AGE 300000    // Publish batched pump events at most 5 minutes after the first one
+#define JOURNAL_DRAIN_INTERVAL 1000 // Take journaled events out at 1 a second (bursts of 4), the publish limit
+const int JOURNAL_EEPROM_ADDRESS = 0;   // the journal takes 64 * 16 = 1024 bytes of EEPROM from here
+const unsigned int JOURNAL_RECORDS = 64;
+const int ALERT_STATE_EEPROM_ADDRESS = 1024;    // the alert state takes ALERT_STATE_EEPROM_SIZE bytes from here,
+                                                //  up to the end of the Photon's 2047 bytes
+const int PHOTON_EEPROM_SIZE = 2047;    // bytes of emulated EEPROM on the Photon
+// growing the alert state or the journal must not run one into the other or off the end
+static_assert(JOURNAL_EEPROM_ADDRESS + (int)JOURNAL_RECORDS * JOURNAL_RECORD_SIZE <= ALERT_STATE_EEPROM_ADDRESS,
+              "the event journal runs into the alert state in EEPROM");
+static_assert(ALERT_STATE_EEPROM_ADDRESS + ALERT_STATE_EEPROM_SIZE <= PHOTON_EEPROM_SIZE,
+              "the alert state runs off the end of the Photon's EEPROM");
+#define PUMP_DEBOUNCE_DELAY 1000    // a pump sensor must hold a new level this long (ms) to count
 
 const int UTC_OFFSET = -8;  // set for Pacific Standard Time
 
@@ -97,28 +164,83 @@ float mg_smoothedTemp = 0.0, mg_smoothedHumidity = 0.0; // smoothed for the disp
 // globals to hold state of the pump sensors
 bool mg_wellPumpState, mg_pressurePumpState;
 
-// structure to hold pins that need to be DEBOUNCED
-typedef struct {
-    unsigned int pinNumber;      // pin number to Monitor
-    bool value;                  // the current debounced value of the pin
-    bool lastReadValue;          // the value of the pin when it was last read - not DEBOUNCED
-    unsigned long beginTime;     // the time when lastReadValue was read
-    unsigned long debounceDelay; // in milliseconds. lastReadValue must remain unchanged this long
-                                 // for the code to update the value
-} ty_debouncePin;
-ty_debouncePin mg_pushbutton, mg_wellPumpSensor, mg_pressurePumpSensor, mg_htSwitchPin;
+// the polled pins that need to be DEBOUNCED: pin, value before the first reading, debounce delay (ms).
+// To add an input, add a channel here and test its bit in loop().
+enum {
+    PUSHBUTTON_CHANNEL,
+    HT_SWITCH_CHANNEL,
+    INPUT_CHANNELS
+};
+const WSMDebounceChannel mg_inputChannels[INPUT_CHANNELS] = {
+    {BUTTON_PIN, false, 100},
+    {HT_SWITCH_PIN, false, 50}
+};
+WSMDebouncer mg_inputs(mg_inputChannels, INPUT_CHANNELS);
 
-// Early declares to avoid compiler making it's own decision about parameters
-bool readPinDebounced(ty_debouncePin *_pinToRead);
-void initDebounce (ty_debouncePin *debounceStruct, int _pinNumber, boolean _value, boolean _lastReadValue, int _beginTime, long _debounceDelay);
+// the pump sensors are captured by interrupt; pump relay sensor is normally open (1) for off
+WSMEdgeCapture mg_wellPumpSensor(WELL_PUMP_SENSOR_PIN, true, PUMP_DEBOUNCE_DELAY);
+WSMEdgeCapture mg_pressurePumpSensor(PRESSURE_PUMP_SENSOR_PIN, true, PUMP_DEBOUNCE_DELAY);
+void wellPumpEdge() { mg_wellPumpSensor.capture(); }
+void pressurePumpEdge() { mg_pressurePumpSensor.capture(); }
 
 
 // Lib instantiate
 PietteTech_DHT DHT(DHTPIN, DHTTYPE);    // create DHT object to read temp and humidity
 Servo myservo;  // create servo object to control a servo
 
-// create instance of WSMAlertProcessor class
-WSMAlertProcessor alerter;
+// create instance of WSMAlertProcessor class: the default limits, with the adaptive deviation and
+// short cycling alerts on
+struct WSMSiteLimits : WSMAlertLimits {
+    WSMSiteLimits() {
+        deviationSigmas = DEVIATION_ALERT_SIGMAS;
+        ppCycles10Minutes = PP_SHORT_CYCLE_10_MINUTES;
+        ppCyclesHour = PP_SHORT_CYCLE_HOUR;
+    }
+};
+const WSMSiteLimits mg_alertLimits;
+WSMAlertProcessor alerter(mg_alertLimits);
+
+// this site's own alerts, added to the fixed ones in setup().  To add an alert, add a rule here.
+const WSMAlertRule mg_siteAlertRules[] = {
+    // the WP came on with the well house at or below freezing; once a day at most
+    {"wsmAlertWPFreeze", ALERT_ON_WP_ON, MEASURE_TEMPERATURE, ALERT_AT_MOST, WP_FREEZE_TEMP, 48, ALERT_OWN_HOLDOFF, 0, 1,
+        "WP came on at ", " degrees F."}
+};
+
+// the events for the webhook are journaled, then go out in batches
+WSMEventJournal journal(JOURNAL_EEPROM_ADDRESS, JOURNAL_RECORDS, JOURNAL_DRAIN_INTERVAL);
+WSMPublishBatcher batcher("wsmEventBatch", BATCH_MAX_AGE);
+
+// every publication goes through the queue; when it is full a new one is refused, and the batcher
+// keeps its batch and the journal its events until there is room
+WSMPublishQueue publisher(DROP_NEWEST);
+
+// the pump statistics, summarized every hour
+WSMPumpStats pumpStats;
+
+// the periodic tasks of loop(); their ids are set in setup()
+WSMScheduler scheduler;
+int mg_flashTask = -1;
+
+// the boot phases; the indicator shows the restart until BOOT_INDICATOR_ON
+WSMBootSequence mg_boot;
+boolean mg_bootIndicator = false;
+
+// the stages of loop() the profiler times, in order.  To time another stage, add it here and lap()
+// it in loop().
+enum {
+    STAGE_DHT,          // collecting a DHT11 reading
+    STAGE_TASKS,        // the scheduled tasks: DHT sample, TRH publication, alert tick, ...
+    STAGE_INPUTS,       // debouncing the polled inputs
+    STAGE_SERVO,        // the toggle switch and the meter
+    STAGE_PUMPS,        // the pushbutton and the pump changes: journal, alerts, statistics
+    STAGE_PUBLISH,      // queueing the journaled and batched events
+    STAGE_REPORT,       // the sensor report and the indicator
+    LOOP_STAGES
+};
+const char *const mg_loopStageNames[LOOP_STAGES] = {"dht", "tasks", "inputs", "servo", "pumps", "publish", "report"};
+WSMLoopProfiler mg_profiler(mg_loopStageNames, LOOP_STAGES);
+int mg_profileView = -1;    // what LoopProfile shows: a stage, LOOP_STAGES for the whole pass, -1 for the summary
 
 
 // Utility functions
@@ -136,7 +258,14 @@ void reportDeviceRestart()
 
 // Globals
 boolean LEDPinState = false;   // D7 LED is used for indicating DHT measurements
-String mg_particleSensorReport = "";
+boolean mg_newDHTData = false;  // a DHT11 reading has been started and not yet collected
+char mg_particleSensorReport[JSON_EVENT_SIZE * 2] = "";
+char mg_publishStats[JSON_EVENT_SIZE] = "";
+char mg_pumpStats[JSON_EVENT_SIZE * 3] = "";
+char mg_bootTimes[JSON_EVENT_SIZE] = "";
+char mg_loopProfile[JSON_EVENT_SIZE * 4] = "";
+char mg_publishQueue[JSON_EVENT_SIZE] = "";
+unsigned int mg_restartReportSent = 0;  // the queue's sent count once the restart report has gone; 0 if none is waiting
 String mg_particleDHTReport = "";
 
 SYSTEM_THREAD(ENABLED); // run threaded operation so firmware can detect and process disconnects from the Particle cloud
@@ -144,6 +273,8 @@ SYSTEM_THREAD(ENABLED); // run threaded operation so firmware can detect and pro
 // setup()
 void setup() {
 
+    mg_boot.begin(millis());    // the boot starts now; nothing in setup() waits
+
     WiFi.selectAntenna(ANT_AUTO);
 
     pinMode(LED_PIN, OUTPUT);
@@ -153,10 +284,9 @@ void setup() {
     pinMode(WELL_PUMP_SENSOR_PIN, INPUT_PULLUP);
     pinMode(PRESSURE_PUMP_SENSOR_PIN, INPUT_PULLUP);
     myservo.attach(SERVO_PIN);  // attaches to the servo object
-    initDebounce(&mg_pushbutton, BUTTON_PIN, false, false, 0, 100);
-    initDebounce(&mg_wellPumpSensor, WELL_PUMP_SENSOR_PIN, true, true, 0, 1000);
-    initDebounce(&mg_pressurePumpSensor, PRESSURE_PUMP_SENSOR_PIN, true, true, 0, 1000);
-    initDebounce(&mg_htSwitchPin, HT_SWITCH_PIN, false, false, 0, 50);
+    mg_inputs.begin();
+    mg_wellPumpSensor.begin(wellPumpEdge);
+    mg_pressurePumpSensor.begin(pressurePumpEdge);
 
     DHT.begin();    // start up the DHT11 sensor
 
@@ -165,25 +295,53 @@ void setup() {
     Time.zone(UTC_OFFSET);
     
     Particle.variable("SensorReport", mg_particleSensorReport);
-
+    Particle.variable("PublishStats", mg_publishStats);
+    Particle.variable("PublishQueue", mg_publishQueue);
+    Particle.variable("PumpStats", mg_pumpStats);
+    Particle.variable("BootTimes", mg_bootTimes);
+    mg_boot.write(mg_bootTimes, sizeof(mg_bootTimes));
+    Particle.variable("LoopProfile", mg_loopProfile);
+    Particle.function("loopProfile", loopProfileQuery);
+
+    // the restart indicator: on, off at BOOT_INDICATOR_OFF, on at BOOT_INDICATOR_ON; loop() samples
+    // the inputs meanwhile, and reports the restart once the cloud is connected
     digitalWrite(INDICATOR_PIN, HIGH);
-    delay(600);
-    digitalWrite(INDICATOR_PIN, LOW);
-    delay(1200);  // Give particle cloud time to stabilize
-    digitalWrite(INDICATOR_PIN, HIGH);  // Pushbutton pin remains solid ON while device is working
+    mg_bootIndicator = true;
 
-    alerter.begin();    // initialize the alert generator
+    for(const WSMAlertRule &rule : mg_siteAlertRules) {
+        alerter.addRule(rule);
+    }
+    publisher.begin();  // start the publish worker; without threads loop() publishes
+    publisher.startWorker();
+    alerter.persist(ALERT_STATE_EEPROM_ADDRESS);    // keep the alert state across restarts
+    alerter.publishVia(&publisher);
+    alerter.begin();    // initialize the alert generator, with the state from before the restart
+    batcher.publishVia(&publisher);
+    batcher.begin();    // initialize the event batching
+    journal.begin();    // recover the events that were not published before the restart
+    pumpStats.begin(millis());  // the first hour of pump statistics starts now
+
+    // the periodic tasks; the first TRH publication and alert tick are on the first pass
+    scheduler.begin();
+    scheduler.every(DHT_SAMPLE_INTERVAL, sampleDHT, DHT_SAMPLE_INTERVAL);
+    scheduler.every(PARTICLE_DHT_PUBLISH_INTERVAL, publishTRHTask);
+    scheduler.every(ALERT_TICK_INTERVAL, alertTimeTick);
+    mg_flashTask = scheduler.add(FLASH_INTERVAL, flashIndicator);
+    scheduler.every(PUMP_STATS_INTERVAL, publishPumpStats, PUMP_STATS_INTERVAL);
+    scheduler.every(LOOP_PROFILE_INTERVAL, writeLoopProfile, LOOP_PROFILE_INTERVAL);
+    scheduler.after(BOOT_INDICATOR_OFF, bootIndicatorOff);
+    scheduler.after(BOOT_INDICATOR_ON, bootIndicatorOn);
 
     Particle.publishVitals(21600); // publish vitals every 6 hours
 
+    mg_profiler.begin();    // the first pass of loop() is the first one timed
+    writeLoopProfile();
+
 }  // end of setup()
 
 // loop()
 void loop() {
     //static boolean indicator = false;  // set to true to flash the indicator
-    static unsigned long lastDHTReadTime = 0UL;    // DHT 11 reading time
-    static unsigned long lastPublishTime = millis() - PARTICLE_DHT_PUBLISH_INTERVAL; //0UL;  // Published particle event time
-    static boolean newDHTData = false; // flag to indicate DHT11 has new data
     static boolean htSwitchState = HT_SWITCH_TEMPERATURE;  // hold the reading of the toggle switch
     //static boolean htSwitchLastState = HT_SWITCH_TEMPERATURE;  // hold the previous reading of the toggle switch
     //static boolean firstNotification = false;  // indicator to use for a second alarm notification
@@ -194,17 +352,12 @@ void loop() {
     // Non-blocking read of DHT11 data and publish and display it
     float currentTemp, currentHumidity;
 
-    static boolean onceUponRestart = true;
-    if (onceUponRestart){
-        onceUponRestart = false;
-        reportDeviceRestart();
-        createSensorJSON();
-    }
+    mg_profiler.startPass();
 
     int DHTsensorStatus = startReadDHT(false);  // refresh the sensor status but don't start a new reading
 
 	if(DHTsensorStatus != ACQUIRING) {
-      if(newDHTData == true) { // we have new data
+      if(mg_newDHTData == true) { // we have new data
         currentTemp = DHT.getFahrenheit();
         currentHumidity = DHT.getHumidity();
 
@@ -218,162 +371,270 @@ void loop() {
         // 10 point moving average
         mg_smoothedTemp =  (0.9 * mg_smoothedTemp) +  (0.1 * currentTemp);
         mg_smoothedHumidity =  (0.9 * mg_smoothedHumidity) +  (0.1 * currentHumidity);
+        alerter.temperatureReading(mg_smoothedTemp);    // for the freeze alert
 
         needNewReport = true;
 
-	    newDHTData = false; // don't update results again until a new reading
+	    mg_newDHTData = false; // don't update results again until a new reading
       }
+    }
+    mg_profiler.lap(STAGE_DHT);
 
-      if((diff(millis(), lastDHTReadTime)) >= DHT_SAMPLE_INTERVAL) { // we are ready for a new reading
-          startReadDHT(true);  // start a new reading
-          newDHTData = true; // set flag to indicate that a new reading will result
-          lastDHTReadTime = millis();
-
-            // toggle the D7 LED to indicate loop timing for DHT11 reading
-            LEDPinState = !LEDPinState;
-            if (LEDPinState) {
-                digitalWrite(LED_PIN, HIGH);
-            } else {
-                digitalWrite(LED_PIN, LOW);
-            }
-
-        }
+    // the DHT sample, TRH publication, alert tick and indicator flash, when they are due; once a
+    // reading has been collected above, so that a new one does not start over it
+    scheduler.run();
+    mg_profiler.lap(STAGE_TASKS);
 
-    }
+    // read all of the polled inputs; the bits of the ones that changed are set
+    WSMChannelMask inputsChanged = mg_inputs.sample();
+    mg_profiler.lap(STAGE_INPUTS);
 
     // Handle toggle switch and servo meter
 
     //  read the toggle switch position and set the boolean for type of display accordingly
-    if(readPinDebounced(&mg_htSwitchPin)){
-        publishParticleEvent("ht toggle state:" + String(mg_htSwitchPin.value));
+    if(inputsChanged & WSMDebouncer::bit(HT_SWITCH_CHANNEL)){
+        publishParticleEvent("ht toggle state:" + String(mg_inputs.value(HT_SWITCH_CHANNEL)));
     };
-    if(mg_htSwitchPin.value == false)  {   // indicates a temperature display
+    if(mg_inputs.value(HT_SWITCH_CHANNEL) == false)  {   // indicates a temperature display
         htSwitchState = HT_SWITCH_TEMPERATURE;
     } else {
         htSwitchState = HT_SWITCH_HUMIDITY;
     }
 
     moveServo(htSwitchState); 
-
-    /******************************************************************
-     * NOTE: PARTICLE_DHT_PUBLISH_INTERVAL is used for timings in the WSM Alert Processor as well
-     * as for publishing intervals of TRH.  DO NOT CHANGE this constant value and DO NOT DELETE this test.
-     * If it is desired not to log TRH, then comment outt the line below: 
-     * publishTRH(mg_smoothedTemp, mg_smoothedHumidity);
-     * *****************************************************************/
-    if((diff(millis(), lastPublishTime)) >= PARTICLE_DHT_PUBLISH_INTERVAL)  // we should publish our values
-    {
-        lastPublishTime = millis();
-        // publish Smoothed temperature and humidity readings to the cloud
-    //    publishParticleEvent("Humidity Smoothed (%): " + String(mg_smoothedHumidity));
-    //    publishParticleEvent( "Temperature Smoothed (oF): " + String(mg_smoothedTemp));
-        publishTRH(mg_smoothedTemp, mg_smoothedHumidity);
-    }
+    mg_profiler.lap(STAGE_SERVO);
 
     // Handle pushbutton
 
     // process the pushbutton
-    if(readPinDebounced(&mg_pushbutton) == true) {
+    if(inputsChanged & WSMDebouncer::bit(PUSHBUTTON_CHANNEL)) {
         //Pinstate has changed
         needNewReport = true;
-        String tempString = String(mg_pushbutton.value);
+        String tempString = String(mg_inputs.value(PUSHBUTTON_CHANNEL));
         publishParticleEvent("pushbutton state: " + tempString );
 
-        digitalWrite(INDICATOR_PIN, mg_pushbutton.value);  //if the push button is depressed, turn off indicator
+        digitalWrite(INDICATOR_PIN, mg_inputs.value(PUSHBUTTON_CHANNEL));  //if the push button is depressed, turn off indicator
     }
 
     // Handle the sensors
 
-    // process the well pump sensor
-    if(readPinDebounced(&mg_wellPumpSensor) == true) {
+    // process the well pump sensor; a late pass can find more than one change
+    while(mg_wellPumpSensor.changed() == true) {
         needNewReport = true;
-        String tempString = String(!mg_wellPumpSensor.value); // pump relay sensor is normally open (1) for off
-        //publishParticleEvent("well pump state: " + tempString);
-        publishWPchange(!mg_wellPumpSensor.value);
+        //publishParticleEvent("well pump state: " + String(!mg_wellPumpSensor.value()));
+        publishWPchange(!mg_wellPumpSensor.value(), mg_wellPumpSensor.changeMillis());
     }
 
     // process the pressure pump sensor
-    if(readPinDebounced(&mg_pressurePumpSensor) == true) {
+    while(mg_pressurePumpSensor.changed() == true) {
         needNewReport = true;
-        String tempString = String(!mg_pressurePumpSensor.value); // pump relay sensor is normally open (1) for off
-        //publishParticleEvent("pressure pump state: " + tempString);
-            publishPPchange(!mg_pressurePumpSensor.value);
+        //publishParticleEvent("pressure pump state: " + String(!mg_pressurePumpSensor.value()));
+        publishPPchange(!mg_pressurePumpSensor.value(), mg_pressurePumpSensor.changeMillis());
     }
 
+    // the boot: the first sensor report once the inputs have been sampled, and the restart report
+    // once the cloud is connected
+    if (mg_boot.sampled(millis())) {
+        needNewReport = true;
+        mg_boot.write(mg_bootTimes, sizeof(mg_bootTimes));
+    }
+    if (mg_boot.cloudConnected(millis(), Particle.connected())) {
+        // the queue sends in order and, refusing rather than dropping, sends all it takes: the
+        // report has gone once the queue has sent as many publications as it had taken with it
+        unsigned int enqueued = publisher.get_enqueued();
+        reportDeviceRestart();
+        mg_restartReportSent = publisher.get_enqueued() != enqueued ? publisher.get_enqueued() : 0;
+        mg_boot.write(mg_bootTimes, sizeof(mg_bootTimes));
+    }
+    mg_profiler.lap(STAGE_PUMPS);
+
+    // publish the journaled events, and the batched pump events when they are due
+    drainJournal();
+    batcher.process();
+    if (batcher.statsChanged()) {
+        batcher.writeStats(mg_publishStats, sizeof(mg_publishStats));
+    }
+    publisher.process();    // only where there is no worker thread
+    if (publisher.statsChanged()) {
+        publisher.writeStats(mg_publishQueue, sizeof(mg_publishQueue));
+    }
+    if (mg_restartReportSent != 0 && publisher.get_sent() >= mg_restartReportSent) {
+        mg_restartReportSent = 0;
+        mg_boot.published(millis());
+        mg_boot.write(mg_bootTimes, sizeof(mg_bootTimes));
+    }
+    mg_profiler.lap(STAGE_PUBLISH);
+
     // create a new report if needed
     if (needNewReport) {
-        mg_particleSensorReport = createSensorJSON();
+        createSensorJSON(mg_particleSensorReport, sizeof(mg_particleSensorReport));
         needNewReport = false;
     }
 
-    if (not Particle.connected()) {
-        nbFlashIndicator(true);
+    // the indicator flashes while the cloud is not connected, once the restart has been shown
+    if (mg_bootIndicator) {
+        // bootIndicatorOn() ends it
+    } else if (not Particle.connected()) {
+        if (not scheduler.active(mg_flashTask)) {
+            scheduler.start(mg_flashTask);
+        }
     } else {
-        digitalWrite(INDICATOR_PIN, mg_pushbutton.value);  //if the push button is depressed, turn off indicator
+        scheduler.stop(mg_flashTask);
+        digitalWrite(INDICATOR_PIN, mg_inputs.value(PUSHBUTTON_CHANNEL));  //if the push button is depressed, turn off indicator
     }
+    mg_profiler.lap(STAGE_REPORT);
+    mg_profiler.endPass();
 
 } // end of loop()
 
-/* initDebounce():  used to initialize the debounce structure for a pin
-    parameters:
-        These are documented in the ty_debouncePin structure declaration
-*/
-void initDebounce (ty_debouncePin *debounceStruct, int _pinNumber, boolean _value, boolean _lastReadValue, int _beginTime, long _debounceDelay) {
-    debounceStruct->pinNumber = _pinNumber;
-    debounceStruct->value = _value;
-    debounceStruct->lastReadValue = _lastReadValue;
-    debounceStruct->beginTime = _beginTime;
-    debounceStruct->debounceDelay = _debounceDelay;
-}
 
 
-/* createSensorJSON(): returns a string suitable for passing to the cloud, containing
-     the current values of all sensors
+/* createSensorJSON(): writes a string suitable for passing to the cloud, containing
+     the current values of all sensors, into json
 */
 
-String createSensorJSON(){
-
-    String json = "";
-    json += makeNameValuePair("Project", "Well System Monitor");
-    json += "," + makeNameValuePairLong("JSONVersion", 2);
-    json += "," + makeNameValuePair("Time", Time.format("%F %T"));
-    json += "," + makeNameValuePairLong("PushButton", mg_pushbutton.value);
-    json += "," + makeNameValuePairLong("Toggle", mg_htSwitchPin.value);
-    json += "," + makeNameValuePairLong("WellPump", !mg_wellPumpSensor.value); // pump relay sensor is normally open (1) for off
-    json += "," + makeNameValuePairLong("PressurePump", !mg_pressurePumpSensor.value); // pump relay sensor is normally open (1) for off
-    json += "," + makeNameValuePairFloat("TEMP", mg_smoothedTemp);
-    json += "," + makeNameValuePairFloat("RH", mg_smoothedHumidity);
-    json = "{" + json + "}";
-    return json;
+void createSensorJSON(char *json, size_t size){
+
+    char timeString[TIME_STRING_SIZE];
+    JSONWriter::formatTime(timeString, Time.local());
+
+    JSONWriter writer(json, size);
+    writer.key("Project", "Well System Monitor");
+    writer.key("JSONVersion", 2);
+    writer.key("Time", timeString);
+    writer.key("PushButton", mg_inputs.value(PUSHBUTTON_CHANNEL));
+    writer.key("Toggle", mg_inputs.value(HT_SWITCH_CHANNEL));
+    writer.key("WellPump", !mg_wellPumpSensor.value()); // pump relay sensor is normally open (1) for off
+    writer.key("PressurePump", !mg_pressurePumpSensor.value()); // pump relay sensor is normally open (1) for off
+    writer.key("TEMP", mg_smoothedTemp, 2);
+    writer.key("RH", mg_smoothedHumidity, 2);
+    writer.end();
 
 }
 
+/* loopProfileQuery(): the loopProfile cloud function; chooses what the LoopProfile variable shows
+    parameters:
+        argument - "" for the longest time of every stage, a stage name (or "loop" for the whole pass)
+                   for its histogram, "reset" to start counting over
+    return:
+        the longest time of the stage (of the pass for the summary) in us, or -1 for an unknown stage
+*/
+int loopProfileQuery(String argument) {
+    argument.trim();
+    if(argument == "reset") {
+        mg_profiler.begin();
+        argument = "";
+    }
+    int view = argument.length() == 0 ? -1 : mg_profiler.find(argument.c_str());
+    if(view < 0 && argument.length() != 0) {
+        return -1;
+    }
+    mg_profileView = view;
+    writeLoopProfile();
+    if(view >= 0 && view < LOOP_STAGES) {
+        return (int)mg_profiler.stage(view).maxMicros;
+    }
+    return (int)mg_profiler.pass().maxMicros;
+}   // end of loopProfileQuery()
+
 /* publishParticleEvent()  Used to make each publish event the same format
         String message     The message to publish
 */
 void publishParticleEvent (String message){
 
     String thisTime = Time.format("%F %T");
-    Particle.publish("WSM", thisTime + " | " + message, PRIVATE);
+    publisher.publish("WSM", (thisTime + " | " + message).c_str());
 
 }
 
 
+/* Scheduled tasks (see setup()) */
+
+/* sampleDHT(): every DHT_SAMPLE_INTERVAL, start a DHT11 reading; loop() collects it */
+void sampleDHT() {
+    if(startReadDHT(false) == ACQUIRING) {
+        return;     // the last reading is not finished; try again next time
+    }
+    startReadDHT(true);  // start a new reading
+    mg_newDHTData = true; // set flag to indicate that a new reading will result
+
+    // toggle the D7 LED to indicate loop timing for DHT11 reading
+    LEDPinState = !LEDPinState;
+    if (LEDPinState) {
+        digitalWrite(LED_PIN, HIGH);
+    } else {
+        digitalWrite(LED_PIN, LOW);
+    }
+}   // end of sampleDHT()
+
+/* publishTRHTask(): every PARTICLE_DHT_PUBLISH_INTERVAL, publish the smoothed readings.
+    If it is desired not to log TRH, then comment out the line below; the alert processor
+    has its own timer (alertTimeTick()) and does not depend on it.
+*/
+void publishTRHTask() {
+    // publish Smoothed temperature and humidity readings to the cloud
+//    publishParticleEvent("Humidity Smoothed (%): " + String(mg_smoothedHumidity));
+//    publishParticleEvent( "Temperature Smoothed (oF): " + String(mg_smoothedTemp));
+    publishTRH(mg_smoothedTemp, mg_smoothedHumidity);
+}   // end of publishTRHTask()
+
+/* alertTimeTick(): every ALERT_TICK_INTERVAL, a ½ hour time tick for the alert processor.
+    The alert thresholds are counted in these ticks: DO NOT CHANGE ALERT_TICK_INTERVAL.
+*/
+void alertTimeTick() {
+    alerter.halfHourTimeTick();
+}   // end of alertTimeTick()
+
+/* publishPumpStats(): every PUMP_STATS_INTERVAL, close the hour of pump statistics and publish
+    the summary; it is also the PumpStats variable
+*/
+void publishPumpStats() {
+    pumpStats.closeHour(millis());
+    pumpStats.writeSummary(mg_pumpStats, sizeof(mg_pumpStats), Time.now());
+    if(Particle.connected()) {
+        publisher.publish("wsmPumpStats", mg_pumpStats);
+    }
+}   // end of publishPumpStats()
+
+/* writeLoopProfile(): every LOOP_PROFILE_INTERVAL, refresh the LoopProfile variable with the view
+    last asked for by loopProfileQuery()
+*/
+void writeLoopProfile() {
+    if(mg_profileView < 0) {
+        mg_profiler.writeSummary(mg_loopProfile, sizeof(mg_loopProfile));
+    } else {
+        mg_profiler.writeStage(mg_profileView, mg_loopProfile, sizeof(mg_loopProfile));
+    }
+}   // end of writeLoopProfile()
+
+/* bootIndicatorOff(), bootIndicatorOn(): the restart indicator, BOOT_INDICATOR_OFF and
+    BOOT_INDICATOR_ON after setup(); after that loop() lights or flashes the indicator
+*/
+void bootIndicatorOff() {
+    digitalWrite(INDICATOR_PIN, LOW);
+}   // end of bootIndicatorOff()
+
+void bootIndicatorOn() {
+    digitalWrite(INDICATOR_PIN, HIGH);  // Pushbutton pin remains solid ON while device is working
+    mg_bootIndicator = false;
+}   // end of bootIndicatorOn()
+
+/* flashIndicator(): every FLASH_INTERVAL while the cloud is not connected */
+void flashIndicator() {
+    nbFlashIndicator(true);
+}   // end of flashIndicator()
+
 /* nbFlashIndicator():  non-blocking function to flash the indicator LED when alarming
-                        or light it constantly when not alarming
+                        or light it constantly when not alarming; called every FLASH_INTERVAL
+                        by the scheduler while flashing
     parameters:
         flash - true to flash the LED, false to light it constantly
 */
 void nbFlashIndicator(boolean flash) {
-    const unsigned long FLASH_INTERVAL = 150; // 150 ms on and off
     static boolean lastOn = true;   // start with LED on
-    static unsigned long lastTime = millis();
 
-    if(flash == true) {     // flashes the LED
-        if(diff(millis(), lastTime) >= FLASH_INTERVAL) { // flip the LED state
-            lastOn = !lastOn;
-            lastTime = millis();
-        }
+    if(flash == true) {     // flashes the LED: flip the LED state
+        lastOn = !lastOn;
 
     } else {  // not flashing the LED
         lastOn = true;
@@ -387,57 +648,16 @@ void nbFlashIndicator(boolean flash) {
     return;
 }   // end of nbFlashIndicator()
 
-/* readPinDebounced: read a pin with debouncing
-    parameters: pass in structure holding state of the pin
-    return:
-        flag that indicates the pin status has changed
-*/
-bool readPinDebounced(ty_debouncePin *_pinToRead) {
-    bool stateChanged = false;
-    bool currentReadValue;
-
-    int currentPinRead = digitalRead(_pinToRead->pinNumber);
-
-    if (currentPinRead == 0){
-        currentReadValue = false;
-    } else {
-        currentReadValue = true;
-    }
-
-    unsigned long timeNow = millis();
-
-    if(currentReadValue != _pinToRead->lastReadValue) { // has the pin changed since last time here?
-        // pin changed, reset timer
-        _pinToRead->beginTime = timeNow;
-        _pinToRead->lastReadValue = currentReadValue;
-
-    } else {
-        // pin did not change since last time in this routine
-        if(diff(timeNow, _pinToRead->beginTime) > _pinToRead->debounceDelay) { // has pin change lasted?
-            // pin change lasted, so it's a valid change
-            if(_pinToRead->value != currentReadValue){
-                //saved pin state is getting updated
-                _pinToRead->value = currentReadValue;
-                stateChanged = true; // alert the caller
-            }
-        }
-    }
-
-    return stateChanged;
-
-}  // end of readPinDebounced
-
-
 /* diff(): function to measure time differences using millis() that corrects for millis() overflow.
     paramters:
-        current - the current time value from millis(), as unsigned long
-        last - the previous time value from millis(), as unsigned long
+        current - the current time value from millis(), as system_tick_t
+        last - the previous time value from millis(), as system_tick_t
     return:
-        the difference between current and last, as unsigned long
+        the difference between current and last, as system_tick_t
 */
-unsigned long diff(unsigned long _current, unsigned long _last)  {
-    const unsigned long MAX = 0xffffffff;  // an unsigned long is 4 bytes
-    unsigned long difference;
+system_tick_t diff(system_tick_t _current, system_tick_t _last)  {
+    const system_tick_t MAX = 0xffffffff;  // millis() is 4 bytes
+    system_tick_t difference;
 
     if (_current < _last) {       // overflow condition
         difference = (MAX - _last) + _current;
@@ -461,6 +681,7 @@ int startReadDHT(boolean _startRead) {
 
     if(state == ACQUIRING) {  // test to see if we are done
         if(DHT.acquiring() == false) { // done acquriring
+            mg_wellPumpSensor.attach();  // DHTPIN shares its interrupt line with the well pump sensor
             dhtResultCode = DHT.getStatus();  // store the result code from the library
            if(dhtResultCode == DHTLIB_OK) {
                state = COMPLETE_OK;
@@ -519,108 +740,111 @@ void meterDisplay(float _displayValue, int _lowestValue, int _highestValue)  {
 }  // end of meterDisplay()
 
 // New publication functions for version 1.3:
+// 2026: the events are journaled in EEPROM first; drainJournal() publishes them from there.
 
 //  publish new temperature and humidity values
 void publishTRH(float temp, float rh) {
-  String eData = "";
+  WSMJournalRecord record = {JOURNAL_TRH, false, (uint32_t)Time.now(), temp, rh};
 
-  // build the data string with time, temp and rh values
-  eData += "{\"etime\":";
-  eData += String(Time.now());
-  eData += ",\"temp\":";
-  eData += String(temp);
-  eData += ",\"rh\":";
-  eData += String(rh);
-  eData += ",\"loctime\":\"";
-  eData += String(Time.format("%F %T"));
-  eData += "\"}";
+  // journal the report for the webhook
+  journal.append(record);
 
-  // publish to the webhook
-  Particle.publish("wsmEventTRH", eData, PRIVATE);
-
-  // publish a 1/2 hour time tick increment to the alert processor
-  alerter.halfHourTimeTick();
+  // 2026: the ½ hour time tick of the alert processor is alertTimeTick(), on its own timer
 
   return;
 } // end of publishTRH()
 
-//  publish pressure pump status change
-void publishPPchange(int newPPstatus) {
-  static unsigned long ppumpOnTimestamp;
-  String eData = "";
+//  publish pressure pump status change; changeTime is millis() when the relay moved
+void publishPPchange(int newPPstatus, system_tick_t changeTime) {
+  static system_tick_t ppumpOnTimestamp;
   float pumpTime;
-
-  // build the data string with time, pp value
-  eData += "{\"etime\":";
-  eData += String(Time.now());
-  eData += ",\"pp\":";
-  eData += String(newPPstatus);
+  unsigned int alertCount = alerter.get_alertCount();
+  WSMJournalRecord record = {JOURNAL_PP_ON, false, (uint32_t)Time.now(), 0.0, 0.0};
 
   // computation of PP on time
   if(newPPstatus == 1) {  // the pump has come on
-    ppumpOnTimestamp = millis();
-    eData += ",\"loctime\":\"";
-    eData += String(Time.format("%F %T"));
-    eData += "\"}";
+    ppumpOnTimestamp = changeTime;
 
     // publish pp turned on to alert processor
     alerter.ppTurnedOn();
+    pumpStats.pumpOn(PUMP_PP, changeTime);
   }
   else {    // the pump has turned off
-    eData += ",\"ppon\":";
-    pumpTime = (float)(millis() - ppumpOnTimestamp)/60000.0;
-    eData += String(pumpTime);
-    eData += ",\"loctime\":\"";
-    eData += String(Time.format("%F %T"));
-    eData += "\"}";
+    pumpTime = (float)(changeTime - ppumpOnTimestamp)/60000.0;
+    record.kind = JOURNAL_PP_OFF;
+    record.value1 = pumpTime;
 
     // publish pp turned off to alert processor
     alerter.ppTurnedOff(pumpTime);
+    pumpStats.pumpOff(PUMP_PP, changeTime);
   }
 
-  // publish to the webhook
-  Particle.publish("wsmEventPPstatus", eData, PRIVATE);
+  // journal for the webhook; an event that raised an alert is published along with the alert
+  record.alert = alerter.get_alertCount() != alertCount;
+  journal.append(record);
 
   return;
 } // end of publishPPchange()
 
-//  publish well pump status change
-void publishWPchange(int newWPstatus) {
-  static unsigned long wpumpOnTimestamp;
-  String eData = "";
+//  publish well pump status change; changeTime is millis() when the relay moved
+void publishWPchange(int newWPstatus, system_tick_t changeTime) {
+  static system_tick_t wpumpOnTimestamp;
   float pumpTime;
-
-  // build the data string with time, wp value
-  eData += "{\"etime\":";
-  eData += String(Time.now());
-  eData += ",\"wp\":";
-  eData += String(newWPstatus);
+  unsigned int alertCount = alerter.get_alertCount();
+  WSMJournalRecord record = {JOURNAL_WP_ON, false, (uint32_t)Time.now(), 0.0, 0.0};
 
 // computation of WP on time
   if(newWPstatus == 1) {  // the pump has come on
-    wpumpOnTimestamp = millis();
-    eData += ",\"loctime\":\"";
-    eData += String(Time.format("%F %T"));
-    eData += "\"}";
+    wpumpOnTimestamp = changeTime;
 
     // publish wp turned on to alert processor
     alerter.wpTurnedOn();
+    pumpStats.pumpOn(PUMP_WP, changeTime);
   }
   else {    // the pump has turned off
-    eData += ",\"wpon\":";
-    pumpTime = (float)(millis() - wpumpOnTimestamp)/60000;
-    eData += String(pumpTime);
-    eData += ",\"loctime\":\"";
-    eData += String(Time.format("%F %T"));
-    eData += "\"}";
+    pumpTime = (float)(changeTime - wpumpOnTimestamp)/60000;
+    record.kind = JOURNAL_WP_OFF;
+    record.value1 = pumpTime;
 
     // publish wp turned off to alert processor
     alerter.wpTurnedOff(pumpTime);
+    pumpStats.pumpOff(PUMP_WP, changeTime);
   }
 
-  // publish to the webhook
-  Particle.publish("wsmEventWPstatus", eData, PRIVATE);
+  // journal for the webhook; an event that raised an alert is published along with the alert
+  record.alert = alerter.get_alertCount() != alertCount;
+  journal.append(record);
 
   return;
 } // end of publishWPchange()
 
+/* drainJournal(): while connected to the cloud, hand the journaled events to the batcher in order,
+    no faster than JOURNAL_DRAIN_INTERVAL allows, and mark them drained once the publish queue has
+    sent them (or dropped them).  While the batcher is retrying a batch the queue refused, no more
+    events are taken out; an event the batcher could not take is kept here and offered again, so
+    a full queue never costs a journaled event.  The TRH report, and an event that raised an alert,
+    send the pack straight away.
+*/
+void drainJournal() {
+  static unsigned int lastHandled = 0;  // events the queue had sent or dropped at the last confirm
+  static WSMJournalRecord record;       // taken out of the journal, not yet taken by the batcher
+  static bool taken = false;
+
+  if(Particle.connected() && !batcher.retrying()) {
+    if(!taken) {
+      taken = journal.next(record);
+    }
+    if(taken && batcher.add(record)) {
+      taken = false;
+      if(record.kind == JOURNAL_TRH || record.alert) {
+        batcher.flush();
+      }
+    }
+  }
+
+  unsigned int handled = publisher.get_eventsSent() + publisher.get_eventsDropped();
+  journal.confirm(handled - lastHandled);
+  lastHandled = handled;
+
+  return;
+} // end of drainJournal()